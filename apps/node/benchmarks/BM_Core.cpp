@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "MsgQ.h"
+#include "Dictionary.h"
+#include "Table.h"
+#include "Ordering.h"
+#include "FieldColumn.h"
+#include "RecordObject.h"
+#include "StringLib.h"
+#include "BM_Core.h"
+
+/******************************************************************************
+ * LOCAL DATA
+ ******************************************************************************/
+
+static const char* SUITE = "core";
+
+static const long NUM_MESSAGES = 1000;
+static const int MESSAGE_SIZE = 64;
+static const long NUM_KEYS = 10000;
+static const long NUM_ROWS = 100000;
+static const long NUM_RECORDS = 10000;
+
+/* ATL06 Elevation Measurement (mirrors Atl06Dispatch::elevation_t) */
+typedef struct {
+    uint64_t            extent_id;
+    uint32_t            segment_id;
+    int32_t             photon_count;
+    uint16_t            rgt;
+    uint8_t             cycle;
+    int64_t             time_ns;
+    double              latitude;
+    double              longitude;
+    double              h_mean;
+    float               x_atc;
+    float               h_sigma;
+} bm_elevation_t;
+
+static const char* elRecType = "bm_elevation";
+static const RecordObject::fieldDef_t elRecDef[] = {
+    {"extent_id",   RecordObject::UINT64,   offsetof(bm_elevation_t, extent_id),    1,  NULL, NATIVE_FLAGS | RecordObject::INDEX,   NULL},
+    {"segment_id",  RecordObject::UINT32,   offsetof(bm_elevation_t, segment_id),   1,  NULL, NATIVE_FLAGS,                         NULL},
+    {"n_fit_photons",RecordObject::INT32,   offsetof(bm_elevation_t, photon_count), 1,  NULL, NATIVE_FLAGS,                         NULL},
+    {"rgt",         RecordObject::UINT16,   offsetof(bm_elevation_t, rgt),          1,  NULL, NATIVE_FLAGS,                         NULL},
+    {"cycle",       RecordObject::UINT8,    offsetof(bm_elevation_t, cycle),        1,  NULL, NATIVE_FLAGS,                         NULL},
+    {"time",        RecordObject::TIME8,    offsetof(bm_elevation_t, time_ns),      1,  NULL, NATIVE_FLAGS | RecordObject::TIME,    NULL},
+    {"latitude",    RecordObject::DOUBLE,   offsetof(bm_elevation_t, latitude),     1,  NULL, NATIVE_FLAGS | RecordObject::Y_COORD, NULL},
+    {"longitude",   RecordObject::DOUBLE,   offsetof(bm_elevation_t, longitude),    1,  NULL, NATIVE_FLAGS | RecordObject::X_COORD, NULL},
+    {"h_mean",      RecordObject::DOUBLE,   offsetof(bm_elevation_t, h_mean),       1,  NULL, NATIVE_FLAGS | RecordObject::Z_COORD, NULL},
+    {"x_atc",       RecordObject::FLOAT,    offsetof(bm_elevation_t, x_atc),        1,  NULL, NATIVE_FLAGS,                         NULL},
+    {"h_sigma",     RecordObject::FLOAT,    offsetof(bm_elevation_t, h_sigma),      1,  NULL, NATIVE_FLAGS,                         NULL}
+};
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * benchMsgQ
+ *
+ *  posts a batch of copied messages and then receives and dereferences them
+ *  all from the same thread, measuring the queue and not the scheduler
+ *----------------------------------------------------------------------------*/
+static void benchMsgQ (BenchRunner& runner)
+{
+    Publisher pub("benchq", NUM_MESSAGES);
+    Subscriber sub("benchq");
+    uint8_t message[MESSAGE_SIZE] = {0};
+
+    runner.run(SUITE, "msgq_post_receive", NUM_MESSAGES, NUM_MESSAGES * MESSAGE_SIZE, [&]() {
+        for(long i = 0; i < NUM_MESSAGES; i++)
+        {
+            message[0] = static_cast<uint8_t>(i);
+            pub.postCopy(message, MESSAGE_SIZE, IO_CHECK);
+        }
+        for(long i = 0; i < NUM_MESSAGES; i++)
+        {
+            Subscriber::msgRef_t ref;
+            if(sub.receiveRef(ref, IO_CHECK) > 0)
+            {
+                sub.dereference(ref);
+            }
+        }
+    });
+}
+
+/*----------------------------------------------------------------------------
+ * benchDictionary
+ *----------------------------------------------------------------------------*/
+static void benchDictionary (BenchRunner& runner, const vector<string>& keys)
+{
+    runner.run(SUITE, "dictionary_add", NUM_KEYS, 0, [&]() {
+        Dictionary<long> dictionary;
+        for(long i = 0; i < NUM_KEYS; i++) dictionary.add(keys[i].c_str(), i);
+        benchKeep(dictionary.length());
+    });
+
+    Dictionary<long> dictionary;
+    for(long i = 0; i < NUM_KEYS; i++) dictionary.add(keys[i].c_str(), i);
+
+    runner.run(SUITE, "dictionary_find", NUM_KEYS, 0, [&]() {
+        long sum = 0;
+        for(long i = 0; i < NUM_KEYS; i++) sum += dictionary[keys[i].c_str()];
+        benchKeep(sum);
+    });
+
+    runner.run(SUITE, "dictionary_find_view", NUM_KEYS, 0, [&]() {
+        long sum = 0;
+        for(long i = 0; i < NUM_KEYS; i++) sum += dictionary.get(std::string_view(keys[i]));
+        benchKeep(sum);
+    });
+
+    vector<DictionaryKey> hashed_keys;
+    hashed_keys.reserve(NUM_KEYS);
+    for(long i = 0; i < NUM_KEYS; i++) hashed_keys.emplace_back(keys[i].c_str());
+
+    runner.run(SUITE, "dictionary_find_prehashed", NUM_KEYS, 0, [&]() {
+        long sum = 0;
+        for(long i = 0; i < NUM_KEYS; i++) sum += dictionary.get(hashed_keys[i]);
+        benchKeep(sum);
+    });
+
+    runner.run(SUITE, "dictionary_iterate", NUM_KEYS, 0, [&]() {
+        long sum = 0;
+        long value;
+        const char* key = dictionary.first(&value);
+        while(key != NULL)
+        {
+            sum += value;
+            key = dictionary.next(&value);
+        }
+        benchKeep(sum);
+    });
+}
+
+/*----------------------------------------------------------------------------
+ * benchTable
+ *----------------------------------------------------------------------------*/
+static void benchTable (BenchRunner& runner)
+{
+    const okey_t table_size = NUM_KEYS * 2;
+
+    runner.run(SUITE, "table_add", NUM_KEYS, 0, [&]() {
+        Table<long, okey_t> table(table_size);
+        for(long i = 0; i < NUM_KEYS; i++) table.add(i * 7, i, true);
+        benchKeep(table.length());
+    });
+
+    Table<long, okey_t> table(table_size);
+    for(long i = 0; i < NUM_KEYS; i++) table.add(i * 7, i, true);
+
+    runner.run(SUITE, "table_find", NUM_KEYS, 0, [&]() {
+        long sum = 0;
+        long value = 0;
+        for(long i = 0; i < NUM_KEYS; i++)
+        {
+            if(table.find(i * 7, Table<long, okey_t>::MATCH_EXACTLY, &value)) sum += value;
+        }
+        benchKeep(sum);
+    });
+}
+
+/*----------------------------------------------------------------------------
+ * benchOrdering
+ *----------------------------------------------------------------------------*/
+static void benchOrdering (BenchRunner& runner)
+{
+    /* keys in a scrambled but repeatable order */
+    vector<okey_t> keys(NUM_KEYS);
+    for(long i = 0; i < NUM_KEYS; i++) keys[i] = (i * 7919) % NUM_KEYS;
+
+    runner.run(SUITE, "ordering_add", NUM_KEYS, 0, [&]() {
+        Ordering<long, okey_t> ordering;
+        for(long i = 0; i < NUM_KEYS; i++) ordering.add(keys[i], i);
+        benchKeep(ordering.length());
+    });
+
+    vector<long> values(NUM_KEYS);
+    for(long i = 0; i < NUM_KEYS; i++) values[i] = i;
+
+    runner.run(SUITE, "ordering_load", NUM_KEYS, 0, [&]() {
+        Ordering<long, okey_t> ordering;
+        ordering.load(keys.data(), values.data(), NUM_KEYS);
+        benchKeep(ordering.length());
+    });
+
+    Ordering<long, okey_t> ordering;
+    for(long i = 0; i < NUM_KEYS; i++) ordering.add(keys[i], i);
+
+    runner.run(SUITE, "ordering_get", NUM_KEYS, 0, [&]() {
+        long sum = 0;
+        for(long i = 0; i < NUM_KEYS; i++) sum += ordering.get(keys[i]);
+        benchKeep(sum);
+    });
+
+    runner.run(SUITE, "ordering_iterate", NUM_KEYS, 0, [&]() {
+        long sum = 0;
+        long value;
+        okey_t key = ordering.first(&value);
+        while(key != static_cast<okey_t>(INVALID_KEY))
+        {
+            sum += value;
+            key = ordering.next(&value);
+        }
+        benchKeep(sum);
+    });
+
+    runner.run(SUITE, "ordering_remove_add", NUM_KEYS, 0, [&]() {
+        Ordering<long, okey_t> single;
+        for(long i = 0; i < NUM_KEYS; i++)
+        {
+            single.add(keys[i], i);
+            single.remove(keys[i]);
+        }
+        benchKeep(single.length());
+    });
+}
+
+/*----------------------------------------------------------------------------
+ * benchFieldColumn
+ *----------------------------------------------------------------------------*/
+static void benchFieldColumn (BenchRunner& runner)
+{
+    const long bytes = NUM_ROWS * sizeof(double);
+
+    runner.run(SUITE, "fieldcolumn_append", NUM_ROWS, bytes, [&]() {
+        FieldColumn<double> column;
+        for(long i = 0; i < NUM_ROWS; i++) column.append(static_cast<double>(i));
+        benchKeep(column.length());
+    });
+
+    FieldColumn<double> column;
+    for(long i = 0; i < NUM_ROWS; i++) column.append(static_cast<double>(i));
+    vector<uint8_t> buffer(bytes);
+
+    runner.run(SUITE, "fieldcolumn_serialize", NUM_ROWS, bytes, [&]() {
+        benchKeep(column.serialize(buffer.data(), buffer.size()));
+    });
+}
+
+/*----------------------------------------------------------------------------
+ * benchRecordObject
+ *
+ *  reads every field of a batch of ATL06 shaped records by name and through
+ *  compiled field paths
+ *----------------------------------------------------------------------------*/
+static void benchRecordObject (BenchRunner& runner)
+{
+    const int num_fields = sizeof(elRecDef) / sizeof(RecordObject::fieldDef_t);
+
+    vector<RecordObject*> records;
+    for(long i = 0; i < NUM_RECORDS; i++)
+    {
+        RecordObject* rec = new RecordObject(elRecType);
+        bm_elevation_t* elevation = reinterpret_cast<bm_elevation_t*>(rec->getRecordData());
+        elevation->extent_id = i;
+        elevation->time_ns = 1700000000000000000LL + i;
+        elevation->latitude = -71.0 + (i * 0.0001);
+        elevation->longitude = 150.0 + (i * 0.0001);
+        elevation->h_mean = 1000.0 + (i % 100);
+        records.push_back(rec);
+    }
+
+    runner.run(SUITE, "recordobject_get_by_name", NUM_RECORDS * num_fields, 0, [&]() {
+        double sum = 0.0;
+        for(RecordObject* rec: records)
+        {
+            for(int f = 0; f < num_fields; f++)
+            {
+                sum += rec->getValueReal(rec->getField(elRecDef[f].name));
+            }
+        }
+        benchKeep(sum);
+    });
+
+    vector<RecordObject::FieldPath*> paths;
+    for(int f = 0; f < num_fields; f++) paths.push_back(new RecordObject::FieldPath(elRecDef[f].name));
+
+    runner.run(SUITE, "recordobject_get_compiled", NUM_RECORDS * num_fields, 0, [&]() {
+        double sum = 0.0;
+        for(RecordObject* rec: records)
+        {
+            for(RecordObject::FieldPath* path: paths)
+            {
+                sum += path->getReal(rec);
+            }
+        }
+        benchKeep(sum);
+    });
+
+    for(RecordObject::FieldPath* path: paths) delete path;
+    for(RecordObject* rec: records) delete rec;
+}
+
+/******************************************************************************
+ * METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * run
+ *----------------------------------------------------------------------------*/
+void BM_Core::run (BenchRunner& runner)
+{
+    RECDEF(elRecType, elRecDef, sizeof(bm_elevation_t), NULL);
+
+    vector<string> keys;
+    for(long i = 0; i < NUM_KEYS; i++) keys.emplace_back(FString("/gt%ldl/heights/h_ph_%ld", (i % 3) + 1, i).c_str());
+
+    benchMsgQ(runner);
+    benchDictionary(runner, keys);
+    benchTable(runner);
+    benchOrdering(runner);
+    benchFieldColumn(runner);
+    benchRecordObject(runner);
+}
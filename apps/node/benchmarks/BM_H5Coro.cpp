@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "BM_H5Coro.h"
+
+#ifdef __h5coro__
+
+#include "LuaEngine.h"
+#include "Asset.h"
+#include "FileIODriver.h"
+#include "H5CoroLib.h"
+#include "H5Filter.h"
+#include "H5Writer.h"
+
+#include <zlib.h>
+
+#include <cmath>
+
+/******************************************************************************
+ * LOCAL DATA
+ ******************************************************************************/
+
+static const char* SUITE = "h5coro";
+
+static const char* BENCH_DIRECTORY = "/tmp";
+static const char* BENCH_RESOURCE = "sliderule-bench.h5";
+
+static const int64_t NUM_PHOTONS = 2000000;
+static const int64_t CHUNK_ROWS = 10000;    // matches the chunking of ATL03 photon datasets
+static const int DEFLATE_LEVEL = 6;
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * createAsset
+ *
+ *  assets can only be created through lua, so a bare interpreter is used to
+ *  hold the asset for the duration of the benchmarks
+ *----------------------------------------------------------------------------*/
+static Asset* createAsset (lua_State* L)
+{
+    lua_pushstring(L, "sliderule-bench");
+    lua_pushnil(L);
+    lua_pushstring(L, FileIODriver::FORMAT);
+    lua_pushstring(L, BENCH_DIRECTORY);
+    if(Asset::luaCreate(L) != 1 || lua_isuserdata(L, -1) == 0)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "unable to create benchmark asset");
+    }
+    return dynamic_cast<Asset*>(LuaObject::getLuaObject(L, -1, Asset::OBJECT_TYPE));
+}
+
+/*----------------------------------------------------------------------------
+ * benchRead
+ *
+ *  reads a full dataset through a fresh context each call so that the i/o
+ *  cache starts cold; dataset metadata stays cached across calls
+ *----------------------------------------------------------------------------*/
+static void benchRead (BenchRunner& runner, const Asset* asset, const char* name, const char* dataset, int type_size)
+{
+    const H5Coro::range_t slice[1] = {{0, H5Coro::EOR}};
+    runner.run(SUITE, name, NUM_PHOTONS, NUM_PHOTONS * type_size, [&]() {
+        H5Coro::Context context(asset, BENCH_RESOURCE);
+        H5Coro::info_t info = H5Coro::read(&context, dataset, RecordObject::DYNAMIC, slice, 1);
+        benchKeep(info.data[info.datasize - 1]);
+        operator delete[](info.data, std::align_val_t(H5CORO_DATA_ALIGNMENT));
+    });
+}
+
+/*----------------------------------------------------------------------------
+ * benchFilters
+ *
+ *  runs the inflate and unshuffle kernels directly on chunks shuffled and
+ *  compressed the same way as the generated file; zlib is run alongside the
+ *  build time inflate backend as a reference
+ *----------------------------------------------------------------------------*/
+static void benchFilters (BenchRunner& runner, const uint8_t* values, int type_size, const char* type_name)
+{
+    const int64_t chunk_size = CHUNK_ROWS * type_size;
+    const int64_t num_chunks = NUM_PHOTONS / CHUNK_ROWS;
+
+    /* Build Shuffled and Compressed Chunks */
+    vector<vector<uint8_t>> chunks;
+    vector<uint8_t> shuffled(chunk_size);
+    for(int64_t c = 0; c < num_chunks; c++)
+    {
+        const uint8_t* input = &values[c * chunk_size];
+        for(int64_t e = 0; e < CHUNK_ROWS; e++)
+        {
+            for(int b = 0; b < type_size; b++)
+            {
+                shuffled[(b * CHUNK_ROWS) + e] = input[(e * type_size) + b];
+            }
+        }
+        uLongf compressed_size = compressBound(chunk_size);
+        vector<uint8_t> compressed(compressed_size);
+        if(compress2(compressed.data(), &compressed_size, shuffled.data(), chunk_size, DEFLATE_LEVEL) != Z_OK)
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to compress benchmark chunk");
+        }
+        compressed.resize(compressed_size);
+        chunks.push_back(std::move(compressed));
+    }
+
+    /* Inflate */
+    vector<uint8_t> inflated(chunk_size * num_chunks);
+    if(H5Filter::getInflateBackend() != H5Filter::ZLIB_INFLATE)
+    {
+        runner.run(SUITE, FString("inflate_%s_zlib", type_name).c_str(), NUM_PHOTONS, inflated.size(), [&]() {
+            for(int64_t c = 0; c < num_chunks; c++)
+            {
+                H5Filter::inflateZlib(chunks[c].data(), chunks[c].size(), &inflated[c * chunk_size], chunk_size);
+            }
+            benchKeep(inflated[0]);
+        });
+    }
+    runner.run(SUITE, FString("inflate_%s_%s", type_name, H5Filter::inflate2str(H5Filter::getInflateBackend())).c_str(), NUM_PHOTONS, inflated.size(), [&]() {
+        for(int64_t c = 0; c < num_chunks; c++)
+        {
+            H5Filter::inflate(chunks[c].data(), chunks[c].size(), &inflated[c * chunk_size], chunk_size);
+        }
+        benchKeep(inflated[0]);
+    });
+
+    /* Unshuffle - each kernel the cpu supports */
+    vector<uint8_t> output(chunk_size * num_chunks);
+    const H5Filter::unshuffle_kernel_t best_kernel = H5Filter::getUnshuffleKernel();
+    for(int k = H5Filter::SCALAR_UNSHUFFLE; k <= best_kernel; k++)
+    {
+        const H5Filter::unshuffle_kernel_t kernel = static_cast<H5Filter::unshuffle_kernel_t>(k);
+        const H5Filter::unshuffle_func_t unshuffle = H5Filter::getUnshuffleFunc(kernel);
+        runner.run(SUITE, FString("unshuffle_%s_%s", type_name, H5Filter::unshuffle2str(kernel)).c_str(), NUM_PHOTONS, output.size(), [&]() {
+            for(int64_t c = 0; c < num_chunks; c++)
+            {
+                unshuffle(&inflated[c * chunk_size], CHUNK_ROWS, &output[c * chunk_size], 0, CHUNK_ROWS, type_size);
+            }
+            benchKeep(output[0]);
+        });
+    }
+}
+
+/******************************************************************************
+ * METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * run
+ *----------------------------------------------------------------------------*/
+void BM_H5Coro::run (BenchRunner& runner)
+{
+    /* Synthetic Photon Track - smooth enough to compress like real data */
+    vector<double> delta_time(NUM_PHOTONS);
+    vector<double> lat_ph(NUM_PHOTONS);
+    vector<float> h_ph(NUM_PHOTONS);
+    for(int64_t i = 0; i < NUM_PHOTONS; i++)
+    {
+        delta_time[i] = 5.0e7 + (i * 1.0e-5);
+        lat_ph[i] = -71.0 + (i * 6.3e-6);
+        h_ph[i] = static_cast<float>(1500.0 + (50.0 * sin(i * 1.0e-4)) + ((i * 7919) % 97) * 0.01);
+    }
+
+    /* Generate File */
+    const FString filename("%s/%s", BENCH_DIRECTORY, BENCH_RESOURCE);
+    H5Writer writer(filename.c_str());
+    writer.addDataset("/gt1l/heights/delta_time", RecordObject::DOUBLE, delta_time.data(), NUM_PHOTONS, 0, CHUNK_ROWS, DEFLATE_LEVEL, true);
+    writer.addDataset("/gt1l/heights/lat_ph", RecordObject::DOUBLE, lat_ph.data(), NUM_PHOTONS, 0, CHUNK_ROWS, DEFLATE_LEVEL, true);
+    writer.addDataset("/gt1l/heights/h_ph", RecordObject::FLOAT, h_ph.data(), NUM_PHOTONS, 0, CHUNK_ROWS, DEFLATE_LEVEL, true);
+    writer.addDataset("/gt1l/heights/lon_ph", RecordObject::DOUBLE, lat_ph.data(), NUM_PHOTONS, 0, CHUNK_ROWS);
+    const uint64_t file_size = writer.close();
+    print2term("Generated %s (%lu bytes)\n", filename.c_str(), static_cast<unsigned long>(file_size));
+
+    /* Read Benchmarks */
+    lua_State* L = luaL_newstate();
+    Asset* asset = NULL;
+    try
+    {
+        asset = createAsset(L);
+        benchRead(runner, asset, "read_f8_deflate_shuffle", "/gt1l/heights/delta_time", sizeof(double));
+        benchRead(runner, asset, "read_f4_deflate_shuffle", "/gt1l/heights/h_ph", sizeof(float));
+        benchRead(runner, asset, "read_f8_unfiltered", "/gt1l/heights/lon_ph", sizeof(double));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Failed to run h5coro read benchmarks: %s", e.what());
+    }
+    if(asset) asset->releaseLuaObject();
+    lua_close(L);
+
+    /* Filter Benchmarks */
+    benchFilters(runner, reinterpret_cast<const uint8_t*>(delta_time.data()), sizeof(double), "f8");
+    benchFilters(runner, reinterpret_cast<const uint8_t*>(h_ph.data()), sizeof(float), "f4");
+
+    remove(filename.c_str());
+}
+
+#else
+
+void BM_H5Coro::run (BenchRunner& runner)
+{
+    (void)runner;
+}
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "BM_Icesat2.h"
+
+#ifdef __icesat2__
+
+#include "LuaEngine.h"
+#include "Atl03DataFrame.h"
+#include "Atl03Parameters.h"
+#include "SurfaceFitter.h"
+#include "PhoReal.h"
+
+#include <cmath>
+
+/******************************************************************************
+ * LOCAL DATA
+ ******************************************************************************/
+
+static const char* SUITE = "icesat2";
+
+static const long NUM_PHOTONS = 100000;
+static const double PHOTON_SPACING = 0.7;       // meters along track
+static const double SEGMENT_LENGTH = 20.0;      // meters, ATL03 geolocation segment
+static const int64_t GPS_EPOCH_NS = 1198800018000000000LL;
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * populate
+ *
+ *  synthetic photon track over sloped terrain with a canopy layer; every
+ *  column the fitter and phoreal read is filled in
+ *----------------------------------------------------------------------------*/
+static void populate (Atl03DataFrame* df)
+{
+    auto ground = [](long i) { return 800.0 + (i * PHOTON_SPACING * 0.01) + (5.0 * sin(i * 1.0e-3)); };
+    auto atl08 = [](long i) -> uint8_t {
+        const long r = (i * 7919) % 10;
+        if(r < 5) return Icesat2Parameters::ATL08_GROUND;
+        if(r < 8) return Icesat2Parameters::ATL08_CANOPY;
+        if(r < 9) return Icesat2Parameters::ATL08_TOP_OF_CANOPY;
+        return Icesat2Parameters::ATL08_NOISE;
+    };
+    auto relief = [&atl08](long i) -> float {
+        const uint8_t c = atl08(i);
+        if(c == Icesat2Parameters::ATL08_GROUND) return static_cast<float>(((i * 31) % 7) * 0.05 - 0.15);
+        if(c == Icesat2Parameters::ATL08_NOISE) return static_cast<float>(((i * 13) % 200) - 100);
+        return static_cast<float>(2.0 + ((i * 17) % 150) * 0.1);
+    };
+
+    df->time_ns.appendEach(NUM_PHOTONS, [](long i){ return time8_t(GPS_EPOCH_NS + (i * 100000LL)); });
+    df->latitude.appendEach(NUM_PHOTONS, [](long i){ return 40.0 + (i * PHOTON_SPACING * 9.0e-6); });
+    df->longitude.appendEach(NUM_PHOTONS, [](long i){ return -105.0 + (i * PHOTON_SPACING * 1.0e-6); });
+    df->segment_id.appendEach(NUM_PHOTONS, [](long i){ return static_cast<int32_t>(500000 + (i * PHOTON_SPACING / SEGMENT_LENGTH)); });
+    df->x_atc.appendEach(NUM_PHOTONS, [](long i){ return 1.0e7 + (i * PHOTON_SPACING); });
+    df->y_atc.appendEach(NUM_PHOTONS, [](long i){ return static_cast<float>(3200.0 + ((i % 5) * 0.1)); });
+    df->height.appendEach(NUM_PHOTONS, [&](long i){ return static_cast<float>(ground(i) + relief(i)); });
+    df->solar_elevation.appendValue(-10.0F, NUM_PHOTONS);
+    df->background_rate.appendValue(1.0e6F, NUM_PHOTONS);
+    df->spacecraft_velocity.appendValue(7000.0F, NUM_PHOTONS);
+    df->atl03_cnf.appendValue(4, NUM_PHOTONS);
+    df->quality_ph.appendValue(0, NUM_PHOTONS);
+    df->relief.appendEach(NUM_PHOTONS, relief);
+    df->landcover.appendValue(111, NUM_PHOTONS);
+    df->snowcover.appendValue(1, NUM_PHOTONS);
+    df->atl08_class.appendEach(NUM_PHOTONS, atl08);
+    df->setNumRows(df->ph_index.appendEach(NUM_PHOTONS, [](long i){ return static_cast<uint32_t>(i); }));
+}
+
+/*----------------------------------------------------------------------------
+ * createObject
+ *
+ *  objects are created through their lua factories with the arguments already
+ *  on the stack; a reference is taken and the stack cleared so the next call
+ *  starts at the first argument
+ *----------------------------------------------------------------------------*/
+static LuaObject* createObject (lua_State* L, lua_CFunction create, const char* object_type)
+{
+    if(create(L) != 1 || lua_isuserdata(L, -1) == 0)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "unable to create benchmark %s", object_type);
+    }
+    LuaObject* lua_obj = LuaObject::getLuaObject(L, -1, object_type);
+    lua_settop(L, 0);
+    return lua_obj;
+}
+
+/******************************************************************************
+ * METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * run
+ *
+ *  each runner replaces the photon columns of the dataframe it is run on, so
+ *  a fresh dataframe is built (untimed) before every call
+ *----------------------------------------------------------------------------*/
+void BM_Icesat2::run (BenchRunner& runner)
+{
+    lua_State* L = luaL_newstate();
+    Atl03Parameters* parms = NULL;
+    Atl03DataFrame* df = NULL;
+    GeoDataFrame::FrameRunner* fitter = NULL;
+    GeoDataFrame::FrameRunner* phoreal = NULL;
+
+    try
+    {
+        /* Parameters */
+        lua_newtable(L);
+        if(luaCreateParameters<Atl03Parameters>(L) != 1 || lua_isuserdata(L, -1) == 0)
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "unable to create benchmark parameters");
+        }
+        parms = dynamic_cast<Atl03Parameters*>(LuaObject::getLuaObject(L, -1, Atl03Parameters::OBJECT_TYPE));
+        lua_setglobal(L, "parms"); // held for the duration of the benchmarks
+        lua_settop(L, 0);
+        parms->stages[Icesat2Parameters::STAGE_ATL08] = true;
+        parms->stages[Icesat2Parameters::STAGE_PHOREAL] = true;
+
+        auto setup = [&]() {
+            if(df) df->releaseLuaObject();
+            lua_gc(L, LUA_GCCOLLECT, 0);
+            lua_pushstring(L, "gt1l");
+            lua_getglobal(L, "parms"); // released by dataframe
+            df = dynamic_cast<Atl03DataFrame*>(createObject(L, Atl03DataFrame::luaCreate, GeoDataFrame::OBJECT_TYPE));
+            populate(df);
+        };
+
+        /* Surface Fitter */
+        lua_getglobal(L, "parms"); // released by fitter
+        fitter = dynamic_cast<GeoDataFrame::FrameRunner*>(createObject(L, SurfaceFitter::luaCreate, GeoDataFrame::FrameRunner::OBJECT_TYPE));
+        runner.run(SUITE, "surface_fitter", NUM_PHOTONS, 0, setup, [&]() {
+            fitter->run(df);
+            benchKeep(df->length());
+        });
+
+        /* PhoREAL */
+        lua_getglobal(L, "parms"); // released by phoreal
+        phoreal = dynamic_cast<GeoDataFrame::FrameRunner*>(createObject(L, PhoReal::luaCreate, GeoDataFrame::FrameRunner::OBJECT_TYPE));
+        runner.run(SUITE, "phoreal", NUM_PHOTONS, 0, setup, [&]() {
+            phoreal->run(df);
+            benchKeep(df->length());
+        });
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Failed to run icesat2 benchmarks: %s", e.what());
+    }
+
+    if(phoreal) phoreal->releaseLuaObject();
+    if(fitter) fitter->releaseLuaObject();
+    if(df) df->releaseLuaObject();
+    if(parms) parms->releaseLuaObject();
+    lua_close(L);
+}
+
+#else
+
+void BM_Icesat2::run (BenchRunner& runner)
+{
+    (void)runner;
+}
+
+#endif
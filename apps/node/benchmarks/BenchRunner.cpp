@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "StringLib.h"
+#include "BenchRunner.h"
+
+#include <algorithm>
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const double BenchRunner::DEFAULT_MIN_TIME = 0.5;
+
+/******************************************************************************
+ * METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+BenchRunner::BenchRunner (const char* _filter, double _min_time, long _max_iterations):
+    filter(_filter),
+    minTime(_min_time),
+    maxIterations(MAX(_max_iterations, MIN_ITERATIONS))
+{
+}
+
+/*----------------------------------------------------------------------------
+ * selected - filter is matched against "<suite>/<name>"
+ *----------------------------------------------------------------------------*/
+bool BenchRunner::selected (const char* suite, const char* name) const
+{
+    if(filter == NULL) return true;
+    const FString full_name("%s/%s", suite, name);
+    return StringLib::find(full_name.c_str(), filter) != NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * report
+ *----------------------------------------------------------------------------*/
+void BenchRunner::report (const char* suite, const char* name, long items, long bytes, vector<double>& samples)
+{
+    std::sort(samples.begin(), samples.end());
+
+    result_t result = {
+        .suite = suite,
+        .name = name,
+        .iterations = static_cast<long>(samples.size()),
+        .items = items,
+        .bytes = bytes,
+        .total = 0.0,
+        .mean = 0.0,
+        .min = samples.front(),
+        .p50 = samples[samples.size() / 2],
+        .p99 = samples[MIN(samples.size() - 1, (samples.size() * 99) / 100)]
+    };
+    for(const double sample: samples) result.total += sample;
+    result.mean = result.total / result.iterations;
+
+    const double items_per_sec = (items * result.iterations) / result.total;
+    const double mbytes_per_sec = (bytes * result.iterations) / result.total / 1000000.0;
+    print2term("%-8s %-36s %9ld calls %12.3lf us/call (p50) %12.3lf us/call (p99) %14.0lf items/s %10.1lf MB/s\n",
+               suite, name, result.iterations, result.p50 * 1000000.0, result.p99 * 1000000.0, items_per_sec, mbytes_per_sec);
+
+    results.push_back(result);
+}
+
+/*----------------------------------------------------------------------------
+ * toJson
+ *----------------------------------------------------------------------------*/
+string BenchRunner::toJson (void) const
+{
+    string json = FString("{\"version\":\"%s\",\"build\":\"%s\",\"cpus\":%d,\"min_time\":%lf,\"results\":[", LIBID, BUILDINFO, OsApi::nproc(), minTime).c_str();
+
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        const result_t& r = results[i];
+        json += FString("%s{\"suite\":\"%s\",\"name\":\"%s\",\"iterations\":%ld,\"items_per_call\":%ld,\"bytes_per_call\":%ld,"
+                        "\"total_s\":%.9lf,\"mean_us\":%.3lf,\"min_us\":%.3lf,\"p50_us\":%.3lf,\"p99_us\":%.3lf,"
+                        "\"items_per_s\":%.1lf,\"mbytes_per_s\":%.3lf}",
+                        i > 0 ? "," : "", r.suite.c_str(), r.name.c_str(), r.iterations, r.items, r.bytes,
+                        r.total, r.mean * 1000000.0, r.min * 1000000.0, r.p50 * 1000000.0, r.p99 * 1000000.0,
+                        (r.items * r.iterations) / r.total, (r.bytes * r.iterations) / r.total / 1000000.0).c_str();
+    }
+
+    json += "]}\n";
+    return json;
+}
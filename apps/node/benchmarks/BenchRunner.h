@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __bench_runner__
+#define __bench_runner__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+
+#include <chrono>
+
+/******************************************************************************
+ * BenchRunner CLASS
+ *
+ *  Times a benchmark function until a minimum amount of time has elapsed and
+ *  records the latency of each call; each call processes a fixed number of
+ *  items and bytes so that throughput can be reported alongside latency
+ ******************************************************************************/
+
+class BenchRunner
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const long MIN_ITERATIONS = 5;
+        static const long DEFAULT_MAX_ITERATIONS = 1000000;
+        static const double DEFAULT_MIN_TIME; // seconds
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        typedef struct {
+            string      suite;
+            string      name;
+            long        iterations;     // number of timed calls
+            long        items;          // items processed per call
+            long        bytes;          // bytes processed per call
+            double      total;          // seconds across all timed calls
+            double      mean;           // seconds per call
+            double      min;            // seconds per call
+            double      p50;            // seconds per call
+            double      p99;            // seconds per call
+        } result_t;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+                        BenchRunner     (const char* _filter, double _min_time=DEFAULT_MIN_TIME, long _max_iterations=DEFAULT_MAX_ITERATIONS);
+                        ~BenchRunner    (void) = default;
+
+        bool            selected        (const char* suite, const char* name) const;
+        void            report          (const char* suite, const char* name, long items, long bytes, vector<double>& samples);
+        string          toJson          (void) const;
+        long            numResults      (void) const { return static_cast<long>(results.size()); }
+
+        /*--------------------------------------------------------------------
+         * Template Methods
+         *--------------------------------------------------------------------*/
+
+        /* setup is called before every call to func and is not timed */
+        template<class S, class F>
+        void run (const char* suite, const char* name, long items, long bytes, S setup, F func)
+        {
+            if(!selected(suite, name)) return;
+
+            vector<double> samples;
+            setup();
+            func(); // warm up
+
+            double elapsed = 0.0;
+            while((elapsed < minTime || static_cast<long>(samples.size()) < MIN_ITERATIONS) &&
+                  (static_cast<long>(samples.size()) < maxIterations))
+            {
+                setup();
+                const auto start = std::chrono::steady_clock::now();
+                func();
+                const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+                samples.push_back(duration.count());
+                elapsed += duration.count();
+            }
+
+            report(suite, name, items, bytes, samples);
+        }
+
+        template<class F>
+        void run (const char* suite, const char* name, long items, long bytes, F func)
+        {
+            run(suite, name, items, bytes, [](){}, func);
+        }
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        const char*         filter;
+        double              minTime;
+        long                maxIterations;
+        vector<result_t>    results;
+};
+
+/******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/* keeps the optimizer from discarding results that are otherwise unused */
+template<class T>
+inline void benchKeep (const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+#endif  /* __bench_runner__ */
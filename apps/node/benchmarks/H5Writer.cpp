@@ -0,0 +1,606 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "H5Writer.h"
+
+#include <zlib.h>
+
+/******************************************************************************
+ * LOCAL DATA
+ ******************************************************************************/
+
+static const uint8_t H5_SIGNATURE[8]    = {0x89, 'H', 'D', 'F', '\r', '\n', 0x1A, '\n'};
+static const uint8_t OHDR_SIGNATURE[4]  = {'O', 'H', 'D', 'R'};
+static const uint8_t TREE_SIGNATURE[4]  = {'T', 'R', 'E', 'E'};
+
+static const int DATASPACE_MSG  = 0x01;
+static const int LINK_INFO_MSG  = 0x02;
+static const int DATATYPE_MSG   = 0x03;
+static const int FILL_VALUE_MSG = 0x05;
+static const int LINK_MSG       = 0x06;
+static const int LAYOUT_MSG     = 0x08;
+static const int GROUP_INFO_MSG = 0x0A;
+static const int FILTER_MSG     = 0x0B;
+
+static const int DEFLATE_FILTER = 1;
+static const int SHUFFLE_FILTER = 2;
+
+static const uint8_t CONSTANT_MSG_FLAG = 0x01;
+
+/******************************************************************************
+ * METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+H5Writer::H5Writer (const char* _filename):
+    filename(_filename),
+    eof(SUPERBLOCK_SIZE)
+{
+    root.group = true;
+    file = fopen(filename, "w+b");
+    if(file == NULL)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to create h5 file: %s", filename);
+    }
+
+    /* Reserve Superblock (written on close) */
+    const uint8_t superblock[SUPERBLOCK_SIZE] = {0};
+    if(fwrite(superblock, 1, SUPERBLOCK_SIZE, file) != SUPERBLOCK_SIZE)
+    {
+        fclose(file);
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to write superblock to h5 file: %s", filename);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor
+ *----------------------------------------------------------------------------*/
+H5Writer::~H5Writer (void)
+{
+    if(file) fclose(file); // file was never closed and is incomplete
+}
+
+/*----------------------------------------------------------------------------
+ * addDataset
+ *
+ *  the dataset is one dimensional when cols is zero and two dimensional
+ *  otherwise; chunks span chunk_rows rows and all of the columns, and the
+ *  intermediate groups in the path are created as needed
+ *----------------------------------------------------------------------------*/
+void H5Writer::addDataset (const char* path, RecordObject::fieldType_t type, const void* data, int64_t rows, int64_t cols, int64_t chunk_rows, int deflate_level, bool shuffle_data)
+{
+    const int type_size = typeSize(type);
+    const int ndims = (cols > 0) ? 2 : 1;
+    const int64_t row_elements = (cols > 0) ? cols : 1;
+    const int64_t row_size = row_elements * type_size;
+    const bool chunked = chunk_rows != CONTIGUOUS;
+
+    /* Check Parameters */
+    if(file == NULL)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "h5 file already closed: %s", filename);
+    }
+    if(rows <= 0 || cols < 0 || chunk_rows < 0)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid dimensions for %s: %ld x %ld, chunk of %ld", path, (long)rows, (long)cols, (long)chunk_rows);
+    }
+    if(!chunked && (deflate_level != NO_DEFLATE || shuffle_data))
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "filters require a chunked dataset: %s", path);
+    }
+
+    /* Create Dataset Object */
+    string name;
+    object_t* parent = makeGroups(path, name);
+    object_t* dataset = new object_t;
+    dataset->group = false;
+    parent->children[name] = dataset;
+
+    /* Dataspace Message */
+    vector<uint8_t> dataspace;
+    put(dataspace, 2, 1);                           // version
+    put(dataspace, ndims, 1);                       // dimensionality
+    put(dataspace, 0, 1);                           // flags - no maximum dimensions
+    put(dataspace, 1, 1);                           // simple dataspace
+    put(dataspace, rows, 8);
+    if(cols > 0) put(dataspace, cols, 8);
+    putMessage(dataset->messages, DATASPACE_MSG, dataspace);
+
+    /* Datatype Message */
+    vector<uint8_t> datatype;
+    if(type == RecordObject::FLOAT || type == RecordObject::DOUBLE)
+    {
+        const bool dbl = type == RecordObject::DOUBLE;
+        const uint32_t bit_field = 0x20 | ((dbl ? 63 : 31) << 8); // little endian, implied msb, sign bit location
+        put(datatype, 0x11 | (bit_field << 8), 4);  // version 1, floating point class
+        put(datatype, type_size, 4);
+        put(datatype, 0, 2);                        // bit offset
+        put(datatype, type_size * 8, 2);            // bit precision
+        put(datatype, dbl ? 52 : 23, 1);            // exponent location
+        put(datatype, dbl ? 11 : 8, 1);             // exponent size
+        put(datatype, 0, 1);                        // mantissa location
+        put(datatype, dbl ? 52 : 23, 1);            // mantissa size
+        put(datatype, dbl ? 1023 : 127, 4);         // exponent bias
+    }
+    else
+    {
+        const bool is_signed = type == RecordObject::INT8 || type == RecordObject::INT16 || type == RecordObject::INT32 || type == RecordObject::INT64;
+        const uint32_t bit_field = is_signed ? 0x08 : 0x00; // little endian
+        put(datatype, 0x10 | (bit_field << 8), 4);  // version 1, fixed point class
+        put(datatype, type_size, 4);
+        put(datatype, 0, 2);                        // bit offset
+        put(datatype, type_size * 8, 2);            // bit precision
+    }
+    putMessage(dataset->messages, DATATYPE_MSG, datatype, CONSTANT_MSG_FLAG);
+
+    /* Fill Value Message */
+    vector<uint8_t> fill_value;
+    put(fill_value, 3, 1);                          // version
+    put(fill_value, (chunked ? 3 : 2) | (2 << 2), 1); // allocation time (incremental or late), write fill value if set
+    putMessage(dataset->messages, FILL_VALUE_MSG, fill_value, CONSTANT_MSG_FLAG);
+
+    /* Contiguous Dataset */
+    if(!chunked)
+    {
+        const uint64_t address = append(data, rows * row_size);
+
+        vector<uint8_t> layout;
+        put(layout, 3, 1);                          // version
+        put(layout, 1, 1);                          // contiguous
+        put(layout, address, 8);
+        put(layout, rows * row_size, 8);
+        putMessage(dataset->messages, LAYOUT_MSG, layout);
+        return;
+    }
+
+    /* Filter Pipeline Message */
+    const int num_filters = (shuffle_data ? 1 : 0) + (deflate_level != NO_DEFLATE ? 1 : 0);
+    if(num_filters > 0)
+    {
+        vector<uint8_t> filters;
+        put(filters, 2, 1);                         // version
+        put(filters, num_filters, 1);
+        if(shuffle_data)
+        {
+            put(filters, SHUFFLE_FILTER, 2);
+            put(filters, 0, 2);                     // flags
+            put(filters, 1, 2);                     // number of client values
+            put(filters, type_size, 4);
+        }
+        if(deflate_level != NO_DEFLATE)
+        {
+            put(filters, DEFLATE_FILTER, 2);
+            put(filters, 0, 2);                     // flags
+            put(filters, 1, 2);                     // number of client values
+            put(filters, deflate_level, 4);
+        }
+        putMessage(dataset->messages, FILTER_MSG, filters);
+    }
+
+    /* Write Chunks (the last chunk is padded out to the full chunk size) */
+    const int64_t chunk_size = chunk_rows * row_size;
+    vector<uint8_t> raw(chunk_size);
+    vector<uint8_t> shuffled(chunk_size);
+    vector<uint8_t> deflated(compressBound(chunk_size));
+    vector<chunk_t> chunks;
+    for(int64_t row = 0; row < rows; row += chunk_rows)
+    {
+        const int64_t num_rows = MIN(chunk_rows, rows - row);
+        memset(raw.data(), 0, chunk_size);
+        memcpy(raw.data(), reinterpret_cast<const uint8_t*>(data) + (row * row_size), num_rows * row_size);
+
+        const uint8_t* chunk = raw.data();
+        int64_t size = chunk_size;
+        if(shuffle_data)
+        {
+            shuffle(chunk, shuffled.data(), chunk_size / type_size, type_size);
+            chunk = shuffled.data();
+        }
+        if(deflate_level != NO_DEFLATE)
+        {
+            uLongf deflated_size = deflated.size();
+            if(compress2(deflated.data(), &deflated_size, chunk, size, deflate_level) != Z_OK)
+            {
+                throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to deflate chunk at row %ld of %s", (long)row, path);
+            }
+            chunk = deflated.data();
+            size = static_cast<int64_t>(deflated_size);
+        }
+
+        const chunk_t entry = {
+            .size = static_cast<uint32_t>(size),
+            .address = append(chunk, size),
+            .row = row
+        };
+        chunks.push_back(entry);
+    }
+
+    /* Layout Message */
+    vector<uint8_t> layout;
+    put(layout, 3, 1);                              // version
+    put(layout, 2, 1);                              // chunked
+    put(layout, ndims + 1, 1);                      // dimensionality (includes element size)
+    put(layout, writeChunks(chunks, chunk_rows, cols), 8);
+    put(layout, chunk_rows, 4);
+    if(cols > 0) put(layout, cols, 4);
+    put(layout, type_size, 4);
+    putMessage(dataset->messages, LAYOUT_MSG, layout);
+}
+
+/*----------------------------------------------------------------------------
+ * close
+ *
+ *  writes the group headers and superblock, returns the size of the file
+ *----------------------------------------------------------------------------*/
+uint64_t H5Writer::close (void)
+{
+    if(file == NULL)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "h5 file already closed: %s", filename);
+    }
+
+    /* Write Object Headers */
+    const uint64_t root_address = writeObject(&root);
+
+    /* Write Superblock */
+    vector<uint8_t> superblock(H5_SIGNATURE, H5_SIGNATURE + sizeof(H5_SIGNATURE));
+    put(superblock, 2, 1);                          // version
+    put(superblock, 8, 1);                          // size of offsets
+    put(superblock, 8, 1);                          // size of lengths
+    put(superblock, 0, 1);                          // file consistency flags
+    put(superblock, 0, 8);                          // base address
+    put(superblock, UNDEFINED_ADDRESS, 8);          // superblock extension address
+    put(superblock, eof, 8);                        // end of file address
+    put(superblock, root_address, 8);
+    put(superblock, checksum(superblock.data(), superblock.size()), 4);
+    assert(superblock.size() == SUPERBLOCK_SIZE);
+
+    const bool status = (fseeko(file, 0, SEEK_SET) == 0) &&
+                        (fwrite(superblock.data(), 1, superblock.size(), file) == superblock.size());
+    fclose(file);
+    file = NULL;
+
+    if(!status)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to write superblock to h5 file: %s", filename);
+    }
+
+    return eof;
+}
+
+/*----------------------------------------------------------------------------
+ * typeSize
+ *----------------------------------------------------------------------------*/
+int H5Writer::typeSize (RecordObject::fieldType_t type)
+{
+    switch(type)
+    {
+        case RecordObject::INT8:    return 1;
+        case RecordObject::UINT8:   return 1;
+        case RecordObject::INT16:   return 2;
+        case RecordObject::UINT16:  return 2;
+        case RecordObject::INT32:   return 4;
+        case RecordObject::UINT32:  return 4;
+        case RecordObject::INT64:   return 8;
+        case RecordObject::UINT64:  return 8;
+        case RecordObject::FLOAT:   return 4;
+        case RecordObject::DOUBLE:  return 8;
+        default: throw RunTimeException(CRITICAL, RTE_FAILURE, "unsupported h5 dataset type: %d", static_cast<int>(type));
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * append - writes data at the end of the file, returns its address
+ *----------------------------------------------------------------------------*/
+uint64_t H5Writer::append (const void* data, int64_t size)
+{
+    const uint64_t address = eof;
+    if( (fseeko(file, static_cast<off_t>(address), SEEK_SET) != 0) ||
+        (fwrite(data, 1, size, file) != static_cast<size_t>(size)) )
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to write %ld bytes to h5 file: %s", (long)size, filename);
+    }
+    eof += size;
+    return address;
+}
+
+/*----------------------------------------------------------------------------
+ * writeObject - writes children before parents so link addresses are known
+ *----------------------------------------------------------------------------*/
+uint64_t H5Writer::writeObject (object_t* object)
+{
+    vector<uint8_t> messages;
+
+    if(object->group)
+    {
+        /* Link Info - compact storage, no fractal heap or name index */
+        vector<uint8_t> link_info;
+        put(link_info, 0, 1);                       // version
+        put(link_info, 0, 1);                       // flags
+        put(link_info, UNDEFINED_ADDRESS, 8);       // fractal heap address
+        put(link_info, UNDEFINED_ADDRESS, 8);       // name index b-tree address
+        putMessage(messages, LINK_INFO_MSG, link_info);
+
+        /* Group Info - defaults */
+        const vector<uint8_t> group_info = {0, 0};  // version, flags
+        putMessage(messages, GROUP_INFO_MSG, group_info);
+
+        /* Hard Links */
+        for(auto& child: object->children)
+        {
+            const string& name = child.first;
+            const uint64_t address = writeObject(child.second);
+
+            vector<uint8_t> link;
+            put(link, 1, 1);                        // version
+            put(link, 0, 1);                        // flags - one byte name length, hard link
+            put(link, name.size(), 1);
+            link.insert(link.end(), name.begin(), name.end());
+            put(link, address, 8);
+            putMessage(messages, LINK_MSG, link);
+        }
+    }
+    else
+    {
+        messages = object->messages;
+    }
+
+    /* Object Header */
+    vector<uint8_t> header(OHDR_SIGNATURE, OHDR_SIGNATURE + sizeof(OHDR_SIGNATURE));
+    put(header, 2, 1);                              // version
+    put(header, 0x02, 1);                           // flags - four byte chunk size
+    put(header, messages.size(), 4);
+    header.insert(header.end(), messages.begin(), messages.end());
+    put(header, checksum(header.data(), header.size()), 4);
+
+    return append(header.data(), header.size());
+}
+
+/*----------------------------------------------------------------------------
+ * writeChunks
+ *
+ *  builds the version 1 b-tree indexing the chunks bottom up, one level at a
+ *  time with nodes of at most 2k entries, and returns the address of the root
+ *----------------------------------------------------------------------------*/
+uint64_t H5Writer::writeChunks (const vector<chunk_t>& chunks, int64_t chunk_rows, int64_t cols)
+{
+    const int ndims = (cols > 0) ? 2 : 1;
+    const int64_t key_size = 8 + ((ndims + 1) * 8);
+    const int64_t node_size = 24 + ((2 * BTREE_K) * 8) + (((2 * BTREE_K) + 1) * key_size);
+
+    /* Leaves */
+    vector<node_t> children;
+    for(const chunk_t& chunk: chunks)
+    {
+        const node_t child = {
+            .address = chunk.address,
+            .first_row = chunk.row,
+            .last_row = chunk.row + chunk_rows
+        };
+        children.push_back(child);
+    }
+
+    /* Levels */
+    int level = 0;
+    do
+    {
+        const long num_nodes = (static_cast<long>(children.size()) + (2 * BTREE_K) - 1) / (2 * BTREE_K);
+        const uint64_t level_address = eof;
+        vector<node_t> parents;
+
+        for(long n = 0; n < num_nodes; n++)
+        {
+            const long first = n * 2 * BTREE_K;
+            const long last = MIN(first + (2 * BTREE_K), static_cast<long>(children.size())); // exclusive
+            const uint64_t address = level_address + (n * node_size);
+
+            vector<uint8_t> node(TREE_SIGNATURE, TREE_SIGNATURE + sizeof(TREE_SIGNATURE));
+            put(node, 1, 1);                        // raw data chunk node
+            put(node, level, 1);
+            put(node, last - first, 2);             // entries used
+            put(node, n > 0 ? address - node_size : UNDEFINED_ADDRESS, 8);
+            put(node, n < (num_nodes - 1) ? address + node_size : UNDEFINED_ADDRESS, 8);
+            for(long c = first; c < last; c++)
+            {
+                const uint32_t size = (level == 0) ? chunks[c].size : 0;
+                putChunkKey(node, size, children[c].first_row, cols, false);
+                put(node, children[c].address, 8);
+            }
+            putChunkKey(node, 0, children[last - 1].last_row, cols, true);
+            node.resize(node_size, 0);
+
+            append(node.data(), node.size());
+
+            const node_t parent = {
+                .address = address,
+                .first_row = children[first].first_row,
+                .last_row = children[last - 1].last_row
+            };
+            parents.push_back(parent);
+        }
+
+        children = parents;
+        level++;
+    } while(children.size() > 1);
+
+    return children[0].address;
+}
+
+/*----------------------------------------------------------------------------
+ * makeGroups - returns the group holding the final path element
+ *----------------------------------------------------------------------------*/
+H5Writer::object_t* H5Writer::makeGroups (const char* path, string& name)
+{
+    object_t* group = &root;
+    string remaining(path);
+    while(!remaining.empty() && remaining[0] == '/') remaining.erase(0, 1);
+
+    size_t slash;
+    while((slash = remaining.find('/')) != string::npos)
+    {
+        const string element = remaining.substr(0, slash);
+        remaining.erase(0, slash + 1);
+
+        auto iter = group->children.find(element);
+        if(iter == group->children.end())
+        {
+            object_t* child = new object_t;
+            child->group = true;
+            group->children[element] = child;
+            group = child;
+        }
+        else if(iter->second->group)
+        {
+            group = iter->second;
+        }
+        else
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "path element is a dataset: %s in %s", element.c_str(), path);
+        }
+    }
+
+    if(remaining.empty() || remaining.size() > 255)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid dataset name: %s", path);
+    }
+    if(group->children.find(remaining) != group->children.end())
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "dataset already exists: %s", path);
+    }
+
+    name = remaining;
+    return group;
+}
+
+/*----------------------------------------------------------------------------
+ * put - little endian
+ *----------------------------------------------------------------------------*/
+void H5Writer::put (vector<uint8_t>& buf, uint64_t value, int size)
+{
+    for(int i = 0; i < size; i++)
+    {
+        buf.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * putMessage
+ *----------------------------------------------------------------------------*/
+void H5Writer::putMessage (vector<uint8_t>& buf, int type, const vector<uint8_t>& body, uint8_t flags)
+{
+    put(buf, type, 1);
+    put(buf, body.size(), 2);
+    put(buf, flags, 1);
+    buf.insert(buf.end(), body.begin(), body.end());
+}
+
+/*----------------------------------------------------------------------------
+ * putChunkKey
+ *
+ *  left keys hold the offset of the first element of the chunk, right keys
+ *  hold the offset one past the last element in every dimension
+ *----------------------------------------------------------------------------*/
+void H5Writer::putChunkKey (vector<uint8_t>& buf, uint32_t size, int64_t row, int64_t cols, bool right_key)
+{
+    put(buf, size, 4);
+    put(buf, 0, 4);                                 // filter mask
+    put(buf, row, 8);
+    if(cols > 0) put(buf, right_key ? cols : 0, 8);
+    put(buf, 0, 8);                                 // element offset
+}
+
+/*----------------------------------------------------------------------------
+ * shuffle - inverse of the hdf5 unshuffle filter
+ *----------------------------------------------------------------------------*/
+void H5Writer::shuffle (const uint8_t* input, uint8_t* output, int64_t num_elements, int type_size)
+{
+    for(int64_t element_index = 0; element_index < num_elements; element_index++)
+    {
+        for(int64_t val_index = 0; val_index < type_size; val_index++)
+        {
+            output[(val_index * num_elements) + element_index] = input[(element_index * type_size) + val_index];
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * checksum - Jenkins lookup3 hash used by hdf5 metadata
+ *----------------------------------------------------------------------------*/
+uint32_t H5Writer::checksum (const uint8_t* data, size_t length)
+{
+    #define LOOKUP3_ROT(x,k) (((x) << (k)) ^ ((x) >> (32 - (k))))
+
+    uint32_t a = 0xDEADBEEF + static_cast<uint32_t>(length);
+    uint32_t b = a;
+    uint32_t c = a;
+
+    while(length > 12)
+    {
+        a += data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+        b += data[4] | (data[5] << 8) | (data[6] << 16) | (static_cast<uint32_t>(data[7]) << 24);
+        c += data[8] | (data[9] << 8) | (data[10] << 16) | (static_cast<uint32_t>(data[11]) << 24);
+        a -= c;  a ^= LOOKUP3_ROT(c, 4);  c += b;
+        b -= a;  b ^= LOOKUP3_ROT(a, 6);  a += c;
+        c -= b;  c ^= LOOKUP3_ROT(b, 8);  b += a;
+        a -= c;  a ^= LOOKUP3_ROT(c, 16); c += b;
+        b -= a;  b ^= LOOKUP3_ROT(a, 19); a += c;
+        c -= b;  c ^= LOOKUP3_ROT(b, 4);  b += a;
+        length -= 12;
+        data += 12;
+    }
+
+    if(length > 0)
+    {
+        uint32_t* words[3] = {&a, &b, &c};
+        for(size_t i = 0; i < length; i++)
+        {
+            *words[i / 4] += static_cast<uint32_t>(data[i]) << ((i % 4) * 8);
+        }
+        c ^= b; c -= LOOKUP3_ROT(b, 14);
+        a ^= c; a -= LOOKUP3_ROT(c, 11);
+        b ^= a; b -= LOOKUP3_ROT(a, 25);
+        c ^= b; c -= LOOKUP3_ROT(b, 16);
+        a ^= c; a -= LOOKUP3_ROT(c, 4);
+        b ^= a; b -= LOOKUP3_ROT(a, 14);
+        c ^= b; c -= LOOKUP3_ROT(b, 24);
+    }
+
+    #undef LOOKUP3_ROT
+
+    return c;
+}
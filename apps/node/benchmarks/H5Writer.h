@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __h5_writer__
+#define __h5_writer__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "RecordObject.h"
+
+#include <map>
+
+/******************************************************************************
+ * H5Writer CLASS
+ *
+ *  Writes small HDF5 files with the subset of the format that h5coro reads:
+ *  version 2 superblock and object headers, compact link storage for groups,
+ *  and contiguous or chunked numeric datasets indexed by a version 1 b-tree
+ *  with optional shuffle and deflate filters.  Used to generate synthetic
+ *  granules so that the read path can be exercised without network access.
+ ******************************************************************************/
+
+class H5Writer
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int64_t CONTIGUOUS = 0;    // chunk_rows for an unchunked dataset
+        static const int NO_DEFLATE = -1;       // deflate_level for an uncompressed dataset
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        explicit        H5Writer        (const char* _filename);
+                        ~H5Writer       (void);
+
+        void            addDataset      (const char* path, RecordObject::fieldType_t type, const void* data,
+                                         int64_t rows, int64_t cols=0, int64_t chunk_rows=CONTIGUOUS,
+                                         int deflate_level=NO_DEFLATE, bool shuffle=false);
+        uint64_t        close           (void);
+
+        static int      typeSize        (RecordObject::fieldType_t type);
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int SUPERBLOCK_SIZE = 48;
+        static const int BTREE_K = 32;          // default k of the chunk b-tree, nodes hold 2k entries
+        static const uint64_t UNDEFINED_ADDRESS = 0xFFFFFFFFFFFFFFFFULL;
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        struct object_t {
+            bool                            group;
+            vector<uint8_t>                 messages;   // dataset header messages
+            std::map<string, object_t*>     children;   // group members
+            ~object_t(void) { for(auto& child: children) delete child.second; }
+        };
+
+        typedef struct {
+            uint32_t                        size;       // bytes stored
+            uint64_t                        address;
+            int64_t                         row;        // first row of chunk
+        } chunk_t;
+
+        typedef struct {
+            uint64_t                        address;
+            int64_t                         first_row;  // left key
+            int64_t                         last_row;   // right key
+        } node_t;
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        const char*         filename;
+        FILE*               file;
+        uint64_t            eof;
+        object_t            root;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        uint64_t            append          (const void* data, int64_t size);
+        uint64_t            writeObject     (object_t* object);
+        uint64_t            writeChunks     (const vector<chunk_t>& chunks, int64_t chunk_rows, int64_t cols);
+        object_t*           makeGroups      (const char* path, string& name);
+
+        static void         put             (vector<uint8_t>& buf, uint64_t value, int size);
+        static void         putMessage      (vector<uint8_t>& buf, int type, const vector<uint8_t>& body, uint8_t flags=0);
+        static void         putChunkKey     (vector<uint8_t>& buf, uint32_t size, int64_t row, int64_t cols, bool right_key);
+        static void         shuffle         (const uint8_t* input, uint8_t* output, int64_t num_elements, int type_size);
+        static uint32_t     checksum        (const uint8_t* data, size_t length);
+};
+
+#endif  /* __h5_writer__ */
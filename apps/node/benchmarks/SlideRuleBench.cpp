@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ INCLUDES
+ ******************************************************************************/
+
+#include "core.h"
+#include "StringLib.h"
+#include "OsApi.h"
+
+#ifdef __h5coro__
+#include "h5coro.h"
+#endif
+
+#ifdef __icesat2__
+#include "icesat2.h"
+#endif
+
+#include "BenchRunner.h"
+#include "BM_Core.h"
+#include "BM_H5Coro.h"
+#include "BM_Icesat2.h"
+#include "SyntheticGranule.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+/******************************************************************************
+ LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/*
+ * usage - Print command line options
+ */
+static void usage (const char* app)
+{
+    print2term("Usage: %s [-f|--filter <suite/name substring>] [-t|--time <seconds per benchmark>] [-o|--output <json file>] [-g|--granules <directory> [-n|--segments <per beam>]]\n", app);
+}
+
+/******************************************************************************
+ MAIN
+ ******************************************************************************/
+
+int main (int argc, char* argv[])
+{
+    const char* filter = NULL;
+    const char* output = NULL;
+    const char* granules = NULL;
+    int64_t num_segments = SyntheticGranule::DEFAULT_SEGMENTS;
+    double min_time = BenchRunner::DEFAULT_MIN_TIME;
+
+    /* Parse Command Line */
+    for(int i = 1; i < argc; i++)
+    {
+        const bool has_value = (i + 1) < argc;
+        if((StringLib::match(argv[i], "-f") || StringLib::match(argv[i], "--filter")) && has_value)
+        {
+            filter = argv[++i];
+        }
+        else if((StringLib::match(argv[i], "-t") || StringLib::match(argv[i], "--time")) && has_value)
+        {
+            min_time = strtod(argv[++i], NULL);
+        }
+        else if((StringLib::match(argv[i], "-o") || StringLib::match(argv[i], "--output")) && has_value)
+        {
+            output = argv[++i];
+        }
+        else if((StringLib::match(argv[i], "-g") || StringLib::match(argv[i], "--granules")) && has_value)
+        {
+            granules = argv[++i];
+        }
+        else if((StringLib::match(argv[i], "-n") || StringLib::match(argv[i], "--segments")) && has_value)
+        {
+            num_segments = strtoll(argv[++i], NULL, 0);
+        }
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    /* Generate Synthetic Granules (for replay.lua) */
+    if(granules)
+    {
+        try
+        {
+            const uint64_t size = SyntheticGranule::write(granules, num_segments);
+            print2term("Wrote %s and %s to %s (%lu bytes)\n", SyntheticGranule::ATL03_RESOURCE, SyntheticGranule::ATL08_RESOURCE, granules, static_cast<unsigned long>(size));
+            return 0;
+        }
+        catch(const RunTimeException& e)
+        {
+            print2term("Failed to write granules: %s\n", e.what());
+            return -1;
+        }
+    }
+
+    /* Initialize Built-In Packages */
+    initcore();
+
+    #ifdef __h5coro__
+        inith5coro();
+    #endif
+
+    #ifdef __icesat2__
+        initicesat2();
+    #endif
+
+    /* Run Benchmarks */
+    BenchRunner runner(filter, min_time);
+    BM_Core::run(runner);
+    BM_H5Coro::run(runner);
+    BM_Icesat2::run(runner);
+
+    /* Write Results */
+    const string json = runner.toJson();
+    int status = 0;
+    if(output)
+    {
+        FILE* fp = fopen(output, "w");
+        if(fp)
+        {
+            fwrite(json.c_str(), 1, json.size(), fp);
+            fclose(fp);
+            print2term("Wrote %ld results to %s\n", runner.numResults(), output);
+        }
+        else
+        {
+            print2term("Failed to open %s for writing\n", output);
+            status = -1;
+        }
+    }
+    else
+    {
+        printf("%s\n", json.c_str());
+    }
+
+    /* Clean Up Built-In Packages */
+    #ifdef __icesat2__
+        deiniticesat2();
+    #endif
+
+    #ifdef __h5coro__
+        deinith5coro();
+    #endif
+
+    deinitcore();
+
+    return status;
+}
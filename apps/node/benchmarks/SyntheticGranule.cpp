@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "StringLib.h"
+#include "SyntheticGranule.h"
+
+#include <cmath>
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* SyntheticGranule::ATL03_RESOURCE = "ATL03_20200101000000_01230605_006_01.h5";
+const char* SyntheticGranule::ATL08_RESOURCE = "ATL08_20200101000000_01230605_006_01.h5";
+
+const char* SyntheticGranule::BEAMS[NUM_BEAMS] = {"gt1l", "gt1r", "gt2l", "gt2r", "gt3l", "gt3r"};
+
+/******************************************************************************
+ * LOCAL DATA
+ ******************************************************************************/
+
+static const double SEGMENT_LENGTH = 20.0;          // meters
+static const double GROUND_SPEED = 7000.0;          // meters per second
+static const double START_DISTANCE = 10000000.0;    // along track distance of first segment
+static const double START_TIME = 62985600.0;        // seconds since ATLAS SDP epoch
+static const double BACKGROUND_PERIOD = 0.02;       // seconds, 50Hz
+
+/******************************************************************************
+ * METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * write - returns the combined size of both granules
+ *----------------------------------------------------------------------------*/
+uint64_t SyntheticGranule::write (const char* directory, int64_t num_segments)
+{
+    const FString atl03_filename("%s/%s", directory, ATL03_RESOURCE);
+    const FString atl08_filename("%s/%s", directory, ATL08_RESOURCE);
+    H5Writer atl03(atl03_filename.c_str());
+    H5Writer atl08(atl08_filename.c_str());
+
+    /* Orbit Info - forward orientation */
+    const int8_t sc_orient = 1;
+    atl03.addDataset("/orbit_info/sc_orient", RecordObject::INT8, &sc_orient, 1);
+
+    /* Beams */
+    for(int b = 0; b < NUM_BEAMS; b++)
+    {
+        writeBeam(atl03, atl08, b, num_segments);
+    }
+
+    return atl03.close() + atl08.close();
+}
+
+/*----------------------------------------------------------------------------
+ * writeBeam
+ *
+ *  strong (left) beams have four times the photon rate of weak (right) beams;
+ *  half the photons are ground, four tenths are canopy, and the rest noise
+ *----------------------------------------------------------------------------*/
+void SyntheticGranule::writeBeam (H5Writer& atl03, H5Writer& atl08, int beam_index, int64_t num_segments)
+{
+    const char* beam = BEAMS[beam_index];
+    const bool strong = (beam_index % 2) == 0;
+    const int track = beam_index / 2;
+    const double across_offset = (track - 1) * 3300.0 + (strong ? 0.0 : 90.0);
+
+    /* Segment Datasets */
+    vector<double> seg_delta_time(num_segments);
+    vector<int32_t> segment_id(num_segments);
+    vector<double> segment_dist_x(num_segments);
+    vector<float> solar_elevation(num_segments);
+    vector<int8_t> podppd_flag(num_segments, 0);
+    vector<float> velocity_sc(num_segments * 3);
+    vector<double> ref_lat(num_segments);
+    vector<double> ref_lon(num_segments);
+    vector<int32_t> segment_ph_cnt(num_segments);
+    vector<float> geoid(num_segments);
+    int64_t num_photons = 0;
+    for(int64_t s = 0; s < num_segments; s++)
+    {
+        const double distance = s * SEGMENT_LENGTH;
+        seg_delta_time[s] = START_TIME + (distance / GROUND_SPEED);
+        segment_id[s] = static_cast<int32_t>(500000 + s);
+        segment_dist_x[s] = START_DISTANCE + distance;
+        solar_elevation[s] = -10.0F;
+        velocity_sc[(s * 3) + 0] = 6990.0F;
+        velocity_sc[(s * 3) + 1] = 350.0F;
+        velocity_sc[(s * 3) + 2] = 100.0F;
+        ref_lat[s] = 40.0 + (distance * 9.0e-6);
+        ref_lon[s] = -105.0 + (across_offset * 1.2e-5) + (distance * 1.0e-6);
+        segment_ph_cnt[s] = static_cast<int32_t>((strong ? 16 : 4) + ((s * 7919) % 5) - 2);
+        geoid[s] = -15.0F;
+        num_photons += segment_ph_cnt[s];
+    }
+
+    /* Photon Datasets */
+    vector<float> dist_ph_along(num_photons);
+    vector<float> dist_ph_across(num_photons);
+    vector<float> h_ph(num_photons);
+    vector<int8_t> signal_conf_ph(num_photons * 5);
+    vector<int8_t> quality_ph(num_photons, 0);
+    vector<uint8_t> weight_ph(num_photons);
+    vector<double> lat_ph(num_photons);
+    vector<double> lon_ph(num_photons);
+    vector<double> ph_delta_time(num_photons);
+
+    /* ATL08 Photon Datasets */
+    vector<int32_t> ph_segment_id(num_photons);
+    vector<int32_t> classed_pc_indx(num_photons);
+    vector<int8_t> classed_pc_flag(num_photons);
+    vector<float> ph_h(num_photons);
+
+    int64_t p = 0;
+    for(int64_t s = 0; s < num_segments; s++)
+    {
+        for(int32_t k = 1; k <= segment_ph_cnt[s]; k++, p++)
+        {
+            const float along = static_cast<float>((k - 0.5) * SEGMENT_LENGTH / segment_ph_cnt[s]);
+            const double distance = (s * SEGMENT_LENGTH) + along;
+            const double ground = 800.0 + (distance * 0.01) + (5.0 * sin(distance / 1000.0));
+            const long r = ((p + beam_index) * 2654435761L) % 100;
+
+            int8_t atl08_class;
+            float relief;
+            int8_t cnf;
+            if(r < 50)      { atl08_class = 1; relief = static_cast<float>(((p * 31) % 7) * 0.05 - 0.15); cnf = 4; }
+            else if(r < 80) { atl08_class = 2; relief = static_cast<float>(2.0 + ((p * 17) % 120) * 0.1); cnf = 3; }
+            else if(r < 90) { atl08_class = 3; relief = static_cast<float>(14.0 + ((p * 13) % 30) * 0.1); cnf = 2; }
+            else            { atl08_class = 0; relief = static_cast<float>(((p * 13) % 200) - 100); cnf = 0; }
+
+            dist_ph_along[p] = along;
+            dist_ph_across[p] = static_cast<float>(across_offset + ((p % 9) - 4) * 0.5);
+            h_ph[p] = static_cast<float>(ground + relief);
+            for(int c = 0; c < 5; c++) signal_conf_ph[(p * 5) + c] = cnf;
+            weight_ph[p] = (atl08_class == 0) ? 0 : 200;
+            lat_ph[p] = 40.0 + (distance * 9.0e-6);
+            lon_ph[p] = -105.0 + (across_offset * 1.2e-5) + (distance * 1.0e-6);
+            ph_delta_time[p] = START_TIME + (distance / GROUND_SPEED);
+
+            ph_segment_id[p] = segment_id[s];
+            classed_pc_indx[p] = k;
+            classed_pc_flag[p] = atl08_class;
+            ph_h[p] = relief;
+        }
+    }
+
+    /* Background Datasets */
+    const double track_time = (num_segments * SEGMENT_LENGTH) / GROUND_SPEED;
+    const int64_t num_background = static_cast<int64_t>(track_time / BACKGROUND_PERIOD) + 1;
+    vector<double> bckgrd_delta_time(num_background);
+    vector<float> bckgrd_rate(num_background);
+    for(int64_t i = 0; i < num_background; i++)
+    {
+        bckgrd_delta_time[i] = START_TIME + (i * BACKGROUND_PERIOD);
+        bckgrd_rate[i] = static_cast<float>(1.0e6 + ((i * 7) % 50) * 1.0e4);
+    }
+
+    /* Land Segment Datasets */
+    const int64_t num_land_segments = (num_segments + SEGMENTS_PER_LAND_SEGMENT - 1) / SEGMENTS_PER_LAND_SEGMENT;
+    vector<int32_t> segment_id_beg(num_land_segments);
+    vector<int16_t> segment_landcover(num_land_segments, 111);
+    vector<int8_t> segment_snowcover(num_land_segments, 1);
+    for(int64_t i = 0; i < num_land_segments; i++)
+    {
+        segment_id_beg[i] = segment_id[i * SEGMENTS_PER_LAND_SEGMENT];
+    }
+
+    /* Write ATL03 */
+    add(atl03, beam, "geolocation/delta_time",              RecordObject::DOUBLE,   seg_delta_time.data(),      num_segments);
+    add(atl03, beam, "geolocation/segment_id",              RecordObject::INT32,    segment_id.data(),          num_segments);
+    add(atl03, beam, "geolocation/segment_dist_x",          RecordObject::DOUBLE,   segment_dist_x.data(),      num_segments);
+    add(atl03, beam, "geolocation/solar_elevation",         RecordObject::FLOAT,    solar_elevation.data(),     num_segments);
+    add(atl03, beam, "geolocation/podppd_flag",             RecordObject::INT8,     podppd_flag.data(),         num_segments);
+    add(atl03, beam, "geolocation/velocity_sc",             RecordObject::FLOAT,    velocity_sc.data(),         num_segments, 3);
+    add(atl03, beam, "geolocation/reference_photon_lat",    RecordObject::DOUBLE,   ref_lat.data(),             num_segments);
+    add(atl03, beam, "geolocation/reference_photon_lon",    RecordObject::DOUBLE,   ref_lon.data(),             num_segments);
+    add(atl03, beam, "geolocation/segment_ph_cnt",          RecordObject::INT32,    segment_ph_cnt.data(),      num_segments);
+    add(atl03, beam, "geophys_corr/geoid",                  RecordObject::FLOAT,    geoid.data(),               num_segments);
+    add(atl03, beam, "heights/dist_ph_along",               RecordObject::FLOAT,    dist_ph_along.data(),       num_photons);
+    add(atl03, beam, "heights/dist_ph_across",              RecordObject::FLOAT,    dist_ph_across.data(),      num_photons);
+    add(atl03, beam, "heights/h_ph",                        RecordObject::FLOAT,    h_ph.data(),                num_photons);
+    add(atl03, beam, "heights/signal_conf_ph",              RecordObject::INT8,     signal_conf_ph.data(),      num_photons, 5);
+    add(atl03, beam, "heights/quality_ph",                  RecordObject::INT8,     quality_ph.data(),          num_photons);
+    add(atl03, beam, "heights/weight_ph",                   RecordObject::UINT8,    weight_ph.data(),           num_photons);
+    add(atl03, beam, "heights/lat_ph",                      RecordObject::DOUBLE,   lat_ph.data(),              num_photons);
+    add(atl03, beam, "heights/lon_ph",                      RecordObject::DOUBLE,   lon_ph.data(),              num_photons);
+    add(atl03, beam, "heights/delta_time",                  RecordObject::DOUBLE,   ph_delta_time.data(),       num_photons);
+    add(atl03, beam, "bckgrd_atlas/delta_time",             RecordObject::DOUBLE,   bckgrd_delta_time.data(),   num_background);
+    add(atl03, beam, "bckgrd_atlas/bckgrd_rate",            RecordObject::FLOAT,    bckgrd_rate.data(),         num_background);
+
+    /* Write ATL08 */
+    add(atl08, beam, "signal_photons/ph_segment_id",        RecordObject::INT32,    ph_segment_id.data(),       num_photons);
+    add(atl08, beam, "signal_photons/classed_pc_indx",      RecordObject::INT32,    classed_pc_indx.data(),     num_photons);
+    add(atl08, beam, "signal_photons/classed_pc_flag",      RecordObject::INT8,     classed_pc_flag.data(),     num_photons);
+    add(atl08, beam, "signal_photons/ph_h",                 RecordObject::FLOAT,    ph_h.data(),                num_photons);
+    add(atl08, beam, "land_segments/segment_id_beg",        RecordObject::INT32,    segment_id_beg.data(),      num_land_segments);
+    add(atl08, beam, "land_segments/segment_landcover",     RecordObject::INT16,    segment_landcover.data(),   num_land_segments);
+    add(atl08, beam, "land_segments/segment_snowcover",     RecordObject::INT8,     segment_snowcover.data(),   num_land_segments);
+}
+
+/*----------------------------------------------------------------------------
+ * add - chunked and compressed like the ATL03/ATL08 products
+ *----------------------------------------------------------------------------*/
+void SyntheticGranule::add (H5Writer& writer, const char* beam, const char* name, RecordObject::fieldType_t type, const void* data, int64_t rows, int64_t cols)
+{
+    const FString path("/%s/%s", beam, name);
+    writer.addDataset(path.c_str(), type, data, rows, cols, MIN(rows, CHUNK_ROWS), DEFLATE_LEVEL, true);
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __synthetic_granule__
+#define __synthetic_granule__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "H5Writer.h"
+
+/******************************************************************************
+ * SyntheticGranule CLASS
+ *
+ *  Writes a pair of ATL03 and ATL08 granules with every dataset that the
+ *  Atl03DataFrame reads, laid out and chunked like the real products, over a
+ *  synthetic vegetated track.  The pair is named so that the ATL08 resource
+ *  is found by the same substitution the atl03x endpoint uses.
+ ******************************************************************************/
+
+class SyntheticGranule
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const char* ATL03_RESOURCE;
+        static const char* ATL08_RESOURCE;
+
+        static const int64_t DEFAULT_SEGMENTS = 20000;  // per beam, ~400km of track
+        static const int NUM_BEAMS = 6;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static uint64_t write   (const char* directory, int64_t num_segments=DEFAULT_SEGMENTS);
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const char* BEAMS[NUM_BEAMS];
+
+        static const int64_t CHUNK_ROWS = 10000;
+        static const int DEFLATE_LEVEL = 6;
+        static const int SEGMENTS_PER_LAND_SEGMENT = 5;
+        static const int SEGMENTS_PER_BACKGROUND = 7;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static void     writeBeam   (H5Writer& atl03, H5Writer& atl08, int beam_index, int64_t num_segments);
+        static void     add         (H5Writer& writer, const char* beam, const char* name, RecordObject::fieldType_t type, const void* data, int64_t rows, int64_t cols=0);
+};
+
+#endif  /* __synthetic_granule__ */
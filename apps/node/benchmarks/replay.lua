@@ -0,0 +1,127 @@
+--
+-- Granule Replay Harness
+--
+--  Replays a local ATL03/ATL08 granule pair through the same chain the atl03x
+--  endpoint uses (Atl03DataFrame -> FrameRunner -> ArrowDataFrame) and reports
+--  per-stage wall time, bytes read, h5coro cache hit rates, frame runner pool
+--  usage and peak RSS.
+--
+--  Usage: sliderule replay.lua <directory> [<resource>] [<latency ms>] [<bandwidth MB/s>] [<fit|phoreal|none>] [<output json>]
+--
+--  Synthetic granules can be generated with: sliderule-bench --granules <directory>
+--
+
+local json = require("json")
+
+-- Command Line --
+
+local directory = arg[1]
+local resource  = arg[2] or "ATL03_20200101000000_01230605_006_01.h5"
+local latency   = tonumber(arg[3]) or 0.0
+local bandwidth = tonumber(arg[4]) or 0.0
+local stage     = arg[5] or "fit"
+local output    = arg[6]
+
+if not directory then
+    print("Usage: replay.lua <directory> [<resource>] [<latency ms>] [<bandwidth MB/s>] [<fit|phoreal|none>] [<output json>]")
+    sys.quit(1)
+end
+
+local beams = {"gt1l", "gt1r", "gt2l", "gt2r", "gt3l", "gt3r"}
+local timeout = 600000 -- ms
+
+-- Setup --
+
+local asset = core.asset("replay", "nil", "file", directory, "empty.index"):global("replay")
+core.iomodel(latency, bandwidth)
+core.iostats(true)
+
+local parms = icesat2.parms03({
+    resource = resource,
+    output = {format = "parquet"}
+}, nil, "replay")
+
+local atl03h5 = h5coro.object("replay", resource)
+local atl08h5 = h5coro.object("replay", resource:gsub("ATL03", "ATL08"))
+
+local report = {
+    resource = resource,
+    latency_ms = latency,
+    bandwidth_mbps = bandwidth,
+    runner = stage,
+    stages = {},
+    rows = 0
+}
+
+-- Stage 1: Subset --
+
+local t0 = time.latch()
+local dataframes = {}
+for _, beam in ipairs(beams) do
+    dataframes[beam] = icesat2.atl03x(beam, parms, atl03h5, atl08h5, nil, core.EVENTQ)
+end
+for beam, df in pairs(dataframes) do
+    if not df:waiton(timeout) or df:inerror() then
+        print(string.format("Failed to subset beam %s", beam))
+        sys.quit(1)
+    end
+    report["rows"] = report["rows"] + df:numrows()
+end
+report["stages"]["subset"] = time.latch() - t0
+
+-- Stage 2: FrameRunner --
+
+t0 = time.latch()
+for _, df in pairs(dataframes) do
+    if stage == "fit" then
+        df:run(icesat2.fit(parms))
+    elseif stage == "phoreal" then
+        df:run(icesat2.phoreal(parms))
+    end
+    df:run(core.TERMINATE)
+end
+for beam, df in pairs(dataframes) do
+    if not df:finished(timeout) then
+        print(string.format("Timed out running beam %s", beam))
+        sys.quit(1)
+    end
+end
+report["stages"]["runner"] = time.latch() - t0
+
+-- Stage 3: Arrow --
+
+t0 = time.latch()
+for beam, df in pairs(dataframes) do
+    local filename = string.format("/tmp/replay_%s.parquet", beam)
+    if not arrow.dataframe(parms, df):export(filename) then
+        print(string.format("Failed to export beam %s", beam))
+        sys.quit(1)
+    end
+    sys.deletefile(filename)
+end
+report["stages"]["arrow"] = time.latch() - t0
+
+-- Report --
+
+local function cache_report(stats)
+    local lookups = stats["cache_hit"] + stats["cache_miss"]
+    stats["hit_rate"] = lookups > 0 and (stats["cache_hit"] / lookups) or 0.0
+    return stats
+end
+
+report["atl03"] = cache_report(atl03h5:stats())
+report["atl08"] = cache_report(atl08h5:stats())
+report["io"] = core.iostats()
+report["pool"] = core.runnerpool()
+report["maxrss"] = sys.maxrss()
+
+local report_str = json.encode(report)
+if output then
+    local f = io.open(output, "w")
+    f:write(report_str)
+    f:close()
+else
+    print(report_str)
+end
+
+sys.quit(0)
@@ -221,6 +221,7 @@ class BathyDataFrame: public GeoDataFrame
          *--------------------------------------------------------------------*/
 
         friend class UT_BathyRefractionCorrector; // necessary for the private constructor/destructor
+        friend class UT_BathyHistogram;
 };
 
 #endif  /* __bathy_data_frame__ */
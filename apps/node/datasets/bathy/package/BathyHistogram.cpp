@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+#include "OsApi.h"
+#include "BathyHistogram.h"
+
+/******************************************************************************
+ * METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+BathyHistogram::BathyHistogram (long _smooth_width):
+    smoothWidth(_smooth_width),
+    start(0.0),
+    binSize(1.0),
+    numValues(0),
+    boxTotal(0)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * reset - resize and empty the histogram, storage is reused
+ *----------------------------------------------------------------------------*/
+void BathyHistogram::reset (long num_bins, double _start, double _bin_size)
+{
+    start = _start;
+    binSize = _bin_size;
+    bins.assign(num_bins, 0);
+    boxes.assign((smoothWidth > 0) ? MAX(num_bins - smoothWidth + 1, 0) : 0, 0);
+    numValues = 0;
+    boxTotal = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * clear - empty the histogram keeping its size and bin edges
+ *----------------------------------------------------------------------------*/
+void BathyHistogram::clear (void)
+{
+    std::fill(bins.begin(), bins.end(), 0);
+    std::fill(boxes.begin(), boxes.end(), 0);
+    numValues = 0;
+    boxTotal = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * add - returns false if value falls outside of the histogram
+ *----------------------------------------------------------------------------*/
+bool BathyHistogram::add (double value)
+{
+    return update(bin(value), 1);
+}
+
+/*----------------------------------------------------------------------------
+ * remove - value must have been previously added
+ *----------------------------------------------------------------------------*/
+bool BathyHistogram::remove (double value)
+{
+    return update(bin(value), -1);
+}
+
+/*----------------------------------------------------------------------------
+ * sumHighest - sum of the largest count smoothed bins
+ *
+ *  the sum of the lowest N smoothed bins is smoothedTotal() - sumHighest(size - N)
+ *----------------------------------------------------------------------------*/
+uint64_t BathyHistogram::sumHighest (long count)
+{
+    const long num_boxes = boxes.size();
+    if(count <= 0) return 0;
+    if(count >= num_boxes) return boxTotal;
+
+    scratch.assign(boxes.begin(), boxes.end());
+    std::nth_element(scratch.begin(), scratch.begin() + count, scratch.end(), std::greater<uint32_t>());
+    return std::accumulate(scratch.begin(), scratch.begin() + count, static_cast<uint64_t>(0));
+}
+
+/*----------------------------------------------------------------------------
+ * update
+ *----------------------------------------------------------------------------*/
+bool BathyHistogram::update (long index, int delta)
+{
+    const long num_bins = bins.size();
+    if(index < 0 || index >= num_bins)
+    {
+        return false;
+    }
+
+    bins[index] += delta;
+    numValues += delta;
+
+    /* Update every box that includes this bin */
+    const long num_boxes = boxes.size();
+    const long first = MAX(index - smoothWidth + 1, 0);
+    const long last = MIN(index, num_boxes - 1);
+    for(long i = first; i <= last; i++)
+    {
+        boxes[i] += delta;
+        boxTotal += delta;
+    }
+
+    return true;
+}
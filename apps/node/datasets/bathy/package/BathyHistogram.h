@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __bathy_histogram__
+#define __bathy_histogram__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <cmath>
+
+#include "OsApi.h"
+
+/******************************************************************************
+ * CLASS
+ ******************************************************************************/
+
+/*
+ * Histogram of photon heights that is maintained incrementally as a window
+ * slides along the track: photons entering the window are added and photons
+ * leaving it are removed, so overlapping windows are never rebinned. A box
+ * smoothed copy of the bins (sum of each run of smoothWidth bins) is kept up
+ * to date with every add and remove, and order statistics over the smoothed
+ * bins are computed by partial selection instead of a full sort.
+ */
+class BathyHistogram
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        explicit    BathyHistogram  (long _smooth_width=0);
+                    ~BathyHistogram (void) = default;
+
+        void        reset           (long num_bins, double _start, double _bin_size);
+        void        clear           (void);
+        bool        add             (double value);
+        bool        remove          (double value);
+        uint64_t    sumHighest      (long count);
+
+        long        bin             (double value) const { return static_cast<long>(std::floor((value - start) / binSize)); }
+        long        numBins         (void) const { return bins.size(); }
+        long        population      (void) const { return numValues; }
+        uint32_t    operator[]      (long index) const { return bins[index]; }
+        long        numSmoothed     (void) const { return boxes.size(); }
+        uint32_t    smoothed        (long index) const { return boxes[index]; }
+        uint64_t    smoothedTotal   (void) const { return boxTotal; }
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        bool        update          (long index, int delta);
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        long                smoothWidth;    // zero disables smoothing
+        double              start;
+        double              binSize;
+        long                numValues;
+        vector<uint32_t>    bins;
+        vector<uint32_t>    boxes;          // boxes[i] = bins[i] + ... + bins[i + smoothWidth - 1]
+        uint64_t            boxTotal;
+        vector<uint32_t>    scratch;        // reused for order statistics
+};
+
+#endif  /* __bathy_histogram__ */
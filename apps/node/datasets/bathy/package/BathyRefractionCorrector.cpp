@@ -189,8 +189,6 @@ BathyRefractionCorrector::~BathyRefractionCorrector (void)
 bool BathyRefractionCorrector::run(GeoDataFrame* dataframe)
 {
     BathyDataFrame& df = *dynamic_cast<BathyDataFrame*>(dataframe);
-    const RefractionFields& refraction_parms = parms->refraction;
-    bool first_transform_error = true;
 
     /* Get Input Columns */
     FieldColumn<float>* surface_h = reinterpret_cast<FieldColumn<float>*>(df.getColumn("surface_h", true));
@@ -201,25 +199,58 @@ bool BathyRefractionCorrector::run(GeoDataFrame* dataframe)
         return false;
     }
 
-    /* Get UTM Transformations */
-    GeoLib::UTMTransform utm_transform(df.lat_ph[0], df.lon_ph[0]);
+    /* Check For Photons */
+    if(df.length() <= 0)
+    {
+        return true;
+    }
+
+    /* Run Refraction Correction Across Frame Runner Pool */
+    correct_context_t context = {this, &df, surface_h, class_ph, df.lat_ph[0], df.lon_ph[0]};
+    if(!parms->runnerPool.run(correctPhotons, &context, df.length(), PHOTON_GRAIN))
+    {
+        mlog(CRITICAL, "Failed to run refraction correction");
+        return false;
+    }
+
+    /* Mark Completion */
+    return true;
+}
+
+/*----------------------------------------------------------------------------
+ * correctPhotons - corrects a range of photons; each photon is corrected in
+ *                  place independently of the others so ranges run concurrently
+ *----------------------------------------------------------------------------*/
+void BathyRefractionCorrector::correctPhotons (void* context, long start, long count)
+{
+    const correct_context_t* ctx = static_cast<const correct_context_t*>(context);
+    BathyDataFrame& df = *ctx->df;
+    const FieldColumn<float>* surface_h = ctx->surface_h;
+    const FieldColumn<int>* class_ph = ctx->class_ph;
+    const RefractionFields& refraction_parms = ctx->corrector->parms->refraction;
+    GeoLib::TIFFImage* water_ri_mask = ctx->corrector->waterRiMask;
+    bool first_transform_error = true;
+    uint64_t subaqueous_photons = 0;
+
+    /* Get UTM Transformations (not shareable across threads) */
+    GeoLib::UTMTransform utm_transform(ctx->lat0, ctx->lon0);
     GeoLib::UTMTransform wgs84_transform(utm_transform.zone, utm_transform.is_north);
 
     /* Run Refraction Correction */
-    for(long i = 0; i < df.length(); i++)
+    for(long i = start; i < start + count; i++)
     {
         /* Correct All Subaqueous and Non-Sea-Surface Photons */
         const double depth = (*surface_h)[i] - df.geoid_corr_h[i]; // compute un-refraction-corrected depths
         if((depth > 0) && ((*class_ph)[i] != BathyParameters::SEA_SURFACE))
         {
             /* Count Subaqueous Photons */
-            subaqueousPhotons++;
+            subaqueous_photons++;
 
             /* Get Refraction Index of Water */
             double ri_water = refraction_parms.RIWater.value;
-            if(waterRiMask)
+            if(water_ri_mask)
             {
-                const double pixel = sampleWaterMask(waterRiMask, df.lon_ph[i], df.lat_ph[i]);
+                const double pixel = sampleWaterMask(water_ri_mask, df.lon_ph[i], df.lat_ph[i]);
                 if(pixel > 0.0) ri_water = pixel; // only set if valid pixel
             }
 
@@ -274,6 +305,10 @@ bool BathyRefractionCorrector::run(GeoDataFrame* dataframe)
         }
     }
 
-    /* Mark Completion */
-    return true;
+    /* Count Subaqueous Photons */
+    ctx->corrector->m.lock();
+    {
+        ctx->corrector->subaqueousPhotons += subaqueous_photons;
+    }
+    ctx->corrector->m.unlock();
 }
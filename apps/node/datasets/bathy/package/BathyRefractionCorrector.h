@@ -70,6 +70,25 @@ class BathyRefractionCorrector: public GeoDataFrame::FrameRunner
 
     private:
 
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const long PHOTON_GRAIN = 65536; // photons corrected per pool task, amortizes creating the transforms
+
+        /*--------------------------------------------------------------------
+         * Typedefs
+         *--------------------------------------------------------------------*/
+
+        typedef struct {
+            BathyRefractionCorrector*   corrector;
+            BathyDataFrame*             df;
+            const FieldColumn<float>*   surface_h;
+            const FieldColumn<int>*     class_ph;
+            double                      lat0;   // location of first photon selects the UTM zone
+            double                      lon0;
+        } correct_context_t;
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
@@ -77,6 +96,8 @@ class BathyRefractionCorrector: public GeoDataFrame::FrameRunner
         BathyRefractionCorrector    (lua_State* L, BathyParameters* _parms);
         ~BathyRefractionCorrector   (void) override;
 
+        static void correctPhotons  (void* context, long start, long count);
+
         /*--------------------------------------------------------------------
          * Data
          *--------------------------------------------------------------------*/
@@ -40,6 +40,7 @@
 
 #include "OsApi.h"
 #include "BathyParameters.h"
+#include "BathyHistogram.h"
 #include "BathySeaSurfaceFinder.h"
 
 /******************************************************************************
@@ -98,6 +99,12 @@ bool BathySeaSurfaceFinder::run(GeoDataFrame* dataframe)
     /* create new column */
     FieldColumn<float>* surface_h = new FieldColumn<float>;
 
+    /* working buffers reused across extents */
+    vector<double> heights;
+    BathyHistogram histogram;
+    vector<double> kernel;
+    vector<double> smoothed_histogram;
+
     /* for each extent (p0 = start photon) */
     for(long p0 = 0; p0 < df.length(); p0 += parms->phInExtent.value)
     {
@@ -116,7 +123,7 @@ bool BathySeaSurfaceFinder::run(GeoDataFrame* dataframe)
             double avg_bckgnd = 0.0;
 
             /* build list photon heights */
-            vector<double> heights;
+            heights.clear();
             for(long i = p0; i < p1; i++)
             {
                 const double height = static_cast<double>(df.geoid_corr_h[i]);
@@ -163,11 +170,11 @@ bool BathySeaSurfaceFinder::run(GeoDataFrame* dataframe)
             avg_bckgnd /= heights.size();
 
             /* build histogram of photon heights */
-            vector<long> histogram(num_bins);
-            std::for_each (std::begin(heights), std::end(heights), [&](const double h) {
-                const long bin = static_cast<long>(std::floor((h - min_h) / surface_parms.binSize.value));
-                histogram[bin]++;
-            });
+            histogram.reset(num_bins, min_h, surface_parms.binSize.value);
+            for(const double h: heights)
+            {
+                histogram.add(h);
+            }
 
             /* calculate mean and standard deviation of histogram */
             double bckgnd = 0.0;
@@ -184,9 +191,11 @@ bool BathySeaSurfaceFinder::run(GeoDataFrame* dataframe)
             {
                 const double bin_avg = static_cast<double>(heights.size()) / static_cast<double>(num_bins);
                 double accum = 0.0;
-                std::for_each (std::begin(histogram), std::end(histogram), [&](const double h) {
+                for(long i = 0; i < num_bins; i++)
+                {
+                    const double h = histogram[i];
                     accum += (h - bin_avg) * (h - bin_avg);
-                });
+                }
                 bckgnd = bin_avg;
                 stddev = sqrt(accum / heights.size());
             }
@@ -196,7 +205,7 @@ bool BathySeaSurfaceFinder::run(GeoDataFrame* dataframe)
             const long k = (static_cast<long>(std::ceil(kernel_size / surface_parms.binSize.value)) & ~0x1) / 2;
             const long kernel_bins = 2 * k + 1;
             double kernel_sum = 0.0;
-            vector<double> kernel(kernel_bins);
+            kernel.resize(kernel_bins);
             for(long x = -k; x <= k; x++)
             {
                 const long i = x + k;
@@ -210,19 +219,21 @@ bool BathySeaSurfaceFinder::run(GeoDataFrame* dataframe)
             }
 
             /* build filtered histogram */
-            vector<double> smoothed_histogram(num_bins);
+            smoothed_histogram.resize(num_bins);
             for(long i = 0; i < num_bins; i++)
             {
+                /* every tap reads the same bin, so its range check and value are hoisted out of the kernel loop */
+                const long index = i + k;
                 double output = 0.0;
                 long num_samples = 0;
-                for(long j = -k; j <= k; j++)
+                if(index < num_bins)
                 {
-                    const long index = i + k;
-                    if(index >= 0 && index < num_bins)
+                    const double count = static_cast<double>(histogram[index]);
+                    for(long j = -k; j <= k; j++)
                     {
-                        output += kernel[j + k] * static_cast<double>(histogram[index]);
-                        num_samples++;
+                        output += kernel[j + k] * count;
                     }
+                    num_samples = kernel_bins;
                 }
                 smoothed_histogram[i] = output * static_cast<double>(kernel_bins) / static_cast<double>(num_samples);
             }
@@ -38,9 +38,9 @@
 #include <algorithm>
 
 #include "OsApi.h"
-#include "List.h"
 #include "GeoLib.h"
 #include "BathyParameters.h"
+#include "BathyHistogram.h"
 #include "BathySignalStrength.h"
 
 
@@ -128,18 +128,18 @@ bool BathySignalStrength::run(GeoDataFrame* dataframe)
         signal_strength->append(0);
     }
 
+    // sliding window histogram, smoothed by summing adjacent bins when the background is estimated from it
+    const long smoothed_numbins = histo_numbins - 1;
+    BathyHistogram histogram(2);
+    histogram.reset(histo_numbins, histo_start, histo_binstep);
+    long histo_start_i = 0; // first photon in histogram
+    long histo_stop_i = 0; // one past last photon in histogram
+
     // histogram processing
     long next_extent_start_i = 0;
     while(true)
     {
-        // allocate and initialize histogram
-        uint32_t* histogram = new uint32_t[histo_numbins];
-        memset(histogram, 0, sizeof(uint32_t) * histo_numbins);
-
-        // initialize accumulated background for calculating average below
-        double background_acc = 0.0;
-
-        // bin photons in extent
+        // find photons in extent
         const long start_i = next_extent_start_i;
         long i = start_i;
         while(i < df.length())
@@ -163,18 +163,29 @@ bool BathySignalStrength::run(GeoDataFrame* dataframe)
                 }
             }
 
-            // bin the photon
-            const long bin = static_cast<long>(std::floor((df.geoid_corr_h[i] - histo_start) / histo_binstep));
-            if(bin >= 0 && bin <= histo_numbins) histogram[bin]++;
-            else mlog(CRITICAL, "Invalid bin in histogram: %ld <== %.3f %.3f %.3f", bin, df.geoid_corr_h[i], histo_start,  histo_binstep);
-
-            // accumulate background rate
-            background_acc += df.background_rate[i];
-
             // go to next photon
             i++;
         }
 
+        // slide histogram to extent - remove photons that left it and bin photons that entered it
+        for(long k = histo_start_i; k < MIN(start_i, histo_stop_i); k++)
+        {
+            histogram.remove(df.geoid_corr_h[k]);
+        }
+        for(long k = MAX(i, start_i); k < histo_stop_i; k++)
+        {
+            histogram.remove(df.geoid_corr_h[k]);
+        }
+        for(long k = MAX(histo_stop_i, start_i); k < i; k++)
+        {
+            if(!histogram.add(df.geoid_corr_h[k]))
+            {
+                mlog(CRITICAL, "Invalid bin in histogram: %ld <== %.3f %.3f %.3f", histogram.bin(df.geoid_corr_h[k]), df.geoid_corr_h[k], histo_start,  histo_binstep);
+            }
+        }
+        histo_start_i = start_i;
+        histo_stop_i = i;
+
         // check if valid histogram
         const long photons_in_histogram = i - start_i;
         if(photons_in_histogram > 0)
@@ -189,67 +200,55 @@ bool BathySignalStrength::run(GeoDataFrame* dataframe)
 
             if(use_background_rate)
             {
+                // accumulate background rate
+                double background_acc = 0.0;
+                for(long k = start_i; k < i; k++)
+                {
+                    background_acc += df.background_rate[k];
+                }
+
                 // determine expected values for each bin
                 const double background_avg = background_acc / photons_in_histogram;
                 background_pe = background_avg * histo_bintime * num_shots;
             }
             else
             {
-                // smooth histogram and created sorted values
-                const long smoothed_numbins = histo_numbins - 1;
-                List<uint32_t> sorted_smoothed_histogram(smoothed_numbins);
-                for(long bin = 0; bin < smoothed_numbins; bin++)
-                {
-                    histogram[bin] = histogram[bin] + histogram[bin + 1];
-                    sorted_smoothed_histogram.add(histogram[bin]);
-                }
-
-                // sum the lowest N bins
-                sorted_smoothed_histogram.sort();
-                uint32_t bin_acc = 0;
-                for(long bin = 0; bin < smoothed_numbins - histo_min_numbins; bin++)
-                {
-                    bin_acc += sorted_smoothed_histogram[bin];
-                }
+                // sum the lowest N smoothed bins
+                const uint64_t bin_acc = histogram.smoothedTotal() - histogram.sumHighest(histo_min_numbins);
 
                 // calculate average background contribution to each bin
                 background_pe = bin_acc / (smoothed_numbins - histo_min_numbins);
             }
 
-            // calculate signal pe normalized to 255
-            // across the range of 0 to max_shot_pe
-            for(long bin = 0; bin < histo_numbins; bin++)
-            {
-                const double shot_pe = MAX(MIN((static_cast<double>(histogram[bin]) - background_pe) / num_shots, max_shot_pe), 0.0);
-                histogram[bin] = (shot_pe / max_shot_pe) * 0xFF;
-            }
-
             // traverse all photons in histogram and assign signal score
             for(long k = start_i; k < i; k++)
             {
-                const long bin = static_cast<long>(std::floor((df.geoid_corr_h[k] - histo_start) / histo_binstep));
-                if(bin >= 0 && bin <= histo_numbins)
+                const long bin = histogram.bin(df.geoid_corr_h[k]);
+                if(bin >= 0 && bin < histo_numbins)
                 {
+                    // calculate signal pe normalized to 255
+                    // across the range of 0 to max_shot_pe
+                    const uint32_t bin_count = (!use_background_rate && bin < smoothed_numbins) ? histogram.smoothed(bin) : histogram[bin];
+                    const double shot_pe = MAX(MIN((static_cast<double>(bin_count) - background_pe) / num_shots, max_shot_pe), 0.0);
+                    const uint32_t bin_score = (shot_pe / max_shot_pe) * 0xFF;
+
                     /* get current signal score from processing flags */
                     uint32_t signal_score = (*signal_strength)[k];
 
                     /* set signal score */
-                    if(signal_score == 0) signal_score = histogram[bin];
-                    else signal_score = MAX(histogram[bin], signal_score);
+                    if(signal_score == 0) signal_score = bin_score;
+                    else signal_score = MAX(bin_score, signal_score);
 
                     /* populate processing flags with latest signal score */
                     (*signal_strength)[k] = signal_score;
                 }
                 else
                 {
-                    mlog(CRITICAL, "Invalid bin in histogram: %ld <== %.3f %.3f %.3f", bin, df.geoid_corr_h[i], histo_start,  histo_binstep);
+                    mlog(CRITICAL, "Invalid bin in histogram: %ld <== %.3f %.3f %.3f", bin, df.geoid_corr_h[k], histo_start,  histo_binstep);
                 }
             }
         }
 
-        // clean up histogram memory
-        delete [] histogram;
-
         // check for completion
         if(i >= df.length())
         {
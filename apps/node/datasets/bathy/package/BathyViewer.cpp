@@ -82,6 +82,12 @@ int BathyViewer::luaCreate (lua_State* L)
         /* Get Parameters */
         _parms = dynamic_cast<Icesat2Parameters*>(getLuaObject(L, 1, Icesat2Parameters::OBJECT_TYPE));
 
+        /* Check View Level */
+        if(_parms->viewLevel.value < 0 || _parms->viewLevel.value > SegmentPyramid::NUM_LEVELS)
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "Invalid view level: %d", _parms->viewLevel.value);
+        }
+
         /* Return Reader Object */
         return createLuaObject(L, new BathyViewer(L, _parms));
     }
@@ -142,7 +148,7 @@ BathyViewer::BathyViewer (lua_State* L, Icesat2Parameters* _parms):
                         info->track = track;
                         info->pair = pair;
                         StringLib::format(info->prefix, 7, "/gt%d%c", info->track, info->pair == 0 ? 'l' : 'r');
-                        readerPid[threadCount++] = new Thread(subsettingThread, info);
+                        readerPid[threadCount++] = new Thread(parms->viewLevel.value > 0 ? pyramidThread : subsettingThread, info);
                     }
                 }
             }
@@ -292,6 +298,89 @@ void* BathyViewer::subsettingThread (void* parm)
     return NULL;
 }
 
+/*----------------------------------------------------------------------------
+ * pyramidThread
+ *
+ *  counts from the bins of the segment pyramid at the requested level; each
+ *  bin is tested against the mask at the location of its middle segment
+ *  with photons
+ *----------------------------------------------------------------------------*/
+void* BathyViewer::pyramidThread (void* parm)
+{
+    /* Get Thread Info */
+    info_t* info = static_cast<info_t*>(parm);
+    BathyViewer* reader = info->reader;
+
+    /* Initialize Count of Photons */
+    int64_t total_photons = 0;
+    int64_t photons_in_mask = 0;
+    int64_t total_segments = 0;
+    int64_t segments_in_mask = 0;
+    int64_t total_errors = 0;
+
+    try
+    {
+        /* Get Pyramid Level */
+        const SegmentPyramid pyramid(reader->context, reader->parms->asset.getName(), reader->parms->getResource(), info->prefix, reader->read_timeout_ms);
+        long num_bins = 0;
+        const SegmentPyramid::bin_t* bins = pyramid.level(reader->parms->viewLevel.value, &num_bins);
+
+        /* Traverse All Bins */
+        for(long b = 0; reader->active.load() && b < num_bins; b++)
+        {
+            const SegmentPyramid::bin_t& bin = bins[b];
+
+            /* Get X and Y Coordinates */
+            const uint32_t y = static_cast<uint32_t>((bin.latitude - GLOBAL_BATHYMETRY_MASK_MIN_LAT) / GLOBAL_BATHYMETRY_MASK_PIXEL_SIZE);
+            const uint32_t x = static_cast<uint32_t>((bin.longitude - GLOBAL_BATHYMETRY_MASK_MIN_LON) / GLOBAL_BATHYMETRY_MASK_PIXEL_SIZE);
+
+            /* Count Photons in Mask */
+            const GeoLib::TIFFImage::val_t pixel = reader->bathyMask->getPixel(x, y);
+            if(pixel.u32 == GLOBAL_BATHYMETRY_MASK_OFF_VALUE)
+            {
+                photons_in_mask += bin.ph_cnt;
+                segments_in_mask += bin.segments;
+            }
+
+            /* Count Totals */
+            total_photons += bin.ph_cnt;
+            total_segments += bin.segments;
+            total_errors += bin.invalid;
+        }
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Failure on resource %s track %d.%d: %s", reader->parms->getResource(), info->track, info->pair, e.what());
+    }
+
+    /* Handle Global Reader Updates */
+    reader->threadMut.lock();
+    {
+        /* Sum Total */
+        reader->totalPhotons += total_photons;
+        reader->totalPhotonsInMask += photons_in_mask;
+        reader->totalSegments += total_segments;
+        reader->totalSegmentsInMask += segments_in_mask;
+        reader->totalErrors += total_errors;
+
+        /* Count Completion */
+        reader->numComplete++;
+        if(reader->numComplete == reader->threadCount)
+        {
+            /* Indicate End of Data */
+            mlog(INFO, "Completed processing resource %s: %ld photons", reader->parms->getResource(), reader->totalPhotons);
+            reader->signalComplete();
+        }
+    }
+    reader->threadMut.unlock();
+
+    /* Clean Up */
+    delete info;
+
+    /* Return */
+    return NULL;
+}
+
 /*----------------------------------------------------------------------------
  * luaCounts - :counts()
  *----------------------------------------------------------------------------*/
@@ -44,6 +44,7 @@
 #include "H5Array.h"
 #include "GeoLib.h"
 #include "Icesat2Parameters.h"
+#include "SegmentPyramid.h"
 
 /******************************************************************************
  * ATL03 TABLE BUILDER
@@ -137,6 +138,7 @@ class BathyViewer: public LuaObject
                             ~BathyViewer           (void) override;
 
         static void*        subsettingThread        (void* parm);
+        static void*        pyramidThread           (void* parm);
         static int          luaCounts               (lua_State* L);
 };
 
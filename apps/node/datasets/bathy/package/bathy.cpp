@@ -45,6 +45,7 @@
 #include "BathyRefractionCorrector.h"
 #ifdef __unittesting__
 #include "UT_BathyRefractionCorrector.h"
+#include "UT_BathyHistogram.h"
 #endif
 
 /******************************************************************************
@@ -74,6 +75,7 @@ int bathy_open (lua_State *L)
         {"refraction",          BathyRefractionCorrector::luaCreate},
 #ifdef __unittesting__
         {"ut_refraction",          UT_BathyRefractionCorrector::luaCreate},
+        {"ut_histogram",           UT_BathyHistogram::luaCreate},
 #endif
         {NULL,                  NULL}
     };
@@ -9,6 +9,7 @@ end
 -- Setup --
 
 local ut_refraction = bathy.ut_refraction()
+local ut_histogram = bathy.ut_histogram()
 
 -- Self Test --
 
@@ -22,6 +23,22 @@ runner.unittest("Bathy Refraction", function()
     runner.assert(ut_refraction:refraction(parms, refraction), "Failed refraction test")
 end)
 
+runner.unittest("Bathy Sliding Histogram", function()
+    runner.assert(ut_histogram:histogram(), "Failed sliding histogram test")
+end)
+
+runner.unittest("Bathy Signal Strength", function()
+    local parms = bathy.parms({})
+    local signal = bathy.signal(parms)
+    runner.assert(ut_histogram:signal(parms, signal), "Failed signal strength test")
+end)
+
+runner.unittest("Bathy Sea Surface", function()
+    local parms = bathy.parms({})
+    local seasurface = bathy.seasurface(parms)
+    runner.assert(ut_histogram:seasurface(parms, seasurface), "Failed sea surface test")
+end)
+
 -- Report Results --
 
 runner.report()
@@ -0,0 +1,572 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <algorithm>
+
+#include "OsApi.h"
+#include "UT_BathyHistogram.h"
+#include "BathyHistogram.h"
+#include "BathyDataFrame.h"
+#include "BathyParameters.h"
+#include "GeoDataFrame.h"
+
+/******************************************************************************
+ * FILE DATA
+ ******************************************************************************/
+
+#define UT_NUM_PHOTONS  20000
+#define UT_SEED         1234
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * buildTrack - synthetic beam with sea surface, sea floor, and background photons
+ *----------------------------------------------------------------------------*/
+static void buildTrack (BathyDataFrame& df, const BathyParameters* parms)
+{
+    std::mt19937 gen(UT_SEED);
+    std::uniform_real_distribution<double> step(0.0, 0.05);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::normal_distribution<double> surface(0.0, 0.15);
+    std::normal_distribution<double> seafloor(-8.0, 0.3);
+    std::uniform_real_distribution<double> background(-30.0, 20.0);
+    std::uniform_real_distribution<float> rate(1000000.0, 5000000.0);
+
+    const double min_h = parms->minGeoidDelta.value + 1.0;
+    const double max_h = parms->maxGeoidDelta.value - 1.0;
+
+    /* several photons per shot, shots every 0.7m along track */
+    double x_atc = 0.0;
+    for(int i = 0; i < UT_NUM_PHOTONS; i++)
+    {
+        x_atc += step(gen);
+        const int64_t time_ns = static_cast<int64_t>(x_atc / 0.7) * 100000;
+
+        double h;
+        const double p = unit(gen);
+        if(p < 0.3)         h = surface(gen);
+        else if(p < 0.5)    h = seafloor(gen);
+        else                h = background(gen);
+
+        df.addRow();
+        df.time_ns.append(time8_t(time_ns));
+        df.x_atc.append(x_atc);
+        df.geoid_corr_h.append(MAX(MIN(h, max_h), min_h));
+        df.background_rate.append(rate(gen));
+        df.processing_flags.append(0);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * legacySignalStrength - BathySignalStrength::run prior to sliding histograms
+ *----------------------------------------------------------------------------*/
+static void legacySignalStrength (const BathyDataFrame& df, const BathyParameters* parms, vector<uint16_t>& signal_strength)
+{
+    const double max_shot_pe = 1.0;
+    const double histo_binsize = 0.2;
+    const double histo_width = 20.0;
+    const double histo_step = 10.0;
+    const int32_t histo_min_numbins = 10;
+    const double histo_start = parms->minGeoidDelta.value;
+    const double histo_stop = parms->maxGeoidDelta.value;
+    const double histo_binstep = histo_binsize / 2.0;
+    const int32_t histo_numbins = static_cast<int32_t>(std::ceil((histo_stop - histo_start) / histo_binstep));
+
+    signal_strength.assign(df.length(), 0);
+
+    long next_extent_start_i = 0;
+    while(true)
+    {
+        vector<uint32_t> histogram(histo_numbins, 0);
+
+        const long start_i = next_extent_start_i;
+        long i = start_i;
+        while(i < df.length())
+        {
+            if((df.x_atc[i] - df.x_atc[start_i]) <= histo_step)
+            {
+                next_extent_start_i = i + 1;
+            }
+            if((df.x_atc[i] - df.x_atc[start_i]) > histo_width)
+            {
+                if((i < (df.length() - 1)) &&
+                   ((df.x_atc[df.length() - 1] - df.x_atc[next_extent_start_i]) > histo_width))
+                {
+                    break;
+                }
+            }
+            const long bin = static_cast<long>(std::floor((df.geoid_corr_h[i] - histo_start) / histo_binstep));
+            if(bin >= 0 && bin < histo_numbins) histogram[bin]++;
+            i++;
+        }
+
+        if(i - start_i > 0)
+        {
+            const int32_t num_shots = ((df.time_ns[i - 1].nanoseconds - df.time_ns[start_i].nanoseconds) / 100000) + 1;
+
+            const long smoothed_numbins = histo_numbins - 1;
+            vector<uint32_t> sorted_smoothed_histogram;
+            for(long bin = 0; bin < smoothed_numbins; bin++)
+            {
+                histogram[bin] = histogram[bin] + histogram[bin + 1];
+                sorted_smoothed_histogram.push_back(histogram[bin]);
+            }
+            std::sort(sorted_smoothed_histogram.begin(), sorted_smoothed_histogram.end());
+            uint32_t bin_acc = 0;
+            for(long bin = 0; bin < smoothed_numbins - histo_min_numbins; bin++)
+            {
+                bin_acc += sorted_smoothed_histogram[bin];
+            }
+            const double background_pe = bin_acc / (smoothed_numbins - histo_min_numbins);
+
+            for(long bin = 0; bin < histo_numbins; bin++)
+            {
+                const double shot_pe = MAX(MIN((static_cast<double>(histogram[bin]) - background_pe) / num_shots, max_shot_pe), 0.0);
+                histogram[bin] = (shot_pe / max_shot_pe) * 0xFF;
+            }
+
+            for(long k = start_i; k < i; k++)
+            {
+                const long bin = static_cast<long>(std::floor((df.geoid_corr_h[k] - histo_start) / histo_binstep));
+                if(bin >= 0 && bin < histo_numbins)
+                {
+                    uint32_t signal_score = signal_strength[k];
+                    if(signal_score == 0) signal_score = histogram[bin];
+                    else signal_score = MAX(histogram[bin], signal_score);
+                    signal_strength[k] = signal_score;
+                }
+            }
+        }
+
+        if(i >= df.length())
+        {
+            break;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * legacySeaSurface - BathySeaSurfaceFinder::run prior to sliding histograms
+ *----------------------------------------------------------------------------*/
+static void legacySeaSurface (const BathyDataFrame& df, const BathyParameters* parms, vector<float>& surface_h)
+{
+    const SurfaceFields& surface_parms = parms->surface;
+
+    for(long p0 = 0; p0 < df.length(); p0 += parms->phInExtent.value)
+    {
+        const long p1 = MIN(df.length(), p0 + parms->phInExtent.value);
+        float cur_surface_h = std::numeric_limits<float>::quiet_NaN();
+
+        double min_h = std::numeric_limits<double>::max();
+        double max_h = std::numeric_limits<double>::min();
+        double min_t = std::numeric_limits<double>::max();
+        double max_t = std::numeric_limits<double>::min();
+        double avg_bckgnd = 0.0;
+
+        vector<double> heights;
+        for(long i = p0; i < p1; i++)
+        {
+            const double height = static_cast<double>(df.geoid_corr_h[i]);
+            const double time_secs = static_cast<double>(df.time_ns[i].nanoseconds) / 1000000000.0;
+            if(height < min_h) min_h = height;
+            if(height > max_h) max_h = height;
+            if(time_secs < min_t) min_t = time_secs;
+            if(time_secs > max_t) max_t = time_secs;
+            avg_bckgnd = df.background_rate[i];
+            heights.push_back(height);
+        }
+
+        const double range_h = max_h - min_h;
+        const long num_bins = static_cast<long>(std::ceil(range_h / surface_parms.binSize.value)) + 1;
+        if(!heights.empty() && range_h > 0 && range_h <= surface_parms.maxRange.value && num_bins > 0 && num_bins <= surface_parms.maxBins.value)
+        {
+            avg_bckgnd /= heights.size();
+
+            vector<long> histogram(num_bins);
+            std::for_each (std::begin(heights), std::end(heights), [&](const double h) {
+                const long bin = static_cast<long>(std::floor((h - min_h) / surface_parms.binSize.value));
+                histogram[bin]++;
+            });
+
+            double bckgnd = 0.0;
+            double stddev = 0.0;
+            if(surface_parms.modelAsPoisson)
+            {
+                const long num_shots = std::round((max_t - min_t) / 0.0001);
+                const double bin_t = surface_parms.binSize.value * 0.00000002 / 3.0;
+                const double bin_pe = bin_t * num_shots * avg_bckgnd;
+                bckgnd = bin_pe;
+                stddev = sqrt(bin_pe);
+            }
+            else
+            {
+                const double bin_avg = static_cast<double>(heights.size()) / static_cast<double>(num_bins);
+                double accum = 0.0;
+                std::for_each (std::begin(histogram), std::end(histogram), [&](const double h) {
+                    accum += (h - bin_avg) * (h - bin_avg);
+                });
+                bckgnd = bin_avg;
+                stddev = sqrt(accum / heights.size());
+            }
+
+            const double kernel_size = 6.0 * stddev + 1.0;
+            const long k = (static_cast<long>(std::ceil(kernel_size / surface_parms.binSize.value)) & ~0x1) / 2;
+            const long kernel_bins = 2 * k + 1;
+            double kernel_sum = 0.0;
+            vector<double> kernel(kernel_bins);
+            for(long x = -k; x <= k; x++)
+            {
+                const long i = x + k;
+                const double r = x / stddev;
+                kernel[i] = exp(-0.5 * r * r);
+                kernel_sum += kernel[i];
+            }
+            for(int i = 0; i < kernel_bins; i++)
+            {
+                kernel[i] /= kernel_sum;
+            }
+
+            vector<double> smoothed_histogram(num_bins);
+            for(long i = 0; i < num_bins; i++)
+            {
+                double output = 0.0;
+                long num_samples = 0;
+                for(long j = -k; j <= k; j++)
+                {
+                    const long index = i + k;
+                    if(index >= 0 && index < num_bins)
+                    {
+                        output += kernel[j + k] * static_cast<double>(histogram[index]);
+                        num_samples++;
+                    }
+                }
+                smoothed_histogram[i] = output * static_cast<double>(kernel_bins) / static_cast<double>(num_samples);
+            }
+
+            long highest_peak_bin = 0;
+            double highest_peak = smoothed_histogram[0];
+            for(int i = 1; i < num_bins; i++)
+            {
+                if(smoothed_histogram[i] > highest_peak)
+                {
+                    highest_peak = smoothed_histogram[i];
+                    highest_peak_bin = i;
+                }
+            }
+
+            const long peak_separation_in_bins = static_cast<long>(std::ceil(surface_parms.minPeakSeparation.value / surface_parms.binSize.value));
+            long second_peak_bin = -1;
+            double second_peak = std::numeric_limits<double>::min();
+            for(int i = 0; i < num_bins; i++)
+            {
+                if(std::abs(i - highest_peak_bin) > peak_separation_in_bins)
+                {
+                    if(smoothed_histogram[i] > second_peak)
+                    {
+                        second_peak = smoothed_histogram[i];
+                        second_peak_bin = i;
+                    }
+                }
+            }
+
+            if( (second_peak_bin != -1) &&
+                (second_peak * surface_parms.highestPeakRatio.value >= highest_peak) )
+            {
+                if(highest_peak_bin < second_peak_bin)
+                {
+                    highest_peak = second_peak;
+                    highest_peak_bin = second_peak_bin;
+                }
+            }
+
+            const double signal_threshold = bckgnd + (stddev * surface_parms.signalThreshold.value);
+            if(highest_peak >= signal_threshold)
+            {
+                cur_surface_h = min_h + (highest_peak_bin * surface_parms.binSize.value) + (surface_parms.binSize.value / 2.0);
+            }
+        }
+
+        for(long i = p0; i < p1; i++)
+        {
+            surface_h.push_back(cur_surface_h);
+        }
+    }
+}
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_BathyHistogram::OBJECT_TYPE = "UT_BathyHistogram";
+const char* UT_BathyHistogram::LUA_META_NAME = "UT_BathyHistogram";
+const struct luaL_Reg UT_BathyHistogram::LUA_META_TABLE[] = {
+    {"histogram",       luaHistogramTest},
+    {"signal",          luaSignalStrengthTest},
+    {"seasurface",      luaSeaSurfaceTest},
+    {NULL,              NULL}
+};
+
+/******************************************************************************
+ * CLASS METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * luaCreate - :UT_BathyHistogram()
+ *----------------------------------------------------------------------------*/
+int UT_BathyHistogram::luaCreate (lua_State* L)
+{
+    try
+    {
+        return createLuaObject(L, new UT_BathyHistogram(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_BathyHistogram::UT_BathyHistogram (lua_State* L):
+    LuaObject(L, OBJECT_TYPE, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor  -
+ *----------------------------------------------------------------------------*/
+UT_BathyHistogram::~UT_BathyHistogram(void) = default;
+
+/*----------------------------------------------------------------------------
+ * luaHistogramTest - :histogram()
+ *----------------------------------------------------------------------------*/
+int UT_BathyHistogram::luaHistogramTest (lua_State* L)
+{
+    bool status = true;
+
+    const long num_bins = 200;
+    const long smooth_width = 3;
+    const double start = -10.0;
+    const double bin_size = 0.1;
+
+    std::mt19937 gen(UT_SEED);
+    std::uniform_real_distribution<double> value(start - 1.0, start + (num_bins * bin_size) + 1.0);
+
+    BathyHistogram histogram(smooth_width);
+    histogram.reset(num_bins, start, bin_size);
+
+    /* slide a window over random values */
+    vector<double> values;
+    for(int i = 0; i < 5000; i++) values.push_back(value(gen));
+
+    const long window = 300;
+    for(long w = 0; w + window <= static_cast<long>(values.size()) && status; w += 50)
+    {
+        if(w == 0)
+        {
+            for(long i = 0; i < window; i++) histogram.add(values[i]);
+        }
+        else
+        {
+            for(long i = w - 50; i < w; i++) histogram.remove(values[i]);
+            for(long i = w + window - 50; i < w + window; i++) histogram.add(values[i]);
+        }
+
+        /* rebuild expected histogram from scratch */
+        vector<uint32_t> expected(num_bins, 0);
+        long population = 0;
+        for(long i = w; i < w + window; i++)
+        {
+            const long bin = static_cast<long>(std::floor((values[i] - start) / bin_size));
+            if(bin >= 0 && bin < num_bins)
+            {
+                expected[bin]++;
+                population++;
+            }
+        }
+
+        if(histogram.population() != population)
+        {
+            mlog(CRITICAL, "Window %ld: mismatched population %ld != %ld", w, histogram.population(), population);
+            status = false;
+        }
+
+        for(long b = 0; b < num_bins; b++)
+        {
+            if(histogram[b] != expected[b])
+            {
+                mlog(CRITICAL, "Window %ld: mismatched bin %ld: %u != %u", w, b, histogram[b], expected[b]);
+                status = false;
+            }
+        }
+
+        /* smoothed bins and order statistics */
+        vector<uint32_t> boxes;
+        uint64_t total = 0;
+        for(long b = 0; b + smooth_width <= num_bins; b++)
+        {
+            uint32_t box = 0;
+            for(long j = 0; j < smooth_width; j++) box += expected[b + j];
+            boxes.push_back(box);
+            total += box;
+        }
+
+        if(histogram.numSmoothed() != static_cast<long>(boxes.size()) || histogram.smoothedTotal() != total)
+        {
+            mlog(CRITICAL, "Window %ld: mismatched smoothing %ld, %lu != %ld, %lu", w, histogram.numSmoothed(), (unsigned long)histogram.smoothedTotal(), (long)boxes.size(), (unsigned long)total);
+            status = false;
+            continue;
+        }
+
+        for(long b = 0; b < histogram.numSmoothed(); b++)
+        {
+            if(histogram.smoothed(b) != boxes[b])
+            {
+                mlog(CRITICAL, "Window %ld: mismatched smoothed bin %ld: %u != %u", w, b, histogram.smoothed(b), boxes[b]);
+                status = false;
+            }
+        }
+
+        std::sort(boxes.begin(), boxes.end(), std::greater<uint32_t>());
+        for(long count: {0L, 1L, 10L, 100L, static_cast<long>(boxes.size())})
+        {
+            uint64_t highest = 0;
+            for(long j = 0; j < count; j++) highest += boxes[j];
+            if(histogram.sumHighest(count) != highest)
+            {
+                mlog(CRITICAL, "Window %ld: mismatched sum of highest %ld bins: %lu != %lu", w, count, (unsigned long)histogram.sumHighest(count), (unsigned long)highest);
+                status = false;
+            }
+        }
+    }
+
+    return returnLuaStatus(L, status);
+}
+
+/*----------------------------------------------------------------------------
+ * luaSignalStrengthTest - :signal(<parms>, <signal strength runner>)
+ *----------------------------------------------------------------------------*/
+int UT_BathyHistogram::luaSignalStrengthTest (lua_State* L)
+{
+    bool status = true;
+    GeoDataFrame::FrameRunner* runner = NULL;
+
+    try
+    {
+        // dataframe takes ownership of parms
+        runner = dynamic_cast<GeoDataFrame::FrameRunner*>(getLuaObject(L, 3, GeoDataFrame::FrameRunner::OBJECT_TYPE));
+        BathyParameters* parms = dynamic_cast<BathyParameters*>(getLuaObject(L, 2, BathyParameters::OBJECT_TYPE));
+
+        BathyDataFrame dataframe(parms);
+        buildTrack(dataframe, parms);
+
+        vector<uint16_t> expected;
+        legacySignalStrength(dataframe, parms, expected);
+
+        if(!runner->run(&dataframe)) throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to run signal strength");
+        FieldColumn<uint16_t>* signal_strength = reinterpret_cast<FieldColumn<uint16_t>*>(dataframe.getColumn("signal_strength"));
+        if(!signal_strength) throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to get signal_strength column");
+
+        long mismatches = 0;
+        for(long i = 0; i < dataframe.length(); i++)
+        {
+            if((*signal_strength)[i] != expected[i])
+            {
+                if(mismatches++ < 10) mlog(CRITICAL, "Mismatched signal strength at photon %ld: %u != %u", i, (*signal_strength)[i], expected[i]);
+                status = false;
+            }
+        }
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error running signal strength test: %s", e.what());
+        status = false;
+    }
+
+    if(runner) runner->releaseLuaObject();
+    return returnLuaStatus(L, status);
+}
+
+/*----------------------------------------------------------------------------
+ * luaSeaSurfaceTest - :seasurface(<parms>, <sea surface runner>)
+ *----------------------------------------------------------------------------*/
+int UT_BathyHistogram::luaSeaSurfaceTest (lua_State* L)
+{
+    bool status = true;
+    GeoDataFrame::FrameRunner* runner = NULL;
+
+    try
+    {
+        // dataframe takes ownership of parms
+        runner = dynamic_cast<GeoDataFrame::FrameRunner*>(getLuaObject(L, 3, GeoDataFrame::FrameRunner::OBJECT_TYPE));
+        BathyParameters* parms = dynamic_cast<BathyParameters*>(getLuaObject(L, 2, BathyParameters::OBJECT_TYPE));
+
+        BathyDataFrame dataframe(parms);
+        buildTrack(dataframe, parms);
+
+        vector<float> expected;
+        legacySeaSurface(dataframe, parms, expected);
+
+        if(!runner->run(&dataframe)) throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to run sea surface finder");
+        FieldColumn<float>* surface_h = reinterpret_cast<FieldColumn<float>*>(dataframe.getColumn("surface_h"));
+        if(!surface_h) throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to get surface_h column");
+
+        long mismatches = 0;
+        for(long i = 0; i < dataframe.length(); i++)
+        {
+            const float h = (*surface_h)[i];
+            if((h != expected[i]) && !(std::isnan(h) && std::isnan(expected[i])))
+            {
+                if(mismatches++ < 10) mlog(CRITICAL, "Mismatched surface height at photon %ld: %f != %f", i, h, expected[i]);
+                status = false;
+            }
+        }
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error running sea surface test: %s", e.what());
+        status = false;
+    }
+
+    if(runner) runner->releaseLuaObject();
+    return returnLuaStatus(L, status);
+}
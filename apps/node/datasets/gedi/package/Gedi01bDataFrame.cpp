@@ -184,6 +184,10 @@ void* Gedi01bDataFrame::subsettingThread (void* parm)
         txwaveform.join(df->readTimeoutMs, true);
         rxwaveform.join(df->readTimeoutMs, true);
 
+        /* Size Waveform Columns */
+        df->tx_waveform.reserve(aoi.count, aoi.count * GEDI01B_TX_SAMPLES_MAX);
+        df->rx_waveform.reserve(aoi.count, aoi.count * GEDI01B_RX_SAMPLES_MAX);
+
         /* Traverse All Footprints In Dataset */
         for(long footprint = 0; df->active.load() && footprint < aoi.count; footprint++)
         {
@@ -224,24 +228,14 @@ void* Gedi01bDataFrame::subsettingThread (void* parm)
             df->flags.append(row_flags);
 
             /* Populate Tx Waveform */
-            FieldList<float> tx_list(GEDI01B_TX_SAMPLES_MAX, 0.0);
             const long tx_start = gedi01b.tx_start_index[footprint] - gedi01b.tx_start_index[0];
-            const long tx_end = tx_start + MIN(gedi01b.tx_sample_count[footprint], static_cast<uint16_t>(GEDI01B_TX_SAMPLES_MAX));
-            for(long i = tx_start, j = 0; i < tx_end; i++, j++)
-            {
-                tx_list[j] = txwaveform[i];
-            }
-            df->tx_waveform.append(tx_list);
+            const long tx_count = MIN(gedi01b.tx_sample_count[footprint], static_cast<uint16_t>(GEDI01B_TX_SAMPLES_MAX));
+            df->tx_waveform.appendList(&txwaveform[tx_start], tx_count, GEDI01B_TX_SAMPLES_MAX, 0.0);
 
             /* Populate Rx Waveform */
-            FieldList<float> rx_list(GEDI01B_RX_SAMPLES_MAX, 0.0);
             const long rx_start = gedi01b.rx_start_index[footprint] - gedi01b.rx_start_index[0];
-            const long rx_end = rx_start + MIN(gedi01b.rx_sample_count[footprint], static_cast<uint16_t>(GEDI01B_RX_SAMPLES_MAX));
-            for(long i = rx_start, j = 0; i < rx_end; i++, j++)
-            {
-                rx_list[j] = rxwaveform[i];
-            }
-            df->rx_waveform.append(rx_list);
+            const long rx_count = MIN(gedi01b.rx_sample_count[footprint], static_cast<uint16_t>(GEDI01B_RX_SAMPLES_MAX));
+            df->rx_waveform.appendList(&rxwaveform[rx_start], rx_count, GEDI01B_RX_SAMPLES_MAX, 0.0);
 
             /* Ancillary Data */
             if(gedi01b.anc_data.length() > 0)
@@ -105,8 +105,8 @@ class Gedi01bDataFrame: public GediDataFrame
         FieldColumn<uint16_t>           tx_size;
         FieldColumn<uint16_t>           rx_size;
         FieldColumn<uint8_t>            flags;
-        FieldColumn<FieldList<float>>   tx_waveform;
-        FieldColumn<FieldList<float>>   rx_waveform;
+        FieldRaggedColumn<float>        tx_waveform;
+        FieldRaggedColumn<float>        rx_waveform;
 
         /*--------------------------------------------------------------------
          * Methods
@@ -139,7 +139,8 @@ Atl03DataFrame::Atl03DataFrame (lua_State* L, const char* beam_str, Atl03Paramet
     usePodppd(parms->podppdMask.value != 0x00),
     useYapc006(parms->stages[Icesat2Parameters::STAGE_YAPC] && (parms->yapc.version.value == 0) && (parms->granuleFields.version.value == 6)),
     useYapc007(parms->stages[Icesat2Parameters::STAGE_YAPC] && (parms->yapc.version.value == 0) && (parms->granuleFields.version.value >= 7)),
-    useGeoid(parms->datum.value == MathLib::EGM08)
+    useGeoid(parms->datum.value == MathLib::EGM08),
+    useLateRead(parms->lateRead.value)
 {
     /* Set Optional PhoREAL Columns */
     if(parms->stages[Icesat2Parameters::STAGE_PHOREAL])
@@ -224,23 +225,24 @@ Atl03DataFrame::Atl03Data::Atl03Data (Atl03DataFrame* df, const AreaOfInterest03
     segment_dist_x      (df->hdf03, FString("%s/%s", df->beam, "geolocation/segment_dist_x").c_str(),   0, aoi.first_segment, aoi.num_segments),
     solar_elevation     (df->hdf03, FString("%s/%s", df->beam, "geolocation/solar_elevation").c_str(),  0, aoi.first_segment, aoi.num_segments),
     podppd_flag         (df->usePodppd ? df->hdf03 : NULL, FString("%s/%s", df->beam, "geolocation/podppd_flag").c_str(), 0, aoi.first_segment, aoi.num_segments),
-    dist_ph_along       (df->hdf03, FString("%s/%s", df->beam, "heights/dist_ph_along").c_str(),        0, aoi.first_photon,  aoi.num_photons),
-    dist_ph_across      (df->hdf03, FString("%s/%s", df->beam, "heights/dist_ph_across").c_str(),       0, aoi.first_photon,  aoi.num_photons),
-    h_ph                (df->hdf03, FString("%s/%s", df->beam, "heights/h_ph").c_str(),                 0, aoi.first_photon,  aoi.num_photons),
+    dist_ph_along       (df->useLateRead ? NULL : df->hdf03, FString("%s/%s", df->beam, "heights/dist_ph_along").c_str(), 0, aoi.first_photon,  aoi.num_photons),
+    dist_ph_across      (df->useLateRead ? NULL : df->hdf03, FString("%s/%s", df->beam, "heights/dist_ph_across").c_str(), 0, aoi.first_photon,  aoi.num_photons),
+    h_ph                (df->useLateRead ? NULL : df->hdf03, FString("%s/%s", df->beam, "heights/h_ph").c_str(), 0, aoi.first_photon,  aoi.num_photons),
     signal_conf_ph      (df->hdf03, FString("%s/%s", df->beam, "heights/signal_conf_ph").c_str(),       df->signalConfColIndex, aoi.first_photon,  aoi.num_photons),
     quality_ph          (df->hdf03, FString("%s/%s", df->beam, "heights/quality_ph").c_str(),           0, aoi.first_photon,  aoi.num_photons),
     weight006_ph        (df->useYapc006 ? df->hdf03 : NULL, FString("%s/%s", df->beam, "heights/weight_ph").c_str(), 0, aoi.first_photon,  aoi.num_photons),
     weight007_ph        (df->useYapc007 ? df->hdf03 : NULL, FString("%s/%s", df->beam, "heights/weight_ph").c_str(), 0, aoi.first_photon,  aoi.num_photons),
-    lat_ph              (df->hdf03, FString("%s/%s", df->beam, "heights/lat_ph").c_str(),               0, aoi.first_photon,  aoi.num_photons),
-    lon_ph              (df->hdf03, FString("%s/%s", df->beam, "heights/lon_ph").c_str(),               0, aoi.first_photon,  aoi.num_photons),
-    delta_time          (df->hdf03, FString("%s/%s", df->beam, "heights/delta_time").c_str(),           0, aoi.first_photon,  aoi.num_photons),
+    lat_ph              (df->useLateRead ? NULL : df->hdf03, FString("%s/%s", df->beam, "heights/lat_ph").c_str(), 0, aoi.first_photon,  aoi.num_photons),
+    lon_ph              (df->useLateRead ? NULL : df->hdf03, FString("%s/%s", df->beam, "heights/lon_ph").c_str(), 0, aoi.first_photon,  aoi.num_photons),
+    delta_time          (df->useLateRead ? NULL : df->hdf03, FString("%s/%s", df->beam, "heights/delta_time").c_str(), 0, aoi.first_photon,  aoi.num_photons),
     bckgrd_delta_time   (df->hdf03, FString("%s/%s", df->beam, "bckgrd_atlas/delta_time").c_str()),
     bckgrd_rate         (df->hdf03, FString("%s/%s", df->beam, "bckgrd_atlas/bckgrd_rate").c_str()),
     geoid               (df->useGeoid ? df->hdf03 : NULL,       FString("%s/%s", df->beam, "geophys_corr/geoid").c_str(),               0,  aoi.first_segment, aoi.num_segments),
     anc_bckgrd_data     (df->parms->atl03BckgrdFields,df->hdf03,FString("%s/%s", df->beam, "bckgrd_atlas").c_str()),
     anc_geo_data        (df->parms->atl03GeoFields,  df->hdf03, FString("%s/%s", df->beam, "geolocation").c_str(),        H5Coro::ALL_COLS, aoi.first_segment, aoi.num_segments),
     anc_corr_data       (df->parms->atl03CorrFields, df->hdf03, FString("%s/%s", df->beam, "geophys_corr").c_str(),       H5Coro::ALL_COLS, aoi.first_segment, aoi.num_segments),
-    anc_ph_data         (df->parms->atl03PhFields,   df->hdf03, FString("%s/%s", df->beam, "heights").c_str(),            H5Coro::ALL_COLS, aoi.first_photon,  aoi.num_photons)
+    anc_ph_data         (df->parms->atl03PhFields,   df->hdf03, FString("%s/%s", df->beam, "heights").c_str(),            H5Coro::ALL_COLS, aoi.first_photon,  aoi.num_photons),
+    num_photons         (0)
 {
     /* Join Hardcoded Reads */
     sc_orient.join(df->readTimeoutMs, true);
@@ -250,16 +252,19 @@ Atl03DataFrame::Atl03Data::Atl03Data (Atl03DataFrame* df, const AreaOfInterest03
     segment_dist_x.join(df->readTimeoutMs, true);
     solar_elevation.join(df->readTimeoutMs, true);
     if(df->usePodppd) podppd_flag.join(df->readTimeoutMs, true);
-    dist_ph_along.join(df->readTimeoutMs, true);
-    dist_ph_across.join(df->readTimeoutMs, true);
-    h_ph.join(df->readTimeoutMs, true);
     signal_conf_ph.join(df->readTimeoutMs, true);
     quality_ph.join(df->readTimeoutMs, true);
     if(df->useYapc006) weight006_ph.join(df->readTimeoutMs, true);
     if(df->useYapc007) weight007_ph.join(df->readTimeoutMs, true);
-    lat_ph.join(df->readTimeoutMs, true);
-    lon_ph.join(df->readTimeoutMs, true);
-    delta_time.join(df->readTimeoutMs, true);
+    if(!df->useLateRead)
+    {
+        dist_ph_along.join(df->readTimeoutMs, true);
+        dist_ph_across.join(df->readTimeoutMs, true);
+        h_ph.join(df->readTimeoutMs, true);
+        lat_ph.join(df->readTimeoutMs, true);
+        lon_ph.join(df->readTimeoutMs, true);
+        delta_time.join(df->readTimeoutMs, true);
+    }
     bckgrd_delta_time.join(df->readTimeoutMs, true);
     bckgrd_rate.join(df->readTimeoutMs, true);
     if(df->useGeoid) geoid.join(df->readTimeoutMs, true);
@@ -269,6 +274,28 @@ Atl03DataFrame::Atl03Data::Atl03Data (Atl03DataFrame* df, const AreaOfInterest03
     anc_geo_data.joinToGDF(df, df->readTimeoutMs, true);
     anc_corr_data.joinToGDF(df, df->readTimeoutMs, true);
     anc_ph_data.joinToGDF(df, df->readTimeoutMs, true);
+
+    /* Set Number of Photons (always read for filtering) */
+    num_photons = quality_ph.size;
+}
+
+/*----------------------------------------------------------------------------
+ * Atl03LateData::Constructor
+ *----------------------------------------------------------------------------*/
+Atl03DataFrame::Atl03LateData::Atl03LateData (Atl03DataFrame* df, const vector<H5Coro::range_t>& ranges):
+    dist_ph_along       (df->hdf03, FString("%s/%s", df->beam, "heights/dist_ph_along").c_str(),        0, ranges),
+    dist_ph_across      (df->hdf03, FString("%s/%s", df->beam, "heights/dist_ph_across").c_str(),       0, ranges),
+    h_ph                (df->hdf03, FString("%s/%s", df->beam, "heights/h_ph").c_str(),                 0, ranges),
+    lat_ph              (df->hdf03, FString("%s/%s", df->beam, "heights/lat_ph").c_str(),               0, ranges),
+    lon_ph              (df->hdf03, FString("%s/%s", df->beam, "heights/lon_ph").c_str(),               0, ranges),
+    delta_time          (df->hdf03, FString("%s/%s", df->beam, "heights/delta_time").c_str(),           0, ranges)
+{
+    dist_ph_along.join(df->readTimeoutMs, true);
+    dist_ph_across.join(df->readTimeoutMs, true);
+    h_ph.join(df->readTimeoutMs, true);
+    lat_ph.join(df->readTimeoutMs, true);
+    lon_ph.join(df->readTimeoutMs, true);
+    delta_time.join(df->readTimeoutMs, true);
 }
 
 /*----------------------------------------------------------------------------
@@ -334,7 +361,7 @@ void Atl03DataFrame::Atl08Class::classify (const Atl03DataFrame* df, const AreaO
     }
 
     /* Allocate ATL08 Classification Array */
-    const long num_photons = atl03.dist_ph_along.size;
+    const long num_photons = atl03.num_photons;
     classification = new uint8_t [num_photons];
 
     /* Allocate PhoREAL Arrays */
@@ -500,7 +527,7 @@ void Atl03DataFrame::Atl24Class::classify (const Atl03DataFrame* df, const AreaO
     atl24_confidence.join(df->readTimeoutMs, true);
 
     /* Allocate ATL08 Classification Array */
-    const long num_photons = atl03.dist_ph_along.size;
+    const long num_photons = atl03.num_photons;
     classification = new uint8_t [num_photons];
     confidence = new float [num_photons];
 
@@ -573,8 +600,18 @@ void* Atl03DataFrame::subsettingThread (void* parm)
         int32_t current_count = 0; // number of photons in current segment already accounted for
         int32_t background_index = 0;
 
-        /* Traverse All Photons In Dataset */
-        while(df->active.load() && (++current_photon < atl03.dist_ph_along.size))
+        /* Initialize Selection of Photons */
+        vector<int32_t> sel_photon;     // index into photon datasets
+        vector<int32_t> sel_segment;    // index into segment datasets
+        vector<int32_t> sel_background; // index into background datasets
+        vector<int8_t>  sel_cnf;        // signal confidence of photon
+        sel_photon.reserve(atl03.num_photons);
+        sel_segment.reserve(atl03.num_photons);
+        sel_background.reserve(atl03.num_photons);
+        sel_cnf.reserve(atl03.num_photons);
+
+        /* Select Photons In Dataset */
+        while(df->active.load() && (++current_photon < atl03.num_photons))
         {
             /* Go to Photon's Segment */
             current_count++;
@@ -632,7 +669,7 @@ void* Atl03DataFrame::subsettingThread (void* parm)
                 continue;
             }
 
-            /* Set and Check ATL03 Photon Quality Level */
+            /* Check ATL03 Photon Quality Level */
             const Icesat2Parameters::quality_ph_t quality_ph = static_cast<Icesat2Parameters::quality_ph_t>(atl03.quality_ph[current_photon]);
             if(quality_ph < Icesat2Parameters::QUALITY_NOMINAL || quality_ph >= Icesat2Parameters::NUM_PHOTON_QUALITY)
             {
@@ -643,7 +680,7 @@ void* Atl03DataFrame::subsettingThread (void* parm)
                 continue;
             }
 
-            /* Set and Check ATL03 POD/PPD Degradation */
+            /* Check ATL03 POD/PPD Degradation */
             if(df->usePodppd)
             {
                 const uint8_t podppd_flag = atl03.podppd_flag[current_segment];
@@ -658,11 +695,10 @@ void* Atl03DataFrame::subsettingThread (void* parm)
                 }
             }
 
-            /* Set and Check ATL08 Classification */
-            Icesat2Parameters::atl08_class_t atl08_class = Icesat2Parameters::ATL08_UNCLASSIFIED;
+            /* Check ATL08 Classification */
             if(atl08.classification)
             {
-                atl08_class = static_cast<Icesat2Parameters::atl08_class_t>(atl08[current_photon]);
+                const Icesat2Parameters::atl08_class_t atl08_class = static_cast<Icesat2Parameters::atl08_class_t>(atl08[current_photon]);
                 if(atl08_class < 0 || atl08_class >= Icesat2Parameters::NUM_ATL08_CLASSES)
                 {
                     throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid atl08 classification: %d", atl08_class);
@@ -673,137 +709,141 @@ void* Atl03DataFrame::subsettingThread (void* parm)
                 }
             }
 
-            /* Set and Check YAPC Score */
-            uint16_t yapc_score = 0;
+            /* Check YAPC Score */
             if(df->useYapc006) // read from atl03 granule release 006
             {
-                yapc_score = atl03.weight006_ph[current_photon];
-                if(yapc_score < parms.yapc.score)
+                if(atl03.weight006_ph[current_photon] < parms.yapc.score)
                 {
                     continue;
                 }
             }
             else if(df->useYapc007) // read from atl03 granule release 007
             {
-                yapc_score = atl03.weight007_ph[current_photon];
-                if(yapc_score < parms.yapc.score)
+                if(atl03.weight007_ph[current_photon] < parms.yapc.score)
                 {
                     continue;
                 }
             }
 
-            /* Set PhoREAL Fields */
-            float relief = 0.0;
-            uint8_t landcover_flag = Atl08Class::INVALID_FLAG;
-            uint8_t snowcover_flag = Atl08Class::INVALID_FLAG;
-            if(atl08.phoreal)
-            {
-                /* Set Relief */
-                if(!parms.phoreal.use_abs_h)
-                {
-                    relief = atl08.relief[current_photon];
-                }
-                else
-                {
-                    relief = atl03.h_ph[current_photon];
-                }
-
-                /* Set Flags */
-                landcover_flag = atl08.landcover[current_photon];
-                snowcover_flag = atl08.snowcover[current_photon];
-            }
-
-            /* Set ATL24 Fields */
-            Atl24Fields::class_t atl24_class = Atl24Fields::UNCLASSIFIED;
-            float atl24_confidence = 0.0;
+            /* Check ATL24 Class and Confidence */
             if(atl24.classification)
             {
-                atl24_class = static_cast<Atl24Fields::class_t>(atl24.classification[current_photon]);
-                if(atl24_class != Atl24Fields::UNCLASSIFIED)
-                {
-                    atl24_confidence = atl24.confidence[current_photon];
-                }
-
-                /* Check ATL24 Class */
+                const Atl24Fields::class_t atl24_class = static_cast<Atl24Fields::class_t>(atl24.classification[current_photon]);
+                const float atl24_confidence = (atl24_class != Atl24Fields::UNCLASSIFIED) ? atl24.confidence[current_photon] : 0.0F;
                 if(!parms.atl24.class_ph[atl24_class])
                 {
                     continue;
                 }
-
-                /* Check ATL24 Confidence */
                 if(parms.atl24.confidence_threshold.value > atl24_confidence)
                 {
                     continue;
                 }
             }
 
-            /* Calculate Spacecraft Velocity */
-            const int32_t sc_v_offset = current_segment * 3;
-            const double sc_v1 = atl03.velocity_sc[sc_v_offset + 0];
-            const double sc_v2 = atl03.velocity_sc[sc_v_offset + 1];
-            const double sc_v3 = atl03.velocity_sc[sc_v_offset + 2];
-            const float spacecraft_velocity = static_cast<float>(sqrt((sc_v1*sc_v1) + (sc_v2*sc_v2) + (sc_v3*sc_v3)));
-
-            /* Calculate Background Rate */
+            /* Find Background Rate */
             while((background_index < (atl03.bckgrd_rate.size - 1)) &&
                   (atl03.bckgrd_delta_time[background_index + 1] <= atl03.segment_delta_time[current_segment]))
             {
                 background_index++;
             }
 
-            /* Calculate Height */
-            float height = atl03.h_ph[current_photon];
-            if(df->useGeoid) height -= atl03.geoid[current_segment];
-
-            /* Add Photon to DataFrame */
-            df->addRow();
-            df->time_ns.append(Icesat2Parameters::deltatime2timestamp(atl03.delta_time[current_photon]));
-            df->latitude.append(atl03.lat_ph[current_photon]);
-            df->longitude.append(atl03.lon_ph[current_photon]);
-            df->segment_id.append(atl03.segment_id[current_segment]);
-            df->x_atc.append(atl03.dist_ph_along[current_photon] + atl03.segment_dist_x[current_segment]);
-            df->y_atc.append(atl03.dist_ph_across[current_photon]);
-            df->height.append(height);
-            df->solar_elevation.append(atl03.solar_elevation[current_segment]);
-            df->background_rate.append(atl03.bckgrd_rate[background_index]);
-            df->atl03_cnf.append(atl03_cnf);
-            df->quality_ph.append(static_cast<int8_t>(quality_ph));
-            df->spacecraft_velocity.append(spacecraft_velocity);
-            df->ph_index.append(current_photon + aoi.first_photon);
-
-            /* Add Optional PhoREAL Data */
-            if(atl08.phoreal)
-            {
-                df->relief.append(relief);
-                df->landcover.append(landcover_flag);
-                df->snowcover.append(snowcover_flag);
-            }
+            /* Select Photon */
+            sel_photon.push_back(current_photon);
+            sel_segment.push_back(current_segment);
+            sel_background.push_back(background_index);
+            sel_cnf.push_back(atl03_cnf);
+        }
 
-            /* Add Optional YAPC Data */
-            if(parms.stages[Icesat2Parameters::STAGE_YAPC])
-            {
-                df->yapc_score.append(yapc_score);
-            }
+        /* Read Remaining Photon Variables for Selected Photons */
+        unique_ptr<Atl03LateData> late;
+        vector<H5Coro::range_t> ranges;
+        vector<int32_t> sel_range;  // range of each selected photon in the late read photon variables
+        vector<int32_t> sel_offset; // row of each selected photon within its range
+        if(df->useLateRead)
+        {
+            chunkRanges(aoi.first_photon, atl03.num_photons, df->photonChunkRows(), sel_photon, ranges, sel_range, sel_offset);
+            late = std::make_unique<Atl03LateData>(df, ranges);
+            mlog(DEBUG, "Late read of %ld photons in %ld ranges for %s/%s", static_cast<long>(sel_photon.size()), static_cast<long>(ranges.size()), df->hdf03->name, df->beam);
+        }
 
-            /* Add Optional ATL08 Data */
-            if(atl08.classification)
-            {
-                df->atl08_class.append(static_cast<uint8_t>(atl08_class));
-            }
+        /* Gather Selected Photons Into DataFrame */
+        const long num_selected = static_cast<long>(sel_photon.size());
+        const int32_t* ph = sel_photon.data();
+        const int32_t* seg = sel_segment.data();
+        const int32_t* bg = sel_background.data();
+        const int8_t* cnf = sel_cnf.data();
+
+        /* Photon Variables Not Used for Filtering */
+        const int32_t* rng = late ? sel_range.data() : NULL;
+        const int32_t* off = late ? sel_offset.data() : ph;
+        const photon_var_t<double> delta_time      = {late ? late->delta_time.data.data()      : &atl03.delta_time.pointer,      rng, off};
+        const photon_var_t<double> lat_ph          = {late ? late->lat_ph.data.data()          : &atl03.lat_ph.pointer,          rng, off};
+        const photon_var_t<double> lon_ph          = {late ? late->lon_ph.data.data()          : &atl03.lon_ph.pointer,          rng, off};
+        const photon_var_t<float>  dist_ph_along   = {late ? late->dist_ph_along.data.data()   : &atl03.dist_ph_along.pointer,   rng, off};
+        const photon_var_t<float>  dist_ph_across  = {late ? late->dist_ph_across.data.data()  : &atl03.dist_ph_across.pointer,  rng, off};
+        const photon_var_t<float>  h_ph            = {late ? late->h_ph.data.data()            : &atl03.h_ph.pointer,            rng, off};
+
+        df->time_ns.appendEach(num_selected, [&](long i){ return Icesat2Parameters::deltatime2timestamp(delta_time[i]); });
+        df->latitude.appendEach(num_selected, [&](long i){ return lat_ph[i]; });
+        df->longitude.appendEach(num_selected, [&](long i){ return lon_ph[i]; });
+        df->segment_id.appendEach(num_selected, [&](long i){ return atl03.segment_id[seg[i]]; });
+        df->x_atc.appendEach(num_selected, [&](long i){ return dist_ph_along[i] + atl03.segment_dist_x[seg[i]]; });
+        df->y_atc.appendEach(num_selected, [&](long i){ return dist_ph_across[i]; });
+        if(df->useGeoid) df->height.appendEach(num_selected, [&](long i){ return h_ph[i] - atl03.geoid[seg[i]]; });
+        else df->height.appendEach(num_selected, [&](long i){ return h_ph[i]; });
+        df->solar_elevation.appendEach(num_selected, [&](long i){ return atl03.solar_elevation[seg[i]]; });
+        df->background_rate.appendEach(num_selected, [&](long i){ return atl03.bckgrd_rate[bg[i]]; });
+        df->atl03_cnf.appendEach(num_selected, [&](long i){ return cnf[i]; });
+        df->quality_ph.appendEach(num_selected, [&](long i){ return atl03.quality_ph[ph[i]]; });
+        df->spacecraft_velocity.appendEach(num_selected, [&](long i){
+            const int32_t sc_v_offset = seg[i] * 3;
+            const double sc_v1 = atl03.velocity_sc[sc_v_offset + 0];
+            const double sc_v2 = atl03.velocity_sc[sc_v_offset + 1];
+            const double sc_v3 = atl03.velocity_sc[sc_v_offset + 2];
+            return static_cast<float>(sqrt((sc_v1*sc_v1) + (sc_v2*sc_v2) + (sc_v3*sc_v3)));
+        });
+        df->setNumRows(df->ph_index.appendEach(num_selected, [&](long i){ return static_cast<uint32_t>(ph[i] + aoi.first_photon); }));
 
-            /* Add Optional ATL24 Data */
-            if(atl24.classification)
-            {
-                df->atl24_class.append(static_cast<uint8_t>(atl24_class));
-                df->atl24_confidence.append(atl24_confidence);
-            }
+        /* Gather Optional PhoREAL Data */
+        if(atl08.phoreal)
+        {
+            if(!parms.phoreal.use_abs_h) df->relief.appendEach(num_selected, [&](long i){ return atl08.relief[ph[i]]; });
+            else df->relief.appendEach(num_selected, [&](long i){ return h_ph[i]; });
+            df->landcover.appendEach(num_selected, [&](long i){ return atl08.landcover[ph[i]]; });
+            df->snowcover.appendEach(num_selected, [&](long i){ return atl08.snowcover[ph[i]]; });
+        }
 
-            /* Add Ancillary Elements */
-            if(atl03.anc_bckgrd_data.length() > 0)  atl03.anc_bckgrd_data.addToGDF(df, background_index);
-            if(atl03.anc_geo_data.length() > 0)     atl03.anc_geo_data.addToGDF(df, current_segment);
-            if(atl03.anc_corr_data.length() > 0)    atl03.anc_corr_data.addToGDF(df, current_segment);
-            if(atl03.anc_ph_data.length() > 0)      atl03.anc_ph_data.addToGDF(df, current_photon);
-            if(atl08.anc_seg_indices)               atl08.anc_seg_data.addToGDF(df, atl08.anc_seg_indices[current_photon]);
+        /* Gather Optional YAPC Data */
+        if(parms.stages[Icesat2Parameters::STAGE_YAPC])
+        {
+            if(df->useYapc006) df->yapc_score.appendEach(num_selected, [&](long i){ return static_cast<uint16_t>(atl03.weight006_ph[ph[i]]); });
+            else if(df->useYapc007) df->yapc_score.appendEach(num_selected, [&](long i){ return atl03.weight007_ph[ph[i]]; });
+            else df->yapc_score.appendValue(0, num_selected);
+        }
+
+        /* Gather Optional ATL08 Data */
+        if(atl08.classification)
+        {
+            df->atl08_class.appendEach(num_selected, [&](long i){ return atl08[ph[i]]; });
+        }
+
+        /* Gather Optional ATL24 Data */
+        if(atl24.classification)
+        {
+            df->atl24_class.appendEach(num_selected, [&](long i){ return atl24.classification[ph[i]]; });
+            df->atl24_confidence.appendEach(num_selected, [&](long i){
+                return (atl24.classification[ph[i]] != Atl24Fields::UNCLASSIFIED) ? atl24.confidence[ph[i]] : 0.0F;
+            });
+        }
+
+        /* Gather Ancillary Elements */
+        for(long i = 0; i < num_selected; i++)
+        {
+            if(atl03.anc_bckgrd_data.length() > 0)  atl03.anc_bckgrd_data.addToGDF(df, bg[i]);
+            if(atl03.anc_geo_data.length() > 0)     atl03.anc_geo_data.addToGDF(df, seg[i]);
+            if(atl03.anc_corr_data.length() > 0)    atl03.anc_corr_data.addToGDF(df, seg[i]);
+            if(atl03.anc_ph_data.length() > 0)      atl03.anc_ph_data.addToGDF(df, ph[i]);
+            if(atl08.anc_seg_indices)               atl08.anc_seg_data.addToGDF(df, atl08.anc_seg_indices[ph[i]]);
         }
     }
     catch(const RunTimeException& e)
@@ -820,3 +860,53 @@ void* Atl03DataFrame::subsettingThread (void* parm)
     /* Return */
     return NULL;
 }
+
+/*----------------------------------------------------------------------------
+ * photonChunkRows
+ *
+ *  Number of rows in each chunk of the heights datasets, read from the data
+ *  layout message of h_ph
+ *----------------------------------------------------------------------------*/
+long Atl03DataFrame::photonChunkRows (void) const
+{
+    const H5Coro::info_t info = H5Coro::read(hdf03, FString("%s/%s", beam, "heights/h_ph").c_str(), RecordObject::DYNAMIC, NULL, 0, true, traceId);
+    if(info.chunkdims[0] > 0) return static_cast<long>(info.chunkdims[0]);
+    return UNCHUNKED_RANGE_ROWS;
+}
+
+/*----------------------------------------------------------------------------
+ * chunkRanges
+ *
+ *  Builds the row ranges, aligned to the chunks of the heights datasets, that
+ *  hold the selected photons, along with the range of each selected photon
+ *  and its row within that range
+ *----------------------------------------------------------------------------*/
+void Atl03DataFrame::chunkRanges (long first_photon, long num_photons, long chunk_rows, const vector<int32_t>& photons, vector<H5Coro::range_t>& ranges, vector<int32_t>& range_index, vector<int32_t>& offsets)
+{
+    const int64_t first_row = first_photon;
+    const int64_t last_row = first_photon + num_photons; // exclusive
+
+    range_index.reserve(photons.size());
+    offsets.reserve(photons.size());
+    for(const int32_t photon: photons)
+    {
+        const int64_t row = first_row + photon;
+        if(ranges.empty() || (row >= ranges.back().r1))
+        {
+            const int64_t chunk_start = (row / chunk_rows) * chunk_rows;
+            const int64_t chunk_end = chunk_start + chunk_rows;
+            const int64_t r0 = MAX(chunk_start, first_row);
+            const int64_t r1 = MIN(chunk_end, last_row);
+            if(!ranges.empty() && (ranges.back().r1 == r0))
+            {
+                ranges.back().r1 = r1; // extend range into adjacent chunk
+            }
+            else
+            {
+                ranges.push_back({r0, r1});
+            }
+        }
+        range_index.push_back(static_cast<int32_t>(ranges.size() - 1));
+        offsets.push_back(static_cast<int32_t>(row - ranges.back().r0));
+    }
+}
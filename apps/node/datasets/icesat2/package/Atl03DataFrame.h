@@ -42,6 +42,7 @@
 #include "MsgQ.h"
 #include "OsApi.h"
 #include "H5Array.h"
+#include "H5RangeArray.h"
 #include "H5VarSet.h"
 #include "H5Object.h"
 #include "Atl03Parameters.h"
@@ -141,6 +142,34 @@ class Atl03DataFrame: public GeoDataFrame
                 H5VarSet            anc_geo_data;
                 H5VarSet            anc_corr_data;
                 H5VarSet            anc_ph_data;
+
+                long                num_photons;
+        };
+
+        /* Atl03 Late Read Subclass */
+        class Atl03LateData
+        {
+            public:
+
+                Atl03LateData       (Atl03DataFrame* df, const vector<H5Coro::range_t>& ranges);
+                ~Atl03LateData      (void) = default;
+
+                H5RangeArray<float>     dist_ph_along;
+                H5RangeArray<float>     dist_ph_across;
+                H5RangeArray<float>     h_ph;
+                H5RangeArray<double>    lat_ph;
+                H5RangeArray<double>    lon_ph;
+                H5RangeArray<double>    delta_time;
+        };
+
+        /* Photon Variable - selected photon rows of either the area of interest or the late read ranges */
+        template <class T>
+        struct photon_var_t
+        {
+            const T* const* data;   // rows of each range
+            const int32_t*  range;  // range of each selected photon, NULL when there is a single range
+            const int32_t*  offset; // row of each selected photon within its range
+            T operator[] (long i) const { return range ? data[range[i]][offset[i]] : data[0][offset[i]]; }
         };
 
         /* Atl08 Classification Subclass */
@@ -213,6 +242,7 @@ class Atl03DataFrame: public GeoDataFrame
          *--------------------------------------------------------------------*/
 
         static const double ATL03_SEGMENT_LENGTH;
+        static const long UNCHUNKED_RANGE_ROWS = 10000; // alignment of late read ranges when the heights datasets are not chunked
 
         /*--------------------------------------------------------------------
          * Data
@@ -232,6 +262,7 @@ class Atl03DataFrame: public GeoDataFrame
         bool                useYapc006;
         bool                useYapc007;
         bool                useGeoid;
+        bool                useLateRead;
 
         /*--------------------------------------------------------------------
          * Methods
@@ -242,6 +273,15 @@ class Atl03DataFrame: public GeoDataFrame
                                              const char* outq_name);
                         ~Atl03DataFrame     (void) override;
         static void*    subsettingThread    (void* parm);
+        long            photonChunkRows     (void) const;
+        static void     chunkRanges         (long first_photon, long num_photons, long chunk_rows, const vector<int32_t>& photons,
+                                             vector<H5Coro::range_t>& ranges, vector<int32_t>& range_index, vector<int32_t>& offsets);
+
+        /*--------------------------------------------------------------------
+         * Friends
+         *--------------------------------------------------------------------*/
+
+        friend class UT_Atl03DataFrame; // necessary for exercising the late read ranges
 };
 
 #endif  /* __atl03_dataframe__ */
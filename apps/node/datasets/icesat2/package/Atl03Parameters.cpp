@@ -296,6 +296,7 @@ Atl03Parameters::Atl03Parameters(lua_State* L, uint64_t key_space, const char* a
     addParameter("len",                 &extentLength,          "Size (in meters) of the variable length segment");
     addParameter("res",                 &extentStep,            "Step (in meters) of the variable length segments; could also be thought of as the spacing of the segments or the resolution of the segments");
     addParameter("podppd",              &podppdMask,            "Pointing/geolocation degradation mask; each bit in the mask represents a pointing/geolocation solution quality assessment to be included; the bits are 0: nominal, 1: pod_degrade, 2: ppd_degrade, 3: podppd_degrade, 4: cal_nominal, 5: cal_pod_degrade, 6: cal_ppd_degrade, 7: cal_podppd_degrade");
+    addParameter("late_read",           &lateRead,              "Boolean flag indicating that photon variables not used for filtering (e.g. heights, locations, times) are only read for the chunks that contain photons passing the confidence, quality, and YAPC filters; reduces the data read for highly selective requests");
     addParameter("fit",                 &fit,                   "Configuration structure for the 'Surface Fitting' algorithm; when provided the servers will fit a surface to the source photon cloud and return an elevation dataset similar to ATL06");
     addParameter("yapc",                &yapc,                  "Configuration structure for the 'Yet Another Photon Classifier' algorithm; when provided the servers will calculate a density score for each photon and include that score in the response data");
     addParameter("phoreal",             &phoreal,               "Configuration structure for the 'PhoREAL' algorithm; when provided the servers will calculate canopy metrics on the source photon cloud and return those metrics as a dataset similar to ATL08");
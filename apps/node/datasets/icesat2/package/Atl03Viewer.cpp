@@ -97,6 +97,7 @@ int Atl03Viewer::luaCreate (lua_State* L)
         /* Check for Null Resource and Asset */
         if(_parms->resource.value.empty()) throw RunTimeException(CRITICAL, RTE_FAILURE, "Must supply a resource to process");
         else if(_parms->asset.asset == NULL) throw RunTimeException(CRITICAL, RTE_FAILURE, "Must supply a valid asset");
+        else if(_parms->viewLevel.value < 0 || _parms->viewLevel.value > SegmentPyramid::NUM_LEVELS) throw RunTimeException(CRITICAL, RTE_FAILURE, "Invalid view level: %d", _parms->viewLevel.value);
 
         /* Return Viewer Object */
         return createLuaObject(L, new Atl03Viewer(L, outq_name, _parms, send_terminator));
@@ -421,66 +422,9 @@ void* Atl03Viewer::subsettingThread (void* parm)
 
     try
     {
-        /* Subset to Region of Interest */
-        const Region region(info);
-
-        /* Read ATL03 Datasets */
-        const Atl03Data atl03(info, region);
-
-        /* Increment Read Statistics */
-        local_stats.segments_read = region.num_segments;
-
-        List<segment_t> segments;
-
-        const uint32_t max_segments_per_extent = 256;
-
-        /* Loop Through Each Segment */
-        for(long s = 0; reader->active.load() && s < region.num_segments; s++)
-        {
-            /* Skip segments with zero photon count */
-            if(region.segment_ph_cnt[s] == 0) continue;
-
-            const segment_t segment = {
-                .time_ns   = Icesat2Parameters::deltatime2timestamp(atl03.segment_delta_time[s]),
-                .extent_id = Icesat2Parameters::generateExtentId(parms->granuleFields.rgt.value, parms->granuleFields.cycle.value, parms->granuleFields.region.value, info->track, info->pair, s),
-                .latitude  = region.segment_lat[s],
-                .longitude = region.segment_lon[s],
-                .dist_x    = atl03.segment_dist_x[s],
-                .id        = static_cast<uint32_t>(atl03.segment_id[s]),
-                .ph_cnt    = static_cast<uint32_t>(region.segment_ph_cnt[s])
-            };
-            segments.add(segment);
-
-            const bool last_segment = (s == local_stats.segments_read - 1);
-
-            if(segments.length() % max_segments_per_extent == 0 || last_segment)
-            {
-                /* Calculate Extent Record Size */
-                const int batch_bytes = offsetof(extent_t, segments) + (sizeof(segment_t) * segments.length());
-
-                /* Initialize Extent Record */
-                RecordObject record (batchRecType, batch_bytes);
-                extent_t* extent = reinterpret_cast<extent_t*>(record.getRecordData());
-                extent->region = parms->granuleFields.region.value;
-                extent->track = info->track;
-                extent->pair = info->pair;
-                extent->spot = Icesat2Parameters::getSpotNumber(static_cast<Icesat2Parameters::sc_orient_t>(atl03.sc_orient[0]),
-                                                           static_cast<Icesat2Parameters::track_t>(info->track), info->pair);
-                extent->reference_ground_track = parms->granuleFields.rgt.value;
-                extent->cycle = parms->granuleFields.cycle.value;
-
-                /* Populate Segments */
-                for(int32_t i = 0; i < segments.length(); i++)
-                {
-                    extent->segments[i] = segments.get(i);
-                }
-
-                reader->postRecord(record, local_stats);
-
-                /* Reset Segment List */
-                segments.clear();
-            }
-        }
+        /* View Granule at Requested Resolution */
+        if(parms->viewLevel.value > 0) reader->viewPyramid(info, local_stats);
+        else reader->viewSegments(info, local_stats);
     }
     catch(const RunTimeException& e)
     {
@@ -536,6 +480,138 @@ void* Atl03Viewer::subsettingThread (void* parm)
     return NULL;
 }
 
+/*----------------------------------------------------------------------------
+ * viewSegments - every segment read from the granule
+ *----------------------------------------------------------------------------*/
+void Atl03Viewer::viewSegments (const info_t* info, stats_t& local_stats)
+{
+    /* Subset to Region of Interest */
+    const Region region(info);
+
+    /* Read ATL03 Datasets */
+    const Atl03Data atl03(info, region);
+
+    /* Increment Read Statistics */
+    local_stats.segments_read = region.num_segments;
+
+    List<segment_t> segments;
+
+    /* Loop Through Each Segment */
+    for(long s = 0; active.load() && s < region.num_segments; s++)
+    {
+        /* Skip segments with zero photon count */
+        if(region.segment_ph_cnt[s] == 0) continue;
+
+        const segment_t segment = {
+            .time_ns   = Icesat2Parameters::deltatime2timestamp(atl03.segment_delta_time[s]),
+            .extent_id = Icesat2Parameters::generateExtentId(parms->granuleFields.rgt.value, parms->granuleFields.cycle.value, parms->granuleFields.region.value, info->track, info->pair, s),
+            .latitude  = region.segment_lat[s],
+            .longitude = region.segment_lon[s],
+            .dist_x    = atl03.segment_dist_x[s],
+            .id        = static_cast<uint32_t>(atl03.segment_id[s]),
+            .ph_cnt    = static_cast<uint32_t>(region.segment_ph_cnt[s])
+        };
+        segments.add(segment);
+
+        const bool last_segment = (s == local_stats.segments_read - 1);
+
+        if(segments.length() % MAX_SEGMENTS_PER_EXTENT == 0 || last_segment)
+        {
+            postExtent(info, segments, atl03.sc_orient[0], local_stats);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * viewPyramid - bins of the segment pyramid at the requested level
+ *
+ *  bins are sent as segment records: the time, distance and id are those of
+ *  the first segment in the bin, the location is that of its middle segment
+ *  with photons, and the photon count is the total of the bin
+ *----------------------------------------------------------------------------*/
+void Atl03Viewer::viewPyramid (const info_t* info, stats_t& local_stats)
+{
+    /* Read Spacecraft Orientation */
+    H5Array<int8_t> sc_orient(context, "/orbit_info/sc_orient");
+    sc_orient.join(read_timeout_ms, true);
+
+    /* Get Pyramid Level */
+    const SegmentPyramid pyramid(context, parms->asset.getName(), parms->getResource(), info->prefix, read_timeout_ms);
+    long num_bins = 0;
+    const SegmentPyramid::bin_t* bins = pyramid.level(parms->viewLevel.value, &num_bins);
+
+    /* Increment Read Statistics */
+    local_stats.segments_read = num_bins;
+
+    List<segment_t> segments;
+
+    /* Loop Through Each Bin */
+    for(long b = 0; active.load() && b < num_bins; b++)
+    {
+        const SegmentPyramid::bin_t& bin = bins[b];
+
+        /* Skip bins with zero photon count or outside region of interest */
+        bool include = (bin.ph_cnt > 0);
+        if(include)
+        {
+            if(parms->regionMask.valid()) include = parms->maskIncludes(bin.longitude, bin.latitude);
+            else if(parms->pointsInPolygon.value > 0) include = parms->polyIncludes(bin.longitude, bin.latitude);
+        }
+
+        if(include)
+        {
+            const segment_t segment = {
+                .time_ns   = Icesat2Parameters::deltatime2timestamp(bin.delta_time),
+                .extent_id = Icesat2Parameters::generateExtentId(parms->granuleFields.rgt.value, parms->granuleFields.cycle.value, parms->granuleFields.region.value, info->track, info->pair, b),
+                .latitude  = bin.latitude,
+                .longitude = bin.longitude,
+                .dist_x    = bin.dist_x,
+                .id        = static_cast<uint32_t>(bin.segment_id),
+                .ph_cnt    = bin.ph_cnt
+            };
+            segments.add(segment);
+        }
+
+        const bool last_bin = (b == num_bins - 1);
+
+        if((segments.length() > 0) && (segments.length() % MAX_SEGMENTS_PER_EXTENT == 0 || last_bin))
+        {
+            postExtent(info, segments, sc_orient[0], local_stats);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * postExtent - post and clear a batch of segments
+ *----------------------------------------------------------------------------*/
+void Atl03Viewer::postExtent (const info_t* info, List<segment_t>& segments, int8_t sc_orient, stats_t& local_stats)
+{
+    /* Calculate Extent Record Size */
+    const int batch_bytes = offsetof(extent_t, segments) + (sizeof(segment_t) * segments.length());
+
+    /* Initialize Extent Record */
+    RecordObject record (batchRecType, batch_bytes);
+    extent_t* extent = reinterpret_cast<extent_t*>(record.getRecordData());
+    extent->region = parms->granuleFields.region.value;
+    extent->track = info->track;
+    extent->pair = info->pair;
+    extent->spot = Icesat2Parameters::getSpotNumber(static_cast<Icesat2Parameters::sc_orient_t>(sc_orient),
+                                               static_cast<Icesat2Parameters::track_t>(info->track), info->pair);
+    extent->reference_ground_track = parms->granuleFields.rgt.value;
+    extent->cycle = parms->granuleFields.cycle.value;
+
+    /* Populate Segments */
+    for(int32_t i = 0; i < segments.length(); i++)
+    {
+        extent->segments[i] = segments.get(i);
+    }
+
+    postRecord(record, local_stats);
+
+    /* Reset Segment List */
+    segments.clear();
+}
+
 /*----------------------------------------------------------------------------
  * postRecord
  *----------------------------------------------------------------------------*/
@@ -44,6 +44,7 @@
 #include "OsApi.h"
 #include "H5Array.h"
 #include "Atl03Parameters.h"
+#include "SegmentPyramid.h"
 
 /******************************************************************************
  * ATL03 VIEWER
@@ -58,6 +59,7 @@ class Atl03Viewer: public LuaObject
          *--------------------------------------------------------------------*/
 
         static const int32_t INVALID_INDICE = -1;
+        static const int32_t MAX_SEGMENTS_PER_EXTENT = 256;
 
         static const char* segRecType;
         static const RecordObject::fieldDef_t segRecDef[];
@@ -193,6 +195,9 @@ class Atl03Viewer: public LuaObject
                             ~Atl03Viewer                (void) override;
 
         static void*        subsettingThread            (void* parm);
+        void                viewSegments                (const info_t* info, stats_t& local_stats);
+        void                viewPyramid                 (const info_t* info, stats_t& local_stats);
+        void                postExtent                  (const info_t* info, List<segment_t>& segments, int8_t sc_orient, stats_t& local_stats);
         void                postRecord                  (RecordObject& record, stats_t& local_stats);
         static int          luaStats                    (lua_State* L);
 };
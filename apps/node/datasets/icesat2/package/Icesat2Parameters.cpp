@@ -270,6 +270,7 @@ Icesat2Parameters::Icesat2Parameters(lua_State* L, uint64_t key_space, const cha
     addParameter("spots",               &spots,                 "List of spots (1, 2, 3, 4, 5, 6) to process; this is only supported by the atl03x endpoint");
     addParameter("beams",               &beams,                 "List of beams (gt1l, gt1r, gt2l, gt2r, gt3l, gt3r; defaults to all) to process");
     addParameter("track",               &track,                 "Reference pair track number (1, 2, 3, or 0 to include for all three; defaults to 0) to process; note that when provided, this is combined with the beam selection as a union of the two");
+    addParameter("view_level",          &viewLevel,             "Resolution served by the viewer endpoints: 0 reads every segment from the granule; 1 to 4 serve bins of 8, 64, 512, or 4096 segments from a cached summary of the granule");
     addParameter("atl09_fields",        &atl09Fields,           "Ancillary fields in the ATL09 granule to include in the response (e.g. low_rate/cal_c); supported by all x-series endpoints");
     addParameter("granule",             &granuleFields,         "Versioning, ground track, and date information pulled from the granule processed; output only");
 
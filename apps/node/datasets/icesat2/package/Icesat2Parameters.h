@@ -395,6 +395,7 @@ class Icesat2Parameters: public RequestParameters
         FieldEnumeration<spot_t, NUM_SPOTS>                 spots = {true, true, true, true, true, true};           // list of which spots (1,2,3,4,5,6)
         FieldEnumeration<gt_t,NUM_SPOTS>                    beams {true, true, true, true, true, true};             // list of which beams (gt[l|r][1|2|3])
         FieldElement<int>                                   track {ALL_TRACKS};                                     // reference pair track number (1, 2, 3, or 0 for all tracks)
+        FieldElement<int>                                   viewLevel {0};                                          // segment pyramid level served by the viewers (0 for full resolution)
         FieldList<string>                                   atl09Fields;                                            // list of ATL09 fields used by Atl09Sampler
         Atl03GranuleFields                                  granuleFields;                                          // ATL03 granule attributes
 
@@ -105,6 +105,19 @@ bool PhoReal::run (GeoDataFrame* dataframe)
 {
     Atl03DataFrame& df = *dynamic_cast<Atl03DataFrame*>(dataframe);
 
+    // find extents to process
+    vector<extent_t> extents;
+    findExtents(df, extents);
+
+    // run phoreal algorithm on extents across the frame runner pool
+    vector<result_t> results(extents.size());
+    extent_context_t context = {this, &df, &extents, &results};
+    if(!parms->runnerPool.run(processExtents, &context, extents.size(), EXTENT_GRAIN))
+    {
+        mlog(CRITICAL, "Failed to process extents");
+        return false;
+    }
+
     // create new dataframe columns
     FieldColumn<time8_t>*   time_ns                 = new FieldColumn<time8_t>(Field::TIME_COLUMN);
     FieldColumn<double>*    latitude                = new FieldColumn<double>(Field::Y_COLUMN);
@@ -136,6 +149,87 @@ bool PhoReal::run (GeoDataFrame* dataframe)
     GeoDataFrame::createAncillaryColumns(&ancillary_columns, parms->atl03PhFields);
     GeoDataFrame::createAncillaryColumns(&ancillary_columns, parms->atl08Fields);
 
+    // for each extent
+    for(size_t e = 0; e < extents.size(); e++)
+    {
+        const extent_t& extent = extents[e];
+        const result_t& result = results[e];
+        const int32_t i0 = extent.start_photon;
+        const int32_t num_photons = extent.num_photons;
+
+        pflags->append(result.pflags | extent.pflags);
+        time_ns->append(static_cast<time8_t>(result.time_ns));
+        latitude->append(result.latitude);
+        longitude->append(result.longitude);
+        segment_id_beg->append(df.segment_id[i0]);
+        x_atc->append(result.x_atc);
+        y_atc->append(result.y_atc);
+
+        ground_photon_count->append(result.ground_photon_count);
+        vegetation_photon_count->append(result.vegetation_photon_count);
+        h_te_median->append(result.h_te_median);
+        h_max_canopy->append(result.h_max_canopy);
+        h_min_canopy->append(result.h_min_canopy);
+        h_mean_canopy->append(result.h_mean_canopy);
+        h_canopy->append(result.h_canopy);
+        canopy_openness->append(result.canopy_openness);
+        canopy_h_metrics->append(result.canopy_h_metrics);
+
+        const uint32_t center_ph = i0 + (num_photons / 2);
+        photon_start->append(df.ph_index[i0]);
+        photon_count->append(static_cast<uint32_t>(num_photons));
+        landcover->append(df.landcover[center_ph]);
+        snowcover->append(df.snowcover[center_ph]);
+        solar_elevation->append(df.solar_elevation[center_ph]);
+
+        GeoDataFrame::populateAncillaryColumns(ancillary_columns, df, i0, num_photons);
+    }
+
+    // clear all columns from original dataframe
+    dataframe->clear(); // frees memory
+
+    // install new columns into dataframe
+    dataframe->addExistingColumn("time_ns",                 time_ns,                    "Unix time (nanoseconds)");
+    dataframe->addExistingColumn("latitude",                latitude,                   "Latitude (EPSG:9989)");
+    dataframe->addExistingColumn("longitude",               longitude,                  "Longitude (EPSG:9989)");
+    dataframe->addExistingColumn("segment_id_beg",          segment_id_beg,             "First segment used in extent to calculate vegetation metrics");
+    dataframe->addExistingColumn("x_atc",                   x_atc,                      "Distance from the equator (in meters)");
+    dataframe->addExistingColumn("y_atc",                   y_atc,                      "distance from reference track (in meters)");
+    dataframe->addExistingColumn("photon_start",            photon_start,               "photon index of start of extent");
+    dataframe->addExistingColumn("photon_count",            photon_count,               "number of photons used in final elevation calculation");
+    dataframe->addExistingColumn("pflags",                  pflags,                     "processing flags");
+    dataframe->addExistingColumn("ground_photon_count",     ground_photon_count,        "number of photons labeled as ground in extent");
+    dataframe->addExistingColumn("vegetation_photon_count", vegetation_photon_count,    "number of photons labeled as canopy or top of canopy in extent");
+    dataframe->addExistingColumn("landcover",               landcover,                  "atl08 land_segments/segments_landcover");
+    dataframe->addExistingColumn("snowcover",               snowcover,                  "atl08 land_segments/segments_snowcover");
+    dataframe->addExistingColumn("solar_elevation",         solar_elevation,            "atl03 solar elevation");
+    dataframe->addExistingColumn("h_te_median",             h_te_median,                "median terrain height for ground photons");
+    dataframe->addExistingColumn("h_max_canopy",            h_max_canopy,               "maximum relief height for canopy photons");
+    dataframe->addExistingColumn("h_min_canopy",            h_min_canopy,               "minimum relief height for canopy photons");
+    dataframe->addExistingColumn("h_mean_canopy",           h_mean_canopy,              "average relief height for canopy photons");
+    dataframe->addExistingColumn("h_canopy",                h_canopy,                   "98th percentile relief height for canopy photons");
+    dataframe->addExistingColumn("canopy_openness",         canopy_openness,            "standard deviation of relief height for canopy photons");
+    dataframe->addExistingColumn("canopy_h_metrics",        canopy_h_metrics,           "relief height at given percentile for canopy photons");
+
+    // install ancillary columns into dataframe
+    GeoDataFrame::addAncillaryColumns (ancillary_columns, dataframe);
+    delete ancillary_columns;
+
+    // finalize dataframe
+    dataframe->populateGeoColumns();
+
+    // return success
+    return true;
+}
+
+/*----------------------------------------------------------------------------
+ * findExtents
+ *
+ *  steps through the photons in extent step increments and records each
+ *  extent the algorithm is to be run on
+ *----------------------------------------------------------------------------*/
+void PhoReal::findExtents (const Atl03DataFrame& df, vector<extent_t>& extents) const
+{
     // for each photon
     int32_t i0 = 0; // start row
     while(i0 < df.length())
@@ -175,39 +269,10 @@ bool PhoReal::run (GeoDataFrame* dataframe)
             _pflags |= Icesat2Parameters::PFLAG_TOO_FEW_PHOTONS;
         }
 
-        // run phoreal algorithm
+        // add extent to be processed
         if(_pflags == 0 || parms->passInvalid)
         {
-            result_t result;
-            geolocate(df, i0, num_photons, result);
-            algorithm(df, i0, num_photons, result);
-
-            pflags->append(result.pflags | _pflags);
-            time_ns->append(static_cast<time8_t>(result.time_ns));
-            latitude->append(result.latitude);
-            longitude->append(result.longitude);
-            segment_id_beg->append(df.segment_id[i0]);
-            x_atc->append(result.x_atc);
-            y_atc->append(result.y_atc);
-
-            ground_photon_count->append(result.ground_photon_count);
-            vegetation_photon_count->append(result.vegetation_photon_count);
-            h_te_median->append(result.h_te_median);
-            h_max_canopy->append(result.h_max_canopy);
-            h_min_canopy->append(result.h_min_canopy);
-            h_mean_canopy->append(result.h_mean_canopy);
-            h_canopy->append(result.h_canopy);
-            canopy_openness->append(result.canopy_openness);
-            canopy_h_metrics->append(result.canopy_h_metrics);
-
-            const uint32_t center_ph = i0 + (num_photons / 2);
-            photon_start->append(df.ph_index[i0]);
-            photon_count->append(static_cast<uint32_t>(num_photons));
-            landcover->append(df.landcover[center_ph]);
-            snowcover->append(df.snowcover[center_ph]);
-            solar_elevation->append(df.solar_elevation[center_ph]);
-
-            GeoDataFrame::populateAncillaryColumns(ancillary_columns, df, i0, num_photons);
+            extents.push_back({i0, num_photons, _pflags});
         }
 
         // find start of next extent
@@ -225,42 +290,22 @@ bool PhoReal::run (GeoDataFrame* dataframe)
             break;
         }
     }
+}
 
-    // clear all columns from original dataframe
-    dataframe->clear(); // frees memory
-
-    // install new columns into dataframe
-    dataframe->addExistingColumn("time_ns",                 time_ns,                    "Unix time (nanoseconds)");
-    dataframe->addExistingColumn("latitude",                latitude,                   "Latitude (EPSG:9989)");
-    dataframe->addExistingColumn("longitude",               longitude,                  "Longitude (EPSG:9989)");
-    dataframe->addExistingColumn("segment_id_beg",          segment_id_beg,             "First segment used in extent to calculate vegetation metrics");
-    dataframe->addExistingColumn("x_atc",                   x_atc,                      "Distance from the equator (in meters)");
-    dataframe->addExistingColumn("y_atc",                   y_atc,                      "distance from reference track (in meters)");
-    dataframe->addExistingColumn("photon_start",            photon_start,               "photon index of start of extent");
-    dataframe->addExistingColumn("photon_count",            photon_count,               "number of photons used in final elevation calculation");
-    dataframe->addExistingColumn("pflags",                  pflags,                     "processing flags");
-    dataframe->addExistingColumn("ground_photon_count",     ground_photon_count,        "number of photons labeled as ground in extent");
-    dataframe->addExistingColumn("vegetation_photon_count", vegetation_photon_count,    "number of photons labeled as canopy or top of canopy in extent");
-    dataframe->addExistingColumn("landcover",               landcover,                  "atl08 land_segments/segments_landcover");
-    dataframe->addExistingColumn("snowcover",               snowcover,                  "atl08 land_segments/segments_snowcover");
-    dataframe->addExistingColumn("solar_elevation",         solar_elevation,            "atl03 solar elevation");
-    dataframe->addExistingColumn("h_te_median",             h_te_median,                "median terrain height for ground photons");
-    dataframe->addExistingColumn("h_max_canopy",            h_max_canopy,               "maximum relief height for canopy photons");
-    dataframe->addExistingColumn("h_min_canopy",            h_min_canopy,               "minimum relief height for canopy photons");
-    dataframe->addExistingColumn("h_mean_canopy",           h_mean_canopy,              "average relief height for canopy photons");
-    dataframe->addExistingColumn("h_canopy",                h_canopy,                   "98th percentile relief height for canopy photons");
-    dataframe->addExistingColumn("canopy_openness",         canopy_openness,            "standard deviation of relief height for canopy photons");
-    dataframe->addExistingColumn("canopy_h_metrics",        canopy_h_metrics,           "relief height at given percentile for canopy photons");
-
-    // install ancillary columns into dataframe
-    GeoDataFrame::addAncillaryColumns (ancillary_columns, dataframe);
-    delete ancillary_columns;
-
-    // finalize dataframe
-    dataframe->populateGeoColumns();
-
-    // return success
-    return true;
+/*----------------------------------------------------------------------------
+ * processExtents - geolocates and runs the algorithm on a range of extents;
+ *                  extents are independent so ranges run concurrently
+ *----------------------------------------------------------------------------*/
+void PhoReal::processExtents (void* context, long start, long count)
+{
+    const extent_context_t* ctx = static_cast<const extent_context_t*>(context);
+    for(long e = start; e < start + count; e++)
+    {
+        const extent_t& extent = (*ctx->extents)[e];
+        result_t& result = (*ctx->results)[e];
+        ctx->phoreal->geolocate(*ctx->df, extent.start_photon, extent.num_photons, result);
+        ctx->phoreal->algorithm(*ctx->df, extent.start_photon, extent.num_photons, result);
+    }
 }
 
 /*----------------------------------------------------------------------------
@@ -53,6 +53,7 @@ class PhoReal: public GeoDataFrame::FrameRunner
 
         static const int NUM_PERCENTILES = 20;
         static const int MAX_BINS = 1000;
+        static const long EXTENT_GRAIN = 16; // extents processed per pool task
 
         static const double PercentileInterval[NUM_PERCENTILES];
 
@@ -90,6 +91,19 @@ class PhoReal: public GeoDataFrame::FrameRunner
             FieldArray<float,NUM_PERCENTILES> canopy_h_metrics;
         };
 
+        typedef struct {
+            int32_t     start_photon;
+            int32_t     num_photons;
+            uint32_t    pflags;             // extent level processing flags
+        } extent_t;
+
+        typedef struct {
+            PhoReal*                phoreal;
+            const Atl03DataFrame*   df;
+            const vector<extent_t>* extents;
+            vector<result_t>*       results;
+        } extent_context_t;
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
@@ -97,6 +111,8 @@ class PhoReal: public GeoDataFrame::FrameRunner
                         PhoReal             (lua_State* L, Atl03Parameters* _parms);
                         ~PhoReal            (void) override;
 
+        void            findExtents         (const Atl03DataFrame& df, vector<extent_t>& extents) const;
+        static void     processExtents      (void* context, long start, long count);
         void            geolocate           (const Atl03DataFrame& df, uint32_t start_photon, uint32_t num_photons, result_t& result);
         void            algorithm           (const Atl03DataFrame& df, uint32_t start_photon, uint32_t num_photons, result_t& result);
         static void     quicksort           (uint32_t* index_array, const FieldColumn<float>& column, int start, int end);
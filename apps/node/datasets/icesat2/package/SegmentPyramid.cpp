@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <errno.h>
+#include <sys/stat.h>
+#include <cstdio>
+
+#include "OsApi.h"
+#include "StringLib.h"
+#include "H5Array.h"
+#include "SegmentPyramid.h"
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* SegmentPyramid::FILE_EXTENSION = "pyr";
+const char* SegmentPyramid::cacheRoot = NULL;
+Mutex SegmentPyramid::cacheMut;
+std::atomic<long> SegmentPyramid::tmpIndex{0};
+
+/******************************************************************************
+ * SEGMENT PYRAMID CLASS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * init
+ *----------------------------------------------------------------------------*/
+void SegmentPyramid::init (void)
+{
+    cacheRoot = NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * deinit
+ *----------------------------------------------------------------------------*/
+void SegmentPyramid::deinit (void)
+{
+    cacheMut.lock();
+    {
+        delete [] cacheRoot;
+        cacheRoot = NULL;
+    }
+    cacheMut.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * luaCreateCache - pyramidcache(<root>)
+ *----------------------------------------------------------------------------*/
+int SegmentPyramid::luaCreateCache (lua_State* L)
+{
+    try
+    {
+        /* Get Parameters */
+        const char* cache_root = LuaObject::getLuaString(L, 1);
+
+        /* Create Cache Directory (if it doesn't exist) */
+        const int ret = mkdir(cache_root, 0700);
+        if(ret == -1 && errno != EEXIST)
+        {
+            char err_buf[256];
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "Failed to create pyramid cache directory %s: %s", cache_root, strerror_r(errno, err_buf, sizeof(err_buf)));
+        }
+
+        /* Set Cache Root */
+        cacheMut.lock();
+        {
+            delete [] cacheRoot;
+            cacheRoot = StringLib::duplicate(cache_root);
+        }
+        cacheMut.unlock();
+
+        lua_pushboolean(L, true);
+        return 1;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating pyramid cache: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *
+ *  prefix is the beam group of the granule, e.g. /gt1l
+ *----------------------------------------------------------------------------*/
+SegmentPyramid::SegmentPyramid (H5Coro::Context* context, const char* asset_name, const char* resource, const char* prefix, int read_timeout_ms):
+    cached(false)
+{
+    /* Build Sidecar Filename */
+    string filename;
+    cacheMut.lock();
+    {
+        if(cacheRoot)
+        {
+            filename = FString("%s%c%s.%s.%s.v%u.%s", cacheRoot, PATH_DELIMETER, asset_name, resource,
+                               prefix[0] == '/' ? &prefix[1] : prefix, FILE_VERSION, FILE_EXTENSION).c_str();
+        }
+    }
+    cacheMut.unlock();
+
+    /* Serve From Sidecar */
+    if(!filename.empty() && readSidecar(filename.c_str(), levels))
+    {
+        cached = true;
+        return;
+    }
+
+    /* Read Segment Rate Datasets */
+    H5Array<double>  segment_lat        (context, FString("%s/%s", prefix, "geolocation/reference_photon_lat").c_str());
+    H5Array<double>  segment_lon        (context, FString("%s/%s", prefix, "geolocation/reference_photon_lon").c_str());
+    H5Array<int32_t> segment_ph_cnt     (context, FString("%s/%s", prefix, "geolocation/segment_ph_cnt").c_str());
+    H5Array<double>  segment_delta_time (context, FString("%s/%s", prefix, "geolocation/delta_time").c_str());
+    H5Array<int32_t> segment_id         (context, FString("%s/%s", prefix, "geolocation/segment_id").c_str());
+    H5Array<double>  segment_dist_x     (context, FString("%s/%s", prefix, "geolocation/segment_dist_x").c_str());
+    segment_lat.join(read_timeout_ms, true);
+    segment_lon.join(read_timeout_ms, true);
+    segment_ph_cnt.join(read_timeout_ms, true);
+    segment_delta_time.join(read_timeout_ms, true);
+    segment_id.join(read_timeout_ms, true);
+    segment_dist_x.join(read_timeout_ms, true);
+
+    /* Check Sizes */
+    const long num_segments = segment_ph_cnt.size;
+    if(segment_lat.size != num_segments || segment_lon.size != num_segments || segment_delta_time.size != num_segments ||
+       segment_id.size != num_segments || segment_dist_x.size != num_segments)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "mismatched segment datasets in %s%s", resource, prefix);
+    }
+
+    /* Build Pyramid */
+    summarize(segment_lat.data, segment_lon.data, segment_ph_cnt.data, segment_delta_time.data,
+              segment_id.data, segment_dist_x.data, num_segments, levels);
+
+    /* Write Sidecar */
+    if(!filename.empty())
+    {
+        try
+        {
+            writeSidecar(filename.c_str(), levels);
+        }
+        catch(const RunTimeException& e)
+        {
+            mlog(e.level(), "Failed to cache segment pyramid: %s", e.what());
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * level - bins of level 1 to NUM_LEVELS
+ *----------------------------------------------------------------------------*/
+const SegmentPyramid::bin_t* SegmentPyramid::level (int lvl, long* num_bins) const
+{
+    if(lvl < 1 || lvl > NUM_LEVELS)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid pyramid level: %d", lvl);
+    }
+
+    const std::vector<bin_t>& bins = levels[lvl - 1];
+    *num_bins = static_cast<long>(bins.size());
+    return bins.data();
+}
+
+/*----------------------------------------------------------------------------
+ * fromCache
+ *----------------------------------------------------------------------------*/
+bool SegmentPyramid::fromCache (void) const
+{
+    return cached;
+}
+
+/*----------------------------------------------------------------------------
+ * summarize
+ *----------------------------------------------------------------------------*/
+void SegmentPyramid::summarize (const double* lat, const double* lon, const int32_t* ph_cnt, const double* delta_time,
+                                const int32_t* segment_id, const double* dist_x, long num_segments,
+                                std::vector<bin_t>* levels)
+{
+    /* Treat Each Segment as a Bin */
+    std::vector<bin_t> segments(num_segments);
+    for(long s = 0; s < num_segments; s++)
+    {
+        const bool valid = (ph_cnt[s] >= 0 && ph_cnt[s] <= MAX_PH_CNT);
+        bin_t& bin = segments[s];
+        bin.delta_time = delta_time[s];
+        bin.dist_x = dist_x[s];
+        bin.latitude = lat[s];
+        bin.longitude = lon[s];
+        bin.segment_id = segment_id[s];
+        bin.ph_cnt = valid ? static_cast<uint32_t>(ph_cnt[s]) : 0;
+        bin.segments = 1;
+        bin.populated = (valid && ph_cnt[s] > 0) ? 1 : 0;
+        bin.invalid = valid ? 0 : 1;
+        bin.spare = 0;
+    }
+
+    /* Combine Each Level From the One Below */
+    combine(segments, levels[0]);
+    for(int lvl = 1; lvl < NUM_LEVELS; lvl++)
+    {
+        combine(levels[lvl - 1], levels[lvl]);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * combine
+ *
+ *  the location of a bin is taken from its middle populated bin rather than
+ *  averaged, so that it always lies on the ground track (segments without
+ *  photons can carry invalid coordinates, and averaging longitudes breaks
+ *  across the antimeridian)
+ *----------------------------------------------------------------------------*/
+void SegmentPyramid::combine (const std::vector<bin_t>& below, std::vector<bin_t>& above)
+{
+    const long num_below = static_cast<long>(below.size());
+    above.clear();
+    above.reserve((num_below + LEVEL_FANOUT - 1) / LEVEL_FANOUT);
+
+    for(long first = 0; first < num_below; first += LEVEL_FANOUT)
+    {
+        const long last = MIN(first + LEVEL_FANOUT, num_below);
+
+        /* Start From First Bin */
+        bin_t bin = below[first];
+        bin.ph_cnt = 0;
+        bin.segments = 0;
+        bin.populated = 0;
+        bin.invalid = 0;
+
+        /* Accumulate Counts */
+        long populated_bins = 0;
+        for(long b = first; b < last; b++)
+        {
+            bin.ph_cnt += below[b].ph_cnt;
+            bin.segments += below[b].segments;
+            bin.populated += below[b].populated;
+            bin.invalid += below[b].invalid;
+            if(below[b].populated > 0) populated_bins++;
+        }
+
+        /* Locate at Middle Populated Bin */
+        long target = populated_bins / 2;
+        for(long b = first; b < last; b++)
+        {
+            if(below[b].populated > 0 && target-- == 0)
+            {
+                bin.latitude = below[b].latitude;
+                bin.longitude = below[b].longitude;
+                break;
+            }
+        }
+
+        above.push_back(bin);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * readSidecar
+ *
+ *  the bin counts in the header must account for the exact size of the file
+ *  before anything is allocated for them
+ *----------------------------------------------------------------------------*/
+bool SegmentPyramid::readSidecar (const char* filename, std::vector<bin_t>* levels)
+{
+    FILE* fp = fopen(filename, "rb");
+    if(fp == NULL) return false;
+
+    /* Read and Check Header */
+    header_t header;
+    struct stat st;
+    bool status = (fstat(fileno(fp), &st) == 0) &&
+                  (fread(&header, sizeof(header), 1, fp) == 1) &&
+                  (header.magic == FILE_MAGIC) &&
+                  (header.version == FILE_VERSION) &&
+                  (header.fanout == LEVEL_FANOUT) &&
+                  (header.levels == NUM_LEVELS) &&
+                  (header.binsize == sizeof(bin_t));
+
+    /* Check Counts Against File Size */
+    const int64_t max_bins = status ? static_cast<int64_t>((st.st_size - sizeof(header)) / sizeof(bin_t)) : 0;
+    int64_t total_bins = 0;
+    for(int lvl = 0; status && lvl < NUM_LEVELS; lvl++)
+    {
+        const int64_t expected = (lvl == 0) ? header.counts[0] : (header.counts[lvl - 1] + LEVEL_FANOUT - 1) / LEVEL_FANOUT;
+        status = (header.counts[lvl] >= 0) && (header.counts[lvl] <= max_bins) && (header.counts[lvl] == expected);
+        total_bins += header.counts[lvl];
+    }
+    status = status && (static_cast<int64_t>(sizeof(header)) + (total_bins * static_cast<int64_t>(sizeof(bin_t))) == st.st_size);
+
+    /* Read Levels */
+    for(int lvl = 0; status && lvl < NUM_LEVELS; lvl++)
+    {
+        levels[lvl].resize(header.counts[lvl]);
+        status = (fread(levels[lvl].data(), sizeof(bin_t), levels[lvl].size(), fp) == levels[lvl].size());
+    }
+    fclose(fp);
+
+    if(!status)
+    {
+        mlog(WARNING, "Ignoring invalid segment pyramid %s", filename);
+        for(int lvl = 0; lvl < NUM_LEVELS; lvl++) levels[lvl].clear();
+    }
+
+    return status;
+}
+
+/*----------------------------------------------------------------------------
+ * writeSidecar
+ *
+ *  written to a temporary file and renamed into place so that concurrent
+ *  requests for the same granule never read a partial sidecar
+ *----------------------------------------------------------------------------*/
+void SegmentPyramid::writeSidecar (const char* filename, const std::vector<bin_t>* levels)
+{
+    /* Build Header */
+    header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.fanout = LEVEL_FANOUT;
+    header.levels = NUM_LEVELS;
+    header.binsize = sizeof(bin_t);
+    for(int lvl = 0; lvl < NUM_LEVELS; lvl++)
+    {
+        header.counts[lvl] = static_cast<int64_t>(levels[lvl].size());
+    }
+
+    /* Write Temporary File */
+    const FString tmp_filename("%s.%ld.tmp", filename, tmpIndex++);
+    FILE* fp = fopen(tmp_filename.c_str(), "wb");
+    if(fp == NULL)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to open %s for writing", tmp_filename.c_str());
+    }
+    bool status = (fwrite(&header, sizeof(header), 1, fp) == 1);
+    for(int lvl = 0; status && lvl < NUM_LEVELS; lvl++)
+    {
+        status = (fwrite(levels[lvl].data(), sizeof(bin_t), levels[lvl].size(), fp) == levels[lvl].size());
+    }
+    status = (fclose(fp) == 0) && status;
+
+    /* Move Into Place */
+    if(!status || std::rename(tmp_filename.c_str(), filename) != 0)
+    {
+        std::remove(tmp_filename.c_str());
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to write %s", filename);
+    }
+}
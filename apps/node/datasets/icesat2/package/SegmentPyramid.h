@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __segment_pyramid__
+#define __segment_pyramid__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <atomic>
+#include <vector>
+
+#include "OsApi.h"
+#include "LuaEngine.h"
+#include "H5CoroLib.h"
+
+/******************************************************************************
+ * SEGMENT PYRAMID
+ ******************************************************************************/
+/*
+ * SegmentPyramid - multi-resolution summary of the segment rate data of one
+ *  ATL03 beam, as used by the viewers
+ *
+ *  Level 1 combines every LEVEL_FANOUT segments into a bin and each further
+ *  level combines LEVEL_FANOUT bins of the level below.  Level 0 is the
+ *  granule itself and is never summarized.  When a cache directory has been
+ *  set the pyramid is written there as a sidecar file the first time a beam
+ *  is summarized and read back on every later request for that beam; the
+ *  sidecar is keyed by asset, resource, beam, and file version.
+ */
+class SegmentPyramid
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int NUM_LEVELS = 4;
+        static const int LEVEL_FANOUT = 8;
+        static const int32_t MAX_PH_CNT = 100000; // segment photon counts above this are invalid
+
+        static const uint64_t FILE_MAGIC = 0x31445259504753; // "SGPYRD1"
+        static const uint32_t FILE_VERSION = 1;
+        static const char* FILE_EXTENSION;
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        typedef struct {
+            double          delta_time;     // of the first segment in the bin
+            double          dist_x;         // of the first segment in the bin
+            double          latitude;       // of the middle segment with photons
+            double          longitude;      // of the middle segment with photons
+            int32_t         segment_id;     // of the first segment in the bin
+            uint32_t        ph_cnt;         // total photons in valid segments
+            uint32_t        segments;       // segments in the bin
+            uint32_t        populated;      // segments with photons
+            uint32_t        invalid;        // segments with an out of range photon count
+            uint32_t        spare;
+        } bin_t;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static void         init            (void);
+        static void         deinit          (void);
+        static int          luaCreateCache  (lua_State* L);
+
+                            SegmentPyramid  (H5Coro::Context* context, const char* asset_name, const char* resource, const char* prefix, int read_timeout_ms);
+                            ~SegmentPyramid (void) = default;
+
+        const bin_t*        level           (int lvl, long* num_bins) const;
+        bool                fromCache       (void) const;
+
+        static void         summarize       (const double* lat, const double* lon, const int32_t* ph_cnt, const double* delta_time,
+                                             const int32_t* segment_id, const double* dist_x, long num_segments,
+                                             std::vector<bin_t>* levels);
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        typedef struct {
+            uint64_t        magic;          // FILE_MAGIC
+            uint32_t        version;        // FILE_VERSION
+            uint32_t        fanout;         // LEVEL_FANOUT
+            uint32_t        levels;         // NUM_LEVELS
+            uint32_t        binsize;        // sizeof(bin_t)
+            int64_t         counts[NUM_LEVELS];
+        } header_t;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static void         combine         (const std::vector<bin_t>& below, std::vector<bin_t>& above);
+        static bool         readSidecar     (const char* filename, std::vector<bin_t>* levels);
+        static void         writeSidecar    (const char* filename, const std::vector<bin_t>* levels);
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        static const char*          cacheRoot;
+        static Mutex                cacheMut;
+        static std::atomic<long>    tmpIndex;
+
+        std::vector<bin_t>          levels[NUM_LEVELS];
+        bool                        cached;
+
+        /*--------------------------------------------------------------------
+         * Friends
+         *--------------------------------------------------------------------*/
+
+        friend class UT_SegmentPyramid; // necessary for exercising the sidecar
+};
+
+#endif  /* __segment_pyramid__ */
@@ -105,6 +105,19 @@ bool SurfaceFitter::run (GeoDataFrame* dataframe)
 {
     Atl03DataFrame& df = *dynamic_cast<Atl03DataFrame*>(dataframe);
 
+    // find extents to fit
+    vector<extent_t> extents;
+    findExtents(df, extents);
+
+    // fit extents across the frame runner pool
+    vector<result_t> results(extents.size());
+    fit_context_t context = {this, &df, &extents, &results};
+    if(!parms->runnerPool.run(fitExtents, &context, extents.size(), EXTENT_GRAIN))
+    {
+        mlog(CRITICAL, "Failed to fit extents");
+        return false;
+    }
+
     // create new dataframe columns
     FieldColumn<time8_t>*   time_ns         = new FieldColumn<time8_t>(Field::TIME_COLUMN);
     FieldColumn<double>*    latitude        = new FieldColumn<double>(Field::Y_COLUMN);
@@ -129,6 +142,75 @@ bool SurfaceFitter::run (GeoDataFrame* dataframe)
     GeoDataFrame::createAncillaryColumns(&ancillary_columns, parms->atl03PhFields);
     GeoDataFrame::createAncillaryColumns(&ancillary_columns, parms->atl08Fields);
 
+    // for each extent
+    for(size_t e = 0; e < extents.size(); e++)
+    {
+        const extent_t& extent = extents[e];
+        const result_t& result = results[e];
+        const int32_t i0 = extent.start_photon;
+
+        // build dataframe columns
+        if(result.pflags == 0 || parms->passInvalid)
+        {
+            // populate surface fit columns
+            time_ns->append(static_cast<time8_t>(result.time_ns));
+            latitude->append(result.latitude);
+            longitude->append(result.longitude);
+            segment_id_beg->append(df.segment_id[i0]);
+            x_atc->append(extent.center);
+            y_atc->append(result.y_atc);
+            photon_start->append(df.ph_index[i0]);
+            pflags->append(result.pflags | extent.pflags);
+            h_mean->append(static_cast<float>(result.h_mean));
+            dh_fit_dx->append(result.dh_fit_dx);
+            window_height->append(result.window_height);
+            n_fit_photons->append(static_cast<uint32_t>(result.n_fit_photons));
+            rms_misfit->append(result.rms_misfit);
+            h_sigma->append(result.h_sigma);
+
+            // populate ancillary columns
+            GeoDataFrame::populateAncillaryColumns(ancillary_columns, df, i0, extent.num_photons);
+        }
+    }
+
+    // clear all columns from original dataframe
+    dataframe->clear(); // frees memory
+
+    // install new columns into dataframe
+    dataframe->addExistingColumn("time_ns",                 time_ns,            "Unix time (nanoseconds)");
+    dataframe->addExistingColumn("latitude",                latitude,           "Latitude (EPSG:9989)");
+    dataframe->addExistingColumn("longitude",               longitude,          "Longitude (EPSG:9989)");
+    dataframe->addExistingColumn("segment_id_beg",          segment_id_beg,     "First segment used in extent to calculate surface fit");
+    dataframe->addExistingColumn("x_atc",                   x_atc,              "Distance from the equator (in meters)");
+    dataframe->addExistingColumn("y_atc",                   y_atc,              "Distance from reference track (in meters)");
+    dataframe->addExistingColumn("photon_start",            photon_start,       "Photon index of start of extent");
+    dataframe->addExistingColumn("pflags",                  pflags,             "Processing flags");
+    dataframe->addExistingColumn("h_mean",                  h_mean,             "Mean elevation of segment (in meters); from ellipsoid");
+    dataframe->addExistingColumn("dh_fit_dx",               dh_fit_dx,          "Along track slope");
+    dataframe->addExistingColumn("w_surface_window_final",  window_height,      "Height (in meters) of final window used in fit");
+    dataframe->addExistingColumn("n_fit_photons",           n_fit_photons,      "Number of photons used in final elevation calculation");
+    dataframe->addExistingColumn("rms_misfit",              rms_misfit,         "RMS of the differences between the fitted line and actual photons");
+    dataframe->addExistingColumn("h_sigma",                 h_sigma,            "Uncertainty of the estimated mean height");
+
+    // install ancillary columns into dataframe
+    GeoDataFrame::addAncillaryColumns (ancillary_columns, dataframe);
+    delete ancillary_columns;
+
+    // finalize dataframe
+    dataframe->populateGeoColumns();
+
+    // update runtime
+    return true;
+}
+
+/*----------------------------------------------------------------------------
+ * findExtents
+ *
+ *  steps through the photons in extent step increments and records each
+ *  extent that is to be fit
+ *----------------------------------------------------------------------------*/
+void SurfaceFitter::findExtents (const Atl03DataFrame& df, vector<extent_t>& extents) const
+{
     // initialize
     double start_distance = 0;
     if(df.length() > 0)
@@ -165,36 +247,11 @@ bool SurfaceFitter::run (GeoDataFrame* dataframe)
             _pflags |= Icesat2Parameters::PFLAG_TOO_FEW_PHOTONS;
         }
 
-        // add result row to surface fitter dataframe
+        // add extent to be fit
         if(_pflags == 0 || parms->passInvalid)
         {
             const double center_of_extent = start_distance + (parms->extentLength.value / 2.0);
-
-            // run least squares fit
-            const result_t result = iterativeFitStage(df, i0, num_photons, center_of_extent);
-
-            // build dataframe columns
-            if(result.pflags == 0 || parms->passInvalid)
-            {
-                // populate surface fit columns
-                time_ns->append(static_cast<time8_t>(result.time_ns));
-                latitude->append(result.latitude);
-                longitude->append(result.longitude);
-                segment_id_beg->append(df.segment_id[i0]);
-                x_atc->append(center_of_extent);
-                y_atc->append(result.y_atc);
-                photon_start->append(df.ph_index[i0]);
-                pflags->append(result.pflags | _pflags);
-                h_mean->append(static_cast<float>(result.h_mean));
-                dh_fit_dx->append(result.dh_fit_dx);
-                window_height->append(result.window_height);
-                n_fit_photons->append(static_cast<uint32_t>(result.n_fit_photons));
-                rms_misfit->append(result.rms_misfit);
-                h_sigma->append(result.h_sigma);
-
-                // populate ancillary columns
-                GeoDataFrame::populateAncillaryColumns(ancillary_columns, df, i0, num_photons);
-            }
+            extents.push_back({i0, num_photons, center_of_extent, _pflags});
         }
 
         while(i0 < df.length())
@@ -215,35 +272,20 @@ bool SurfaceFitter::run (GeoDataFrame* dataframe)
             }
         }
     }
+}
 
-    // clear all columns from original dataframe
-    dataframe->clear(); // frees memory
-
-    // install new columns into dataframe
-    dataframe->addExistingColumn("time_ns",                 time_ns,            "Unix time (nanoseconds)");
-    dataframe->addExistingColumn("latitude",                latitude,           "Latitude (EPSG:9989)");
-    dataframe->addExistingColumn("longitude",               longitude,          "Longitude (EPSG:9989)");
-    dataframe->addExistingColumn("segment_id_beg",          segment_id_beg,     "First segment used in extent to calculate surface fit");
-    dataframe->addExistingColumn("x_atc",                   x_atc,              "Distance from the equator (in meters)");
-    dataframe->addExistingColumn("y_atc",                   y_atc,              "Distance from reference track (in meters)");
-    dataframe->addExistingColumn("photon_start",            photon_start,       "Photon index of start of extent");
-    dataframe->addExistingColumn("pflags",                  pflags,             "Processing flags");
-    dataframe->addExistingColumn("h_mean",                  h_mean,             "Mean elevation of segment (in meters); from ellipsoid");
-    dataframe->addExistingColumn("dh_fit_dx",               dh_fit_dx,          "Along track slope");
-    dataframe->addExistingColumn("w_surface_window_final",  window_height,      "Height (in meters) of final window used in fit");
-    dataframe->addExistingColumn("n_fit_photons",           n_fit_photons,      "Number of photons used in final elevation calculation");
-    dataframe->addExistingColumn("rms_misfit",              rms_misfit,         "RMS of the differences between the fitted line and actual photons");
-    dataframe->addExistingColumn("h_sigma",                 h_sigma,            "Uncertainty of the estimated mean height");
-
-    // install ancillary columns into dataframe
-    GeoDataFrame::addAncillaryColumns (ancillary_columns, dataframe);
-    delete ancillary_columns;
-
-    // finalize dataframe
-    dataframe->populateGeoColumns();
-
-    // update runtime
-    return true;
+/*----------------------------------------------------------------------------
+ * fitExtents - runs least squares fit on a range of extents; extents are
+ *              fit independently so ranges are run concurrently on the pool
+ *----------------------------------------------------------------------------*/
+void SurfaceFitter::fitExtents (void* context, long start, long count)
+{
+    const fit_context_t* fit = static_cast<const fit_context_t*>(context);
+    for(long e = start; e < start + count; e++)
+    {
+        const extent_t& extent = (*fit->extents)[e];
+        (*fit->results)[e] = fit->fitter->iterativeFitStage(*fit->df, extent.start_photon, extent.num_photons, extent.center);
+    }
 }
 
 /*----------------------------------------------------------------------------
@@ -70,6 +70,7 @@ class SurfaceFitter: public GeoDataFrame::FrameRunner
          static const double RDE_SCALE_FACTOR;
          static const double SIGMA_BEAM;
          static const double SIGMA_XMIT;
+         static const long EXTENT_GRAIN = 32; // extents fit per pool task
 
          /*--------------------------------------------------------------------
          * Typedefs
@@ -95,6 +96,20 @@ class SurfaceFitter: public GeoDataFrame::FrameRunner
             double      window_height = 0;
         };
 
+        typedef struct {
+            int32_t     start_photon;
+            int32_t     num_photons;
+            double      center;             // x_atc of center of extent
+            uint32_t    pflags;             // extent level processing flags
+        } extent_t;
+
+        typedef struct {
+            SurfaceFitter*          fitter;
+            const Atl03DataFrame*   df;
+            const vector<extent_t>* extents;
+            vector<result_t>*       results;
+        } fit_context_t;
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
@@ -102,6 +117,8 @@ class SurfaceFitter: public GeoDataFrame::FrameRunner
         SurfaceFitter  (lua_State* L, Atl03Parameters* _parms);
         ~SurfaceFitter (void) override;
 
+        void            findExtents             (const Atl03DataFrame& df, vector<extent_t>& extents) const;
+        static void     fitExtents              (void* context, long start, long count);
         result_t        iterativeFitStage       (const Atl03DataFrame& df, int32_t start_photon, int32_t num_photon, double center_of_extent);
         static void     leastSquaresFit         (const Atl03DataFrame& df, point_t* array, int32_t size, bool final, result_t& result);
         static void     quicksort               (point_t* array, int32_t start, int32_t end);
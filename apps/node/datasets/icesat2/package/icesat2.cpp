@@ -64,10 +64,13 @@
 #include "CumulusIODriver.h"
 #include "MeritRaster.h"
 #include "PhoReal.h"
+#include "SegmentPyramid.h"
 #include "SurfaceBlanket.h"
 #include "SurfaceFitter.h"
 #ifdef __unittesting__
 #include "UT_Atl06Dispatch.h"
+#include "UT_Atl03DataFrame.h"
+#include "UT_SegmentPyramid.h"
 #endif
 
 /******************************************************************************
@@ -114,8 +117,11 @@ int icesat2_open (lua_State *L)
         // misc
         {"atl03granule",        Atl03Granule::luaCreate},
         {"atl24granule",        Atl24Granule::luaCreate},
+        {"pyramidcache",        SegmentPyramid::luaCreateCache},
 #ifdef __unittesting__
         {"ut_atl06",            UT_Atl06Dispatch::luaCreate},
+        {"ut_atl03",            UT_Atl03DataFrame::luaCreate},
+        {"ut_pyramid",          UT_SegmentPyramid::luaCreate},
 #endif
         {NULL,                  NULL}
     };
@@ -177,6 +183,7 @@ void initicesat2 (void)
     Atl06Reader::init();
     Atl08Dispatch::init();
     Atl13Reader::init();
+    SegmentPyramid::init();
 
     /* Register IO Drivers */
     Asset::registerDriver(CumulusIODriver::FORMAT, CumulusIODriver::create);
@@ -195,5 +202,6 @@ void initicesat2 (void)
 
 void deiniticesat2 (void)
 {
+    SegmentPyramid::deinit();
 }
 }
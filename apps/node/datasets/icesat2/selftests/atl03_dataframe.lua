@@ -70,6 +70,44 @@ end)
 
 -- Self Test --
 
+runner.unittest("ATL03 DataFrame - Late Read", function()
+
+    local parms = icesat2.parms03({
+        srt = 3,
+        cnf = 4,
+        late_read = true,
+        resource = "ATL03_20200304065203_10470605_006_01.h5"
+    }, nil, "icesat2")
+
+    local atl03h5 = h5coro.object(asset_name, parms["resource"])
+    local atl03df = icesat2.atl03x("gt1l", parms, atl03h5, nil, nil, core.EVENTQ)
+
+    runner.assert(atl03df:waiton(30000), "timed out creating dataframe", true)
+    runner.assert(atl03df:inerror() == false, "dataframe encountered error")
+
+    -- same photons and values as reading the whole area of interest
+    runner.assert(atl03df:numrows() == 5912939, string.format("incorrect number of rows: %d", atl03df:numrows()))
+    runner.assert(atl03df:numcols() == 13, string.format("incorrect number of columns: %d", atl03df:numcols()))
+
+    check_expected({
+        time_ns = 1583304724130344448,
+        latitude = 79.993572,
+        longitude = -40.942408,
+        x_atc = 11132842.088085,
+        y_atc = 3271.814941,
+        height = 2178.863281,
+        solar_elevation = -11.243111,
+        background_rate = 32401.623047,
+        spacecraft_velocity = 7096.781738,
+        atl03_cnf = 4,
+        quality_ph = 0,
+        ph_index = 112
+    }, atl03df, 100, 0.00001)
+
+end)
+
+-- Self Test --
+
 runner.unittest("ATL03 DataFrame - Ancillary Data", function()
 
     local parms = icesat2.parms03({
@@ -34,6 +34,25 @@ runner.unittest("ATL03 Viewer Extent Record", function()
     f1:destroy()
 end)
 
+runner.unittest("ATL03 Viewer Pyramid Level", function()
+    runner.assert(icesat2.pyramidcache("/tmp/pyramid_cache"))
+    local parms = {resource="ATL03_20200304065203_10470605_007_01.h5", track=icesat2.RPT_1, view_level=2}
+    for _, source in ipairs({"granule", "cache"}) do
+        local recq = msg.subscribe("atl03-reader-recq")
+        local tstart = time.latch()
+        local f1 = icesat2.atl03v("atl03-reader-recq", icesat2.parms03(parms, nil, "icesat2"))
+        local extentrec = recq:recvrecord(15000)
+        print(string.format("Time to execute from %s: %f", source, time.latch() - tstart))
+        runner.assert(extentrec, "Failed to read an extent record")
+        if extentrec then
+            runner.assert(extentrec:getvalue("track") == 1, extentrec:getvalue("track"))
+            runner.assert(extentrec:getvalue("segments[0].segment_ph_cnt") > 0)
+        end
+        recq:destroy()
+        f1:destroy()
+    end
+end)
+
 runner.unittest("ATL03 Viewer Extent Definition", function()
     local def = msg.definition("atl03vrec")
     print("atl03vrec", json.encode(def))
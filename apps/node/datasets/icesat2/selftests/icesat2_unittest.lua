@@ -9,6 +9,8 @@ end
 -- Setup --
 
 local atl06_dispatch = icesat2.ut_atl06()
+local atl03_dataframe = icesat2.ut_atl03()
+local segment_pyramid = icesat2.ut_pyramid()
 
 -- Self Test --
 
@@ -20,6 +22,22 @@ runner.unittest("ATL06 Dispatch Sort Unit Test", function()
     runner.assert(atl06_dispatch:sorttest(), "Failed sorttest")
 end)
 
+runner.unittest("ATL03 DataFrame Late Read Ranges Unit Test", function()
+    runner.assert(atl03_dataframe:rangestest(), "Failed rangestest")
+end)
+
+runner.unittest("ATL03 DataFrame Late Read Gather Unit Test", function()
+    runner.assert(atl03_dataframe:latereadtest(), "Failed latereadtest")
+end)
+
+runner.unittest("Segment Pyramid Levels Unit Test", function()
+    runner.assert(segment_pyramid:levelstest(), "Failed levelstest")
+end)
+
+runner.unittest("Segment Pyramid Sidecar Unit Test", function()
+    runner.assert(segment_pyramid:sidecartest(), "Failed sidecartest")
+end)
+
 -- Report Results --
 
 runner.report()
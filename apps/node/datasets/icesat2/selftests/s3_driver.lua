@@ -40,6 +40,16 @@ runner.unittest("S3 range read", function()
     runner.assert(response == "Shakespeare")
 end)
 
+-- Self Test --
+
+runner.unittest("S3 multipart upload", function()
+    local upload_key = string.format("%s/multipart.%s", test_path, test_file)
+    local status = aws.s3upload(test_bucket, upload_key, test_file, nil, nil, true, 5)
+    runner.assert(status == true, "failed to upload file: "..test_file)
+    local size = aws.s3probe(test_bucket, upload_key)
+    runner.assert(size == 5458199, "failed to upload entire file: "..tostring(size))
+end)
+
 -- Clean Up --
 
 os.remove(test_file)
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "EventLib.h"
+#include "UT_Atl03DataFrame.h"
+#include "Atl03DataFrame.h"
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_Atl03DataFrame::OBJECT_TYPE = "UT_Atl03DataFrame";
+const char* UT_Atl03DataFrame::LUA_META_NAME = "UT_Atl03DataFrame";
+const struct luaL_Reg UT_Atl03DataFrame::LUA_META_TABLE[] = {
+    {"rangestest",      luaRangesTest},
+    {"latereadtest",    luaLateReadTest},
+    {NULL,              NULL}
+};
+
+/******************************************************************************
+ * CLASS METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * luaCreate - :UT_Atl03DataFrame()
+ *----------------------------------------------------------------------------*/
+int UT_Atl03DataFrame::luaCreate (lua_State* L)
+{
+    try
+    {
+        return createLuaObject(L, new UT_Atl03DataFrame(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_Atl03DataFrame::UT_Atl03DataFrame (lua_State* L):
+    LuaObject(L, OBJECT_TYPE, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor  -
+ *----------------------------------------------------------------------------*/
+UT_Atl03DataFrame::~UT_Atl03DataFrame(void) = default;
+
+/*----------------------------------------------------------------------------
+ * checkRanges - properties every set of late read ranges must have
+ *----------------------------------------------------------------------------*/
+bool UT_Atl03DataFrame::checkRanges (long first_photon, long num_photons, long chunk_rows, const vector<int32_t>& photons)
+{
+    vector<H5Coro::range_t> ranges;
+    vector<int32_t> range_index;
+    vector<int32_t> offsets;
+    Atl03DataFrame::chunkRanges(first_photon, num_photons, chunk_rows, photons, ranges, range_index, offsets);
+
+    if(range_index.size() != photons.size() || offsets.size() != photons.size())
+    {
+        mlog(CRITICAL, "Mismatched number of photons: %ld, %ld != %ld", range_index.size(), offsets.size(), photons.size());
+        return false;
+    }
+
+    for(size_t r = 0; r < ranges.size(); r++)
+    {
+        /* ranges stay within the area of interest, are ordered, and never share a chunk */
+        const H5Coro::range_t& range = ranges[r];
+        if((range.r0 >= range.r1) || (range.r0 < first_photon) || (range.r1 > first_photon + num_photons) ||
+           ((range.r0 != first_photon) && (range.r0 % chunk_rows != 0)) ||
+           ((range.r1 != first_photon + num_photons) && (range.r1 % chunk_rows != 0)) ||
+           ((r > 0) && (ranges[r - 1].r1 >= range.r0)))
+        {
+            mlog(CRITICAL, "Invalid range %ld: [%ld, %ld)", r, static_cast<long>(range.r0), static_cast<long>(range.r1));
+            return false;
+        }
+    }
+
+    for(size_t i = 0; i < photons.size(); i++)
+    {
+        /* every photon is found at its row */
+        const int32_t r = range_index[i];
+        if((r < 0) || (r >= static_cast<int32_t>(ranges.size())) ||
+           (ranges[r].r0 + offsets[i] != first_photon + photons[i]) ||
+           (ranges[r].r0 + offsets[i] >= ranges[r].r1))
+        {
+            mlog(CRITICAL, "Photon %d not found in range %d at offset %d", photons[i], r, offsets[i]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*----------------------------------------------------------------------------
+ * luaRangesTest
+ *----------------------------------------------------------------------------*/
+int UT_Atl03DataFrame::luaRangesTest (lua_State* L)
+{
+    bool status = true;
+
+    /* no photons selected */
+    {
+        vector<H5Coro::range_t> ranges;
+        vector<int32_t> range_index;
+        vector<int32_t> offsets;
+        Atl03DataFrame::chunkRanges(250, 500, 100, {}, ranges, range_index, offsets);
+        if(!ranges.empty() || !range_index.empty() || !offsets.empty())
+        {
+            mlog(CRITICAL, "Ranges built for no photons: %ld", ranges.size());
+            status = false;
+        }
+    }
+
+    /* partial first and last chunks, adjacent chunks merged, gaps kept */
+    {
+        vector<H5Coro::range_t> ranges;
+        vector<int32_t> range_index;
+        vector<int32_t> offsets;
+        Atl03DataFrame::chunkRanges(250, 500, 100, {0, 49, 50, 260, 499}, ranges, range_index, offsets);
+        const H5Coro::range_t expected_ranges[3] = {{250, 400}, {500, 600}, {700, 750}};
+        const int32_t expected_index[5] = {0, 0, 0, 1, 2};
+        const int32_t expected_offsets[5] = {0, 49, 50, 10, 49};
+        if(ranges.size() != 3)
+        {
+            mlog(CRITICAL, "Mismatched number of ranges: %ld != 3", ranges.size());
+            status = false;
+        }
+        else
+        {
+            for(int r = 0; r < 3; r++)
+            {
+                if(ranges[r].r0 != expected_ranges[r].r0 || ranges[r].r1 != expected_ranges[r].r1)
+                {
+                    mlog(CRITICAL, "Mismatched range %d: [%ld, %ld)", r, static_cast<long>(ranges[r].r0), static_cast<long>(ranges[r].r1));
+                    status = false;
+                }
+            }
+            for(int i = 0; i < 5; i++)
+            {
+                if(range_index[i] != expected_index[i] || offsets[i] != expected_offsets[i])
+                {
+                    mlog(CRITICAL, "Mismatched photon %d: range %d, offset %d", i, range_index[i], offsets[i]);
+                    status = false;
+                }
+            }
+        }
+    }
+
+    /* photons on both sides of every chunk boundary */
+    {
+        vector<int32_t> photons;
+        for(int32_t p = 0; p < 1000; p++)
+        {
+            if((p % 100 == 0) || (p % 100 == 99)) photons.push_back(p);
+        }
+        status = checkRanges(0, 1000, 100, photons) && status;
+        status = checkRanges(37, 1000, 100, photons) && status;
+    }
+
+    /* area of interest within a single chunk */
+    {
+        vector<H5Coro::range_t> ranges;
+        vector<int32_t> range_index;
+        vector<int32_t> offsets;
+        Atl03DataFrame::chunkRanges(1020, 30, 10000, {5, 29}, ranges, range_index, offsets);
+        if(ranges.size() != 1 || ranges[0].r0 != 1020 || ranges[0].r1 != 1050 || offsets[0] != 5 || offsets[1] != 29)
+        {
+            mlog(CRITICAL, "Failed single chunk ranges");
+            status = false;
+        }
+    }
+
+    /* sparse and dense selections */
+    {
+        vector<int32_t> sparse;
+        vector<int32_t> dense;
+        for(int32_t p = 0; p < 100000; p += 7919) sparse.push_back(p);
+        for(int32_t p = 0; p < 100000; p++) if(p % 3) dense.push_back(p);
+        status = checkRanges(12345, 100000, 10000, sparse) && status;
+        status = checkRanges(12345, 100000, 10000, dense) && status;
+        status = checkRanges(0, 100000, 1, sparse) && status;
+    }
+
+    lua_pushboolean(L, status);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaLateReadTest
+ *----------------------------------------------------------------------------*/
+int UT_Atl03DataFrame::luaLateReadTest (lua_State* L)
+{
+    bool status = true;
+
+    /* photon variable whose value at every row of the granule is the row */
+    const long first_photon = 2500;
+    const long num_photons = 40000;
+    vector<double> aoi_rows(num_photons);
+    for(long i = 0; i < num_photons; i++) aoi_rows[i] = static_cast<double>(first_photon + i);
+
+    /* selected photons clustered in a few chunks */
+    vector<int32_t> photons;
+    for(int32_t p = 0; p < num_photons; p++)
+    {
+        if(((p / 5000) % 3 == 0) && (p % 11 == 0)) photons.push_back(p);
+    }
+
+    /* whole area of interest */
+    double* aoi_data = aoi_rows.data();
+    const Atl03DataFrame::photon_var_t<double> aoi_var = {&aoi_data, NULL, photons.data()};
+
+    /* late read ranges, each read into its own buffer */
+    vector<H5Coro::range_t> ranges;
+    vector<int32_t> range_index;
+    vector<int32_t> offsets;
+    Atl03DataFrame::chunkRanges(first_photon, num_photons, 10000, photons, ranges, range_index, offsets);
+    vector<vector<double>> range_rows(ranges.size());
+    vector<double*> range_data(ranges.size());
+    for(size_t r = 0; r < ranges.size(); r++)
+    {
+        for(int64_t row = ranges[r].r0; row < ranges[r].r1; row++) range_rows[r].push_back(static_cast<double>(row));
+        range_data[r] = range_rows[r].data();
+    }
+    const Atl03DataFrame::photon_var_t<double> late_var = {range_data.data(), range_index.data(), offsets.data()};
+
+    /* both gather the same rows */
+    for(size_t i = 0; i < photons.size(); i++)
+    {
+        const double expected = static_cast<double>(first_photon + photons[i]);
+        if(aoi_var[i] != expected || late_var[i] != expected)
+        {
+            mlog(CRITICAL, "Mismatched photon %d: %lf, %lf != %lf", photons[i], aoi_var[i], late_var[i], expected);
+            status = false;
+            break;
+        }
+    }
+
+    /* late read only reads the chunks holding selected photons */
+    long rows_read = 0;
+    for(const H5Coro::range_t& range: ranges) rows_read += range.r1 - range.r0;
+    if(rows_read >= num_photons || ranges.empty())
+    {
+        mlog(CRITICAL, "Late read did not reduce rows read: %ld of %ld", rows_read, num_photons);
+        status = false;
+    }
+
+    lua_pushboolean(L, status);
+    return 1;
+}
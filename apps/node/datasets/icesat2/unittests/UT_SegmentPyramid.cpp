@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "OsApi.h"
+#include "EventLib.h"
+#include "UT_SegmentPyramid.h"
+#include "SegmentPyramid.h"
+
+/******************************************************************************
+ * LOCAL DATA
+ ******************************************************************************/
+
+static const long NUM_SEGMENTS = 5000; // not a multiple of any level's span
+static const char* SIDECAR_FILENAME = "/tmp/ut_segment_pyramid.pyr";
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * segments - synthetic segment rate data with empty and invalid segments
+ *----------------------------------------------------------------------------*/
+typedef struct {
+    std::vector<double>     lat;
+    std::vector<double>     lon;
+    std::vector<int32_t>    ph_cnt;
+    std::vector<double>     delta_time;
+    std::vector<int32_t>    segment_id;
+    std::vector<double>     dist_x;
+} segments_t;
+
+static void populate (segments_t& s)
+{
+    for(long i = 0; i < NUM_SEGMENTS; i++)
+    {
+        const long r = (i * 7919) % 100;
+        int32_t cnt = static_cast<int32_t>((i * 31) % 250);
+        if(r < 20) cnt = 0;                                         // no photons
+        else if(r < 23) cnt = SegmentPyramid::MAX_PH_CNT + 1;       // out of range
+        else if(r < 25) cnt = -1;                                   // fill value
+        s.lat.push_back(-60.0 + (i * 0.0002));
+        s.lon.push_back(170.0 + (i * 0.0001));
+        s.ph_cnt.push_back(cnt);
+        s.delta_time.push_back(1.0e8 + (i * 0.003));
+        s.segment_id.push_back(static_cast<int32_t>(700000 + i));
+        s.dist_x.push_back(1.0e7 + (i * 20.0));
+    }
+}
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_SegmentPyramid::OBJECT_TYPE = "UT_SegmentPyramid";
+const char* UT_SegmentPyramid::LUA_META_NAME = "UT_SegmentPyramid";
+const struct luaL_Reg UT_SegmentPyramid::LUA_META_TABLE[] = {
+    {"levelstest",      luaLevelsTest},
+    {"sidecartest",     luaSidecarTest},
+    {NULL,              NULL}
+};
+
+/******************************************************************************
+ * CLASS METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * luaCreate - :UT_SegmentPyramid()
+ *----------------------------------------------------------------------------*/
+int UT_SegmentPyramid::luaCreate (lua_State* L)
+{
+    try
+    {
+        return createLuaObject(L, new UT_SegmentPyramid(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_SegmentPyramid::UT_SegmentPyramid (lua_State* L):
+    LuaObject(L, OBJECT_TYPE, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor  -
+ *----------------------------------------------------------------------------*/
+UT_SegmentPyramid::~UT_SegmentPyramid(void) = default;
+
+/*----------------------------------------------------------------------------
+ * luaLevelsTest
+ *
+ *  every bin of every level is checked against the segments it spans,
+ *  computed directly rather than from the level below
+ *----------------------------------------------------------------------------*/
+int UT_SegmentPyramid::luaLevelsTest (lua_State* L)
+{
+    bool status = true;
+
+    segments_t s;
+    populate(s);
+    std::vector<SegmentPyramid::bin_t> levels[SegmentPyramid::NUM_LEVELS];
+    SegmentPyramid::summarize(s.lat.data(), s.lon.data(), s.ph_cnt.data(), s.delta_time.data(),
+                              s.segment_id.data(), s.dist_x.data(), NUM_SEGMENTS, levels);
+
+    long span = 1;
+    for(int lvl = 0; status && lvl < SegmentPyramid::NUM_LEVELS; lvl++)
+    {
+        span *= SegmentPyramid::LEVEL_FANOUT;
+        const long num_bins = (NUM_SEGMENTS + span - 1) / span;
+        if(static_cast<long>(levels[lvl].size()) != num_bins)
+        {
+            mlog(CRITICAL, "Mismatched number of bins at level %d: %ld != %ld", lvl + 1, levels[lvl].size(), num_bins);
+            status = false;
+            break;
+        }
+
+        for(long b = 0; b < num_bins; b++)
+        {
+            const long first = b * span;
+            const long last = MIN(first + span, NUM_SEGMENTS);
+
+            /* brute force counts */
+            uint32_t ph_cnt = 0;
+            uint32_t populated = 0;
+            uint32_t invalid = 0;
+            for(long i = first; i < last; i++)
+            {
+                const bool valid = s.ph_cnt[i] >= 0 && s.ph_cnt[i] <= SegmentPyramid::MAX_PH_CNT;
+                if(valid) ph_cnt += s.ph_cnt[i];
+                if(valid && s.ph_cnt[i] > 0) populated++;
+                if(!valid) invalid++;
+            }
+
+            /* location lies on a populated segment of the bin (or its first segment if none) */
+            const SegmentPyramid::bin_t& bin = levels[lvl][b];
+            bool located = (populated == 0) && (bin.latitude == s.lat[first]) && (bin.longitude == s.lon[first]);
+            for(long i = first; !located && i < last; i++)
+            {
+                located = (s.ph_cnt[i] > 0) && (s.ph_cnt[i] <= SegmentPyramid::MAX_PH_CNT) &&
+                          (bin.latitude == s.lat[i]) && (bin.longitude == s.lon[i]);
+            }
+
+            if((bin.ph_cnt != ph_cnt) || (bin.populated != populated) || (bin.invalid != invalid) ||
+               (bin.segments != static_cast<uint32_t>(last - first)) || (bin.segment_id != s.segment_id[first]) ||
+               (bin.delta_time != s.delta_time[first]) || (bin.dist_x != s.dist_x[first]) || !located)
+            {
+                mlog(CRITICAL, "Mismatched bin %ld at level %d: ph_cnt %u != %u, populated %u != %u, invalid %u != %u, segments %u, located %d",
+                     b, lvl + 1, bin.ph_cnt, ph_cnt, bin.populated, populated, bin.invalid, invalid, bin.segments, located);
+                status = false;
+                break;
+            }
+        }
+    }
+
+    lua_pushboolean(L, status);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaSidecarTest
+ *----------------------------------------------------------------------------*/
+int UT_SegmentPyramid::luaSidecarTest (lua_State* L)
+{
+    bool status = true;
+
+    segments_t s;
+    populate(s);
+    std::vector<SegmentPyramid::bin_t> levels[SegmentPyramid::NUM_LEVELS];
+    SegmentPyramid::summarize(s.lat.data(), s.lon.data(), s.ph_cnt.data(), s.delta_time.data(),
+                              s.segment_id.data(), s.dist_x.data(), NUM_SEGMENTS, levels);
+
+    /* round trip */
+    std::vector<SegmentPyramid::bin_t> copy[SegmentPyramid::NUM_LEVELS];
+    try
+    {
+        SegmentPyramid::writeSidecar(SIDECAR_FILENAME, levels);
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(CRITICAL, "Failed to write sidecar: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+    if(!SegmentPyramid::readSidecar(SIDECAR_FILENAME, copy))
+    {
+        mlog(CRITICAL, "Failed to read sidecar");
+        status = false;
+    }
+    for(int lvl = 0; status && lvl < SegmentPyramid::NUM_LEVELS; lvl++)
+    {
+        if(copy[lvl].size() != levels[lvl].size() ||
+           memcmp(copy[lvl].data(), levels[lvl].data(), levels[lvl].size() * sizeof(SegmentPyramid::bin_t)) != 0)
+        {
+            mlog(CRITICAL, "Mismatched level %d after round trip", lvl + 1);
+            status = false;
+        }
+    }
+
+    /* read whole file back for corrupting */
+    std::vector<uint8_t> contents;
+    FILE* fp = fopen(SIDECAR_FILENAME, "rb");
+    if(fp)
+    {
+        uint8_t buffer[4096];
+        size_t n;
+        while((n = fread(buffer, 1, sizeof(buffer), fp)) > 0) contents.insert(contents.end(), buffer, buffer + n);
+        fclose(fp);
+    }
+    auto rewrite = [](const std::vector<uint8_t>& bytes, size_t size) {
+        FILE* out = fopen(SIDECAR_FILENAME, "wb");
+        if(out)
+        {
+            fwrite(bytes.data(), 1, size, out);
+            fclose(out);
+        }
+    };
+
+    /* truncated file is rejected and leaves no levels */
+    rewrite(contents, contents.size() - sizeof(SegmentPyramid::bin_t));
+    if(SegmentPyramid::readSidecar(SIDECAR_FILENAME, copy) || !copy[0].empty())
+    {
+        mlog(CRITICAL, "Accepted truncated sidecar");
+        status = false;
+    }
+
+    /* counts beyond the size of the file are rejected before allocating */
+    std::vector<uint8_t> corrupt = contents;
+    SegmentPyramid::header_t header;
+    memcpy(&header, corrupt.data(), sizeof(header));
+    header.counts[0] = 0x7FFFFFFFFFFFLL;
+    for(int lvl = 1; lvl < SegmentPyramid::NUM_LEVELS; lvl++)
+    {
+        header.counts[lvl] = (header.counts[lvl - 1] + SegmentPyramid::LEVEL_FANOUT - 1) / SegmentPyramid::LEVEL_FANOUT;
+    }
+    memcpy(corrupt.data(), &header, sizeof(header));
+    rewrite(corrupt, corrupt.size());
+    if(SegmentPyramid::readSidecar(SIDECAR_FILENAME, copy))
+    {
+        mlog(CRITICAL, "Accepted sidecar with oversized counts");
+        status = false;
+    }
+
+    /* other file version is rejected */
+    corrupt = contents;
+    memcpy(&header, corrupt.data(), sizeof(header));
+    header.version = SegmentPyramid::FILE_VERSION + 1;
+    memcpy(corrupt.data(), &header, sizeof(header));
+    rewrite(corrupt, corrupt.size());
+    if(SegmentPyramid::readSidecar(SIDECAR_FILENAME, copy))
+    {
+        mlog(CRITICAL, "Accepted sidecar of another version");
+        status = false;
+    }
+
+    std::remove(SIDECAR_FILENAME);
+
+    lua_pushboolean(L, status);
+    return 1;
+}
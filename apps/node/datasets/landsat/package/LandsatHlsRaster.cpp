@@ -225,6 +225,14 @@ bool LandsatHlsRaster::findRasters(raster_finder_t* finder)
 }
 
 
+/*----------------------------------------------------------------------------
+ * getBatchGroupSamples - columnar results
+ *----------------------------------------------------------------------------*/
+uint32_t LandsatHlsRaster::getBatchGroupSamples(const rasters_group_t* rgroup, RasterSampleBuffer& buffer, uint32_t flags, uint32_t pointIndx)
+{
+    return getBatchGroupSamplesFromList(rgroup, buffer, flags, pointIndx);
+}
+
 /*----------------------------------------------------------------------------
  * getBatchGroupSamples
  *----------------------------------------------------------------------------*/
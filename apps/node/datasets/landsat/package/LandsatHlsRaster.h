@@ -86,6 +86,7 @@ class LandsatHlsRaster: public GeoIndexedRaster
         bool     findRasters         (raster_finder_t* finder) final;
 
         uint32_t getBatchGroupSamples(const rasters_group_t* rgroup, List<RasterSample*>* slist, uint32_t flags, uint32_t pointIndx) final;
+        uint32_t getBatchGroupSamples(const rasters_group_t* rgroup, RasterSampleBuffer& buffer, uint32_t flags, uint32_t pointIndx) final;
 
         void     resolveBands        (vector<string>& bands) final
                                      { bands.clear(); } /* Landsat bands are in seperate rasters */
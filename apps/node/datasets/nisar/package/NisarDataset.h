@@ -78,6 +78,7 @@ class NisarDataset: public GeoIndexedRaster
         bool    findRasters  (raster_finder_t* finder) final;
 
         uint32_t getBatchGroupSamples(const rasters_group_t* rgroup, List<RasterSample*>* slist, uint32_t flags, uint32_t pointIndx) final;
+        uint32_t getBatchGroupSamples(const rasters_group_t* rgroup, RasterSampleBuffer& buffer, uint32_t flags, uint32_t pointIndx) final;
 
         /*-------------------------------------------------------------------------------
         * NISAR HDF5 georeferencing overrides
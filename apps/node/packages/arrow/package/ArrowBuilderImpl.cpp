@@ -651,11 +651,65 @@ void ArrowBuilderImpl::createMetadataFile(void)
     else throw RunTimeException(CRITICAL, RTE_FAILURE, "Failed to open metadata file: %s", file_path);
 }
 
+/*----------------------------------------------------------------------------
+* processDirectField - B: arrow builder type, T: storage type of field
+*----------------------------------------------------------------------------*/
+template<class B, class T>
+void ArrowBuilderImpl::processDirectField (const RecordObject::Accessor& accessor, shared_ptr<arrow::Array>* column, batch_list_t& record_batch, int num_rows, int batch_row_size_bits)
+{
+    B builder;
+    (void)builder.Reserve(num_rows);
+    const long row_size_bytes = TOBYTES(batch_row_size_bits);
+    for(int i = 0; i < record_batch.length(); i++)
+    {
+        ArrowBuilder::batch_t* batch = record_batch.get(i);
+        const unsigned char* data = batch->pri_record->getRecordData();
+        if(accessor.getField().flags & RecordObject::BATCH)
+        {
+            long byte_offset = 0;
+            for(int row = 0; row < batch->rows; row++)
+            {
+                builder.UnsafeAppend(accessor.value<T>(data, byte_offset));
+                byte_offset += row_size_bytes;
+            }
+        }
+        else // non-batch field
+        {
+            const T value = accessor.value<T>(data);
+            for(int row = 0; row < batch->rows; row++)
+            {
+                builder.UnsafeAppend(value);
+            }
+        }
+    }
+    (void)builder.Finish(column);
+}
+
 /*----------------------------------------------------------------------------
 * processField
 *----------------------------------------------------------------------------*/
 void ArrowBuilderImpl::processField (RecordObject::field_t& field, shared_ptr<arrow::Array>* column, batch_list_t& record_batch, int num_rows, int batch_row_size_bits)
 {
+    /* Fields at a Fixed Byte Offset are Read Through a Compiled Accessor */
+    const RecordObject::Accessor accessor(field);
+    if(accessor.isDirect() && (batch_row_size_bits % 8 == 0))
+    {
+        switch(field.type)
+        {
+            case RecordObject::DOUBLE:  processDirectField<arrow::DoubleBuilder, double>    (accessor, column, record_batch, num_rows, batch_row_size_bits); return;
+            case RecordObject::FLOAT:   processDirectField<arrow::FloatBuilder, float>      (accessor, column, record_batch, num_rows, batch_row_size_bits); return;
+            case RecordObject::INT8:    processDirectField<arrow::Int8Builder, int8_t>      (accessor, column, record_batch, num_rows, batch_row_size_bits); return;
+            case RecordObject::INT16:   processDirectField<arrow::Int16Builder, int16_t>    (accessor, column, record_batch, num_rows, batch_row_size_bits); return;
+            case RecordObject::INT32:   processDirectField<arrow::Int32Builder, int32_t>    (accessor, column, record_batch, num_rows, batch_row_size_bits); return;
+            case RecordObject::INT64:   processDirectField<arrow::Int64Builder, int64_t>    (accessor, column, record_batch, num_rows, batch_row_size_bits); return;
+            case RecordObject::UINT8:   processDirectField<arrow::UInt8Builder, uint8_t>    (accessor, column, record_batch, num_rows, batch_row_size_bits); return;
+            case RecordObject::UINT16:  processDirectField<arrow::UInt16Builder, uint16_t>  (accessor, column, record_batch, num_rows, batch_row_size_bits); return;
+            case RecordObject::UINT32:  processDirectField<arrow::UInt32Builder, uint32_t>  (accessor, column, record_batch, num_rows, batch_row_size_bits); return;
+            case RecordObject::UINT64:  processDirectField<arrow::UInt64Builder, uint64_t>  (accessor, column, record_batch, num_rows, batch_row_size_bits); return;
+            default:                    break; // TIME8 needs a typed timestamp builder, handled below
+        }
+    }
+
     switch(field.type)
     {
         case RecordObject::DOUBLE:
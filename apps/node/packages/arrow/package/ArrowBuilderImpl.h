@@ -108,6 +108,12 @@ class ArrowBuilderImpl
                                      batch_list_t& record_batch,
                                      int num_rows,
                                      int batch_row_size_bits);
+        template<class B, class T>
+        static void processDirectField(const RecordObject::Accessor& accessor,
+                                     shared_ptr<arrow::Array>* column,
+                                     batch_list_t& record_batch,
+                                     int num_rows,
+                                     int batch_row_size_bits);
         static void processArray     (RecordObject::field_t& field,
                                      shared_ptr<arrow::Array>* column,
                                      batch_list_t& record_batch,
@@ -39,16 +39,20 @@
 #include <arrow/table.h>
 #include <arrow/util/key_value_metadata.h>
 #include <arrow/io/file.h>
+#include <arrow/io/memory.h>
 #include <arrow/ipc/api.h>
 #include <arrow/builder.h>
+#include <arrow/array.h>
 #include <parquet/file_writer.h>
 #include <arrow/csv/writer.h>
 #include <regex>
+#include <limits>
 #include "OsApi.h"
 #include "GeoDataFrame.h"
 #include "FieldList.h"
 #include "FieldArray.h"
 #include "FieldColumn.h"
+#include "FieldRaggedColumn.h"
 #include "ArrowDataFrame.h"
 #include "OutputFields.h"
 #include "OutputLib.h"
@@ -148,24 +152,54 @@ void encodeColumnTime8(const FieldColumn<FieldColumn<time8_t>>* field_column, ve
     columns.push_back(arrow_column);
 }
 
+/*----------------------------------------------------------------------------
+* encodeRaggedList - T: ragged column value type
+*
+*  the values and offsets of a ragged column are already in the arrow list
+*  layout, so the array is built directly on top of them without a copy; the
+*  array borrows the column's memory and must not outlive the dataframe
+*----------------------------------------------------------------------------*/
+template<class T>
+void encodeRaggedList(const FieldRaggedColumn<T>* field_column, const shared_ptr<arrow::DataType>& value_type, vector<shared_ptr<arrow::Array>>& columns)
+{
+    const long num_rows = field_column->length();
+    const long num_values = field_column->numValues();
+    const shared_ptr<arrow::Buffer> offsets = arrow::Buffer::Wrap(field_column->offsets.data(), num_rows + 1);
+    const shared_ptr<arrow::Buffer> values = arrow::Buffer::Wrap(field_column->values.data(), num_values);
+    const shared_ptr<arrow::ArrayData> value_data = arrow::ArrayData::Make(value_type, num_values, {nullptr, values}, 0);
+    const shared_ptr<arrow::ArrayData> list_data = arrow::ArrayData::Make(arrow::list(value_type), num_rows, {nullptr, offsets}, {value_data}, 0);
+    columns.push_back(arrow::MakeArray(list_data));
+}
+
 /*----------------------------------------------------------------------------
 * encodeList - T: field list type, B: arrow builder type
 *----------------------------------------------------------------------------*/
 template<class T, class B>
-void encodeList(const FieldColumn<FieldList<T>>* field_column, vector<shared_ptr<arrow::Array>>& columns)
+void encodeList(const Field* field, const shared_ptr<arrow::DataType>& value_type, vector<shared_ptr<arrow::Array>>& columns)
 {
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        const FieldRaggedColumn<T>* ragged_column = dynamic_cast<const FieldRaggedColumn<T>*>(field);
+        if(ragged_column)
+        {
+            encodeRaggedList(ragged_column, value_type, columns);
+            return;
+        }
+    }
+
+    const FieldColumn<FieldList<T>>* field_column = dynamic_cast<const FieldColumn<FieldList<T>>*>(field);
     auto builder = make_shared<B>();
 
     const long num_rows = field_column->length();
     arrow::ListBuilder list_builder(arrow::default_memory_pool(), builder);
     for(long i = 0; i < num_rows; i++)
     {
-        const FieldList<T>& field = (*field_column)[i];
-        const long num_elements = field.length();
+        const FieldList<T>& field_list = (*field_column)[i];
+        const long num_elements = field_list.length();
         (void)list_builder.Append();
         for(int element = 0; element < num_elements; element++)
         {
-            (void)builder->Append(field[element]);
+            (void)builder->Append(field_list[element]);
         }
     }
 
@@ -177,20 +211,30 @@ void encodeList(const FieldColumn<FieldList<T>>* field_column, vector<shared_ptr
 /*----------------------------------------------------------------------------
 * encodeList - time8_t
 *----------------------------------------------------------------------------*/
-void encodeListTime8(const FieldColumn<FieldList<time8_t>>* field_column, vector<shared_ptr<arrow::Array>>& columns)
+void encodeListTime8(const Field* field, vector<shared_ptr<arrow::Array>>& columns)
 {
-    auto builder = make_shared<arrow::TimestampBuilder>(arrow::timestamp(arrow::TimeUnit::NANO), arrow::default_memory_pool());
+    const shared_ptr<arrow::DataType> value_type = arrow::timestamp(arrow::TimeUnit::NANO);
+
+    const FieldRaggedColumn<time8_t>* ragged_column = dynamic_cast<const FieldRaggedColumn<time8_t>*>(field);
+    if(ragged_column)
+    {
+        encodeRaggedList(ragged_column, value_type, columns);
+        return;
+    }
+
+    const FieldColumn<FieldList<time8_t>>* field_column = dynamic_cast<const FieldColumn<FieldList<time8_t>>*>(field);
+    auto builder = make_shared<arrow::TimestampBuilder>(value_type, arrow::default_memory_pool());
 
     const long num_rows = field_column->length();
     arrow::ListBuilder list_builder(arrow::default_memory_pool(), builder);
     for(long i = 0; i < num_rows; i++)
     {
-        const FieldList<time8_t>& field = (*field_column)[i];
-        const long num_elements = field.length();
+        const FieldList<time8_t>& field_list = (*field_column)[i];
+        const long num_elements = field_list.length();
         (void)list_builder.Append();
         for(int element = 0; element < num_elements; element++)
         {
-            (void)builder->Append(field[element].nanoseconds);
+            (void)builder->Append(field_list[element].nanoseconds);
         }
     }
 
@@ -385,7 +429,7 @@ string pandasMetaData (const char* index_column_name, const shared_ptr<arrow::Sc
 /*----------------------------------------------------------------------------
 * processDataFrame
 *----------------------------------------------------------------------------*/
-void processDataFrame (vector<shared_ptr<arrow::Array>>& columns, vector<shared_ptr<arrow::Field>>& fields, const OutputFields& parms, const GeoDataFrame& dataframe, const uint32_t trace_id)
+void processDataFrame (vector<shared_ptr<arrow::Array>>& columns, vector<shared_ptr<arrow::Field>>& fields, const OutputFields& parms, OutputFields::format_t format, const GeoDataFrame& dataframe, const uint32_t trace_id)
 {
     // build columns
     Dictionary<FieldMap<FieldUntypedColumn>::entry_t>::Iterator iter(dataframe.getColumns());
@@ -395,7 +439,7 @@ void processDataFrame (vector<shared_ptr<arrow::Array>>& columns, vector<shared_
         const Field* field = iter[f].value.field;
 
         // check for geoparquet format
-        if( (parms.format == OutputFields::GEOPARQUET) &&
+        if( (format == OutputFields::GEOPARQUET) &&
             (field->encoding & Field::X_COLUMN ||
              field->encoding & Field::Y_COLUMN) )
         {
@@ -407,8 +451,8 @@ void processDataFrame (vector<shared_ptr<arrow::Array>>& columns, vector<shared_
         if(parms.finalFields.length() > 0)
         {
             // when parquet, must include time column becuase it is used as the index
-            if( ((parms.format == OutputFields::PARQUET) ||
-                 (parms.format == OutputFields::GEOPARQUET)) &&
+            if( ((format == OutputFields::PARQUET) ||
+                 (format == OutputFields::GEOPARQUET)) &&
                 ((field->encoding & Field::TIME_COLUMN) == 0))
             {
                 // look for field in list of fields provided by user
@@ -458,18 +502,18 @@ void processDataFrame (vector<shared_ptr<arrow::Array>>& columns, vector<shared_
                 case Field::NESTED_ARRAY | Field::TIME8:    encodeArrayTime8                                (field, columns);                                                           fields.push_back(arrow::field(name, arrow::list(arrow::timestamp(arrow::TimeUnit::NANO)))); break;
                 case Field::NESTED_ARRAY | Field::STRING:   encodeArray<string,    arrow::StringBuilder>    (field, columns);                                                           fields.push_back(arrow::field(name, arrow::utf8()));                                        break;
 
-                case Field::NESTED_LIST | Field::INT8:      encodeList<int8_t,     arrow::Int8Builder>      (dynamic_cast<const FieldColumn<FieldList<int8_t>>*>(field), columns);      fields.push_back(arrow::field(name, arrow::list(arrow::int8())));                           break;
-                case Field::NESTED_LIST | Field::INT16:     encodeList<int16_t,    arrow::Int16Builder>     (dynamic_cast<const FieldColumn<FieldList<int16_t>>*>(field), columns);     fields.push_back(arrow::field(name, arrow::list(arrow::int16())));                          break;
-                case Field::NESTED_LIST | Field::INT32:     encodeList<int32_t,    arrow::Int32Builder>     (dynamic_cast<const FieldColumn<FieldList<int32_t>>*>(field), columns);     fields.push_back(arrow::field(name, arrow::list(arrow::int32())));                          break;
-                case Field::NESTED_LIST | Field::INT64:     encodeList<int64_t,    arrow::Int64Builder>     (dynamic_cast<const FieldColumn<FieldList<int64_t>>*>(field), columns);     fields.push_back(arrow::field(name, arrow::list(arrow::int64())));                          break;
-                case Field::NESTED_LIST | Field::UINT8:     encodeList<uint8_t,    arrow::UInt8Builder>     (dynamic_cast<const FieldColumn<FieldList<uint8_t>>*>(field), columns);     fields.push_back(arrow::field(name, arrow::list(arrow::uint8())));                          break;
-                case Field::NESTED_LIST | Field::UINT16:    encodeList<uint16_t,   arrow::UInt16Builder>    (dynamic_cast<const FieldColumn<FieldList<uint16_t>>*>(field), columns);    fields.push_back(arrow::field(name, arrow::list(arrow::uint16())));                         break;
-                case Field::NESTED_LIST | Field::UINT32:    encodeList<uint32_t,   arrow::UInt32Builder>    (dynamic_cast<const FieldColumn<FieldList<uint32_t>>*>(field), columns);    fields.push_back(arrow::field(name, arrow::list(arrow::uint32())));                         break;
-                case Field::NESTED_LIST | Field::UINT64:    encodeList<uint64_t,   arrow::UInt64Builder>    (dynamic_cast<const FieldColumn<FieldList<uint64_t>>*>(field), columns);    fields.push_back(arrow::field(name, arrow::list(arrow::uint64())));                         break;
-                case Field::NESTED_LIST | Field::FLOAT:     encodeList<float,      arrow::FloatBuilder>     (dynamic_cast<const FieldColumn<FieldList<float>>*>(field), columns);       fields.push_back(arrow::field(name, arrow::list(arrow::float32())));                        break;
-                case Field::NESTED_LIST | Field::DOUBLE:    encodeList<double,     arrow::DoubleBuilder>    (dynamic_cast<const FieldColumn<FieldList<double>>*>(field), columns);      fields.push_back(arrow::field(name, arrow::list(arrow::float64())));                        break;
-                case Field::NESTED_LIST | Field::TIME8:     encodeListTime8                                 (dynamic_cast<const FieldColumn<FieldList<time8_t>>*>(field), columns);     fields.push_back(arrow::field(name, arrow::list(arrow::timestamp(arrow::TimeUnit::NANO)))); break;
-                case Field::NESTED_LIST | Field::STRING:    encodeList<string,     arrow::StringBuilder>    (dynamic_cast<const FieldColumn<FieldList<string>>*>(field), columns);      fields.push_back(arrow::field(name, arrow::utf8()));                                        break;
+                case Field::NESTED_LIST | Field::INT8:      encodeList<int8_t,     arrow::Int8Builder>      (field, arrow::int8(), columns);                                            fields.push_back(arrow::field(name, arrow::list(arrow::int8())));                           break;
+                case Field::NESTED_LIST | Field::INT16:     encodeList<int16_t,    arrow::Int16Builder>     (field, arrow::int16(), columns);                                           fields.push_back(arrow::field(name, arrow::list(arrow::int16())));                          break;
+                case Field::NESTED_LIST | Field::INT32:     encodeList<int32_t,    arrow::Int32Builder>     (field, arrow::int32(), columns);                                           fields.push_back(arrow::field(name, arrow::list(arrow::int32())));                          break;
+                case Field::NESTED_LIST | Field::INT64:     encodeList<int64_t,    arrow::Int64Builder>     (field, arrow::int64(), columns);                                           fields.push_back(arrow::field(name, arrow::list(arrow::int64())));                          break;
+                case Field::NESTED_LIST | Field::UINT8:     encodeList<uint8_t,    arrow::UInt8Builder>     (field, arrow::uint8(), columns);                                           fields.push_back(arrow::field(name, arrow::list(arrow::uint8())));                          break;
+                case Field::NESTED_LIST | Field::UINT16:    encodeList<uint16_t,   arrow::UInt16Builder>    (field, arrow::uint16(), columns);                                          fields.push_back(arrow::field(name, arrow::list(arrow::uint16())));                         break;
+                case Field::NESTED_LIST | Field::UINT32:    encodeList<uint32_t,   arrow::UInt32Builder>    (field, arrow::uint32(), columns);                                          fields.push_back(arrow::field(name, arrow::list(arrow::uint32())));                         break;
+                case Field::NESTED_LIST | Field::UINT64:    encodeList<uint64_t,   arrow::UInt64Builder>    (field, arrow::uint64(), columns);                                          fields.push_back(arrow::field(name, arrow::list(arrow::uint64())));                         break;
+                case Field::NESTED_LIST | Field::FLOAT:     encodeList<float,      arrow::FloatBuilder>     (field, arrow::float32(), columns);                                         fields.push_back(arrow::field(name, arrow::list(arrow::float32())));                        break;
+                case Field::NESTED_LIST | Field::DOUBLE:    encodeList<double,     arrow::DoubleBuilder>    (field, arrow::float64(), columns);                                         fields.push_back(arrow::field(name, arrow::list(arrow::float64())));                        break;
+                case Field::NESTED_LIST | Field::TIME8:     encodeListTime8                                 (field, columns);                                                           fields.push_back(arrow::field(name, arrow::list(arrow::timestamp(arrow::TimeUnit::NANO)))); break;
+                case Field::NESTED_LIST | Field::STRING:    encodeList<string,     arrow::StringBuilder>    (field, arrow::utf8(), columns);                                            fields.push_back(arrow::field(name, arrow::utf8()));                                        break;
 
                 case Field::NESTED_COLUMN | Field::INT8:    encodeColumn<int8_t,   arrow::Int8Builder>      (dynamic_cast<const FieldColumn<FieldColumn<int8_t>>*>(field), columns);    fields.push_back(arrow::field(name, arrow::list(arrow::int8())));                           break;
                 case Field::NESTED_COLUMN | Field::INT16:   encodeColumn<int16_t,  arrow::Int16Builder>     (dynamic_cast<const FieldColumn<FieldColumn<int16_t>>*>(field), columns);   fields.push_back(arrow::field(name, arrow::list(arrow::int16())));                          break;
@@ -495,7 +539,7 @@ void processDataFrame (vector<shared_ptr<arrow::Array>>& columns, vector<shared_
     }
 
     // build geo columns
-    if(parms.format == OutputFields::GEOPARQUET)
+    if(format == OutputFields::GEOPARQUET)
     {
         const uint32_t geo_trace_id = start_trace(INFO, trace_id, "encodeGeometry", "%s", "{}");
         encodeGeometry(dataframe, columns);
@@ -504,6 +548,99 @@ void processDataFrame (vector<shared_ptr<arrow::Array>>& columns, vector<shared_
     }
 }
 
+/*----------------------------------------------------------------------------
+* decode - T: field column type, A: arrow array type
+*
+*  chunks without nulls are copied with a single bulk append; nulls are only
+*  accepted for floating point columns (checked by the caller) and become NaN
+*----------------------------------------------------------------------------*/
+template<class T, class A>
+FieldUntypedColumn* decode(const shared_ptr<arrow::ChunkedArray>& chunked_array)
+{
+    FieldColumn<T>* column = new FieldColumn<T>(0U, MAX(chunked_array->length(), 1L));
+    for(const shared_ptr<arrow::Array>& chunk: chunked_array->chunks())
+    {
+        const shared_ptr<A> array = std::static_pointer_cast<A>(chunk);
+        if(array->null_count() == 0)
+        {
+            column->appendBuffer(reinterpret_cast<const uint8_t*>(array->raw_values()), array->length() * sizeof(T));
+        }
+        else
+        {
+            for(int64_t i = 0; i < array->length(); i++)
+            {
+                column->append(array->IsNull(i) ? std::numeric_limits<T>::quiet_NaN() : array->Value(i));
+            }
+        }
+    }
+    return column;
+}
+
+/*----------------------------------------------------------------------------
+* decodeTime8
+*----------------------------------------------------------------------------*/
+FieldUntypedColumn* decodeTime8(const shared_ptr<arrow::ChunkedArray>& chunked_array)
+{
+    static_assert(sizeof(time8_t) == sizeof(int64_t));
+
+    int64_t scale = 1;
+    switch(std::static_pointer_cast<arrow::TimestampType>(chunked_array->type())->unit())
+    {
+        case arrow::TimeUnit::SECOND:   scale = 1000000000; break;
+        case arrow::TimeUnit::MILLI:    scale = 1000000;    break;
+        case arrow::TimeUnit::MICRO:    scale = 1000;       break;
+        case arrow::TimeUnit::NANO:     scale = 1;          break;
+    }
+
+    FieldColumn<time8_t>* column = new FieldColumn<time8_t>(0U, MAX(chunked_array->length(), 1L));
+    for(const shared_ptr<arrow::Array>& chunk: chunked_array->chunks())
+    {
+        const shared_ptr<arrow::TimestampArray> array = std::static_pointer_cast<arrow::TimestampArray>(chunk);
+        if(scale == 1)
+        {
+            column->appendBuffer(reinterpret_cast<const uint8_t*>(array->raw_values()), array->length() * sizeof(time8_t));
+        }
+        else
+        {
+            for(int64_t i = 0; i < array->length(); i++)
+            {
+                column->append(time8_t(array->Value(i) * scale));
+            }
+        }
+    }
+    return column;
+}
+
+/*----------------------------------------------------------------------------
+* decodeString
+*----------------------------------------------------------------------------*/
+FieldUntypedColumn* decodeString(const shared_ptr<arrow::ChunkedArray>& chunked_array)
+{
+    FieldColumn<string>* column = new FieldColumn<string>(0U, MAX(chunked_array->length(), 1L));
+    for(const shared_ptr<arrow::Array>& chunk: chunked_array->chunks())
+    {
+        const shared_ptr<arrow::StringArray> array = std::static_pointer_cast<arrow::StringArray>(chunk);
+        for(int64_t i = 0; i < array->length(); i++)
+        {
+            column->append(array->GetString(i));
+        }
+    }
+    return column;
+}
+
+/*----------------------------------------------------------------------------
+* writeIpcStream
+*----------------------------------------------------------------------------*/
+arrow::Status writeIpcStream (arrow::io::OutputStream* sink, const shared_ptr<arrow::Schema>& schema, const shared_ptr<arrow::RecordBatch>& batch)
+{
+    auto result = arrow::ipc::MakeStreamWriter(sink, schema);
+    if(!result.ok()) return result.status();
+    const shared_ptr<arrow::ipc::RecordBatchWriter> writer = result.ValueOrDie();
+    const arrow::Status s = writer->WriteRecordBatch(*batch);
+    if(!s.ok()) return s;
+    return writer->Close();
+}
+
 /******************************************************************************
  * CLASS DATA
  ******************************************************************************/
@@ -512,7 +649,8 @@ const char* ArrowDataFrame::OBJECT_TYPE = "ArrowDataFrame";
 const char* ArrowDataFrame::LUA_META_NAME = "ArrowDataFrame";
 const struct luaL_Reg ArrowDataFrame::LUA_META_TABLE[] = {
     {"export",  luaExport},
-    {"import",  luaImport}, // TODO
+    {"share",   luaShare},
+    {"import",  luaImport},
     {NULL,      NULL}
 };
 
@@ -571,7 +709,7 @@ int ArrowDataFrame::luaExport (lua_State* L)
         // process dataframe to arrow table
         vector<shared_ptr<arrow::Array>> columns; // data
         vector<shared_ptr<arrow::Field>> field_list; // schema
-        processDataFrame(columns, field_list, arrow_parms, dataframe, trace_id);
+        processDataFrame(columns, field_list, arrow_parms, arrow_parms.format.value, dataframe, trace_id);
         shared_ptr<arrow::Schema> schema = make_shared<arrow::Schema>(field_list); // create schema
 
         // write out table
@@ -727,25 +865,193 @@ int ArrowDataFrame::luaExport (lua_State* L)
 }
 
 /*----------------------------------------------------------------------------
- * luaImport - import()
+ * luaShare - share(<filename>) -> filename
+ *
+ *  writes the dataframe as an uncompressed Arrow IPC stream directly into a
+ *  memory mapped file; when the file is in a container sandbox the container
+ *  can map it (e.g. pyarrow.memory_map) and use the columns without parsing
+ *----------------------------------------------------------------------------*/
+int ArrowDataFrame::luaShare (lua_State* L)
+{
+    bool status = false;
+    const char* filename = NULL;
+
+    try
+    {
+        // get lua parameters
+        ArrowDataFrame* lua_obj = dynamic_cast<ArrowDataFrame*>(getLuaSelf(L, 1));
+        filename = getLuaString(L, 2);
+
+        // get references
+        const RequestParameters& parms = *lua_obj->parms;
+        const GeoDataFrame& dataframe = *lua_obj->dataframe;
+
+        // start trace
+        const uint32_t parent_trace_id = EventLib::grabId();
+        const uint32_t trace_id = start_trace(INFO, parent_trace_id, "ArrowDataFrame", "{\"num_rows\": %ld}", dataframe.length());
+
+        // process dataframe to arrow record batch (geometry left as x and y columns)
+        vector<shared_ptr<arrow::Array>> columns; // data
+        vector<shared_ptr<arrow::Field>> field_list; // schema
+        processDataFrame(columns, field_list, parms.output, OutputFields::FEATHER, dataframe, trace_id);
+        shared_ptr<arrow::Schema> schema = make_shared<arrow::Schema>(field_list);
+        auto metadata = make_shared<arrow::KeyValueMetadata>();
+        metadata->Append("meta", dataframe.getMetaAsJson());
+        metadata->Append("recordinfo", dataframe.getInfoAsJson());
+        schema = schema->WithMetadata(metadata);
+        const shared_ptr<arrow::RecordBatch> batch = arrow::RecordBatch::Make(schema, dataframe.length(), columns);
+
+        // size stream so the mapped file can be allocated up front
+        const uint32_t write_trace_id = start_trace(INFO, trace_id, "write_stream", "%s", "{}");
+        arrow::io::MockOutputStream mock_stream;
+        const arrow::Status mock_status = writeIpcStream(&mock_stream, schema, batch);
+        if(!mock_status.ok())
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to size arrow stream: %s", mock_status.ToString().c_str());
+        }
+
+        // write stream into memory mapped file
+        auto result = arrow::io::MemoryMappedFile::Create(filename, mock_stream.GetExtentBytesWritten());
+        if(!result.ok())
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to create memory mapped file %s: %s", filename, result.status().ToString().c_str());
+        }
+        const shared_ptr<arrow::io::MemoryMappedFile> mapped_file = result.ValueOrDie();
+        const arrow::Status s = writeIpcStream(mapped_file.get(), schema, batch);
+        (void)mapped_file->Close();
+        if(!s.ok())
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to write arrow stream to %s: %s", filename, s.ToString().c_str());
+        }
+        status = true;
+        stop_trace(INFO, write_trace_id);
+
+        // stop trace
+        stop_trace(INFO, trace_id);
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error sharing %s: %s", OBJECT_TYPE, e.what());
+    }
+
+    // return filename or failure
+    if(status) lua_pushstring(L, filename);
+    else lua_pushnil(L);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaImport - import(<filename>) -> number of columns adopted
+ *
+ *  reads an Arrow IPC stream (e.g. results written by a container) from a
+ *  memory mapped file and copies each column into the dataframe, replacing
+ *  any non-geometry column of the same name; columns with nulls are only
+ *  imported when floating point (nulls become NaN)
  *----------------------------------------------------------------------------*/
 int ArrowDataFrame::luaImport (lua_State* L)
 {
-    bool status = true;
+    bool status = false;
+    int num_adopted = 0;
+
     try
     {
+        // get lua parameters
         ArrowDataFrame* lua_obj = dynamic_cast<ArrowDataFrame*>(getLuaSelf(L, 1));
-        (void)lua_obj;
+        const char* filename = getLuaString(L, 2);
+        GeoDataFrame& dataframe = *lua_obj->dataframe;
+
+        // memory map file - the stream is read in place, columns are copied out below
+        auto map_result = arrow::io::MemoryMappedFile::Open(filename, arrow::io::FileMode::READ);
+        if(!map_result.ok())
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to map %s: %s", filename, map_result.status().ToString().c_str());
+        }
+        const shared_ptr<arrow::io::MemoryMappedFile> mapped_file = map_result.ValueOrDie();
+
+        // read table
+        auto reader_result = arrow::ipc::RecordBatchStreamReader::Open(mapped_file);
+        if(!reader_result.ok())
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to open arrow stream %s: %s", filename, reader_result.status().ToString().c_str());
+        }
+        auto table_result = reader_result.ValueOrDie()->ToTable();
+        if(!table_result.ok())
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to read arrow stream %s: %s", filename, table_result.status().ToString().c_str());
+        }
+        const shared_ptr<arrow::Table> table = table_result.ValueOrDie();
+
+        // check rows
+        const long num_rows = table->num_rows();
+        if(dataframe.length() > 0 && num_rows != dataframe.length())
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "imported table has %ld rows, dataframe has %ld", num_rows, dataframe.length());
+        }
+
+        // adopt columns
+        for(int i = 0; i < table->num_columns(); i++)
+        {
+            const string& name = table->field(i)->name();
+            const shared_ptr<arrow::ChunkedArray>& chunked_array = table->column(i);
+
+            // do not replace columns the dataframe tracks for geometry
+            const FieldUntypedColumn* existing = dataframe.getColumn(name.c_str(), true);
+            if(existing && (existing->encoding & (Field::TIME_COLUMN | Field::X_COLUMN | Field::Y_COLUMN | Field::Z_COLUMN)))
+            {
+                mlog(WARNING, "Skipping import of geometry column %s", name.c_str());
+                continue;
+            }
+
+            // nulls have no representation outside of floating point columns
+            const arrow::Type::type type_id = chunked_array->type()->id();
+            if( (chunked_array->null_count() > 0) &&
+                (type_id != arrow::Type::FLOAT) &&
+                (type_id != arrow::Type::DOUBLE) )
+            {
+                mlog(WARNING, "Skipping import of column %s with %ld null values", name.c_str(), static_cast<long>(chunked_array->null_count()));
+                continue;
+            }
+
+            FieldUntypedColumn* column = NULL;
+            switch(type_id)
+            {
+                case arrow::Type::INT8:         column = decode<int8_t,     arrow::Int8Array>   (chunked_array); break;
+                case arrow::Type::INT16:        column = decode<int16_t,    arrow::Int16Array>  (chunked_array); break;
+                case arrow::Type::INT32:        column = decode<int32_t,    arrow::Int32Array>  (chunked_array); break;
+                case arrow::Type::INT64:        column = decode<int64_t,    arrow::Int64Array>  (chunked_array); break;
+                case arrow::Type::UINT8:        column = decode<uint8_t,    arrow::UInt8Array>  (chunked_array); break;
+                case arrow::Type::UINT16:       column = decode<uint16_t,   arrow::UInt16Array> (chunked_array); break;
+                case arrow::Type::UINT32:       column = decode<uint32_t,   arrow::UInt32Array> (chunked_array); break;
+                case arrow::Type::UINT64:       column = decode<uint64_t,   arrow::UInt64Array> (chunked_array); break;
+                case arrow::Type::FLOAT:        column = decode<float,      arrow::FloatArray>  (chunked_array); break;
+                case arrow::Type::DOUBLE:       column = decode<double,     arrow::DoubleArray> (chunked_array); break;
+                case arrow::Type::TIMESTAMP:    column = decodeTime8                            (chunked_array); break;
+                case arrow::Type::STRING:       column = decodeString                           (chunked_array); break;
+                default: mlog(WARNING, "Skipping import of column %s with type %s", name.c_str(), chunked_array->type()->ToString().c_str()); break;
+            }
+            if(!column) continue;
+
+            if(existing) dataframe.deleteColumn(name.c_str());
+            if(!dataframe.addColumn(name.c_str(), column, NULL, true))
+            {
+                delete column;
+                throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to add column %s to dataframe", name.c_str());
+            }
+            num_adopted++;
+        }
 
-        throw RunTimeException(CRITICAL, RTE_FAILURE, "unsupported");
+        // update rows
+        dataframe.setNumRows(num_rows);
+        (void)mapped_file->Close();
+        status = true;
     }
     catch(const RunTimeException& e)
     {
         mlog(e.level(), "Error importing %s: %s", OBJECT_TYPE, e.what());
-        status = false;
     }
 
-    return returnLuaStatus(L, status);
+    lua_pushinteger(L, num_adopted);
+    return returnLuaStatus(L, status, 2);
 }
 
 /*----------------------------------------------------------------------------
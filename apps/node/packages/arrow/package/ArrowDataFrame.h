@@ -63,6 +63,7 @@ class ArrowDataFrame: public LuaObject
 
         static int  luaCreate   (lua_State* L);
         static int  luaExport   (lua_State* L);
+        static int  luaShare    (lua_State* L);
         static int  luaImport   (lua_State* L);
 
     private:
@@ -0,0 +1,43 @@
+local runner = require("test_executive")
+
+-- Self Test --
+
+runner.unittest("ArrowDataFrame Share and Import", function()
+
+    local table_in = {a = {1,2,3,4}, b = {11.5,12.5,13.5,14.5}, c = {-21,-22,-23,-24}}
+    local filename = string.format("/tmp/arrow_share_%d.arrow", os.time())
+    local parms = core.parms()
+
+    -- share dataframe into memory mapped file
+    local df_in = core.dataframe(table_in)
+    local shared = arrow.dataframe(parms, df_in):share(filename)
+    runner.assert(shared == filename, "failed to share dataframe", true)
+
+    -- import columns into empty dataframe
+    local df_out = core.dataframe()
+    local num_columns, status = arrow.dataframe(parms, df_out):import(filename)
+    runner.assert(status, "failed to import dataframe", true)
+    runner.assert(num_columns == 3, string.format("imported %d columns, expected 3", num_columns))
+    runner.assert(df_out:numrows() == 4, string.format("imported %d rows, expected 4", df_out:numrows()))
+
+    for k,_ in pairs(table_in) do
+        for i = 1,4 do
+            runner.assert(table_in[k][i] == df_out[k][i], string.format("imported mismatch on key %s, row %d: %f != %f", k, i, table_in[k][i], df_out[k][i]))
+        end
+    end
+
+    -- import replaces existing non-geometry columns
+    local df_replace = core.dataframe({a = {0,0,0,0}, b = {0,0,0,0}, c = {0,0,0,0}})
+    num_columns, status = arrow.dataframe(parms, df_replace):import(filename)
+    runner.assert(status and num_columns == 3, "failed to import into populated dataframe")
+    for i = 1,4 do
+        runner.assert(table_in["b"][i] == df_replace["b"][i], string.format("replaced mismatch on row %d: %f != %f", i, table_in["b"][i], df_replace["b"][i]))
+    end
+
+    os.remove(filename)
+
+end)
+
+-- Report Results --
+
+runner.report()
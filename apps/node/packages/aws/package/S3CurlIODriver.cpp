@@ -39,6 +39,8 @@
 #include "OsApi.h"
 
 #include <curl/curl.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <openssl/hmac.h>
 #include <openssl/sha.h>
 #include <openssl/evp.h>
@@ -63,6 +65,38 @@ typedef struct {
     long        size;
 } file_data_t;
 
+typedef struct {
+    int         fd;
+    int64_t     offset;
+    int64_t     remaining;
+} part_data_t;
+
+typedef struct {
+    long        number;
+    int64_t     offset;
+    int64_t     size;
+    string      etag;
+    string      checksum;
+} upload_part_t;
+
+typedef struct {
+    int                                 fd;
+    const char*                         bucket;
+    const char*                         key;
+    const char*                         endpoint;
+    const char*                         region;
+    const CredentialStore::Credential*  credentials;
+    bool                                withChecksum;
+    string                              url;
+    string                              uploadId;
+    string                              encodedUploadId;
+    vector<upload_part_t>               parts;
+    Mutex                               mutex;
+    size_t                              nextPart;
+    bool                                failed;
+    string                              error;
+} multipart_upload_t;
+
 typedef struct curl_slist* headers_t;
 
 typedef size_t (*write_cb_t)(void*, size_t, size_t, void*);
@@ -176,6 +210,51 @@ static size_t curlReadFile(void* buffer, size_t size, size_t nmemb, void *userp)
     return bytes_read;
 }
 
+/*----------------------------------------------------------------------------
+ * curlReadPart
+ *----------------------------------------------------------------------------*/
+static size_t curlReadPart(void* buffer, size_t size, size_t nmemb, void *userp)
+{
+    part_data_t* data = reinterpret_cast<part_data_t*>(userp);
+    const size_t bytes_to_read = MIN(size * nmemb, static_cast<size_t>(data->remaining));
+    if(bytes_to_read == 0) return 0;
+    const ssize_t bytes_read = pread(data->fd, buffer, bytes_to_read, data->offset);
+    if(bytes_read < 0) return CURL_READFUNC_ABORT;
+    data->offset += bytes_read;
+    data->remaining -= bytes_read;
+    return bytes_read;
+}
+
+/*----------------------------------------------------------------------------
+ * curlWriteString
+ *----------------------------------------------------------------------------*/
+static size_t curlWriteString(const void *buffer, size_t size, size_t nmemb, void *userp)
+{
+    string* rsps = reinterpret_cast<string*>(userp);
+    const size_t rsps_size = size * nmemb;
+    rsps->append(reinterpret_cast<const char*>(buffer), rsps_size);
+    return rsps_size;
+}
+
+/*----------------------------------------------------------------------------
+ * curlHeaderETag
+ *----------------------------------------------------------------------------*/
+static size_t curlHeaderETag(const char* buffer, size_t size, size_t nitems, void *userp)
+{
+    string* etag = reinterpret_cast<string*>(userp);
+    const size_t header_size = size * nitems;
+    const size_t prefix_len = 5; // "etag:"
+    if(header_size > prefix_len && strncasecmp(buffer, "etag:", prefix_len) == 0)
+    {
+        size_t start = prefix_len;
+        size_t end = header_size;
+        while(start < end && isspace(buffer[start])) start++;
+        while(end > start && isspace(buffer[end - 1])) end--;
+        etag->assign(&buffer[start], end - start);
+    }
+    return header_size;
+}
+
 /*----------------------------------------------------------------------------
  * buildReadHeadersV2
  *----------------------------------------------------------------------------*/
@@ -214,7 +293,7 @@ static headers_t buildReadHeadersV2 (const char* bucket, const char* key, const
 /*----------------------------------------------------------------------------
  * buildWriteHeadersV2
  *----------------------------------------------------------------------------*/
-static headers_t buildWriteHeadersV2 (const char* bucket, const char* key, const CredentialStore::Credential* credentials, long content_length)
+static headers_t buildWriteHeadersV2 (const char* bucket, const char* key, const CredentialStore::Credential* credentials, long content_length, const char* verb="PUT", const char* subresource="")
 {
     /* Initial HTTP Header List */
     struct curl_slist* headers = NULL;
@@ -243,7 +322,7 @@ static headers_t buildWriteHeadersV2 (const char* bucket, const char* key, const
         headers = curl_slist_append(headers, securityTokenHeader.c_str());
 
         /* Build Authorization Header */
-        const FString stringToSign("PUT\n\n%s\n%s\n%s\n/%s/%s", contentType.c_str(), date.c_str(), securityTokenHeader.c_str(), bucket, key);
+        const FString stringToSign("%s\n\n%s\n%s\n%s\n/%s/%s%s", verb, contentType.c_str(), date.c_str(), securityTokenHeader.c_str(), bucket, key, subresource);
         unsigned char hash[EVP_MAX_MD_SIZE];
         unsigned int hash_size = EVP_MAX_MD_SIZE; // set below with actual size
         HMAC(EVP_sha1(), reinterpret_cast<const unsigned char*>(credentials->secretAccessKey.value.c_str()), credentials->secretAccessKey.value.length(), reinterpret_cast<const unsigned char*>(stringToSign.c_str()), stringToSign.length(), hash, &hash_size);
@@ -259,7 +338,8 @@ static headers_t buildWriteHeadersV2 (const char* bucket, const char* key, const
 /*----------------------------------------------------------------------------
  * buildWriteHeadersV4
  *----------------------------------------------------------------------------*/
-static headers_t buildWriteHeadersV4 (const char* bucket, const char* key, const char* endpoint, const char* region, const CredentialStore::Credential* credentials, long content_length, const char* sha256_b64)
+static headers_t buildWriteHeadersV4 (const char* bucket, const char* key, const char* endpoint, const char* region, const CredentialStore::Credential* credentials, long content_length, const char* sha256_b64,
+                                      const char* verb="PUT", const char* query="", bool checksum_algorithm=false)
 {
     /* Must Supply Credentials */
     if(!credentials || credentials->sessionToken.value.empty())
@@ -280,27 +360,27 @@ static headers_t buildWriteHeadersV4 (const char* bucket, const char* key, const
     const FString timestamp("%04d%02d%02dT%02d%02d%02dZ", gmt_date.year, gmt_date.month, gmt_date.day, gmt_time.hour, gmt_time.minute, gmt_time.second);
     const FString date("%04d%02d%02d", gmt_date.year, gmt_date.month, gmt_date.day);
 
-    /* Build Signed Headers List (sorted, lowercase, semicolon-separated) */
-    const char* signed_headers = sha256_b64
-        ? "content-length;host;x-amz-checksum-sha256;x-amz-content-sha256;x-amz-date;x-amz-security-token"
-        : "content-length;host;x-amz-content-sha256;x-amz-date;x-amz-security-token";
-
-    /* Build Canonical Request and Hash */
-    char canonical_request_hash[SHA256_HEX_STR_SIZE];
-    if(sha256_b64)
+    /* Build Canonical and Signed Headers (sorted, lowercase) */
+    string canonical_headers = FString("content-length:%ld\nhost:%s\n", content_length, endpoint).c_str();
+    string signed_headers = "content-length;host";
+    if(checksum_algorithm)
     {
-        const FString canonical_request(
-            "PUT\n/%s/%s\n\ncontent-length:%ld\nhost:%s\nx-amz-checksum-sha256:%s\nx-amz-content-sha256:UNSIGNED-PAYLOAD\nx-amz-date:%s\nx-amz-security-token:%s\n\n%s\nUNSIGNED-PAYLOAD",
-            bucket, key_ptr, content_length, endpoint, sha256_b64, timestamp.c_str(), token, signed_headers);
-        sha256hash(canonical_request.c_str(), canonical_request.length(), canonical_request_hash);
+        canonical_headers += "x-amz-checksum-algorithm:SHA256\n";
+        signed_headers += ";x-amz-checksum-algorithm";
     }
-    else
+    if(sha256_b64)
     {
-        const FString canonical_request(
-            "PUT\n/%s/%s\n\ncontent-length:%ld\nhost:%s\nx-amz-content-sha256:UNSIGNED-PAYLOAD\nx-amz-date:%s\nx-amz-security-token:%s\n\n%s\nUNSIGNED-PAYLOAD",
-            bucket, key_ptr, content_length, endpoint, timestamp.c_str(), token, signed_headers);
-        sha256hash(canonical_request.c_str(), canonical_request.length(), canonical_request_hash);
+        canonical_headers += FString("x-amz-checksum-sha256:%s\n", sha256_b64).c_str();
+        signed_headers += ";x-amz-checksum-sha256";
     }
+    canonical_headers += FString("x-amz-content-sha256:UNSIGNED-PAYLOAD\nx-amz-date:%s\nx-amz-security-token:%s\n", timestamp.c_str(), token).c_str();
+    signed_headers += ";x-amz-content-sha256;x-amz-date;x-amz-security-token";
+
+    /* Build Canonical Request and Hash */
+    char canonical_request_hash[SHA256_HEX_STR_SIZE];
+    const FString canonical_request("%s\n/%s/%s\n%s\n%s\n%s\nUNSIGNED-PAYLOAD",
+        verb, bucket, key_ptr, query, canonical_headers.c_str(), signed_headers.c_str());
+    sha256hash(canonical_request.c_str(), canonical_request.length(), canonical_request_hash);
 
     /* Build String to Sign */
     const FString scope("%s/%s/s3/aws4_request", date.c_str(), region);
@@ -343,13 +423,17 @@ static headers_t buildWriteHeadersV4 (const char* bucket, const char* key, const
     headers = curl_slist_append(headers, "Transfer-Encoding:"); // strip Transfer-Encoding curl might otherwise add
     headers = curl_slist_append(headers, FString("x-amz-date: %s", timestamp.c_str()).c_str());
     headers = curl_slist_append(headers, FString("x-amz-content-sha256: %s", "UNSIGNED-PAYLOAD").c_str());
+    if(checksum_algorithm)
+    {
+        headers = curl_slist_append(headers, "x-amz-checksum-algorithm: SHA256");
+    }
     if(sha256_b64)
     {
         headers = curl_slist_append(headers, FString("x-amz-checksum-sha256: %s", sha256_b64).c_str());
     }
     headers = curl_slist_append(headers, FString("x-amz-security-token: %s", token).c_str());
     headers = curl_slist_append(headers, FString("Content-Length: %ld", content_length).c_str());
-    headers = curl_slist_append(headers, FString("Authorization: AWS4-HMAC-SHA256 Credential=%s/%s, SignedHeaders=%s, Signature=%s", credentials->accessKeyId.value.c_str(), scope.c_str(), signed_headers, signature_hex).c_str());
+    headers = curl_slist_append(headers, FString("Authorization: AWS4-HMAC-SHA256 Credential=%s/%s, SignedHeaders=%s, Signature=%s", credentials->accessKeyId.value.c_str(), scope.c_str(), signed_headers.c_str(), signature_hex).c_str());
 
     return headers;
 }
@@ -503,6 +587,369 @@ static string calculateChecksum (FILE* fd)
     return sha256_b64;
 }
 
+/*----------------------------------------------------------------------------
+ * extractRegion - expects "s3.<region>.<domain>", returns NULL otherwise
+ *----------------------------------------------------------------------------*/
+static const char* extractRegion (const char* endpoint, char* region_buf, int region_buf_size)
+{
+    const int s3_prefix_len = 3;
+    if(strncmp(endpoint, "s3.", s3_prefix_len) != 0)
+    {
+        return NULL;
+    }
+
+    const char* region_start = endpoint + s3_prefix_len;
+    const char* region_end = strchr(region_start, '.');
+    if(!region_end)
+    {
+        throw RunTimeException(ERROR, RTE_FAILURE, "Invalid domain in endpoint: %s", endpoint);
+    }
+
+    const int region_len = region_end - region_start;
+    if(region_len <= 0 || region_len >= region_buf_size)
+    {
+        throw RunTimeException(ERROR, RTE_FAILURE, "Invalid region in endpoint: %s", endpoint);
+    }
+
+    memcpy(region_buf, region_start, region_len);
+    region_buf[region_len] = '\0';
+    return region_buf;
+}
+
+/*----------------------------------------------------------------------------
+ * buildWriteUrl - endpoints may supply their own scheme (e.g. http://localhost:9000)
+ *----------------------------------------------------------------------------*/
+static FString buildWriteUrl (const char* endpoint, const char* bucket, const char* key)
+{
+    if(strncmp(endpoint, "http://", 7) == 0 || strncmp(endpoint, "https://", 8) == 0)
+    {
+        return FString("%s/%s/%s", endpoint, bucket, key);
+    }
+    return FString("https://%s/%s/%s", endpoint, bucket, key);
+}
+
+/*----------------------------------------------------------------------------
+ * uriEncode
+ *----------------------------------------------------------------------------*/
+static string uriEncode (const string& value)
+{
+    string encoded;
+    for(const char c: value)
+    {
+        if(isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '.' || c == '~')
+        {
+            encoded += c;
+        }
+        else
+        {
+            encoded += FString("%%%02X", static_cast<unsigned char>(c)).c_str();
+        }
+    }
+    return encoded;
+}
+
+/*----------------------------------------------------------------------------
+ * getXmlElement
+ *----------------------------------------------------------------------------*/
+static string getXmlElement (const string& xml, const char* element)
+{
+    const string open_tag = FString("<%s>", element).c_str();
+    const string close_tag = FString("</%s>", element).c_str();
+    const size_t start = xml.find(open_tag);
+    if(start == string::npos) return string();
+    const size_t end = xml.find(close_tag, start + open_tag.length());
+    if(end == string::npos) return string();
+    return xml.substr(start + open_tag.length(), end - start - open_tag.length());
+}
+
+/*----------------------------------------------------------------------------
+ * calculatePartChecksum
+ *----------------------------------------------------------------------------*/
+static string calculatePartChecksum (int fd, int64_t offset, int64_t size)
+{
+    string sha256_b64;
+    EVP_MD_CTX* context = EVP_MD_CTX_new();
+    const size_t buffer_size = 0x100000; // 1MB
+    unsigned char* buffer = new unsigned char [buffer_size];
+
+    if(context && EVP_DigestInit_ex(context, EVP_sha256(), NULL))
+    {
+        bool status = true;
+        int64_t bytes_remaining = size;
+        while(status && bytes_remaining > 0)
+        {
+            const size_t bytes_to_read = MIN(buffer_size, static_cast<size_t>(bytes_remaining));
+            const ssize_t bytes_read = pread(fd, buffer, bytes_to_read, offset + (size - bytes_remaining));
+            if(bytes_read <= 0 || !EVP_DigestUpdate(context, buffer, bytes_read))
+            {
+                status = false;
+            }
+            bytes_remaining -= bytes_read;
+        }
+
+        unsigned char hash[SHA256_DIGEST_LENGTH];
+        unsigned int hash_size = 0;
+        if(status && EVP_DigestFinal_ex(context, hash, &hash_size) && hash_size == SHA256_DIGEST_LENGTH)
+        {
+            sha256_b64 = StringLib::b64encode(hash, SHA256_DIGEST_LENGTH);
+        }
+    }
+
+    /* Clean Up */
+    if(context) EVP_MD_CTX_free(context);
+    delete [] buffer;
+
+    /* Check for Failed Checksum Calculation */
+    if(sha256_b64.empty())
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "Failed to calculate checksum of part at %ld", offset);
+    }
+
+    return sha256_b64;
+}
+
+/*----------------------------------------------------------------------------
+ * buildMultipartHeaders
+ *----------------------------------------------------------------------------*/
+static headers_t buildMultipartHeaders (const multipart_upload_t* upload, const char* verb, const char* query, const char* subresource, long content_length, const char* sha256_b64, bool checksum_algorithm)
+{
+    if(upload->region)
+    {
+        return buildWriteHeadersV4(upload->bucket, upload->key, upload->endpoint, upload->region, upload->credentials, content_length, sha256_b64, verb, query, checksum_algorithm);
+    }
+    return buildWriteHeadersV2(upload->bucket, upload->key, upload->credentials, content_length, verb, subresource);
+}
+
+/*----------------------------------------------------------------------------
+ * performMultipartRequest - initiate, complete, and abort requests
+ *----------------------------------------------------------------------------*/
+static long performMultipartRequest (const FString& url, headers_t headers, const char* verb, const string& body, string& response)
+{
+    /* Initialize cURL */
+    CURL* curl = curl_easy_init();
+    if(!curl)
+    {
+        throw RunTimeException(ERROR, RTE_FAILURE, "Failed to initialize cURL %s request", verb);
+    }
+
+    /* Set Options */
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, S3CurlIODriver::READ_TIMEOUT);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, S3CurlIODriver::CONNECTION_TIMEOUT);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, S3CurlIODriver::LOW_SPEED_TIME);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, S3CurlIODriver::LOW_SPEED_LIMIT);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, S3CurlIODriver::SSL_VERIFYPEER);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, S3CurlIODriver::SSL_VERIFYHOST);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curlWriteString);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+    curl_easy_setopt(curl, CURLOPT_SHARE, curlShare);
+    if(strcmp(verb, "POST") == 0)
+    {
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(body.length()));
+    }
+    else
+    {
+        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, verb);
+    }
+
+    /* Perform Request */
+    long http_code = 0;
+    bool rqst_complete = false;
+    int attempts = S3CurlIODriver::ATTEMPTS_PER_REQUEST;
+    while(!rqst_complete && (attempts-- > 0))
+    {
+        response.clear();
+        const CURLcode res = curl_easy_perform(curl);
+        if(res == CURLE_OK)
+        {
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+            rqst_complete = true;
+        }
+        else if(res == CURLE_OPERATION_TIMEDOUT)
+        {
+            mlog(ERROR, "cURL call timed out (%d) for %s request: %s", res, verb, url.c_str());
+        }
+        else
+        {
+            mlog(ERROR, "cURL call failed (%d) for %s request: %s", res, verb, url.c_str());
+            OsApi::performIOTimeout();
+        }
+    }
+
+    /* Clean Up */
+    curl_easy_cleanup(curl);
+
+    /* Check Completion */
+    if(!rqst_complete)
+    {
+        throw RunTimeException(ERROR, RTE_FAILURE, "cURL %s request for %s did not complete", verb, url.c_str());
+    }
+
+    return http_code;
+}
+
+/*----------------------------------------------------------------------------
+ * uploadPart
+ *----------------------------------------------------------------------------*/
+static void uploadPart (const multipart_upload_t* upload, upload_part_t& part)
+{
+    CURL* curl = NULL;
+    headers_t headers = NULL;
+    part_data_t data = {upload->fd, part.offset, part.size};
+    bool rqst_complete = false;
+
+    try
+    {
+        /* Calculate Checksum */
+        if(upload->withChecksum)
+        {
+            part.checksum = calculatePartChecksum(upload->fd, part.offset, part.size);
+        }
+
+        /* Build Headers */
+        const FString query("partNumber=%ld&uploadId=%s", part.number, upload->encodedUploadId.c_str());
+        const FString subresource("?partNumber=%ld&uploadId=%s", part.number, upload->uploadId.c_str());
+        headers = buildMultipartHeaders(upload, "PUT", query.c_str(), subresource.c_str(), part.size, !part.checksum.empty() ? part.checksum.c_str() : NULL, false);
+
+        /* Initialize cURL Request */
+        const FString url("%s?%s", upload->url.c_str(), query.c_str());
+        curl = initializeWriteRequest(url, headers, curlReadPart, &data);
+        curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(part.size));
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curlHeaderETag);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &part.etag);
+
+        /* Perform Request - parts are rewound and resent on a failed attempt */
+        int attempts = S3CurlIODriver::ATTEMPTS_PER_REQUEST;
+        while(!rqst_complete && (attempts-- > 0))
+        {
+            data.offset = part.offset;
+            data.remaining = part.size;
+            part.etag.clear();
+
+            const CURLcode res = curl_easy_perform(curl);
+            if(res == CURLE_OK)
+            {
+                long http_code = 0;
+                curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+                if(http_code < 300)
+                {
+                    rqst_complete = true;
+                }
+                else if(http_code >= 500)
+                {
+                    /* Server Errors (e.g. 503 SlowDown) are Retried */
+                    mlog(ERROR, "S3 put of part %ld returned http error <%ld>, retrying: %s", part.number, http_code, upload->key);
+                    OsApi::performIOTimeout();
+                }
+                else
+                {
+                    throw RunTimeException(ERROR, RTE_FAILURE, "S3 put of part %ld returned http error <%ld>", part.number, http_code);
+                }
+            }
+            else if(res == CURLE_OPERATION_TIMEDOUT)
+            {
+                mlog(ERROR, "cURL call timed out (%d) for part %ld of: %s", res, part.number, upload->key);
+            }
+            else
+            {
+                mlog(ERROR, "cURL call failed (%d) for part %ld of: %s", res, part.number, upload->key);
+                OsApi::performIOTimeout();
+            }
+        }
+
+        /* Check Completion */
+        if(!rqst_complete)
+        {
+            throw RunTimeException(ERROR, RTE_FAILURE, "cURL upload of part %ld for %s to S3 did not complete", part.number, upload->key);
+        }
+        else if(part.etag.empty())
+        {
+            throw RunTimeException(ERROR, RTE_FAILURE, "S3 put of part %ld did not return an ETag", part.number);
+        }
+    }
+    catch(const RunTimeException& e)
+    {
+        if(curl) curl_easy_cleanup(curl);
+        if(headers) curl_slist_free_all(headers);
+        throw; // rethrow after cleaning up
+    }
+
+    /* Clean Up */
+    curl_easy_cleanup(curl);
+    if(headers) curl_slist_free_all(headers);
+}
+
+/*----------------------------------------------------------------------------
+ * uploadPartThread - workers pull parts until none remain or one fails
+ *----------------------------------------------------------------------------*/
+static void* uploadPartThread (void* parm)
+{
+    multipart_upload_t* upload = static_cast<multipart_upload_t*>(parm);
+
+    while(true)
+    {
+        /* Get Next Part */
+        upload_part_t* part = NULL;
+        upload->mutex.lock();
+        {
+            if(!upload->failed && upload->nextPart < upload->parts.size())
+            {
+                part = &upload->parts[upload->nextPart++];
+            }
+        }
+        upload->mutex.unlock();
+        if(!part) break;
+
+        /* Upload Part */
+        try
+        {
+            uploadPart(upload, *part);
+        }
+        catch(const RunTimeException& e)
+        {
+            upload->mutex.lock();
+            {
+                if(!upload->failed)
+                {
+                    upload->failed = true;
+                    upload->error = e.what();
+                }
+            }
+            upload->mutex.unlock();
+        }
+    }
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * abortMultipartUpload - releases parts already stored by S3
+ *----------------------------------------------------------------------------*/
+static void abortMultipartUpload (const multipart_upload_t* upload)
+{
+    headers_t headers = NULL;
+    try
+    {
+        const FString query("uploadId=%s", upload->encodedUploadId.c_str());
+        const FString subresource("?uploadId=%s", upload->uploadId.c_str());
+        headers = buildMultipartHeaders(upload, "DELETE", query.c_str(), subresource.c_str(), 0, NULL, false);
+        string response;
+        const long http_code = performMultipartRequest(FString("%s?%s", upload->url.c_str(), query.c_str()), headers, "DELETE", string(), response);
+        if(http_code >= 300)
+        {
+            throw RunTimeException(ERROR, RTE_FAILURE, "http error <%ld>", http_code);
+        }
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(CRITICAL, "Failed to abort multipart upload %s of %s: %s", upload->uploadId.c_str(), upload->key, e.what());
+    }
+    if(headers) curl_slist_free_all(headers);
+}
+
 /******************************************************************************
  * STATIC DATA
  ******************************************************************************/
@@ -914,33 +1361,9 @@ int64_t S3CurlIODriver::put (const char* filename, const char* bucket, const cha
         const char* key_ptr = key;
         if(key_ptr[0] == '/') key_ptr++;
 
-        /* Extract Region from Endpoint (expects "s3.<region>.<domain>") */
-        const char* region = NULL;
+        /* Extract Region from Endpoint */
         char region_buf[64];
-        const int s3_prefix_len = 3;
-        if(strncmp(endpoint, "s3.", s3_prefix_len) == 0)
-        {
-            const char* region_start = endpoint + s3_prefix_len;
-            const char* region_end = strchr(region_start, '.');
-            if(region_end)
-            {
-                const int region_len = region_end - region_start;
-                if(region_len > 0 && region_len < static_cast<int>(sizeof(region_buf)))
-                {
-                    memcpy(region_buf, region_start, region_len);
-                    region_buf[region_len] = '\0';
-                    region = region_buf;
-                }
-                else
-                {
-                    throw RunTimeException(ERROR, RTE_FAILURE, "Invalid region in endpoint: %s", endpoint);
-                }
-            }
-            else
-            {
-                throw RunTimeException(ERROR, RTE_FAILURE, "Invalid domain in endpoint: %s", endpoint);
-            }
-        }
+        const char* region = extractRegion(endpoint, region_buf, sizeof(region_buf));
 
         /* Calculate Checksum */
         string sha256_b64;
@@ -955,7 +1378,7 @@ int64_t S3CurlIODriver::put (const char* filename, const char* bucket, const cha
         else        headers = buildWriteHeadersV2(bucket, key_ptr, credentials, content_length);
 
         /* Build URL */
-        const FString url("https://%s/%s/%s", endpoint, bucket, key_ptr);
+        const FString url = buildWriteUrl(endpoint, bucket, key_ptr);
 
         /* Initialize cURL Request */
         curl = initializeWriteRequest(url, headers, curlReadFile, &data);
@@ -1018,6 +1441,149 @@ int64_t S3CurlIODriver::put (const char* filename, const char* bucket, const cha
     return data.size;
 }
 
+/*----------------------------------------------------------------------------
+ * putMultipart - file
+ *----------------------------------------------------------------------------*/
+int64_t S3CurlIODriver::putMultipart (const char* filename, const char* bucket, const char* key, const char* endpoint, const CredentialStore::Credential* credentials, bool with_checksum, int64_t part_size, int concurrency)
+{
+    multipart_upload_t upload;
+    upload.fd = -1;
+    upload.nextPart = 0;
+    upload.failed = false;
+    headers_t headers = NULL;
+    int64_t content_length = 0;
+
+    try
+    {
+        /* Open File */
+        upload.fd = open(filename, O_RDONLY);
+        if(upload.fd < 0)
+        {
+            char err_buf[256];
+            throw RunTimeException(ERROR, RTE_FAILURE, "Failed to open source file %s for reading: %s", filename, strerror_r(errno, err_buf, sizeof(err_buf)));
+        }
+
+        /* Get Size of File */
+        struct stat file_stat;
+        if(fstat(upload.fd, &file_stat) != 0)
+        {
+            char err_buf[256];
+            throw RunTimeException(ERROR, RTE_FAILURE, "Failed to stat source file %s: %s", filename, strerror_r(errno, err_buf, sizeof(err_buf)));
+        }
+        content_length = file_stat.st_size;
+        if(content_length == 0)
+        {
+            throw RunTimeException(ERROR, RTE_RESOURCE_EMPTY, "File is empty: %s", filename);
+        }
+
+        /* Massage Key */
+        const char* key_ptr = key;
+        if(key_ptr[0] == '/') key_ptr++;
+
+        /* Extract Region from Endpoint */
+        char region_buf[64];
+        const char* region = extractRegion(endpoint, region_buf, sizeof(region_buf));
+
+        /* Populate Upload */
+        upload.bucket = bucket;
+        upload.key = key_ptr;
+        upload.endpoint = endpoint;
+        upload.region = region;
+        upload.credentials = credentials;
+        upload.withChecksum = with_checksum && region;
+        upload.url = buildWriteUrl(endpoint, bucket, key_ptr).c_str();
+        if(with_checksum && !region)
+        {
+            mlog(WARNING, "Skipping checksum calculation for v2 header write");
+        }
+
+        /* Size Parts */
+        part_size = MAX(part_size, MIN_PART_SIZE);
+        if(((content_length + part_size - 1) / part_size) > MAX_PARTS)
+        {
+            part_size = (content_length + MAX_PARTS - 1) / MAX_PARTS;
+        }
+        for(int64_t offset = 0; offset < content_length; offset += part_size)
+        {
+            const upload_part_t part = {
+                .number = static_cast<long>(upload.parts.size() + 1),
+                .offset = offset,
+                .size = MIN(part_size, content_length - offset),
+                .etag = "",
+                .checksum = ""
+            };
+            upload.parts.push_back(part);
+        }
+        concurrency = MAX(1, MIN(concurrency, MIN(MAX_UPLOAD_CONCURRENCY, static_cast<int>(upload.parts.size()))));
+
+        /* Create Multipart Upload */
+        string response;
+        headers = buildMultipartHeaders(&upload, "POST", "uploads=", "?uploads", 0, NULL, upload.withChecksum);
+        const long create_code = performMultipartRequest(FString("%s?uploads", upload.url.c_str()), headers, "POST", string(), response);
+        curl_slist_free_all(headers);
+        headers = NULL;
+        if(create_code >= 300)
+        {
+            throw RunTimeException(ERROR, RTE_FAILURE, "S3 create multipart upload returned http error <%ld>", create_code);
+        }
+        upload.uploadId = getXmlElement(response, "UploadId");
+        if(upload.uploadId.empty())
+        {
+            throw RunTimeException(ERROR, RTE_FAILURE, "S3 create multipart upload did not return an upload id");
+        }
+        upload.encodedUploadId = uriEncode(upload.uploadId);
+
+        /* Upload Parts */
+        vector<Thread*> workers;
+        for(int i = 0; i < concurrency; i++)
+        {
+            workers.push_back(new Thread(uploadPartThread, &upload));
+        }
+        for(Thread* worker: workers)
+        {
+            delete worker; // joins
+        }
+        if(upload.failed)
+        {
+            throw RunTimeException(ERROR, RTE_FAILURE, "Failed to upload parts of %s: %s", key_ptr, upload.error.c_str());
+        }
+
+        /* Build Part List */
+        string part_list("<CompleteMultipartUpload xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">");
+        for(const upload_part_t& part: upload.parts)
+        {
+            part_list += FString("<Part><PartNumber>%ld</PartNumber><ETag>%s</ETag>", part.number, part.etag.c_str()).c_str();
+            if(!part.checksum.empty()) part_list += FString("<ChecksumSHA256>%s</ChecksumSHA256>", part.checksum.c_str()).c_str();
+            part_list += "</Part>";
+        }
+        part_list += "</CompleteMultipartUpload>";
+
+        /* Complete Multipart Upload - errors can be returned in the body of a 200 response */
+        const FString query("uploadId=%s", upload.encodedUploadId.c_str());
+        const FString subresource("?uploadId=%s", upload.uploadId.c_str());
+        headers = buildMultipartHeaders(&upload, "POST", query.c_str(), subresource.c_str(), part_list.length(), NULL, false);
+        const long complete_code = performMultipartRequest(FString("%s?%s", upload.url.c_str(), query.c_str()), headers, "POST", part_list, response);
+        if(complete_code >= 300 || response.find("<Error>") != string::npos)
+        {
+            throw RunTimeException(ERROR, RTE_FAILURE, "S3 complete multipart upload failed <%ld>: %s", complete_code, getXmlElement(response, "Message").c_str());
+        }
+    }
+    catch(const RunTimeException& e)
+    {
+        if(headers) curl_slist_free_all(headers);
+        if(!upload.uploadId.empty()) abortMultipartUpload(&upload);
+        if(upload.fd >= 0) close(upload.fd);
+        throw; // rethrow after cleaning up
+    }
+
+    /* Clean Up */
+    if(headers) curl_slist_free_all(headers);
+    close(upload.fd);
+
+    /* Return Success */
+    return content_length;
+}
+
 /*----------------------------------------------------------------------------
  * probe - HEAD request to retrieve object size
  *----------------------------------------------------------------------------*/
@@ -1280,7 +1846,7 @@ int S3CurlIODriver::luaRead(lua_State* L)
 }
 
 /*----------------------------------------------------------------------------
- * luaUpload - s3upload(<bucket>, <key>, <filename>, [<endpoint>], [<identity>])
+ * luaUpload - s3upload(<bucket>, <key>, <filename>, [<endpoint>], [<identity>], [<with_checksum>], [<part_size_mb>])
  *----------------------------------------------------------------------------*/
 int S3CurlIODriver::luaUpload(lua_State* L)
 {
@@ -1296,12 +1862,21 @@ int S3CurlIODriver::luaUpload(lua_State* L)
         const char* endpoint    = LuaObject::getLuaString(L, 4, true, default_endpoint.c_str());
         const char* identity    = LuaObject::getLuaString(L, 5, true, S3CurlIODriver::DEFAULT_IDENTITY);
         const bool with_checksum = LuaObject::getLuaBoolean(L, 6, true, false);
+        const long part_size_mb = LuaObject::getLuaInteger(L, 7, true, 0);
 
         /* Get Credentials */
         const CredentialStore::Credential credentials = CredentialStore::get(identity);
 
         /* Make Request */
-        const int64_t upload_size = put(filename, bucket, key, endpoint, &credentials, with_checksum);
+        int64_t upload_size = 0;
+        if(part_size_mb > 0)
+        {
+            upload_size = putMultipart(filename, bucket, key, endpoint, &credentials, with_checksum, part_size_mb * 0x100000L, SystemConfig::settings().s3UploadConcurrency.value);
+        }
+        else
+        {
+            upload_size = put(filename, bucket, key, endpoint, &credentials, with_checksum);
+        }
 
         /* Push Contents */
         if(upload_size > 0)
@@ -59,6 +59,9 @@ class S3CurlIODriver: public Asset::IODriver
         static const long ATTEMPTS_PER_REQUEST = 3;
         static const long SSL_VERIFYPEER = 0;
         static const long SSL_VERIFYHOST = 0;
+        static const int64_t MIN_PART_SIZE = 0x500000; // 5MB, smallest part S3 accepts
+        static const int64_t MAX_PARTS = 10000;
+        static const int MAX_UPLOAD_CONCURRENCY = 32;
         static const char* DEFAULT_IDENTITY;
         static const char* CURL_FORMAT;
 
@@ -92,6 +95,12 @@ class S3CurlIODriver: public Asset::IODriver
                                              const char* bucket, const char* key, const char* endpoint,
                                              const CredentialStore::Credential* credentials, bool with_checksum=false);
 
+        // multipart file PUT - parts read directly from file and sent concurrently
+        static int64_t      putMultipart    (const char* filename,
+                                             const char* bucket, const char* key, const char* endpoint,
+                                             const CredentialStore::Credential* credentials, bool with_checksum,
+                                             int64_t part_size, int concurrency);
+
         // HEAD - return size of object in bytes
         static int64_t      probe           (const char* bucket, const char* key, const char* endpoint,
                                              const CredentialStore::Credential* credentials);
@@ -0,0 +1,81 @@
+local runner = require("test_executive")
+local srcfile, dirpath = runner.srcscript()
+
+-- Requirements --
+
+if not os.execute("python3 --version > /dev/null 2>&1") then
+    return runner.skip()
+end
+
+-- Setup --
+
+local port = 10091
+local endpoint = string.format("http://127.0.0.1:%d", port)
+local bucket = "local-bucket"
+local server_dir = "/tmp/s3_local"
+local test_file = "/tmp/s3_local.bin"
+
+os.execute(string.format("rm -rf %s && mkdir -p %s", server_dir, server_dir))
+os.execute(string.format("python3 %ss3_local_server.py %d %s &", dirpath, port, server_dir))
+
+local server_pid = nil
+for _=1,10 do
+    local f = io.open(server_dir.."/ready", "r")
+    if f then
+        server_pid = f:read("a")
+        f:close()
+        if server_pid and #server_pid > 0 then break end
+    end
+    sys.wait(1)
+end
+if not server_pid then
+    print("Unable to start local S3 endpoint")
+    return runner.skip()
+end
+
+runner.assert(aws.csput("s3_local", {accessKeyId="1234", secretAccessKey="5678", sessionToken="abcdefg", expiration="2099-01-01 00:00:00+00:00"}), "failed to store local credentials")
+
+-- two parts at the minimum part size
+local f = io.open(test_file, "w")
+for i=1,120000 do
+    f:write(string.format("%08d: the quick brown fox jumps over the lazy dog\n", i))
+end
+f:close()
+
+local function readall (filename)
+    local fp = io.open(filename, "rb")
+    if not fp then return nil end
+    local contents = fp:read("a")
+    fp:close()
+    return contents
+end
+
+-- Self Test --
+
+runner.unittest("S3 local multipart upload (slow down)", function()
+    local key = "data/slowdown.bin"
+    local status = aws.s3upload(bucket, key, test_file, endpoint, "s3_local", false, 5)
+    runner.assert(status == true, "failed to upload after 503 responses")
+    local uploaded = readall(string.format("%s/%s/%s", server_dir, bucket, key))
+    runner.assert(uploaded ~= nil and uploaded == readall(test_file), "uploaded object does not match source file")
+end)
+
+runner.unittest("S3 local multipart upload (unavailable)", function()
+    local status = aws.s3upload(bucket, "data/unavailable.bin", test_file, endpoint, "s3_local", false, 5)
+    runner.assert(status == false, "should have failed once retries were exhausted")
+end)
+
+runner.unittest("S3 local multipart upload (forbidden)", function()
+    local status = aws.s3upload(bucket, "data/forbidden.bin", test_file, endpoint, "s3_local", false, 5)
+    runner.assert(status == false, "should have failed on a 403 response")
+end)
+
+-- Clean Up --
+
+os.execute("kill "..server_pid)
+os.execute("rm -rf "..server_dir)
+os.remove(test_file)
+
+-- Report Results --
+
+runner.report()
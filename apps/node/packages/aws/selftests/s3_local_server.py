@@ -0,0 +1,107 @@
+#
+# Minimal S3-compatible endpoint for the s3_local.lua selftest
+#
+#   python3 s3_local_server.py <port> <directory>
+#
+# Supports the multipart upload requests issued by S3CurlIODriver and writes
+# completed objects to <directory>/<bucket>/<key>. Faults are injected by key:
+#   - keys containing "slowdown" get a 503 SlowDown on the first attempt of each part
+#   - keys containing "unavailable" get a 503 on every attempt of each part
+#   - keys containing "forbidden" get a 403 on every attempt of each part
+# Once listening, the process id is written to <directory>/ready
+#
+
+import os
+import sys
+import threading
+import uuid
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import urlparse, parse_qs
+
+uploads = {}        # upload id -> {part number: bytes}
+attempts = {}       # (upload id, part number) -> number of attempts
+lock = threading.Lock()
+
+class S3Handler(BaseHTTPRequestHandler):
+
+    protocol_version = "HTTP/1.1" # needed for Expect: 100-continue
+
+    def respond(self, code, body=b"", headers=None):
+        self.send_response(code)
+        for name, value in (headers or {}).items():
+            self.send_header(name, value)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def error(self, code, s3_code, message):
+        body = f"<?xml version=\"1.0\" encoding=\"UTF-8\"?><Error><Code>{s3_code}</Code><Message>{message}</Message></Error>"
+        self.respond(code, body.encode())
+
+    def body(self):
+        return self.rfile.read(int(self.headers.get("Content-Length", 0)))
+
+    def target(self):
+        url = urlparse(self.path)
+        return url.path.lstrip("/"), parse_qs(url.query, keep_blank_values=True)
+
+    def do_POST(self):
+        path, query = self.target()
+        data = self.body()
+        if "uploads" in query:
+            upload_id = uuid.uuid4().hex
+            with lock:
+                uploads[upload_id] = {}
+            body = f"<?xml version=\"1.0\" encoding=\"UTF-8\"?><InitiateMultipartUploadResult><Key>{path}</Key><UploadId>{upload_id}</UploadId></InitiateMultipartUploadResult>"
+            self.respond(200, body.encode())
+        elif "uploadId" in query:
+            upload_id = query["uploadId"][0]
+            with lock:
+                parts = uploads.pop(upload_id, None)
+            if parts is None:
+                self.error(404, "NoSuchUpload", "upload does not exist")
+                return
+            numbers = [int(n.split(b"</PartNumber>")[0]) for n in data.split(b"<PartNumber>")[1:]]
+            filename = os.path.join(sys.argv[2], path)
+            os.makedirs(os.path.dirname(filename), exist_ok=True)
+            with open(filename, "wb") as f:
+                for number in numbers:
+                    f.write(parts[number])
+            body = f"<?xml version=\"1.0\" encoding=\"UTF-8\"?><CompleteMultipartUploadResult><Key>{path}</Key></CompleteMultipartUploadResult>"
+            self.respond(200, body.encode())
+        else:
+            self.error(400, "InvalidRequest", "unsupported request")
+
+    def do_PUT(self):
+        path, query = self.target()
+        data = self.body()
+        if "partNumber" not in query or "uploadId" not in query:
+            self.error(400, "InvalidRequest", "unsupported request")
+            return
+        upload_id = query["uploadId"][0]
+        number = int(query["partNumber"][0])
+        with lock:
+            attempt = attempts.get((upload_id, number), 0) + 1
+            attempts[(upload_id, number)] = attempt
+        if "forbidden" in path:
+            self.error(403, "AccessDenied", "access denied")
+        elif "unavailable" in path or ("slowdown" in path and attempt == 1):
+            self.error(503, "SlowDown", "please reduce your request rate")
+        else:
+            with lock:
+                uploads[upload_id][number] = data
+            self.respond(200, headers={"ETag": f"\"{upload_id}-{number}\""})
+
+    def do_DELETE(self):
+        _, query = self.target()
+        with lock:
+            uploads.pop(query.get("uploadId", [""])[0], None)
+        self.respond(204)
+
+    def log_message(self, format, *args):
+        pass
+
+server = ThreadingHTTPServer(("127.0.0.1", int(sys.argv[1])), S3Handler)
+with open(os.path.join(sys.argv[2], "ready"), "w") as f:
+    f.write(str(os.getpid()))
+server.serve_forever()
@@ -33,6 +33,8 @@
  * INCLUDES
  ******************************************************************************/
 
+#include <new>
+
 #include "CcsdsRecordDispatcher.h"
 #include "CcsdsRecord.h"
 #include "OsApi.h"
@@ -111,3 +113,12 @@ RecordObject* CcsdsRecordDispatcher::createRecord (unsigned char* buffer, int si
 {
     return new CcsdsRecordInterface(buffer, size);
 }
+
+/*----------------------------------------------------------------------------
+ * createRecordView
+ *----------------------------------------------------------------------------*/
+RecordObject* CcsdsRecordDispatcher::createRecordView (unsigned char* buffer, int size, view_t* view)
+{
+    static_assert(sizeof(CcsdsRecordInterface) <= VIEW_SIZE);
+    return new (view->mem) CcsdsRecordInterface(buffer, size);
+}
@@ -63,6 +63,7 @@ class CcsdsRecordDispatcher: public RecordDispatcher
                         ~CcsdsRecordDispatcher  (void) override;
 
         RecordObject*   createRecord            (unsigned char* buffer, int size) override;
+        RecordObject*   createRecordView        (unsigned char* buffer, int size, view_t* view) override;
 };
 
 #endif  /* __ccsds_record_dispatcher__ */
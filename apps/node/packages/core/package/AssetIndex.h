@@ -36,17 +36,34 @@
  * INCLUDES
  ******************************************************************************/
 
+#include <algorithm>
+#include <cmath>
 #include "OsApi.h"
 #include "Asset.h"
 #include "EventLib.h"
 #include "Dictionary.h"
 #include "List.h"
 #include "Ordering.h"
+#include "StringLib.h"
 #include "LuaObject.h"
 
 /******************************************************************************
  * ASSET INDEX CLASS
  ******************************************************************************/
+/*
+ * AssetIndex - index of the spans of an asset's resources
+ *
+ *  build() bulk loads every resource into a packed tree: the resources are
+ *  ordered by sort-tile-recursive packing on the centers of their spans and
+ *  grouped PACKED_FANOUT at a time into leaf nodes, which are in turn grouped
+ *  PACKED_FANOUT at a time into the level above, up to a single root.  The
+ *  nodes live in flat arrays, level by level, so the children of a node are
+ *  adjacent in memory and are found by arithmetic instead of pointers.  The
+ *  packed tree can be saved to and loaded from a file.
+ *
+ *  Resources added after the packed tree is built go into a pointer based
+ *  tree that is searched alongside it; pack() folds them into the packed tree.
+ */
 
 // NOLINTBEGIN(misc-no-recursion)
 
@@ -60,6 +77,10 @@ class AssetIndex: public LuaObject
          *--------------------------------------------------------------------*/
 
         static const int DEFAULT_THRESHOLD = 8;
+        static const int PACKED_FANOUT = 16;
+        static const uint64_t PACKED_MAGIC = 0x3158444950524C53; // "SLRPIDX1"
+        static const uint32_t PACKED_VERSION = 2;
+        static const int PACKED_ASSET_NAME_LEN = 64;
 
         /*--------------------------------------------------------------------
          * Types
@@ -87,6 +108,20 @@ class AssetIndex: public LuaObject
             int             depth;      // depth of tree at this node
         } node_t;
 
+        typedef struct {
+            uint64_t        magic;      // PACKED_MAGIC
+            uint32_t        version;    // PACKED_VERSION
+            uint32_t        spansize;   // sizeof(T), rejects files written by another index type
+            uint32_t        fanout;     // PACKED_FANOUT
+            uint32_t        levels;     // number of node levels
+            int64_t         numspans;   // resources in the spans list
+            int64_t         numentries; // resources in the leaf entries
+            int64_t         numnodes;   // nodes across all levels
+            int64_t         numresources;   // resources in the asset when saved
+            uint64_t        resourcehash;   // hash of the asset's resource names, in order
+            char            assetname[PACKED_ASSET_NAME_LEN]; // asset the index was built from (truncated)
+        } packed_header_t;
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
@@ -99,6 +134,10 @@ class AssetIndex: public LuaObject
         virtual bool            add             (const T& span); // NOT thread safe
         virtual Ordering<int>*  query           (const T& span);
         virtual void            display         (void);
+        virtual void            pack            (void);
+        virtual void            save            (const char* filename);
+        virtual void            load            (const char* filename);
+        virtual int             dimensions      (void);
 
         virtual void            split           (node_t* node, T& lspan, T& rspan) = 0;
         virtual bool            isleft          (node_t* node, const T& span) = 0;
@@ -108,10 +147,14 @@ class AssetIndex: public LuaObject
         virtual T               attr2span       (Dictionary<double>* attr, bool* provided=NULL) = 0;
         virtual T               luatable2span   (lua_State* L, int parm) = 0;
         virtual void            displayspan     (const T& span) = 0;
+        virtual double          center          (const T& span, int dim) = 0;
 
         static int              luaAdd          (lua_State* L);
         static int              luaQuery        (lua_State* L);
         static int              luaDisplay      (lua_State* L);
+        static int              luaPack         (lua_State* L);
+        static int              luaSave         (lua_State* L);
+        static int              luaLoad         (lua_State* L);
 
     private:
 
@@ -119,7 +162,10 @@ class AssetIndex: public LuaObject
          * Methods
          *--------------------------------------------------------------------*/
 
-        void        buildtree       (node_t* root, int* maxdepth);
+        uint64_t    resourcehash    (void);
+        void        packslice       (int32_t* order, long count, const double* centers, int dim);
+        void        packlevels      (void);
+        void        querypacked     (const T& span, vector<unsigned long>& results);
         void        updatenode      (int i, node_t** node, int* maxdepth);
         void        balancenode     (node_t** root);
         void        querynode       (const T& span, node_t* curr, Ordering<int>* list);
@@ -133,9 +179,14 @@ class AssetIndex: public LuaObject
          *--------------------------------------------------------------------*/
 
         Asset&      asset;
-        List<T>     spans; // parallels asset resource list
-        int32_t     threshold;
-        node_t*     tree;
+        List<T>             spans; // parallels asset resource list
+        int32_t             threshold;
+        node_t*             tree; // resources added since the last pack
+
+        vector<T>           entrySpans;     // leaf entries in packed order
+        vector<int32_t>     entryIndex;     // resource index of each leaf entry
+        vector<T>           nodeSpans;      // packed nodes, leaf level first and root last
+        vector<int64_t>     levelOffsets;   // start of each level in nodeSpans, plus the end
 };
 
 /******************************************************************************
@@ -177,7 +228,7 @@ AssetIndex<T>::~AssetIndex (void)
 template <class T>
 void AssetIndex<T>::build (void)
 {
-    /* Build Tree Node */
+    /* Populate Resource Spans */
     spans.clear();
     for(int i = 0; i < asset.size(); i++)
     {
@@ -186,22 +237,12 @@ void AssetIndex<T>::build (void)
         if(provided)
         {
             /* Add to Global Resource List */
-            const int index = spans.add(span);
-
-            /* Create Tree Node */
-            if(tree == NULL) tree = newnode(span);
-
-            /* Update Tree Span */
-            tree->span = combine(tree->span, span);
-
-            /* Update Tree Resource List */
-            tree->ril->add(index);
+            spans.add(span);
         }
     }
 
-    /* Build Tree Structure */
-    int maxdepth = 0;
-    buildtree(tree, &maxdepth);
+    /* Bulk Load Packed Tree */
+    pack();
 }
 
 /*----------------------------------------------------------------------------
@@ -238,7 +279,17 @@ template <class T>
 Ordering<int>* AssetIndex<T>::query (const T& span)
 {
     Ordering<int>* list = new Ordering<int>();
+
+    /* Query Packed Tree */
+    vector<unsigned long> results;
+    querypacked(span, results);
+    std::sort(results.begin(), results.end());
+    const vector<int> indexes(results.begin(), results.end());
+    list->load(results.data(), indexes.data(), static_cast<long>(results.size()));
+
+    /* Query Resources Added Since Pack */
     querynode(span, tree, list);
+
     return list;
 }
 
@@ -248,9 +299,232 @@ Ordering<int>* AssetIndex<T>::query (const T& span)
 template <class T>
 void AssetIndex<T>::display (void)
 {
+    if(!levelOffsets.empty())
+    {
+        print2term("packed: %ld resources, %ld nodes, %ld levels ", static_cast<long>(entryIndex.size()), static_cast<long>(nodeSpans.size()), static_cast<long>(levelOffsets.size() - 1));
+        displayspan(nodeSpans.back());
+        print2term("\n\n");
+    }
     displaynode(tree);
 }
 
+/*----------------------------------------------------------------------------
+ * pack - bulk load every resource into the packed tree
+ *----------------------------------------------------------------------------*/
+template <class T>
+void AssetIndex<T>::pack (void)
+{
+    const long num_spans = spans.length();
+    const int dims = dimensions();
+
+    /* Calculate Centers */
+    vector<double> centers(num_spans * dims);
+    for(long i = 0; i < num_spans; i++)
+    {
+        for(int d = 0; d < dims; d++)
+        {
+            centers[(i * dims) + d] = center(spans[i], d);
+        }
+    }
+
+    /* Order Resources */
+    vector<int32_t> order(num_spans);
+    for(long i = 0; i < num_spans; i++) order[i] = static_cast<int32_t>(i);
+    packslice(order.data(), num_spans, centers.data(), 0);
+
+    /* Populate Leaf Entries */
+    entryIndex = order;
+    entrySpans.resize(num_spans);
+    for(long i = 0; i < num_spans; i++)
+    {
+        entrySpans[i] = spans[entryIndex[i]];
+    }
+
+    /* Build Node Levels */
+    packlevels();
+
+    /* Pointer Tree Now Only Holds Resources Added After Pack */
+    deletenode(tree);
+    tree = NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * save - write the packed tree to a file
+ *
+ *  Note:   the file is in native byte order and is only meaningful for the
+ *          same asset and index type it was written from; the asset's name,
+ *          resource count, and a hash of its resource names are recorded so
+ *          that load() can reject it for any other asset
+ *----------------------------------------------------------------------------*/
+template <class T>
+void AssetIndex<T>::save (const char* filename)
+{
+    /* Fold In Resources Added Since Pack */
+    if(tree) pack();
+
+    /* Flatten Spans */
+    vector<T> all_spans(spans.length());
+    for(int i = 0; i < spans.length(); i++) all_spans[i] = spans[i];
+
+    /* Build Header */
+    packed_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = PACKED_MAGIC;
+    header.version = PACKED_VERSION;
+    header.spansize = sizeof(T);
+    header.fanout = PACKED_FANOUT;
+    header.levels = levelOffsets.empty() ? 0 : static_cast<uint32_t>(levelOffsets.size() - 1);
+    header.numspans = static_cast<int64_t>(all_spans.size());
+    header.numentries = static_cast<int64_t>(entryIndex.size());
+    header.numnodes = static_cast<int64_t>(nodeSpans.size());
+    header.numresources = asset.size();
+    header.resourcehash = resourcehash();
+    StringLib::copy(header.assetname, asset.getName(), PACKED_ASSET_NAME_LEN);
+
+    /* Write File */
+    FILE* fp = fopen(filename, "wb");
+    if(fp == NULL)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to open %s for writing", filename);
+    }
+
+    bool status = (fwrite(&header, sizeof(header), 1, fp) == 1);
+    status = status && (fwrite(all_spans.data(), sizeof(T), all_spans.size(), fp) == all_spans.size());
+    status = status && (fwrite(entryIndex.data(), sizeof(int32_t), entryIndex.size(), fp) == entryIndex.size());
+    status = status && (fwrite(nodeSpans.data(), sizeof(T), nodeSpans.size(), fp) == nodeSpans.size());
+    status = status && (fwrite(levelOffsets.data(), sizeof(int64_t), levelOffsets.size(), fp) == levelOffsets.size());
+    status = (fclose(fp) == 0) && status;
+
+    if(!status)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to write %s", filename);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * load - replace the index with a packed tree read from a file
+ *----------------------------------------------------------------------------*/
+template <class T>
+void AssetIndex<T>::load (const char* filename)
+{
+    FILE* fp = fopen(filename, "rb");
+    if(fp == NULL)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to open %s for reading", filename);
+    }
+
+    /* Read and Check Header */
+    packed_header_t header;
+    const bool valid = (fread(&header, sizeof(header), 1, fp) == 1) &&
+                       (header.magic == PACKED_MAGIC) &&
+                       (header.version == PACKED_VERSION) &&
+                       (header.spansize == sizeof(T)) &&
+                       (header.fanout == PACKED_FANOUT) &&
+                       (header.numspans >= 0) && (header.numspans <= asset.size()) &&
+                       (header.numentries >= 0) && (header.numentries <= header.numspans) &&
+                       (header.numnodes >= 0) && (header.numnodes <= header.numentries) &&
+                       (header.levels <= header.numnodes);
+    if(!valid)
+    {
+        fclose(fp);
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid packed index header in %s", filename);
+    }
+
+    /* Check Asset Identity */
+    char asset_name[PACKED_ASSET_NAME_LEN];
+    StringLib::copy(asset_name, asset.getName(), PACKED_ASSET_NAME_LEN);
+    header.assetname[PACKED_ASSET_NAME_LEN - 1] = '\0';
+    if(!StringLib::match(header.assetname, asset_name))
+    {
+        fclose(fp);
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "packed index in %s was built from asset %s, not %s", filename, header.assetname, asset_name);
+    }
+    if((header.numresources != asset.size()) || (header.resourcehash != resourcehash()))
+    {
+        fclose(fp);
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "packed index in %s is out of date with the resources of asset %s", filename, asset_name);
+    }
+
+    /* Read Arrays */
+    vector<T> file_spans(header.numspans);
+    vector<int32_t> file_index(header.numentries);
+    vector<T> file_nodes(header.numnodes);
+    vector<int64_t> file_offsets(header.levels > 0 ? header.levels + 1 : 0);
+    bool status = (fread(file_spans.data(), sizeof(T), file_spans.size(), fp) == file_spans.size());
+    status = status && (fread(file_index.data(), sizeof(int32_t), file_index.size(), fp) == file_index.size());
+    status = status && (fread(file_nodes.data(), sizeof(T), file_nodes.size(), fp) == file_nodes.size());
+    status = status && (fread(file_offsets.data(), sizeof(int64_t), file_offsets.size(), fp) == file_offsets.size());
+    fclose(fp);
+    if(!status)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "truncated packed index in %s", filename);
+    }
+
+    /* Check Structure */
+    for(const int32_t index: file_index)
+    {
+        if(index < 0 || index >= header.numspans)
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid resource index %d in %s", index, filename);
+        }
+    }
+    int64_t children = header.numentries;
+    for(uint32_t level = 0; level < header.levels; level++)
+    {
+        const int64_t count = (children + PACKED_FANOUT - 1) / PACKED_FANOUT;
+        if(file_offsets[level + 1] - file_offsets[level] != count || (level == 0 && file_offsets[0] != 0))
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid packed index level %u in %s", level, filename);
+        }
+        children = count;
+    }
+    if(header.levels > 0 && (children != 1 || file_offsets[header.levels] != header.numnodes))
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid packed index root in %s", filename);
+    }
+
+    /* Replace Index */
+    spans.clear();
+    for(const T& span: file_spans) spans.add(span);
+    entryIndex = std::move(file_index);
+    nodeSpans = std::move(file_nodes);
+    levelOffsets = std::move(file_offsets);
+    entrySpans.resize(entryIndex.size());
+    for(size_t i = 0; i < entryIndex.size(); i++)
+    {
+        entrySpans[i] = spans[entryIndex[i]];
+    }
+    deletenode(tree);
+    tree = NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * resourcehash - FNV-1a over the asset's resource names, in order
+ *----------------------------------------------------------------------------*/
+template <class T>
+uint64_t AssetIndex<T>::resourcehash (void)
+{
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for(int i = 0; i < asset.size(); i++)
+    {
+        for(const char* c = asset[i].name; *c != '\0'; c++)
+        {
+            h = (h ^ static_cast<uint8_t>(*c)) * 0x100000001B3ULL;
+        }
+        h = (h ^ 0xFF) * 0x100000001B3ULL; // separates names
+    }
+    return h;
+}
+
+/*----------------------------------------------------------------------------
+ * dimensions - number of span centers used to order the packed tree
+ *----------------------------------------------------------------------------*/
+template <class T>
+int AssetIndex<T>::dimensions (void)
+{
+    return 1;
+}
+
 /*----------------------------------------------------------------------------
  * luaAdd - :add(<attributes>)
  *----------------------------------------------------------------------------*/
@@ -324,6 +598,92 @@ int AssetIndex<T>::luaQuery (lua_State* L)
     return returnLuaStatus(L, status, 2);
 }
 
+/*----------------------------------------------------------------------------
+ * luaPack - :pack()
+ *----------------------------------------------------------------------------*/
+template <class T>
+int AssetIndex<T>::luaPack (lua_State* L)
+{
+    bool status = false;
+
+    try
+    {
+        /* Get Self */
+        AssetIndex<T>* lua_obj = reinterpret_cast<AssetIndex<T>*>(getLuaSelf(L, 1));
+
+        /* Pack Tree */
+        lua_obj->pack();
+
+        /* Set Status */
+        status = true;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error packing: %s", e.what());
+    }
+
+    /* Return Status */
+    return returnLuaStatus(L, status);
+}
+
+/*----------------------------------------------------------------------------
+ * luaSave - :save(<filename>)
+ *----------------------------------------------------------------------------*/
+template <class T>
+int AssetIndex<T>::luaSave (lua_State* L)
+{
+    bool status = false;
+
+    try
+    {
+        /* Get Parameters */
+        AssetIndex<T>* lua_obj = reinterpret_cast<AssetIndex<T>*>(getLuaSelf(L, 1));
+        const char* filename = getLuaString(L, 2);
+
+        /* Save Packed Tree */
+        lua_obj->save(filename);
+
+        /* Set Status */
+        status = true;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error saving: %s", e.what());
+    }
+
+    /* Return Status */
+    return returnLuaStatus(L, status);
+}
+
+/*----------------------------------------------------------------------------
+ * luaLoad - :load(<filename>)
+ *----------------------------------------------------------------------------*/
+template <class T>
+int AssetIndex<T>::luaLoad (lua_State* L)
+{
+    bool status = false;
+
+    try
+    {
+        /* Get Parameters */
+        AssetIndex<T>* lua_obj = reinterpret_cast<AssetIndex<T>*>(getLuaSelf(L, 1));
+        const char* filename = getLuaString(L, 2);
+
+        /* Load Packed Tree */
+        lua_obj->load(filename);
+
+        /* Set Status */
+        status = true;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error loading: %s", e.what());
+    }
+
+    /* Return Status */
+    return returnLuaStatus(L, status);
+}
+
 /*----------------------------------------------------------------------------
  * luaDisplay - :display()
  *----------------------------------------------------------------------------*/
@@ -353,79 +713,126 @@ int AssetIndex<T>::luaDisplay (lua_State* L)
 }
 
 /*----------------------------------------------------------------------------
- * buildtree
+ * packslice - sort-tile-recursive ordering of resources
+ *
+ *  sorts the resources on the center of dimension dim, cuts them into
+ *  slabs holding the same number of leaf nodes, and orders each slab on
+ *  the remaining dimensions
  *----------------------------------------------------------------------------*/
 template <class T>
-void AssetIndex<T>::buildtree (node_t* root, int* maxdepth)
+void AssetIndex<T>::packslice (int32_t* order, long count, const double* centers, int dim)
 {
-    /* Check Root */
-    if(!root || !root->ril) return;
-
-    /* Split Current Leaf Node */
-    const int root_size = root->ril->length();
-    if(root_size >= threshold)
-    {
-        /* Split Node */
-        T lspan;
-        T rspan;
-        split(root, lspan, rspan);
-        node_t* lnode = newnode(lspan);
-        node_t* rnode = newnode(rspan);
-
-        /* Split Resources on Both Leaves */
-        int lcnt = 0;
-        int rcnt = 0;
-        for(int j = 0; j < root_size; j++)
+    const int dims = dimensions();
+
+    /* Sort on Current Dimension */
+    std::sort(order, order + count, [centers, dims, dim](int32_t a, int32_t b) {
+        return centers[(a * dims) + dim] < centers[(b * dims) + dim];
+    });
+
+    /* Tile Remaining Dimensions */
+    const int remaining = dims - dim - 1;
+    if(remaining > 0 && count > PACKED_FANOUT)
+    {
+        const long leaves = (count + PACKED_FANOUT - 1) / PACKED_FANOUT;
+        const long slabs = static_cast<long>(ceil(pow(static_cast<double>(leaves), 1.0 / (remaining + 1))));
+        const long slab_size = ((leaves + slabs - 1) / slabs) * PACKED_FANOUT;
+        for(long start = 0; start < count; start += slab_size)
         {
-            const int resource_index = root->ril->get(j);
-            T& resource_span = spans.get(resource_index);
+            packslice(order + start, MIN(slab_size, count - start), centers, dim + 1);
+        }
+    }
+}
 
-            if(intersect(lspan, resource_span))
-            {
-                lcnt++;
-                lnode->span = combine(lnode->span, resource_span);
-                lnode->ril->add(resource_index);
-            }
+/*----------------------------------------------------------------------------
+ * packlevels - combine leaf entries into levels of nodes up to a single root
+ *----------------------------------------------------------------------------*/
+template <class T>
+void AssetIndex<T>::packlevels (void)
+{
+    nodeSpans.clear();
+    levelOffsets.clear();
 
-            if(intersect(rspan, resource_span))
-            {
-                rcnt++;
-                rnode->span = combine(rnode->span, resource_span);
-                rnode->ril->add(resource_index);
-            }
+    const long num_entries = static_cast<long>(entrySpans.size());
+    if(num_entries == 0) return;
+    nodeSpans.reserve((num_entries / (PACKED_FANOUT - 1)) + 1);
+
+    /* Leaf Level */
+    levelOffsets.push_back(0);
+    for(long i = 0; i < num_entries; i += PACKED_FANOUT)
+    {
+        T span = entrySpans[i];
+        const long last = MIN(i + PACKED_FANOUT, num_entries);
+        for(long j = i + 1; j < last; j++) span = combine(span, entrySpans[j]);
+        nodeSpans.push_back(span);
+    }
+
+    /* Branch Levels */
+    long first_child = 0;
+    long num_children = static_cast<long>(nodeSpans.size());
+    while(num_children > 1)
+    {
+        levelOffsets.push_back(static_cast<int64_t>(nodeSpans.size()));
+        for(long i = 0; i < num_children; i += PACKED_FANOUT)
+        {
+            T span = nodeSpans[first_child + i];
+            const long last = MIN(i + PACKED_FANOUT, num_children);
+            for(long j = i + 1; j < last; j++) span = combine(span, nodeSpans[first_child + j]);
+            nodeSpans.push_back(span);
         }
+        first_child += num_children;
+        num_children = static_cast<long>(nodeSpans.size()) - first_child;
+    }
+    levelOffsets.push_back(static_cast<int64_t>(nodeSpans.size()));
+}
+
+/*----------------------------------------------------------------------------
+ * querypacked
+ *----------------------------------------------------------------------------*/
+template <class T>
+void AssetIndex<T>::querypacked (const T& span, vector<unsigned long>& results)
+{
+    const long levels = static_cast<long>(levelOffsets.size()) - 1;
+    if(levels <= 0) return;
+
+    /* Check Root */
+    if(!intersect(span, nodeSpans.back())) return;
+
+    /* Depth First Search of Intersecting Nodes */
+    vector<std::pair<long, long>> stack; // (level, node within level)
+    stack.reserve(levels * PACKED_FANOUT);
+    stack.emplace_back(levels - 1, 0);
+    while(!stack.empty())
+    {
+        const long level = stack.back().first;
+        const long first = stack.back().second * PACKED_FANOUT;
+        stack.pop_back();
 
-        /* Check if Makes Sense to Split */
-        if(lcnt > 0 && rcnt > 0 && lcnt != root_size && rcnt != root_size)
+        if(level == 0)
         {
-            /* Split Root */
-            delete root->ril;
-            root->ril = NULL;
-            root->left = lnode;
-            root->right = rnode;
-
-            /* Recurse Into Each Leaf */
-            buildtree(root->left, maxdepth);
-            buildtree(root->right, maxdepth);
-
-            /* Update Max Depth */
-            (*maxdepth)++;
+            /* Check Leaf Entries */
+            const long last = MIN(first + PACKED_FANOUT, static_cast<long>(entrySpans.size()));
+            for(long e = first; e < last; e++)
+            {
+                if(intersect(span, entrySpans[e]))
+                {
+                    results.push_back(entryIndex[e]);
+                }
+            }
         }
         else
         {
-            /* Clean Up (unused) Leaf Nodes */
-            delete lnode->ril;
-            delete lnode;
-            delete rnode->ril;
-            delete rnode;
+            /* Check Child Nodes */
+            const int64_t child_offset = levelOffsets[level - 1];
+            const long last = MIN(first + PACKED_FANOUT, static_cast<long>(levelOffsets[level] - child_offset));
+            for(long c = last - 1; c >= first; c--)
+            {
+                if(intersect(span, nodeSpans[child_offset + c]))
+                {
+                    stack.emplace_back(level - 1, c);
+                }
+            }
         }
     }
-
-    /* Update Current Depth */
-    if(root->depth < *maxdepth)
-    {
-        root->depth = *maxdepth;
-    }
 }
 
 /*----------------------------------------------------------------------------
@@ -69,6 +69,25 @@ static int debug_print(CURL *handle, curl_infotype type, char *data, size_t size
 }
 #endif
 
+/* Shared Output Stream Ownership */
+typedef struct {
+    const CurlLib::stream_t*    stream;
+    int                         stream_id;
+} stream_owner_t;
+
+static int check_stream_owner(void* clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow)
+{
+    (void)dltotal;
+    (void)dlnow;
+    (void)ultotal;
+    (void)ulnow;
+
+    /* Abort transfer once a competing request has claimed the output stream */
+    const stream_owner_t* stream = static_cast<const stream_owner_t*>(clientp);
+    const int owner = stream->stream->owner.load(std::memory_order_acquire);
+    return ((owner == CurlLib::STREAM_UNCLAIMED) || (owner == stream->stream_id)) ? 0 : 1;
+}
+
 /******************************************************************************
  * cURL LIBRARY CLASS
  ******************************************************************************/
@@ -311,8 +330,11 @@ long CurlLib::postAsStream (const char* url, const char* data, Publisher* outq,
 
 /*----------------------------------------------------------------------------
  * postAsRecord - SlideRule Native Protocol
+ *
+ *  when a stream is supplied, the output stream is shared with competing
+ *  requests for the same resource (see stream_t)
  *----------------------------------------------------------------------------*/
-long CurlLib::postAsRecord (const char* url, const char* data, Publisher* outq, bool with_terminator, int timeout, const std::atomic<bool>* active, hdrs_t* headers)
+long CurlLib::postAsRecord (const char* url, const char* data, Publisher* outq, bool with_terminator, int timeout, const std::atomic<bool>* active, hdrs_t* headers, stream_t* stream, int stream_id)
 {
     long http_code = 0;
     CURL* curl = NULL;
@@ -332,7 +354,16 @@ long CurlLib::postAsRecord (const char* url, const char* data, Publisher* outq,
         .rec_buf = NULL,
         .outq = outq,
         .url = url,
-        .active = active
+        .active = active,
+        .stream = stream,
+        .stream_id = stream_id,
+        .held = {}
+    };
+
+    /* Initialize Stream Ownership */
+    stream_owner_t stream_owner = {
+        .stream = stream,
+        .stream_id = stream_id
     };
 
     /* Initialize cURL */
@@ -352,6 +383,14 @@ long CurlLib::postAsRecord (const char* url, const char* data, Publisher* outq,
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, CurlLib::postRecords);
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, &parser);
 
+        /* Abort Request if Competing Request Owns Output Stream */
+        if(stream)
+        {
+            curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+            curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, check_stream_owner);
+            curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &stream_owner);
+        }
+
         /* Add Headers */
         struct curl_slist* hdr_slist = NULL;
         const FString client_hdr("x-sliderule-client: core-%s", LIBID);
@@ -393,6 +432,9 @@ long CurlLib::postAsRecord (const char* url, const char* data, Publisher* outq,
             delete [] parser.rec_buf;
         }
 
+        /* Release or Drop Held Status Records */
+        finishStream(&parser, http_code == EndpointObject::OK);
+
         /* Display Error Message if Errors Encountered */
         if(parser.err_cnt > 0)
         {
@@ -799,6 +841,100 @@ void CurlLib::combineResponse (List<data_t>* rsps_set, const char** response, in
     else delete [] total_rsps;
 }
 
+/*----------------------------------------------------------------------------
+ * CurlLib::routeRecord
+ *
+ *  decides what to do with a complete record when the output stream is
+ *  shared: a data record claims an unclaimed stream; alert and log records
+ *  are held until it is known which request owns the stream
+ *----------------------------------------------------------------------------*/
+CurlLib::route_t CurlLib::routeRecord(parser_t* parser)
+{
+    if(!parser->stream) return POST_RECORD;
+
+    // check current owner
+    const int owner = parser->stream->owner.load(std::memory_order_acquire);
+    if(owner == parser->stream_id) return POST_RECORD;
+    if(owner != STREAM_UNCLAIMED) return DROP_RECORD;
+
+    // hold status records
+    const RecordObject::rec_hdr_t* rec_hdr = reinterpret_cast<const RecordObject::rec_hdr_t*>(parser->rec_buf);
+    const uint16_t type_size = OsApi::swaps(rec_hdr->type_size);
+    const char* rec_type = reinterpret_cast<const char*>(&parser->rec_buf[sizeof(RecordObject::rec_hdr_t)]);
+    if((type_size > 0) && (rec_type[type_size - 1] == '\0'))
+    {
+        if(StringLib::match(rec_type, EventLib::alertRecType) || StringLib::match(rec_type, EventLib::logRecType))
+        {
+            return HOLD_RECORD;
+        }
+    }
+
+    // claim stream
+    int expected = STREAM_UNCLAIMED;
+    if(parser->stream->owner.compare_exchange_strong(expected, parser->stream_id, std::memory_order_acq_rel))
+    {
+        return POST_RECORD;
+    }
+
+    return (expected == parser->stream_id) ? POST_RECORD : DROP_RECORD;
+}
+
+/*----------------------------------------------------------------------------
+ * CurlLib::finishStream
+ *
+ *  a successful request claims the stream if no other request has; held
+ *  status records are posted unless a competing request owns the stream
+ *----------------------------------------------------------------------------*/
+void CurlLib::finishStream(parser_t* parser, bool success)
+{
+    if(!parser->stream) return;
+
+    // claim stream on success
+    int owner = STREAM_UNCLAIMED;
+    if(success)
+    {
+        parser->stream->owner.compare_exchange_strong(owner, parser->stream_id, std::memory_order_acq_rel);
+    }
+    owner = parser->stream->owner.load(std::memory_order_acquire);
+
+    // release or drop held records
+    const bool release = (owner == parser->stream_id) || (owner == STREAM_UNCLAIMED);
+    for(const std::pair<uint8_t*, uint32_t>& rec: parser->held)
+    {
+        if(release) postRecord(parser, rec.first, rec.second);
+        else delete [] rec.first;
+    }
+    parser->held.clear();
+}
+
+/*----------------------------------------------------------------------------
+ * CurlLib::postRecord
+ *
+ *  takes ownership of the buffer
+ *----------------------------------------------------------------------------*/
+bool CurlLib::postRecord(parser_t* parser, uint8_t* buf, uint32_t size)
+{
+    int post_status = MsgQ::STATE_TIMEOUT;
+    while((!parser->active || parser->active->load(std::memory_order_acquire)) && post_status == MsgQ::STATE_TIMEOUT)
+    {
+        post_status = parser->outq->postRef(buf, size, SYS_TIMEOUT);
+    }
+
+    // handle post errors
+    if(post_status <= 0)
+    {
+        if(post_status < 0)
+        {
+            mlog(DEBUG, "Failed to post response for %s: %d", parser->url, post_status);
+            parser->err_cnt++;
+        }
+        delete [] buf;
+        return false;
+    }
+
+    return true;
+}
+
 /*----------------------------------------------------------------------------
  * CurlLib::postRecords
  *----------------------------------------------------------------------------*/
@@ -854,25 +990,35 @@ size_t CurlLib::postRecords(const void *buffer, size_t size, size_t nmemb, void
             // check body complete
             if(parser->rec_index == parser->rec_size)
             {
-                // post record
-                int post_status = MsgQ::STATE_TIMEOUT;
-                while((!parser->active || parser->active->load(std::memory_order_acquire)) && post_status == MsgQ::STATE_TIMEOUT)
+                // route record
+                const route_t route = routeRecord(parser);
+                if(route == DROP_RECORD)
                 {
-                    post_status = parser->outq->postRef(parser->rec_buf, parser->rec_size, SYS_TIMEOUT);
-                    // reset body
-                    if(post_status != MsgQ::STATE_TIMEOUT)
-                    {
-                        parser->rec_index = 0;
-                        parser->rec_size = 0;
-                    }
-                    // handle post errors
-                    if(post_status < 0)
+                    delete [] parser->rec_buf;
+                    parser->rec_index = 0;
+                    parser->rec_size = 0;
+                    return 0; // aborts transfer
+                }
+                else if(route == HOLD_RECORD)
+                {
+                    parser->held.emplace_back(parser->rec_buf, parser->rec_size);
+                }
+                else
+                {
+                    // post held records ahead of the record that claimed the stream
+                    for(const std::pair<uint8_t*, uint32_t>& rec: parser->held)
                     {
-                        mlog(DEBUG, "Failed to post response for %s: %d", parser->url, post_status);
-                        delete [] parser->rec_buf;
-                        parser->err_cnt++;
+                        postRecord(parser, rec.first, rec.second);
                     }
+                    parser->held.clear();
+
+                    // post record
+                    postRecord(parser, parser->rec_buf, parser->rec_size);
                 }
+
+                // reset body
+                parser->rec_index = 0;
+                parser->rec_size = 0;
             }
         }
     }
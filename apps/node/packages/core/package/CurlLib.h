@@ -57,6 +57,7 @@ class CurlLib
 
         static const int CONNECTION_TIMEOUT = 10L; // seconds
         static const int DATA_TIMEOUT = 60L; // seconds
+        static const int STREAM_UNCLAIMED = -1; // owner of a shared output stream before any data is posted
 
         /*--------------------------------------------------------------------
          * Typedefs
@@ -64,6 +65,16 @@ class CurlLib
 
         typedef List<const FString*> hdrs_t;
 
+        /*
+         * Output stream shared between competing requests for the same resource;
+         * the first request to post a data record (or to finish successfully)
+         * claims the stream, all other requests are aborted and their records
+         * are dropped; status records are held until the stream is claimed
+         */
+        struct stream_t {
+            std::atomic<int>    owner {STREAM_UNCLAIMED};   // request that claimed the stream
+        };
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
@@ -77,7 +88,8 @@ class CurlLib
                                              const char* username=NULL, const char* password=NULL);
         static long         postAsStream    (const char* url, const char* data, Publisher* outq, bool with_terminator);
         static long         postAsRecord    (const char* url, const char* data, Publisher* outq, bool with_terminator,
-                                             int timeout, const std::atomic<bool>* active=NULL, hdrs_t* headers=NULL);
+                                             int timeout, const std::atomic<bool>* active=NULL, hdrs_t* headers=NULL,
+                                             stream_t* stream=NULL, int stream_id=0);
         static int          getHeaders      (lua_State* L, int index, hdrs_t& header_list);
         static int          luaGet          (lua_State* L);
         static int          luaPut          (lua_State* L);
@@ -87,6 +99,8 @@ class CurlLib
 
     private:
 
+        friend class UT_EndpointProxy; // necessary for testing stream ownership
+
         /*--------------------------------------------------------------------
          * Constants
          *--------------------------------------------------------------------*/
@@ -115,13 +129,25 @@ class CurlLib
             Publisher*  outq;
             const char* url;
             const std::atomic<bool>* active;
+            stream_t*   stream;     // shared between competing requests for the same output stream
+            int         stream_id;
+            vector<std::pair<uint8_t*, uint32_t>> held; // status records held until the stream is claimed
         } parser_t;
 
+        typedef enum {
+            POST_RECORD,
+            HOLD_RECORD,
+            DROP_RECORD
+        } route_t;
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
 
         static void     combineResponse (List<data_t>* rsps_set, const char** response, int* size);
+        static route_t  routeRecord     (parser_t* parser);
+        static void     finishStream    (parser_t* parser, bool success);
+        static bool     postRecord      (parser_t* parser, uint8_t* buf, uint32_t size);
         static size_t   postRecords     (const void *buffer, size_t size, size_t nmemb, void *userp);
         static size_t   postData        (const void *buffer, size_t size, size_t nmemb, void *userp);
         static size_t   writeData       (const void *buffer, size_t size, size_t nmemb, void *userp);
@@ -40,9 +40,89 @@
 #include "OsApi.h"
 #include <climits>
 #include <assert.h>
+#include <string_view>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/******************************************************************************
+ * DICTIONARY KEY CLASS
+ *
+ *  A key hashed once up front so that repeated lookups of the same name (e.g.
+ *  a column looked up per batch) skip the hash; the key only references the
+ *  string it was created from, which must outlive it.
+ ******************************************************************************/
+
+class DictionaryKey
+{
+    public:
+
+        explicit DictionaryKey (const char* _key): str(_key), hash(hashKey(str)) {}
+        explicit DictionaryKey (std::string_view _key): str(_key), hash(hashKey(str)) {}
+
+        static uint64_t hashKey (std::string_view key);
+
+        const std::string_view  str;
+        const uint64_t          hash;
+
+    private:
+
+        static uint64_t mix (uint64_t x);
+};
+
+/*----------------------------------------------------------------------------
+ * hashKey
+ *
+ *  consumes the key eight bytes at a time; the result is only ever used
+ *  within the process so the byte order of the platform does not matter,
+ *  and the tail is assembled byte by byte to avoid a variable length memcpy
+ *----------------------------------------------------------------------------*/
+inline uint64_t DictionaryKey::hashKey (std::string_view key)
+{
+    const char* ptr = key.data();
+    size_t len = key.size();
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ len;
+
+    while(len >= sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, ptr, sizeof(uint64_t));
+        h = (h ^ word) * 0x9FB21C651E98DF25ULL;
+        ptr += sizeof(uint64_t);
+        len -= sizeof(uint64_t);
+    }
+
+    if(len > 0)
+    {
+        uint64_t word = 0;
+        for(size_t i = 0; i < len; i++) word |= static_cast<uint64_t>(static_cast<uint8_t>(ptr[i])) << (i * 8);
+        h = (h ^ word) * 0x9FB21C651E98DF25ULL;
+    }
+
+    return mix(h);
+}
+
+/*----------------------------------------------------------------------------
+ * mix
+ *----------------------------------------------------------------------------*/
+inline uint64_t DictionaryKey::mix (uint64_t x)
+{
+    x ^= x >> 32;
+    x *= 0xD6E8FEB86659FD93ULL;
+    x ^= x >> 32;
+    return x;
+}
 
 /******************************************************************************
  * DICTIONARY TEMPLATE
+ *
+ *  Open addressing hash table with a separate array of one byte control
+ *  entries per slot (empty, deleted, or the low 7 bits of the hash of a full
+ *  slot).  Lookups compare a group of 16 control bytes at once against the
+ *  7-bit tag and only touch the slots that match; the full hash is cached in
+ *  each slot so that string compares only happen on true candidates and
+ *  rehashing never rehashes a key.
  ******************************************************************************/
 
 template <class T>
@@ -55,9 +135,10 @@ class Dictionary
          *--------------------------------------------------------------------*/
 
         static const int            DEFAULT_HASH_TABLE_SIZE = 256;
-        static const unsigned int   EMPTY_ENTRY             = 0; // must be 0 because hashTable initialized to 0's
         static const unsigned int   NULL_INDEX              = UINT_MAX;
+        static const int            GROUP_WIDTH             = 16; // control bytes compared per probe
         static const double         DEFAULT_HASH_TABLE_LOAD; // statically defined below
+        static const double         MAX_HASH_TABLE_LOAD; // statically defined below
 
         /*--------------------------------------------------------------------
          * Iterator Subclass
@@ -93,7 +174,11 @@ class Dictionary
 
         bool        add             (const char* key, const T& data, bool unique=false);
         T&          get             (const char* key) const;
+        T&          get             (std::string_view key) const;
+        T&          get             (const DictionaryKey& key) const;
         bool        find            (const char* key, T* data=NULL) const;
+        bool        find            (std::string_view key, T* data=NULL) const;
+        bool        find            (const DictionaryKey& key, T* data=NULL) const;
         bool        remove          (const char* key);
         int         length          (void) const;
         int         getHashSize     (void) const;
@@ -112,6 +197,14 @@ class Dictionary
 
     protected:
 
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int8_t CTRL_EMPTY      = -128;  // 0x80
+        static const int8_t CTRL_DELETED    = -2;    // 0xFE
+        static const int    MIN_HASH_SIZE   = GROUP_WIDTH;
+
         /*--------------------------------------------------------------------
          * Types
          *--------------------------------------------------------------------*/
@@ -119,20 +212,20 @@ class Dictionary
         typedef struct {
             const char*     key;
             T               data;
-            unsigned int    chain;  // depth of the chain to reach this entry, 0 indicates empty
-            unsigned int    hash;   // unconstrained hash value
-            unsigned int    next;
-            unsigned int    prev;
+            uint64_t        hash;   // unconstrained hash value
+            unsigned int    len;    // length of key
         } hash_node_t;
 
         /*--------------------------------------------------------------------
          * Data
          *--------------------------------------------------------------------*/
 
+        int8_t* ctrlTable;  // hashSize control bytes followed by a copy of the first GROUP_WIDTH - 1
         typename Dictionary<T>::hash_node_t* hashTable;
-        unsigned int hashSize;
+        unsigned int hashSize; // power of two
         unsigned int numEntries;
-        unsigned int maxChain;
+        unsigned int numDeleted;
+        unsigned int maxChain; // most groups probed by an insert
         double hashLoad;
         unsigned int currIndex;
 
@@ -140,11 +233,16 @@ class Dictionary
          * Methods
          *--------------------------------------------------------------------*/
 
-        unsigned int    hashKey     (const char* key) const;  // returns unconstrained hash
-        unsigned int    getNode     (const char* key) const;  // returns index into hash table
-        void            addNode     (const char* key, const T& data, unsigned int hash, bool rehashed=false);
+        unsigned int    getNode     (const char* key, unsigned int len, uint64_t hash) const;  // returns index into hash table
+        void            addNode     (const char* key, unsigned int len, const T& data, uint64_t hash);
         void            freeNode    (unsigned int hash_index);
+        void            allocate    (unsigned int hash_size);
+        bool            rehash      (unsigned int hash_size);
+        void            setCtrl     (unsigned int index, int8_t ctrl);
+        bool            isFull      (unsigned int index) const;
 
+        static uint32_t matchGroup  (const int8_t* group, int8_t ctrl);
+        static uint32_t matchFree   (const int8_t* group);
 };
 
 /******************************************************************************
@@ -180,7 +278,7 @@ typename Dictionary<T>::kv_t Dictionary<T>::Iterator::operator[](int index)
         while(curr_index < index) // move forward
         {
             table_index++;
-            if(source.hashTable[table_index].chain != EMPTY_ENTRY)
+            if(source.isFull(table_index))
             {
                 curr_index++;
             }
@@ -189,7 +287,7 @@ typename Dictionary<T>::kv_t Dictionary<T>::Iterator::operator[](int index)
         while(curr_index > index) // move backwards
         {
             table_index--;
-            if(source.hashTable[table_index].chain != EMPTY_ENTRY)
+            if(source.isFull(table_index))
             {
                 curr_index--;
             }
@@ -208,19 +306,27 @@ typename Dictionary<T>::kv_t Dictionary<T>::Iterator::operator[](int index)
 template <class T>
 const double Dictionary<T>::DEFAULT_HASH_TABLE_LOAD = 0.75;
 
+template <class T>
+const double Dictionary<T>::MAX_HASH_TABLE_LOAD = 0.875;
+
 /******************************************************************************
  * DICTIONARY METHODS
  ******************************************************************************/
 
 /*----------------------------------------------------------------------------
  * Constructor
+ *
+ *  hash size is rounded up to a power of two of at least one group, and the
+ *  load is capped so that every probe sequence is guaranteed an empty slot
  *----------------------------------------------------------------------------*/
 template <class T>
 Dictionary<T>::Dictionary(int hash_size, double hash_load)
 {
     assert(hash_size >= 0);
 
-    hashSize = hash_size == 0 ? DEFAULT_HASH_TABLE_SIZE : hash_size;
+    unsigned int size = MIN_HASH_SIZE;
+    const unsigned int requested_size = hash_size == 0 ? DEFAULT_HASH_TABLE_SIZE : hash_size;
+    while(size < requested_size) size <<= 1;
 
     if(hash_load <= 0.0 || hash_load > 1.0)
     {
@@ -228,11 +334,10 @@ Dictionary<T>::Dictionary(int hash_size, double hash_load)
     }
     else
     {
-        hashLoad = hash_load;
+        hashLoad = MIN(hash_load, MAX_HASH_TABLE_LOAD);
     }
 
-    hashTable = new hash_node_t [hashSize];
-    for(unsigned int i = 0; i < hashSize; i++) hashTable[i].chain = EMPTY_ENTRY;
+    allocate(size);
 
     currIndex = 0;
     numEntries = 0;
@@ -244,23 +349,16 @@ Dictionary<T>::Dictionary(int hash_size, double hash_load)
  *----------------------------------------------------------------------------*/
 template <class T>
 Dictionary<T>::Dictionary(const Dictionary<T>& dictionary):
-    hashSize(dictionary.hashSize),
-    hashLoad(dictionary.hashLoad)
+    ctrlTable(NULL),
+    hashTable(NULL),
+    hashSize(0),
+    numEntries(0),
+    numDeleted(0),
+    maxChain(0),
+    hashLoad(dictionary.hashLoad),
+    currIndex(0)
 {
-    hashTable = new hash_node_t [hashSize];
-    for(unsigned int i = 0; i < hashSize; i++)
-    {
-        OsApi::dupstr(&hashTable[i].key, dictionary.hashTable[i].key);
-        hashTable[i].data = dictionary.hashTable[i].data;
-        hashTable[i].chain = dictionary.hashTable[i].chain;
-        hashTable[i].hash = dictionary.hashTable[i].hash;
-        hashTable[i].next = dictionary.hashTable[i].next;
-        hashTable[i].prev = dictionary.hashTable[i].prev;
-    }
-
-    currIndex = dictionary.currIndex;
-    numEntries = dictionary.numEntries;
-    maxChain = dictionary.maxChain;
+    *this = dictionary;
 }
 
 /*----------------------------------------------------------------------------
@@ -270,6 +368,7 @@ template <class T>
 Dictionary<T>::~Dictionary(void)
 {
     clear();
+    delete [] ctrlTable;
     delete [] hashTable;
 }
 
@@ -285,52 +384,36 @@ bool Dictionary<T>::add(const char* key, const T& data, bool unique)
 
     bool status = true;
 
+    /* Hash Key Once */
+    const unsigned int len = strlen(key);
+    const uint64_t hash = DictionaryKey::hashKey(std::string_view(key, len));
+
     /* Insert Entry into Dictionary */
-    const unsigned int index = getNode(key);
+    const unsigned int index = getNode(key, len, hash);
     if(index == NULL_INDEX)
     {
-        /* Check for Rehash Needed */
-        if(numEntries > (hashSize * hashLoad))
+        /* Check for Rehash Needed (deleted slots count against the load) */
+        if((numEntries + numDeleted) >= (hashSize * hashLoad))
         {
-            const unsigned int old_hash_size = hashSize;
-            hash_node_t* old_hash_table = hashTable;
-
-            const unsigned int new_hash_size = hashSize * 2;              // double size of hash table
-            if(new_hash_size > 0 && new_hash_size > hashSize)
+            if(numEntries < (hashSize * hashLoad / 2))
             {
-                hashSize = new_hash_size;
-                hashTable = new hash_node_t [hashSize];
-                for(unsigned int i = 0; i < hashSize; i++)
-                {
-                    hashTable[i].chain = EMPTY_ENTRY;
-                }
-
-                maxChain = 0;
-
-                for(unsigned int i = 0; i < old_hash_size; i++)
-                {
-                    if(old_hash_table[i].chain != EMPTY_ENTRY)
-                    {
-                        addNode(old_hash_table[i].key,
-                                old_hash_table[i].data,
-                                old_hash_table[i].hash,
-                                true); // rehash doesn't reallocate key
-                    }
-                }
-
-                delete [] old_hash_table;
+                /* Mostly Deleted Slots - Reclaim Them In Place */
+                status = rehash(hashSize);
             }
             else
             {
-                /* Unable to Make Hash Larger */
-                status = false;
+                /* Double Size of Hash Table */
+                const unsigned int new_hash_size = hashSize * 2;
+                status = (new_hash_size > hashSize) && rehash(new_hash_size);
             }
         }
 
         /* Add Node */
         if(status)
         {
-            addNode(key, data, hashKey(key));
+            const char* new_key = NULL;
+            OsApi::dupstr(&new_key, key);
+            addNode(new_key, len, data, hash);
             numEntries++;
         }
     }
@@ -357,9 +440,29 @@ bool Dictionary<T>::add(const char* key, const T& data, bool unique)
 template <class T>
 T& Dictionary<T>::get(const char* key) const
 {
-    const unsigned int index = getNode(key);
+    return get(std::string_view(key));
+}
+
+/*----------------------------------------------------------------------------
+ * get - heterogeneous lookup
+ *----------------------------------------------------------------------------*/
+template <class T>
+T& Dictionary<T>::get(std::string_view key) const
+{
+    const unsigned int index = getNode(key.data(), key.size(), DictionaryKey::hashKey(key));
     if(index != NULL_INDEX) return hashTable[index].data;
-    throw RunTimeException(CRITICAL, RTE_FAILURE, "key <%s> not found", key);
+    throw RunTimeException(CRITICAL, RTE_FAILURE, "key <%.*s> not found", static_cast<int>(key.size()), key.data());
+}
+
+/*----------------------------------------------------------------------------
+ * get - pre-hashed lookup
+ *----------------------------------------------------------------------------*/
+template <class T>
+T& Dictionary<T>::get(const DictionaryKey& key) const
+{
+    const unsigned int index = getNode(key.str.data(), key.str.size(), key.hash);
+    if(index != NULL_INDEX) return hashTable[index].data;
+    throw RunTimeException(CRITICAL, RTE_FAILURE, "key <%.*s> not found", static_cast<int>(key.str.size()), key.str.data());
 }
 
 /*----------------------------------------------------------------------------
@@ -370,83 +473,74 @@ T& Dictionary<T>::get(const char* key) const
 template <class T>
 bool Dictionary<T>::find(const char* key, T* data) const
 {
-    bool found = false;
+    if(key == NULL) return false;
+    return find(std::string_view(key), data);
+}
 
-    if(key != NULL)
-    {
-        const unsigned int index = getNode(key);
-        if(index != NULL_INDEX)
-        {
-            found = true;
-            if(data) *data = hashTable[index].data;
-        }
-    }
+/*----------------------------------------------------------------------------
+ * find - heterogeneous lookup
+ *----------------------------------------------------------------------------*/
+template <class T>
+bool Dictionary<T>::find(std::string_view key, T* data) const
+{
+    const unsigned int index = getNode(key.data(), key.size(), DictionaryKey::hashKey(key));
+    if(index == NULL_INDEX) return false;
+    if(data) *data = hashTable[index].data;
+    return true;
+}
 
-    return found;
+/*----------------------------------------------------------------------------
+ * find - pre-hashed lookup
+ *----------------------------------------------------------------------------*/
+template <class T>
+bool Dictionary<T>::find(const DictionaryKey& key, T* data) const
+{
+    const unsigned int index = getNode(key.str.data(), key.str.size(), key.hash);
+    if(index == NULL_INDEX) return false;
+    if(data) *data = hashTable[index].data;
+    return true;
 }
 
 /*----------------------------------------------------------------------------
  * remove
+ *
+ *  a slot can go straight back to empty when no probe sequence could have
+ *  passed over it, i.e. every group that contains it already has an empty
+ *  slot; otherwise it is marked deleted so later probes continue past it
  *----------------------------------------------------------------------------*/
 template <class T>
 bool Dictionary<T>::remove(const char* key)
 {
-    bool status = true;
-
-    /* Check Pointers */
-    const unsigned int index = getNode(key);
-    if(index != NULL_INDEX)
+    if(key == NULL) return false;
+
+    const unsigned int len = strlen(key);
+    const unsigned int index = getNode(key, len, DictionaryKey::hashKey(std::string_view(key, len)));
+    if(index == NULL_INDEX) return false;
+
+    /* Delete Node */
+    delete [] hashTable[index].key;
+    freeNode(index);
+
+    /* Mark Control Byte */
+    const unsigned int mask = hashSize - 1;
+    const uint32_t empty_after = matchGroup(&ctrlTable[index], CTRL_EMPTY);
+    const uint32_t empty_before = matchGroup(&ctrlTable[(index - GROUP_WIDTH) & mask], CTRL_EMPTY);
+    const bool was_never_full = empty_before && empty_after &&
+                                ((__builtin_ctz(empty_after) + (__builtin_clz(empty_before) - (32 - GROUP_WIDTH))) < GROUP_WIDTH);
+    if(was_never_full)
     {
-        /* Delete Node */
-        delete [] hashTable[index].key;
-        freeNode(index);
-
-        /* Get List Indices */
-        unsigned int       next_index = hashTable[index].next;
-        const unsigned int prev_index = hashTable[index].prev;
-
-        if((hashTable[index].chain == 1) && (next_index != NULL_INDEX))
-        {
-            hashTable[next_index].chain = EMPTY_ENTRY;
-
-            /* Copy Next Item into Start of Chain */
-            hashTable[index].key   = hashTable[next_index].key;
-            hashTable[index].data  = hashTable[next_index].data;
-            hashTable[index].hash  = hashTable[next_index].hash;
-            hashTable[index].next  = hashTable[next_index].next;
-            hashTable[index].prev  = NULL_INDEX;
-
-            /* Goto Next Entry (for later transversal) */
-            next_index = hashTable[index].next;
-            if(next_index != NULL_INDEX) hashTable[next_index].prev = index;
-        }
-        else
-        {
-            hashTable[index].chain = EMPTY_ENTRY;
-
-            /* Bridge Over Removed Entry */
-            if(next_index != NULL_INDEX) hashTable[next_index].prev = prev_index;
-            if(prev_index != NULL_INDEX) hashTable[prev_index].next = next_index;
-        }
-
-        /* Transverse to End of Chain */
-        while(next_index != NULL_INDEX)
-        {
-            hashTable[next_index].chain--;
-            next_index = hashTable[next_index].next;
-        }
-
-        /* Update Statistics */
-        numEntries--;
+        setCtrl(index, CTRL_EMPTY);
     }
     else
     {
-        /* Key Not Found */
-        status = false;
+        setCtrl(index, CTRL_DELETED);
+        numDeleted++;
     }
 
-    /* Return Status */
-    return status;
+    /* Update Statistics */
+    numEntries--;
+
+    return true;
 }
 
 /*----------------------------------------------------------------------------
@@ -469,6 +563,8 @@ int Dictionary<T>::getHashSize(void) const
 
 /*----------------------------------------------------------------------------
  * getMaxChain
+ *
+ *  number of groups probed by the longest insert since the last rehash
  *----------------------------------------------------------------------------*/
 template <class T>
 int Dictionary<T>::getMaxChain(void) const
@@ -487,7 +583,7 @@ int Dictionary<T>::getKeys (char*** keys) const
     *keys = new char* [numEntries];
     for(unsigned int i = 0, j = 0; i < hashSize; i++)
     {
-        if(hashTable[i].chain != EMPTY_ENTRY)
+        if(isFull(i))
         {
             const char* new_key = NULL;
             OsApi::dupstr(&new_key, hashTable[i].key);
@@ -509,16 +605,19 @@ void Dictionary<T>::clear (void)
     /* Clear Hash */
     for(unsigned int i = 0; numEntries > 0 && i < hashSize; i++)
     {
-        if(hashTable[i].chain != EMPTY_ENTRY)
+        if(isFull(i))
         {
-            hashTable[i].chain = EMPTY_ENTRY;
             delete [] hashTable[i].key;
             numEntries--;
             freeNode(i);
         }
     }
 
+    /* Reset Control Bytes */
+    if(ctrlTable) memset(ctrlTable, CTRL_EMPTY, hashSize + GROUP_WIDTH - 1);
+
     /* Clear Attributes */
+    numDeleted = 0;
     maxChain = 0;
 }
 
@@ -533,7 +632,7 @@ const char* Dictionary<T>::first (T* data)
     currIndex = 0;
     while(currIndex < hashSize)
     {
-        if(hashTable[currIndex].chain != EMPTY_ENTRY)
+        if(isFull(currIndex))
         {
             if(data) *data = hashTable[currIndex].data;
             key = hashTable[currIndex].key;
@@ -555,7 +654,7 @@ const char* Dictionary<T>::next (T* data)
 
     while(++currIndex < hashSize)
     {
-        if(hashTable[currIndex].chain != EMPTY_ENTRY)
+        if(isFull(currIndex))
         {
             if(data) *data = hashTable[currIndex].data;
             key = hashTable[currIndex].key;
@@ -576,7 +675,7 @@ const char* Dictionary<T>::prev (T* data)
 
     while(--currIndex < hashSize) // since we are using unsigned math, the .lt. is appropriate
     {
-        if(hashTable[currIndex].chain != EMPTY_ENTRY)
+        if(isFull(currIndex))
         {
             if(data) *data = hashTable[currIndex].data;
             key = hashTable[currIndex].key;
@@ -598,7 +697,7 @@ const char* Dictionary<T>::last (T* data)
     currIndex = hashSize - 1;
     while(currIndex < hashSize)
     {
-        if(hashTable[currIndex].chain != EMPTY_ENTRY)
+        if(isFull(currIndex))
         {
             if(data) *data = hashTable[currIndex].data;
             key = hashTable[currIndex].key;
@@ -623,23 +722,21 @@ Dictionary<T>& Dictionary<T>::operator=(const Dictionary& other)
     clear();
 
     /* Free Hash */
+    delete [] ctrlTable;
     delete [] hashTable;
 
     /* Copy Other Dictionary */
-    hashSize = other.hashSize;
     hashLoad = other.hashLoad;
-    hashTable = new hash_node_t [hashSize];
+    allocate(other.hashSize);
+    memcpy(ctrlTable, other.ctrlTable, hashSize + GROUP_WIDTH - 1);
     for(unsigned int i = 0; i < hashSize; i++)
     {
-        hashTable[i].chain = EMPTY_ENTRY;
-        if(other.hashTable[i].chain != EMPTY_ENTRY)
+        if(other.isFull(i))
         {
             /* copy fields */
             hashTable[i].data = other.hashTable[i].data;
-            hashTable[i].chain = other.hashTable[i].chain;
             hashTable[i].hash = other.hashTable[i].hash;
-            hashTable[i].next = other.hashTable[i].next;
-            hashTable[i].prev = other.hashTable[i].prev;
+            hashTable[i].len = other.hashTable[i].len;
 
             /* copy key */
             const char* new_key = NULL;
@@ -649,6 +746,7 @@ Dictionary<T>& Dictionary<T>::operator=(const Dictionary& other)
     }
     currIndex = 0;
     numEntries = other.numEntries;
+    numDeleted = other.numDeleted;
     maxChain = other.maxChain;
 
     /* return */
@@ -677,199 +775,208 @@ T& Dictionary<T>::operator[](const char* key)
     return get(key);
 }
 
-/*----------------------------------------------------------------------------
- * hashKey
- *----------------------------------------------------------------------------*/
-template <class T>
-unsigned int Dictionary<T>::hashKey(const char *key) const
-{
-    const char* ptr = key;
-    long        h   = 0;
-
-    while(*ptr != '\0')
-    {
-        h += *ptr;
-        h += ( h << 10 );
-        h ^= ( h >> 6 );
-        ptr++;
-    }
-
-    h += ( h << 3 );
-    h ^= ( h >> 11 );
-    h += ( h << 15 );
-
-    return (unsigned int)h;
-}
-
 /*----------------------------------------------------------------------------
  * getNode
  *
- *  must be called from locked context
+ *  probes whole groups at a time: the starting slot comes from the upper bits
+ *  of the hash, candidates within a group are the control bytes equal to the
+ *  lower 7 bits, and the search ends at the first group with an empty slot;
+ *  groups are stepped triangularly which visits every slot of a power of two
+ *  sized table
  *----------------------------------------------------------------------------*/
 template <class T>
-unsigned int Dictionary<T>::getNode(const char* key) const
+unsigned int Dictionary<T>::getNode(const char* key, unsigned int len, uint64_t hash) const
 {
     assert(hashSize);
 
-    /* Check Pointer */
-    if(key != NULL)
+    const unsigned int mask = hashSize - 1;
+    const int8_t tag = static_cast<int8_t>(hash & 0x7F);
+    unsigned int pos = static_cast<unsigned int>(hash >> 7) & mask;
+    unsigned int step = 0;
+
+    while(true)
     {
-        /* Grab Hash Entry */
-        unsigned int index = hashKey(key) % hashSize;
+        const int8_t* group = &ctrlTable[pos];
 
-        /* Search */
-        while(index != NULL_INDEX && hashTable[index].chain != EMPTY_ENTRY)
+        /* Check Candidates */
+        uint32_t candidates = matchGroup(group, tag);
+        while(candidates)
         {
-            /* Compare Hash Key to Key */
-            int i = 0;
-            while(hashTable[index].key[i] == key[i])
+            const unsigned int index = (pos + __builtin_ctz(candidates)) & mask;
+            const hash_node_t& node = hashTable[index];
+            if((node.hash == hash) && (node.len == len) && (memcmp(node.key, key, len) == 0))
             {
-                /* If there is no difference AND key is at null, return match */
-                if(key[i] == '\0')
-                {
-                    return index;
-                }
-
-                /* Goto next character */
-                i++;
+                return index;
             }
+            candidates &= candidates - 1;
+        }
 
-            /* As soon as there is a difference, go to next */
-            index = hashTable[index].next;
+        /* Stop at First Group with an Empty Slot */
+        if(matchGroup(group, CTRL_EMPTY))
+        {
+            return NULL_INDEX;
         }
-    }
 
-    return NULL_INDEX;
+        /* Next Group */
+        step += GROUP_WIDTH;
+        pos = (pos + step) & mask;
+    }
 }
 
 /*----------------------------------------------------------------------------
  * addNode
+ *
+ *  key must not already be in the table; takes ownership of key
  *----------------------------------------------------------------------------*/
 template <class T>
-void Dictionary<T>::addNode (const char* key, const T& data, unsigned int hash, bool rehashed)
+void Dictionary<T>::addNode (const char* key, unsigned int len, const T& data, uint64_t hash)
 {
     assert(hashSize);
 
-    /* Constrain the Hash */
-    const unsigned int curr_index = hash % hashSize;
+    const unsigned int mask = hashSize - 1;
+    unsigned int pos = static_cast<unsigned int>(hash >> 7) & mask;
+    unsigned int step = 0;
+    unsigned int groups = 1;
 
-    /* Optimize Creation of New Key */
-    const char* new_key = NULL;
-    if(rehashed)
+    /* Find First Empty or Deleted Slot Along Probe Sequence */
+    uint32_t available = matchFree(&ctrlTable[pos]);
+    while(!available)
     {
-        new_key = key;
+        step += GROUP_WIDTH;
+        pos = (pos + step) & mask;
+        available = matchFree(&ctrlTable[pos]);
+        groups++;
     }
-    else
+    const unsigned int index = (pos + __builtin_ctz(available)) & mask;
+
+    /* Populate Slot */
+    if(ctrlTable[index] == CTRL_DELETED) numDeleted--;
+    setCtrl(index, static_cast<int8_t>(hash & 0x7F));
+    hashTable[index].key   = key;
+    hashTable[index].data  = data;
+    hashTable[index].hash  = hash;
+    hashTable[index].len   = len;
+
+    /* Check For New Max Chain */
+    if(groups > maxChain)
     {
-        const char* tmp_key = NULL;
-        OsApi::dupstr(&tmp_key, key);
-        new_key = tmp_key;
+        maxChain = groups;
     }
+}
 
-    /* Add Entry Directly to Hash */
-    if(hashTable[curr_index].chain == EMPTY_ENTRY)
-    {
-        hashTable[curr_index].key   = new_key;
-        hashTable[curr_index].data  = data;
-        hashTable[curr_index].chain = 1;
-        hashTable[curr_index].hash  = hash;
-        hashTable[curr_index].next  = NULL_INDEX;
-        hashTable[curr_index].prev  = NULL_INDEX;
-    }
-    /* Add Entry Linked into Hash */
-    else
-    {
-        /* Find First Open Hash Slot */
-        unsigned int open_index = (curr_index + 1) % hashSize;
-        while(hashTable[open_index].chain != EMPTY_ENTRY)
-        {
-            assert(open_index != curr_index); // previous checks prevent this
-            open_index = (open_index + 1) % hashSize;
-        }
+/*----------------------------------------------------------------------------
+ * freeNode
+ *----------------------------------------------------------------------------*/
+template <class T>
+void dictionaryDeleteIfPointer(const T& t) { (void)t; }
 
-        /* Get Indices into List */
-        unsigned int next_index = hashTable[curr_index].next;
-        unsigned int prev_index = hashTable[curr_index].prev;
+template <class T>
+void dictionaryDeleteIfPointer(T* t) { delete t; }
 
-        if(hashTable[curr_index].chain == 1) // collision
-        {
-            /* Transverse to End of Chain */
-            prev_index = curr_index;
-            while(next_index != NULL_INDEX)
-            {
-                prev_index = next_index;
-                next_index = hashTable[next_index].next;
-            }
+template <class T>
+void Dictionary<T>::freeNode(unsigned int hash_index)
+{
+    dictionaryDeleteIfPointer(hashTable[hash_index].data);
+}
 
-            /* Add Entry to Open Slot at End of Chain */
-            hashTable[prev_index].next  = open_index;
-            hashTable[open_index].key   = new_key;
-            hashTable[open_index].data  = data;
-            hashTable[open_index].chain = hashTable[prev_index].chain + 1;
-            hashTable[open_index].hash  = hash;
-            hashTable[open_index].next  = NULL_INDEX;
-            hashTable[open_index].prev  = prev_index;
-
-            /* Check For New Max Chain */
-            if(hashTable[open_index].chain > maxChain)
-            {
-                maxChain = hashTable[open_index].chain;
-            }
-        }
-        else // chain > 1, robin hood the slot
-        {
-            /* Bridge Over Current Slot */
-            if(next_index != NULL_INDEX) hashTable[next_index].prev = prev_index;
-            hashTable[prev_index].next = next_index;
+/*----------------------------------------------------------------------------
+ * allocate
+ *----------------------------------------------------------------------------*/
+template <class T>
+void Dictionary<T>::allocate (unsigned int hash_size)
+{
+    hashSize = hash_size;
+    numDeleted = 0;
+    ctrlTable = new int8_t [hashSize + GROUP_WIDTH - 1];
+    memset(ctrlTable, CTRL_EMPTY, hashSize + GROUP_WIDTH - 1);
+    hashTable = new hash_node_t [hashSize];
+}
 
-            /* Transverse to End of Chain */
-            while(next_index != NULL_INDEX)
-            {
-                hashTable[next_index].chain--;
-                prev_index = next_index;
-                next_index = hashTable[next_index].next;
-            }
+/*----------------------------------------------------------------------------
+ * rehash
+ *
+ *  moves every entry into a freshly allocated table using the cached hash;
+ *  keys and data are moved, not copied
+ *----------------------------------------------------------------------------*/
+template <class T>
+bool Dictionary<T>::rehash (unsigned int hash_size)
+{
+    const unsigned int old_hash_size = hashSize;
+    int8_t* old_ctrl_table = ctrlTable;
+    hash_node_t* old_hash_table = hashTable;
 
-            /* Copy Current Slot to Open Slot at End of Chain */
-            hashTable[prev_index].next  = open_index;
-            hashTable[open_index].key   = hashTable[curr_index].key;
-            hashTable[open_index].data  = hashTable[curr_index].data;
-            hashTable[open_index].chain = hashTable[prev_index].chain + 1;
-            hashTable[open_index].hash  = hashTable[curr_index].hash;
-            hashTable[open_index].next  = NULL_INDEX;
-            hashTable[open_index].prev  = prev_index;
-
-            /* Check For New Max Chain */
-            if(hashTable[open_index].chain > maxChain)
-            {
-                maxChain = hashTable[open_index].chain;
-            }
+    allocate(hash_size);
+    maxChain = 0;
 
-            /* Add Entry to Current Slot */
-            hashTable[curr_index].key   = new_key;
-            hashTable[curr_index].data  = data;
-            hashTable[curr_index].chain = 1;
-            hashTable[curr_index].hash  = hash;
-            hashTable[curr_index].next  = NULL_INDEX;
-            hashTable[curr_index].prev  = NULL_INDEX;
+    for(unsigned int i = 0; i < old_hash_size; i++)
+    {
+        if(old_ctrl_table[i] >= 0)
+        {
+            addNode(old_hash_table[i].key,
+                    old_hash_table[i].len,
+                    old_hash_table[i].data,
+                    old_hash_table[i].hash);
         }
     }
+
+    delete [] old_ctrl_table;
+    delete [] old_hash_table;
+
+    return true;
 }
 
 /*----------------------------------------------------------------------------
- * freeNode
+ * setCtrl
+ *
+ *  the first GROUP_WIDTH - 1 control bytes are mirrored past the end of the
+ *  table so a group can be loaded from any slot without wrapping
  *----------------------------------------------------------------------------*/
 template <class T>
-void dictionaryDeleteIfPointer(const T& t) { (void)t; }
+inline void Dictionary<T>::setCtrl (unsigned int index, int8_t ctrl)
+{
+    ctrlTable[index] = ctrl;
+    ctrlTable[((index - (GROUP_WIDTH - 1)) & (hashSize - 1)) + (GROUP_WIDTH - 1)] = ctrl;
+}
 
+/*----------------------------------------------------------------------------
+ * isFull
+ *----------------------------------------------------------------------------*/
 template <class T>
-void dictionaryDeleteIfPointer(T* t) { delete t; }
+inline bool Dictionary<T>::isFull (unsigned int index) const
+{
+    return ctrlTable[index] >= 0;
+}
 
+/*----------------------------------------------------------------------------
+ * matchGroup - bit i set if group[i] == ctrl
+ *----------------------------------------------------------------------------*/
 template <class T>
-void Dictionary<T>::freeNode(unsigned int hash_index)
+inline uint32_t Dictionary<T>::matchGroup (const int8_t* group, int8_t ctrl)
 {
-    dictionaryDeleteIfPointer(hashTable[hash_index].data);
+#ifdef __SSE2__
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(ctrl), bytes)));
+#else
+    uint32_t mask = 0;
+    for(int i = 0; i < GROUP_WIDTH; i++) mask |= static_cast<uint32_t>(group[i] == ctrl) << i;
+    return mask;
+#endif
 }
 
+/*----------------------------------------------------------------------------
+ * matchFree - bit i set if group[i] is empty or deleted
+ *----------------------------------------------------------------------------*/
+template <class T>
+inline uint32_t Dictionary<T>::matchFree (const int8_t* group)
+{
+#ifdef __SSE2__
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+#else
+    uint32_t mask = 0;
+    for(int i = 0; i < GROUP_WIDTH; i++) mask |= static_cast<uint32_t>(group[i] < 0) << i;
+    return mask;
+#endif
+}
 
 #endif  /* __dictionary__ */
@@ -36,12 +36,14 @@
 #include <math.h>
 #include <float.h>
 #include <stdarg.h>
+#include <algorithm>
 
 #include "OsApi.h"
 #include "CurlLib.h"
 #include "RequestParameters.h"
 #include "EndpointProxy.h"
 #include "SystemConfig.h"
+#include "TimeLib.h"
 
 /******************************************************************************
  * STATIC DATA
@@ -178,6 +180,39 @@ EndpointProxy::EndpointProxy (lua_State* L, const char* _endpoint, const char**
     nodes = new OrchestratorLib::Node* [numResources];
     memset(nodes, 0, sizeof(OrchestratorLib::Node*) * numResources); // set all to NULL
 
+    /*
+     * Initialize Hedging
+     *  - a resource that takes longer than the configured percentile of the
+     *    completed resources is speculatively sent to a second node
+     *  - the number of hedged resources is bounded by the fraction of resources
+     *    expected to be above the percentile
+     */
+    hedgeNodes = new OrchestratorLib::Node* [numResources];
+    memset(hedgeNodes, 0, sizeof(OrchestratorLib::Node*) * numResources); // set all to NULL
+    streams = new CurlLib::stream_t [numResources];
+    startTimes = new double [numResources];
+    outstanding = new int [numResources];
+    hedged = new bool [numResources];
+    complete = new bool [numResources];
+    for(int i = 0; i < numResources; i++)
+    {
+        startTimes[i] = 0.0;
+        outstanding[i] = 0;
+        hedged[i] = false;
+        complete[i] = false;
+    }
+    hedgePercentile = SystemConfig::settings().proxyHedgePercentile.value;
+    hedgeMinSamples = MAX(SystemConfig::settings().proxyHedgeMinSamples.value, 1);
+    numHedged = 0;
+    if(hedgePercentile > 0.0 && hedgePercentile < 1.0)
+    {
+        maxHedged = MAX(static_cast<int>(ceil(numResources * (1.0 - hedgePercentile))), 1);
+    }
+    else
+    {
+        maxHedged = 0; // hedging disabled
+    }
+
     /* Proxy Active */
     active.store(true);
 
@@ -224,8 +259,17 @@ EndpointProxy::~EndpointProxy (void)
     for(int i = 0; i < numResources; i++)
     {
         if(nodes[i]) delete nodes[i];
+        if(hedgeNodes[i]) delete hedgeNodes[i];
     }
     delete [] nodes;
+    delete [] hedgeNodes;
+
+    /* Delete Hedging State */
+    delete [] streams;
+    delete [] startTimes;
+    delete [] outstanding;
+    delete [] hedged;
+    delete [] complete;
 
     /* Delete Allocated Memory */
     delete [] endpoint;
@@ -326,16 +370,7 @@ void* EndpointProxy::collatorThread (void* parm)
                 proxy->nodes[current_resource] = nodes->at(i);
 
                 /* Post Request to Proxy Threads */
-                int status = MsgQ::STATE_TIMEOUT;
-                while(proxy->active.load() && (status == MsgQ::STATE_TIMEOUT))
-                {
-                    status = proxy->rqstPub->postCopy(&current_resource, sizeof(current_resource), SYS_TIMEOUT);
-                    if(status < 0)
-                    {
-                        alert(ERROR, RTE_FAILURE, proxy->outQ, NULL, "Failed (%d) to post request for %s", status, proxy->resources[current_resource]);
-                        break;
-                    }
-                }
+                proxy->postRequest(current_resource, PRIMARY_ATTEMPT);
 
                 /* Bump Current Resource */
                 current_resource++;
@@ -357,15 +392,32 @@ void* EndpointProxy::collatorThread (void* parm)
         }
     }
 
-    /* Check if All Resources Completed */
-    proxy->completion.lock();
+    /* Wait for All Resources to Complete (hedging stragglers) */
+    while(proxy->active.load())
     {
-        while(proxy->active.load() && (proxy->numResourcesComplete < proxy->numResources))
+        bool all_complete = false;
+        vector<int> stragglers;
+        proxy->completion.lock();
+        {
+            if(proxy->numResourcesComplete < proxy->numResources)
+            {
+                proxy->completion.wait(0, SYS_TIMEOUT);
+            }
+            all_complete = proxy->numResourcesComplete >= proxy->numResources;
+            if(!all_complete) proxy->findStragglers(stragglers);
+        }
+        proxy->completion.unlock();
+
+        /* Exit When Complete */
+        if(all_complete) break;
+
+        /* Send Duplicate Requests for Stragglers */
+        for(const int resource: stragglers)
         {
-            proxy->completion.wait(0, SYS_TIMEOUT);
+            if(proxy->outQ->getSubCnt() <= 0) break;
+            proxy->hedgeResource(resource, service);
         }
     }
-    proxy->completion.unlock();
 
     /* Send Terminator */
     if(proxy->sendTerminator)
@@ -404,21 +456,36 @@ void* EndpointProxy::proxyThread (void* parm)
     while(proxy->active.load())
     {
         /* Receive Request */
-        int current_resource;
-        const int recv_status = proxy->rqstSub->receiveCopy(&current_resource, sizeof(current_resource), SYS_TIMEOUT);
+        rqst_t rqst;
+        const int recv_status = proxy->rqstSub->receiveCopy(&rqst, sizeof(rqst), SYS_TIMEOUT);
         if(recv_status > 0)
         {
             /* Get Resource and Node */
+            const int current_resource = rqst.resource;
+            const bool is_hedge = (rqst.attempt == HEDGED_ATTEMPT);
             const char* resource = proxy->resources[current_resource];
-            OrchestratorLib::Node* node = proxy->nodes[current_resource];
+            OrchestratorLib::Node* node = is_hedge ? proxy->hedgeNodes[current_resource] : proxy->nodes[current_resource];
+            CurlLib::stream_t* stream = (proxy->maxHedged > 0) ? &proxy->streams[current_resource] : NULL; // only shared when hedging
             bool valid = false; // set to true on success
+            bool lost = false; // set to true when a competing attempt owns the output stream
             bool need_to_free_node = false; // set to true when retries occur
             long failed_transactions[NUM_RETRIES];
             int num_failed = 0;
 
-            /* Make (possibly multiple) Request(s) */
+            /* Start Processing Resource */
+            if(!is_hedge)
+            {
+                proxy->completion.lock();
+                {
+                    proxy->startTimes[current_resource] = TimeLib::latchtime();
+                    proxy->outstanding[current_resource]++;
+                }
+                proxy->completion.unlock();
+            }
+
+            /* Make (possibly multiple) Request(s) - retries stop once a competing attempt owns the stream */
             int attempts = NUM_RETRIES;
-            while(!valid && attempts-- > 0 && node)
+            while(!valid && !lost && attempts-- > 0 && node)
             {
                 /* Make Request */
                 if(proxy->outQ->getSubCnt() > 0)
@@ -427,8 +494,10 @@ void* EndpointProxy::proxyThread (void* parm)
                     {
                         const FString url("%s/source/%s", node->member, proxy->endpoint);
                         const FString data("{\"resource\": \"%s\", \"key_space\": %d, \"parms\": %s}", resource, current_resource, proxy->parameters);
-                        const long http_code = CurlLib::postAsRecord(url.c_str(), data.c_str(), proxy->outQ, false, proxy->timeout, &proxy->active, &headers);
-                        if(http_code == EndpointObject::OK) valid = true;
+                        const long http_code = CurlLib::postAsRecord(url.c_str(), data.c_str(), proxy->outQ, false, proxy->timeout, &proxy->active, &headers, stream, rqst.attempt);
+                        const attempt_status_t status = checkAttempt(stream, rqst.attempt, http_code);
+                        if(status == ATTEMPT_VALID) valid = true;
+                        else if(status == ATTEMPT_LOST) lost = true;
                         else throw RunTimeException(CRITICAL, RTE_FAILURE, "Error code returned from request to %s: %d", node->member, (int)http_code);
                     }
                     catch(const RunTimeException& e)
@@ -437,8 +506,8 @@ void* EndpointProxy::proxyThread (void* parm)
                     }
                 }
 
-                /* Unlock Node (on success) */
-                if(valid) OrchestratorLib::unlock(&node->transaction, 1);
+                /* Unlock Node (on success or when abandoned to a competing attempt) */
+                if(valid || lost) OrchestratorLib::unlock(&node->transaction, 1);
                 else failed_transactions[num_failed++] = node->transaction;
 
                 /* Reset Node */
@@ -446,7 +515,7 @@ void* EndpointProxy::proxyThread (void* parm)
                 node = NULL;
 
                 /* Handle Retry on Failure */
-                if(!valid && attempts > 0)
+                if(!valid && !lost && attempts > 0)
                 {
                     mlog(CRITICAL, "Retrying processing resource [%d out of %d]: %s", current_resource + 1, proxy->numResources, resource);
                     while(proxy->active.load() && (proxy->outQ->getSubCnt() > 0) && !node)
@@ -491,23 +560,15 @@ void* EndpointProxy::proxyThread (void* parm)
                 OrchestratorLib::unlock(failed_transactions, num_failed);
             }
 
-            /* Post Status */
-            const int code = valid ? RTE_STATUS : RTE_FAILURE;
-            const event_level_t level = valid ? INFO : ERROR;
-            alert(level, code, proxy->outQ, NULL, "%s processing resource [%d out of %d]: %s",
-                                                    valid ? "Successfully completed" : "Failed to complete",
-                                                    current_resource + 1, proxy->numResources, resource);
-
-            /* Resource Completed */
-            proxy->completion.lock();
+            /* Report Abandoned Attempt */
+            if(lost)
             {
-                proxy->numResourcesComplete++;
-                if(proxy->numResourcesComplete >= proxy->numResources)
-                {
-                    proxy->completion.signal();
-                }
+                mlog(INFO, "Abandoned %s request for resource [%d out of %d] to competing request: %s",
+                            is_hedge ? "hedged" : "primary", current_resource + 1, proxy->numResources, resource);
             }
-            proxy->completion.unlock();
+
+            /* Attempt Completed */
+            proxy->completeAttempt(current_resource, valid);
         }
         else if(recv_status != MsgQ::STATE_TIMEOUT)
         {
@@ -518,3 +579,203 @@ void* EndpointProxy::proxyThread (void* parm)
 
     return NULL;
 }
+
+/*----------------------------------------------------------------------------
+ * postRequest
+ *----------------------------------------------------------------------------*/
+bool EndpointProxy::postRequest (int resource, int attempt)
+{
+    const rqst_t rqst = {
+        .resource = resource,
+        .attempt = attempt
+    };
+
+    int status = MsgQ::STATE_TIMEOUT;
+    while(active.load() && (status == MsgQ::STATE_TIMEOUT))
+    {
+        status = rqstPub->postCopy(&rqst, sizeof(rqst), SYS_TIMEOUT);
+        if(status < 0)
+        {
+            alert(ERROR, RTE_FAILURE, outQ, NULL, "Failed (%d) to post request for %s", status, resources[resource]);
+            break;
+        }
+    }
+
+    return status > 0;
+}
+
+/*----------------------------------------------------------------------------
+ * completeAttempt
+ *
+ *  a resource is complete when any attempt succeeds, or when it has failed
+ *  and no other attempt is still outstanding
+ *----------------------------------------------------------------------------*/
+void EndpointProxy::completeAttempt (int resource, bool valid)
+{
+    bool report = false;
+
+    /* Check if Resource Complete */
+    completion.lock();
+    {
+        outstanding[resource]--;
+        if(!complete[resource] && (valid || (outstanding[resource] <= 0)))
+        {
+            complete[resource] = true;
+            if(valid) durations.push_back(TimeLib::latchtime() - startTimes[resource]);
+            report = true;
+        }
+    }
+    completion.unlock();
+
+    /* Resource Completed */
+    if(report)
+    {
+        /* Post Status */
+        const int code = valid ? RTE_STATUS : RTE_FAILURE;
+        const event_level_t level = valid ? INFO : ERROR;
+        alert(level, code, outQ, NULL, "%s processing resource [%d out of %d]: %s",
+                                        valid ? "Successfully completed" : "Failed to complete",
+                                        resource + 1, numResources, resources[resource]);
+
+        /* Signal Completion (after status so it precedes terminator) */
+        completion.lock();
+        {
+            numResourcesComplete++;
+            if(numResourcesComplete >= numResources)
+            {
+                completion.signal();
+            }
+        }
+        completion.unlock();
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * findStragglers
+ *
+ *  must be called with completion locked
+ *----------------------------------------------------------------------------*/
+void EndpointProxy::findStragglers (vector<int>& stragglers)
+{
+    /* Check if Hedging Possible */
+    if((numHedged >= maxHedged) || (durations.size() < static_cast<size_t>(hedgeMinSamples)))
+    {
+        return;
+    }
+
+    /* Calculate Threshold from Distribution of Completed Resources */
+    const double threshold = hedgeThreshold(durations, hedgePercentile);
+
+    /* Find Resources Running Longer than Threshold */
+    const double now = TimeLib::latchtime();
+    for(int i = 0; (i < numResources) && ((numHedged + static_cast<int>(stragglers.size())) < maxHedged); i++)
+    {
+        if(!complete[i] && !hedged[i] && (outstanding[i] > 0) && ((now - startTimes[i]) > threshold))
+        {
+            stragglers.push_back(i);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * hedgeResource
+ *
+ *  speculatively sends a duplicate request for the resource to another node;
+ *  whichever request first posts data claims the output stream and the other
+ *  request is aborted
+ *----------------------------------------------------------------------------*/
+void EndpointProxy::hedgeResource (int resource, const char* service)
+{
+    /* Lock Node for Duplicate Request */
+    OrchestratorLib::Node* node = NULL;
+    vector<OrchestratorLib::Node*>* locked_nodes = OrchestratorLib::lock(service, 1, timeout, locksPerNode);
+    if(locked_nodes)
+    {
+        for(unsigned j = 0; j < locked_nodes->size(); j++)
+        {
+            if(!node) node = locked_nodes->at(j);
+            else delete locked_nodes->at(j);
+        }
+        delete locked_nodes;
+    }
+
+    /* Check Node Available */
+    if(!node)
+    {
+        return; // try again on next poll
+    }
+
+    /* Commit to Hedging Resource */
+    bool commit = false;
+    completion.lock();
+    {
+        const bool same_node = nodes[resource] && StringLib::match(nodes[resource]->member, node->member);
+        if(!complete[resource] && !hedged[resource] && !same_node)
+        {
+            hedged[resource] = true;
+            hedgeNodes[resource] = node;
+            outstanding[resource]++;
+            numHedged++;
+            commit = true;
+        }
+    }
+    completion.unlock();
+
+    /* Post Duplicate Request */
+    if(commit)
+    {
+        mlog(INFO, "Hedging straggling resource [%d out of %d] on %s: %s", resource + 1, numResources, node->member, resources[resource]);
+        if(!postRequest(resource, HEDGED_ATTEMPT))
+        {
+            OrchestratorLib::unlock(&node->transaction, 1);
+            completeAttempt(resource, false);
+        }
+    }
+    else
+    {
+        OrchestratorLib::unlock(&node->transaction, 1);
+        delete node;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * checkAttempt
+ *
+ *  a successful attempt is valid only if it owns the output stream (the
+ *  response could have been status records only, in which case it claims
+ *  the stream here); a failed attempt is retried unless a competing attempt
+ *  owns the stream - including when this attempt owned the stream and then
+ *  failed, so that the winner of a hedge is still retried
+ *----------------------------------------------------------------------------*/
+EndpointProxy::attempt_status_t EndpointProxy::checkAttempt (CurlLib::stream_t* stream, int attempt, long http_code)
+{
+    if(!stream)
+    {
+        return (http_code == EndpointObject::OK) ? ATTEMPT_VALID : ATTEMPT_FAILED;
+    }
+
+    int owner = CurlLib::STREAM_UNCLAIMED;
+    if(http_code == EndpointObject::OK)
+    {
+        stream->owner.compare_exchange_strong(owner, attempt);
+        owner = stream->owner.load();
+        return (owner == attempt) ? ATTEMPT_VALID : ATTEMPT_LOST;
+    }
+
+    owner = stream->owner.load();
+    return ((owner == CurlLib::STREAM_UNCLAIMED) || (owner == attempt)) ? ATTEMPT_FAILED : ATTEMPT_LOST;
+}
+
+/*----------------------------------------------------------------------------
+ * hedgeThreshold
+ *
+ *  processing time at the given percentile of the completed resources;
+ *  durations must not be empty
+ *----------------------------------------------------------------------------*/
+double EndpointProxy::hedgeThreshold (const vector<double>& durations, float percentile)
+{
+    vector<double> sorted_durations(durations);
+    const size_t index = MIN(static_cast<size_t>(percentile * sorted_durations.size()), sorted_durations.size() - 1);
+    std::nth_element(sorted_durations.begin(), sorted_durations.begin() + index, sorted_durations.end());
+    return sorted_durations[index];
+}
@@ -42,6 +42,7 @@
 #include "MsgQ.h"
 #include "OsApi.h"
 #include "OrchestratorLib.h"
+#include "CurlLib.h"
 
 /******************************************************************************
  * ATL03 READER
@@ -60,6 +61,14 @@ class EndpointProxy: public LuaObject
         static const int MAX_PROXY_THREADS = 200;
         static const int DEFAULT_PROXY_THREADS = 40; // when no better method to determine is available
         static const int NUM_RETRIES = 3;
+        static const int PRIMARY_ATTEMPT = 0;
+        static const int HEDGED_ATTEMPT = 1;
+
+        typedef enum {
+            ATTEMPT_VALID,      // attempt owns the output stream and succeeded
+            ATTEMPT_LOST,       // a competing attempt owns the output stream
+            ATTEMPT_FAILED      // attempt failed and can be retried
+        } attempt_status_t;
 
         static const char* OBJECT_TYPE;
         static const char* LUA_META_NAME;
@@ -73,6 +82,17 @@ class EndpointProxy: public LuaObject
 
     private:
 
+        friend class UT_EndpointProxy; // necessary for testing stream ownership
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        typedef struct {
+            int                 resource;
+            int                 attempt; // PRIMARY_ATTEMPT or HEDGED_ATTEMPT
+        } rqst_t;
+
         /*--------------------------------------------------------------------
          * Data
          *--------------------------------------------------------------------*/
@@ -84,9 +104,18 @@ class EndpointProxy: public LuaObject
         Thread*                 collatorPid;
         const char**            resources;
         OrchestratorLib::Node** nodes;
+        OrchestratorLib::Node** hedgeNodes;
+        CurlLib::stream_t*      streams; // output stream shared by the attempts of each resource
         int                     numResources;
         int                     numResourcesComplete;
-        Cond                    completion;
+        Cond                    completion; // protects everything below
+        double*                 startTimes;
+        int*                    outstanding;
+        bool*                   hedged;
+        bool*                   complete;
+        vector<double>          durations; // processing times of completed resources
+        int                     numHedged;
+        int                     maxHedged;
         const char*             endpoint;
         const char*             parameters;
         const char*             sourceIP;
@@ -95,6 +124,8 @@ class EndpointProxy: public LuaObject
         Publisher*              outQ;
         int                     numProxyThreads;
         bool                    sendTerminator;
+        float                   hedgePercentile;
+        int                     hedgeMinSamples;
 
         /*--------------------------------------------------------------------
          * Methods
@@ -110,6 +141,12 @@ class EndpointProxy: public LuaObject
         static int          luaNumProxyThreads      (lua_State* L);
         static void*        collatorThread          (void* parm);
         static void*        proxyThread             (void* parm);
+        bool                postRequest             (int resource, int attempt);
+        void                completeAttempt         (int resource, bool valid);
+        void                findStragglers          (vector<int>& stragglers);
+        void                hedgeResource           (int resource, const char* service);
+        static attempt_status_t checkAttempt        (CurlLib::stream_t* stream, int attempt, long http_code);
+        static double       hedgeThreshold          (const vector<double>& durations, float percentile);
 };
 
 #endif  /* __endpoint_proxy__ */
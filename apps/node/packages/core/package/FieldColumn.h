@@ -46,6 +46,7 @@
 #include "FieldList.h"
 #include "FieldArray.h"
 #include "FieldElement.h"
+#include "RequestArena.h"
 
 using std::unordered_map;
 
@@ -105,6 +106,8 @@ class FieldColumn: public FieldUntypedColumn
         long            append          (const T& v);
         long            appendBuffer    (const uint8_t* buffer, long size);
         long            appendValue     (const T& v, long size);
+        template<class F>
+        long            appendEach      (long size, F f);
         void            initialize      (long size, const T& v);
 
         void            clear           (void) override;
@@ -132,10 +135,14 @@ class FieldColumn: public FieldUntypedColumn
         int             toLua           (lua_State* L, long key) const override;
         void            fromLua         (lua_State* L, int index) override;
 
+        T*              allocChunk      (long size);
+        void            freeChunk       (T* chunk);
+
         /*--------------------------------------------------------------------
          * Data
          *--------------------------------------------------------------------*/
 
+        shared_ptr<RequestArena> arena; // request arena chunks are carved from, NULL for heap
         vector<T*> chunks;
         long currChunk;
         long currChunkOffset;
@@ -344,6 +351,7 @@ inline FieldUntypedColumn::column_t toDoubles(const FieldColumn<FieldColumn<stri
 template<class T>
 FieldColumn<T>::FieldColumn(uint32_t encoding_mask, long _chunk_size):
     FieldUntypedColumn(getImpliedEncoding<T>() | encoding_mask),
+    arena(RequestArena::current()),
     currChunk(-1),
     currChunkOffset(_chunk_size),
     numElements(0),
@@ -356,7 +364,8 @@ FieldColumn<T>::FieldColumn(uint32_t encoding_mask, long _chunk_size):
  *----------------------------------------------------------------------------*/
 template<class T>
 FieldColumn<T>::FieldColumn(const uint8_t* buffer, long size, uint32_t encoding_mask):
-    FieldUntypedColumn(getImpliedEncoding<T>() | encoding_mask)
+    FieldUntypedColumn(getImpliedEncoding<T>() | encoding_mask),
+    arena(RequestArena::current())
 {
     assert(size > 0);
     assert(size % sizeof(T) == 0);
@@ -366,9 +375,9 @@ FieldColumn<T>::FieldColumn(const uint8_t* buffer, long size, uint32_t encoding_
     currChunk = 0;
     currChunkOffset = num_elements;
     numElements = num_elements;
-    chunkSize = size;
+    chunkSize = num_elements;
 
-    T* column_ptr = new T[num_elements];
+    T* column_ptr = allocChunk(num_elements);
     const T* buf_ptr = reinterpret_cast<const T*>(buffer);
     for(long i = 0; i < num_elements; i++)
     {
@@ -384,6 +393,7 @@ FieldColumn<T>::FieldColumn(const uint8_t* buffer, long size, uint32_t encoding_
 template<class T>
 FieldColumn<T>::FieldColumn(const FieldColumn<T>& column):
     FieldUntypedColumn(getImpliedEncoding<T>()),
+    arena(RequestArena::current()),
     currChunk(column.currChunk),
     currChunkOffset(column.currChunkOffset),
     numElements(column.numElements),
@@ -392,7 +402,7 @@ FieldColumn<T>::FieldColumn(const FieldColumn<T>& column):
     // all but last chunk
     for(long c = 0; c < currChunk; c++)
     {
-        T* chunk = new T[chunkSize];
+        T* chunk = allocChunk(chunkSize);
         for(long i = 0; i < chunkSize; i++)
         {
             chunk[i] = column.chunks[c][i];
@@ -402,7 +412,7 @@ FieldColumn<T>::FieldColumn(const FieldColumn<T>& column):
     // last chunk
     if(currChunk >= 0)
     {
-        T* chunk = new T[chunkSize];
+        T* chunk = allocChunk(chunkSize);
         for(long i = 0; i < currChunkOffset; i++)
         {
             chunk[i] = column.chunks[currChunk][i];
@@ -419,7 +429,7 @@ FieldColumn<T>::~FieldColumn(void)
 {
     for(T* chunk: chunks)
     {
-        delete [] chunk;
+        freeChunk(chunk);
     }
 }
 
@@ -436,7 +446,7 @@ long FieldColumn<T>::append(const T& v)
     }
     else
     {
-        T* chunk = new T[chunkSize];
+        T* chunk = allocChunk(chunkSize);
         chunk[0] = v;
         chunks.push_back(chunk);
         currChunk++;
@@ -473,7 +483,7 @@ long FieldColumn<T>::appendBuffer(const uint8_t* buffer, long size)
         elements_remaining -= elements_to_copy;
         if(currChunkOffset == chunkSize)
         {
-            T* chunk = new T[chunkSize];
+            T* chunk = allocChunk(chunkSize);
             chunks.push_back(chunk);
             currChunkOffset = 0;
             currChunk++;
@@ -505,13 +515,49 @@ long FieldColumn<T>::appendValue(const T& v, long size)
         elements_remaining -= elements_to_copy;
         if(currChunkOffset == chunkSize)
         {
-            T* chunk = new T[chunkSize];
+            T* chunk = allocChunk(chunkSize);
+            chunks.push_back(chunk);
+            currChunkOffset = 0;
+            currChunk++;
+        }
+    }
+
+    return numElements;
+}
+
+/*----------------------------------------------------------------------------
+ * appendEach
+ *
+ *  appends f(i) for i in [0, size); each chunk is filled in a single loop
+ *  so gathering a column from a selection of indices stays tight
+ *----------------------------------------------------------------------------*/
+template<class T>
+template<class F>
+long FieldColumn<T>::appendEach(long size, F f)
+{
+    long i = 0;
+    while(i < size)
+    {
+        if(currChunkOffset == chunkSize)
+        {
+            T* chunk = allocChunk(chunkSize);
             chunks.push_back(chunk);
             currChunkOffset = 0;
             currChunk++;
         }
+
+        const long elements_to_copy = MIN(chunkSize - currChunkOffset, size - i);
+        T* chunk_ptr = &chunks[currChunk][currChunkOffset];
+        for(long k = 0; k < elements_to_copy; k++)
+        {
+            chunk_ptr[k] = f(i + k);
+        }
+
+        currChunkOffset += elements_to_copy;
+        i += elements_to_copy;
     }
 
+    numElements += size;
     return numElements;
 }
 
@@ -525,7 +571,7 @@ void FieldColumn<T>::initialize(long size, const T& v)
     chunkSize = size;
     currChunkOffset = size;
     currChunk = 0;
-    T* chunk = new T[chunkSize];
+    T* chunk = allocChunk(chunkSize);
     for(int i = 0; i < chunkSize; i++)
     {
         chunk[i] = v;
@@ -543,7 +589,7 @@ void FieldColumn<T>::clear(void)
     // delete all chunks
     for(T* chunk: chunks)
     {
-        delete [] chunk;
+        freeChunk(chunk);
     }
     chunks.clear();
 
@@ -683,7 +729,7 @@ long FieldColumn<T>::filter (const vector<uint8_t>& mask)
     vector<T*> new_chunks;
     long src_element = 0;
     long dst_offset = 0;
-    T* chunk = new T[chunkSize];
+    T* chunk = allocChunk(chunkSize);
 
     // all but last chunk
     for(long src_c = 0; src_c < currChunk; src_c++)
@@ -696,7 +742,7 @@ long FieldColumn<T>::filter (const vector<uint8_t>& mask)
                 if(dst_offset == chunkSize)
                 {
                     new_chunks.push_back(chunk);
-                    chunk = new T[chunkSize];
+                    chunk = allocChunk(chunkSize);
                     dst_offset = 0;
                 }
             }
@@ -713,12 +759,18 @@ long FieldColumn<T>::filter (const vector<uint8_t>& mask)
                 if(dst_offset == chunkSize)
                 {
                     new_chunks.push_back(chunk);
-                    chunk = new T[chunkSize];
+                    chunk = allocChunk(chunkSize);
                     dst_offset = 0;
                 }
             }
         }
     }
+    new_chunks.push_back(chunk);
+    // free filtered chunks
+    for(T* old_chunk: chunks)
+    {
+        freeChunk(old_chunk);
+    }
     // set members
     chunks = new_chunks;
     currChunk = new_chunks.size() - 1;
@@ -949,4 +1001,45 @@ void FieldColumn<T>::fromLua (lua_State* L, int index)
     }
 }
 
+/*----------------------------------------------------------------------------
+ * allocChunk
+ *
+ *  chunks of trivially destructible types come out of the request arena the
+ *  column was created under; everything else (e.g. strings) uses the heap
+ *----------------------------------------------------------------------------*/
+template<class T>
+T* FieldColumn<T>::allocChunk (long size)
+{
+    if constexpr (std::is_trivially_destructible_v<T>)
+    {
+        if(arena)
+        {
+            T* chunk = arena->allocate<T>(size);
+            std::uninitialized_default_construct_n(chunk, size);
+            return chunk;
+        }
+    }
+    return new T[size];
+}
+
+/*----------------------------------------------------------------------------
+ * freeChunk
+ *
+ *  arena chunks are handed back to the arena so that slabs can be unmapped
+ *  before the request completes; every chunk holds chunkSize elements
+ *----------------------------------------------------------------------------*/
+template<class T>
+void FieldColumn<T>::freeChunk (T* chunk)
+{
+    if constexpr (std::is_trivially_destructible_v<T>)
+    {
+        if(arena)
+        {
+            arena->release<T>(chunk, chunkSize);
+            return;
+        }
+    }
+    delete [] chunk;
+}
+
 #endif  /* __field_column__ */
@@ -0,0 +1,643 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __field_ragged_column__
+#define __field_ragged_column__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <limits>
+#include <type_traits>
+
+#include "OsApi.h"
+#include "MathLib.h"
+#include "LuaEngine.h"
+#include "Field.h"
+#include "FieldList.h"
+#include "FieldColumn.h"
+#include "RequestArena.h"
+
+/******************************************************************************
+ * CLASS
+ ******************************************************************************/
+
+/*
+ * FieldUntypedRaggedColumn
+ *
+ *  non-templated view of a ragged column so that code walking a dataframe
+ *  can recognize the flat layout without knowing the value type
+ */
+struct FieldUntypedRaggedColumn: public FieldUntypedColumn
+{
+    explicit FieldUntypedRaggedColumn (uint32_t _encoding=0): FieldUntypedColumn(_encoding) {};
+    ~FieldUntypedRaggedColumn (void) = default;
+
+    virtual long numValues (void) const = 0;
+    virtual long rowLength (long i) const = 0;
+};
+
+/*
+ * FieldRaggedColumn
+ *
+ *  column of variable length lists stored as one flat buffer of values and
+ *  an offsets array (offsets[i] to offsets[i+1] are the values of row i);
+ *  this is the Arrow list layout, so the buffers can be handed to Arrow
+ *  as is, and it is encoded as a NESTED_LIST so it is interchangeable on
+ *  the wire with a FieldColumn<FieldList<T>>
+ */
+template <class T>
+class FieldRaggedColumn: public FieldUntypedRaggedColumn
+{
+    static_assert(std::is_trivially_copyable_v<T>, "ragged column values must be trivially copyable");
+
+    public:
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        explicit        FieldRaggedColumn   (uint32_t encoding_mask=0);
+                        ~FieldRaggedColumn  (void) override = default;
+
+        long            append          (const FieldList<T>& list);
+        long            appendList      (const T* data, long size);
+        long            appendList      (const T* data, long size, long padded_size, const T& fill);
+        long            appendBuffer    (const uint8_t* buffer, long num_rows);
+        void            reserve         (long num_rows, long num_values);
+
+        void            clear           (void) override;
+        long            length          (void) const override;
+        long            serialize       (uint8_t* buffer, size_t size) const override;
+
+        long            numValues       (void) const override;
+        long            rowLength       (long i) const override;
+        const T*        rowData         (long i) const;
+
+        long            raw             (uint8_t* buffer, size_t size, long element) const override;
+        Field*          row             (long element) const override;
+        long            filter          (const vector<uint8_t>& mask) override;
+
+        double          sum             (long start_index = 0, long num_elements = -1) const override;
+        double          mean            (long start_index = 0, long num_elements = -1) const override;
+        double          median          (long start_index = 0, long num_elements = -1) const override;
+        double          mode            (long start_index = 0, long num_elements = -1) const override;
+        unique_map_t    unique          (long start_index = 0, long num_elements = -1, long scale = 1) const override;
+
+        string          toOpenApi       (const char* description) const override;
+        string          toJson          (void) const override;
+        int             toLua           (lua_State* L) const override;
+        int             toLua           (lua_State* L, long key) const override;
+        void            fromLua         (lua_State* L, int index) override;
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        vector<T, ArenaAllocator<T>> values;               // allocated from the request arena when one is bound
+        vector<int32_t, ArenaAllocator<int32_t>> offsets;  // num rows + 1, int32 to match arrow::ListArray
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        void            checkCapacity   (long size) const;
+        column_t        toDoubles       (long start_index, long num_elements) const;
+};
+
+/******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+template<class T>
+inline double raggedToDouble(const T& v) {
+    return static_cast<double>(v);
+}
+inline double raggedToDouble(const time8_t& v) {
+    return static_cast<double>(v.nanoseconds);
+}
+
+/******************************************************************************
+ * METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+template<class T>
+FieldRaggedColumn<T>::FieldRaggedColumn(uint32_t encoding_mask):
+    FieldUntypedRaggedColumn(Field::NESTED_LIST | getImpliedEncoding<T>() | encoding_mask),
+    offsets{0}
+{
+}
+
+/*----------------------------------------------------------------------------
+ * append
+ *----------------------------------------------------------------------------*/
+template<class T>
+long FieldRaggedColumn<T>::append(const FieldList<T>& list)
+{
+    return appendList(list.values.data(), static_cast<long>(list.values.size()));
+}
+
+/*----------------------------------------------------------------------------
+ * appendList - bulk copy one row
+ *----------------------------------------------------------------------------*/
+template<class T>
+long FieldRaggedColumn<T>::appendList(const T* data, long size)
+{
+    checkCapacity(size);
+    values.insert(values.end(), data, data + size);
+    offsets.push_back(static_cast<int32_t>(values.size()));
+    return length();
+}
+
+/*----------------------------------------------------------------------------
+ * appendList - bulk copy one row and pad it out to a fixed length
+ *----------------------------------------------------------------------------*/
+template<class T>
+long FieldRaggedColumn<T>::appendList(const T* data, long size, long padded_size, const T& fill)
+{
+    const long row_size = MAX(size, padded_size);
+    checkCapacity(row_size);
+    values.insert(values.end(), data, data + size);
+    values.insert(values.end(), row_size - size, fill);
+    offsets.push_back(static_cast<int32_t>(values.size()));
+    return length();
+}
+
+/*----------------------------------------------------------------------------
+ * appendBuffer - rows in the serialized layout (see serialize)
+ *----------------------------------------------------------------------------*/
+template<class T>
+long FieldRaggedColumn<T>::appendBuffer(const uint8_t* buffer, long num_rows)
+{
+    const uint32_t* sizes_ptr = reinterpret_cast<const uint32_t*>(buffer);
+    const uint8_t* data_ptr = buffer + (sizeof(uint32_t) * num_rows);
+
+    // build offsets
+    long total_size = 0;
+    offsets.reserve(offsets.size() + num_rows);
+    for(long i = 0; i < num_rows; i++)
+    {
+        assert(sizes_ptr[i] % sizeof(T) == 0);
+        total_size += sizes_ptr[i] / sizeof(T);
+        checkCapacity(total_size);
+        offsets.push_back(static_cast<int32_t>(values.size() + total_size));
+    }
+
+    // copy values
+    const size_t start = values.size();
+    values.resize(start + total_size);
+    memcpy(reinterpret_cast<void*>(&values[start]), data_ptr, total_size * sizeof(T));
+
+    return length();
+}
+
+/*----------------------------------------------------------------------------
+ * reserve
+ *----------------------------------------------------------------------------*/
+template<class T>
+void FieldRaggedColumn<T>::reserve(long num_rows, long num_values)
+{
+    offsets.reserve(offsets.size() + num_rows);
+    values.reserve(values.size() + num_values);
+}
+
+/*----------------------------------------------------------------------------
+ * clear
+ *----------------------------------------------------------------------------*/
+template<class T>
+void FieldRaggedColumn<T>::clear(void)
+{
+    values.clear();
+    offsets.clear();
+    offsets.push_back(0);
+}
+
+/*----------------------------------------------------------------------------
+ * length
+ *----------------------------------------------------------------------------*/
+template<class T>
+long FieldRaggedColumn<T>::length(void) const
+{
+    return static_cast<long>(offsets.size()) - 1;
+}
+
+/*----------------------------------------------------------------------------
+ * serialize
+ *
+ *  uint32_t   size_of_row_list_in_bytes [num_rows]
+ *  T          row_list [num_rows][elements_in_list]
+ *
+ *  same layout GeoDataFrame uses for nested list columns, written with one
+ *  copy of the values instead of one per row
+ *----------------------------------------------------------------------------*/
+template<class T>
+long FieldRaggedColumn<T>::serialize (uint8_t* buffer, size_t size) const
+{
+    const long num_rows = length();
+    const size_t size_of_sizes = sizeof(uint32_t) * num_rows;
+    const size_t size_of_values = sizeof(T) * values.size();
+    if(size_of_sizes + size_of_values > size) return 0;
+
+    uint32_t* sizes_ptr = reinterpret_cast<uint32_t*>(buffer);
+    for(long i = 0; i < num_rows; i++)
+    {
+        sizes_ptr[i] = static_cast<uint32_t>(offsets[i + 1] - offsets[i]) * sizeof(T);
+    }
+    memcpy(&buffer[size_of_sizes], reinterpret_cast<const void*>(values.data()), size_of_values);
+
+    return static_cast<long>(size_of_sizes + size_of_values);
+}
+
+/*----------------------------------------------------------------------------
+ * numValues
+ *----------------------------------------------------------------------------*/
+template<class T>
+long FieldRaggedColumn<T>::numValues(void) const
+{
+    return static_cast<long>(values.size());
+}
+
+/*----------------------------------------------------------------------------
+ * rowLength
+ *----------------------------------------------------------------------------*/
+template<class T>
+long FieldRaggedColumn<T>::rowLength(long i) const
+{
+    return offsets[i + 1] - offsets[i];
+}
+
+/*----------------------------------------------------------------------------
+ * rowData
+ *----------------------------------------------------------------------------*/
+template<class T>
+const T* FieldRaggedColumn<T>::rowData(long i) const
+{
+    return values.data() + offsets[i];
+}
+
+/*----------------------------------------------------------------------------
+ * raw - first value of the row (zero when empty), one element wide like
+ *       the other nested columns
+ *----------------------------------------------------------------------------*/
+template<class T>
+long FieldRaggedColumn<T>::raw (uint8_t* buffer, size_t size, long element) const
+{
+    (void)size;
+
+    assert(sizeof(T) <= size);
+    assert(element >= 0);
+    assert(element < length());
+
+    if(rowLength(element) > 0) memcpy(reinterpret_cast<void*>(buffer), reinterpret_cast<const void*>(rowData(element)), sizeof(T));
+    else memset(buffer, 0, sizeof(T));
+
+    return sizeof(T);
+}
+
+/*----------------------------------------------------------------------------
+ * row
+ *----------------------------------------------------------------------------*/
+template<class T>
+Field* FieldRaggedColumn<T>::row (long element) const
+{
+    FieldList<T>* list = new FieldList<T>();
+    list->values.assign(rowData(element), rowData(element) + rowLength(element));
+    return list;
+}
+
+/*----------------------------------------------------------------------------
+ * filter - compacts kept rows in place
+ *----------------------------------------------------------------------------*/
+template<class T>
+long FieldRaggedColumn<T>::filter (const vector<uint8_t>& mask)
+{
+    const long num_rows = length();
+    long dst_row = 0;
+    int32_t src_start = offsets[0];
+    for(long src_row = 0; src_row < num_rows; src_row++)
+    {
+        const int32_t src_end = offsets[src_row + 1];
+        if(mask[src_row] == 1)
+        {
+            const int32_t dst_start = offsets[dst_row];
+            if(dst_start != src_start)
+            {
+                std::copy(values.begin() + src_start, values.begin() + src_end, values.begin() + dst_start);
+            }
+            offsets[++dst_row] = dst_start + (src_end - src_start);
+        }
+        src_start = src_end;
+    }
+    offsets.resize(dst_row + 1);
+    values.resize(offsets[dst_row]);
+    return length();
+}
+
+/*----------------------------------------------------------------------------
+ * FieldUntypedColumn - sum
+ *----------------------------------------------------------------------------*/
+template<class T>
+double FieldRaggedColumn<T>::sum (long start_index, long num_elements) const
+{
+    if(num_elements < 0) num_elements = length();
+    if(num_elements == 0) return 0.0;
+    double acc = 0;
+    column_t column = toDoubles(start_index, num_elements);
+    for(long i = 0; i < column.size; i++)
+    {
+        acc += column.data[i];
+    }
+    delete [] column.data;
+    return acc;
+}
+
+/*----------------------------------------------------------------------------
+ * FieldUntypedColumn - mean
+ *----------------------------------------------------------------------------*/
+template<class T>
+double FieldRaggedColumn<T>::mean (long start_index, long num_elements) const
+{
+    if(num_elements < 0) num_elements = length();
+    if(num_elements == 0) return 0.0;
+    double avg;
+    column_t column = toDoubles(start_index, num_elements);
+    double acc = 0;
+    for(long i = 0; i < column.size; i++)
+    {
+        if(column.data[i] < std::numeric_limits<float>::max())
+        {
+            acc += column.data[i];
+        }
+    }
+    avg = acc / static_cast<double>(num_elements);
+    delete [] column.data;
+    return avg;
+}
+
+/*----------------------------------------------------------------------------
+ * FieldUntypedColumn - median
+ *----------------------------------------------------------------------------*/
+template<class T>
+double FieldRaggedColumn<T>::median (long start_index, long num_elements) const
+{
+    if(num_elements < 0) num_elements = length();
+    if(num_elements == 0) return 0.0;
+    column_t column = toDoubles(start_index, num_elements);
+    if(column.size == 0)
+    {
+        delete [] column.data;
+        return 0.0;
+    }
+    double avg;
+    MathLib::quicksort(column.data, 0, column.size - 1);
+    if(column.size % 2 == 0) // even
+    {
+        const long i0 = (column.size - 1) / 2;
+        const long i1 = ((column.size - 1) / 2) + 1;
+        avg = (column.data[i0] + column.data[i1]) / 2.0;
+    }
+    else // odd
+    {
+        const long i0 = (column.size - 1) / 2;
+        avg = column.data[i0];
+    }
+    delete [] column.data;
+    return avg;
+}
+
+/*----------------------------------------------------------------------------
+ * FieldUntypedColumn - mode
+ *----------------------------------------------------------------------------*/
+template<class T>
+double FieldRaggedColumn<T>::mode (long start_index, long num_elements) const
+{
+    if(num_elements < 0) num_elements = length();
+    if(num_elements == 0) return 0.0;
+    column_t column = toDoubles(start_index, num_elements);
+    if(column.size == 0)
+    {
+        delete [] column.data;
+        return 0.0;
+    }
+    MathLib::quicksort(column.data, 0, column.size - 1);
+    double avg = column.data[0];
+    long highest_consecutive = 1;
+    long current_consecutive = 1;
+    for(long i = 1; i < column.size; i++)
+    {
+        if(column.data[i] == column.data[i-1])
+        {
+            current_consecutive++;
+            if(current_consecutive > highest_consecutive)
+            {
+                highest_consecutive = current_consecutive;
+                avg = column.data[i];
+            }
+        }
+        else
+        {
+            current_consecutive = 1;
+        }
+    }
+    delete [] column.data;
+    return avg;
+}
+
+/*----------------------------------------------------------------------------
+ * FieldUntypedColumn - unique
+ *----------------------------------------------------------------------------*/
+template<class T>
+typename FieldRaggedColumn<T>::unique_map_t FieldRaggedColumn<T>::unique (long start_index, long num_elements, long scale) const
+{
+    unique_map_t unique_map;
+    if(num_elements < 0) num_elements = length();
+    if(num_elements > 0)
+    {
+        column_t column = toDoubles(start_index, num_elements);
+        for(long i = 0; i < column.size; i++)
+        {
+            const double value = column.data[i] * scale;
+            if(value >= static_cast<double>(std::numeric_limits<int64_t>::min()) &&
+               value <= static_cast<double>(std::numeric_limits<int64_t>::max()))
+            {
+                const int64_t scaled_key = static_cast<int64_t>(value);
+                unique_map[scaled_key]++; // no need to check, defaults to zero when doesn't exist
+            }
+        }
+        delete [] column.data;
+    }
+    return unique_map;
+}
+
+/*----------------------------------------------------------------------------
+ * toOpenApi
+ *----------------------------------------------------------------------------*/
+template <class T>
+string FieldRaggedColumn<T>::toOpenApi (const char* description) const
+{
+    return FString("{\"type\": \"array\", \"description\": \"%s\", \"items\": {\"type\": \"%s\", \"format\": \"%s\"}}",
+        description, this->getOpenApiType(), this->getOpenApiFormat()).c_str();
+}
+
+/*----------------------------------------------------------------------------
+ * toJson
+ *----------------------------------------------------------------------------*/
+template <class T>
+string FieldRaggedColumn<T>::toJson (void) const
+{
+    const long num_rows = length();
+    string str("[");
+    for(long i = 0; i < num_rows; i++)
+    {
+        str += "[";
+        for(int32_t j = offsets[i]; j < offsets[i + 1]; j++)
+        {
+            str += convertToJson(values[j]);
+            if(j < offsets[i + 1] - 1) str += ",";
+        }
+        str += "]";
+        if(i < num_rows - 1) str += ",";
+    }
+    str += "]";
+    return str;
+}
+
+/*----------------------------------------------------------------------------
+ * toLua
+ *----------------------------------------------------------------------------*/
+template<class T>
+int FieldRaggedColumn<T>::toLua (lua_State* L) const
+{
+    const long num_rows = length();
+    lua_newtable(L);
+    for(long i = 0; i < num_rows; i++)
+    {
+        toLua(L, i);
+        lua_rawseti(L, -2, i + 1);
+    }
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * toLua
+ *----------------------------------------------------------------------------*/
+template <class T>
+int FieldRaggedColumn<T>::toLua (lua_State* L, long key) const
+{
+    if(key >= 0 && key < length())
+    {
+        lua_newtable(L);
+        for(int32_t j = offsets[key]; j < offsets[key + 1]; j++)
+        {
+            convertToLua(L, values[j]);
+            lua_rawseti(L, -2, j - offsets[key] + 1);
+        }
+    }
+    else
+    {
+        lua_pushnil(L);
+    }
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * fromLua
+ *----------------------------------------------------------------------------*/
+template<class T>
+void FieldRaggedColumn<T>::fromLua (lua_State* L, int index)
+{
+    // check read-only
+    if(this->encoding & Field::READ_ONLY)
+    {
+        return; // do not populate field
+    }
+
+    // clear out existing rows
+    clear();
+
+    // convert each row from lua
+    const int num_rows = lua_rawlen(L, index);
+    for(int i = 0; i < num_rows; i++)
+    {
+        lua_rawgeti(L, index, i + 1);
+        const int num_values = lua_rawlen(L, -1);
+        checkCapacity(num_values);
+        for(int j = 0; j < num_values; j++)
+        {
+            T value;
+            lua_rawgeti(L, -1, j + 1);
+            convertFromLua(L, -1, value);
+            lua_pop(L, 1);
+            values.push_back(value);
+        }
+        lua_pop(L, 1);
+        offsets.push_back(static_cast<int32_t>(values.size()));
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * checkCapacity
+ *----------------------------------------------------------------------------*/
+template<class T>
+void FieldRaggedColumn<T>::checkCapacity (long size) const
+{
+    if(static_cast<long>(values.size()) + size > std::numeric_limits<int32_t>::max())
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "ragged column exceeded maximum number of values: %ld + %ld", static_cast<long>(values.size()), size);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * toDoubles - flattens the values of the requested rows
+ *----------------------------------------------------------------------------*/
+template<class T>
+FieldUntypedColumn::column_t FieldRaggedColumn<T>::toDoubles (long start_index, long num_elements) const
+{
+    const int32_t start = offsets[start_index];
+    const int32_t end = offsets[start_index + num_elements];
+    column_t column = {
+        .data = new double[end - start],
+        .size = end - start
+    };
+    for(int32_t i = start; i < end; i++)
+    {
+        column.data[i - start] = raggedToDouble(values[i]);
+    }
+    return column;
+}
+
+#endif  /* __field_ragged_column__ */
@@ -37,8 +37,12 @@
 #include "OsApi.h"
 #include "Asset.h"
 #include "StringLib.h"
+#include "TimeLib.h"
+#include "EventLib.h"
+#include "LuaEngine.h"
 
 #include <sys/stat.h>
+#include <unistd.h>
 
 /******************************************************************************
  * STATIC DATA
@@ -46,6 +50,12 @@
 
 const char* FileIODriver::FORMAT = "file";
 
+std::atomic<double> FileIODriver::modelLatency = {0.0};
+std::atomic<double> FileIODriver::modelBandwidth = {0.0};
+std::atomic<int64_t> FileIODriver::statReads = {0};
+std::atomic<int64_t> FileIODriver::statBytes = {0};
+std::atomic<int64_t> FileIODriver::statTime = {0};
+
 /******************************************************************************
  * FILE IO DRIVER CLASS
  ******************************************************************************/
@@ -63,14 +73,38 @@ Asset::IODriver* FileIODriver::create (const Asset* _asset, const char* resource
  *----------------------------------------------------------------------------*/
 int64_t FileIODriver::ioRead (uint8_t* data, int64_t size, uint64_t pos)
 {
-    /* Seek to New Position */
-    if(fseeko(ioFile, static_cast<off_t>(pos), SEEK_SET) != 0)
+    const double start = TimeLib::latchtime();
+
+    /* Read Data - positional reads so concurrent readers of a context do not race on the file offset */
+    int64_t bytes_read = 0;
+    while(bytes_read < size)
     {
-        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to go to I/O position: 0x%lx", pos);
+        const ssize_t ret = pread(fileno(ioFile), &data[bytes_read], size - bytes_read, static_cast<off_t>(pos + bytes_read));
+        if(ret < 0)
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to read from I/O position: 0x%lx", pos + bytes_read);
+        }
+        else if(ret == 0)
+        {
+            break; // end of file
+        }
+        bytes_read += ret;
     }
 
-    /* Read Data */
-    return fread(data, 1, size, ioFile);
+    /* Apply Latency and Bandwidth Model */
+    const double latency = modelLatency.load(std::memory_order_relaxed);
+    const double bandwidth = modelBandwidth.load(std::memory_order_relaxed);
+    double delay = latency;
+    if(bandwidth > 0.0) delay += static_cast<double>(bytes_read) / bandwidth;
+    delay -= TimeLib::latchtime() - start;
+    if(delay > 0.0) OsApi::sleep(delay);
+
+    /* Update Statistics */
+    statReads.fetch_add(1, std::memory_order_relaxed);
+    statBytes.fetch_add(bytes_read, std::memory_order_relaxed);
+    statTime.fetch_add(static_cast<int64_t>((TimeLib::latchtime() - start) * 1000000000.0), std::memory_order_relaxed);
+
+    return bytes_read;
 }
 
 /*----------------------------------------------------------------------------
@@ -94,6 +128,62 @@ int64_t FileIODriver::size (void)
     return static_cast<int64_t>(st.st_size);
 }
 
+/*----------------------------------------------------------------------------
+ * setModel
+ *
+ *  every read is delayed to take at least latency + size / bandwidth seconds,
+ *  approximating a ranged GET against remote storage; zero disables a term
+ *----------------------------------------------------------------------------*/
+void FileIODriver::setModel (double latency, double bandwidth)
+{
+    modelLatency.store(latency > 0.0 ? latency : 0.0);
+    modelBandwidth.store(bandwidth > 0.0 ? bandwidth : 0.0);
+}
+
+/*----------------------------------------------------------------------------
+ * luaModel - iomodel(<latency ms>, <bandwidth MB/s>)
+ *----------------------------------------------------------------------------*/
+int FileIODriver::luaModel (lua_State* L)
+{
+    try
+    {
+        const double latency_ms = LuaObject::getLuaFloat(L, 1, true, 0.0);
+        const double bandwidth_mbs = LuaObject::getLuaFloat(L, 2, true, 0.0);
+        setModel(latency_ms / 1000.0, bandwidth_mbs * 1000000.0);
+        mlog(INFO, "File I/O model set to %.3lfms latency and %.3lfMB/s bandwidth", latency_ms, bandwidth_mbs);
+        lua_pushboolean(L, true);
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error setting file I/O model: %s", e.what());
+        lua_pushboolean(L, false);
+    }
+
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaStats - iostats([<reset>]) --> {reads, bytes, seconds}
+ *----------------------------------------------------------------------------*/
+int FileIODriver::luaStats (lua_State* L)
+{
+    const bool reset = LuaObject::getLuaBoolean(L, 1, true, false);
+
+    lua_newtable(L);
+    LuaEngine::setAttrInt(L, "reads", statReads.load());
+    LuaEngine::setAttrInt(L, "bytes", statBytes.load());
+    LuaEngine::setAttrNum(L, "seconds", static_cast<double>(statTime.load()) / 1000000000.0);
+
+    if(reset)
+    {
+        statReads.store(0);
+        statBytes.store(0);
+        statTime.store(0);
+    }
+
+    return 1;
+}
+
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
@@ -39,6 +39,8 @@
 #include "OsApi.h"
 #include "Asset.h"
 
+#include <atomic>
+
 /******************************************************************************
  * FILE IO DRIVER CLASS
  ******************************************************************************/
@@ -62,6 +64,10 @@ class FileIODriver: public Asset::IODriver
         string              path        (void) override;
         int64_t             size        (void) override;
 
+        static void         setModel    (double latency, double bandwidth);
+        static int          luaModel    (lua_State* L);
+        static int          luaStats    (lua_State* L);
+
     private:
 
         /*--------------------------------------------------------------------
@@ -78,6 +84,15 @@ class FileIODriver: public Asset::IODriver
         const Asset*    asset;
         string          filePath;
         fileptr_t       ioFile;
+
+        /* injected latency and bandwidth model (for local replay of remote reads) */
+        static std::atomic<double>  modelLatency;   // seconds per read
+        static std::atomic<double>  modelBandwidth; // bytes per second, zero is unlimited
+
+        /* read statistics */
+        static std::atomic<int64_t> statReads;
+        static std::atomic<int64_t> statBytes;
+        static std::atomic<int64_t> statTime;       // nanoseconds spent in reads
 };
 
 #endif  /* __file_io_driver__ */
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <algorithm>
+#include <exception>
+
+#include "OsApi.h"
+#include "SystemConfig.h"
+#include "FrameRunnerPool.h"
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+Cond                                FrameRunnerPool::poolCond(NUM_SIGNALS);
+bool                                FrameRunnerPool::active = false;
+vector<Thread*>                     FrameRunnerPool::workers;
+vector<FrameRunnerPool::job_t*>     FrameRunnerPool::jobs;
+size_t                              FrameRunnerPool::nextJob = 0;
+FrameRunnerPool::stats_t            FrameRunnerPool::stats = {};
+
+/******************************************************************************
+ * CLIENT METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Client Constructor
+ *----------------------------------------------------------------------------*/
+FrameRunnerPool::Client::Client(int _limit):
+    limit(MAX(_limit, 0)),
+    active(0)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * setLimit
+ *----------------------------------------------------------------------------*/
+void FrameRunnerPool::Client::setLimit(int _limit)
+{
+    poolCond.lock();
+    {
+        limit = MAX(_limit, 0);
+    }
+    poolCond.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * run - calls func over [0, num_items) in ranges of at most grain items;
+ *       returns when every range has been executed, false if any failed
+ *----------------------------------------------------------------------------*/
+bool FrameRunnerPool::Client::run(range_func_t func, void* context, long num_items, long grain)
+{
+    if(num_items <= 0) return true;
+
+    job_t job(this, func, context, MAX(grain, 1L));
+    const long num_tasks = (num_items + job.grain - 1) / job.grain;
+
+    /* Size Job */
+    poolCond.lock();
+    {
+        startWorkers();
+
+        long participants = std::min(num_tasks, static_cast<long>(workers.size()) + 1);
+        if(limit > 0) participants = std::min(participants, static_cast<long>(limit));
+        participants = MAX(participants, 1L);
+
+        /* Split items evenly across participants */
+        for(long i = 0; i < participants; i++)
+        {
+            job.ranges.push_back({(num_items * i) / participants, (num_items * (i + 1)) / participants});
+        }
+        job.remaining = num_items;
+        job.joined = 1; // submitting thread takes the first range
+        job.running = 1;
+        active++;
+
+        /* Offer remaining ranges to the workers */
+        stats.jobs++;
+        if(participants > 1)
+        {
+            jobs.push_back(&job);
+            stats.pending = jobs.size();
+            poolCond.signal(WORK_SIGNAL, Cond::NOTIFY_ALL);
+        }
+        else
+        {
+            stats.inlined++;
+        }
+    }
+    poolCond.unlock();
+
+    /* Work On Job Until All Items Claimed */
+    participate(&job, 0);
+
+    /* Wait For Workers Still Executing A Range */
+    poolCond.lock();
+    {
+        const vector<job_t*>::iterator iter = std::find(jobs.begin(), jobs.end(), &job);
+        if(iter != jobs.end())
+        {
+            jobs.erase(iter);
+            stats.pending = jobs.size();
+        }
+
+        job.running--;
+        active--;
+        while(job.running > 0)
+        {
+            poolCond.wait(DONE_SIGNAL, SYS_TIMEOUT);
+        }
+
+        stats.tasks += job.tasks;
+        stats.steals += job.steals;
+    }
+    poolCond.unlock();
+
+    return !job.failed.load();
+}
+
+/******************************************************************************
+ * PUBLIC METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * init
+ *----------------------------------------------------------------------------*/
+void FrameRunnerPool::init (void)
+{
+    poolCond.lock();
+    {
+        active = true;
+    }
+    poolCond.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * deinit
+ *----------------------------------------------------------------------------*/
+void FrameRunnerPool::deinit (void)
+{
+    poolCond.lock();
+    {
+        active = false;
+        poolCond.signal(WORK_SIGNAL, Cond::NOTIFY_ALL);
+    }
+    poolCond.unlock();
+
+    for(Thread* pid: workers)
+    {
+        delete pid;
+    }
+    workers.clear();
+
+    poolCond.lock();
+    {
+        stats.workers = 0;
+    }
+    poolCond.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * getStats
+ *----------------------------------------------------------------------------*/
+FrameRunnerPool::stats_t FrameRunnerPool::getStats (void)
+{
+    poolCond.lock();
+    const stats_t _stats = stats;
+    poolCond.unlock();
+    return _stats;
+}
+
+/*----------------------------------------------------------------------------
+ * luaStats - runnerpool() -> table of frame runner pool statistics
+ *----------------------------------------------------------------------------*/
+int FrameRunnerPool::luaStats (lua_State* L)
+{
+    const stats_t _stats = getStats();
+
+    lua_newtable(L);
+    LuaEngine::setAttrInt(L, "workers", _stats.workers);
+    LuaEngine::setAttrInt(L, "busy", _stats.busy);
+    LuaEngine::setAttrInt(L, "pending", _stats.pending);
+    LuaEngine::setAttrInt(L, "jobs", _stats.jobs);
+    LuaEngine::setAttrInt(L, "inlined", _stats.inlined);
+    LuaEngine::setAttrInt(L, "tasks", _stats.tasks);
+    LuaEngine::setAttrInt(L, "steals", _stats.steals);
+    return 1;
+}
+
+/******************************************************************************
+ * PRIVATE METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * workerThread
+ *----------------------------------------------------------------------------*/
+void* FrameRunnerPool::workerThread (void* parm)
+{
+    (void)parm;
+
+    poolCond.lock();
+    while(active)
+    {
+        /* Wait for a job with an unclaimed range */
+        size_t index = 0;
+        job_t* job = join(index);
+        if(!job)
+        {
+            poolCond.wait(WORK_SIGNAL, SYS_TIMEOUT);
+            continue;
+        }
+        stats.busy++;
+        poolCond.unlock();
+
+        /* Work On Job */
+        participate(job, index);
+
+        poolCond.lock();
+        stats.busy--;
+        job->running--;
+        job->client->active--;
+        poolCond.signal(DONE_SIGNAL, Cond::NOTIFY_ALL);
+    }
+    poolCond.unlock();
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * join - claims a range of the next job round robin within its client's
+ *        limit, lock held
+ *----------------------------------------------------------------------------*/
+FrameRunnerPool::job_t* FrameRunnerPool::join (size_t& index)
+{
+    const size_t num_jobs = jobs.size();
+    for(size_t i = 0; i < num_jobs; i++)
+    {
+        const size_t j = (nextJob + i) % num_jobs;
+        job_t* job = jobs[j];
+        const Client* client = job->client;
+        if( (job->joined < job->ranges.size()) &&
+            (job->remaining.load() > 0) &&
+            (client->limit == 0 || client->active < client->limit) )
+        {
+            index = job->joined++;
+            job->running++;
+            job->client->active++;
+            nextJob = j + 1;
+            return job;
+        }
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * participate - executes ranges of the job until no items are left
+ *----------------------------------------------------------------------------*/
+void FrameRunnerPool::participate (job_t* job, size_t index)
+{
+    long start;
+    long count;
+    while(claim(job, index, start, count))
+    {
+        if(job->failed.load()) continue; // drain remaining items
+
+        try
+        {
+            job->func(job->context, start, count);
+        }
+        catch(const RunTimeException& e)
+        {
+            mlog(e.level(), "Failed to run items %ld to %ld: %s", start, start + count - 1, e.what());
+            job->failed = true;
+        }
+        catch(const std::exception& e)
+        {
+            mlog(CRITICAL, "Failed to run items %ld to %ld: %s", start, start + count - 1, e.what());
+            job->failed = true;
+        }
+        catch(...)
+        {
+            mlog(CRITICAL, "Failed to run items %ld to %ld: unknown exception", start, start + count - 1);
+            job->failed = true;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * claim - takes the next grain items from the participant's own range,
+ *         stealing the back half of the largest range when it is empty
+ *----------------------------------------------------------------------------*/
+bool FrameRunnerPool::claim (job_t* job, size_t index, long& start, long& count)
+{
+    bool claimed = false;
+
+    job->rangeMut.lock();
+    {
+        range_t& own = job->ranges[index];
+        if(own.begin >= own.end)
+        {
+            /* Find largest range left */
+            range_t* victim = NULL;
+            for(range_t& range: job->ranges)
+            {
+                if(!victim || (range.end - range.begin) > (victim->end - victim->begin))
+                {
+                    victim = &range;
+                }
+            }
+
+            /* Steal back half */
+            const long left = victim->end - victim->begin;
+            if(left > 0)
+            {
+                const long half = (left + 1) / 2;
+                own.begin = victim->end - half;
+                own.end = victim->end;
+                victim->end -= half;
+                job->steals++;
+            }
+        }
+
+        if(own.begin < own.end)
+        {
+            start = own.begin;
+            count = MIN(job->grain, own.end - own.begin);
+            own.begin += count;
+            job->remaining -= count;
+            job->tasks++;
+            claimed = true;
+        }
+    }
+    job->rangeMut.unlock();
+
+    return claimed;
+}
+
+/*----------------------------------------------------------------------------
+ * startWorkers - starts the worker threads on first use, lock held
+ *----------------------------------------------------------------------------*/
+void FrameRunnerPool::startWorkers (void)
+{
+    if(!workers.empty() || !active) return;
+
+    int num_threads = SystemConfig::settings().frameRunnerThreads.value;
+    if(num_threads <= 0) num_threads = OsApi::nproc();
+    for(int i = 0; i < num_threads; i++)
+    {
+        workers.push_back(new Thread(workerThread, NULL));
+    }
+    stats.workers = workers.size();
+
+    mlog(INFO, "Started %d frame runner threads", num_threads);
+}
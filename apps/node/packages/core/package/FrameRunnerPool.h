@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __frame_runner_pool__
+#define __frame_runner_pool__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <atomic>
+
+#include "OsApi.h"
+#include "LuaEngine.h"
+
+/******************************************************************************
+ * FRAME RUNNER POOL CLASS
+ ******************************************************************************/
+
+/*
+ * Node wide pool of worker threads shared by all frame runners
+ *
+ *  - a frame runner that can process its rows independently hands the pool a
+ *    function and a number of items (rows or extents); the items are split
+ *    into one contiguous range per participating thread and each participant
+ *    works through its range grain items at a time
+ *  - a participant that runs out of items steals the back half of the
+ *    largest range left, so uneven beams and uneven extents keep every
+ *    participant busy until the whole job is done
+ *  - the thread that submits a job always participates in it, so a job
+ *    completes even when every worker is busy with other requests
+ *  - each request runs its jobs through a client whose limit caps the number
+ *    of threads (submitting threads included) working on the request at once
+ *  - the number of workers is set by the frame_runner_threads setting; zero
+ *    sizes the pool to the number of cores
+ */
+class FrameRunnerPool
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Typedefs
+         *--------------------------------------------------------------------*/
+
+        typedef void (*range_func_t) (void* context, long start, long count);
+
+        typedef struct {
+            long        workers;        // worker threads
+            long        busy;           // worker threads participating in a job
+            long        pending;        // jobs in progress
+            long        jobs;           // total jobs run through the pool
+            long        inlined;        // total jobs run entirely by the submitting thread
+            long        tasks;          // total ranges of grain items executed
+            long        steals;         // total ranges taken from another participant
+        } stats_t;
+
+        /*--------------------------------------------------------------------
+         * Client Subclass
+         *--------------------------------------------------------------------*/
+
+        class Client
+        {
+            public:
+
+                explicit    Client      (int _limit=0);
+                            ~Client     (void) = default;
+
+                void        setLimit    (int _limit);
+                bool        run         (range_func_t func, void* context, long num_items, long grain);
+
+            private:
+
+                friend class FrameRunnerPool;
+
+                int         limit;      // maximum participating threads, zero is unlimited
+                int         active;     // participating threads
+        };
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static void     init        (void);
+        static void     deinit      (void);
+        static stats_t  getStats    (void);
+        static int      luaStats    (lua_State* L);
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int WORK_SIGNAL = 0;
+        static const int DONE_SIGNAL = 1;
+        static const int NUM_SIGNALS = 2;
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        typedef struct {
+            long begin;
+            long end;
+        } range_t;
+
+        struct job_t {
+            Client*             client;
+            range_func_t        func;
+            void*               context;
+            long                grain;
+            Mutex               rangeMut;   // protects ranges, tasks, and steals
+            vector<range_t>     ranges;     // one per participant
+            long                tasks;
+            long                steals;
+            size_t              joined;     // ranges claimed by a participant (pool lock)
+            int                 running;    // participants still working (pool lock)
+            std::atomic<long>   remaining;  // items not yet claimed
+            std::atomic<bool>   failed;
+            job_t (Client* _client, range_func_t _func, void* _context, long _grain):
+                client(_client),
+                func(_func),
+                context(_context),
+                grain(_grain),
+                tasks(0),
+                steals(0),
+                joined(0),
+                running(0),
+                remaining(0),
+                failed(false) {}
+        };
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        static Cond             poolCond;   // protects all pool and client state
+        static bool             active;
+        static vector<Thread*>  workers;
+        static vector<job_t*>   jobs;
+        static size_t           nextJob;    // round robin position
+        static stats_t          stats;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static void*    workerThread    (void* parm);
+        static job_t*   join            (size_t& index);
+        static void     participate     (job_t* job, size_t index);
+        static bool     claim           (job_t* job, size_t index, long& start, long& count);
+        static void     startWorkers    (void);
+};
+
+#endif  /* __frame_runner_pool__ */
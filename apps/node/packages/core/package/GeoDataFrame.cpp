@@ -254,24 +254,27 @@ static void _addSourceMetaData(GeoDataFrame* dataframe, GeoDataFrame::gdf_rec_t*
 template<class T>
 static void _addListColumn(GeoDataFrame* dataframe, GeoDataFrame::gdf_rec_t* rec)
 {
-    // get column from dataframe
-    FieldColumn<FieldList<T>>* column = dynamic_cast<FieldColumn<FieldList<T>>*>(dataframe->getColumn(rec->name, true));
+    // get column from dataframe (received list columns are ragged, locally built ones may not be)
+    FieldUntypedColumn* column = dataframe->getColumn(rec->name, true);
+    FieldRaggedColumn<T>* ragged_column = dynamic_cast<FieldRaggedColumn<T>*>(column);
+    FieldColumn<FieldList<T>>* list_column = dynamic_cast<FieldColumn<FieldList<T>>*>(column);
 
     // (optionally) pull out description and get pointer to data
     const char* description = (rec->encoding & Field::HAS_DESCRIPTION) ? reinterpret_cast<const char*>(rec->data) : NULL;
     uint8_t* data_ptr = (rec->encoding & Field::HAS_DESCRIPTION) ? (rec->data + (StringLib::size(description) + 1)) : rec->data;
 
     // create new column if not found
-    if(!column)
+    if(!ragged_column && !list_column)
     {
-        column = new FieldColumn<FieldList<T>>(rec->encoding & ~Field::NESTED_MASK, GeoDataFrame::DEFAULT_RECEIVED_COLUMN_CHUNK_SIZE);
+        ragged_column = new FieldRaggedColumn<T>(rec->encoding & ~Field::NESTED_MASK);
         const char* column_description = StringLib::duplicate(description);
-        if(!dataframe->addColumn(rec->name, column, column_description, true))
+        if(!dataframe->addColumn(rec->name, ragged_column, column_description, true))
         {
-            delete column;
+            delete ragged_column;
             delete [] column_description;
             throw RunTimeException(ERROR, RTE_FAILURE, "failed to add list column <%s> to dataframe", rec->name);
         }
+        column = ragged_column;
     }
     else if((column->encoding & ~Field::NESTED_MASK) != (rec->encoding & ~Field::NESTED_MASK))
     {
@@ -281,15 +284,22 @@ static void _addListColumn(GeoDataFrame* dataframe, GeoDataFrame::gdf_rec_t* rec
     // append data to column
     if(rec->type == GeoDataFrame::COLUMN_REC)
     {
-        uint32_t* sizes_ptr = reinterpret_cast<uint32_t*>(data_ptr);
-        const long size_of_sizes = sizeof(uint32_t) * rec->num_rows;
-        long data_offset = size_of_sizes;
-        for(uint32_t j = 0; j < rec->num_rows; j++)
+        if(ragged_column)
+        {
+            dataframe->setNumRows(ragged_column->appendBuffer(data_ptr, rec->num_rows));
+        }
+        else
         {
-            FieldList<T> field_list;
-            field_list.appendBuffer(&data_ptr[data_offset], sizes_ptr[j]);
-            data_offset += sizes_ptr[j];
-            dataframe->setNumRows(column->append(field_list));
+            uint32_t* sizes_ptr = reinterpret_cast<uint32_t*>(data_ptr);
+            const long size_of_sizes = sizeof(uint32_t) * rec->num_rows;
+            long data_offset = size_of_sizes;
+            for(uint32_t j = 0; j < rec->num_rows; j++)
+            {
+                FieldList<T> field_list;
+                field_list.appendBuffer(&data_ptr[data_offset], sizes_ptr[j]);
+                data_offset += sizes_ptr[j];
+                dataframe->setNumRows(list_column->append(field_list));
+            }
         }
     }
     else
@@ -304,7 +314,15 @@ static void _addListColumn(GeoDataFrame* dataframe, GeoDataFrame::gdf_rec_t* rec
 template<typename T>
 static long _appendListBuffer(GeoDataFrame* gdf, const char* name, const void* values, long count, bool nodata)
 {
-    FieldColumn<FieldList<T>>* column = dynamic_cast<FieldColumn<FieldList<T>>*>(gdf->getColumn(name, true));
+    FieldUntypedColumn* column = gdf->getColumn(name, true);
+    FieldRaggedColumn<T>* ragged_column = dynamic_cast<FieldRaggedColumn<T>*>(column);
+    if(ragged_column)
+    {
+        if(nodata) return ragged_column->appendList(NULL, 0, count, static_cast<T>(0));
+        else return ragged_column->appendList(reinterpret_cast<const T*>(values), count);
+    }
+
+    FieldColumn<FieldList<T>>* list_column = dynamic_cast<FieldColumn<FieldList<T>>*>(column);
     FieldList<T> list;
     if(nodata)
     {
@@ -315,7 +333,7 @@ static long _appendListBuffer(GeoDataFrame* gdf, const char* name, const void* v
         const T* typed = reinterpret_cast<const T*>(values);
         for(long i = 0; i < count; i++) list.append(typed[i]);
     }
-    return column->append(list);
+    return list_column->append(list);
 }
 
 /*----------------------------------------------------------------------------
@@ -786,17 +804,17 @@ bool GeoDataFrame::addNewColumn (const char* name, uint32_t column_encoding, con
     {
         switch(value_encoding)
         {
-            case RecordObject::INT8:    column = new FieldColumn<FieldList<int8_t>>  (encoding_mask); break;
-            case RecordObject::INT16:   column = new FieldColumn<FieldList<int16_t>> (encoding_mask); break;
-            case RecordObject::INT32:   column = new FieldColumn<FieldList<int32_t>> (encoding_mask); break;
-            case RecordObject::INT64:   column = new FieldColumn<FieldList<int64_t>> (encoding_mask); break;
-            case RecordObject::UINT8:   column = new FieldColumn<FieldList<uint8_t>> (encoding_mask); break;
-            case RecordObject::UINT16:  column = new FieldColumn<FieldList<uint16_t>>(encoding_mask); break;
-            case RecordObject::UINT32:  column = new FieldColumn<FieldList<uint32_t>>(encoding_mask); break;
-            case RecordObject::UINT64:  column = new FieldColumn<FieldList<uint64_t>>(encoding_mask); break;
-            case RecordObject::FLOAT:   column = new FieldColumn<FieldList<float>>   (encoding_mask); break;
-            case RecordObject::DOUBLE:  column = new FieldColumn<FieldList<double>>  (encoding_mask); break;
-            case RecordObject::TIME8:   column = new FieldColumn<FieldList<time8_t>> (encoding_mask); break;
+            case RecordObject::INT8:    column = new FieldRaggedColumn<int8_t>  (encoding_mask); break;
+            case RecordObject::INT16:   column = new FieldRaggedColumn<int16_t> (encoding_mask); break;
+            case RecordObject::INT32:   column = new FieldRaggedColumn<int32_t> (encoding_mask); break;
+            case RecordObject::INT64:   column = new FieldRaggedColumn<int64_t> (encoding_mask); break;
+            case RecordObject::UINT8:   column = new FieldRaggedColumn<uint8_t> (encoding_mask); break;
+            case RecordObject::UINT16:  column = new FieldRaggedColumn<uint16_t>(encoding_mask); break;
+            case RecordObject::UINT32:  column = new FieldRaggedColumn<uint32_t>(encoding_mask); break;
+            case RecordObject::UINT64:  column = new FieldRaggedColumn<uint64_t>(encoding_mask); break;
+            case RecordObject::FLOAT:   column = new FieldRaggedColumn<float>   (encoding_mask); break;
+            case RecordObject::DOUBLE:  column = new FieldRaggedColumn<double>  (encoding_mask); break;
+            case RecordObject::TIME8:   column = new FieldRaggedColumn<time8_t> (encoding_mask); break;
             default:
             {
                 mlog(ERROR, "Cannot add nested column <%s> of type %d", name, value_encoding);
@@ -1471,12 +1489,20 @@ void GeoDataFrame::sendDataframe (const char* rspq, uint64_t key_space, bool wit
             // determine size of sizes (bytes)
             const long size_of_sizes = sizeof(uint32_t) * kv.value.field->length();
 
-            // determine size of column
+            // determine size of column (ragged columns already hold the flattened values)
+            const FieldUntypedRaggedColumn* ragged_column = dynamic_cast<const FieldUntypedRaggedColumn*>(kv.value.field);
             long column_size = 0;
-            for(long j = 0; j < kv.value.field->length(); j++)
+            if(ragged_column)
             {
-                const Field* field_list = kv.value.field->get(j);
-                column_size += field_list->length();
+                column_size = ragged_column->numValues();
+            }
+            else
+            {
+                for(long j = 0; j < kv.value.field->length(); j++)
+                {
+                    const Field* field_list = kv.value.field->get(j);
+                    column_size += field_list->length();
+                }
             }
             column_size *= RecordObject::FIELD_TYPE_BYTES[encoded_type];
 
@@ -1501,13 +1527,21 @@ void GeoDataFrame::sendDataframe (const char* rspq, uint64_t key_space, bool wit
             data_ptr += description_size;
 
             // serialize column data into record
-            long data_offset = size_of_sizes;
-            uint32_t* sizes_ptr = reinterpret_cast<uint32_t*>(data_ptr);
-            for(long j = 0; j < kv.value.field->length(); j++)
+            if(ragged_column)
+            {
+                const long bytes_serialized = ragged_column->serialize(data_ptr, data_size);
+                if(bytes_serialized != data_size) throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to serialize column %s: %ld != %ld", gdf_rec_data->name, bytes_serialized, data_size);
+            }
+            else
             {
-                const Field* field_list = kv.value.field->get(j);
-                sizes_ptr[j] = static_cast<uint32_t>(field_list->length()) * RecordObject::FIELD_TYPE_BYTES[encoded_type];
-                data_offset += field_list->serialize(&(data_ptr[data_offset]), data_size - data_offset);
+                long data_offset = size_of_sizes;
+                uint32_t* sizes_ptr = reinterpret_cast<uint32_t*>(data_ptr);
+                for(long j = 0; j < kv.value.field->length(); j++)
+                {
+                    const Field* field_list = kv.value.field->get(j);
+                    sizes_ptr[j] = static_cast<uint32_t>(field_list->length()) * RecordObject::FIELD_TYPE_BYTES[encoded_type];
+                    data_offset += field_list->serialize(&(data_ptr[data_offset]), data_size - data_offset);
+                }
             }
 
             // send column record
@@ -43,6 +43,7 @@
 #include "MsgQ.h"
 #include "Field.h"
 #include "FieldColumn.h"
+#include "FieldRaggedColumn.h"
 #include "FieldMap.h"
 #include "RecordObject.h"
 #include "RequestParameters.h"
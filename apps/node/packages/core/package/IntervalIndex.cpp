@@ -48,6 +48,9 @@ const struct luaL_Reg IntervalIndex::LUA_META_TABLE[] = {
     {"add",         luaAdd},
     {"query",       luaQuery},
     {"display",     luaDisplay},
+    {"pack",        luaPack},
+    {"save",        luaSave},
+    {"load",        luaLoad},
     {NULL,          NULL}
 };
 
@@ -250,3 +253,12 @@ void IntervalIndex::displayspan (const intervalspan_t& span)
 {
     print2term("[%.3lf, %.3lf]", span.t0, span.t1);
 }
+
+/*----------------------------------------------------------------------------
+ * center
+ *----------------------------------------------------------------------------*/
+double IntervalIndex::center (const intervalspan_t& span, int dim)
+{
+    (void)dim;
+    return (span.t0 + span.t1) / 2.0;
+}
@@ -71,6 +71,7 @@ class IntervalIndex: public AssetIndex<intervalspan_t>
         intervalspan_t  attr2span       (Dictionary<double>* attr, bool* provided=NULL) override;
         intervalspan_t  luatable2span   (lua_State* L, int parm) override;
         void            displayspan     (const intervalspan_t& span) override;
+        double          center          (const intervalspan_t& span, int dim) override;
 
     private:
 
@@ -43,6 +43,7 @@
 #include "SystemConfig.h"
 #include "TimeLib.h"
 #include "RequestParameters.h"
+#include "RequestArena.h"
 
 /******************************************************************************
  * STATIC DATA
@@ -529,10 +530,15 @@ EndpointObject::content_t LuaEndpoint::selectContentType (Request* request, cons
  *----------------------------------------------------------------------------*/
 void LuaEndpoint::checkMemoryUsage(Request* request)
 {
+    // system usage covers everything on the host, the arena limit covers
+    // what in-flight requests on this server hold
     const double memory_usage = OsApi::memusage();
-    if(memory_usage >= SystemConfig::settings().memoryThreshold.value)
+    const long arena_mb = static_cast<long>(RequestArena::liveBytes() >> 20);
+    const long arena_limit_mb = SystemConfig::settings().requestArenaLimitMB.value;
+    if( (memory_usage >= SystemConfig::settings().memoryThreshold.value) ||
+        ((arena_limit_mb > 0) && (arena_mb >= arena_limit_mb)) )
     {
-        const FString error_msg("Memory (%d%%) exceeded threshold, not performing request: %s", (int)(memory_usage * 100.0), request->resource);
+        const FString error_msg("Memory (%d%%) exceeded threshold with %ld MB held by %ld requests, not performing request: %s", (int)(memory_usage * 100.0), arena_mb, RequestArena::liveArenas(), request->resource);
         sendHeader(Service_Unavailable, content2str(TEXT), &request->rspq, error_msg.c_str(), error_msg.length());
         throw RunTimeException(ERROR, RTE_NOT_ENOUGH_MEMORY, "%s", error_msg.c_str());
     }
@@ -573,6 +579,11 @@ void* LuaEndpoint::requestThread (void* parm)
         .account = request->getHdrAccount()
     };
 
+    /* Bind Request Arena */
+    shared_ptr<RequestArena> arena;
+    if(SystemConfig::settings().requestArena.value) arena = make_shared<RequestArena>(request->id);
+    const RequestArena::Scope arena_scope(arena);
+
     /* Initialize Lua Engine */
     LuaEngine engine(trace_id, NULL); // TODO: implement lua hook that checks for the timeout to have expired
 
@@ -606,6 +617,7 @@ void* LuaEndpoint::requestThread (void* parm)
     /* Generate Telemetry */
     tlm.duration = static_cast<float>(TimeLib::latchtime() - start);
     telemeter(INFO, tlm);
+    if(arena) mlog(DEBUG, "Request %s used %ld bytes of %ld reserved in its arena", request->id, static_cast<long>(arena->usedBytes()), static_cast<long>(arena->reservedBytes()));
 
     /* Clean Up */
     delete request;
@@ -74,6 +74,7 @@ const struct luaL_Reg LuaLibrarySys::sysLibs [] = {
     {"fileexists",  LuaLibrarySys::lsys_fileexists},
     {"deletefile",  LuaLibrarySys::lsys_deletefile},
     {"memu",        LuaLibrarySys::lsys_memu},
+    {"maxrss",      LuaLibrarySys::lsys_maxrss},
     {"upleap",      LuaLibrarySys::lsys_updateleapsecs},
     {"lsdev",       DeviceObject::luaList},
     {"getcfg",      SystemConfig::luaGetField},
@@ -581,6 +582,15 @@ int LuaLibrarySys::lsys_memu (lua_State* L)
     return 1;
 }
 
+/*----------------------------------------------------------------------------
+ * lsys_maxrss - peak resident set size of the process in bytes
+ *----------------------------------------------------------------------------*/
+int LuaLibrarySys::lsys_maxrss (lua_State* L)
+{
+    lua_pushinteger(L, OsApi::maxrss());
+    return 1;
+}
+
 /*----------------------------------------------------------------------------
  * lsys_updateleapsecs - update leap seconds
  *----------------------------------------------------------------------------*/
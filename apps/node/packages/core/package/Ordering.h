@@ -37,13 +37,24 @@
  ******************************************************************************/
 
 #include <assert.h>
+#include <algorithm>
 #include "OsApi.h"
 
 /******************************************************************************
  * ORDERING TEMPLATE
  ******************************************************************************/
 /*
- * Ordering - sorted linked list of data type T and index type K
+ * Ordering - sorted list of data type T and index type K
+ *
+ *  Entries are kept in a two level B+tree: a sorted vector of leaf blocks,
+ *  each holding up to BLOCK_SIZE entries with the keys and data in separate
+ *  contiguous arrays, indexed (once there is more than one block) by a
+ *  contiguous array of each block's largest key.  Lookups binary search the
+ *  index and then the keys of a single block; inserts shift at most one
+ *  block and split it when full; while there is a single block, adds insert
+ *  into it directly, and emptying it keeps its storage so that a key can be
+ *  removed and added again without reallocating.
+ *  Entries with equal keys are kept newest first.
  */
 template <class T, typename K=unsigned long>
 class Ordering
@@ -69,6 +80,8 @@ class Ordering
          *--------------------------------------------------------------------*/
 
         static const long INFINITE_LIST_SIZE = -1;
+        static const long BLOCK_SIZE = 128;
+        static const long INITIAL_BLOCK_SIZE = 8; // most orderings are short lists
 
         /*--------------------------------------------------------------------
          * Iterator Subclass
@@ -89,7 +102,7 @@ class Ordering
                 kv_t                operator[]  (int index) const;
                 const int           length;
             private:
-                const T**           values;
+                T*                  values; // copied so the ordering can be modified while iterating
                 K*                  keys;
         };
 
@@ -101,6 +114,7 @@ class Ordering
                     ~Ordering   (void);
 
         bool        add         (K key, const T& data, bool unique=false);
+        void        load        (const K* keys, const T* data, long count);
         T&          get         (K key, searchMode_t smode=EXACT_MATCH);
         bool        remove      (K key, searchMode_t smode=EXACT_MATCH);
         long        length      (void) const;
@@ -122,33 +136,42 @@ class Ordering
          * Types
          *--------------------------------------------------------------------*/
 
-        typedef struct sorted_block_t {
-            K                       key;
-            T                       data;
-            struct sorted_block_t*  next;
-            struct sorted_block_t*  prev;
-        } sorted_node_t;
+        typedef struct {
+            vector<K>   keys;
+            vector<T>   data;
+        } sorted_block_t;
+
+        typedef struct {
+            long        block;
+            long        index;
+        } position_t;
 
         /*--------------------------------------------------------------------
          * Data
          *--------------------------------------------------------------------*/
 
-        sorted_node_t*  firstNode;
-        sorted_node_t*  lastNode;
-        sorted_node_t*  curr;
-        long            len;
-        long            maxListSize;
-        postFunc_t      postFunc;
-        void*           postParm;
+        vector<sorted_block_t>  blocks;
+        vector<K>               maxKeys;    // largest key of each block, empty when there is a single block
+        position_t              curr;   // block is -1 when not set
+        long                    len;
+        long                    maxListSize;
+        postFunc_t              postFunc;
+        void*                   postParm;
 
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
 
         bool            setMaxListSize  (long _max_list_size);
-        bool            addNode         (K key, const T& data, bool unique);
-        void            postNode        (sorted_node_t* node);
-        void            freeNode        (sorted_node_t* node);
+        bool            search          (K key, searchMode_t smode, position_t& pos) const;
+        position_t      lowerBound      (K key) const;
+        position_t      upperBound      (K key) const;
+        bool            stepBack        (position_t& pos) const;
+        void            insertEntry     (position_t pos, K key, const T& data);
+        void            eraseEntry      (position_t pos);
+        void            trimList        (void);
+        void            postNode        (T& data);
+        void            freeNode        (T& data);
 };
 
 /******************************************************************************
@@ -162,17 +185,15 @@ template <class T, typename K>
 Ordering<T,K>::Iterator::Iterator(const Ordering& o):
     length(o.len)
 {
-    values = new const T* [length];
+    values = new T [length];
     keys = new K [length];
 
     int j = 0;
-    sorted_node_t* node_ptr = o.firstNode;
-    while(node_ptr != NULL)
+    for(const sorted_block_t& block: o.blocks)
     {
-        values[j] = &node_ptr->data; // NOLINT(clang-analyzer-cplusplus.NewDelete)
-        keys[j] = node_ptr->key;
-        j++;
-        node_ptr = node_ptr->next;
+        std::copy(block.keys.begin(), block.keys.end(), &keys[j]);
+        std::copy(block.data.begin(), block.data.end(), &values[j]);
+        j += block.keys.size();
     }
 }
 
@@ -194,7 +215,7 @@ typename Ordering<T,K>::kv_t Ordering<T,K>::Iterator::operator[](int index) cons
 {
     if( (index < length) && (index >= 0) )
     {
-        const Ordering<T,K>::kv_t pair(keys[index], *values[index]);  // NOLINT(clang-analyzer-core.CallAndMessage)
+        const Ordering<T,K>::kv_t pair(keys[index], values[index]);
         return pair;
     }
 
@@ -211,9 +232,8 @@ typename Ordering<T,K>::kv_t Ordering<T,K>::Iterator::operator[](int index) cons
 template <class T, typename K>
 Ordering<T,K>::Ordering(postFunc_t post_func, void* post_parm, K max_list_size)
 {
-    firstNode   = NULL;
-    lastNode    = NULL;
-    curr        = NULL;
+    curr.block  = -1;
+    curr.index  = 0;
     len         = 0;
 
     postFunc    = post_func;
@@ -233,126 +253,145 @@ Ordering<T,K>::~Ordering(void)
 
 /*----------------------------------------------------------------------------
  * add
+ *
+ *  a new entry goes in front of any entries with an equal key
  *----------------------------------------------------------------------------*/
 template <class T, typename K>
 bool Ordering<T,K>::add(K key, const T& data, bool unique)
 {
-    return addNode(key, data, unique);
+    /* Single Block - leaf local insert, no index or split to maintain */
+    if(maxKeys.empty() && !blocks.empty() && (static_cast<long>(blocks[0].keys.size()) < BLOCK_SIZE))
+    {
+        sorted_block_t& block = blocks[0];
+        const long index = std::lower_bound(block.keys.begin(), block.keys.end(), key) - block.keys.begin();
+        if(unique && (index < static_cast<long>(block.keys.size())) && (block.keys[index] == key))
+        {
+            return false;
+        }
+        block.keys.insert(block.keys.begin() + index, key);
+        block.data.insert(block.data.begin() + index, data);
+        len++;
+        curr.block = 0;
+        curr.index = index;
+        if(maxListSize != INFINITE_LIST_SIZE) trimList();
+        return true;
+    }
+
+    const position_t pos = lowerBound(key);
+
+    /* Check Uniqueness */
+    if(unique && (pos.block < static_cast<long>(blocks.size())) && (blocks[pos.block].keys[pos.index] == key))
+    {
+        return false;
+    }
+
+    /* Add Entry */
+    insertEntry(pos, key, data);
+
+    /* Post or Remove First Entries */
+    trimList();
+
+    return true;
 }
 
 /*----------------------------------------------------------------------------
- * get
+ * load
+ *
+ *  bulk adds unsorted entries by sorting them once and merging them with the
+ *  existing entries into freshly packed blocks; the result is the same as
+ *  adding each entry in turn, including the newest first order of equal keys
  *----------------------------------------------------------------------------*/
 template <class T, typename K>
-T& Ordering<T,K>::get(K key, searchMode_t smode)
+void Ordering<T,K>::load(const K* keys, const T* data, long count)
 {
-    bool found = false;
-
-    /* Reset Current if Necessary */
-    if(curr == NULL) curr = lastNode;
-
-    /* look for data */
-    if(curr != NULL)
-    {
-        if (smode == EXACT_MATCH)
-        {
-            while (key < curr->key && curr->prev != NULL) curr = curr->prev;
-            while (key > curr->key && curr->next != NULL) curr = curr->next;
-            if (key == curr->key) found = true;
-        }
-        else if (smode == GREATER_THAN_OR_EQUAL) // i.e. you want the first node greater than or equal to the key
+    if(count <= 0) return;
+
+    /* Sort Incoming Entries (later entries first within equal keys) */
+    vector<long> order(count);
+    for(long i = 0; i < count; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [keys](long a, long b) {
+        return (keys[a] < keys[b]) || (!(keys[b] < keys[a]) && (a > b));
+    });
+
+    /* Merge with Existing Entries */
+    vector<sorted_block_t> merged;
+    vector<K> merged_keys;
+    merged.reserve(((len + count) / BLOCK_SIZE) + 1);
+    merged_keys.reserve(((len + count) / BLOCK_SIZE) + 1);
+    auto append = [&merged, &merged_keys](K key, const T& value) {
+        if(merged.empty() || static_cast<long>(merged.back().keys.size()) >= BLOCK_SIZE)
         {
-            while (key < curr->key && curr->prev != NULL) curr = curr->prev;
-            while (key > curr->key && curr->next != NULL) curr = curr->next;
-            if (key <= curr->key) found = true;
+            merged.emplace_back();
+            merged.back().keys.reserve(BLOCK_SIZE);
+            merged.back().data.reserve(BLOCK_SIZE);
+            merged_keys.push_back(key);
         }
-        else if (smode == LESS_THAN_OR_EQUAL) // i.e. you want the last node less than or equal to the key
-        {
-            while (key > curr->key && curr->next != NULL) curr = curr->next;
-            while (key < curr->key && curr->prev != NULL) curr = curr->prev;
-            if (key >= curr->key) found = true;
-        }
-        else if (smode == GREATER_THAN) // i.e. you want the first node greater than the key
-        {
-            while (key < curr->key && curr->prev != NULL) curr = curr->prev;
-            while (key > curr->key && curr->next != NULL) curr = curr->next;
-            if (key < curr->key) found = true;
-        }
-        else if (smode == LESS_THAN) // i.e. you want the last node less than the key
-        {
-            while (key > curr->key && curr->next != NULL) curr = curr->next;
-            while (key < curr->key && curr->prev != NULL) curr = curr->prev;
-            if (key > curr->key) found = true;
-        }
-        else // invalid search mode
+        merged.back().keys.push_back(key);
+        merged.back().data.push_back(value);
+        merged_keys.back() = key;
+    };
+
+    long n = 0;
+    for(const sorted_block_t& block: blocks)
+    {
+        for(size_t i = 0; i < block.keys.size(); i++)
         {
-            assert(false);
+            while((n < count) && (keys[order[n]] <= block.keys[i]))
+            {
+                append(keys[order[n]], data[order[n]]);
+                n++;
+            }
+            append(block.keys[i], block.data[i]);
         }
     }
+    while(n < count)
+    {
+        append(keys[order[n]], data[order[n]]);
+        n++;
+    }
 
-    if(found) return curr->data;
-    throw RunTimeException(CRITICAL, RTE_FAILURE, "key not found");
+    /* Replace Blocks */
+    blocks.swap(merged);
+    maxKeys.swap(merged_keys);
+    if(blocks.size() <= 1) maxKeys.clear();
+    len += count;
+    curr.block = -1;
+
+    /* Post or Remove First Entries */
+    trimList();
 }
 
 /*----------------------------------------------------------------------------
- * remove
- *
- *  TODO factor out common search code into its own function
+ * get
  *----------------------------------------------------------------------------*/
 template <class T, typename K>
-bool Ordering<T,K>::remove(K key, searchMode_t smode)
+T& Ordering<T,K>::get(K key, searchMode_t smode)
 {
-    bool found = false;
-
-    /* Reset Current if Necessary */
-    if(curr == NULL) curr = lastNode;
-
-    /* look for data */
-    if (curr != NULL)
+    position_t pos;
+    if(search(key, smode, pos))
     {
-        if (smode == EXACT_MATCH)
-        {
-            while (key < curr->key && curr->prev != NULL) curr = curr->prev;
-            while (key > curr->key && curr->next != NULL) curr = curr->next;
-            if (key == curr->key) found = true;
-        }
-        else if (smode == GREATER_THAN_OR_EQUAL) // i.e. you want the first node greater than or equal to the key
-        {
-            while (key < curr->key && curr->prev != NULL) curr = curr->prev;
-            while (key > curr->key && curr->next != NULL) curr = curr->next;
-            if (key < curr->key) found = true;
-        }
-        else if (smode == LESS_THAN_OR_EQUAL) // i.e. you want the first node less than the key
-        {
-            while (key > curr->key && curr->next != NULL) curr = curr->next;
-            while (key < curr->key && curr->prev != NULL) curr = curr->prev;
-            if (key > curr->key) found = true;
-        }
-        else // invalid search mode
-        {
-            assert(false);
-        }
+        curr = pos;
+        return blocks[pos.block].data[pos.index];
     }
 
-    if (found)
+    throw RunTimeException(CRITICAL, RTE_FAILURE, "key not found");
+}
+
+/*----------------------------------------------------------------------------
+ * remove
+ *----------------------------------------------------------------------------*/
+template <class T, typename K>
+bool Ordering<T,K>::remove(K key, searchMode_t smode)
+{
+    position_t pos;
+    if(search(key, smode, pos))
     {
         /* delete data */
-        freeNode(curr);
-
-        /* delete node */
-        sorted_node_t* node = curr;
-
-        if (curr->prev != NULL)  curr->prev->next = curr->next;
-        else                     firstNode = curr->next; // reposition first node
-
-        if (curr->next != NULL)  curr->next->prev = curr->prev;
-        else                     lastNode = curr->prev; // reposition last node
-
-        if (curr->next != NULL)  curr = curr->next;
-        else                     curr = curr->prev;
+        freeNode(blocks[pos.block].data[pos.index]);
 
-        delete node;
-        len--;
+        /* delete entry - leaves current at the following entry */
+        curr = pos;
+        eraseEntry(pos);
 
         /* return success */
         return true;
@@ -385,29 +424,20 @@ bool Ordering<T,K>::empty(void) const
 template <class T, typename K>
 void Ordering<T,K>::clear(void)
 {
-    /* Set Current Pointer */
-    curr = lastNode;
-
-    /* Check for Empty List */
-    if(curr == NULL)
-    {
-        firstNode = NULL;
-        return;
-    }
-
-    /* Clear In Previous Direction */
-    while(curr != NULL)
+    /* Free Data */
+    for(sorted_block_t& block: blocks)
     {
-        sorted_node_t* node = curr;
-        curr = curr->prev;
-        freeNode(node);
-        delete node;
-        len--;
+        for(T& data: block.data)
+        {
+            freeNode(data);
+        }
     }
 
     /* Reset Parameters */
-    firstNode = NULL;
-    lastNode = NULL;
+    blocks.clear();
+    maxKeys.clear();
+    curr.block = -1;
+    len = 0;
 }
 
 /*----------------------------------------------------------------------------
@@ -416,25 +446,20 @@ void Ordering<T,K>::clear(void)
 template <class T, typename K>
 void Ordering<T,K>::flush(void)
 {
-    /* Pop List */
-    while(firstNode != NULL)
+    /* Post List in Order */
+    for(sorted_block_t& block: blocks)
     {
-        /* Save off First and Move it to Next */
-        sorted_node_t* node = firstNode;
-        firstNode = firstNode->next;
-
-        /* Post Data */
-        postNode(node);
-
-        /* Delete Old Node */
-        delete node;
-        len--;
+        for(T& data: block.data)
+        {
+            postNode(data);
+        }
     }
 
     /* Reset Parameters */
-    firstNode = NULL;
-    lastNode = NULL;
-    curr = NULL;
+    blocks.clear();
+    maxKeys.clear();
+    curr.block = -1;
+    len = 0;
 }
 
 /*----------------------------------------------------------------------------
@@ -443,14 +468,15 @@ void Ordering<T,K>::flush(void)
 template <class T, typename K>
 K Ordering<T,K>::first(T* data)
 {
-    curr = firstNode;
-
-    if (curr != NULL)
+    if(len > 0)
     {
-        if (data != NULL) *data = curr->data;
-        return curr->key;
+        curr.block = 0;
+        curr.index = 0;
+        if (data != NULL) *data = blocks[0].data[0];
+        return blocks[0].keys[0];
     }
 
+    curr.block = -1;
     return (K)INVALID_KEY;
 }
 
@@ -460,11 +486,21 @@ K Ordering<T,K>::first(T* data)
 template <class T, typename K>
 K Ordering<T,K>::next(T* data)
 {
-    if (curr != NULL && curr->next != NULL)
+    if(curr.block >= 0)
     {
-        curr = curr->next;
-        if (data != NULL) *data = curr->data;
-        return curr->key;
+        position_t pos = curr;
+        if(++pos.index >= static_cast<long>(blocks[pos.block].keys.size()))
+        {
+            pos.block++;
+            pos.index = 0;
+        }
+
+        if(pos.block < static_cast<long>(blocks.size()))
+        {
+            curr = pos;
+            if (data != NULL) *data = blocks[curr.block].data[curr.index];
+            return blocks[curr.block].keys[curr.index];
+        }
     }
 
     return (K)INVALID_KEY;
@@ -476,14 +512,15 @@ K Ordering<T,K>::next(T* data)
 template <class T, typename K>
 K Ordering<T,K>::last(T* data)
 {
-    curr = lastNode;
-
-    if (curr != NULL)
+    if(len > 0)
     {
-        if (data != NULL) *data = curr->data;
-        return curr->key;
+        curr.block = blocks.size() - 1;
+        curr.index = blocks[curr.block].keys.size() - 1;
+        if (data != NULL) *data = blocks[curr.block].data[curr.index];
+        return blocks[curr.block].keys[curr.index];
     }
 
+    curr.block = -1;
     return (K)INVALID_KEY;
 }
 
@@ -493,11 +530,15 @@ K Ordering<T,K>::last(T* data)
 template <class T, typename K>
 K Ordering<T,K>::prev(T* data)
 {
-    if (curr != NULL && curr->next != NULL)
+    if(curr.block >= 0)
     {
-        curr = curr->next;
-        if (data != NULL) *data = curr->data;
-        return curr->key;
+        position_t pos = curr;
+        if(stepBack(pos))
+        {
+            curr = pos;
+            if (data != NULL) *data = blocks[curr.block].data[curr.index];
+            return blocks[curr.block].keys[curr.index];
+        }
     }
 
     return (K)INVALID_KEY;
@@ -509,6 +550,9 @@ K Ordering<T,K>::prev(T* data)
 template <class T, typename K>
 Ordering<T,K>& Ordering<T,K>::operator=(const Ordering& other)
 {
+    /* check self assignment */
+    if(this == &other) return *this;
+
     /* clear existing list */
     clear();
 
@@ -519,13 +563,10 @@ Ordering<T,K>& Ordering<T,K>::operator=(const Ordering& other)
     postFunc = other.postFunc;
     postParm = other.postParm;
 
-    /* build new list */
-    const sorted_node_t* tmp_node = other.firstNode;
-    while(tmp_node != NULL)
-    {
-        addNode(tmp_node->key, tmp_node->data, false);
-        tmp_node = tmp_node->next;
-    }
+    /* copy blocks */
+    blocks = other.blocks;
+    maxKeys = other.maxKeys;
+    len = other.len;
 
     /* return */
     return *this;
@@ -556,125 +597,254 @@ bool Ordering<T,K>::setMaxListSize(long _max_list_size)
 }
 
 /*----------------------------------------------------------------------------
- * addNode
+ * search
  *
- *  take note of mid-function return point
+ *  EXACT_MATCH and GREATER_THAN_OR_EQUAL find the first entry not less than
+ *  the key, GREATER_THAN the first entry greater than the key, and the LESS
+ *  modes the entry just before those
  *----------------------------------------------------------------------------*/
 template <class T, typename K>
-bool Ordering<T,K>::addNode(K key, const T& data, bool unique)
+bool Ordering<T,K>::search(K key, searchMode_t smode, position_t& pos) const
 {
-    /* Check for Valid Current Pointer */
-    if (curr == NULL && lastNode != NULL) curr = lastNode;
+    const long num_blocks = blocks.size();
+    if(len == 0) return false; // may still hold an empty block
 
-    /* Find Insertion Point */
-    if (curr != NULL)
+    if (smode == EXACT_MATCH)
     {
-        if (key <= curr->key)
-        {
-            while (key <= curr->key && curr->prev != NULL)
-            {
-                curr = curr->prev;
-            }
-        }
-        else // if(new_node->key > curr->key)
-        {
-            while (key > curr->key && curr->next != NULL)
-            {
-                curr = curr->next;
-            }
-        }
+        pos = lowerBound(key);
+        return (pos.block < num_blocks) && (blocks[pos.block].keys[pos.index] == key);
+    }
+    else if (smode == GREATER_THAN_OR_EQUAL) // i.e. you want the first node greater than or equal to the key
+    {
+        pos = lowerBound(key);
+        return pos.block < num_blocks;
+    }
+    else if (smode == LESS_THAN_OR_EQUAL) // i.e. you want the last node less than or equal to the key
+    {
+        pos = upperBound(key);
+        return stepBack(pos);
+    }
+    else if (smode == GREATER_THAN) // i.e. you want the first node greater than the key
+    {
+        pos = upperBound(key);
+        return pos.block < num_blocks;
+    }
+    else if (smode == LESS_THAN) // i.e. you want the last node less than the key
+    {
+        pos = lowerBound(key);
+        return stepBack(pos);
+    }
+    else // invalid search mode
+    {
+        assert(false);
     }
 
-    /* Check Uniqueness */
-    if(unique && curr && curr->key == key)
+    return false;
+}
+
+/*----------------------------------------------------------------------------
+ * lowerBound - position of first entry not less than key, or end
+ *----------------------------------------------------------------------------*/
+template <class T, typename K>
+typename Ordering<T,K>::position_t Ordering<T,K>::lowerBound(K key) const
+{
+    position_t pos = {0, 0};
+    if(!maxKeys.empty()) pos.block = std::lower_bound(maxKeys.begin(), maxKeys.end(), key) - maxKeys.begin();
+    else if(blocks.empty() || blocks[0].keys.empty() || (blocks[0].keys.back() < key)) pos.block = blocks.size();
+
+    if(pos.block < static_cast<long>(blocks.size()))
     {
-        return false;
+        const vector<K>& keys = blocks[pos.block].keys;
+        pos.index = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
     }
+    return pos;
+}
 
-    /* Allocate New Node */
-    sorted_node_t* new_node = new sorted_node_t;
-    len++;
+/*----------------------------------------------------------------------------
+ * upperBound - position of first entry greater than key, or end
+ *----------------------------------------------------------------------------*/
+template <class T, typename K>
+typename Ordering<T,K>::position_t Ordering<T,K>::upperBound(K key) const
+{
+    position_t pos = {0, 0};
+    if(!maxKeys.empty()) pos.block = std::upper_bound(maxKeys.begin(), maxKeys.end(), key) - maxKeys.begin();
+    else if(blocks.empty() || blocks[0].keys.empty() || !(key < blocks[0].keys.back())) pos.block = blocks.size();
 
-    /* Populate Node */
-    new_node->key = key;
-    new_node->data = data;
-    new_node->next = NULL;
-    new_node->prev = NULL;
+    if(pos.block < static_cast<long>(blocks.size()))
+    {
+        const vector<K>& keys = blocks[pos.block].keys;
+        pos.index = std::upper_bound(keys.begin(), keys.end(), key) - keys.begin();
+    }
+    return pos;
+}
 
-    /* Add Node */
-    if (curr == NULL)
+/*----------------------------------------------------------------------------
+ * stepBack - moves position to the previous entry, false if at the start
+ *----------------------------------------------------------------------------*/
+template <class T, typename K>
+bool Ordering<T,K>::stepBack(position_t& pos) const
+{
+    if(pos.index > 0)
     {
-        curr = new_node;
-        firstNode = new_node;
-        lastNode = new_node;
+        pos.index--;
+        return true;
     }
-    else if (new_node->key <= curr->key)
+
+    if(pos.block > 0)
     {
-        new_node->next = curr;
-        new_node->prev = curr->prev;
+        pos.block--;
+        pos.index = blocks[pos.block].keys.size() - 1;
+        return true;
+    }
 
-        if (curr->prev != NULL) curr->prev->next = new_node;
-        else                    firstNode = new_node; // reposition first node
+    return false;
+}
 
-        curr->prev = new_node;
+/*----------------------------------------------------------------------------
+ * insertEntry
+ *
+ *  an end position appends to the last block; a full block is split in half
+ *  before the entry is inserted, and current is left on the new entry
+ *----------------------------------------------------------------------------*/
+template <class T, typename K>
+void Ordering<T,K>::insertEntry(position_t pos, K key, const T& data)
+{
+    /* Resolve End Position */
+    if(blocks.empty())
+    {
+        blocks.emplace_back();
+        blocks[0].keys.reserve(INITIAL_BLOCK_SIZE);
+        blocks[0].data.reserve(INITIAL_BLOCK_SIZE);
+        pos.block = 0;
+        pos.index = 0;
     }
-    else // if(new_node->key > curr->key)
+    else if(pos.block >= static_cast<long>(blocks.size()))
     {
-        new_node->prev = curr;
-        new_node->next = curr->next;
-
-        if (curr->next != NULL) curr->next->prev = new_node;
-        else                    lastNode = new_node; // reposition last node
+        pos.block = blocks.size() - 1;
+        pos.index = blocks[pos.block].keys.size();
+    }
 
-        curr->next = new_node;
+    /* Split Full Block */
+    if(static_cast<long>(blocks[pos.block].keys.size()) >= BLOCK_SIZE)
+    {
+        const long half = BLOCK_SIZE / 2;
+        if(maxKeys.empty()) maxKeys.push_back(blocks[0].keys.back());
+        blocks.emplace(blocks.begin() + pos.block + 1);
+        maxKeys.insert(maxKeys.begin() + pos.block + 1, maxKeys[pos.block]);
+        sorted_block_t& lower = blocks[pos.block];
+        sorted_block_t& upper = blocks[pos.block + 1];
+        upper.keys.reserve(BLOCK_SIZE);
+        upper.data.reserve(BLOCK_SIZE);
+        upper.keys.assign(lower.keys.begin() + half, lower.keys.end());
+        upper.data.assign(lower.data.begin() + half, lower.data.end());
+        lower.keys.resize(half);
+        lower.data.resize(half);
+        maxKeys[pos.block] = lower.keys.back();
+        if(pos.index > half)
+        {
+            pos.block++;
+            pos.index -= half;
+        }
     }
 
-    /* Post or Remove First Node */
-    while ((maxListSize != INFINITE_LIST_SIZE) && (len > maxListSize))
+    /* Insert Entry */
+    sorted_block_t& block = blocks[pos.block];
+    if(pos.index == static_cast<long>(block.keys.size()))
     {
-        /* Save off First and Move it to Next */
-        sorted_node_t* old_node = firstNode;
-        firstNode = firstNode->next;
+        block.keys.push_back(key);
+        block.data.push_back(data);
+        if(!maxKeys.empty()) maxKeys[pos.block] = key;
+    }
+    else
+    {
+        block.keys.insert(block.keys.begin() + pos.index, key);
+        block.data.insert(block.data.begin() + pos.index, data);
+    }
+    len++;
+
+    curr = pos;
+}
+
+/*----------------------------------------------------------------------------
+ * eraseEntry
+ *
+ *  does not free the data; a current position at or after the entry shifts
+ *  so that it stays on the same entry, or the following one if it was the
+ *  entry erased (the preceding one if there is no following entry); the
+ *  last block is kept when it empties
+ *----------------------------------------------------------------------------*/
+template <class T, typename K>
+void Ordering<T,K>::eraseEntry(position_t pos)
+{
+    sorted_block_t& block = blocks[pos.block];
+    block.keys.erase(block.keys.begin() + pos.index);
+    block.data.erase(block.data.begin() + pos.index);
+    len--;
 
-        /* Check Curr Pointer */
-        if (curr == old_node)
+    /* Update Current Position */
+    if(curr.block == pos.block)
+    {
+        if(curr.index > pos.index) curr.index--;
+        if(curr.index >= static_cast<long>(block.keys.size()))
         {
-            curr = firstNode;
+            curr.block++;
+            curr.index = 0;
         }
+    }
 
-        /* Post/Free Data */
-        postNode(old_node);
-
-        /* Delete Old Node */
-        delete old_node;
-        len--;
+    /* Remove Empty Block */
+    if(block.keys.empty() && (blocks.size() > 1))
+    {
+        blocks.erase(blocks.begin() + pos.block);
+        maxKeys.erase(maxKeys.begin() + pos.block);
+        if(blocks.size() <= 1) maxKeys.clear();
+        if(curr.block > pos.block) curr.block--;
+    }
+    else if(!maxKeys.empty())
+    {
+        maxKeys[pos.block] = block.keys.back();
+    }
 
-        /* Check for Exit */
-        if (firstNode != NULL)
+    /* Fall Back to Last Entry */
+    if(curr.block >= static_cast<long>(blocks.size()))
+    {
+        if(len == 0)
         {
-            firstNode->prev = NULL;
+            curr.block = -1;
         }
-        else // empty list
+        else
         {
-            firstNode = NULL;
-            curr = NULL;
-            lastNode = NULL;
-            break;
+            curr.block = blocks.size() - 1;
+            curr.index = blocks[curr.block].keys.size() - 1;
         }
     }
+}
 
-    return true;
+/*----------------------------------------------------------------------------
+ * trimList
+ *
+ *  posts (or frees) the first entries until the list is within its max size
+ *----------------------------------------------------------------------------*/
+template <class T, typename K>
+void Ordering<T,K>::trimList(void)
+{
+    while ((maxListSize != INFINITE_LIST_SIZE) && (len > maxListSize))
+    {
+        const position_t front = {0, 0};
+        postNode(blocks[0].data[0]);
+        eraseEntry(front);
+    }
 }
 
 /*----------------------------------------------------------------------------
  * postNode
  *----------------------------------------------------------------------------*/
 template <class T, typename K>
-void Ordering<T,K>::postNode(sorted_node_t* node)
+void Ordering<T,K>::postNode(T& data)
 {
     int status = 0;
-    if(postFunc) status = postFunc(&(node->data), sizeof(T), postParm);
-    if(status <= 0) freeNode(node);
+    if(postFunc) status = postFunc(&data, sizeof(T), postParm);
+    if(status <= 0) freeNode(data);
 }
 
 /*----------------------------------------------------------------------------
@@ -687,9 +857,9 @@ template <class T>
 void orderingDeleteIfPointer(T* t) { delete t; }
 
 template <class T, typename K>
-void Ordering<T,K>::freeNode(sorted_node_t* node)
+void Ordering<T,K>::freeNode(T& data)
 {
-    orderingDeleteIfPointer(node->data);
+    orderingDeleteIfPointer(data);
 }
 
 #endif  /* __ordering__ */
@@ -321,6 +321,12 @@ bool OutputLib::send2S3 (const char* src_file, const char* dst_file, const char*
         /* Send Initial Status */
         alert(INFO, RTE_STATUS, outq, NULL, "Initiated upload of results to S3, bucket = %s, key = %s", bucket, key);
 
+        /* Select Multipart Upload for Large Files */
+        const int64_t threshold = static_cast<int64_t>(SystemConfig::settings().s3MultipartThresholdMB.value) * 0x100000L;
+        std::error_code ec;
+        const int64_t file_size = static_cast<int64_t>(std::filesystem::file_size(src_file, ec));
+        const bool multipart = (threshold > 0) && !ec && (file_size > threshold);
+
         /* Upload to S3 */
         int attempt = 0;
         int64_t bytes_uploaded = 0;
@@ -328,7 +334,15 @@ bool OutputLib::send2S3 (const char* src_file, const char* dst_file, const char*
         {
             try
             {
-                bytes_uploaded = S3CurlIODriver::put(src_file, bucket, key, endpoint, &credentials, with_checksum);
+                if(multipart)
+                {
+                    const int64_t part_size = static_cast<int64_t>(SystemConfig::settings().s3PartSizeMB.value) * 0x100000L;
+                    bytes_uploaded = S3CurlIODriver::putMultipart(src_file, bucket, key, endpoint, &credentials, with_checksum, part_size, SystemConfig::settings().s3UploadConcurrency.value);
+                }
+                else
+                {
+                    bytes_uploaded = S3CurlIODriver::put(src_file, bucket, key, endpoint, &credentials, with_checksum);
+                }
             }
             catch(const RunTimeException& e)
             {
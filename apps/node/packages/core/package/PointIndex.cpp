@@ -48,6 +48,9 @@ const struct luaL_Reg PointIndex::LUA_META_TABLE[] = {
     {"add",         luaAdd},
     {"query",       luaQuery},
     {"display",     luaDisplay},
+    {"pack",        luaPack},
+    {"save",        luaSave},
+    {"load",        luaLoad},
     {NULL,          NULL}
 };
 
@@ -224,3 +227,12 @@ void PointIndex::displayspan (const pointspan_t& span)
 {
     print2term("[%.3lf, %.3lf]", span.minval, span.maxval);
 }
+
+/*----------------------------------------------------------------------------
+ * center
+ *----------------------------------------------------------------------------*/
+double PointIndex::center (const pointspan_t& span, int dim)
+{
+    (void)dim;
+    return (span.minval + span.maxval) / 2.0;
+}
@@ -71,6 +71,7 @@ class PointIndex: public AssetIndex<pointspan_t>
         pointspan_t     attr2span       (Dictionary<double>* attr, bool* provided=NULL) override;
         pointspan_t     luatable2span   (lua_State* L, int parm) override;
         void            displayspan     (const pointspan_t& span) override;
+        double          center          (const pointspan_t& span, int dim) override;
 
     private:
 
@@ -172,6 +172,169 @@ RecordObject::valType_t RecordObject::Field::getValueType(void)
     return RecordObject::getValueType(field);
 }
 
+/******************************************************************************
+ * RECORD OBJECT ACCESSOR METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+RecordObject::Accessor::Accessor(const field_t& _field):
+    field(_field),
+    offset(TOBYTES(_field.offset)),
+    size(0),
+    swap(NATIVE_FLAGS != (_field.flags & BIGENDIAN)),
+    readReal(NULL),
+    readInteger(NULL)
+{
+    if(field.type >= 0 && field.type < NUM_FIELD_TYPES)
+    {
+        size = FIELD_TYPE_BYTES[field.type];
+    }
+
+    /* Only Fields at a Fixed Byte Offset are Read Directly */
+    if((field.flags & POINTER) || (field.offset % 8 != 0)) return;
+
+    if(swap) compile<true>();
+    else compile<false>();
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor - invalid
+ *----------------------------------------------------------------------------*/
+RecordObject::Accessor::Accessor(void):
+    field({INVALID_FIELD, 0, 0, NULL, NATIVE_FLAGS, NULL}),
+    offset(0),
+    size(0),
+    swap(false),
+    readReal(NULL),
+    readInteger(NULL)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * getReal
+ *----------------------------------------------------------------------------*/
+double RecordObject::Accessor::getReal(RecordObject* rec, int element) const
+{
+    if(!readReal) return rec->getValueReal(field, element);
+    if(field.elements > 0 && element > 0 && element >= field.elements) throw RunTimeException(CRITICAL, RTE_FAILURE, "Out of range access");
+    return readReal(rec->recordData + offset + (element * size));
+}
+
+/*----------------------------------------------------------------------------
+ * getInteger
+ *----------------------------------------------------------------------------*/
+long RecordObject::Accessor::getInteger(RecordObject* rec, int element) const
+{
+    if(!readInteger) return rec->getValueInteger(field, element);
+    if(field.elements > 0 && element > 0 && element >= field.elements) throw RunTimeException(CRITICAL, RTE_FAILURE, "Out of range access");
+    return readInteger(rec->recordData + offset + (element * size));
+}
+
+/*----------------------------------------------------------------------------
+ * compile
+ *----------------------------------------------------------------------------*/
+template<bool SWAP>
+void RecordObject::Accessor::compile(void)
+{
+    switch(field.type)
+    {
+        case INT8:      readReal = readAsReal<int8_t,SWAP>;     readInteger = readAsInteger<int8_t,SWAP>;     break;
+        case INT16:     readReal = readAsReal<int16_t,SWAP>;    readInteger = readAsInteger<int16_t,SWAP>;    break;
+        case INT32:     readReal = readAsReal<int32_t,SWAP>;    readInteger = readAsInteger<int32_t,SWAP>;    break;
+        case INT64:     readReal = readAsReal<int64_t,SWAP>;    readInteger = readAsInteger<int64_t,SWAP>;    break;
+        case UINT8:     readReal = readAsReal<uint8_t,SWAP>;    readInteger = readAsInteger<uint8_t,SWAP>;    break;
+        case UINT16:    readReal = readAsReal<uint16_t,SWAP>;   readInteger = readAsInteger<uint16_t,SWAP>;   break;
+        case UINT32:    readReal = readAsReal<uint32_t,SWAP>;   readInteger = readAsInteger<uint32_t,SWAP>;   break;
+        case UINT64:    readReal = readAsReal<uint64_t,SWAP>;   readInteger = readAsInteger<uint64_t,SWAP>;   break;
+        case FLOAT:     readReal = readAsReal<float,SWAP>;      readInteger = readAsInteger<float,SWAP>;      break;
+        case DOUBLE:    readReal = readAsReal<double,SWAP>;     readInteger = readAsInteger<double,SWAP>;     break;
+        case TIME8:     readReal = readAsReal<int64_t,SWAP>;    readInteger = readAsInteger<int64_t,SWAP>;    break;
+        default:        break; // BITFIELD, STRING, OBJECT, BOOL use the record methods
+    }
+}
+
+/******************************************************************************
+ * RECORD OBJECT FIELD PATH METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+RecordObject::FieldPath::FieldPath(const char* _name):
+    name(StringLib::duplicate(_name)),
+    numEntries(0)
+{
+    if(name && name[0] == IMMEDIATE_FIELD_SYMBOL)
+    {
+        immediate = Accessor(parseImmediateField(name));
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor
+ *----------------------------------------------------------------------------*/
+RecordObject::FieldPath::~FieldPath(void)
+{
+    delete [] name;
+}
+
+/*----------------------------------------------------------------------------
+ * resolve
+ *
+ *  entries are only ever appended and are fully written before numEntries
+ *  is published, so readers scan them without taking the lock; definitions
+ *  are never removed so their addresses identify the record type
+ *----------------------------------------------------------------------------*/
+const RecordObject::Accessor& RecordObject::FieldPath::resolve(RecordObject* rec)
+{
+    if(immediate.isValid()) return immediate;
+
+    const void* def = rec->recordDefinition;
+
+    /* Lock Free Lookup */
+    int n = numEntries.load(std::memory_order_acquire);
+    for(int i = 0; i < n; i++)
+    {
+        if(entries[i].def == def) return entries[i].accessor;
+    }
+
+    /* Compile Accessor for Record Type */
+    const Accessor* accessor = NULL;
+    compileMut.lock();
+    {
+        n = numEntries.load(std::memory_order_relaxed);
+        for(int i = 0; i < n; i++)
+        {
+            if(entries[i].def == def)
+            {
+                accessor = &entries[i].accessor;
+                break;
+            }
+        }
+
+        if(!accessor && n < MAX_RECORD_TYPES)
+        {
+            entries[n].def = def;
+            entries[n].accessor = Accessor(getUserField(rec->recordDefinition, name));
+            numEntries.store(n + 1, std::memory_order_release);
+            accessor = &entries[n].accessor;
+        }
+    }
+    compileMut.unlock();
+
+    /* More Record Types than Slots */
+    if(!accessor)
+    {
+        thread_local Accessor overflow;
+        overflow = Accessor(getUserField(rec->recordDefinition, name));
+        accessor = &overflow;
+    }
+
+    return *accessor;
+}
+
 /******************************************************************************
  * PUBLIC METHODS
  ******************************************************************************/
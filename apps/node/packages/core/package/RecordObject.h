@@ -241,6 +241,89 @@ class RecordObject
                 int             element;        // for arrays
         };
 
+        /*--------------------------------------------------------------------
+         * Accessor (subclass)
+         *
+         *  field resolved once into a typed reader; fields at a fixed offset
+         *  are read directly from the record data, pointers and bit fields
+         *  fall back to getValueReal/getValueInteger
+         *--------------------------------------------------------------------*/
+
+        class Accessor
+        {
+            public:
+
+                explicit    Accessor        (const field_t& _field);
+                            Accessor        (void);
+                            ~Accessor       (void) = default;
+
+                bool        isValid         (void) const { return field.type != INVALID_FIELD; }
+                bool        isDirect        (void) const { return readReal != NULL; }
+                const field_t& getField     (void) const { return field; }
+
+                double      getReal         (RecordObject* rec, int element=0) const;
+                long        getInteger      (RecordObject* rec, int element=0) const;
+
+                /* direct accessors only; byte_offset is added to the field offset (e.g. row in a batch) */
+                double      real            (const unsigned char* data, long byte_offset=0) const { return readReal(data + offset + byte_offset); }
+                long        integer         (const unsigned char* data, long byte_offset=0) const { return readInteger(data + offset + byte_offset); }
+                template<class T>
+                T           value           (const unsigned char* data, long byte_offset=0) const;
+
+            private:
+
+                typedef double (*real_f) (const unsigned char* ptr);
+                typedef long (*integer_f) (const unsigned char* ptr);
+
+                template<class T, bool SWAP> static T read (const unsigned char* ptr);
+                template<class T, bool SWAP> static double readAsReal (const unsigned char* ptr) { return static_cast<double>(read<T,SWAP>(ptr)); }
+                template<class T, bool SWAP> static long readAsInteger (const unsigned char* ptr) { return static_cast<long>(read<T,SWAP>(ptr)); }
+                template<bool SWAP> void compile (void);
+
+                field_t         field;          // resolved field
+                int32_t         offset;         // bytes into record data
+                int32_t         size;           // bytes per element
+                bool            swap;           // field endianness differs from host
+                real_f          readReal;       // NULL when not direct
+                integer_f       readInteger;    // NULL when not direct
+        };
+
+        /*--------------------------------------------------------------------
+         * FieldPath (subclass)
+         *
+         *  field name compiled into an accessor per record type the first
+         *  time a record of that type is seen; lookups after that are a
+         *  lock free scan of the definitions already compiled
+         *--------------------------------------------------------------------*/
+
+        class FieldPath
+        {
+            public:
+
+                static const int MAX_RECORD_TYPES = 8;
+
+                explicit        FieldPath       (const char* _name);
+                                ~FieldPath      (void);
+
+                const Accessor& resolve         (RecordObject* rec);
+                double          getReal         (RecordObject* rec, int element=0) { return resolve(rec).getReal(rec, element); }
+                long            getInteger      (RecordObject* rec, int element=0) { return resolve(rec).getInteger(rec, element); }
+                const char*     getName         (void) const { return name; }
+
+            private:
+
+                typedef struct {
+                    const void*         def;    // definition_t of record type
+                    Accessor            accessor;
+                } entry_t;
+
+                const char*         name;
+                Accessor            immediate;      // used when name is an immediate field
+                Mutex               compileMut;
+                entry_t             entries[MAX_RECORD_TYPES];
+                std::atomic<int>    numEntries;
+        };
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
@@ -385,6 +468,38 @@ class RecordObject
         static definition_t*    getDefinition       (const unsigned char* buffer, int size);
 };
 
+/*----------------------------------------------------------------------------
+ * Accessor::read
+ *----------------------------------------------------------------------------*/
+template<class T, bool SWAP>
+T RecordObject::Accessor::read (const unsigned char* ptr)
+{
+    T v;
+    memcpy(&v, ptr, sizeof(T));
+    if constexpr (SWAP && sizeof(T) > 1)
+    {
+        unsigned char* b = reinterpret_cast<unsigned char*>(&v);
+        for(size_t i = 0; i < sizeof(T) / 2; i++)
+        {
+            const unsigned char t = b[i];
+            b[i] = b[sizeof(T) - 1 - i];
+            b[sizeof(T) - 1 - i] = t;
+        }
+    }
+    return v;
+}
+
+/*----------------------------------------------------------------------------
+ * Accessor::value - T must be the storage type of the field
+ *----------------------------------------------------------------------------*/
+template<class T>
+T RecordObject::Accessor::value (const unsigned char* data, long byte_offset) const
+{
+    assert(sizeof(T) == static_cast<size_t>(size));
+    const unsigned char* ptr = data + offset + byte_offset;
+    return swap ? read<T,true>(ptr) : read<T,false>(ptr);
+}
+
 /*----------------------------------------------------------------------------
  * Exported Typedef (Syntax Sugar)
  *----------------------------------------------------------------------------*/
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <sys/mman.h>
+
+#include "OsApi.h"
+#include "StringLib.h"
+#include "RequestArena.h"
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+std::atomic<uint64_t> RequestArena::arenaIds {1};
+std::atomic<size_t> RequestArena::totalReserved {0};
+std::atomic<long> RequestArena::totalArenas {0};
+
+thread_local shared_ptr<RequestArena> RequestArena::boundArena;
+thread_local RequestArena::sub_arena_t RequestArena::subArenas[SUB_ARENA_SLOTS] = {};
+thread_local int RequestArena::nextSubArena = 0;
+
+/******************************************************************************
+ * SCOPE METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Scope Constructor
+ *----------------------------------------------------------------------------*/
+RequestArena::Scope::Scope(const shared_ptr<RequestArena>& arena):
+    previous(boundArena)
+{
+    boundArena = arena;
+}
+
+/*----------------------------------------------------------------------------
+ * Scope Destructor
+ *----------------------------------------------------------------------------*/
+RequestArena::Scope::~Scope(void)
+{
+    boundArena = previous;
+}
+
+/******************************************************************************
+ * PUBLIC METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+RequestArena::RequestArena(const char* _name, size_t _slab_size):
+    id(arenaIds++),
+    name(StringLib::duplicate(_name)),
+    slabSize(MAX(_slab_size, MIN_SLAB_SIZE)),
+    reserved(0),
+    used(0)
+{
+    totalArenas++;
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor
+ *----------------------------------------------------------------------------*/
+RequestArena::~RequestArena(void)
+{
+    for(const auto& entry: slabs)
+    {
+        munmap(entry.second->base, entry.second->size);
+        delete entry.second;
+    }
+    totalReserved -= reserved;
+    totalArenas--;
+    delete [] name;
+}
+
+/*----------------------------------------------------------------------------
+ * allocate
+ *
+ *  small allocations are carved out of the calling thread's slab for this
+ *  arena; allocations larger than a quarter of a slab get a slab of their own
+ *  so they don't strand the remainder of the current one
+ *----------------------------------------------------------------------------*/
+void* RequestArena::allocate(size_t size, size_t alignment)
+{
+    if(size == 0) size = 1;
+
+    /* Large Allocations */
+    if(size > (slabSize >> 2))
+    {
+        slab_t* slab = newSlab(size, false);
+        slab->offset = size;
+        slab->live += size;
+        used += size;
+        return slab->base;
+    }
+
+    /* Find Thread's Sub-Arena */
+    sub_arena_t* sub_arena = NULL;
+    for(int i = 0; i < SUB_ARENA_SLOTS; i++)
+    {
+        if(subArenas[i].arena_id == id)
+        {
+            sub_arena = &subArenas[i];
+            break;
+        }
+    }
+
+    /* Claim a Slot for this Arena */
+    if(!sub_arena)
+    {
+        sub_arena = &subArenas[nextSubArena];
+        nextSubArena = (nextSubArena + 1) % SUB_ARENA_SLOTS;
+
+        /* Retire Slab of Evicted Arena (if it still exists) */
+        if(sub_arena->slab)
+        {
+            const shared_ptr<RequestArena> evicted = sub_arena->owner.lock();
+            if(evicted) evicted->retireSlab(sub_arena->slab);
+        }
+
+        sub_arena->arena_id = id;
+        sub_arena->owner = weak_from_this();
+        sub_arena->slab = newSlab(slabSize, true);
+    }
+
+    /* Bump Allocate */
+    slab_t* slab = sub_arena->slab;
+    size_t offset = (slab->offset + alignment - 1) & ~(alignment - 1);
+    if(offset + size > slab->size)
+    {
+        retireSlab(slab);
+        slab = newSlab(slabSize, true);
+        sub_arena->slab = slab;
+        offset = 0;
+    }
+    slab->offset = offset + size;
+    slab->live += size;
+    used += size;
+
+    return slab->base + offset;
+}
+
+/*----------------------------------------------------------------------------
+ * release
+ *
+ *  hands back memory returned by allocate; the slab it came from is unmapped
+ *  once everything in it has been released and no thread is still carving
+ *  out of it, otherwise the memory is reclaimed with the arena
+ *----------------------------------------------------------------------------*/
+void RequestArena::release(void* ptr, size_t size)
+{
+    if(size == 0) size = 1;
+
+    uint8_t* addr = static_cast<uint8_t*>(ptr);
+    slabMut.lock();
+    {
+        auto iter = slabs.upper_bound(addr);
+        if(iter != slabs.begin())
+        {
+            slab_t* slab = (--iter)->second;
+            if(addr < slab->base + slab->size)
+            {
+                used -= size;
+                if((slab->live -= size) == 0 && !slab->active)
+                {
+                    unmapSlab(slab);
+                }
+            }
+        }
+    }
+    slabMut.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * getName
+ *----------------------------------------------------------------------------*/
+const char* RequestArena::getName(void) const
+{
+    return name;
+}
+
+/*----------------------------------------------------------------------------
+ * reservedBytes - memory mapped for this arena
+ *----------------------------------------------------------------------------*/
+size_t RequestArena::reservedBytes(void) const
+{
+    return reserved;
+}
+
+/*----------------------------------------------------------------------------
+ * usedBytes - memory handed out by this arena and not yet released
+ *----------------------------------------------------------------------------*/
+size_t RequestArena::usedBytes(void) const
+{
+    return used;
+}
+
+/*----------------------------------------------------------------------------
+ * current - arena bound to the calling thread, NULL if none
+ *----------------------------------------------------------------------------*/
+shared_ptr<RequestArena> RequestArena::current(void)
+{
+    return boundArena;
+}
+
+/*----------------------------------------------------------------------------
+ * liveBytes - memory mapped across all arenas in the process
+ *----------------------------------------------------------------------------*/
+size_t RequestArena::liveBytes(void)
+{
+    return totalReserved;
+}
+
+/*----------------------------------------------------------------------------
+ * liveArenas
+ *----------------------------------------------------------------------------*/
+long RequestArena::liveArenas(void)
+{
+    return totalArenas;
+}
+
+/******************************************************************************
+ * PRIVATE METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * newSlab
+ *----------------------------------------------------------------------------*/
+RequestArena::slab_t* RequestArena::newSlab(size_t size, bool active)
+{
+    const size_t page_size = 0x1000;
+    const size_t map_size = (size + page_size - 1) & ~(page_size - 1);
+
+    void* base = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(base == MAP_FAILED)
+    {
+        throw RunTimeException(CRITICAL, RTE_NOT_ENOUGH_MEMORY, "arena %s failed to map %ld bytes", name, static_cast<long>(map_size));
+    }
+
+    slab_t* slab = new slab_t;
+    slab->base = static_cast<uint8_t*>(base);
+    slab->size = map_size;
+    slab->offset = 0;
+    slab->live = 0;
+    slab->active = active;
+    slabMut.lock();
+    {
+        slabs[slab->base] = slab;
+    }
+    slabMut.unlock();
+
+    reserved += map_size;
+    totalReserved += map_size;
+
+    return slab;
+}
+
+/*----------------------------------------------------------------------------
+ * retireSlab - called by the allocating thread when it moves to a new slab
+ *----------------------------------------------------------------------------*/
+void RequestArena::retireSlab(slab_t* slab)
+{
+    slabMut.lock();
+    {
+        slab->active = false;
+        if(slab->live == 0) unmapSlab(slab);
+    }
+    slabMut.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * unmapSlab - slabMut must be held
+ *----------------------------------------------------------------------------*/
+void RequestArena::unmapSlab(slab_t* slab)
+{
+    slabs.erase(slab->base);
+    munmap(slab->base, slab->size);
+    reserved -= slab->size;
+    totalReserved -= slab->size;
+    delete slab;
+}
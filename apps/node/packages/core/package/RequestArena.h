@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __request_arena__
+#define __request_arena__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include "OsApi.h"
+
+/******************************************************************************
+ * CLASS
+ ******************************************************************************/
+
+/*
+ * Bump allocator whose memory is released in bulk when the last reference to
+ * the arena goes away.  Each thread allocating out of an arena carves from its
+ * own slab so the hot path takes no lock.  Slabs are mapped directly from the
+ * operating system so that releasing an arena returns its memory immediately
+ * instead of leaving fragmented free space in the heap.  Memory handed back
+ * with release() is unmapped as soon as nothing in its slab is still in use
+ * and no thread is allocating out of the slab; a thread that gives up its
+ * slot for an arena to allocate out of another one retires the slab it held.
+ *
+ * A request binds an arena to its thread with a Scope; structures that opt in
+ * capture RequestArena::current() when they are constructed and keep a
+ * reference to it for as long as they live.
+ */
+class RequestArena: public std::enable_shared_from_this<RequestArena>
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const size_t DEFAULT_SLAB_SIZE = 0x100000; // 1MB
+        static const size_t MIN_SLAB_SIZE = 0x10000; // 64KB
+        static const int SUB_ARENA_SLOTS = 4; // arenas a thread can allocate from without grabbing a new slab
+
+        /*--------------------------------------------------------------------
+         * Scope - binds an arena to the calling thread
+         *--------------------------------------------------------------------*/
+
+        class Scope
+        {
+            public:
+                explicit Scope  (const shared_ptr<RequestArena>& arena);
+                ~Scope          (void);
+            private:
+                shared_ptr<RequestArena> previous;
+        };
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        explicit                    RequestArena    (const char* _name, size_t _slab_size=DEFAULT_SLAB_SIZE);
+                                    ~RequestArena   (void);
+
+        void*                       allocate        (size_t size, size_t alignment=alignof(std::max_align_t));
+        template<class T> T*        allocate        (long count) { return static_cast<T*>(allocate(count * sizeof(T), alignof(T))); }
+        void                        release         (void* ptr, size_t size);
+        template<class T> void      release         (T* ptr, long count) { release(static_cast<void*>(ptr), count * sizeof(T)); }
+
+        const char*                 getName         (void) const;
+        size_t                      reservedBytes   (void) const;
+        size_t                      usedBytes       (void) const;
+
+        static shared_ptr<RequestArena> current     (void);
+        static size_t               liveBytes       (void);
+        static long                 liveArenas      (void);
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        struct slab_t {
+            uint8_t*            base;
+            size_t              size;
+            size_t              offset;
+            std::atomic<size_t> live;       // bytes handed out and not yet released
+            bool                active;     // a thread is bump allocating out of it (protected by slabMut)
+        };
+
+        typedef struct {
+            uint64_t                    arena_id;
+            slab_t*                     slab;
+            std::weak_ptr<RequestArena> owner;  // so an evicted slab can be retired if its arena still exists
+        } sub_arena_t;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        slab_t*                     newSlab         (size_t size, bool active);
+        void                        retireSlab      (slab_t* slab);
+        void                        unmapSlab       (slab_t* slab);
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        static std::atomic<uint64_t>    arenaIds;
+        static std::atomic<size_t>      totalReserved;
+        static std::atomic<long>        totalArenas;
+
+        static thread_local shared_ptr<RequestArena> boundArena;
+        static thread_local sub_arena_t subArenas[SUB_ARENA_SLOTS];
+        static thread_local int         nextSubArena;
+
+        const uint64_t                  id;
+        const char*                     name;
+        const size_t                    slabSize;
+        Mutex                           slabMut;
+        std::map<uint8_t*, slab_t*>     slabs;          // keyed by base address
+        std::atomic<size_t>             reserved;
+        std::atomic<size_t>             used;
+};
+
+/******************************************************************************
+ * ALLOCATOR
+ ******************************************************************************/
+
+/*
+ * Standard library allocator over the arena bound when the container is
+ * constructed; falls back to the heap when no arena is bound.  Buffers
+ * dropped as a container grows or shrinks are released back to the arena.
+ */
+template<class T>
+class ArenaAllocator
+{
+    public:
+
+        typedef T value_type;
+
+        ArenaAllocator (void): arena(RequestArena::current()) {}
+        template<class U> ArenaAllocator (const ArenaAllocator<U>& other): arena(other.arena) {}
+
+        T* allocate (size_t n)
+        {
+            if(arena) return arena->allocate<T>(n);
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate (T* p, size_t n)
+        {
+            if(arena) arena->release<T>(p, n);
+            else std::allocator<T>().deallocate(p, n);
+        }
+
+        template<class U> bool operator== (const ArenaAllocator<U>& other) const { return arena == other.arena; }
+        template<class U> bool operator!= (const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+        shared_ptr<RequestArena> arena;
+};
+
+#endif  /* __request_arena__ */
@@ -451,6 +451,9 @@ void RequestParameters::fromLua (lua_State* L, int index)
     if(nodeTimeout == REQUEST_INVALID_TIMEOUT)  nodeTimeout = timeout;
     if(readTimeout == REQUEST_INVALID_TIMEOUT)  readTimeout = timeout;
 
+    // limit frame runner pool threads used by request
+    runnerPool.setLimit(runnerConcurrency.value);
+
     // project polygon (if necessary)
     pointsInPolygon = polygon.length();
     if(pointsInPolygon.value > 0)
@@ -499,6 +502,7 @@ RequestParameters::RequestParameters(lua_State* L, uint64_t key_space, const cha
     addParameter("node_timeout",        &nodeTimeout,           "Maximum duration in seconds for each distributed processing node to finish processing its portion of a request");
     addParameter("read_timeout",        &readTimeout,           "Maximum duration in seconds for an individual I/O read to complete");
     addParameter("cluster_size_hint",   &clusterSizeHint,       "User supplied hint as to the number of nodes in the cluster; used to influence the way the processing is distributed across the cluster");
+    addParameter("runner_concurrency",  &runnerConcurrency,     "Maximum number of threads working on a partitioned frame runner for the request at once; zero is limited only by the node");
     addParameter("key_space",           &keySpace,              "Partitions a key space to a processing node; in general a user should not supply this value but rather let the system choose a value (which is the default)");
     addParameter("region_mask",         &regionMask,            "GeoJSON structure describing the area of interest; this causes the server to rasterize the supplied area and subset based on the rasterized image");
     addParameter("sliderule_version",   &slideruleVersion,      "Version of the SlideRule software running on the servers; output only");
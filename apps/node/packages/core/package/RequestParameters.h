@@ -47,6 +47,7 @@
 #include "TimeLib.h"
 #include "OutputFields.h"
 #include "SystemConfig.h"
+#include "FrameRunnerPool.h"
 
 #ifdef __geo__
 #include "GeoFields.h"
@@ -158,6 +159,7 @@ class RequestParameters: public LuaObject, public FieldMap<Field>
         FieldElement<int>                   nodeTimeout         {REQUEST_INVALID_TIMEOUT};
         FieldElement<int>                   readTimeout         {REQUEST_INVALID_TIMEOUT};
         FieldElement<int>                   clusterSizeHint     {0};
+        FieldElement<int>                   runnerConcurrency   {0};
         FieldElement<uint64_t>              keySpace            {INVALID_KEY};
         RegionMask                          regionMask;
         FieldElement<string>                slideruleVersion    {LIBID, Field::READ_ONLY};
@@ -170,6 +172,7 @@ class RequestParameters: public LuaObject, public FieldMap<Field>
         #endif
 
         MathLib::point_t*                   projectedPolygon    {NULL};
+        FrameRunnerPool::Client             runnerPool;         // caps the frame runner pool threads used by the request
 };
 
 /******************************************************************************
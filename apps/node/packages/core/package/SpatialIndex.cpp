@@ -53,6 +53,9 @@ const struct luaL_Reg SpatialIndex::LUA_META_TABLE[] = {
     {"add",         luaAdd},
     {"query",       luaQuery},
     {"display",     luaDisplay},
+    {"pack",        luaPack},
+    {"save",        luaSave},
+    {"load",        luaLoad},
     {"project",     luaProject},
     {"sphere",      luaSphere},
     {"split",       luaSplit},
@@ -328,6 +331,24 @@ void SpatialIndex::displayspan (const spatialspan_t& span)
     print2term("[%d,%d x %d,%d]", (int)(proj.p0.x*100), (int)(proj.p0.y*100), (int)(proj.p1.x*100), (int)(proj.p1.y*100));
 }
 
+/*----------------------------------------------------------------------------
+ * center - center of the projected span; dim 0 is x and dim 1 is y
+ *----------------------------------------------------------------------------*/
+double SpatialIndex::center (const spatialspan_t& span, int dim)
+{
+    const projspan_t proj = project(span);
+    if(dim == 0) return (proj.p0.x + proj.p1.x) / 2.0;
+    return (proj.p0.y + proj.p1.y) / 2.0;
+}
+
+/*----------------------------------------------------------------------------
+ * dimensions
+ *----------------------------------------------------------------------------*/
+int SpatialIndex::dimensions (void)
+{
+    return 2;
+}
+
 /******************************************************************************
  * PRIVATE METHODS
  ******************************************************************************/
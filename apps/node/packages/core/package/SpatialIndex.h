@@ -72,6 +72,8 @@ class SpatialIndex: public AssetIndex<spatialspan_t>
         spatialspan_t   attr2span       (Dictionary<double>* attr, bool* provided=NULL) override;
         spatialspan_t   luatable2span   (lua_State* L, int parm) override;
         void            displayspan     (const spatialspan_t& span) override;
+        double          center          (const spatialspan_t& span, int dim) override;
+        int             dimensions      (void) override;
 
     private:
 
@@ -140,6 +140,18 @@ SystemConfig::SystemConfig(void):
         {"in_cloud",                    &inCloud,                   "Flag indicating if the servers detect they are running in a cloud environment"},
         {"publish_timeout_ms",          &publishTimeoutMs,          "Default timeout for posting messages to an internal message queue"},
         {"request_timeout_sec",         &requestTimeoutSec,         "Default timeout for all request related timeout values"},
+        {"proxy_hedge_percentile",      &proxyHedgePercentile,      "Percentile of completed resource durations a proxied resource must exceed before a duplicate request is issued; zero disables"},
+        {"proxy_hedge_min_samples",     &proxyHedgeMinSamples,      "Minimum number of completed resources needed before proxied resources are hedged"},
+        {"raster_collection_limit",     &rasterCollectionLimit,     "Maximum number of raster collections sampled concurrently across all requests on the server"},
+        {"raster_read_limit",           &rasterReadLimit,           "Maximum number of rasters read concurrently across all requests on the server"},
+        {"mask_cache_directory",        &maskCacheDirectory,        "Directory where decoded global masks are stored for memory mapping; empty disables"},
+        {"s3_multipart_threshold_mb",   &s3MultipartThresholdMB,    "Size of an output file above which uploads to S3 are performed as parallel multipart uploads; zero disables"},
+        {"s3_part_size_mb",             &s3PartSizeMB,              "Size of each part of a multipart upload to S3"},
+        {"s3_upload_concurrency",       &s3UploadConcurrency,       "Number of parts of a multipart upload to S3 sent concurrently"},
+        {"docker_socket",               &dockerSocket,              "Unix socket of the Docker API used to run container runtime environments"},
+        {"request_arena",               &requestArena,              "Boolean controlling if requests allocate dataframe columns out of a per-request arena"},
+        {"request_arena_limit_mb",      &requestArenaLimitMB,       "Maximum memory held by request arenas across the server before requests are rejected; zero disables"},
+        {"frame_runner_threads",        &frameRunnerThreads,        "Number of threads shared by all requests for running partitioned dataframe algorithms; zero uses all cores"},
         {"ipv4",                        &ipv4,                      "IP address (version 4) of the server"},
         {"environment_version",         &environmentVersion,        "Version of the infrastructure that deployed the server"},
         {"project_bucket",              &projectBucket,             "Private S3 bucket that holds system configuration and data assets"},
@@ -105,6 +105,18 @@ class SystemConfig: public FieldMap<Field>
         FieldElement<int>               requestMaxResources         {300};
         FieldElement<int>               signedRequestTimeWindow     {60}; // seconds
         FieldElement<string>            stagingAsset                {"sliderule-stage"};
+        FieldElement<float>             proxyHedgePercentile        {0.0}; // zero disables hedging
+        FieldElement<int>               proxyHedgeMinSamples        {10};
+        FieldElement<int>               rasterCollectionLimit       {4}; // node wide
+        FieldElement<int>               rasterReadLimit             {64}; // node wide
+        FieldElement<string>            maskCacheDirectory          {""}; // empty disables
+        FieldElement<int>               s3MultipartThresholdMB      {64}; // zero disables
+        FieldElement<int>               s3PartSizeMB                {16};
+        FieldElement<int>               s3UploadConcurrency         {8};
+        FieldElement<string>            dockerSocket                {"/var/run/docker.sock"};
+        FieldElement<bool>              requestArena                {false};
+        FieldElement<int>               requestArenaLimitMB         {0}; // zero disables
+        FieldElement<int>               frameRunnerThreads          {0}; // zero uses all cores
 
         // ENVIRONMENT VARIABLES
         FieldElement<string>            ipv4;
@@ -46,6 +46,7 @@
 #include "PointIndex.h"
 #include "FileEndpoint.h"
 #include "FileIODriver.h"
+#include "FrameRunnerPool.h"
 #include "GeoDataFrame.h"
 #include "HttpServer.h"
 #include "IntervalIndex.h"
@@ -77,10 +78,14 @@
 #include "OsApi.h"
 #ifdef __unittesting__
 #include "UT_Dictionary.h"
+#include "UT_EndpointProxy.h"
 #include "UT_Field.h"
+#include "UT_FrameRunnerPool.h"
 #include "UT_List.h"
 #include "UT_MsgQ.h"
 #include "UT_Ordering.h"
+#include "UT_RecordObject.h"
+#include "UT_RequestArena.h"
 #include "UT_String.h"
 #include "UT_Table.h"
 #include "UT_TimeLib.h"
@@ -131,6 +136,8 @@ static int core_open (lua_State *L)
         {"intervalindex",   IntervalIndex::luaCreate},
         {"spatialindex",    SpatialIndex::luaCreate},
         {"iodrivers",       Asset::luaDrivers},
+        {"iomodel",         FileIODriver::luaModel},
+        {"iostats",         FileIODriver::luaStats},
         {"get",             CurlLib::luaGet},
         {"put",             CurlLib::luaPut},
         {"post",            CurlLib::luaPost},
@@ -138,6 +145,7 @@ static int core_open (lua_State *L)
         {"download",        CurlLib::luaDownload},
         {"dataframe",       GeoDataFrame::luaCreate},
         {"framesender",     GeoDataFrame::FrameSender::luaCreate},
+        {"runnerpool",      FrameRunnerPool::luaStats},
         {"dedup",           DeduplicateRunner::luaCreate},
         {"proxy",           EndpointProxy::luaCreate},
         {"orchreg",         OrchestratorLib::luaRegisterService},
@@ -151,10 +159,14 @@ static int core_open (lua_State *L)
         {"send2user",       OutputLib::luaSend2User},
 #ifdef __unittesting__
         {"ut_dictionary",   UT_Dictionary::luaCreate},
+        {"ut_proxy",        UT_EndpointProxy::luaCreate},
         {"ut_field",        UT_Field::luaCreate},
+        {"ut_runnerpool",   UT_FrameRunnerPool::luaCreate},
         {"ut_list",         UT_List::luaCreate},
         {"ut_msgq",         UT_MsgQ::luaCreate},
         {"ut_ordering",     UT_Ordering::luaCreate},
+        {"ut_record",       UT_RecordObject::luaCreate},
+        {"ut_arena",        UT_RequestArena::luaCreate},
         {"ut_string",       UT_String::luaCreate},
         {"ut_table",        UT_Table::luaCreate},
         {"ut_timelib",      UT_TimeLib::luaCreate},
@@ -258,11 +270,13 @@ void initcore (void)
     TimeLib::init();
     LuaEngine::init();
     GeoDataFrame::init();
+    FrameRunnerPool::init();
     RequestMetrics::init();
     CurlLib::init();
     OutputLib::init();
 #ifdef __unittesting__
     UT_TimeLib::init();
+    UT_RecordObject::init();
 #endif
 
     /* Register IO Drivers */
@@ -302,6 +316,7 @@ void deinitcore (void)
 {
     print2term("Exiting... ");
     CurlLib::deinit();
+    FrameRunnerPool::deinit();
     LuaEngine::deinit();
     EventLib::deinit();
     TimeLib::deinit();
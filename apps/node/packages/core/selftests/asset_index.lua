@@ -111,6 +111,36 @@ runner.unittest("Query Dataset with Sptial Index", function()
     check_query(r, { 1, 4, 7, 10, 13, 14, 17, 18, 21, 22, 25, 26, 29, 30, 33, 34, 37, 38, 41, 42, 45})
 end)
 
+runner.unittest("Save and Load Packed Index", function()
+    local a = core.getbyname("dataset1")
+    local filename = "/tmp/asset_index_test.idx"
+    local ii = core.intervalindex(a, "t0", "t1")
+    runner.assert(ii:save(filename))
+    local loaded = core.intervalindex(a, "t0", "t1")
+    runner.assert(loaded:load(filename))
+    local r = loaded:query({t0=5.0, t1=17.0})
+    check_query(r, { 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17})
+    local si = core.spatialindex(a, core.SOUTH_POLAR)
+    runner.assert(not si:load(filename), "loaded interval index into spatial index")
+    local other = core.intervalindex(core.getbyname("dataset2"), "t0", "t1")
+    runner.assert(not other:load(filename), "loaded index of another asset")
+    a:load("48", {t0=48,t1=48,lat0=-83.2,lat1=-80.1,lon0=45.0,lon1=46.0,hand=255.4,foot=98})
+    local stale = core.intervalindex(a, "t0", "t1")
+    runner.assert(not stale:load(filename), "loaded index of an updated asset")
+    os.remove(filename)
+end)
+
+runner.unittest("Pack Added Resources", function()
+    local a = core.getbyname("dataset1")
+    local f = core.pointindex(a, "foot")
+    local new_resource = {name="47",t0=47,t1=47,lat0=-83.2,lat1=-80.1,lon0=45.0,lon1=46.0,hand=255.4,foot=99}
+    a:load(new_resource["name"], new_resource)
+    f:add(new_resource)
+    runner.assert(f:pack())
+    local r = f:query({foot=99})
+    check_query(r, { 47 })
+end)
+
 -- Report Results --
 
 runner.report()
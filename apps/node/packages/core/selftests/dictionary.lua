@@ -16,6 +16,8 @@ runner.unittest("Dictionary Unit Test", function()
     runner.assert(ut:functional("small"))
     runner.assert(ut:functional("large"))
     runner.assert(ut:iterator("small"))
+    runner.assert(ut:lookup("small"))
+    runner.assert(ut:lookup("large"))
 end)
 
 -- Report Results --
@@ -0,0 +1,21 @@
+local runner = require("test_executive")
+
+-- Requirements --
+
+if not core.UNITTEST then
+    return runner.skip()
+end
+
+-- Self Test --
+
+runner.unittest("EndpointProxy Unit Test", function()
+    local ut_proxy = core.ut_proxy()
+    runner.assert(ut_proxy:threshold())
+    runner.assert(ut_proxy:hedge())
+    runner.assert(ut_proxy:abandon())
+    runner.assert(ut_proxy:retry())
+end)
+
+-- Report Results --
+
+runner.report()
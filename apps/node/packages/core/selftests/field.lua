@@ -15,6 +15,7 @@ runner.unittest("Field Unit Test", function()
     runner.assert(ut:enumeration())
     runner.assert(ut:list())
     runner.assert(ut:column())
+    runner.assert(ut:ragged())
     runner.assert(ut:dictionary())
 end)
 
@@ -0,0 +1,21 @@
+local runner = require("test_executive")
+
+-- Requirements --
+
+if not core.UNITTEST then
+    return runner.skip()
+end
+
+-- Self Test --
+
+runner.unittest("FrameRunnerPool Unit Test", function()
+    local ut = core.ut_runnerpool()
+    runner.assert(ut:steal())
+    runner.assert(ut:limit())
+    runner.assert(ut:inline())
+    runner.assert(ut:failure())
+end)
+
+-- Report Results --
+
+runner.report()
@@ -15,6 +15,9 @@ runner.unittest("Ordering Unit Test", function()
     runner.assert(ut_ordering:sort())
     runner.assert(ut_ordering:iterator())
     runner.assert(ut_ordering:assignment())
+    runner.assert(ut_ordering:bulkload())
+    runner.assert(ut_ordering:searchmodes())
+    runner.assert(ut_ordering:reuse())
 end)
 
 -- Report Results --
@@ -0,0 +1,19 @@
+local runner = require("test_executive")
+
+-- Requirements --
+
+if not core.UNITTEST then
+    return runner.skip()
+end
+
+-- Self Test --
+
+runner.unittest("RecordObject Unit Test", function()
+    local ut_record = core.ut_record()
+    runner.assert(ut_record:accessor())
+    runner.assert(ut_record:fieldpath())
+end)
+
+-- Report Results --
+
+runner.report()
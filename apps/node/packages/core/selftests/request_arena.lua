@@ -0,0 +1,20 @@
+local runner = require("test_executive")
+
+-- Requirements --
+
+if not core.UNITTEST then
+    return runner.skip()
+end
+
+-- Self Test --
+
+runner.unittest("RequestArena Unit Test", function()
+    local ut = core.ut_arena()
+    runner.assert(ut:allocate())
+    runner.assert(ut:release())
+    runner.assert(ut:column())
+end)
+
+-- Report Results --
+
+runner.report()
@@ -13,6 +13,7 @@ runner.unittest("Request Parameters Defaults", function()
     runner.assert(ptable["node_timeout"] == core.NODE_TIMEOUT)
     runner.assert(ptable["read_timeout"] == core.READ_TIMEOUT)
     runner.assert(ptable["cluster_size_hint"] == 0)
+    runner.assert(ptable["runner_concurrency"] == 0)
     runner.assert(ptable["points_in_polygon"] == 0)
     runner.assert(ptable["region_mask"]["rows"] == 0)
     runner.assert(ptable["region_mask"]["cols"] == 0)
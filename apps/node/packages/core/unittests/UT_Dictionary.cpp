@@ -48,6 +48,7 @@ const char* UT_Dictionary::LUA_META_NAME = "UT_Dictionary";
 const struct luaL_Reg UT_Dictionary::LUA_META_TABLE[] = {
     {"functional",  functionalUnitTestCmd},
     {"iterator",    iteratorUnitTestCmd},
+    {"lookup",      lookupUnitTestCmd},
     {"add_wordset", addWordSetCmd},
     {NULL,          NULL}
 };
@@ -420,6 +421,145 @@ int UT_Dictionary::iteratorUnitTestCmd (lua_State* L)
     return 1;
 }
 
+/*----------------------------------------------------------------------------
+ * lookupUnitTestCmd  -
+ *
+ *  exercises string_view and pre-hashed lookups, and churns adds and removes
+ *  so that deleted slots are reclaimed and probed past
+ *----------------------------------------------------------------------------*/
+int UT_Dictionary::lookupUnitTestCmd (lua_State* L)
+{
+    UT_Dictionary* lua_obj = NULL;
+    const char* wordset_name = NULL;
+    try
+    {
+        lua_obj = dynamic_cast<UT_Dictionary*>(getLuaSelf(L, 1));
+        wordset_name = getLuaString(L, 2);
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(CRITICAL, "Failed to get lua parameters: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    Dictionary<long> d1(16);
+
+    ut_initialize(lua_obj);
+
+    /* Get Word List */
+    vector<string>* wordlist_ptr;
+    try
+    {
+        wordlist_ptr = lua_obj->wordsets[wordset_name];
+        if(wordlist_ptr->empty())
+        {
+            ut_assert(lua_obj, false, "ERROR: word set %s is empty!\n", wordset_name);
+            lua_pushboolean(L, ut_status(lua_obj));
+            return 1;
+        }
+    }
+    catch(RunTimeException& e)
+    {
+        ut_assert(lua_obj, false, "ERROR: unable to locate word set %s: %s\n", wordset_name, e.what());
+        lua_pushboolean(L, ut_status(lua_obj));
+        return 1;
+    }
+
+    /* Get Word Set */
+    vector<string>& wordset = *wordlist_ptr;
+    const int numwords = static_cast<int>(wordset.size());
+
+    /* Set Entries */
+    for(int i = 0; i < numwords; i++)
+    {
+        if(!d1.add(wordset[i].c_str(), i))
+        {
+            ut_assert(lua_obj, false, "ERROR: failed to add %s\n", wordset[i].c_str());
+        }
+    }
+
+    /* Heterogeneous and Pre-Hashed Lookups */
+    for(int i = 0; i < numwords; i++)
+    {
+        long data = -1;
+        const std::string_view view(wordset[i]);
+        if(!d1.find(view, &data) || data != i)
+        {
+            ut_assert(lua_obj, false, "ERROR: failed to find %s by view, %ld != %d\n", wordset[i].c_str(), data, i);
+        }
+
+        const DictionaryKey key(wordset[i].c_str());
+        if(!d1.find(key, &data) || data != i || d1.get(key) != i)
+        {
+            ut_assert(lua_obj, false, "ERROR: failed to find %s by pre-hashed key, %ld != %d\n", wordset[i].c_str(), data, i);
+        }
+    }
+
+    /* Views Must Not Match on Prefix */
+    for(int i = 0; i < numwords; i++)
+    {
+        if(wordset[i].size() > 1)
+        {
+            const std::string_view prefix(wordset[i].c_str(), wordset[i].size() - 1);
+            long data = -1;
+            if(d1.find(prefix, &data) && StringLib::match(wordset[data].c_str(), wordset[i].c_str()))
+            {
+                ut_assert(lua_obj, false, "ERROR: prefix of %s matched the full word\n", wordset[i].c_str());
+            }
+        }
+    }
+
+    /* Churn - Remove Every Other Word and Add It Back */
+    for(int pass = 0; pass < 3; pass++)
+    {
+        for(int i = pass % 2; i < numwords; i += 2)
+        {
+            if(!d1.remove(wordset[i].c_str()))
+            {
+                ut_assert(lua_obj, false, "ERROR: failed to remove %s on pass %d\n", wordset[i].c_str(), pass);
+            }
+        }
+
+        for(int i = 0; i < numwords; i++)
+        {
+            const bool removed = (i % 2) == (pass % 2);
+            if(d1.find(wordset[i].c_str()) == removed)
+            {
+                ut_assert(lua_obj, false, "ERROR: %s was %s after removal on pass %d\n", wordset[i].c_str(), removed ? "found" : "not found", pass);
+            }
+        }
+
+        for(int i = pass % 2; i < numwords; i += 2)
+        {
+            if(!d1.add(wordset[i].c_str(), i, true))
+            {
+                ut_assert(lua_obj, false, "ERROR: failed to re-add %s on pass %d\n", wordset[i].c_str(), pass);
+            }
+        }
+    }
+
+    /* Check Copy */
+    const Dictionary<long> d2(d1);
+    for(int i = 0; i < numwords; i++)
+    {
+        long data = -1;
+        if(!d2.find(wordset[i].c_str(), &data) || data != i)
+        {
+            ut_assert(lua_obj, false, "ERROR: failed to find %s in copy, %ld != %d\n", wordset[i].c_str(), data, i);
+        }
+    }
+
+    /* Check Attributes */
+    print2term("Hash Size, Max Chain, Num Entries, %d, %d, %d\n", d1.getHashSize(), d1.getMaxChain(), d1.length());
+    ut_assert(lua_obj, d1.length() == numwords, "ERROR: incorrect number of entries %d != %d\n", d1.length(), numwords);
+    ut_assert(lua_obj, d2.length() == numwords, "ERROR: incorrect number of entries in copy %d != %d\n", d2.length(), numwords);
+
+    /* Return Status */
+    lua_pushboolean(L, ut_status(lua_obj));
+    return 1;
+}
+
 /*----------------------------------------------------------------------------
  * addWordSetCmd  -
  *----------------------------------------------------------------------------*/
@@ -74,6 +74,7 @@ class UT_Dictionary: public UnitTest
 
         static int  functionalUnitTestCmd   (lua_State* L);
         static int  iteratorUnitTestCmd     (lua_State* L);
+        static int  lookupUnitTestCmd       (lua_State* L);
         static int  addWordSetCmd           (lua_State* L);
         static int  luaTriangleTest         (lua_State* L);
 
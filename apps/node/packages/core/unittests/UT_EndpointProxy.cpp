@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "UT_EndpointProxy.h"
+#include "EndpointProxy.h"
+#include "CurlLib.h"
+#include "UnitTest.h"
+#include "OsApi.h"
+#include "EventLib.h"
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_EndpointProxy::LUA_META_NAME = "UT_EndpointProxy";
+const struct luaL_Reg UT_EndpointProxy::LUA_META_TABLE[] = {
+    {"threshold",   testThreshold},
+    {"hedge",       testHedge},
+    {"abandon",     testAbandon},
+    {"retry",       testRetry},
+    {NULL,          NULL}
+};
+
+static const char* UT_PROXY_QUEUE = "utproxyq";
+static const char* UT_DATA_REC_TYPE = EventLib::telemetryRecType; // stands in for any non-status record
+
+/******************************************************************************
+ * METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * luaCreate -
+ *----------------------------------------------------------------------------*/
+int UT_EndpointProxy::luaCreate (lua_State* L)
+{
+    try
+    {
+        /* Create Unit Test */
+        return createLuaObject(L, new UT_EndpointProxy(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_EndpointProxy::UT_EndpointProxy (lua_State* L):
+    UnitTest(L, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*--------------------------------------------------------------------------------------
+ * testThreshold
+ *--------------------------------------------------------------------------------------*/
+int UT_EndpointProxy::testThreshold(lua_State* L)
+{
+    UT_EndpointProxy* lua_obj = getSelf(L);
+    if(!lua_obj)
+    {
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    ut_initialize(lua_obj);
+
+    // durations 20.0 down to 1.0
+    vector<double> durations;
+    for(int i = 20; i > 0; i--) durations.push_back(static_cast<double>(i));
+
+    ut_assert(lua_obj, EndpointProxy::hedgeThreshold(durations, 0.95) == 20.0, "failed 95th percentile: %lf", EndpointProxy::hedgeThreshold(durations, 0.95));
+    ut_assert(lua_obj, EndpointProxy::hedgeThreshold(durations, 0.5) == 11.0, "failed 50th percentile: %lf", EndpointProxy::hedgeThreshold(durations, 0.5));
+    ut_assert(lua_obj, EndpointProxy::hedgeThreshold(durations, 0.0) == 1.0, "failed 0th percentile: %lf", EndpointProxy::hedgeThreshold(durations, 0.0));
+    ut_assert(lua_obj, EndpointProxy::hedgeThreshold(durations, 1.0) == 20.0, "failed 100th percentile: %lf", EndpointProxy::hedgeThreshold(durations, 1.0));
+
+    // single sample
+    const vector<double> single = {7.0};
+    ut_assert(lua_obj, EndpointProxy::hedgeThreshold(single, 0.95) == 7.0, "failed single sample: %lf", EndpointProxy::hedgeThreshold(single, 0.95));
+
+    // input left unsorted
+    ut_assert(lua_obj, durations[0] == 20.0, "durations modified: %lf", durations[0]);
+
+    lua_pushboolean(L, ut_status(lua_obj));
+    return 1;
+}
+
+/*--------------------------------------------------------------------------------------
+ * testHedge
+ *
+ *  the hedged request posts data first and claims the stream; the primary
+ *  request is aborted on its next data record and its status is dropped
+ *--------------------------------------------------------------------------------------*/
+int UT_EndpointProxy::testHedge(lua_State* L)
+{
+    UT_EndpointProxy* lua_obj = getSelf(L);
+    if(!lua_obj)
+    {
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    ut_initialize(lua_obj);
+
+    Publisher outq(UT_PROXY_QUEUE);
+    Subscriber inq(UT_PROXY_QUEUE);
+    CurlLib::stream_t stream;
+    CurlLib::parser_t primary;
+    CurlLib::parser_t hedge;
+    initParser(&primary, &outq, &stream, EndpointProxy::PRIMARY_ATTEMPT);
+    initParser(&hedge, &outq, &stream, EndpointProxy::HEDGED_ATTEMPT);
+
+    // primary status is held while the stream is unclaimed
+    ut_assert(lua_obj, feedRecord(&primary, EventLib::alertRecType), "failed to feed primary status");
+    ut_assert(lua_obj, primary.held.size() == 1, "failed to hold primary status: %ld", primary.held.size());
+    ut_assert(lua_obj, stream.owner.load() == CurlLib::STREAM_UNCLAIMED, "status record claimed stream: %d", stream.owner.load());
+
+    // hedge claims stream with data
+    ut_assert(lua_obj, feedRecord(&hedge, UT_DATA_REC_TYPE), "failed to feed hedge data");
+    ut_assert(lua_obj, stream.owner.load() == EndpointProxy::HEDGED_ATTEMPT, "hedge failed to claim stream: %d", stream.owner.load());
+
+    // primary aborted
+    ut_assert(lua_obj, !feedRecord(&primary, UT_DATA_REC_TYPE), "failed to abort primary");
+    CurlLib::finishStream(&primary, false);
+    CurlLib::finishStream(&hedge, true);
+    ut_assert(lua_obj, primary.held.empty(), "failed to drop primary status");
+
+    // attempt outcomes
+    ut_assert(lua_obj, EndpointProxy::checkAttempt(&stream, EndpointProxy::HEDGED_ATTEMPT, EndpointObject::OK) == EndpointProxy::ATTEMPT_VALID, "hedge not valid");
+    ut_assert(lua_obj, EndpointProxy::checkAttempt(&stream, EndpointProxy::PRIMARY_ATTEMPT, EndpointObject::OK) == EndpointProxy::ATTEMPT_LOST, "primary not lost on success");
+    ut_assert(lua_obj, EndpointProxy::checkAttempt(&stream, EndpointProxy::PRIMARY_ATTEMPT, EndpointObject::Internal_Server_Error) == EndpointProxy::ATTEMPT_LOST, "primary not lost on failure");
+
+    // only the hedge data reached the output stream
+    vector<string> rec_types;
+    drainRecords(&inq, rec_types);
+    ut_assert(lua_obj, rec_types.size() == 1, "unexpected number of records: %ld", rec_types.size());
+    ut_assert(lua_obj, !rec_types.empty() && rec_types[0] == UT_DATA_REC_TYPE, "unexpected record posted");
+    ut_assert(lua_obj, primary.err_cnt == 0 && hedge.err_cnt == 0, "post errors: %d, %d", primary.err_cnt, hedge.err_cnt);
+
+    lua_pushboolean(L, ut_status(lua_obj));
+    return 1;
+}
+
+/*--------------------------------------------------------------------------------------
+ * testAbandon
+ *
+ *  status records of the winner are posted ahead of its data, status records
+ *  of the abandoned request are never posted
+ *--------------------------------------------------------------------------------------*/
+int UT_EndpointProxy::testAbandon(lua_State* L)
+{
+    UT_EndpointProxy* lua_obj = getSelf(L);
+    if(!lua_obj)
+    {
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    ut_initialize(lua_obj);
+
+    Publisher outq(UT_PROXY_QUEUE);
+    Subscriber inq(UT_PROXY_QUEUE);
+    CurlLib::stream_t stream;
+    CurlLib::parser_t primary;
+    CurlLib::parser_t hedge;
+    initParser(&primary, &outq, &stream, EndpointProxy::PRIMARY_ATTEMPT);
+    initParser(&hedge, &outq, &stream, EndpointProxy::HEDGED_ATTEMPT);
+
+    // both requests report status
+    ut_assert(lua_obj, feedRecord(&primary, EventLib::alertRecType), "failed to feed primary status");
+    ut_assert(lua_obj, feedRecord(&primary, EventLib::logRecType), "failed to feed primary log");
+    ut_assert(lua_obj, feedRecord(&hedge, EventLib::alertRecType), "failed to feed hedge status");
+
+    // primary wins
+    ut_assert(lua_obj, feedRecord(&primary, UT_DATA_REC_TYPE), "failed to feed primary data");
+    ut_assert(lua_obj, feedRecord(&primary, EventLib::alertRecType), "failed to feed primary status after claim");
+
+    // hedge abandoned on its next record of any kind
+    ut_assert(lua_obj, !feedRecord(&hedge, EventLib::alertRecType), "failed to abandon hedge");
+    CurlLib::finishStream(&hedge, true); // success after losing does not claim stream
+    CurlLib::finishStream(&primary, true);
+    ut_assert(lua_obj, stream.owner.load() == EndpointProxy::PRIMARY_ATTEMPT, "ownership changed: %d", stream.owner.load());
+    ut_assert(lua_obj, EndpointProxy::checkAttempt(&stream, EndpointProxy::HEDGED_ATTEMPT, EndpointObject::OK) == EndpointProxy::ATTEMPT_LOST, "hedge not lost");
+
+    // primary status, log, data, status - in order and without duplicates
+    vector<string> rec_types;
+    drainRecords(&inq, rec_types);
+    ut_assert(lua_obj, rec_types.size() == 4, "unexpected number of records: %ld", rec_types.size());
+    if(rec_types.size() == 4)
+    {
+        ut_assert(lua_obj, rec_types[0] == EventLib::alertRecType, "unexpected first record: %s", rec_types[0].c_str());
+        ut_assert(lua_obj, rec_types[1] == EventLib::logRecType, "unexpected second record: %s", rec_types[1].c_str());
+        ut_assert(lua_obj, rec_types[2] == UT_DATA_REC_TYPE, "unexpected third record: %s", rec_types[2].c_str());
+        ut_assert(lua_obj, rec_types[3] == EventLib::alertRecType, "unexpected fourth record: %s", rec_types[3].c_str());
+    }
+
+    lua_pushboolean(L, ut_status(lua_obj));
+    return 1;
+}
+
+/*--------------------------------------------------------------------------------------
+ * testRetry
+ *
+ *  a request that claimed the stream and then failed is retried and its
+ *  retry keeps posting to the stream; a failed request that never claimed
+ *  the stream still reports its status
+ *--------------------------------------------------------------------------------------*/
+int UT_EndpointProxy::testRetry(lua_State* L)
+{
+    UT_EndpointProxy* lua_obj = getSelf(L);
+    if(!lua_obj)
+    {
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    ut_initialize(lua_obj);
+
+    Publisher outq(UT_PROXY_QUEUE);
+    Subscriber inq(UT_PROXY_QUEUE);
+    vector<string> rec_types;
+
+    // hedge takes over the stream and then fails
+    {
+        CurlLib::stream_t stream;
+        CurlLib::parser_t hedge;
+        initParser(&hedge, &outq, &stream, EndpointProxy::HEDGED_ATTEMPT);
+        ut_assert(lua_obj, feedRecord(&hedge, UT_DATA_REC_TYPE), "failed to feed hedge data");
+        CurlLib::finishStream(&hedge, false);
+        ut_assert(lua_obj, EndpointProxy::checkAttempt(&stream, EndpointProxy::HEDGED_ATTEMPT, EndpointObject::Internal_Server_Error) == EndpointProxy::ATTEMPT_FAILED, "owner not retried");
+
+        // retry of the hedge posts to the stream it owns
+        CurlLib::parser_t retry;
+        initParser(&retry, &outq, &stream, EndpointProxy::HEDGED_ATTEMPT);
+        ut_assert(lua_obj, feedRecord(&retry, EventLib::alertRecType), "failed to feed retry status");
+        ut_assert(lua_obj, feedRecord(&retry, UT_DATA_REC_TYPE), "failed to feed retry data");
+        CurlLib::finishStream(&retry, true);
+        ut_assert(lua_obj, EndpointProxy::checkAttempt(&stream, EndpointProxy::HEDGED_ATTEMPT, EndpointObject::OK) == EndpointProxy::ATTEMPT_VALID, "retry not valid");
+
+        drainRecords(&inq, rec_types);
+        ut_assert(lua_obj, rec_types.size() == 3, "unexpected number of records from retry: %ld", rec_types.size());
+    }
+
+    // request fails before the stream is claimed
+    {
+        rec_types.clear();
+        CurlLib::stream_t stream;
+        CurlLib::parser_t primary;
+        initParser(&primary, &outq, &stream, EndpointProxy::PRIMARY_ATTEMPT);
+        ut_assert(lua_obj, feedRecord(&primary, EventLib::alertRecType), "failed to feed primary status");
+        CurlLib::finishStream(&primary, false);
+        ut_assert(lua_obj, stream.owner.load() == CurlLib::STREAM_UNCLAIMED, "failure claimed stream: %d", stream.owner.load());
+        ut_assert(lua_obj, EndpointProxy::checkAttempt(&stream, EndpointProxy::PRIMARY_ATTEMPT, EndpointObject::Internal_Server_Error) == EndpointProxy::ATTEMPT_FAILED, "unclaimed not retried");
+
+        drainRecords(&inq, rec_types);
+        ut_assert(lua_obj, rec_types.size() == 1, "failed to release status of failed request: %ld", rec_types.size());
+    }
+
+    // stream not shared when hedging is disabled
+    ut_assert(lua_obj, EndpointProxy::checkAttempt(NULL, EndpointProxy::PRIMARY_ATTEMPT, EndpointObject::OK) == EndpointProxy::ATTEMPT_VALID, "unshared not valid");
+    ut_assert(lua_obj, EndpointProxy::checkAttempt(NULL, EndpointProxy::PRIMARY_ATTEMPT, EndpointObject::Internal_Server_Error) == EndpointProxy::ATTEMPT_FAILED, "unshared not retried");
+
+    lua_pushboolean(L, ut_status(lua_obj));
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * getSelf
+ *----------------------------------------------------------------------------*/
+UT_EndpointProxy* UT_EndpointProxy::getSelf (lua_State* L)
+{
+    try
+    {
+        return dynamic_cast<UT_EndpointProxy*>(getLuaSelf(L, 1));
+    }
+    catch(const RunTimeException& e)
+    {
+        print2term("Failed to get lua parameters: %s", e.what());
+        return NULL;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * initParser
+ *----------------------------------------------------------------------------*/
+void UT_EndpointProxy::initParser (CurlLib::parser_t* parser, Publisher* outq, CurlLib::stream_t* stream, int stream_id)
+{
+    memset(parser->hdr_buf, 0, sizeof(parser->hdr_buf));
+    parser->hdr_index = 0;
+    parser->rec_size = 0;
+    parser->rec_index = 0;
+    parser->err_cnt = 0;
+    parser->rec_buf = NULL;
+    parser->outq = outq;
+    parser->url = LUA_META_NAME;
+    parser->active = NULL;
+    parser->stream = stream;
+    parser->stream_id = stream_id;
+    parser->held.clear();
+}
+
+/*----------------------------------------------------------------------------
+ * feedRecord
+ *
+ *  passes a serialized record to the response parser as a response would;
+ *  returns false if the parser aborted the transfer
+ *----------------------------------------------------------------------------*/
+bool UT_EndpointProxy::feedRecord (CurlLib::parser_t* parser, const char* rec_type)
+{
+    RecordObject record(rec_type);
+    unsigned char* buffer = NULL;
+    const int size = record.serialize(&buffer, RecordObject::REFERENCE);
+    return CurlLib::postRecords(buffer, 1, size, parser) == static_cast<size_t>(size);
+}
+
+/*----------------------------------------------------------------------------
+ * drainRecords
+ *----------------------------------------------------------------------------*/
+void UT_EndpointProxy::drainRecords (Subscriber* inq, vector<string>& rec_types)
+{
+    Subscriber::msgRef_t ref;
+    while(inq->receiveRef(ref, IO_CHECK) > 0)
+    {
+        const unsigned char* buffer = reinterpret_cast<const unsigned char*>(ref.data);
+        const RecordObject::rec_hdr_t* rec_hdr = reinterpret_cast<const RecordObject::rec_hdr_t*>(buffer);
+        const uint16_t type_size = OsApi::swaps(rec_hdr->type_size);
+        rec_types.emplace_back(reinterpret_cast<const char*>(&buffer[sizeof(RecordObject::rec_hdr_t)]), type_size - 1);
+        inq->dereference(ref);
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ut_endpoint_proxy__
+#define __ut_endpoint_proxy__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "UnitTest.h"
+#include "CurlLib.h"
+#include "MsgQ.h"
+#include "RecordObject.h"
+
+/******************************************************************************
+ * CLASS
+ ******************************************************************************/
+
+class UT_EndpointProxy: public UnitTest
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const char* LUA_META_NAME;
+        static const struct luaL_Reg LUA_META_TABLE[];
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static int  luaCreate   (lua_State* L);
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+    explicit    UT_EndpointProxy    (lua_State* L);
+                ~UT_EndpointProxy   (void) override = default;
+
+	static int  testThreshold       (lua_State* L);
+	static int  testHedge           (lua_State* L);
+	static int  testAbandon         (lua_State* L);
+	static int  testRetry           (lua_State* L);
+
+	static UT_EndpointProxy* getSelf    (lua_State* L);
+	static void     initParser          (CurlLib::parser_t* parser, Publisher* outq, CurlLib::stream_t* stream, int stream_id);
+	static bool     feedRecord          (CurlLib::parser_t* parser, const char* rec_type);
+	static void     drainRecords        (Subscriber* inq, vector<string>& rec_types);
+};
+
+#endif  /* __ut_endpoint_proxy__ */
@@ -45,6 +45,8 @@
 #include "FieldEnumeration.h"
 #include "FieldList.h"
 #include "FieldColumn.h"
+#include "FieldRaggedColumn.h"
+#include "RequestArena.h"
 #include "FieldMap.h"
 
 /******************************************************************************
@@ -58,6 +60,7 @@ const struct luaL_Reg UT_Field::LUA_META_TABLE[] = {
     {"enumeration", testEnumeration},
     {"list",        testList},
     {"column",      testColumn},
+    {"ragged",      testRagged},
     {"dictionary",  testDictionary},
     {NULL,          NULL}
 };
@@ -332,6 +335,104 @@ int UT_Field::testColumn(lua_State* L)
         ut_assert(lua_obj, pdouble.append(1.1) == 1, "failed to append");
         ut_assert(lua_obj, pdouble.append(2.2) == 2, "failed to append");
 
+        // gather int column across chunk boundaries
+        FieldColumn<int64_t> pgather(0U, 4);
+        const int64_t selection[] = {7, 3, 9, 1, 5, 2, 8, 6, 4, 0};
+        ut_assert(lua_obj, pgather.append(-1) == 1, "failed to append");
+        ut_assert(lua_obj, pgather.appendEach(10, [&](long i){ return selection[i] * 10; }) == 11, "failed to append each");
+        ut_assert(lua_obj, pgather[0] == -1, "mismatched value at 0: %ld", pgather[0]);
+        for(long i = 0; i < 10; i++)
+        {
+            ut_assert(lua_obj, pgather[i + 1] == selection[i] * 10, "mismatched value at %ld: %ld", i + 1, pgather[i + 1]);
+        }
+
+        // return status
+        lua_pushboolean(L, ut_status(lua_obj));
+        return 1;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(CRITICAL, "Failed to get lua parameters: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+}
+
+/*--------------------------------------------------------------------------------------
+ * testRagged
+ *--------------------------------------------------------------------------------------*/
+int UT_Field::testRagged(lua_State* L)
+{
+    UT_Field* lua_obj = NULL;
+    try
+    {
+        // initialize test
+        lua_obj = dynamic_cast<UT_Field*>(getLuaSelf(L, 1));
+        ut_initialize(lua_obj);
+
+        FieldRaggedColumn<float> pragged;
+        const float waveform[] = {1.0, 2.0, 3.0, 4.0, 5.0};
+
+        // populate ragged column
+        ut_assert(lua_obj, pragged.appendList(waveform, 3) == 1, "failed to append");
+        ut_assert(lua_obj, pragged.appendList(waveform, 0) == 2, "failed to append");
+        ut_assert(lua_obj, pragged.appendList(&waveform[3], 2, 4, 0.0) == 3, "failed to append");
+        FieldList<float> list;
+        list.append(6.0);
+        ut_assert(lua_obj, pragged.append(list) == 4, "failed to append");
+
+        // check layout
+        ut_assert(lua_obj, pragged.encoding == (Field::NESTED_LIST | Field::FLOAT), "incorrect encoding: %X", pragged.encoding);
+        ut_assert(lua_obj, pragged.numValues() == 8, "incorrect number of values: %ld", pragged.numValues());
+        ut_assert(lua_obj, pragged.rowLength(1) == 0, "incorrect row length: %ld", pragged.rowLength(1));
+        ut_assert(lua_obj, pragged.rowLength(2) == 4, "incorrect row length: %ld", pragged.rowLength(2));
+        ut_assert(lua_obj, pragged.rowData(2)[1] == 5.0, "incorrect value: %f", pragged.rowData(2)[1]);
+        ut_assert(lua_obj, pragged.rowData(2)[3] == 0.0, "incorrect padding: %f", pragged.rowData(2)[3]);
+
+        // round trip through serialized layout
+        uint8_t buffer[(sizeof(uint32_t) * 4) + (sizeof(float) * 8)];
+        ut_assert(lua_obj, pragged.serialize(buffer, sizeof(buffer)) == sizeof(buffer), "failed to serialize");
+        FieldRaggedColumn<float> pcopy;
+        ut_assert(lua_obj, pcopy.appendBuffer(buffer, 4) == 4, "failed to deserialize");
+        ut_assert(lua_obj, pcopy.toJson() == pragged.toJson(), "mismatched json: %s", pcopy.toJson().c_str());
+
+        // append serialized rows onto existing rows
+        ut_assert(lua_obj, pcopy.appendBuffer(buffer, 4) == 8, "failed to append buffer");
+        ut_assert(lua_obj, pcopy.numValues() == 16, "incorrect number of values after append: %ld", pcopy.numValues());
+        for(long i = 0; i < 4; i++)
+        {
+            ut_assert(lua_obj, pcopy.rowLength(i + 4) == pragged.rowLength(i), "mismatched row length at %ld", i);
+            ut_assert(lua_obj, pragged.rowLength(i) == 0 || memcmp(pcopy.rowData(i + 4), pragged.rowData(i), pragged.rowLength(i) * sizeof(float)) == 0, "mismatched row at %ld", i);
+        }
+
+        // filter rows
+        const vector<uint8_t> mask = {0, 1, 1, 0};
+        ut_assert(lua_obj, pragged.filter(mask) == 2, "failed to filter");
+        ut_assert(lua_obj, pragged.numValues() == 4, "incorrect number of values after filter: %ld", pragged.numValues());
+        ut_assert(lua_obj, pragged.toJson() == "[[],[4.000000,5.000000,0.000000,0.000000]]", "incorrect json: %s", pragged.toJson().c_str());
+        ut_assert(lua_obj, pragged.appendList(waveform, 2) == 3, "failed to append after filter");
+        ut_assert(lua_obj, pragged.toJson() == "[[],[4.000000,5.000000,0.000000,0.000000],[1.000000,2.000000]]", "incorrect json after append: %s", pragged.toJson().c_str());
+
+        // filter keeping first and last rows, then all rows, then no rows
+        const vector<uint8_t> ends = {1, 0, 0, 0, 0, 0, 0, 1};
+        ut_assert(lua_obj, pcopy.filter(ends) == 2, "failed to filter ends");
+        ut_assert(lua_obj, pcopy.toJson() == "[[1.000000,2.000000,3.000000],[6.000000]]", "incorrect json after filtering ends: %s", pcopy.toJson().c_str());
+        ut_assert(lua_obj, pcopy.filter({1, 1}) == 2 && pcopy.numValues() == 4, "failed to keep all rows");
+        ut_assert(lua_obj, pcopy.filter({0, 0}) == 0 && pcopy.numValues() == 0, "failed to drop all rows");
+        ut_assert(lua_obj, pcopy.appendList(waveform, 1) == 1 && pcopy.toJson() == "[[1.000000]]", "failed to append to emptied column");
+
+        // values come from the request arena when one is bound
+        const shared_ptr<RequestArena> arena = make_shared<RequestArena>("ut_ragged");
+        {
+            const RequestArena::Scope scope(arena);
+            FieldRaggedColumn<float> parena;
+            for(int i = 0; i < 100; i++) parena.appendList(waveform, 5);
+            ut_assert(lua_obj, arena->usedBytes() >= (500 * sizeof(float)) + (101 * sizeof(int32_t)), "ragged column not allocated from arena: %ld", static_cast<long>(arena->usedBytes()));
+            vector<uint8_t> odd(100);
+            for(int i = 0; i < 100; i++) odd[i] = i % 2;
+            ut_assert(lua_obj, parena.filter(odd) == 50 && parena.rowData(49)[4] == 5.0, "failed to filter arena column");
+        }
+
         // return status
         lua_pushboolean(L, ut_status(lua_obj));
         return 1;
@@ -73,6 +73,7 @@ class UT_Field: public UnitTest
 	static int  testEnumeration (lua_State* L);
 	static int  testList        (lua_State* L);
 	static int  testColumn      (lua_State* L);
+	static int  testRagged      (lua_State* L);
 	static int  testDictionary  (lua_State* L);
 };
 
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <atomic>
+#include <stdexcept>
+
+#include "UT_FrameRunnerPool.h"
+#include "UnitTest.h"
+#include "OsApi.h"
+#include "EventLib.h"
+#include "FrameRunnerPool.h"
+
+/******************************************************************************
+ * LOCAL TYPES
+ ******************************************************************************/
+
+typedef struct {
+    std::atomic<int>*   executed;       // times each item was run
+    long                slow_items;     // items below this take a millisecond each
+    std::atomic<int>    inflight;       // participants inside the function
+    std::atomic<int>    max_inflight;
+    long                caller;         // thread that submitted the job
+    std::atomic<long>   foreign;        // items run by any other thread
+    long                fail_item;      // item that throws
+    int                 fail_kind;      // 0: RunTimeException, 1: std::exception, 2: other
+} ut_job_t;
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * runItems
+ *----------------------------------------------------------------------------*/
+static void runItems (void* context, long start, long count)
+{
+    ut_job_t* job = static_cast<ut_job_t*>(context);
+
+    const int inflight = ++job->inflight;
+    int prev_max = job->max_inflight.load();
+    while(inflight > prev_max && !job->max_inflight.compare_exchange_weak(prev_max, inflight)) {}
+    if(Thread::getId() != job->caller) job->foreign += count;
+
+    for(long i = start; i < start + count; i++)
+    {
+        job->executed[i]++;
+        if(i < job->slow_items) OsApi::sleep(0.001);
+        if(i == job->fail_item)
+        {
+            job->inflight--;
+            if(job->fail_kind == 0) throw RunTimeException(CRITICAL, RTE_FAILURE, "failing item %ld", i);
+            if(job->fail_kind == 1) throw std::runtime_error("failing item");
+            throw job->fail_kind;
+        }
+    }
+
+    job->inflight--;
+}
+
+/*----------------------------------------------------------------------------
+ * initJob
+ *----------------------------------------------------------------------------*/
+static void initJob (ut_job_t& job, std::atomic<int>* executed, long num_items)
+{
+    for(long i = 0; i < num_items; i++) executed[i] = 0;
+    job.executed = executed;
+    job.slow_items = 0;
+    job.inflight = 0;
+    job.max_inflight = 0;
+    job.caller = Thread::getId();
+    job.foreign = 0;
+    job.fail_item = -1;
+    job.fail_kind = 0;
+}
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_FrameRunnerPool::LUA_META_NAME = "UT_FrameRunnerPool";
+const struct luaL_Reg UT_FrameRunnerPool::LUA_META_TABLE[] = {
+    {"steal",       testSteal},
+    {"limit",       testLimit},
+    {"inline",      testInline},
+    {"failure",     testFailure},
+    {NULL,          NULL}
+};
+
+/******************************************************************************
+ * METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * luaCreate -
+ *----------------------------------------------------------------------------*/
+int UT_FrameRunnerPool::luaCreate (lua_State* L)
+{
+    try
+    {
+        /* Create Unit Test */
+        return createLuaObject(L, new UT_FrameRunnerPool(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_FrameRunnerPool::UT_FrameRunnerPool (lua_State* L):
+    UnitTest(L, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*--------------------------------------------------------------------------------------
+ * testSteal
+ *--------------------------------------------------------------------------------------*/
+int UT_FrameRunnerPool::testSteal(lua_State* L)
+{
+    UT_FrameRunnerPool* lua_obj = NULL;
+    try
+    {
+        // initialize test
+        lua_obj = dynamic_cast<UT_FrameRunnerPool*>(getLuaSelf(L, 1));
+        ut_initialize(lua_obj);
+
+        // the first items are slow so the participant given them falls behind
+        const long num_items = 1000;
+        std::atomic<int> executed[num_items];
+        ut_job_t job;
+        initJob(job, executed, num_items);
+        job.slow_items = 100;
+
+        FrameRunnerPool::Client client;
+        const FrameRunnerPool::stats_t before = FrameRunnerPool::getStats();
+        ut_assert(lua_obj, client.run(runItems, &job, num_items, 1), "failed to run job");
+        const FrameRunnerPool::stats_t after = FrameRunnerPool::getStats();
+
+        // every item runs exactly once
+        for(long i = 0; i < num_items; i++)
+        {
+            ut_assert(lua_obj, executed[i] == 1, "item %ld executed %d times", i, executed[i].load());
+        }
+        ut_assert(lua_obj, after.tasks - before.tasks >= num_items, "missing tasks: %ld", after.tasks - before.tasks);
+
+        // idle participants take over the slow range
+        if(after.workers > 0)
+        {
+            ut_assert(lua_obj, after.steals > before.steals, "no ranges stolen");
+            ut_assert(lua_obj, job.foreign > 0, "no items run by workers");
+        }
+
+        // return status
+        lua_pushboolean(L, ut_status(lua_obj));
+        return 1;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Failed to run test: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+}
+
+/*--------------------------------------------------------------------------------------
+ * testLimit
+ *--------------------------------------------------------------------------------------*/
+int UT_FrameRunnerPool::testLimit(lua_State* L)
+{
+    UT_FrameRunnerPool* lua_obj = NULL;
+    try
+    {
+        // initialize test
+        lua_obj = dynamic_cast<UT_FrameRunnerPool*>(getLuaSelf(L, 1));
+        ut_initialize(lua_obj);
+
+        const long num_items = 64;
+        std::atomic<int> executed[num_items];
+        ut_job_t job;
+
+        // no more than the limit participate, submitting thread included
+        initJob(job, executed, num_items);
+        job.slow_items = num_items;
+        FrameRunnerPool::Client client(2);
+        ut_assert(lua_obj, client.run(runItems, &job, num_items, 1), "failed to run limited job");
+        ut_assert(lua_obj, job.max_inflight <= 2, "limit exceeded: %d participants", job.max_inflight.load());
+        for(long i = 0; i < num_items; i++) ut_assert(lua_obj, executed[i] == 1, "item %ld executed %d times", i, executed[i].load());
+
+        // a limit of one runs the job on the submitting thread
+        initJob(job, executed, num_items);
+        client.setLimit(1);
+        const FrameRunnerPool::stats_t before = FrameRunnerPool::getStats();
+        ut_assert(lua_obj, client.run(runItems, &job, num_items, 4), "failed to run job limited to one");
+        const FrameRunnerPool::stats_t after = FrameRunnerPool::getStats();
+        ut_assert(lua_obj, job.max_inflight == 1, "limit exceeded: %d participants", job.max_inflight.load());
+        ut_assert(lua_obj, job.foreign == 0, "items run off the submitting thread: %ld", job.foreign.load());
+        ut_assert(lua_obj, after.inlined == before.inlined + 1, "job not inlined");
+
+        // return status
+        lua_pushboolean(L, ut_status(lua_obj));
+        return 1;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Failed to run test: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+}
+
+/*--------------------------------------------------------------------------------------
+ * testInline
+ *
+ *  stops the workers for the duration of the test; they restart on the next
+ *  job once the pool is reinitialized
+ *--------------------------------------------------------------------------------------*/
+int UT_FrameRunnerPool::testInline(lua_State* L)
+{
+    UT_FrameRunnerPool* lua_obj = NULL;
+    try
+    {
+        // initialize test
+        lua_obj = dynamic_cast<UT_FrameRunnerPool*>(getLuaSelf(L, 1));
+        ut_initialize(lua_obj);
+
+        const long num_items = 256;
+        std::atomic<int> executed[num_items];
+        ut_job_t job;
+        initJob(job, executed, num_items);
+
+        // with no workers the submitting thread runs every item
+        FrameRunnerPool::deinit();
+        FrameRunnerPool::Client client;
+        const FrameRunnerPool::stats_t before = FrameRunnerPool::getStats();
+        const bool status = client.run(runItems, &job, num_items, 8);
+        const FrameRunnerPool::stats_t after = FrameRunnerPool::getStats();
+        FrameRunnerPool::init();
+
+        ut_assert(lua_obj, status, "failed to run job without workers");
+        ut_assert(lua_obj, after.workers == 0, "workers started while inactive: %ld", after.workers);
+        ut_assert(lua_obj, after.inlined == before.inlined + 1, "job not inlined");
+        ut_assert(lua_obj, after.tasks - before.tasks == num_items / 8, "incorrect number of tasks: %ld", after.tasks - before.tasks);
+        ut_assert(lua_obj, job.foreign == 0, "items run off the submitting thread: %ld", job.foreign.load());
+        for(long i = 0; i < num_items; i++) ut_assert(lua_obj, executed[i] == 1, "item %ld executed %d times", i, executed[i].load());
+
+        // workers come back once the pool is active again
+        initJob(job, executed, num_items);
+        ut_assert(lua_obj, client.run(runItems, &job, num_items, 1), "failed to run job after restart");
+        ut_assert(lua_obj, FrameRunnerPool::getStats().workers > 0, "workers not restarted");
+
+        // return status
+        lua_pushboolean(L, ut_status(lua_obj));
+        return 1;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Failed to run test: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+}
+
+/*--------------------------------------------------------------------------------------
+ * testFailure
+ *--------------------------------------------------------------------------------------*/
+int UT_FrameRunnerPool::testFailure(lua_State* L)
+{
+    UT_FrameRunnerPool* lua_obj = NULL;
+    try
+    {
+        // initialize test
+        lua_obj = dynamic_cast<UT_FrameRunnerPool*>(getLuaSelf(L, 1));
+        ut_initialize(lua_obj);
+
+        const long num_items = 500;
+        std::atomic<int> executed[num_items];
+        ut_job_t job;
+        FrameRunnerPool::Client client;
+
+        // any exception thrown by a range fails the job, and the job still completes
+        for(int kind = 0; kind < 3; kind++)
+        {
+            initJob(job, executed, num_items);
+            job.fail_item = 250;
+            job.fail_kind = kind;
+            ut_assert(lua_obj, !client.run(runItems, &job, num_items, 1), "failure of kind %d not reported", kind);
+            ut_assert(lua_obj, job.inflight == 0, "participants still running after failure of kind %d", kind);
+            for(long i = 0; i < num_items; i++)
+            {
+                ut_assert(lua_obj, executed[i] <= 1, "item %ld executed %d times", i, executed[i].load());
+            }
+        }
+
+        // the client is usable after a failure
+        initJob(job, executed, num_items);
+        ut_assert(lua_obj, client.run(runItems, &job, num_items, 1), "failed to run job after failure");
+
+        // return status
+        lua_pushboolean(L, ut_status(lua_obj));
+        return 1;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Failed to run test: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+}
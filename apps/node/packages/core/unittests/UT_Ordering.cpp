@@ -50,6 +50,9 @@ const struct luaL_Reg UT_Ordering::LUA_META_TABLE[] = {
     {"sort",        testSort},
     {"iterator",    testIterator},
     {"assignment",  testAssignment},
+    {"bulkload",    testBulkLoad},
+    {"searchmodes", testSearchModes},
+    {"reuse",       testReuse},
     {NULL,          NULL}
 };
 
@@ -343,3 +346,212 @@ int UT_Ordering::testAssignment(lua_State* L)
     lua_pushboolean(L, ut_status(lua_obj));
     return 1;
 }
+
+/*--------------------------------------------------------------------------------------
+ * testBulkLoad
+ *--------------------------------------------------------------------------------------*/
+int UT_Ordering::testBulkLoad(lua_State* L)
+{
+    UT_Ordering* lua_obj = NULL;
+    try
+    {
+        lua_obj = dynamic_cast<UT_Ordering*>(getLuaSelf(L, 1));
+    }
+    catch(const RunTimeException& e)
+    {
+        print2term("Failed to get lua parameters: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    ut_initialize(lua_obj);
+
+    // build unsorted input large enough to span many blocks, with duplicate keys
+    const long num_entries = 1000000;
+    long* keys = new long [num_entries];
+    long* data = new long [num_entries];
+    unsigned long seed = 0x5EED;
+    for(long i = 0; i < num_entries; i++)
+    {
+        seed = (seed * 6364136223846793005UL) + 1442695040888963407UL;
+        keys[i] = static_cast<long>((seed >> 33) % (num_entries / 2));
+        data[i] = i;
+    }
+
+    // bulk load and sequentially add the same input
+    Ordering<long,long> loaded;
+    loaded.load(keys, data, num_entries);
+    Ordering<long,long> added;
+    for(long i = 0; i < num_entries; i++) added.add(keys[i], data[i]);
+
+    // check both orderings hold the same entries in the same order
+    ut_assert(lua_obj, loaded.length() == num_entries, "failed length check %ld\n", loaded.length());
+    ut_assert(lua_obj, added.length() == num_entries, "failed length check %ld\n", added.length());
+    long loaded_data = 0;
+    long added_data = 0;
+    long loaded_key = loaded.first(&loaded_data);
+    long added_key = added.first(&added_data);
+    long prev_key = loaded_key;
+    long count = 0;
+    while(loaded_key != (long)INVALID_KEY && count < num_entries)
+    {
+        if(loaded_key != added_key || loaded_data != added_data || loaded_key < prev_key)
+        {
+            ut_assert(lua_obj, false, "mismatch at entry %ld: %ld/%ld vs %ld/%ld\n", count, loaded_key, loaded_data, added_key, added_data);
+            break;
+        }
+        prev_key = loaded_key;
+        loaded_key = loaded.next(&loaded_data);
+        added_key = added.next(&added_data);
+        count++;
+    }
+    ut_assert(lua_obj, count == num_entries, "failed to iterate all entries %ld\n", count);
+
+    // remove even keys and check lookups only resolve to odd keys
+    for(long k = 0; k < num_entries / 2; k += 2)
+    {
+        while(loaded.remove(k)) {}
+    }
+    for(long k = 1; k < num_entries / 2; k += 2)
+    {
+        try
+        {
+            const long v = loaded.get(k, Ordering<long,long>::GREATER_THAN_OR_EQUAL);
+            ut_assert(lua_obj, keys[v] >= k && (keys[v] % 2) == 1, "failed to find key %ld: %ld\n", k, keys[v]);
+        }
+        catch(const RunTimeException& e)
+        {
+            // no remaining key at or above k
+            (void)e;
+        }
+    }
+
+    delete [] keys;
+    delete [] data;
+
+    lua_pushboolean(L, ut_status(lua_obj));
+    return 1;
+}
+
+/*--------------------------------------------------------------------------------------
+ * testSearchModes
+ *--------------------------------------------------------------------------------------*/
+int UT_Ordering::testSearchModes(lua_State* L)
+{
+    UT_Ordering* lua_obj = NULL;
+    try
+    {
+        lua_obj = dynamic_cast<UT_Ordering*>(getLuaSelf(L, 1));
+    }
+    catch(const RunTimeException& e)
+    {
+        print2term("Failed to get lua parameters: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    ut_initialize(lua_obj);
+
+    // even keys from 0 to 998
+    Ordering<int,int> mylist;
+    for(int i = 0; i < 500; i++) mylist.add(i * 2, i * 2);
+
+    // check each search mode against odd and even keys
+    for(int k = 1; k < 997; k += 2)
+    {
+        ut_assert(lua_obj, mylist.get(k, Ordering<int,int>::GREATER_THAN_OR_EQUAL) == k + 1, "failed gte %d\n", k);
+        ut_assert(lua_obj, mylist.get(k, Ordering<int,int>::LESS_THAN_OR_EQUAL) == k - 1, "failed lte %d\n", k);
+        ut_assert(lua_obj, mylist.get(k + 1, Ordering<int,int>::GREATER_THAN) == k + 3, "failed gt %d\n", k + 1);
+        ut_assert(lua_obj, mylist.get(k + 1, Ordering<int,int>::LESS_THAN) == k - 1, "failed lt %d\n", k + 1);
+    }
+
+    // check iterating backwards
+    int data = 0;
+    int key = mylist.last(&data);
+    for(int i = 499; i >= 0; i--)
+    {
+        ut_assert(lua_obj, key == i * 2 && data == i * 2, "failed to iterate backwards %d: %d\n", i * 2, key);
+        key = mylist.prev(&data);
+    }
+    ut_assert(lua_obj, key == (int)INVALID_KEY, "failed to stop at beginning\n");
+
+    // check out of range lookups fail
+    bool caught = false;
+    try
+    {
+        mylist.get(0, Ordering<int,int>::LESS_THAN);
+    }
+    catch(const RunTimeException& e)
+    {
+        (void)e;
+        caught = true;
+    }
+    ut_assert(lua_obj, caught, "failed to reject key below range\n");
+
+    lua_pushboolean(L, ut_status(lua_obj));
+    return 1;
+}
+
+/*--------------------------------------------------------------------------------------
+ * testReuse
+ *--------------------------------------------------------------------------------------*/
+int UT_Ordering::testReuse(lua_State* L)
+{
+    UT_Ordering* lua_obj = NULL;
+    try
+    {
+        lua_obj = dynamic_cast<UT_Ordering*>(getLuaSelf(L, 1));
+    }
+    catch(const RunTimeException& e)
+    {
+        print2term("Failed to get lua parameters: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    ut_initialize(lua_obj);
+
+    // repeatedly empty and refill a single key
+    Ordering<int,int> mylist;
+    int data = 0;
+    for(int i = 0; i < 100; i++)
+    {
+        ut_assert(lua_obj, mylist.add(i, i * 10), "failed to add %d\n", i);
+        ut_assert(lua_obj, !mylist.add(i, 0, true), "failed to reject duplicate %d\n", i);
+        ut_assert(lua_obj, mylist.get(i) == i * 10, "failed to get %d\n", i);
+        ut_assert(lua_obj, mylist.remove(i), "failed to remove %d\n", i);
+        ut_assert(lua_obj, mylist.empty(), "failed to empty list at %d\n", i);
+    }
+
+    // an emptied list behaves like a new one
+    ut_assert(lua_obj, mylist.first(&data) == (int)INVALID_KEY, "failed to find no first entry\n");
+    ut_assert(lua_obj, mylist.last(&data) == (int)INVALID_KEY, "failed to find no last entry\n");
+    ut_assert(lua_obj, mylist.prev(&data) == (int)INVALID_KEY, "failed to find no previous entry\n");
+    ut_assert(lua_obj, !mylist.remove(0, Ordering<int,int>::GREATER_THAN_OR_EQUAL), "failed to reject gte on empty list\n");
+    ut_assert(lua_obj, !mylist.remove(0, Ordering<int,int>::LESS_THAN_OR_EQUAL), "failed to reject lte on empty list\n");
+    ut_assert(lua_obj, !mylist.remove(0, Ordering<int,int>::GREATER_THAN), "failed to reject gt on empty list\n");
+    ut_assert(lua_obj, !mylist.remove(0, Ordering<int,int>::LESS_THAN), "failed to reject lt on empty list\n");
+    const Ordering<int,int>::Iterator empty_iter(mylist);
+    ut_assert(lua_obj, empty_iter.length == 0, "failed to iterate empty list: %d\n", empty_iter.length);
+
+    // refill past a single block and drain it again
+    for(int i = 0; i < 1000; i++) mylist.add(999 - i, 999 - i);
+    ut_assert(lua_obj, mylist.length() == 1000, "failed to refill list: %ld\n", mylist.length());
+    int key = mylist.first(&data);
+    for(int i = 0; i < 1000; i++)
+    {
+        ut_assert(lua_obj, key == i && data == i, "failed to iterate refilled list %d: %d\n", i, key);
+        key = mylist.next(&data);
+    }
+    for(int i = 0; i < 1000; i++) mylist.remove(i);
+    ut_assert(lua_obj, mylist.empty() && mylist.first(NULL) == (int)INVALID_KEY, "failed to drain list\n");
+    ut_assert(lua_obj, mylist.add(5, 50) && mylist.last(&data) == 5 && data == 50, "failed to reuse drained list\n");
+
+    // max list size still trims on the single block path
+    Ordering<int,int> shortlist(NULL, NULL, 4);
+    for(int i = 0; i < 10; i++) shortlist.add(i, i);
+    ut_assert(lua_obj, shortlist.length() == 4 && shortlist.first(&data) == 6, "failed to trim list: %ld\n", shortlist.length());
+
+    lua_pushboolean(L, ut_status(lua_obj));
+    return 1;
+}
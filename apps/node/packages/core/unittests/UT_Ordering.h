@@ -73,6 +73,9 @@ class UT_Ordering: public UnitTest
 	static int  testSort        (lua_State* L);
 	static int  testIterator    (lua_State* L);
 	static int  testAssignment  (lua_State* L);
+	static int  testBulkLoad    (lua_State* L);
+	static int  testSearchModes (lua_State* L);
+	static int  testReuse       (lua_State* L);
 };
 
 #endif  /* __ut_ordering__ */
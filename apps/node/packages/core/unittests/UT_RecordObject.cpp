@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <cstddef>
+
+#include "UT_RecordObject.h"
+#include "RecordObject.h"
+#include "UnitTest.h"
+#include "OsApi.h"
+#include "EventLib.h"
+
+/******************************************************************************
+ * LOCAL DATA
+ ******************************************************************************/
+
+/* ATL06 Elevation Measurement (mirrors Atl06Dispatch::elevation_t) */
+typedef struct {
+    uint64_t            extent_id;
+    uint32_t            segment_id;
+    int32_t             photon_count;
+    uint16_t            pflags;
+    uint16_t            rgt;
+    uint8_t             cycle;
+    uint8_t             region;
+    uint8_t             spot;
+    uint8_t             gt;
+    int64_t             time_ns;
+    double              latitude;
+    double              longitude;
+    double              h_mean;
+    float               dh_fit_dx;
+    float               x_atc;
+    float               y_atc;
+    float               window_height;
+    float               rms_misfit;
+    float               h_sigma;
+} ut_elevation_t;
+
+static const char* elRecType = "ut_elevation";
+static const RecordObject::fieldDef_t elRecDef[] = {
+    {"extent_id",   RecordObject::UINT64,   offsetof(ut_elevation_t, extent_id),    1,  NULL, NATIVE_FLAGS | RecordObject::INDEX,   NULL},
+    {"segment_id",  RecordObject::UINT32,   offsetof(ut_elevation_t, segment_id),   1,  NULL, NATIVE_FLAGS,                         NULL},
+    {"n_fit_photons",RecordObject::INT32,   offsetof(ut_elevation_t, photon_count), 1,  NULL, NATIVE_FLAGS,                         NULL},
+    {"rgt",         RecordObject::UINT16,   offsetof(ut_elevation_t, rgt),          1,  NULL, NATIVE_FLAGS,                         NULL},
+    {"cycle",       RecordObject::UINT8,    offsetof(ut_elevation_t, cycle),        1,  NULL, NATIVE_FLAGS,                         NULL},
+    {"time",        RecordObject::TIME8,    offsetof(ut_elevation_t, time_ns),      1,  NULL, NATIVE_FLAGS | RecordObject::TIME,    NULL},
+    {"latitude",    RecordObject::DOUBLE,   offsetof(ut_elevation_t, latitude),     1,  NULL, NATIVE_FLAGS | RecordObject::Y_COORD, NULL},
+    {"longitude",   RecordObject::DOUBLE,   offsetof(ut_elevation_t, longitude),    1,  NULL, NATIVE_FLAGS | RecordObject::X_COORD, NULL},
+    {"h_mean",      RecordObject::DOUBLE,   offsetof(ut_elevation_t, h_mean),       1,  NULL, NATIVE_FLAGS | RecordObject::Z_COORD, NULL},
+    {"x_atc",       RecordObject::FLOAT,    offsetof(ut_elevation_t, x_atc),        1,  NULL, NATIVE_FLAGS,                         NULL},
+    {"h_sigma",     RecordObject::FLOAT,    offsetof(ut_elevation_t, h_sigma),      1,  NULL, NATIVE_FLAGS,                         NULL}
+};
+
+/* Big Endian Record */
+typedef struct {
+    uint16_t            be16;
+    uint32_t            be32;
+    int64_t             be64;
+    double              bedbl;
+    uint16_t            values[4];
+} ut_swapped_t;
+
+static const char* swRecType = "ut_swapped";
+static const RecordObject::fieldDef_t swRecDef[] = {
+    {"be16",        RecordObject::UINT16,   offsetof(ut_swapped_t, be16),           1,  NULL, RecordObject::BIGENDIAN,              NULL},
+    {"be32",        RecordObject::UINT32,   offsetof(ut_swapped_t, be32),           1,  NULL, RecordObject::BIGENDIAN,              NULL},
+    {"be64",        RecordObject::INT64,    offsetof(ut_swapped_t, be64),           1,  NULL, RecordObject::BIGENDIAN,              NULL},
+    {"bedbl",       RecordObject::DOUBLE,   offsetof(ut_swapped_t, bedbl),          1,  NULL, RecordObject::BIGENDIAN,              NULL},
+    {"values",      RecordObject::UINT16,   offsetof(ut_swapped_t, values),         4,  NULL, NATIVE_FLAGS,                         NULL}
+};
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_RecordObject::LUA_META_NAME = "UT_RecordObject";
+const struct luaL_Reg UT_RecordObject::LUA_META_TABLE[] = {
+    {"accessor",    testAccessor},
+    {"fieldpath",   testFieldPath},
+    {NULL,          NULL}
+};
+
+/******************************************************************************
+ * METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * init
+ *----------------------------------------------------------------------------*/
+void UT_RecordObject::init (void)
+{
+    RECDEF(elRecType, elRecDef, sizeof(ut_elevation_t), NULL);
+    RECDEF(swRecType, swRecDef, sizeof(ut_swapped_t), NULL);
+}
+
+/*----------------------------------------------------------------------------
+ * luaCreate -
+ *----------------------------------------------------------------------------*/
+int UT_RecordObject::luaCreate (lua_State* L)
+{
+    try
+    {
+        /* Create Unit Test */
+        return createLuaObject(L, new UT_RecordObject(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_RecordObject::UT_RecordObject (lua_State* L):
+    UnitTest(L, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*--------------------------------------------------------------------------------------
+ * testAccessor
+ *--------------------------------------------------------------------------------------*/
+int UT_RecordObject::testAccessor(lua_State* L)
+{
+    UT_RecordObject* lua_obj = NULL;
+    try
+    {
+        lua_obj = dynamic_cast<UT_RecordObject*>(getLuaSelf(L, 1));
+    }
+    catch(const RunTimeException& e)
+    {
+        print2term("Failed to get lua parameters: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    ut_initialize(lua_obj);
+
+    // native record
+    RecordObject el(elRecType);
+    ut_elevation_t* elevation = reinterpret_cast<ut_elevation_t*>(el.getRecordData());
+    elevation->extent_id = 0x1234567890ABCDEFULL;
+    elevation->segment_id = 654321;
+    elevation->photon_count = -17;
+    elevation->rgt = 1387;
+    elevation->cycle = 22;
+    elevation->time_ns = 1700000000123456789LL;
+    elevation->latitude = -71.25;
+    elevation->longitude = 150.5;
+    elevation->h_mean = 1234.875;
+    elevation->x_atc = 2.5F;
+    elevation->h_sigma = 0.125F;
+
+    const char* el_fields[] = {"extent_id", "segment_id", "n_fit_photons", "rgt", "cycle", "time", "latitude", "longitude", "h_mean", "x_atc", "h_sigma"};
+    for(const char* name: el_fields)
+    {
+        const RecordObject::field_t field = el.getField(name);
+        const RecordObject::Accessor accessor(field);
+        ut_assert(lua_obj, accessor.isDirect(), "expected direct accessor for %s\n", name);
+        ut_assert(lua_obj, accessor.getReal(&el) == el.getValueReal(field), "mismatched real value for %s\n", name);
+        ut_assert(lua_obj, accessor.getInteger(&el) == el.getValueInteger(field), "mismatched integer value for %s\n", name);
+    }
+
+    // typed values
+    const RecordObject::Accessor h_mean(el.getField("h_mean"));
+    ut_assert(lua_obj, h_mean.value<double>(el.getRecordData()) == 1234.875, "failed to read h_mean\n");
+    const RecordObject::Accessor time(el.getField("time"));
+    ut_assert(lua_obj, time.value<int64_t>(el.getRecordData()) == 1700000000123456789LL, "failed to read time\n");
+
+    // swapped record
+    RecordObject sw(swRecType);
+    sw.setValueInteger(sw.getField("be16"), 0x1234);
+    sw.setValueInteger(sw.getField("be32"), 0x12345678);
+    sw.setValueInteger(sw.getField("be64"), -1234567890123L);
+    sw.setValueReal(sw.getField("bedbl"), 3.75);
+    for(int i = 0; i < 4; i++) sw.setValueInteger(sw.getField("values"), 100 + i, i);
+
+    const char* sw_fields[] = {"be16", "be32", "be64", "bedbl"};
+    for(const char* name: sw_fields)
+    {
+        const RecordObject::field_t field = sw.getField(name);
+        const RecordObject::Accessor accessor(field);
+        ut_assert(lua_obj, accessor.getReal(&sw) == sw.getValueReal(field), "mismatched swapped real value for %s\n", name);
+        ut_assert(lua_obj, accessor.getInteger(&sw) == sw.getValueInteger(field), "mismatched swapped integer value for %s\n", name);
+    }
+    const RecordObject::Accessor be64(sw.getField("be64"));
+    ut_assert(lua_obj, be64.value<int64_t>(sw.getRecordData()) == -1234567890123L, "failed to read swapped be64\n");
+
+    // array elements
+    const RecordObject::Accessor values(sw.getField("values"));
+    for(int i = 0; i < 4; i++)
+    {
+        ut_assert(lua_obj, values.getInteger(&sw, i) == 100 + i, "failed to read element %d\n", i);
+    }
+    const RecordObject::Accessor element(sw.getField("values[2]"));
+    ut_assert(lua_obj, element.getInteger(&sw) == 102, "failed to read bracketed element\n");
+
+    // invalid field
+    const RecordObject::Accessor missing(el.getField("not_a_field"));
+    ut_assert(lua_obj, !missing.isValid(), "expected invalid accessor\n");
+
+    // return success or failure
+    lua_pushboolean(L, ut_status(lua_obj));
+    return 1;
+}
+
+/*--------------------------------------------------------------------------------------
+ * testFieldPath
+ *--------------------------------------------------------------------------------------*/
+int UT_RecordObject::testFieldPath(lua_State* L)
+{
+    UT_RecordObject* lua_obj = NULL;
+    try
+    {
+        lua_obj = dynamic_cast<UT_RecordObject*>(getLuaSelf(L, 1));
+    }
+    catch(const RunTimeException& e)
+    {
+        print2term("Failed to get lua parameters: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    ut_initialize(lua_obj);
+
+    RecordObject el(elRecType);
+    reinterpret_cast<ut_elevation_t*>(el.getRecordData())->rgt = 1387;
+
+    RecordObject sw(swRecType);
+    sw.setValueInteger(sw.getField("be16"), 0x1234);
+
+    // same path resolved against different record types
+    RecordObject::FieldPath rgt("rgt");
+    ut_assert(lua_obj, rgt.getInteger(&el) == 1387, "failed to read rgt\n");
+    ut_assert(lua_obj, !rgt.resolve(&sw).isValid(), "expected rgt to be invalid for %s\n", swRecType);
+    ut_assert(lua_obj, rgt.getInteger(&el) == 1387, "failed to reread rgt\n");
+
+    RecordObject::FieldPath be16("be16");
+    ut_assert(lua_obj, be16.getInteger(&sw) == 0x1234, "failed to read be16\n");
+
+    // immediate field
+    RecordObject::FieldPath immediate("$UINT16BE(0,1,_)");
+    ut_assert(lua_obj, immediate.getInteger(&sw) == 0x1234, "failed to read immediate field\n");
+
+    // return success or failure
+    lua_pushboolean(L, ut_status(lua_obj));
+    return 1;
+}
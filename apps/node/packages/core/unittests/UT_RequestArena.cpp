@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "UT_RequestArena.h"
+#include "UnitTest.h"
+#include "OsApi.h"
+#include "RequestArena.h"
+#include "FieldColumn.h"
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_RequestArena::LUA_META_NAME = "UT_RequestArena";
+const struct luaL_Reg UT_RequestArena::LUA_META_TABLE[] = {
+    {"allocate",    testAllocate},
+    {"release",     testRelease},
+    {"column",      testColumn},
+    {NULL,          NULL}
+};
+
+/******************************************************************************
+ * METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * luaCreate -
+ *----------------------------------------------------------------------------*/
+int UT_RequestArena::luaCreate (lua_State* L)
+{
+    try
+    {
+        /* Create Unit Test */
+        return createLuaObject(L, new UT_RequestArena(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_RequestArena::UT_RequestArena (lua_State* L):
+    UnitTest(L, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*--------------------------------------------------------------------------------------
+ * testAllocate
+ *--------------------------------------------------------------------------------------*/
+int UT_RequestArena::testAllocate(lua_State* L)
+{
+    UT_RequestArena* lua_obj = NULL;
+    try
+    {
+        // initialize test
+        lua_obj = dynamic_cast<UT_RequestArena*>(getLuaSelf(L, 1));
+        ut_initialize(lua_obj);
+
+        const size_t live_bytes = RequestArena::liveBytes();
+        const long live_arenas = RequestArena::liveArenas();
+        {
+            const shared_ptr<RequestArena> arena = make_shared<RequestArena>("ut_allocate", RequestArena::MIN_SLAB_SIZE);
+            ut_assert(lua_obj, RequestArena::liveArenas() == live_arenas + 1, "arena not counted");
+            ut_assert(lua_obj, arena->reservedBytes() == 0, "memory reserved before first allocation");
+
+            // bump allocations are aligned and do not overlap
+            uint8_t* a = static_cast<uint8_t*>(arena->allocate(3, 1));
+            double* b = arena->allocate<double>(4);
+            uint64_t* c = arena->allocate<uint64_t>(2);
+            ut_assert(lua_obj, (reinterpret_cast<uintptr_t>(b) % alignof(double)) == 0, "misaligned allocation: %p", b);
+            ut_assert(lua_obj, (reinterpret_cast<uintptr_t>(c) % alignof(uint64_t)) == 0, "misaligned allocation: %p", c);
+            ut_assert(lua_obj, (a + 3 <= reinterpret_cast<uint8_t*>(b)) && (reinterpret_cast<uint8_t*>(b + 4) <= reinterpret_cast<uint8_t*>(c)), "overlapping allocations");
+            ut_assert(lua_obj, arena->usedBytes() == 3 + (4 * sizeof(double)) + (2 * sizeof(uint64_t)), "incorrect used bytes: %ld", static_cast<long>(arena->usedBytes()));
+            ut_assert(lua_obj, arena->reservedBytes() == RequestArena::MIN_SLAB_SIZE, "incorrect reserved bytes: %ld", static_cast<long>(arena->reservedBytes()));
+            ut_assert(lua_obj, RequestArena::liveBytes() == live_bytes + RequestArena::MIN_SLAB_SIZE, "reserved bytes not counted");
+
+            // scope binds arena to thread and restores previous binding
+            ut_assert(lua_obj, RequestArena::current() == NULL, "arena bound outside of scope");
+            {
+                const RequestArena::Scope scope(arena);
+                ut_assert(lua_obj, RequestArena::current() == arena, "arena not bound in scope");
+                {
+                    const RequestArena::Scope inner_scope(NULL);
+                    ut_assert(lua_obj, RequestArena::current() == NULL, "arena not unbound in inner scope");
+                }
+                ut_assert(lua_obj, RequestArena::current() == arena, "arena not restored after inner scope");
+            }
+            ut_assert(lua_obj, RequestArena::current() == NULL, "arena bound after scope");
+        }
+        ut_assert(lua_obj, RequestArena::liveBytes() == live_bytes, "arena memory not unmapped: %ld", static_cast<long>(RequestArena::liveBytes() - live_bytes));
+        ut_assert(lua_obj, RequestArena::liveArenas() == live_arenas, "arena not released");
+
+        // return status
+        lua_pushboolean(L, ut_status(lua_obj));
+        return 1;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(CRITICAL, "Failed to get lua parameters: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+}
+
+/*--------------------------------------------------------------------------------------
+ * testRelease
+ *--------------------------------------------------------------------------------------*/
+int UT_RequestArena::testRelease(lua_State* L)
+{
+    UT_RequestArena* lua_obj = NULL;
+    try
+    {
+        // initialize test
+        lua_obj = dynamic_cast<UT_RequestArena*>(getLuaSelf(L, 1));
+        ut_initialize(lua_obj);
+
+        const size_t slab_size = RequestArena::MIN_SLAB_SIZE;
+        const size_t block_size = slab_size / 8;
+        RequestArena arena("ut_release", slab_size);
+
+        // large allocations get their own slab and are unmapped on release
+        void* large = arena.allocate(slab_size / 2);
+        ut_assert(lua_obj, arena.reservedBytes() == slab_size / 2, "incorrect reserved bytes for large allocation: %ld", static_cast<long>(arena.reservedBytes()));
+        arena.release(large, slab_size / 2);
+        ut_assert(lua_obj, arena.reservedBytes() == 0, "large allocation not unmapped: %ld", static_cast<long>(arena.reservedBytes()));
+        ut_assert(lua_obj, arena.usedBytes() == 0, "large allocation still used: %ld", static_cast<long>(arena.usedBytes()));
+
+        // fill a slab and spill into a second one
+        void* blocks[9];
+        for(int i = 0; i < 9; i++)
+        {
+            blocks[i] = arena.allocate(block_size);
+        }
+        ut_assert(lua_obj, arena.reservedBytes() == 2 * slab_size, "incorrect reserved bytes after spill: %ld", static_cast<long>(arena.reservedBytes()));
+
+        // retired slab is unmapped once everything in it is released
+        for(int i = 0; i < 7; i++)
+        {
+            arena.release(blocks[i], block_size);
+        }
+        ut_assert(lua_obj, arena.reservedBytes() == 2 * slab_size, "slab unmapped while still in use: %ld", static_cast<long>(arena.reservedBytes()));
+        arena.release(blocks[7], block_size);
+        ut_assert(lua_obj, arena.reservedBytes() == slab_size, "retired slab not unmapped: %ld", static_cast<long>(arena.reservedBytes()));
+
+        // slab still being allocated out of stays mapped
+        arena.release(blocks[8], block_size);
+        ut_assert(lua_obj, arena.reservedBytes() == slab_size, "active slab unmapped: %ld", static_cast<long>(arena.reservedBytes()));
+        ut_assert(lua_obj, arena.usedBytes() == 0, "incorrect used bytes after release: %ld", static_cast<long>(arena.usedBytes()));
+
+        // active slab can still be allocated out of
+        void* next = arena.allocate(block_size);
+        ut_assert(lua_obj, next != NULL && arena.reservedBytes() == slab_size, "failed to allocate from active slab");
+
+        // slab of an arena evicted from the thread's slots is retired
+        const shared_ptr<RequestArena> evicted = make_shared<RequestArena>("ut_evicted", slab_size);
+        evicted->release(evicted->allocate(block_size), block_size);
+        ut_assert(lua_obj, evicted->reservedBytes() == slab_size, "active slab unmapped before eviction: %ld", static_cast<long>(evicted->reservedBytes()));
+        vector<shared_ptr<RequestArena>> others;
+        for(int i = 0; i < RequestArena::SUB_ARENA_SLOTS; i++)
+        {
+            others.push_back(make_shared<RequestArena>("ut_evictor", slab_size));
+            others.back()->allocate(block_size);
+        }
+        ut_assert(lua_obj, evicted->reservedBytes() == 0, "evicted slab not unmapped: %ld", static_cast<long>(evicted->reservedBytes()));
+
+        // return status
+        lua_pushboolean(L, ut_status(lua_obj));
+        return 1;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(CRITICAL, "Failed to get lua parameters: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+}
+
+/*--------------------------------------------------------------------------------------
+ * testColumn
+ *--------------------------------------------------------------------------------------*/
+int UT_RequestArena::testColumn(lua_State* L)
+{
+    UT_RequestArena* lua_obj = NULL;
+    try
+    {
+        // initialize test
+        lua_obj = dynamic_cast<UT_RequestArena*>(getLuaSelf(L, 1));
+        ut_initialize(lua_obj);
+
+        const long chunk_size = 1024;
+        const long chunk_bytes = chunk_size * sizeof(double);
+        const shared_ptr<RequestArena> arena = make_shared<RequestArena>("ut_column");
+        {
+            const RequestArena::Scope scope(arena);
+            FieldColumn<double> column(0U, chunk_size);
+            for(long i = 0; i < 4 * chunk_size; i++)
+            {
+                column.append(static_cast<double>(i));
+            }
+            ut_assert(lua_obj, arena->usedBytes() == static_cast<size_t>(4 * chunk_bytes), "column chunks not allocated from arena: %ld", static_cast<long>(arena->usedBytes()));
+
+            // filter hands the source chunks back to the arena
+            vector<uint8_t> mask(column.length());
+            for(long i = 0; i < column.length(); i++) mask[i] = (i % 2) == 0;
+            ut_assert(lua_obj, column.filter(mask) == 2 * chunk_size, "incorrect filtered length: %ld", column.length());
+            ut_assert(lua_obj, arena->usedBytes() == static_cast<size_t>(3 * chunk_bytes), "filtered chunks not released: %ld", static_cast<long>(arena->usedBytes()));
+            for(long i = 0; i < column.length(); i++)
+            {
+                if(!ut_assert(lua_obj, column[i] == static_cast<double>(2 * i), "mismatch at %ld: %lf", i, column[i])) break;
+            }
+            column.append(-1.0);
+            ut_assert(lua_obj, column.length() == (2 * chunk_size) + 1 && column[2 * chunk_size] == -1.0, "failed to append after filter");
+
+            // clear hands all chunks back to the arena
+            column.clear();
+            ut_assert(lua_obj, arena->usedBytes() == 0, "cleared chunks not released: %ld", static_cast<long>(arena->usedBytes()));
+        }
+
+        // filter keeps the partially filled chunk
+        FieldColumn<int32_t> heap_column(0U, 4);
+        for(int32_t i = 0; i < 10; i++) heap_column.append(i);
+        const vector<uint8_t> odd = {0, 1, 0, 1, 0, 1, 0, 1, 0, 1};
+        ut_assert(lua_obj, heap_column.filter(odd) == 5, "incorrect filtered length: %ld", heap_column.length());
+        for(long i = 0; i < heap_column.length(); i++)
+        {
+            ut_assert(lua_obj, heap_column[i] == (2 * i) + 1, "mismatch at %ld: %d", i, heap_column[i]);
+        }
+
+        // deserialized column can be appended to
+        const int32_t values[4] = {10, 11, 12, 13};
+        FieldColumn<int32_t> buffer_column(reinterpret_cast<const uint8_t*>(values), sizeof(values));
+        buffer_column.append(14);
+        ut_assert(lua_obj, buffer_column.length() == 5, "incorrect length after append: %ld", buffer_column.length());
+        for(long i = 0; i < buffer_column.length(); i++)
+        {
+            ut_assert(lua_obj, buffer_column[i] == 10 + i, "mismatch at %ld: %d", i, buffer_column[i]);
+        }
+
+        // return status
+        lua_pushboolean(L, ut_status(lua_obj));
+        return 1;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(CRITICAL, "Failed to get lua parameters: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+}
@@ -0,0 +1,617 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <rapidjson/document.h>
+
+#include "ContainerPool.h"
+#include "ContainerRunner.h"
+#include "OsApi.h"
+#include "EventLib.h"
+#include "SystemConfig.h"
+#include "CurlLib.h"
+#include "EndpointObject.h"
+#include "TimeLib.h"
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* ContainerPool::DEFAULT_IDLE_COMMAND = "sleep infinity";
+const char* ContainerPool::RESET_COMMAND = "find /tmp -mindepth 1 -delete";
+const char* ContainerPool::SCRATCH_DIRECTORY = "/tmp";
+
+Mutex ContainerPool::poolsMut;
+Dictionary<ContainerPool*> ContainerPool::pools;
+
+/******************************************************************************
+ * PUBLIC METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * init
+ *----------------------------------------------------------------------------*/
+void ContainerPool::init (void)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * deinit
+ *----------------------------------------------------------------------------*/
+void ContainerPool::deinit (void)
+{
+    poolsMut.lock();
+    {
+        pools.clear(); // deletes each pool
+    }
+    poolsMut.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * get - returns NULL if image is not pooled (or pool is empty)
+ *----------------------------------------------------------------------------*/
+ContainerPool* ContainerPool::get (const char* image)
+{
+    ContainerPool* pool = NULL;
+    poolsMut.lock();
+    {
+        if(!pools.find(image, &pool) || pool->poolSize <= 0)
+        {
+            pool = NULL;
+        }
+    }
+    poolsMut.unlock();
+    return pool;
+}
+
+/*----------------------------------------------------------------------------
+ * luaConfigure - pool(<image>, <size>, [<max runs>], [<idle command>])
+ *
+ *  a size of zero empties the pool; pools are never deleted while the server
+ *  is running since runners may hold a reference to them
+ *----------------------------------------------------------------------------*/
+int ContainerPool::luaConfigure (lua_State* L)
+{
+    bool status = false;
+
+    try
+    {
+        const char* image = LuaObject::getLuaString(L, 1);
+        const long pool_size = LuaObject::getLuaInteger(L, 2);
+        const long max_runs = LuaObject::getLuaInteger(L, 3, true, DEFAULT_MAX_RUNS);
+        const char* idle_command = LuaObject::getLuaString(L, 4, true, DEFAULT_IDLE_COMMAND);
+
+        if(pool_size < 0 || pool_size > MAX_POOL_SIZE)
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid pool size: %ld", pool_size);
+        }
+        if(max_runs <= 0)
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid max runs: %ld", max_runs);
+        }
+
+        poolsMut.lock();
+        {
+            ContainerPool* pool = NULL;
+            if(pools.find(image, &pool))
+            {
+                pool->poolMut.lock();
+                {
+                    pool->poolSize = pool_size;
+                    pool->maxRuns = max_runs;
+                    pool->idleCommand = idle_command;
+                }
+                pool->poolMut.unlock();
+            }
+            else if(pool_size > 0)
+            {
+                pool = new ContainerPool(image, pool_size, max_runs, idle_command);
+                pools.add(image, pool);
+            }
+        }
+        poolsMut.unlock();
+
+        mlog(INFO, "Configured container pool for <%s>: size=%ld, max_runs=%ld", image, pool_size, max_runs);
+        status = true;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Failed to configure container pool: %s", e.what());
+    }
+
+    return LuaObject::returnLuaStatus(L, status);
+}
+
+/*----------------------------------------------------------------------------
+ * luaStats - poolstats(<image>) -> table of pool statistics
+ *----------------------------------------------------------------------------*/
+int ContainerPool::luaStats (lua_State* L)
+{
+    try
+    {
+        const char* image = LuaObject::getLuaString(L, 1);
+        ContainerPool* pool = get(image);
+        if(!pool)
+        {
+            throw RunTimeException(ERROR, RTE_FAILURE, "no container pool for image: %s", image);
+        }
+
+        pool->poolMut.lock();
+        const stats_t stats = pool->stats;
+        const int idle_count = pool->idle.size();
+        const int busy_count = pool->busy.length();
+        pool->poolMut.unlock();
+
+        lua_newtable(L);
+        LuaEngine::setAttrInt(L, "idle", idle_count);
+        LuaEngine::setAttrInt(L, "busy", busy_count);
+        LuaEngine::setAttrInt(L, "leases", stats.leases);
+        LuaEngine::setAttrInt(L, "hits", stats.hits);
+        LuaEngine::setAttrInt(L, "misses", stats.misses);
+        LuaEngine::setAttrInt(L, "recycled", stats.recycled);
+        LuaEngine::setAttrInt(L, "reset_failures", stats.resetFailures);
+        LuaEngine::setAttrInt(L, "failures", stats.failures);
+        LuaEngine::setAttrNum(L, "avg_start_time", (stats.hits + stats.misses + stats.failures) > 0 ? stats.startTime / (stats.hits + stats.misses + stats.failures) : 0.0);
+        LuaEngine::setAttrNum(L, "max_start_time", stats.maxStartTime);
+        LuaEngine::setAttrNum(L, "avg_lease_time", stats.leases > 0 ? stats.leaseTime / stats.leases : 0.0);
+        return 1;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Failed to get container pool stats: %s", e.what());
+    }
+
+    lua_pushnil(L);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * lease - hands out a warm container, or starts one when none are idle
+ *----------------------------------------------------------------------------*/
+bool ContainerPool::lease (string& container_id, int timeout_secs)
+{
+    const double start = TimeLib::latchtime();
+    bool leased = false;
+
+    /* Wait for an Idle Container While One is Being Warmed */
+    int wait_ms = timeout_secs * 1000;
+    while(!leased && active)
+    {
+        bool keep_waiting = false;
+        poolMut.lock();
+        {
+            if(!idle.empty())
+            {
+                const container_t container = idle.back();
+                idle.pop_back();
+                busy.add(container.id.c_str(), container.runs);
+                container_id = container.id;
+                stats.hits++;
+                leased = true;
+            }
+            else
+            {
+                keep_waiting = starting > 0;
+            }
+        }
+        poolMut.unlock();
+
+        if(leased || !keep_waiting || wait_ms <= 0) break;
+        OsApi::sleep(LEASE_POLL_MS / 1000.0);
+        wait_ms -= LEASE_POLL_MS;
+    }
+
+    /* Start a Container On Demand */
+    if(!leased && active)
+    {
+        if(startContainer(container_id))
+        {
+            poolMut.lock();
+            {
+                busy.add(container_id.c_str(), 0);
+                stats.misses++;
+            }
+            poolMut.unlock();
+            leased = true;
+        }
+    }
+
+    /* Update Statistics */
+    if(leased)
+    {
+        poolMut.lock();
+        {
+            stats.leases++;
+            stats.leaseTime += TimeLib::latchtime() - start;
+        }
+        poolMut.unlock();
+    }
+
+    return leased;
+}
+
+/*----------------------------------------------------------------------------
+ * release - returns container to the idle set unless it needs recycling
+ *
+ *  a container is only reused once everything the command left behind has
+ *  been cleared; a container that cannot be reset is removed instead
+ *----------------------------------------------------------------------------*/
+void ContainerPool::release (const string& container_id, bool healthy)
+{
+    /* Check if Container Can Be Reused */
+    int runs = 0;
+    bool reuse = false;
+    poolMut.lock();
+    {
+        if(busy.find(container_id.c_str(), &runs))
+        {
+            runs++;
+            reuse = healthy && active && (runs < maxRuns);
+        }
+    }
+    poolMut.unlock();
+
+    /* Reset Container */
+    bool reset_failed = false;
+    if(reuse)
+    {
+        reuse = resetContainer(container_id);
+        reset_failed = !reuse;
+    }
+
+    /* Return Container to Idle Set */
+    poolMut.lock();
+    {
+        busy.remove(container_id.c_str());
+        if(reuse && active && static_cast<int>(idle.size()) < poolSize)
+        {
+            const container_t container = {
+                .id = container_id,
+                .runs = runs
+            };
+            idle.push_back(container);
+        }
+        else
+        {
+            reuse = false;
+            stats.recycled++;
+        }
+        if(reset_failed) stats.resetFailures++;
+    }
+    poolMut.unlock();
+
+    if(!reuse)
+    {
+        removeContainer(container_id);
+    }
+}
+
+/******************************************************************************
+ * PRIVATE METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+ContainerPool::ContainerPool (const char* _image, int _pool_size, int _max_runs, const char* idle_command):
+    image(_image),
+    idleCommand(idle_command),
+    poolSize(_pool_size),
+    maxRuns(_max_runs),
+    active(true),
+    starting(0)
+{
+    memset(&stats, 0, sizeof(stats));
+    maintenancePid = new Thread(maintenanceThread, this);
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor
+ *----------------------------------------------------------------------------*/
+ContainerPool::~ContainerPool (void)
+{
+    active = false;
+    delete maintenancePid;
+
+    /* Remove Idle Containers - busy containers are removed on release */
+    for(const container_t& container: idle)
+    {
+        removeContainer(container.id);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * maintenanceThread - keeps the configured number of containers warm
+ *----------------------------------------------------------------------------*/
+void* ContainerPool::maintenanceThread (void* parm)
+{
+    ContainerPool* pool = static_cast<ContainerPool*>(parm);
+
+    while(pool->active)
+    {
+        /* Determine if Another Container is Needed (or One is Surplus) */
+        bool needed = false;
+        string surplus_id;
+        pool->poolMut.lock();
+        {
+            needed = (static_cast<int>(pool->idle.size()) + pool->starting) < pool->poolSize;
+            if(needed)
+            {
+                pool->starting++;
+            }
+            else if(static_cast<int>(pool->idle.size()) > pool->poolSize)
+            {
+                surplus_id = pool->idle.front().id;
+                pool->idle.erase(pool->idle.begin());
+                pool->stats.recycled++;
+            }
+        }
+        pool->poolMut.unlock();
+
+        /* Remove Surplus Container */
+        if(!surplus_id.empty())
+        {
+            removeContainer(surplus_id);
+            continue;
+        }
+
+        /* Warm Container */
+        if(needed)
+        {
+            string container_id;
+            const bool started = pool->startContainer(container_id);
+            pool->poolMut.lock();
+            {
+                pool->starting--;
+                if(started)
+                {
+                    const container_t container = {
+                        .id = container_id,
+                        .runs = 0
+                    };
+                    pool->idle.push_back(container);
+                }
+            }
+            pool->poolMut.unlock();
+
+            /* Back Off on Failure */
+            if(!started) OsApi::sleep(MAINTENANCE_PERIOD_MS / 1000.0);
+        }
+        else
+        {
+            OsApi::sleep(MAINTENANCE_PERIOD_MS / 1000.0);
+        }
+    }
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * startContainer - create and start an idle container for the image
+ *----------------------------------------------------------------------------*/
+bool ContainerPool::startContainer (string& container_id)
+{
+    const char* unix_socket = SystemConfig::settings().dockerSocket.value.c_str();
+    const double start = TimeLib::latchtime();
+    bool started = false;
+
+    /* Check for Image (and Pull If Necessary) */
+    ContainerRunner::checkImage(image.c_str(), ContainerRunner::WAIT_TIMEOUT, NULL);
+
+    /* Configure HTTP Headers */
+    CurlLib::hdrs_t headers(5);
+    const FString* content_type = new const FString("Content-Type: application/json");
+    headers.add(content_type);
+
+    /*
+     * Build Container Parameters
+     *  the host data directory holds every request sandbox; the container runs
+     *  unprivileged on a read-only root filesystem with a tmpfs scratch directory
+     *  so that a run cannot change the container seen by the next run
+     */
+    poolMut.lock();
+    const string cmd_str = ContainerRunner::buildCommandArray(idleCommand);
+    poolMut.unlock();
+    const FString host_config("\"HostConfig\": {\"Binds\": [\"%s:%s\"], \"ReadonlyRootfs\": true, \"Tmpfs\": {\"%s\": \"rw,nosuid,nodev,mode=1777\"}, \"CapDrop\": [\"ALL\"], \"SecurityOpt\": [\"no-new-privileges\"]}",
+                              ContainerRunner::HOST_DIRECTORY, ContainerRunner::HOST_DIRECTORY, SCRATCH_DIRECTORY);
+    const FString data("{\"Image\": \"%s/%s\", \"User\": \"%d:%d\", %s, \"Labels\": {\"sliderule.pool\": \"%s\"}, \"Cmd\": [%s]}",
+                        SystemConfig::settings().containerRegistry.value.c_str(), image.c_str(),
+                        POOL_USER_ID, POOL_USER_ID, host_config.c_str(), image.c_str(), cmd_str.c_str());
+
+    /* Create Container */
+    const FString create_url("http://localhost/%s/containers/create", ContainerRunner::DOCKER_API_VERSION);
+    const char* create_response = NULL;
+    const long create_http_code = CurlLib::request(EndpointObject::POST, create_url.c_str(), data.c_str(), &create_response, NULL, false, false, CurlLib::DATA_TIMEOUT, &headers, unix_socket);
+    if(create_http_code == EndpointObject::Created)
+    {
+        rapidjson::Document json;
+        json.Parse(create_response);
+        if(!json.HasParseError() && json.IsObject() && json.HasMember("Id") && json["Id"].IsString())
+        {
+            container_id = json["Id"].GetString();
+
+            /* Start Container */
+            const FString start_url("http://localhost/%s/containers/%s/start", ContainerRunner::DOCKER_API_VERSION, container_id.c_str());
+            const char* start_response = NULL;
+            const long start_http_code = CurlLib::request(EndpointObject::POST, start_url.c_str(), NULL, &start_response, NULL, false, false, CurlLib::DATA_TIMEOUT, NULL, unix_socket);
+            if(start_http_code == EndpointObject::No_Content)
+            {
+                started = true;
+            }
+            else
+            {
+                mlog(CRITICAL, "Failed to start pooled container <%s>: %ld - %s", image.c_str(), start_http_code, start_response);
+                removeContainer(container_id);
+            }
+            delete [] start_response;
+        }
+        else
+        {
+            mlog(CRITICAL, "Invalid response creating pooled container <%s>: %s", image.c_str(), create_response);
+        }
+    }
+    else
+    {
+        mlog(CRITICAL, "Failed to create pooled container <%s>: %ld - %s", image.c_str(), create_http_code, create_response);
+    }
+    delete [] create_response;
+
+    /* Update Statistics */
+    const double elapsed = TimeLib::latchtime() - start;
+    poolMut.lock();
+    {
+        stats.startTime += elapsed;
+        stats.maxStartTime = MAX(stats.maxStartTime, elapsed);
+        if(!started) stats.failures++;
+    }
+    poolMut.unlock();
+
+    if(started) mlog(INFO, "Started pooled container <%s> in %.3lf seconds", image.c_str(), elapsed);
+
+    return started;
+}
+
+/*----------------------------------------------------------------------------
+ * resetContainer - clears what a run left behind in a container
+ *
+ *  the root filesystem is read-only, so a run can only leave behind processes
+ *  and files in the scratch directory; a container is clean when the idle
+ *  command is its only process and the scratch directory has been emptied
+ *----------------------------------------------------------------------------*/
+bool ContainerPool::resetContainer (const string& container_id)
+{
+    const char* unix_socket = SystemConfig::settings().dockerSocket.value.c_str();
+
+    /* Check for Leftover Processes */
+    bool clean = false;
+    const FString top_url("http://localhost/%s/containers/%s/top", ContainerRunner::DOCKER_API_VERSION, container_id.c_str());
+    const char* top_response = NULL;
+    const long top_http_code = CurlLib::request(EndpointObject::GET, top_url.c_str(), NULL, &top_response, NULL, false, false, CurlLib::DATA_TIMEOUT, NULL, unix_socket);
+    if(top_http_code == EndpointObject::OK)
+    {
+        rapidjson::Document json;
+        json.Parse(top_response);
+        if(!json.HasParseError() && json.IsObject() && json.HasMember("Processes") && json["Processes"].IsArray())
+        {
+            const rapidjson::SizeType num_processes = json["Processes"].Size();
+            clean = (num_processes == 1);
+            if(!clean) mlog(WARNING, "Pooled container <%s> left %u processes running", container_id.c_str(), num_processes);
+        }
+    }
+    else
+    {
+        mlog(CRITICAL, "Failed to list processes of pooled container <%s>: %ld - %s", container_id.c_str(), top_http_code, top_response);
+    }
+    delete [] top_response;
+
+    /* Clear Scratch Directory */
+    if(clean)
+    {
+        const int exit_code = execCommand(container_id, RESET_COMMAND, RESET_TIMEOUT);
+        clean = (exit_code == 0);
+        if(!clean) mlog(WARNING, "Failed to clear scratch directory of pooled container <%s>: %d", container_id.c_str(), exit_code);
+    }
+
+    return clean;
+}
+
+/*----------------------------------------------------------------------------
+ * execCommand - runs command in container and returns its exit code (-1 on failure)
+ *----------------------------------------------------------------------------*/
+int ContainerPool::execCommand (const string& container_id, const string& command, int timeout_secs)
+{
+    const char* unix_socket = SystemConfig::settings().dockerSocket.value.c_str();
+    int exit_code = -1;
+
+    /* Configure HTTP Headers */
+    CurlLib::hdrs_t headers(5);
+    const FString* content_type = new const FString("Content-Type: application/json");
+    headers.add(content_type);
+
+    /* Create Exec */
+    const FString exec_data("{\"AttachStdout\": true, \"AttachStderr\": true, \"Cmd\": [%s]}", ContainerRunner::buildCommandArray(command).c_str());
+    const FString exec_url("http://localhost/%s/containers/%s/exec", ContainerRunner::DOCKER_API_VERSION, container_id.c_str());
+    const char* exec_response = NULL;
+    const long exec_http_code = CurlLib::request(EndpointObject::POST, exec_url.c_str(), exec_data.c_str(), &exec_response, NULL, false, false, CurlLib::DATA_TIMEOUT, &headers, unix_socket);
+    rapidjson::Document exec_json;
+    if(exec_http_code == EndpointObject::Created) exec_json.Parse(exec_response);
+    delete [] exec_response;
+    if(exec_http_code != EndpointObject::Created || exec_json.HasParseError() || !exec_json.IsObject() || !exec_json.HasMember("Id") || !exec_json["Id"].IsString())
+    {
+        return exit_code;
+    }
+    const string exec_id = exec_json["Id"].GetString();
+
+    /* Start Exec - blocks until command completes */
+    const FString start_url("http://localhost/%s/exec/%s/start", ContainerRunner::DOCKER_API_VERSION, exec_id.c_str());
+    const char* start_response = NULL;
+    const long start_http_code = CurlLib::request(EndpointObject::POST, start_url.c_str(), "{\"Detach\": false, \"Tty\": false}", &start_response, NULL, false, false, timeout_secs, &headers, unix_socket);
+    delete [] start_response;
+    if(start_http_code != EndpointObject::OK)
+    {
+        return exit_code;
+    }
+
+    /* Inspect Exec */
+    const FString inspect_url("http://localhost/%s/exec/%s/json", ContainerRunner::DOCKER_API_VERSION, exec_id.c_str());
+    const char* inspect_response = NULL;
+    const long inspect_http_code = CurlLib::request(EndpointObject::GET, inspect_url.c_str(), NULL, &inspect_response, NULL, false, false, CurlLib::DATA_TIMEOUT, NULL, unix_socket);
+    if(inspect_http_code == EndpointObject::OK)
+    {
+        rapidjson::Document json;
+        json.Parse(inspect_response);
+        if(!json.HasParseError() && json.IsObject() &&
+           json.HasMember("Running") && json["Running"].IsBool() && !json["Running"].GetBool() &&
+           json.HasMember("ExitCode") && json["ExitCode"].IsInt())
+        {
+            exit_code = json["ExitCode"].GetInt();
+        }
+    }
+    delete [] inspect_response;
+
+    return exit_code;
+}
+
+/*----------------------------------------------------------------------------
+ * removeContainer - forced removal kills the container if still running
+ *----------------------------------------------------------------------------*/
+void ContainerPool::removeContainer (const string& container_id)
+{
+    const char* unix_socket = SystemConfig::settings().dockerSocket.value.c_str();
+    const FString remove_url("http://localhost/%s/containers/%s?force=true", ContainerRunner::DOCKER_API_VERSION, container_id.c_str());
+    const char* remove_response = NULL;
+    const long remove_http_code = CurlLib::request(EndpointObject::DELETE, remove_url.c_str(), NULL, &remove_response, NULL, false, false, CurlLib::DATA_TIMEOUT, NULL, unix_socket);
+    if(remove_http_code != EndpointObject::No_Content) mlog(CRITICAL, "Failed to delete pooled container <%s>: %ld - %s", container_id.c_str(), remove_http_code, remove_response);
+    delete [] remove_response;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __container_pool__
+#define __container_pool__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "Dictionary.h"
+#include "LuaObject.h"
+
+/******************************************************************************
+ * CONTAINER POOL CLASS
+ ******************************************************************************/
+
+/*
+ * Keeps a set of idle, already started containers for an image so that a
+ * container runner can execute its command inside a warm container (via the
+ * Docker exec API) instead of creating and starting a new one. Containers
+ * run as an unprivileged user on a read-only root filesystem so that the only
+ * state a command can leave behind is in the tmpfs scratch directory, which
+ * is cleared after every run. Containers are recycled after a configurable
+ * number of runs, when they cannot be reset, or on any failure.
+ */
+class ContainerPool
+{
+    friend class UT_ContainerPool; // necessary for the private constructor and fake docker socket
+
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int DEFAULT_MAX_RUNS = 100;
+        static const int MAX_POOL_SIZE = 32;
+        static const int MAINTENANCE_PERIOD_MS = 1000;
+        static const int LEASE_POLL_MS = 100;
+        static const int RESET_TIMEOUT = 30; // seconds
+        static const int POOL_USER_ID = 65534; // nobody
+        static const char* DEFAULT_IDLE_COMMAND;
+        static const char* RESET_COMMAND;
+        static const char* SCRATCH_DIRECTORY;
+
+        /*--------------------------------------------------------------------
+         * Typedefs
+         *--------------------------------------------------------------------*/
+
+        typedef struct {
+            long        leases;         // containers handed out to runners
+            long        hits;           // leases satisfied by a warm container
+            long        misses;         // leases that had to start a container
+            long        recycled;       // containers removed after max runs or failure
+            long        resetFailures;  // containers removed because they could not be reset
+            long        failures;       // containers that failed to create or start
+            double      startTime;      // running total of create+start latency (seconds)
+            double      maxStartTime;   // longest create+start latency (seconds)
+            double      leaseTime;      // running total of time spent acquiring a lease (seconds)
+        } stats_t;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static void             init            (void);
+        static void             deinit          (void);
+        static ContainerPool*   get             (const char* image);
+        static int              luaConfigure    (lua_State* L);
+        static int              luaStats        (lua_State* L);
+
+                                ~ContainerPool  (void); // called by pools dictionary
+        bool                    lease           (string& container_id, int timeout_secs);
+        void                    release         (const string& container_id, bool healthy);
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Typedefs
+         *--------------------------------------------------------------------*/
+
+        typedef struct {
+            string      id;
+            int         runs;
+        } container_t;
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        static Mutex                        poolsMut;
+        static Dictionary<ContainerPool*>   pools;
+
+        string              image;
+        string              idleCommand;
+        int                 poolSize;
+        int                 maxRuns;
+        bool                active;
+        Thread*             maintenancePid;
+        Mutex               poolMut;
+        vector<container_t> idle;
+        Dictionary<int>     busy;           // container id -> number of runs
+        int                 starting;       // containers being started by the maintenance thread
+        stats_t             stats;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+                            ContainerPool       (const char* _image, int _pool_size, int _max_runs, const char* idle_command);
+        static void*        maintenanceThread   (void* parm);
+        bool                startContainer      (string& container_id);
+        bool                resetContainer      (const string& container_id);
+        static int          execCommand         (const string& container_id, const string& command, int timeout_secs);
+        static void         removeContainer     (const string& container_id);
+};
+
+#endif  /* __container_pool__ */
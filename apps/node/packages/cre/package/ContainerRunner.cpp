@@ -39,6 +39,7 @@
 #include <sstream>
 #include <iostream>
 #include <array>
+#include <unistd.h>
 
 #include "ContainerRunner.h"
 #include "OsApi.h"
@@ -60,6 +61,7 @@ const struct luaL_Reg ContainerRunner::LUA_META_TABLE[] = {
 
 const char* ContainerRunner::SANDBOX_MOUNT = "/share";
 const char* ContainerRunner::HOST_DIRECTORY = "/data";
+const char* ContainerRunner::DOCKER_API_VERSION = "v1.43";
 
 /******************************************************************************
  * PUBLIC METHODS
@@ -95,13 +97,13 @@ int ContainerRunner::luaCreate (lua_State* L)
  *----------------------------------------------------------------------------*/
 int ContainerRunner::luaList (lua_State* L)
 {
-    const char* unix_socket = "/var/run/docker.sock";
-    const char* url= "http://localhost/v1.43/containers/json";
+    const char* unix_socket = SystemConfig::settings().dockerSocket.value.c_str();
+    const FString url("http://localhost/%s/containers/json", DOCKER_API_VERSION);
 
     /* Make Request for List of Containers */
     const char* response = NULL;
     int size = 0;
-    const long http_code = CurlLib::request(EndpointObject::GET, url, NULL, &response, &size, false, false, CurlLib::DATA_TIMEOUT, NULL, unix_socket);
+    const long http_code = CurlLib::request(EndpointObject::GET, url.c_str(), NULL, &response, &size, false, false, CurlLib::DATA_TIMEOUT, NULL, unix_socket);
 
     /* Push Result */
     lua_pushinteger(L, http_code);
@@ -177,6 +179,77 @@ int ContainerRunner::luaDeleteUnique (lua_State* L)
     return returnLuaStatus(L, status);
 }
 
+/*----------------------------------------------------------------------------
+ * checkImage - pulls image if it is not already present
+ *----------------------------------------------------------------------------*/
+void ContainerRunner::checkImage (const char* image, int timeout, Publisher* outq)
+{
+    const char* unix_socket = SystemConfig::settings().dockerSocket.value.c_str();
+
+    /* Configure HTTP Headers */
+    CurlLib::hdrs_t headers(5);
+    const FString* content_type = new const FString("Content-Type: application/json");
+    headers.add(content_type);
+
+    /* Check for Image (and Pull If Necessary) */
+    const FString check_url("http://localhost/%s/images/%s/json", DOCKER_API_VERSION, image);
+    const char* check_response = NULL;
+    const long check_http_code = CurlLib::request(EndpointObject::GET, check_url.c_str(), NULL, &check_response, NULL, false, false, timeout, &headers, unix_socket);
+    if(check_http_code < EndpointObject::OK || check_http_code >= EndpointObject::Bad_Request)
+    {
+        alert(CRITICAL, RTE_FAILURE, outq, NULL, "Pulling container <%s>: %ld - %s", image, check_http_code, check_response);
+        const string auth = authenticateToDocker();
+        const FString* registry_auth = new const FString("X-Registry-Auth: %s", auth.c_str());
+        headers.add(registry_auth);
+        const FString pull_url("http://localhost/%s/images/create?fromImage=%s", DOCKER_API_VERSION, image);
+        const char* pull_response = NULL;
+        const long pull_http_code = CurlLib::request(EndpointObject::POST, pull_url.c_str(), NULL, &pull_response, NULL, false, false, timeout, &headers, unix_socket);
+        if(pull_http_code < EndpointObject::OK || pull_http_code >= EndpointObject::Bad_Request)
+        {
+            alert(CRITICAL, RTE_FAILURE, outq, NULL, "Failed to pull container <%s>: %ld - %s", image, pull_http_code, pull_response);
+        }
+        delete [] pull_response;
+    }
+    delete [] check_response;
+}
+
+/*----------------------------------------------------------------------------
+ * buildCommandArray - space separated command to comma separated json strings
+ *
+ *  when a sandbox directory is supplied, paths under the sandbox mount are
+ *  translated to the sandbox directory, which pooled containers reach through
+ *  their mount of the host directory
+ *----------------------------------------------------------------------------*/
+string ContainerRunner::buildCommandArray (const string& command, const char* sandbox_directory)
+{
+    string token;
+    vector<string> tokens;
+    std::istringstream cmd_str_iss(command);
+    while(std::getline(cmd_str_iss, token, ' '))
+    {
+        if(!token.empty())
+        {
+            if(sandbox_directory)
+            {
+                const size_t mount_len = StringLib::size(SANDBOX_MOUNT);
+                if(token.compare(0, mount_len, SANDBOX_MOUNT) == 0 && (token.length() == mount_len || token[mount_len] == '/'))
+                {
+                    token = sandbox_directory + token.substr(mount_len);
+                }
+            }
+            tokens.push_back(token);
+        }
+    }
+    string cmd_str;
+    for(unsigned i = 0; i < tokens.size(); i++)
+    {
+        const FString elem_str("\"%s\"", tokens[i].c_str());
+        cmd_str += elem_str.c_str();
+        if(i < (tokens.size() - 1)) cmd_str += ", ";
+    }
+    return cmd_str;
+}
+
 /******************************************************************************
  * PRIVATE METHODS
  ******************************************************************************/
@@ -216,52 +289,28 @@ void* ContainerRunner::controlThread (void* parm)
     ContainerRunner* cr = reinterpret_cast<ContainerRunner*>(parm);
 
     /* Set Docker Socket */
-    const char* unix_socket = "/var/run/docker.sock";
-    const char* api_version = "v1.43";
+    const char* unix_socket = SystemConfig::settings().dockerSocket.value.c_str();
+    const char* api_version = DOCKER_API_VERSION;
 
     /* Configure HTTP Headers */
     CurlLib::hdrs_t headers(5);
     const FString* content_type = new const FString("Content-Type: application/json");
     headers.add(content_type);
 
-    /* Check for Image (and Pull If Necessary) */
-    const FString check_url("http://localhost/%s/images/%s/json", api_version, cr->parms->container_image.value.c_str());
-    const char* check_response = NULL;
-    const long check_http_code = CurlLib::request(EndpointObject::GET, check_url.c_str(), NULL, &check_response, NULL, false, false, cr->parms->timeout.value, &headers, unix_socket);
-    if(check_http_code < EndpointObject::OK || check_http_code >= EndpointObject::Bad_Request)
+    /* Run in Warm Container */
+    ContainerPool* pool = ContainerPool::get(cr->parms->container_image.value.c_str());
+    if(pool)
     {
-        alert(CRITICAL, RTE_FAILURE, cr->outQ, NULL, "Pulling container <%s>: %ld - %s", cr->parms->container_image.value.c_str(), check_http_code, check_response);
-        const string auth = authenticateToDocker();
-        const FString* registry_auth = new const FString("X-Registry-Auth: %s", auth.c_str());
-        headers.add(registry_auth);
-        const FString pull_url("http://localhost/%s/images/create?fromImage=%s", api_version, cr->parms->container_image.value.c_str());
-        const char* pull_response = NULL;
-        const long pull_http_code = CurlLib::request(EndpointObject::POST, pull_url.c_str(), NULL, &pull_response, NULL, false, false, cr->parms->timeout.value, &headers, unix_socket);
-        if(pull_http_code < EndpointObject::OK || pull_http_code >= EndpointObject::Bad_Request)
-        {
-            alert(CRITICAL, RTE_FAILURE, cr->outQ, NULL, "Failed to pull container <%s>: %ld - %s", cr->parms->container_image.value.c_str(), pull_http_code, pull_response);
-        }
+        cr->runPooled(pool);
+        cr->signalComplete();
+        return NULL;
     }
 
+    /* Check for Image (and Pull If Necessary) */
+    checkImage(cr->parms->container_image.value.c_str(), cr->parms->timeout.value, cr->outQ);
+
     /* Build Container Command Parameter */
-    string token;
-    vector<string> tokens;
-    std::istringstream cmd_str_iss(cr->parms->container_command.value);
-    while(std::getline(cmd_str_iss, token, ' '))
-    {
-        if(!token.empty())
-        {
-            tokens.push_back(token);
-        }
-    }
-    string cmd_str;
-    for(unsigned i = 0; i < tokens.size(); i++)
-    {
-        const FString elem_str("\"%s\"", tokens[i].c_str());
-        cmd_str += elem_str.c_str();
-        if(i < (tokens.size() - 1)) cmd_str += ", ";
-    }
-    const FString cmd("\"Cmd\": [%s]}", cmd_str.c_str());
+    const FString cmd("\"Cmd\": [%s]}", buildCommandArray(cr->parms->container_command.value).c_str());
 
     /* Build Container Parameters */
     const FString image("\"Image\": \"%s/%s\"", SystemConfig::settings().containerRegistry.value.c_str(), cr->parms->container_image.value.c_str());
@@ -414,6 +463,110 @@ void* ContainerRunner::controlThread (void* parm)
     return NULL;
 }
 
+/*----------------------------------------------------------------------------
+ * runPooled - executes command inside a warm container leased from the pool
+ *----------------------------------------------------------------------------*/
+void ContainerRunner::runPooled (ContainerPool* pool)
+{
+    const char* unix_socket = SystemConfig::settings().dockerSocket.value.c_str();
+    const char* container_image = parms->container_image.value.c_str();
+
+    /* Lease Container */
+    string container_id;
+    const double lease_start = TimeLib::latchtime();
+    if(!pool->lease(container_id, parms->timeout.value))
+    {
+        alert(CRITICAL, RTE_FAILURE, outQ, NULL, "Failed to lease pooled container <%s>", container_image);
+        return;
+    }
+
+    /* Build Container Name String */
+    char subid[8];
+    StringLib::copy(subid, container_id.c_str(), 8);
+    const FString container_name_str("%s:%s/%s", container_image, subid, parms->container_name.value.c_str());
+    alert(INFO, RTE_STATUS, outQ, NULL, "Leased pooled container <%s> in %.3lf seconds", container_name_str.c_str(), TimeLib::latchtime() - lease_start);
+
+    /* Give Pool User the Sandbox - pooled containers do not run as root */
+    if(chown(hostSandboxDirectory, ContainerPool::POOL_USER_ID, ContainerPool::POOL_USER_ID) != 0)
+    {
+        char err_buf[256];
+        alert(CRITICAL, RTE_FAILURE, outQ, NULL, "Failed to give pooled container access to sandbox %s: %s", hostSandboxDirectory, strerror_r(errno, err_buf, sizeof(err_buf)));
+        pool->release(container_id, true);
+        return;
+    }
+
+    /* Configure HTTP Headers */
+    CurlLib::hdrs_t headers(5);
+    const FString* content_type = new const FString("Content-Type: application/json");
+    headers.add(content_type);
+
+    /* Create Exec */
+    bool healthy = false;
+    const FString exec_data("{\"AttachStdout\": true, \"AttachStderr\": true, \"WorkingDir\": \"%s\", \"Cmd\": [%s]}",
+                            hostSandboxDirectory, buildCommandArray(parms->container_command.value, hostSandboxDirectory).c_str());
+    const FString exec_url("http://localhost/%s/containers/%s/exec", DOCKER_API_VERSION, container_id.c_str());
+    const char* exec_response = NULL;
+    const long exec_http_code = CurlLib::request(EndpointObject::POST, exec_url.c_str(), exec_data.c_str(), &exec_response, NULL, false, false, CurlLib::DATA_TIMEOUT, &headers, unix_socket);
+    if(exec_http_code != EndpointObject::Created)
+    {
+        alert(CRITICAL, RTE_FAILURE, outQ, NULL, "Failed to create exec in container <%s>: %ld - %s", container_name_str.c_str(), exec_http_code, exec_response);
+    }
+    else
+    {
+        /* Get Exec ID */
+        rapidjson::Document json;
+        json.Parse(exec_response);
+        if(json.HasParseError() || !json.IsObject() || !json.HasMember("Id") || !json["Id"].IsString())
+        {
+            alert(CRITICAL, RTE_FAILURE, outQ, NULL, "Invalid exec response from container <%s>: %s", container_name_str.c_str(), exec_response);
+            delete [] exec_response;
+            pool->release(container_id, false);
+            return;
+        }
+        const string exec_id = json["Id"].GetString();
+
+        /* Start Exec - blocks until command completes and returns its multiplexed output */
+        const double run_start = TimeLib::latchtime();
+        const FString start_url("http://localhost/%s/exec/%s/start", DOCKER_API_VERSION, exec_id.c_str());
+        const char* start_response = NULL;
+        int start_response_size = 0;
+        const long start_http_code = CurlLib::request(EndpointObject::POST, start_url.c_str(), "{\"Detach\": false, \"Tty\": false}", &start_response, &start_response_size, false, false, parms->timeout.value, &headers, unix_socket);
+        if(start_http_code == EndpointObject::OK) processContainerLogs(start_response, start_response_size, container_id.c_str());
+        else alert(CRITICAL, RTE_FAILURE, outQ, NULL, "Failed to run command in container <%s>: %ld", container_name_str.c_str(), start_http_code);
+        delete [] start_response;
+
+        /* Inspect Exec - a command still running has timed out */
+        const FString inspect_url("http://localhost/%s/exec/%s/json", DOCKER_API_VERSION, exec_id.c_str());
+        const char* inspect_response = NULL;
+        const long inspect_http_code = CurlLib::request(EndpointObject::GET, inspect_url.c_str(), NULL, &inspect_response, NULL, false, false, CurlLib::DATA_TIMEOUT, NULL, unix_socket);
+        if(inspect_http_code == EndpointObject::OK)
+        {
+            rapidjson::Document inspect_json;
+            inspect_json.Parse(inspect_response);
+            if(!inspect_json.HasParseError() && inspect_json.IsObject() &&
+               inspect_json.HasMember("Running") && inspect_json["Running"].IsBool() && !inspect_json["Running"].GetBool())
+            {
+                const int exit_code = (inspect_json.HasMember("ExitCode") && inspect_json["ExitCode"].IsInt()) ? inspect_json["ExitCode"].GetInt() : -1;
+                alert(INFO, RTE_STATUS, outQ, NULL, "Container <%s> completed with exit code %d in %.3lf seconds", container_name_str.c_str(), exit_code, TimeLib::latchtime() - run_start);
+                healthy = (start_http_code == EndpointObject::OK);
+            }
+            else
+            {
+                alert(ERROR, RTE_FAILURE, outQ, NULL, "Timeout reached for container <%s> after %d seconds", container_name_str.c_str(), parms->timeout.value);
+            }
+        }
+        else
+        {
+            alert(CRITICAL, RTE_FAILURE, outQ, NULL, "Failed to inspect exec in container <%s>: %ld - %s", container_name_str.c_str(), inspect_http_code, inspect_response);
+        }
+        delete [] inspect_response;
+    }
+    delete [] exec_response;
+
+    /* Return Container to Pool (unhealthy containers are removed) */
+    pool->release(container_id, healthy);
+}
+
 /*----------------------------------------------------------------------------
  * processContainerLogs
  *----------------------------------------------------------------------------*/
@@ -40,6 +40,7 @@
 #include "MsgQ.h"
 #include "LuaObject.h"
 #include "CreParameters.h"
+#include "ContainerPool.h"
 
 /******************************************************************************
  * CONTAINER RUNNER CLASS
@@ -62,6 +63,7 @@ class ContainerRunner: public LuaObject
 
         static const char* SANDBOX_MOUNT;
         static const char* HOST_DIRECTORY;
+        static const char* DOCKER_API_VERSION;
 
         /*--------------------------------------------------------------------
          * Methods
@@ -71,6 +73,8 @@ class ContainerRunner: public LuaObject
         static int          luaList             (lua_State* L);
         static int          luaCreateUnique     (lua_State* L);
         static int          luaDeleteUnique     (lua_State* L);
+        static void         checkImage          (const char* image, int timeout, Publisher* outq);
+        static string       buildCommandArray   (const string& command, const char* sandbox_directory=NULL);
 
     private:
 
@@ -91,6 +95,7 @@ class ContainerRunner: public LuaObject
                         ContainerRunner         (lua_State* L, CreParameters* _parms, const char* host_shared_directory, const char* outq_name);
                         ~ContainerRunner        (void) override;
         static void*    controlThread           (void* parm);
+        void            runPooled               (ContainerPool* pool);
         static void     processContainerLogs    (const char* buffer, int buffer_size, const char* id);
         static string   authenticateToDocker    (void);
 };
@@ -35,7 +35,11 @@
 
 #include "OsApi.h"
 #include "ContainerRunner.h"
+#include "ContainerPool.h"
 #include "CreParameters.h"
+#ifdef __unittesting__
+#include "UT_ContainerPool.h"
+#endif
 
 /******************************************************************************
  * DEFINES
@@ -57,7 +61,12 @@ int cre_open (lua_State* L)
         {"list",        ContainerRunner::luaList},
         {"createunique",ContainerRunner::luaCreateUnique},
         {"deleteunique",ContainerRunner::luaDeleteUnique},
+        {"pool",        ContainerPool::luaConfigure},
+        {"poolstats",   ContainerPool::luaStats},
         {"parms",       luaCreateParameters<CreParameters>},
+#ifdef __unittesting__
+        {"ut_pool",     UT_ContainerPool::luaCreate},
+#endif
         {NULL,          NULL}
     };
 
@@ -78,6 +87,9 @@ int cre_open (lua_State* L)
 extern "C" {
 void initcre (void)
 {
+    /* Initialize Modules */
+    ContainerPool::init();
+
     /* Extend Lua */
     LuaEngine::extend(LUA_CRE_LIBNAME, cre_open, LIBID);
 
@@ -87,5 +99,6 @@ void initcre (void)
 
 void deinitcre (void)
 {
+    ContainerPool::deinit();
 }
 }
@@ -0,0 +1,29 @@
+local runner = require("test_executive")
+
+-- Requirements --
+
+if not core.UNITTEST then
+    return runner.skip()
+end
+
+-- Setup --
+
+local ut_pool = cre.ut_pool()
+
+-- Self Test --
+
+runner.unittest("ContainerPool Reuse", function()
+    runner.assert(ut_pool:reuse(), "Failed container pool reuse test")
+end)
+
+runner.unittest("ContainerPool Reset", function()
+    runner.assert(ut_pool:reset(), "Failed container pool reset test")
+end)
+
+runner.unittest("ContainerPool Invalid Responses", function()
+    runner.assert(ut_pool:invalid(), "Failed container pool invalid response test")
+end)
+
+-- Report Results --
+
+runner.report()
@@ -0,0 +1,515 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "OsApi.h"
+#include "EventLib.h"
+#include "StringLib.h"
+#include "SystemConfig.h"
+#include "UT_ContainerPool.h"
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_ContainerPool::OBJECT_TYPE = "UT_ContainerPool";
+const char* UT_ContainerPool::LUA_META_NAME = "UT_ContainerPool";
+const struct luaL_Reg UT_ContainerPool::LUA_META_TABLE[] = {
+    {"reuse",           luaReuseTest},
+    {"reset",           luaResetTest},
+    {"invalid",         luaInvalidTest},
+    {NULL,              NULL}
+};
+
+const char* UT_ContainerPool::TEST_IMAGE = "ut/pool";
+
+/******************************************************************************
+ * CLASS METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * luaCreate - :UT_ContainerPool()
+ *----------------------------------------------------------------------------*/
+int UT_ContainerPool::luaCreate (lua_State* L)
+{
+    try
+    {
+        return createLuaObject(L, new UT_ContainerPool(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_ContainerPool::UT_ContainerPool (lua_State* L):
+    LuaObject(L, OBJECT_TYPE, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor  -
+ *----------------------------------------------------------------------------*/
+UT_ContainerPool::~UT_ContainerPool(void) = default;
+
+/*----------------------------------------------------------------------------
+ * waitIdle - waits for the maintenance thread to warm the pool
+ *----------------------------------------------------------------------------*/
+bool UT_ContainerPool::waitIdle (ContainerPool* pool, int count)
+{
+    for(int ms = 0; ms < WARM_TIMEOUT_MS; ms += 100)
+    {
+        pool->poolMut.lock();
+        const int idle_count = pool->idle.size();
+        pool->poolMut.unlock();
+        if(idle_count >= count) return true;
+        OsApi::sleep(0.1);
+    }
+    mlog(CRITICAL, "Timed out waiting for %d idle containers", count);
+    return false;
+}
+
+/*----------------------------------------------------------------------------
+ * luaReuseTest - :reuse()
+ *----------------------------------------------------------------------------*/
+int UT_ContainerPool::luaReuseTest (lua_State* L)
+{
+    bool status = true;
+    const string docker_socket = SystemConfig::settings().dockerSocket.value;
+    const FString path("/tmp/ut_docker.%d.sock", getpid());
+
+    FakeDocker* docker = new FakeDocker(path.c_str());
+    SystemConfig::settings().dockerSocket = path.c_str();
+    ContainerPool* pool = new ContainerPool(TEST_IMAGE, 1, 3, ContainerPool::DEFAULT_IDLE_COMMAND);
+
+    if(waitIdle(pool, 1))
+    {
+        /* containers are unprivileged with a read-only root and a tmpfs scratch directory */
+        const string create = docker->lastCreate();
+        if(create.find("\"User\": \"65534:65534\"") == string::npos ||
+           create.find("\"ReadonlyRootfs\": true") == string::npos ||
+           create.find("\"Tmpfs\": {\"/tmp\"") == string::npos ||
+           create.find("\"CapDrop\": [\"ALL\"]") == string::npos)
+        {
+            mlog(CRITICAL, "Pooled container not hardened: %s", create.c_str());
+            status = false;
+        }
+
+        /* keep the maintenance thread from replacing leased containers */
+        docker->mut.lock();
+        docker->failCreate = true;
+        docker->mut.unlock();
+
+        /* leased container is reset and returned until max runs */
+        string first_id;
+        for(int run = 1; run <= 3 && status; run++)
+        {
+            string container_id;
+            if(!pool->lease(container_id, 1))
+            {
+                mlog(CRITICAL, "Failed to lease container on run %d", run);
+                status = false;
+                break;
+            }
+            if(run == 1) first_id = container_id;
+            else if(container_id != first_id)
+            {
+                mlog(CRITICAL, "Container not reused on run %d: %s != %s", run, container_id.c_str(), first_id.c_str());
+                status = false;
+            }
+
+            pool->release(container_id, true);
+
+            const long resets = docker->count("POST /exec/reset");
+            pool->poolMut.lock();
+            const int idle_count = pool->idle.size();
+            const long recycled = pool->stats.recycled;
+            pool->poolMut.unlock();
+            if(run < 3 && (resets != run || idle_count != 1 || recycled != 0))
+            {
+                mlog(CRITICAL, "Container not reset and returned on run %d: %ld resets, %d idle, %ld recycled", run, resets, idle_count, recycled);
+                status = false;
+            }
+            else if(run == 3 && (resets != 2 || idle_count != 0 || recycled != 1 || docker->count("DELETE /containers/") != 1))
+            {
+                mlog(CRITICAL, "Container not recycled after max runs: %ld resets, %d idle, %ld recycled", resets, idle_count, recycled);
+                status = false;
+            }
+        }
+    }
+    else
+    {
+        status = false;
+    }
+
+    delete pool;
+    SystemConfig::settings().dockerSocket = docker_socket;
+    delete docker;
+
+    lua_pushboolean(L, status);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaResetTest - :reset()
+ *----------------------------------------------------------------------------*/
+int UT_ContainerPool::luaResetTest (lua_State* L)
+{
+    bool status = true;
+    const string docker_socket = SystemConfig::settings().dockerSocket.value;
+    const FString path("/tmp/ut_docker.%d.sock", getpid());
+
+    FakeDocker* docker = new FakeDocker(path.c_str());
+    SystemConfig::settings().dockerSocket = path.c_str();
+    ContainerPool* pool = new ContainerPool(TEST_IMAGE, 1, ContainerPool::DEFAULT_MAX_RUNS, ContainerPool::DEFAULT_IDLE_COMMAND);
+
+    /* leftover process, failed scratch reset, and unhealthy run are never reused */
+    for(int scenario = 0; scenario < 3 && status; scenario++)
+    {
+        docker->mut.lock();
+        docker->failCreate = false;
+        docker->numProcesses = (scenario == 0) ? 2 : 1;
+        docker->resetExitCode = (scenario == 1) ? 1 : 0;
+        docker->mut.unlock();
+
+        if(!waitIdle(pool, 1))
+        {
+            status = false;
+            break;
+        }
+
+        docker->mut.lock();
+        docker->failCreate = true;
+        docker->mut.unlock();
+
+        string container_id;
+        if(!pool->lease(container_id, 1))
+        {
+            mlog(CRITICAL, "Failed to lease container in scenario %d", scenario);
+            status = false;
+            break;
+        }
+
+        const long deletes = docker->count("DELETE /containers/");
+        pool->release(container_id, scenario != 2);
+
+        pool->poolMut.lock();
+        const bool returned = !pool->idle.empty() && (pool->idle.back().id == container_id);
+        const long reset_failures = pool->stats.resetFailures;
+        pool->poolMut.unlock();
+
+        const long expected_failures = MIN(scenario + 1, 2);
+        if(returned || docker->count("DELETE /containers/") != deletes + 1 || reset_failures != expected_failures)
+        {
+            mlog(CRITICAL, "Container reused in scenario %d: %ld reset failures", scenario, reset_failures);
+            status = false;
+        }
+    }
+
+    /* only the container that passed the process check was reset */
+    if(status && docker->count("POST /exec/reset") != 1)
+    {
+        mlog(CRITICAL, "Scratch directory reset attempted after failed process check or unhealthy run");
+        status = false;
+    }
+
+    delete pool;
+    SystemConfig::settings().dockerSocket = docker_socket;
+    delete docker;
+
+    lua_pushboolean(L, status);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaInvalidTest - :invalid()
+ *----------------------------------------------------------------------------*/
+int UT_ContainerPool::luaInvalidTest (lua_State* L)
+{
+    bool status = true;
+    const string docker_socket = SystemConfig::settings().dockerSocket.value;
+    const FString path("/tmp/ut_docker.%d.sock", getpid());
+
+    FakeDocker* docker = new FakeDocker(path.c_str());
+    SystemConfig::settings().dockerSocket = path.c_str();
+    docker->failCreate = true;
+    ContainerPool* pool = new ContainerPool(TEST_IMAGE, 0, ContainerPool::DEFAULT_MAX_RUNS, ContainerPool::DEFAULT_IDLE_COMMAND);
+
+    /* create response without a container id */
+    string container_id;
+    if(pool->startContainer(container_id) || pool->stats.failures != 1)
+    {
+        mlog(CRITICAL, "Started container without an id: %ld failures", pool->stats.failures);
+        status = false;
+    }
+
+    /* exec response without an exec id */
+    docker->mut.lock();
+    docker->failExec = true;
+    docker->mut.unlock();
+    if(ContainerPool::execCommand("c0", "true", 1) != -1)
+    {
+        mlog(CRITICAL, "Ran command without an exec id");
+        status = false;
+    }
+
+    /* exec exit code returned */
+    docker->mut.lock();
+    docker->failExec = false;
+    docker->resetExitCode = 3;
+    docker->mut.unlock();
+    const int exit_code = ContainerPool::execCommand("c0", ContainerPool::RESET_COMMAND, 1);
+    if(exit_code != 3)
+    {
+        mlog(CRITICAL, "Mismatched exit code: %d", exit_code);
+        status = false;
+    }
+
+    delete pool;
+    SystemConfig::settings().dockerSocket = docker_socket;
+    delete docker;
+
+    lua_pushboolean(L, status);
+    return 1;
+}
+
+/******************************************************************************
+ * FAKE DOCKER METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * FakeDocker Constructor
+ *----------------------------------------------------------------------------*/
+UT_ContainerPool::FakeDocker::FakeDocker (const char* _path):
+    failCreate(false),
+    failExec(false),
+    numProcesses(1),
+    resetExitCode(0),
+    path(_path),
+    sock(-1),
+    active(true),
+    pid(NULL),
+    nextId(0)
+{
+    unlink(_path);
+    sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    StringLib::copy(addr.sun_path, _path, sizeof(addr.sun_path));
+    if(sock < 0 || bind(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 || listen(sock, 16) != 0)
+    {
+        mlog(CRITICAL, "Failed to serve fake docker socket %s", _path);
+    }
+    pid = new Thread(serverThread, this);
+}
+
+/*----------------------------------------------------------------------------
+ * FakeDocker Destructor
+ *----------------------------------------------------------------------------*/
+UT_ContainerPool::FakeDocker::~FakeDocker (void)
+{
+    active = false;
+    delete pid;
+    if(sock >= 0) close(sock);
+    unlink(path.c_str());
+}
+
+/*----------------------------------------------------------------------------
+ * FakeDocker::count - number of requests starting with the supplied request
+ *----------------------------------------------------------------------------*/
+long UT_ContainerPool::FakeDocker::count (const char* request)
+{
+    long n = 0;
+    const size_t len = StringLib::size(request);
+    mut.lock();
+    for(const string& r: requests)
+    {
+        if(r.compare(0, len, request) == 0) n++;
+    }
+    mut.unlock();
+    return n;
+}
+
+/*----------------------------------------------------------------------------
+ * FakeDocker::lastCreate - body of the last create container request
+ *----------------------------------------------------------------------------*/
+string UT_ContainerPool::FakeDocker::lastCreate (void)
+{
+    mut.lock();
+    const string body = createBody;
+    mut.unlock();
+    return body;
+}
+
+/*----------------------------------------------------------------------------
+ * FakeDocker::serverThread
+ *----------------------------------------------------------------------------*/
+void* UT_ContainerPool::FakeDocker::serverThread (void* parm)
+{
+    FakeDocker* docker = static_cast<FakeDocker*>(parm);
+    while(docker->active)
+    {
+        struct pollfd pfd = {docker->sock, POLLIN, 0};
+        if(poll(&pfd, 1, 100) > 0)
+        {
+            const int client = accept(docker->sock, NULL, NULL);
+            if(client >= 0)
+            {
+                docker->handle(client);
+                close(client);
+            }
+        }
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * FakeDocker::handle - serves one request per connection
+ *----------------------------------------------------------------------------*/
+void UT_ContainerPool::FakeDocker::handle (int client)
+{
+    /* Read Header */
+    string request;
+    char buf[4096];
+    size_t header_end = string::npos;
+    while(header_end == string::npos)
+    {
+        const ssize_t n = recv(client, buf, sizeof(buf), 0);
+        if(n <= 0) return;
+        request.append(buf, n);
+        header_end = request.find("\r\n\r\n");
+    }
+
+    /* Read Body */
+    long content_length = 0;
+    const size_t cl = request.find("Content-Length: ");
+    if(cl != string::npos && cl < header_end) content_length = strtol(request.c_str() + cl + 16, NULL, 10);
+    const size_t ex = request.find("Expect: 100-continue");
+    if(ex != string::npos && ex < header_end)
+    {
+        const char* cont = "HTTP/1.1 100 Continue\r\n\r\n";
+        send(client, cont, strlen(cont), MSG_NOSIGNAL);
+    }
+    while(static_cast<long>(request.size() - (header_end + 4)) < content_length)
+    {
+        const ssize_t n = recv(client, buf, sizeof(buf), 0);
+        if(n <= 0) return;
+        request.append(buf, n);
+    }
+    const string body = request.substr(header_end + 4);
+
+    /* Parse Request Line - strip the api version from the path */
+    const size_t sp1 = request.find(' ');
+    const size_t sp2 = request.find(' ', sp1 + 1);
+    const string verb = request.substr(0, sp1);
+    string url = request.substr(sp1 + 1, sp2 - sp1 - 1);
+    const size_t api = url.find('/', 1);
+    if(api != string::npos) url = url.substr(api);
+
+    /* Build Response */
+    int code = 404;
+    string rsps;
+    mut.lock();
+    {
+        string entry = verb + " " + url;
+        if(verb == "GET" && url.compare(0, 8, "/images/") == 0)
+        {
+            code = 200;
+            rsps = "{}";
+        }
+        else if(verb == "POST" && url == "/containers/create")
+        {
+            createBody = body;
+            code = 201;
+            rsps = failCreate ? "{\"Warnings\": []}" : FString("{\"Id\": \"c%ld\"}", nextId++).c_str();
+        }
+        else if(verb == "POST" && url.find("/exec") != string::npos && url.compare(0, 12, "/containers/") == 0)
+        {
+            const bool reset = body.find("\"find\"") != string::npos;
+            const string exec_id = FString("%s%ld", reset ? "reset" : "e", nextId++).c_str();
+            if(reset) resetExecs.add(exec_id.c_str(), true);
+            code = 201;
+            rsps = failExec ? "[]" : FString("{\"Id\": \"%s\"}", exec_id.c_str()).c_str();
+        }
+        else if(verb == "POST" && url.compare(0, 12, "/containers/") == 0)
+        {
+            code = 204; // start
+        }
+        else if(verb == "GET" && url.compare(0, 12, "/containers/") == 0)
+        {
+            code = 200; // top
+            rsps = "{\"Titles\": [\"PID\", \"CMD\"], \"Processes\": [";
+            for(int p = 0; p < numProcesses; p++)
+            {
+                rsps += FString("%s[\"%d\", \"sleep\"]", p > 0 ? ", " : "", p + 1).c_str();
+            }
+            rsps += "]}";
+        }
+        else if(verb == "POST" && url.compare(0, 6, "/exec/") == 0)
+        {
+            code = 200; // start exec, no output
+        }
+        else if(verb == "GET" && url.compare(0, 6, "/exec/") == 0)
+        {
+            const string exec_id = url.substr(6, url.find('/', 6) - 6);
+            const int exit_code = resetExecs.find(exec_id.c_str()) ? resetExitCode : 0;
+            code = 200;
+            rsps = FString("{\"Running\": false, \"ExitCode\": %d}", exit_code).c_str();
+        }
+        else if(verb == "DELETE" && url.compare(0, 12, "/containers/") == 0)
+        {
+            code = 204;
+        }
+        requests.push_back(entry);
+    }
+    mut.unlock();
+
+    /* Send Response */
+    const char* reason = (code == 200) ? "OK" : (code == 201) ? "Created" : (code == 204) ? "No Content" : "Not Found";
+    string response = FString("HTTP/1.1 %d %s\r\nConnection: close\r\n", code, reason).c_str();
+    if(code != 204) response += FString("Content-Type: application/json\r\nContent-Length: %ld\r\n", static_cast<long>(rsps.size())).c_str();
+    response += "\r\n";
+    response += rsps;
+    send(client, response.c_str(), response.size(), MSG_NOSIGNAL);
+}
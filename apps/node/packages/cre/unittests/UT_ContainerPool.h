@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ut_container_pool__
+#define __ut_container_pool__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "LuaObject.h"
+#include "ContainerPool.h"
+
+/******************************************************************************
+ * CLASS
+ ******************************************************************************/
+
+class UT_ContainerPool: public LuaObject
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const char* OBJECT_TYPE;
+
+        static const char* LUA_META_NAME;
+        static const struct luaL_Reg LUA_META_TABLE[];
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static int  luaCreate   (lua_State* L);
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const char* TEST_IMAGE;
+        static const int WARM_TIMEOUT_MS = 10000;
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        /* Fake Docker Engine API - serves a unix socket with canned responses */
+        class FakeDocker
+        {
+            public:
+
+                explicit FakeDocker     (const char* _path);
+                ~FakeDocker             (void);
+                long count              (const char* request);
+                string lastCreate       (void);
+
+                Mutex           mut;
+                bool            failCreate;         // create responses have no container id
+                bool            failExec;           // exec responses have no exec id
+                int             numProcesses;       // processes listed by top
+                int             resetExitCode;      // exit code of the scratch directory reset
+
+            private:
+
+                static void*    serverThread    (void* parm);
+                void            handle          (int client);
+
+                string          path;
+                int             sock;
+                bool            active;
+                Thread*         pid;
+                long            nextId;
+                vector<string>  requests;           // "<verb> <path>" of each request
+                string          createBody;
+                Dictionary<bool> resetExecs;        // exec ids that reset the scratch directory
+        };
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        explicit UT_ContainerPool (lua_State* L);
+                ~UT_ContainerPool (void) override;
+
+        static bool waitIdle        (ContainerPool* pool, int count);
+        static int  luaReuseTest    (lua_State* L);
+        static int  luaResetTest    (lua_State* L);
+        static int  luaInvalidTest  (lua_State* L);
+};
+
+#endif  /* __ut_container_pool__ */
@@ -40,6 +40,7 @@
 #include "OsApi.h"
 #include "TimeLib.h"
 #include "RasterObject.h"
+#include "SystemConfig.h"
 #include "DataFrameSampler.h"
 
 /******************************************************************************
@@ -52,6 +53,10 @@ const struct luaL_Reg DataFrameSampler::LUA_META_TABLE[] = {
     {NULL,          NULL}
 };
 
+Cond DataFrameSampler::collectionSignal;
+int DataFrameSampler::activeCollections = 0;
+FrameRunnerPool::Client DataFrameSampler::collectionPool;
+
 /******************************************************************************
  * METHODS
  ******************************************************************************/
@@ -145,15 +150,21 @@ bool DataFrameSampler::run (GeoDataFrame* dataframe)
         return false;
     }
 
-    // get samples for all user RasterObjects
+    // sample all raster collections concurrently (each writes only to its own sampler_info_t)
     for(sampler_info_t* sampler: samplers)
     {
         sampler->robj->setCRS(frame_crs);
+    }
+    collectionPool.setLimit(MAX(SystemConfig::settings().rasterCollectionLimit.value, 1));
+    if(!collectionPool.run(sampleCollections, &samplers, samplers.size(), 1))
+    {
+        mlog(CRITICAL, "Failed to sample raster collections");
+        return false;
+    }
 
-        // sample the rasters
-        sampler->robj->getSamples(sampler->obj->points, sampler->samples);
-
-        // put samples into dataframe columns
+    // put samples into dataframe columns
+    for(sampler_info_t* sampler: samplers)
+    {
         if(sampler->geoparms.force_single_sample.value != GeoFields::SINGLE_SAMPLE_NA)
         {
             populateColumns(dataframe, sampler);
@@ -169,6 +180,12 @@ bool DataFrameSampler::run (GeoDataFrame* dataframe)
             mlog(CRITICAL, "Faled to populate file id table");
         }
 
+        // add sampling time metadata
+        if(!populateRunTime(dataframe, sampler))
+        {
+            mlog(ERROR, "Failed to populate sampling time for <%s>", sampler->rkey);
+        }
+
         // release since not needed anymore
         sampler->samples.clear();
     }
@@ -177,6 +194,61 @@ bool DataFrameSampler::run (GeoDataFrame* dataframe)
     return true;
 }
 
+/*----------------------------------------------------------------------------
+ * sampleCollections
+ *
+ *  runs on the frame runner pool; the pool client and the collection slots
+ *  share the node wide limit so workers only join while slots are free
+ *----------------------------------------------------------------------------*/
+void DataFrameSampler::sampleCollections (void* context, long start, long count)
+{
+    const vector<sampler_info_t*>& samplers = *static_cast<const vector<sampler_info_t*>*>(context);
+    for(long i = start; i < start + count; i++)
+    {
+        sampler_info_t* sampler = samplers[i];
+
+        // wait for room under the node wide collection limit
+        const collection_slot_t slot;
+
+        // sample the rasters
+        const double start_time = TimeLib::latchtime();
+        sampler->robj->getSamples(sampler->obj->points, sampler->samples);
+        sampler->runtime = TimeLib::latchtime() - start_time;
+        mlog(INFO, "Sampled %u points from <%s> in %.3lf seconds", sampler->samples.numPoints(), sampler->rkey, sampler->runtime);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * collection_slot_t - constructor
+ *----------------------------------------------------------------------------*/
+DataFrameSampler::collection_slot_t::collection_slot_t (void)
+{
+    collectionSignal.lock();
+    {
+        while(activeCollections >= MAX(SystemConfig::settings().rasterCollectionLimit.value, 1))
+        {
+            collectionSignal.wait(0, SYS_TIMEOUT);
+        }
+        activeCollections++;
+    }
+    collectionSignal.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * collection_slot_t - destructor
+ *
+ *  releases the slot even when sampling throws
+ *----------------------------------------------------------------------------*/
+DataFrameSampler::collection_slot_t::~collection_slot_t (void)
+{
+    collectionSignal.lock();
+    {
+        activeCollections--;
+        collectionSignal.signal(0, Cond::NOTIFY_ONE);
+    }
+    collectionSignal.unlock();
+}
+
 /*----------------------------------------------------------------------------
  * populatePoints
  *----------------------------------------------------------------------------*/
@@ -278,10 +350,16 @@ bool DataFrameSampler::populateMultiColumns (GeoDataFrame* dataframe, sampler_in
         aspect_column   = new FieldColumn<FieldList<double>>(Field::NESTED_LIST);
     }
 
-    // iterate over each sample in a vector of lists of samples
-    for(int i = 0; i < sampler->samples.length(); i++)
+    // translate interned band names to band index
+    const RasterSampleBuffer& samples = sampler->samples;
+    vector<uint16_t> band_map;
+    getBandMap(sampler, band_map);
+
+    // iterate over the samples of each point
+    for(uint32_t i = 0; i < samples.numPoints(); i++)
     {
-        sample_list_t* slist = sampler->samples[i];
+        const uint32_t start = samples.pointStart(i);
+        const uint32_t end = samples.pointEnd(i);
 
         // populate core sample fields
         FieldList<double> value_list;
@@ -289,19 +367,13 @@ bool DataFrameSampler::populateMultiColumns (GeoDataFrame* dataframe, sampler_in
         FieldList<uint64_t> fileid_list;
         FieldList<uint32_t> flags_list;
         FieldList<uint16_t> band_list;
-        for(int j = 0; j < slist->length(); j++)
+        for(uint32_t j = start; j < end; j++)
         {
-            const RasterSample* sample = slist->get(j);
-            value_list.append(sample->value);
-            time_list.append(TimeLib::gps2systimeex(sample->time));
-            fileid_list.append(sample->fileId);
-            if(flags_column) flags_list.append(sample->flags);
-            if(band_column)
-            {
-                uint16_t index = 0xFFFF;
-                sampler->obj->bandIndex.find(sample->bandName.c_str(), &index);
-                band_list.append(index);
-            }
+            value_list.append(samples.value[j]);
+            time_list.append(TimeLib::gps2systimeex(samples.time[j]));
+            fileid_list.append(samples.fileId[j]);
+            if(flags_column) flags_list.append(samples.flags[j]);
+            if(band_column) band_list.append(bandOf(samples, band_map, j));
         }
         value_column->append(value_list);
         time_column->append(time_list);
@@ -319,16 +391,15 @@ bool DataFrameSampler::populateMultiColumns (GeoDataFrame* dataframe, sampler_in
             FieldList<double> median_list;
             FieldList<double> stdev_list;
             FieldList<double> mad_list;
-            for(int j = 0; j < slist->length(); j++)
+            for(uint32_t j = start; j < end; j++)
             {
-                const RasterSample* sample = slist->get(j);
-                count_list.append(sample->stats.count);
-                min_list.append(sample->stats.min);
-                max_list.append(sample->stats.max);
-                mean_list.append(sample->stats.mean);
-                median_list.append(sample->stats.median);
-                stdev_list.append(sample->stats.stdev);
-                mad_list.append(sample->stats.mad);
+                count_list.append(samples.statsCount[j]);
+                min_list.append(samples.statsMin[j]);
+                max_list.append(samples.statsMax[j]);
+                mean_list.append(samples.statsMean[j]);
+                median_list.append(samples.statsMedian[j]);
+                stdev_list.append(samples.statsStdev[j]);
+                mad_list.append(samples.statsMad[j]);
             }
             assert(count_column);   count_column->append(count_list);
             assert(min_column);     min_column->append(min_list);
@@ -345,12 +416,11 @@ bool DataFrameSampler::populateMultiColumns (GeoDataFrame* dataframe, sampler_in
             FieldList<uint32_t> scount_list;
             FieldList<double> slope_list;
             FieldList<double> aspect_list;
-            for(int j = 0; j < slist->length(); j++)
+            for(uint32_t j = start; j < end; j++)
             {
-                const RasterSample* sample = slist->get(j);
-                scount_list.append(sample->derivs.count);
-                slope_list.append(sample->derivs.slopeDeg);
-                aspect_list.append(sample->derivs.aspectDeg);
+                scount_list.append(samples.derivsCount[j]);
+                slope_list.append(samples.derivsSlope[j]);
+                aspect_list.append(samples.derivsAspect[j]);
             }
             assert(scount_column);  scount_column->append(scount_list);
             assert(slope_column);   slope_column->append(slope_list);
@@ -427,26 +497,32 @@ bool DataFrameSampler::populateColumns (GeoDataFrame* dataframe, sampler_info_t*
         aspect_column   = new FieldColumn<double>;
     }
 
-    // iterate over each sample in a vector of lists of samples
-    for(int i = 0; i < sampler->samples.length(); i++)
+    // translate interned band names to band index
+    const RasterSampleBuffer& samples = sampler->samples;
+    vector<uint16_t> band_map;
+    getBandMap(sampler, band_map);
+
+    // iterate over the samples of each point
+    for(uint32_t i = 0; i < samples.numPoints(); i++)
     {
-        sample_list_t* slist = sampler->samples[i];
+        const uint32_t start = samples.pointStart(i);
+        const uint32_t end = samples.pointEnd(i);
 
-        if( (slist->length() > 0) &&
+        if( (end > start) &&
             (sampler->geoparms.force_single_sample.value != GeoFields::SINGLE_SAMPLE_MEAN) &&
             (sampler->geoparms.force_single_sample.value != GeoFields::SINGLE_SAMPLE_MEDIAN) )
         {
             // select the sample
-            const RasterSample* sample = slist->get(0); // default/initialize to first
+            uint32_t j = start; // default/initialize to first
             switch(sampler->geoparms.force_single_sample.value)
             {
                 case GeoFields::SINGLE_SAMPLE_FIRST:
                 {
-                    for(int k = 0; k < slist->length(); k++)
+                    for(uint32_t k = start; k < end; k++)
                     {
-                        if(std::isfinite(slist->get(k)->value))
+                        if(std::isfinite(samples.value[k]))
                         {
-                            sample = slist->get(k);
+                            j = k;
                             break; // don't look for any more
                         }
                     }
@@ -455,11 +531,11 @@ bool DataFrameSampler::populateColumns (GeoDataFrame* dataframe, sampler_info_t*
 
                 case GeoFields::SINGLE_SAMPLE_LAST:
                 {
-                    for(int k = 0; k < slist->length(); k++)
+                    for(uint32_t k = start; k < end; k++)
                     {
-                        if(std::isfinite(slist->get(k)->value))
+                        if(std::isfinite(samples.value[k]))
                         {
-                            sample = slist->get(k);
+                            j = k;
                             // keep looking to get the last one
                         }
                     }
@@ -469,13 +545,13 @@ bool DataFrameSampler::populateColumns (GeoDataFrame* dataframe, sampler_info_t*
                 case GeoFields::SINGLE_SAMPLE_MIN:
                 {
                     double min_val = std::numeric_limits<double>::max();
-                    for(int k = 0; k < slist->length(); k++)
+                    for(uint32_t k = start; k < end; k++)
                     {
-                        const double val = slist->get(k)->value;
+                        const double val = samples.value[k];
                         if(std::isfinite(val) && (val <= min_val)) // equal comparison needed if initial value is NaN
                         {
                             min_val = val;
-                            sample = slist->get(k);
+                            j = k;
                         }
                     }
                     break;
@@ -484,13 +560,13 @@ bool DataFrameSampler::populateColumns (GeoDataFrame* dataframe, sampler_info_t*
                 case GeoFields::SINGLE_SAMPLE_MAX:
                 {
                     double max_val = std::numeric_limits<double>::lowest();
-                    for(int k = 0; k < slist->length(); k++)
+                    for(uint32_t k = start; k < end; k++)
                     {
-                        const double val = slist->get(k)->value;
+                        const double val = samples.value[k];
                         if(std::isfinite(val) && (val >= max_val)) // equal comparison needed if initial value is NaN
                         {
                             max_val = val;
-                            sample = slist->get(k);
+                            j = k;
                         }
                     }
                     break;
@@ -500,65 +576,58 @@ bool DataFrameSampler::populateColumns (GeoDataFrame* dataframe, sampler_info_t*
             }
 
             // populate core sample fields
-            value_column->append(sample->value);
-            time_column->append(TimeLib::gps2systimeex(sample->time));
-            fileid_column->append(sample->fileId);
-            if(flags_column) flags_column->append(sample->flags);
-            if(band_column)
-            {
-                uint16_t index = 0xFFFF;
-                sampler->obj->bandIndex.find(sample->bandName.c_str(), &index);
-                band_column->append(index);
-            }
+            value_column->append(samples.value[j]);
+            time_column->append(TimeLib::gps2systimeex(samples.time[j]));
+            fileid_column->append(samples.fileId[j]);
+            if(flags_column) flags_column->append(samples.flags[j]);
+            if(band_column) band_column->append(bandOf(samples, band_map, j));
 
             // populate zonal stats fields
             if(sampler->robj->hasZonalStats())
             {
-                assert(count_column);   count_column->append(sample->stats.count);
-                assert(min_column);     min_column->append(sample->stats.min);
-                assert(max_column);     max_column->append(sample->stats.max);
-                assert(mean_column);    mean_column->append(sample->stats.mean);
-                assert(median_column);  median_column->append(sample->stats.median);
-                assert(stdev_column);   stdev_column->append(sample->stats.stdev);
-                assert(mad_column);     mad_column->append(sample->stats.mad);
+                assert(count_column);   count_column->append(samples.statsCount[j]);
+                assert(min_column);     min_column->append(samples.statsMin[j]);
+                assert(max_column);     max_column->append(samples.statsMax[j]);
+                assert(mean_column);    mean_column->append(samples.statsMean[j]);
+                assert(median_column);  median_column->append(samples.statsMedian[j]);
+                assert(stdev_column);   stdev_column->append(samples.statsStdev[j]);
+                assert(mad_column);     mad_column->append(samples.statsMad[j]);
             }
 
             // populate slope derivative fields
             if(sampler->robj->hasSpatialDerivs())
             {
-                assert(scount_column);  scount_column->append(sample->derivs.count);
-                assert(slope_column);   slope_column->append(sample->derivs.slopeDeg);
-                assert(aspect_column);  aspect_column->append(sample->derivs.aspectDeg);
+                assert(scount_column);  scount_column->append(samples.derivsCount[j]);
+                assert(slope_column);   slope_column->append(samples.derivsSlope[j]);
+                assert(aspect_column);  aspect_column->append(samples.derivsAspect[j]);
             }
         }
         else
         {
             // populate value
-            if((slist->length() > 0) && (sampler->geoparms.force_single_sample.value == GeoFields::SINGLE_SAMPLE_MEAN))
+            if((end > start) && (sampler->geoparms.force_single_sample.value == GeoFields::SINGLE_SAMPLE_MEAN))
             {
                 double mean_value = 0.0;
                 double mean_cnt = 0;
-                for(int k = 0; k < slist->length(); k++)
+                for(uint32_t k = start; k < end; k++)
                 {
-                    const RasterSample* sample = slist->get(k);
-                    if(std::isfinite(sample->value))
+                    if(std::isfinite(samples.value[k]))
                     {
-                        mean_value += sample->value;
+                        mean_value += samples.value[k];
                         mean_cnt += 1;
                     }
                 }
                 if(mean_cnt > 0) value_column->append(mean_value / mean_cnt);
                 else value_column->append(std::numeric_limits<double>::quiet_NaN());
             }
-            else if((slist->length() > 0) && (sampler->geoparms.force_single_sample.value == GeoFields::SINGLE_SAMPLE_MEDIAN))
+            else if((end > start) && (sampler->geoparms.force_single_sample.value == GeoFields::SINGLE_SAMPLE_MEDIAN))
             {
                 vector<double> values;
-                for(int k = 0; k < slist->length(); k++)
+                for(uint32_t k = start; k < end; k++)
                 {
-                    const RasterSample* sample = slist->get(k);
-                    if(std::isfinite(sample->value))
+                    if(std::isfinite(samples.value[k]))
                     {
-                        values.push_back(sample->value);
+                        values.push_back(samples.value[k]);
                     }
                 }
                 if(!values.empty())
@@ -626,6 +695,29 @@ bool DataFrameSampler::populateColumns (GeoDataFrame* dataframe, sampler_info_t*
     return true;
 }
 
+/*----------------------------------------------------------------------------
+ * getBandMap - band index of each band name interned in sampler's results
+ *----------------------------------------------------------------------------*/
+void DataFrameSampler::getBandMap (const sampler_info_t* sampler, vector<uint16_t>& band_map)
+{
+    for(const string& name: sampler->samples.bandNames)
+    {
+        uint16_t index = RasterSampleBuffer::NO_BAND;
+        sampler->obj->bandIndex.find(name.c_str(), &index);
+        band_map.push_back(index);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * bandOf - band index of the j-th sample
+ *----------------------------------------------------------------------------*/
+uint16_t DataFrameSampler::bandOf (const RasterSampleBuffer& samples, const vector<uint16_t>& band_map, uint32_t j)
+{
+    const uint16_t band = samples.band[j];
+    if(band == RasterSampleBuffer::NO_BAND) return 0xFFFF;
+    return band_map[band];
+}
+
 /*----------------------------------------------------------------------------
  * populateFileIds
  *----------------------------------------------------------------------------*/
@@ -668,3 +760,22 @@ bool DataFrameSampler::populateFileIds (GeoDataFrame* dataframe, sampler_info_t*
     // success
     return true;
 }
+
+/*----------------------------------------------------------------------------
+ * populateRunTime
+ *----------------------------------------------------------------------------*/
+bool DataFrameSampler::populateRunTime (GeoDataFrame* dataframe, sampler_info_t* sampler)
+{
+    FieldElement<double>* field = new FieldElement<double>(sampler->runtime);
+
+    // add sampling time metadata entry for raster
+    const FString key("%s.%s.runtime", GeoFields::PARMS, sampler->rkey);
+    if(!dataframe->addMetaData(key.c_str(), field, StringLib::duplicate("Time (seconds) spent sampling raster"), true))
+    {
+        delete field;
+        return false;
+    }
+
+    // success
+    return true;
+}
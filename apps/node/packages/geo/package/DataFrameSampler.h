@@ -40,6 +40,7 @@
 #include "RequestParameters.h"
 #include "RasterObject.h"
 #include "OsApi.h"
+#include "FrameRunnerPool.h"
 
 #include <set>
 
@@ -74,13 +75,15 @@ class DataFrameSampler: public GeoDataFrame::FrameRunner
             RasterObject* robj;
             DataFrameSampler* obj;
             const GeoFields& geoparms;
-            List<sample_list_t*> samples;
+            RasterSampleBuffer samples;
             vector<std::pair<uint64_t, const char*>> filemap;
+            double runtime; // seconds spent sampling this collection
             sampler_info_t (const char* _rkey, RasterObject* _robj, DataFrameSampler* _obj, const GeoFields& _geoparms):
                 rkey(StringLib::duplicate(_rkey)),
                 robj(_robj),
                 obj(_obj),
-                geoparms(_geoparms) {};
+                geoparms(_geoparms),
+                runtime(0.0) {};
             ~sampler_info_t (void) {
                 delete [] rkey;
                 robj->releaseLuaObject(); };
@@ -94,6 +97,18 @@ class DataFrameSampler: public GeoDataFrame::FrameRunner
 
     private:
 
+        friend class UT_DataFrameSampler; // necessary for testing the collection limit
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        /* Holds one slot under the node wide collection limit for its scope */
+        struct collection_slot_t {
+            collection_slot_t (void);
+            ~collection_slot_t (void);
+        };
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
@@ -102,15 +117,23 @@ class DataFrameSampler: public GeoDataFrame::FrameRunner
                     ~DataFrameSampler       (void) override;
 
         bool        run                     (GeoDataFrame* dataframe) override;
+        static void sampleCollections       (void* context, long start, long count);
         bool        populatePoints          (GeoDataFrame* dataframe);
         static bool populateMultiColumns    (GeoDataFrame* dataframe, sampler_info_t* sampler);
         static bool populateColumns         (GeoDataFrame* dataframe, sampler_info_t* sampler);
         static bool populateFileIds         (GeoDataFrame* dataframe, sampler_info_t* sampler);
+        static bool populateRunTime         (GeoDataFrame* dataframe, sampler_info_t* sampler);
+        static void getBandMap              (const sampler_info_t* sampler, vector<uint16_t>& band_map);
+        static uint16_t bandOf              (const RasterSampleBuffer& samples, const vector<uint16_t>& band_map, uint32_t j);
 
         /*--------------------------------------------------------------------
          * Data
          *--------------------------------------------------------------------*/
 
+         static Cond                    collectionSignal;   // node wide limit on collections being sampled
+         static int                     activeCollections;
+         static FrameRunnerPool::Client collectionPool;     // workers sampling collections, shares the limit
+
          RequestParameters*             parms;
          vector<point_info_t>       points;
          vector<sampler_info_t*>    samplers;
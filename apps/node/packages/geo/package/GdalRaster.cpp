@@ -303,7 +303,23 @@ void GdalRaster::open(void)
  *----------------------------------------------------------------------------*/
 RasterSample* GdalRaster::samplePOI(OGRPoint* poi, int bandNum)
 {
-    RasterSample* sample = NULL;
+    RasterSample* sample = new RasterSample(gpsTime, fileId);
+    if(!samplePOI(poi, bandNum, *sample))
+    {
+        delete sample;
+        sample = NULL;
+    }
+
+    return sample;
+}
+
+/*----------------------------------------------------------------------------
+ * samplePOI - into caller provided (newly constructed) sample,
+ *             returns false if point was not sampled
+ *----------------------------------------------------------------------------*/
+bool GdalRaster::samplePOI(OGRPoint* poi, int bandNum, RasterSample& sample)
+{
+    bool sampled = false;
 
     /* Clear sample/subset error status */
     ssError = SS_NO_ERRORS;
@@ -328,27 +344,30 @@ RasterSample* GdalRaster::samplePOI(OGRPoint* poi, int bandNum)
         if((poi->getX() >= bbox.lon_min) && (poi->getX() <= bbox.lon_max) &&
            (poi->getY() >= bbox.lat_min) && (poi->getY() <= bbox.lat_max))
         {
-            const double vertical_shift = z - poi->getZ();
-            sample = new RasterSample(gpsTime, fileId, vertical_shift);
+            sample.time = gpsTime;
+            sample.fileId = fileId;
+            sample.verticalShift = z - poi->getZ();
 
             if(isDiscreteBand(bandNum))
             {
                 /* Discrete bands are sampled as-is (no resampling/zonal/slope processing). */
-                readPixel(poi, band, sample);
+                readPixel(poi, band, &sample);
             }
             else
             {
                 if(parms->sampling_algo == GRIORA_NearestNeighbour)
-                    readPixel(poi, band, sample);
+                    readPixel(poi, band, &sample);
                 else
-                    resamplePixel(poi, band, sample);
+                    resamplePixel(poi, band, &sample);
 
                 if(parms->zonal_stats)
-                    computeZonalStats(poi, band, sample);
+                    computeZonalStats(poi, band, &sample);
 
                 if(parms->slope_aspect)
-                    computeSlopeAspect(poi, band, sample);
+                    computeSlopeAspect(poi, band, &sample);
             }
+
+            sampled = true;
         }
         else
         {
@@ -357,13 +376,12 @@ RasterSample* GdalRaster::samplePOI(OGRPoint* poi, int bandNum)
     }
     catch (const RunTimeException &e)
     {
-        delete sample;
-        sample = NULL;
+        sampled = false;
         ssError |= SS_RUNTIME_ERROR;
         mlog(e.level(), "Error sampling: %s", e.what());
     }
 
-    return sample;
+    return sampled;
 }
 
 
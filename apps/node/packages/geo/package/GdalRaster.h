@@ -117,6 +117,7 @@ class GdalRaster
         virtual           ~GdalRaster     (void);
         void               open           (void);
         RasterSample*      samplePOI      (OGRPoint* poi, int bandNum);
+        bool               samplePOI      (OGRPoint* poi, int bandNum, RasterSample& sample);
         RasterSubset*      subsetAOI      (OGRPolygon* poly, int bandNum);
         uint8_t*           getPixels      (uint32_t ulx, uint32_t uly, uint32_t _xsize, uint32_t _ysize, int bandNum);
         const string& getFileName    (void) const { return fileName;}
@@ -0,0 +1,514 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <cpl_vsi.h>
+
+#include "GeoIndexCatalog.h"
+#include "EventLib.h"
+#include "StringLib.h"
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+Mutex GeoIndexCatalog::cacheMut;
+std::map<string, shared_ptr<GeoIndexCatalog::entry_t>> GeoIndexCatalog::cache;
+uint64_t GeoIndexCatalog::useCounter = 0;
+
+/******************************************************************************
+ * PUBLIC METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * init
+ *----------------------------------------------------------------------------*/
+void GeoIndexCatalog::init (void)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * deinit
+ *----------------------------------------------------------------------------*/
+void GeoIndexCatalog::deinit (void)
+{
+    /* Features must be destroyed before GDAL is */
+    cacheMut.lock();
+    {
+        cache.clear();
+    }
+    cacheMut.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * get
+ *----------------------------------------------------------------------------*/
+shared_ptr<const GeoIndexCatalog> GeoIndexCatalog::get (const string& file, const char* key, const date_func_t& get_date)
+{
+    /* Build Cache Key */
+    string cache_key;
+    std::string_view content;
+    bool in_memory = false;
+    if(!getCacheKey(file, key, cache_key, content, in_memory))
+    {
+        mlog(ERROR, "Unable to access vector index file: %s", file.c_str());
+        return NULL;
+    }
+
+    /* Find or Create Entry */
+    shared_ptr<entry_t> entry;
+    cacheMut.lock();
+    {
+        auto iter = cache.find(cache_key);
+        if(iter != cache.end())
+        {
+            entry = iter->second;
+        }
+        else
+        {
+            if(cache.size() >= MAX_CATALOGS) evict();
+            entry = make_shared<entry_t>();
+            cache[cache_key] = entry;
+        }
+        entry->lastUsed = ++useCounter;
+    }
+    cacheMut.unlock();
+
+    /* Load Index File (if needed) */
+    shared_ptr<const GeoIndexCatalog> catalog;
+    bool collision = false;
+    entry->mut.lock();
+    {
+        const double now = TimeLib::latchtime();
+        bool reload = (entry->catalog == NULL);
+
+        /* Check Content of In-Memory Index File (hash collision) */
+        if(!reload && in_memory && (entry->content != content))
+        {
+            collision = true;
+        }
+
+        /* Check for Changes to Index File */
+        if(!reload && !in_memory && ((now - entry->checkTime) > STAT_INTERVAL))
+        {
+            int64_t mtime = 0;
+            int64_t file_size = 0;
+            reload = !statFile(file, mtime, file_size) || (mtime != entry->mtime) || (file_size != entry->fileSize);
+            entry->checkTime = now;
+        }
+
+        /* Load Index File */
+        if(reload)
+        {
+            entry->catalog = NULL;
+            if(!in_memory) statFile(file, entry->mtime, entry->fileSize);
+            else entry->content = content;
+            entry->checkTime = now;
+
+            GeoIndexCatalog* new_catalog = create(file, get_date);
+            if(new_catalog) entry->catalog = shared_ptr<const GeoIndexCatalog>(new_catalog);
+        }
+
+        catalog = entry->catalog;
+    }
+    entry->mut.unlock();
+
+    /* Load Uncached Catalog on Collision */
+    if(collision)
+    {
+        mlog(WARNING, "Cache key collision for in-memory index file %s, loading uncached", file.c_str());
+        return shared_ptr<const GeoIndexCatalog>(create(file, get_date));
+    }
+
+    /* Remove Failed Entries */
+    if(catalog == NULL)
+    {
+        cacheMut.lock();
+        {
+            auto iter = cache.find(cache_key);
+            if(iter != cache.end() && iter->second == entry) cache.erase(iter);
+        }
+        cacheMut.unlock();
+    }
+
+    return catalog;
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor
+ *----------------------------------------------------------------------------*/
+GeoIndexCatalog::~GeoIndexCatalog (void)
+{
+    for(OGRFeature* feature: features)
+    {
+        OGRFeature::DestroyFeature(feature);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * query
+ *
+ *  returns index of every feature whose bounding box contains the point;
+ *  does not lock or allocate (other than result) so it is safe to call
+ *  concurrently from multiple threads
+ *----------------------------------------------------------------------------*/
+void GeoIndexCatalog::query (double x, double y, vector<uint32_t>& result, bool sort) const
+{
+    if(boxes.empty()) return;
+
+    /* Depth first traversal starting at root
+     *  - at most NODE_CAPACITY - 1 siblings are pending on each level of the
+     *    current path, and build limits the tree to MAX_LEVELS levels */
+    static const uint32_t MAX_STACK = MAX_LEVELS * NODE_CAPACITY;
+    size_t stack[MAX_STACK];
+    uint32_t stack_level[MAX_STACK];
+    uint32_t top = 0;
+    stack[top] = boxes.size() - 1;
+    stack_level[top++] = levelBounds.size() - 1;
+
+    while(top > 0)
+    {
+        top--;
+        const size_t pos = stack[top];
+        const uint32_t level = stack_level[top];
+
+        /* Check Point in Bounding Box */
+        const GdalRaster::bbox_t& node = boxes[pos];
+        if(x < node.lon_min || x > node.lon_max || y < node.lat_min || y > node.lat_max)
+        {
+            continue;
+        }
+
+        /* Leaf */
+        if(level == 0)
+        {
+            result.push_back(leafItems[pos]);
+            continue;
+        }
+
+        /* Push Children */
+        const size_t level_start = levelBounds[level - 1];
+        const size_t child_level_start = (level >= 2) ? levelBounds[level - 2] : 0;
+        const size_t child_start = child_level_start + ((pos - level_start) * NODE_CAPACITY);
+        const size_t child_end = MIN(child_start + NODE_CAPACITY, levelBounds[level - 1]);
+        assert(top + (child_end - child_start) <= MAX_STACK);
+        for(size_t child = child_end; child > child_start; child--)
+        {
+            stack[top] = child - 1;
+            stack_level[top++] = level - 1;
+        }
+    }
+
+    /* Return in Order of Features in Index File */
+    if(sort)
+    {
+        std::sort(result.begin(), result.end());
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * timeFilter
+ *
+ *  sets mask to true for features within the time range (inclusive),
+ *  features without a date are always included
+ *----------------------------------------------------------------------------*/
+void GeoIndexCatalog::timeFilter (const TimeLib::gmt_time_t& start, const TimeLib::gmt_time_t& stop, vector<bool>& mask) const
+{
+    const int64_t start_gps = TimeLib::gmt2gpstime(start);
+    const int64_t stop_gps = TimeLib::gmt2gpstime(stop);
+
+    /* Include Features Without a Date */
+    mask.assign(features.size(), false);
+    for(size_t i = 0; i < features.size(); i++)
+    {
+        if(gpsTimes[i] == NO_DATE) mask[i] = true;
+    }
+
+    /* Include Features in Time Range */
+    auto first = std::lower_bound(timeOrder.begin(), timeOrder.end(), start_gps,
+                                  [this](uint32_t i, int64_t t) { return gpsTimes[i] < t; });
+    auto last = std::upper_bound(timeOrder.begin(), timeOrder.end(), stop_gps,
+                                 [this](int64_t t, uint32_t i) { return t < gpsTimes[i]; });
+    for(auto iter = first; iter < last; ++iter)
+    {
+        mask[*iter] = true;
+    }
+}
+
+/******************************************************************************
+ * PRIVATE METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+GeoIndexCatalog::GeoIndexCatalog (void):
+    bbox {0, 0, 0, 0},
+    rows (0),
+    cols (0)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * load
+ *----------------------------------------------------------------------------*/
+bool GeoIndexCatalog::load (const string& file, const date_func_t& get_date)
+{
+    /* Open Vector Data Set */
+    GDALDataset* dset = static_cast<GDALDataset*>(GDALOpenEx(file.c_str(), GDAL_OF_VECTOR | GDAL_OF_READONLY, NULL, NULL, NULL));
+    if(dset == NULL)
+    {
+        mlog(CRITICAL, "Failed to open vector index file: %s", file.c_str());
+        return false;
+    }
+
+    OGRLayer* layer = dset->GetLayer(0);
+    if(layer == NULL)
+    {
+        mlog(CRITICAL, "Failed to get layer from vector index file: %s", file.c_str());
+        GDALClose((GDALDatasetH)dset);
+        return false;
+    }
+
+    /* Read All Features */
+    vector<GdalRaster::bbox_t> item_boxes;
+    layer->ResetReading();
+    while(OGRFeature* feature = layer->GetNextFeature())
+    {
+        const OGRGeometry* geo = feature->GetGeometryRef();
+        if(geo == NULL)
+        {
+            OGRFeature::DestroyFeature(feature);
+            continue;
+        }
+
+        /* Bounding Box */
+        OGREnvelope envelope;
+        geo->getEnvelope(&envelope);
+        item_boxes.push_back({envelope.MinX, envelope.MinY, envelope.MaxX, envelope.MaxY});
+
+        /* Datetime */
+        TimeLib::gmt_time_t gmt_date;
+        if(get_date(feature, gmt_date)) gpsTimes.push_back(TimeLib::gmt2gpstime(gmt_date));
+        else gpsTimes.push_back(NO_DATE);
+
+        /* Catalog owns feature */
+        features.push_back(feature);
+    }
+
+    /* Time Index */
+    for(uint32_t i = 0; i < gpsTimes.size(); i++)
+    {
+        if(gpsTimes[i] != NO_DATE) timeOrder.push_back(i);
+    }
+    std::stable_sort(timeOrder.begin(), timeOrder.end(), [this](uint32_t a, uint32_t b) { return gpsTimes[a] < gpsTimes[b]; });
+
+    /* Spatial Index */
+    if(!build(item_boxes))
+    {
+        mlog(CRITICAL, "Too many features (%ld) in vector index file: %s", item_boxes.size(), file.c_str());
+        GDALClose((GDALDatasetH)dset);
+        return false;
+    }
+
+    /* Attributes of Index File */
+    cols = dset->GetRasterXSize();
+    rows = dset->GetRasterYSize();
+
+    OGREnvelope env;
+    if(layer->GetExtent(&env) == OGRERR_NONE)
+    {
+        bbox.lon_min = env.MinX;
+        bbox.lat_min = env.MinY;
+        bbox.lon_max = env.MaxX;
+        bbox.lat_max = env.MaxY;
+    }
+
+    GDALClose((GDALDatasetH)dset);
+    return true;
+}
+
+/*----------------------------------------------------------------------------
+ * build
+ *
+ *  sort-tile-recursive bulk load: leaves are sorted into vertical slices by x
+ *  and then by y within each slice, parent levels group NODE_CAPACITY
+ *  consecutive children until a single root remains; fails if the tree would
+ *  need more than MAX_LEVELS levels
+ *----------------------------------------------------------------------------*/
+bool GeoIndexCatalog::build (const vector<GdalRaster::bbox_t>& itemBoxes)
+{
+    const size_t num_items = itemBoxes.size();
+    if(num_items == 0) return true;
+
+    /* Check Depth of Tree */
+    uint32_t num_levels = 1;
+    for(size_t n = num_items; n > 1; n = (n + NODE_CAPACITY - 1) / NODE_CAPACITY) num_levels++;
+    if(num_levels > MAX_LEVELS) return false;
+
+    /* Sort Leaves */
+    leafItems.resize(num_items);
+    std::iota(leafItems.begin(), leafItems.end(), 0);
+
+    auto center_x = [&itemBoxes](uint32_t i) { return itemBoxes[i].lon_min + itemBoxes[i].lon_max; };
+    auto center_y = [&itemBoxes](uint32_t i) { return itemBoxes[i].lat_min + itemBoxes[i].lat_max; };
+
+    const size_t num_leaf_nodes = (num_items + NODE_CAPACITY - 1) / NODE_CAPACITY;
+    const size_t num_slices = static_cast<size_t>(ceil(sqrt(static_cast<double>(num_leaf_nodes))));
+    const size_t slice_size = num_slices * NODE_CAPACITY;
+
+    std::sort(leafItems.begin(), leafItems.end(), [&center_x](uint32_t a, uint32_t b) { return center_x(a) < center_x(b); });
+    for(size_t start = 0; start < num_items; start += slice_size)
+    {
+        const size_t end = MIN(start + slice_size, num_items);
+        std::sort(leafItems.begin() + start, leafItems.begin() + end, [&center_y](uint32_t a, uint32_t b) { return center_y(a) < center_y(b); });
+    }
+
+    /* Populate Leaf Level */
+    boxes.reserve(num_items + (num_items / (NODE_CAPACITY - 1)) + 1);
+    for(const uint32_t item: leafItems)
+    {
+        boxes.push_back(itemBoxes[item]);
+    }
+    levelBounds.push_back(boxes.size());
+
+    /* Populate Parent Levels */
+    size_t level_start = 0;
+    size_t level_end = boxes.size();
+    while((level_end - level_start) > 1)
+    {
+        for(size_t i = level_start; i < level_end; i += NODE_CAPACITY)
+        {
+            GdalRaster::bbox_t node = boxes[i];
+            const size_t end = MIN(i + NODE_CAPACITY, level_end);
+            for(size_t j = i + 1; j < end; j++)
+            {
+                const GdalRaster::bbox_t& child = boxes[j];
+                node.lon_min = MIN(node.lon_min, child.lon_min);
+                node.lat_min = MIN(node.lat_min, child.lat_min);
+                node.lon_max = MAX(node.lon_max, child.lon_max);
+                node.lat_max = MAX(node.lat_max, child.lat_max);
+            }
+            boxes.push_back(node);
+        }
+        level_start = level_end;
+        level_end = boxes.size();
+        levelBounds.push_back(level_end);
+    }
+
+    return true;
+}
+
+/*----------------------------------------------------------------------------
+ * create
+ *----------------------------------------------------------------------------*/
+GeoIndexCatalog* GeoIndexCatalog::create (const string& file, const date_func_t& get_date)
+{
+    GeoIndexCatalog* catalog = new GeoIndexCatalog();
+    const double start_time = TimeLib::latchtime();
+    if(!catalog->load(file, get_date))
+    {
+        delete catalog;
+        return NULL;
+    }
+
+    mlog(DEBUG, "Loaded %u features from %s in %.3lf seconds", catalog->size(), file.c_str(), TimeLib::latchtime() - start_time);
+    return catalog;
+}
+
+/*----------------------------------------------------------------------------
+ * getCacheKey
+ *----------------------------------------------------------------------------*/
+bool GeoIndexCatalog::getCacheKey (const string& file, const char* key, string& cache_key, std::string_view& content, bool& in_memory)
+{
+    in_memory = (file.rfind("/vsimem/", 0) == 0);
+    if(in_memory)
+    {
+        /* Key in-memory index files by content, their names are unique to each request */
+        vsi_l_offset length = 0;
+        const GByte* buffer = VSIGetMemFileBuffer(file.c_str(), &length, FALSE);
+        if(buffer == NULL) return false;
+        content = std::string_view(reinterpret_cast<const char*>(buffer), length);
+        const size_t hash = std::hash<std::string_view>{}(content);
+        cache_key = FString("%s:mem:%016lX:%lu", key, static_cast<unsigned long>(hash), static_cast<unsigned long>(length)).c_str();
+    }
+    else
+    {
+        cache_key = FString("%s:%s", key, file.c_str()).c_str();
+    }
+
+    return true;
+}
+
+/*----------------------------------------------------------------------------
+ * statFile
+ *----------------------------------------------------------------------------*/
+bool GeoIndexCatalog::statFile (const string& file, int64_t& mtime, int64_t& file_size)
+{
+    VSIStatBufL stat_buf;
+    if(VSIStatL(file.c_str(), &stat_buf) != 0)
+    {
+        return false;
+    }
+
+    mtime = static_cast<int64_t>(stat_buf.st_mtime);
+    file_size = static_cast<int64_t>(stat_buf.st_size);
+    return true;
+}
+
+/*----------------------------------------------------------------------------
+ * evict
+ *
+ *  removes least recently used entry; must be called with cacheMut locked,
+ *  requests still using the evicted catalog keep their reference to it
+ *----------------------------------------------------------------------------*/
+void GeoIndexCatalog::evict (void)
+{
+    auto oldest = cache.end();
+    for(auto iter = cache.begin(); iter != cache.end(); ++iter)
+    {
+        if(oldest == cache.end() || iter->second->lastUsed < oldest->second->lastUsed)
+        {
+            oldest = iter;
+        }
+    }
+
+    if(oldest != cache.end())
+    {
+        cache.erase(oldest);
+    }
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __geo_index_catalog__
+#define __geo_index_catalog__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <ogrsf_frmts.h>
+#include <functional>
+#include <map>
+#include <string_view>
+
+#include "OsApi.h"
+#include "TimeLib.h"
+#include "GdalRaster.h"
+
+/******************************************************************************
+ * GEO INDEX CATALOG CLASS
+ ******************************************************************************/
+
+/*
+ * Node wide cache of parsed vector index files (geojson STAC catalogs, tile indexes)
+ *
+ *  - features, their bounding boxes and datetimes are loaded once per index file
+ *    and shared (read only) by all requests sampling rasters from that index
+ *  - bounding boxes are bulk loaded into a packed R-tree (sort-tile-recursive)
+ *    stored in flat arrays; queries do not lock or allocate and can run
+ *    concurrently from any number of threads
+ *  - in-memory (/vsimem/) index files are keyed by a hash of their content so
+ *    identical catalogs passed in with different requests share one entry; the
+ *    content is kept with the entry and compared on every lookup; all other
+ *    index files are keyed by path and reloaded when their size or
+ *    modification time changes
+ */
+class GeoIndexCatalog
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const uint32_t NODE_CAPACITY = 16;
+        static const uint32_t MAX_LEVELS = 16; // bounds the traversal stack of a query
+        static const int MAX_CATALOGS = 32;
+        static const int STAT_INTERVAL = 60; // seconds between checks for changes to index file
+        static const int64_t NO_DATE = INT64_MIN;
+
+        /*--------------------------------------------------------------------
+         * Typedefs
+         *--------------------------------------------------------------------*/
+
+        typedef std::function<bool(const OGRFeature*, TimeLib::gmt_time_t&)> date_func_t;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static void init    (void);
+        static void deinit  (void);
+        static shared_ptr<const GeoIndexCatalog> get (const string& file, const char* key, const date_func_t& get_date);
+
+                    ~GeoIndexCatalog    (void);
+
+        void        query               (double x, double y, vector<uint32_t>& result, bool sort) const;
+        void        timeFilter          (const TimeLib::gmt_time_t& start, const TimeLib::gmt_time_t& stop, vector<bool>& mask) const;
+
+        uint32_t    size                (void) const { return features.size(); }
+        bool        empty               (void) const { return features.empty(); }
+        const OGRFeature* feature       (uint32_t index) const { return features[index]; }
+        const GdalRaster::bbox_t& extent(void) const { return bbox; }
+        uint32_t    numRows             (void) const { return rows; }
+        uint32_t    numCols             (void) const { return cols; }
+
+    private:
+
+        friend class UT_GeoIndexCatalog; // necessary for testing the tree and cache directly
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        typedef struct Entry {
+            Mutex                               mut;        // serializes loading of the index file
+            shared_ptr<const GeoIndexCatalog>   catalog;
+            int64_t                             mtime;
+            int64_t                             fileSize;
+            double                              checkTime;  // last time index file was checked for changes
+            uint64_t                            lastUsed;
+            string                              content;    // in-memory index files only
+            Entry(void): mtime(0), fileSize(0), checkTime(0.0), lastUsed(0) {}
+        } entry_t;
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        static Mutex                                    cacheMut;
+        static std::map<string, shared_ptr<entry_t>>    cache;
+        static uint64_t                                 useCounter;
+
+        vector<OGRFeature*>         features;
+        vector<int64_t>             gpsTimes;       // milliseconds, NO_DATE if feature has no date
+        vector<uint32_t>            timeOrder;      // dated features sorted by time
+        vector<GdalRaster::bbox_t>  boxes;          // R-tree nodes stored level by level, leaves first
+        vector<uint32_t>            leafItems;      // feature index of each leaf
+        vector<size_t>              levelBounds;    // end of each level in boxes
+        GdalRaster::bbox_t          bbox;
+        uint32_t                    rows;
+        uint32_t                    cols;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+                    GeoIndexCatalog     (void);
+
+        bool        load                (const string& file, const date_func_t& get_date);
+        bool        build               (const vector<GdalRaster::bbox_t>& itemBoxes);
+        static GeoIndexCatalog* create  (const string& file, const date_func_t& get_date);
+        static bool getCacheKey         (const string& file, const char* key, string& cache_key, std::string_view& content, bool& in_memory);
+        static bool statFile            (const string& file, int64_t& mtime, int64_t& file_size);
+        static void evict               (void);
+};
+
+#endif  /* __geo_index_catalog__ */
@@ -33,6 +33,8 @@
  * INCLUDES
  ******************************************************************************/
 
+#include <typeinfo>
+
 #include "GeoRaster.h"
 #include "GeoIndexedRaster.h"
 
@@ -71,14 +73,11 @@ GeoIndexedRaster::RasterFinder::RasterFinder (const OGRGeometry* _geo,
 GeoIndexedRaster::GeoIndexedRaster(lua_State *L, RequestParameters* rqst_parms, const char* key, GdalRaster::overrideGeoTransform_t gtf_cb, GdalRaster::overrideCRS_t crs_cb):
     RasterObject    (L, rqst_parms, key),
     ssErrors        (SS_NO_ERRORS),
-    readerDone      (NUM_SYNC_SIGNALS),
-    activeReaders   (0),
     gtfcb           (gtf_cb),
     crscb           (crs_cb),
     bbox            {0, 0, 0, 0},
     rows            (0),
-    cols            (0),
-    geoRtree        (parms->sort_by_index)
+    cols            (0)
 {
     /* Add Lua Functions */
     LuaEngine::setAttrFunc(L, "dim", luaDimensions);
@@ -152,84 +151,49 @@ bool GeoIndexedRaster::getFeatureDate(const OGRFeature* feature, TimeLib::gmt_ti
 /*----------------------------------------------------------------------------
  * openGeoIndex
  *----------------------------------------------------------------------------*/
-bool GeoIndexedRaster::openGeoIndex(const string& newFile, OGRGeometry* filter)
+bool GeoIndexedRaster::openGeoIndex(const string& newFile)
 {
     /* Trying to open the same file? */
-    if(!geoRtree.empty() && newFile == indexFile)
+    if(catalog != NULL && newFile == indexFile)
         return true;
 
-    GDALDataset* dset = NULL;
-    try
-    {
-        geoRtree.clear();
-
-        /* Open new vector data set*/
-        dset = static_cast<GDALDataset *>(GDALOpenEx(newFile.c_str(), GDAL_OF_VECTOR | GDAL_OF_READONLY, NULL, NULL, NULL));
-        if (dset == NULL)
-        {
-            mlog(CRITICAL, "Failed to open vector index file: %s", newFile.c_str());
-            throw RunTimeException(ERROR, RTE_FAILURE, "Failed to open vector index file: %s:", newFile.c_str());
-        }
-
-        indexFile = newFile;
-        OGRLayer* layer = dset->GetLayer(0);
-        CHECKPTR(layer);
-
-        if(filter)
-        {
-            applySpatialFilter(layer, filter);
-        }
-
-        /*
-         * Insert features into R-tree after applying temporal filter
-         */
-        layer->ResetReading();
-        while(OGRFeature* feature = layer->GetNextFeature())
-        {
-            /* Temporal filter */
-            TimeLib::gmt_time_t gmtDate;
-            if(parms->filter_time && getFeatureDate(feature, gmtDate))
-            {
-                /* Check if feature is in time range */
-                if(!TimeLib::gmtinrange(gmtDate, parms->start_time, parms->stop_time))
-                {
-                    OGRFeature::DestroyFeature(feature);
-                    continue;
-                }
-            }
-
-            /* Insert feature into tree */
-            geoRtree.insert(feature);
-
-            /* Destroy feature, R-tree has its own copy */
-            OGRFeature::DestroyFeature(feature);
-        }
+    const double startTime = TimeLib::latchtime();
 
-        cols = dset->GetRasterXSize();
-        rows = dset->GetRasterYSize();
+    /*
+     * Features and their spatial index are cached node wide, keyed by the raster class
+     * since feature dates are extracted by the (possibly overridden) getFeatureDate
+     */
+    catalog = GeoIndexCatalog::get(newFile, typeid(*this).name(),
+                                   [this](const OGRFeature* feature, TimeLib::gmt_time_t& gmtDate) {
+                                       return getFeatureDate(feature, gmtDate);
+                                   });
+    if(catalog == NULL)
+    {
+        indexFile.clear();
+        catalogMask.clear();
+        ssErrors |= SS_INDEX_FILE_ERROR;
+        return false;
+    }
 
-        /* OGREnvelope is not treated as first classs geometry in OGR, must create a polygon geometry from it */
-        OGREnvelope env;
-        const OGRErr err = layer->GetExtent(&env);
-        if(err == OGRERR_NONE )
-        {
-            bbox.lon_min = env.MinX;
-            bbox.lat_min = env.MinY;
-            bbox.lon_max = env.MaxX;
-            bbox.lat_max = env.MaxY;
-        }
+    indexFile = newFile;
 
-        // mlog(DEBUG, "Loaded %lld features from: %s", layer->GetFeatureCount(), newFile.c_str());
-        GDALClose((GDALDatasetH)dset);
+    /* Temporal filter is per request, catalog is shared */
+    if(parms->filter_time)
+    {
+        catalog->timeFilter(parms->start_time, parms->stop_time, catalogMask);
     }
-    catch (const RunTimeException &e)
+    else
     {
-        GDALClose((GDALDatasetH)dset);
-        geoRtree.clear();
-        ssErrors |= SS_INDEX_FILE_ERROR;
-        return false;
+        catalogMask.clear();
     }
 
+    cols = catalog->numCols();
+    rows = catalog->numRows();
+    bbox = catalog->extent();
+
+    perfStats.indexLoadTime = TimeLib::latchtime() - startTime;
+    mlog(DEBUG, "Opened index file %s with %u features in %.3lf seconds", newFile.c_str(), catalog->size(), perfStats.indexLoadTime);
+
     return true;
 }
 
@@ -433,20 +397,3 @@ bool GeoIndexedRaster::filterRasters(int64_t gps_secs, GroupOrdering* groupList,
     return (!groupList->empty());
 }
 
-/*----------------------------------------------------------------------------
- * applySpatialFilter
- *----------------------------------------------------------------------------*/
-void GeoIndexedRaster::applySpatialFilter(OGRLayer* layer, OGRGeometry* filter)
-{
-    mlog(DEBUG, "Features before spatial filter: %lld", layer->GetFeatureCount());
-
-    const double startTime = TimeLib::latchtime();
-
-    /* Buffered points generates more detailed filter polygon but is much slower than
-     * convex hull, especially for large number of points.
-     */
-    layer->SetSpatialFilter(filter);
-    perfStats.spatialFilterTime = TimeLib::latchtime() - startTime;
-    mlog(DEBUG, "Features after spatial filter: %lld", layer->GetFeatureCount());
-    mlog(DEBUG, "Spatial filter time: %.3lf", perfStats.spatialFilterTime);
-}
@@ -39,14 +39,11 @@
 #include "GdalRaster.h"
 #include "RasterObject.h"
 #include "Ordering.h"
-#include "GeoRtree.h"
+#include "GeoIndexCatalog.h"
 #include <atomic>
 #include <unordered_map>
 #include <set>
 
-/* GEOS C++ API is unstable, use C API */
-#include <geos_c.h>
-
 
 /******************************************************************************
  * GEO RASTER CLASS
@@ -122,17 +119,6 @@ class GeoIndexedRaster: public RasterObject
 
         typedef Ordering<rasters_group_t*, unsigned long> GroupOrdering;
 
-        /* Batch reader thread info used by batch sampling code */
-        typedef struct BatchReader {
-            GeoIndexedRaster*   obj;
-            unique_raster_t*    uraster;
-            Thread*             thread;
-            Cond                sync;
-            std::atomic<bool>   run;
-            explicit BatchReader(GeoIndexedRaster* _obj);
-            ~BatchReader(void);
-        } batch_reader_t;
-
         typedef RasterObject::range_t range_t;
 
         /* Point and it's asociated group list */
@@ -148,8 +134,10 @@ class GeoIndexedRaster: public RasterObject
             range_t                            pGroupsRange;  // range of point groups to process for this thread
             const vector<point_groups_t>& pointsGroups;
             vector<sample_list_t*>        slvector;      // vecotor of sample lists to be returned to the user
+            RasterSampleBuffer*                buffer;        // columnar samples to be returned to the user, NULL if returning lists
             uint32_t                           ssErrors;      // sampling errors
             explicit SampleCollector(GeoIndexedRaster* _obj, const vector<point_groups_t>& _pointsGroups);
+                    ~SampleCollector(void);
         } sample_collector_t;
 
         /* Map of raster file id to list of points to be sampled in that raster */
@@ -164,7 +152,7 @@ class GeoIndexedRaster: public RasterObject
             raster_points_map_t              rasterToPointsMap;
             RasterFileDictionary             threadFileDict;
             std::unordered_map<uint64_t, uint64_t> localToGlobalFileIds; // cache for mapping thread-local file ids to global ids
-            std::unordered_map<long, OGRFeature*>  featureCache;         // cache cloned features by FID to avoid repeated clones
+            std::unordered_map<uint32_t, OGRFeature*> featureCache;       // cache cloned features by catalog index to avoid repeated clones
 
             explicit GroupsFinder (GeoIndexedRaster* _obj, const vector<point_info_t>* _points);
         } groups_finder_t;
@@ -186,6 +174,7 @@ class GeoIndexedRaster: public RasterObject
         using RasterObject::getSamples;
 
         uint32_t        getSamples            (const vector<point_info_t>& points, List<sample_list_t*>& sllist, void* param=NULL) final;
+        uint32_t        getSamples            (const vector<point_info_t>& points, RasterSampleBuffer& buffer, void* param=NULL) final;
 
     protected:
 
@@ -195,10 +184,12 @@ class GeoIndexedRaster: public RasterObject
 
                          GeoIndexedRaster      (lua_State* L, RequestParameters* _parms, const char* key, GdalRaster::overrideGeoTransform_t gtf_cb=NULL, GdalRaster::overrideCRS_t crs_cb=NULL);
         virtual uint32_t getBatchGroupSamples  (const rasters_group_t* rgroup, List<RasterSample*>* slist, uint32_t flags, uint32_t pointIndx);
+        virtual uint32_t getBatchGroupSamples  (const rasters_group_t* rgroup, RasterSampleBuffer& buffer, uint32_t flags, uint32_t pointIndx);
+        uint32_t         getBatchGroupSamplesFromList (const rasters_group_t* rgroup, RasterSampleBuffer& buffer, uint32_t flags, uint32_t pointIndx);
         static  uint32_t getBatchGroupFlags    (const rasters_group_t* rgroup, uint32_t pointIndx);
 
         virtual double   getGmtDate            (const OGRFeature* feature, const char* field,  TimeLib::gmt_time_t& gmtDate);
-        bool             openGeoIndex          (const string& newFile, OGRGeometry* filter=NULL);
+        bool             openGeoIndex          (const string& newFile);
         virtual bool     getFeatureDate        (const OGRFeature* feature, TimeLib::gmt_time_t& gmtDate);
         virtual void     getIndexFile          (const vector<point_info_t>* points, string& file) = 0;
         virtual bool     findRasters           (raster_finder_t* finder) = 0;
@@ -216,18 +207,18 @@ class GeoIndexedRaster: public RasterObject
          *--------------------------------------------------------------------*/
 
         typedef struct PerfStats {
-            double  spatialFilterTime;
+            double  indexLoadTime;
             double  findRastersTime;
             double  findUniqueRastersTime;
             double  samplesTime;
             double  collectSamplesTime;
 
-            PerfStats (void) : spatialFilterTime(0), findRastersTime(0), findUniqueRastersTime(0), samplesTime(0), collectSamplesTime(0) {}
-            void clear(void) { spatialFilterTime = 0; findRastersTime = 0; findUniqueRastersTime = 0; samplesTime = 0; collectSamplesTime = 0; }
+            PerfStats (void) : indexLoadTime(0), findRastersTime(0), findUniqueRastersTime(0), samplesTime(0), collectSamplesTime(0) {}
+            void clear(void) { indexLoadTime = 0; findRastersTime = 0; findUniqueRastersTime = 0; samplesTime = 0; collectSamplesTime = 0; }
             void log  (event_level_t lvl)
             {
                 mlog(lvl, "Performance Stats:");
-                mlog(lvl, "spatialFilter: %12.3lf", spatialFilterTime);
+                mlog(lvl, "indexLoad:     %12.3lf", indexLoadTime);
                 mlog(lvl, "findingRasters:%12.3lf", findRastersTime);
                 mlog(lvl, "findingUnique: %12.3lf", findUniqueRastersTime);
                 mlog(lvl, "sampling:      %12.3lf", samplesTime);
@@ -235,22 +226,11 @@ class GeoIndexedRaster: public RasterObject
             }
         } perf_stats_t;
 
-        /*--------------------------------------------------------------------
-         * Constants
-         *--------------------------------------------------------------------*/
-
-        static const int DATA_TO_SAMPLE   = 0;
-        static const int DATA_SAMPLED     = 1;
-        static const int NUM_SYNC_SIGNALS = 2;
-
         /*--------------------------------------------------------------------
          * Data
          *--------------------------------------------------------------------*/
 
-        List<batch_reader_t*>     batchReaders;
         perf_stats_t              perfStats;
-        Cond                      readerDone;         // Signals when any batch reader finishes work
-        std::atomic<uint32_t>     activeReaders;      // Number of batch readers currently processing work
         GdalRaster::overrideGeoTransform_t gtfcb;
         GdalRaster::overrideCRS_t crscb;
 
@@ -259,7 +239,8 @@ class GeoIndexedRaster: public RasterObject
         uint32_t                  rows;
         uint32_t                  cols;
 
-        GeoRtree                  geoRtree;
+        shared_ptr<const GeoIndexCatalog> catalog;   // shared with other requests using the same index file
+        vector<bool>              catalogMask;        // features passing temporal filter, empty if not filtering
         event_level_t             samplingLogLevel;
 
         /*--------------------------------------------------------------------
@@ -270,15 +251,12 @@ class GeoIndexedRaster: public RasterObject
         static int      luaBoundingBox      (lua_State* L);
         static int      luaCellSize         (lua_State* L);
 
-        static void*    batchReaderThread   (void *param);
+        static void     readRaster          (void* context, void* item);
 
         static void*    groupsFinderThread  (void *param);
         static void*    samplesCollectThread(void *param);
 
-        bool            createBatchReaderThreads  (uint32_t rasters2sample);
         bool            filterRasters       (int64_t gps_secs, GroupOrdering* groupList, RasterFileDictionary& dict);
-        static OGRGeometry* getConvexHull   (const vector<point_info_t>* points);
-        void            applySpatialFilter  (OGRLayer* layer, OGRGeometry* filter);
 
         bool            findAllGroups       (const vector<point_info_t>* points,
                                              vector<point_groups_t>& pointsGroups,
@@ -291,7 +269,12 @@ class GeoIndexedRaster: public RasterObject
         bool            sampleUniqueRasters (const vector<unique_raster_t*>& uniqueRasters);
 
         bool            collectSamples      (const vector<point_groups_t>& pointsGroups,
-                                             List<sample_list_t*>& sllist);
+                                             List<sample_list_t*>* sllist,
+                                             RasterSampleBuffer* buffer);
+
+        uint32_t        batchSamples        (const vector<point_info_t>& points,
+                                             List<sample_list_t*>* sllist,
+                                             RasterSampleBuffer* buffer);
 };
 
 #endif  /* __geo_indexed_raster__ */
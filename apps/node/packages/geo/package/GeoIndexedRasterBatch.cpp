@@ -38,6 +38,7 @@
 
 #include "GeoRaster.h"
 #include "GeoIndexedRaster.h"
+#include "RasterReadExecutor.h"
 
 /******************************************************************************
  * PUBLIC METHODS
@@ -65,10 +66,19 @@ GeoIndexedRaster::SampleCollector::SampleCollector(GeoIndexedRaster* _obj, const
     obj(_obj),
     pGroupsRange({0, 0}),
     pointsGroups(_pointsGroups),
+    buffer(NULL),
     ssErrors(SS_NO_ERRORS)
 {
 }
 
+/*----------------------------------------------------------------------------
+ * SampleCollector Destructor
+ *----------------------------------------------------------------------------*/
+GeoIndexedRaster::SampleCollector::~SampleCollector(void)
+{
+    delete buffer;
+}
+
 /*----------------------------------------------------------------------------
  * GroupsFinder Constructor
  *----------------------------------------------------------------------------*/
@@ -85,7 +95,33 @@ GeoIndexedRaster::GroupsFinder::GroupsFinder(GeoIndexedRaster* _obj, const vecto
 uint32_t GeoIndexedRaster::getSamples(const vector<point_info_t>& points, List<sample_list_t*>& sllist, void* param)
 {
     static_cast<void>(param);
+    return batchSamples(points, &sllist, NULL);
+}
+
+/*----------------------------------------------------------------------------
+ * getSamples - batch sampling, columnar results
+ *----------------------------------------------------------------------------*/
+uint32_t GeoIndexedRaster::getSamples(const vector<point_info_t>& points, RasterSampleBuffer& buffer, void* param)
+{
+    static_cast<void>(param);
+    buffer.configure(hasZonalStats(), hasSpatialDerivs());
+    buffer.reserve(points.size());
+    const uint32_t errors = batchSamples(points, NULL, &buffer);
+
+    /* Keep one entry per point even if sampling failed or was stopped */
+    while(buffer.numPoints() < points.size())
+    {
+        buffer.endPoint();
+    }
+
+    return errors;
+}
 
+/*----------------------------------------------------------------------------
+ * batchSamples
+ *----------------------------------------------------------------------------*/
+uint32_t GeoIndexedRaster::batchSamples(const vector<point_info_t>& points, List<sample_list_t*>* sllist, RasterSampleBuffer* buffer)
+{
     lockSampling();
 
     const bool multiPoints = points.size() > 1;
@@ -117,23 +153,8 @@ uint32_t GeoIndexedRaster::getSamples(const vector<point_info_t>& points, List<s
         string ifile;
         getIndexFile(&points, ifile);
 
-        /* Create a convex hull that wraps around all the points, used for spatial filter.
-         * Skip it for single-point calls so we don't cache a point-filtered R-tree that would
-         * hide rasters on subsequent single-point calls. */
-        OGRGeometry* filter = NULL;
-        if(multiPoints)
-        {
-            filter = getConvexHull(&points);
-        }
-
-        /* Open the index file */
-        const bool indexOpenedOk = openGeoIndex(ifile, filter);
-
-        /* Clean up convex hull */
-        if(filter)
-        {
-            OGRGeometryFactory::destroyGeometry(filter);
-        }
+        /* Open the index file, features and spatial index are shared with other requests */
+        const bool indexOpenedOk = openGeoIndex(ifile);
 
         if(!indexOpenedOk)
         {
@@ -163,8 +184,8 @@ uint32_t GeoIndexedRaster::getSamples(const vector<point_info_t>& points, List<s
             throw RunTimeException(CRITICAL, RTE_FAILURE, "Error sampling unique rasters");
         }
 
-        /* Populate sllist with samples */
-        if(!collectSamples(pointsGroups, sllist))
+        /* Populate sllist (or buffer) with samples */
+        if(!collectSamples(pointsGroups, sllist, buffer))
         {
             throw RunTimeException(CRITICAL, RTE_FAILURE, "Error collecting samples");
         }
@@ -209,33 +230,6 @@ uint32_t GeoIndexedRaster::getSamples(const vector<point_info_t>& points, List<s
  * PROTECTED METHODS
  ******************************************************************************/
 
-/*----------------------------------------------------------------------------
- * BatchReader Constructor
- *----------------------------------------------------------------------------*/
-GeoIndexedRaster::BatchReader::BatchReader(GeoIndexedRaster* _obj) :
-    obj(_obj),
-    uraster(NULL),
-    sync(NUM_SYNC_SIGNALS),
-    run(true)
-{
-    thread = new Thread(GeoIndexedRaster::batchReaderThread, this);
-}
-
-/*----------------------------------------------------------------------------
- * BatchReader Destructor
- *----------------------------------------------------------------------------*/
-GeoIndexedRaster::BatchReader::~BatchReader(void)
-{
-    sync.lock();
-    {
-        run.store(false); /* Set run flag to false */
-        sync.signal(DATA_TO_SAMPLE, Cond::NOTIFY_ONE);
-    }
-    sync.unlock();
-
-    delete thread; /* delete thread waits on thread to join */
-}
-
 /*----------------------------------------------------------------------------
  * getBatchGroupSamples
  *----------------------------------------------------------------------------*/
@@ -306,6 +300,73 @@ uint32_t GeoIndexedRaster::getBatchGroupSamples(const rasters_group_t* rgroup, L
     return errors;
 }
 
+/*----------------------------------------------------------------------------
+ * getBatchGroupSamples - columnar results
+ *
+ *  samples are copied into the buffer in place, ownership stays with the
+ *  unique raster so no per sample copies are allocated
+ *----------------------------------------------------------------------------*/
+uint32_t GeoIndexedRaster::getBatchGroupSamples(const rasters_group_t* rgroup, RasterSampleBuffer& buffer, uint32_t flags, uint32_t pointIndx)
+{
+    uint32_t errors = SS_NO_ERRORS;
+
+    for(const auto& rinfo: rgroup->infovect)
+    {
+        if(!StringLib::match(VALUE_TAG, rinfo.tag.c_str())) continue;
+
+        /* This is the unique raster we are looking for, it cannot be NULL */
+        const unique_raster_t* ur = rinfo.uraster;
+        assert(ur);
+
+        /* Get the sample for this point from unique raster */
+        const point_sample_t* psPtr = NULL;
+        if(ur->useDenseLookup)
+        {
+            if(pointIndx < ur->pointIndexLookup.size())
+                psPtr = ur->pointIndexLookup[pointIndx];
+        }
+        else
+        {
+            auto pit = ur->pointIndexMap.find(pointIndx);
+            if(pit != ur->pointIndexMap.end())
+                psPtr = pit->second;
+        }
+
+        if(psPtr != NULL)
+        {
+            const point_sample_t& ps = *psPtr;
+
+            for(const RasterSample* sample : ps.bandSample)
+            {
+                /* sample can be NULL if raster read failed, (e.g. point out of bounds) */
+                if(sample == NULL) continue;
+
+                buffer.append(*sample, rgroup->gpsTime, flags);
+                errors |= ps.ssErrors;
+            }
+
+            /* Only one raster with VALUE_TAG in a group, see list version above */
+            return errors;
+        }
+    }
+
+    return errors;
+}
+
+/*----------------------------------------------------------------------------
+ * getBatchGroupSamplesFromList
+ *
+ *  columnar results for datasets which override the sample list version of
+ *  getBatchGroupSamples (e.g. to compute derived values)
+ *----------------------------------------------------------------------------*/
+uint32_t GeoIndexedRaster::getBatchGroupSamplesFromList(const rasters_group_t* rgroup, RasterSampleBuffer& buffer, uint32_t flags, uint32_t pointIndx)
+{
+    List<RasterSample*> slist;
+    const uint32_t errors = getBatchGroupSamples(rgroup, &slist, flags, pointIndx);
+    buffer.append(slist);
+    return errors;
+}
+
 /*----------------------------------------------------------------------------
  * getBatchGroupFlags
  *----------------------------------------------------------------------------*/
@@ -338,7 +399,7 @@ uint32_t GeoIndexedRaster::getBatchGroupFlags(const rasters_group_t* rgroup, uin
 
             /*
              * This function assumes that there is only one raster with FLAGS_TAG in a group.
-             * The flags value is read from the sampled band index resolved in batchReaderThread.
+             * The flags value is read from the sampled band index resolved in readRaster.
              */
             RasterSample* sample = NULL;
 
@@ -365,138 +426,114 @@ uint32_t GeoIndexedRaster::getBatchGroupFlags(const rasters_group_t* rgroup, uin
  ******************************************************************************/
 
 /*----------------------------------------------------------------------------
- * batchReaderThread
+ * readRaster - called by the raster read executor for each unique raster
  *----------------------------------------------------------------------------*/
-void* GeoIndexedRaster::batchReaderThread(void *param)
+void GeoIndexedRaster::readRaster(void* context, void* item)
 {
-    batch_reader_t *breader = static_cast<batch_reader_t*>(param);
+    GeoIndexedRaster* obj = static_cast<GeoIndexedRaster*>(context);
+    unique_raster_t* ur = static_cast<unique_raster_t*>(item);
+    GdalRaster* raster = NULL;
 
-    while(breader->run.load())
+    try
     {
-        breader->sync.lock();
-        {
-            /* Wait for raster to work on */
-            while((breader->uraster == NULL) && breader->run.load())
-                breader->sync.wait(DATA_TO_SAMPLE, SYS_TIMEOUT);
-        }
-        breader->sync.unlock();
-
-        if(breader->uraster != NULL)
+        const int elevationBandNum = ur->rinfo->elevationBandNum;
+        const uint32_t elevationBandsMask = (elevationBandNum > 0 && elevationBandNum <= 32) ? (1U << (elevationBandNum - 1)) : 0U;
+        raster = new GdalRaster(obj,
+                                obj->fileDict.get(ur->rinfo->fileId),
+                                0,                     /* Sample collecting code will set it to group's gpsTime */
+                                ur->rinfo->fileId,
+                                elevationBandsMask,
+                                obj->gtfcb,
+                                obj->crscb,
+                                &obj->bbox);
+
+        CHECKPTR(raster);
+
+        /* Open raster so we can get inner bands from it */
+        raster->open();
+
+        vector<int> bands;
+        obj->resolveBands(raster, bands);
+
+        /*
+         * Resolve which sampled band index should be used as flags for this raster.
+         * `bands` contains the actual GDAL band numbers that will be sampled.
+         */
+        ur->flagsSampleIndex = -1;
+        if(StringLib::match(FLAGS_TAG, ur->rinfo->tag.c_str()))
         {
-            unique_raster_t* ur = breader->uraster;
-            GdalRaster* raster = NULL;
-
-            try
+            /* Dataset-provided band number for flags. */
+            const int flagsBandNum = ur->rinfo->flagsBandNum;
+            if(flagsBandNum != GdalRaster::NO_BAND)
             {
-                const int elevationBandNum = ur->rinfo->elevationBandNum;
-                const uint32_t elevationBandsMask = (elevationBandNum > 0 && elevationBandNum <= 32) ? (1U << (elevationBandNum - 1)) : 0U;
-                raster = new GdalRaster(breader->obj,
-                                        breader->obj->fileDict.get(ur->rinfo->fileId),
-                                        0,                     /* Sample collecting code will set it to group's gpsTime */
-                                        ur->rinfo->fileId,
-                                        elevationBandsMask,
-                                        breader->obj->gtfcb,
-                                        breader->obj->crscb,
-                                        &breader->obj->bbox);
-
-                CHECKPTR(raster);
-
-                /* Open raster so we can get inner bands from it */
-                raster->open();
-
-                vector<int> bands;
-                breader->obj->resolveBands(raster, bands);
-
                 /*
-                 * Resolve which sampled band index should be used as flags for this raster.
-                 * `bands` contains the actual GDAL band numbers that will be sampled.
+                 * Find the requested flags band inside the sampled bands list and record
+                 * its sampled index so getBatchGroupFlags can read the correct sample.
                  */
-                ur->flagsSampleIndex = -1;
-                if(StringLib::match(FLAGS_TAG, ur->rinfo->tag.c_str()))
+                for(size_t i = 0; i < bands.size(); i++)
                 {
-                    /* Dataset-provided band number for flags. */
-                    const int flagsBandNum = ur->rinfo->flagsBandNum;
-                    if(flagsBandNum != GdalRaster::NO_BAND)
-                    {
-                        /*
-                         * Find the requested flags band inside the sampled bands list and record
-                         * its sampled index so getBatchGroupFlags can read the correct sample.
-                         */
-                        for(size_t i = 0; i < bands.size(); i++)
-                        {
-                            if(bands[i] == flagsBandNum)
-                            {
-                                ur->flagsSampleIndex = static_cast<int>(i);
-                                break;
-                            }
-                        }
-                    }
-
-                    if(ur->flagsSampleIndex < 0)
+                    if(bands[i] == flagsBandNum)
                     {
-                        /* Flags were requested but the requested band was not sampled/resolved. */
-                        mlog(WARNING, "Failed to resolve flags band %d for raster %s", flagsBandNum, breader->obj->fileDict.get(ur->rinfo->fileId));
+                        ur->flagsSampleIndex = static_cast<int>(i);
+                        break;
                     }
                 }
+            }
 
-                /* Sample all points for this raster */
-                for(point_sample_t& ps : ur->pointSamples)
-                {
-                    ps.bandSample.reserve(bands.size());
-                    ps.bandSampleReturned.reserve(bands.size());
+            if(ur->flagsSampleIndex < 0)
+            {
+                /* Flags were requested but the requested band was not sampled/resolved. */
+                mlog(WARNING, "Failed to resolve flags band %d for raster %s", flagsBandNum, obj->fileDict.get(ur->rinfo->fileId));
+            }
+        }
 
-                    /* Sample raster bands */
-                    const bool oneBand = bands.size() == 1;
-                    if(oneBand)
-                    {
-                        RasterSample* sample = raster->samplePOI(&ps.point, bands[0]);
-                        ps.bandSample.push_back(sample);
-                        ps.bandSampleReturned.push_back(0);
-                    }
-                    else
-                    {
-                        /* Multiple bands */
-                        ps.bandSample.reserve(ps.bandSample.size() + bands.size());
-                        ps.bandSampleReturned.reserve(ps.bandSampleReturned.size() + bands.size());
-                        for(const int bandNum : bands)
-                        {
-                            /* Use local copy of point, it will be projected in samplePOI. We do not want to project it again */
-                            OGRPoint point(ps.point);
-
-                            RasterSample* sample = raster->samplePOI(&point, bandNum);
-                            ps.bandSample.push_back(sample);
-                            ps.bandSampleReturned.push_back(0);
-                            ps.ssErrors |= raster->getSSerror();
-                        }
-                    }
-                }
+        /* Sample all points for this raster */
+        for(point_sample_t& ps : ur->pointSamples)
+        {
+            ps.bandSample.reserve(bands.size());
+            ps.bandSampleReturned.reserve(bands.size());
+
+            /* Sample raster bands */
+            const bool oneBand = bands.size() == 1;
+            if(oneBand)
+            {
+                RasterSample* sample = raster->samplePOI(&ps.point, bands[0]);
+                ps.bandSample.push_back(sample);
+                ps.bandSampleReturned.push_back(0);
             }
-            catch(const RunTimeException& e)
+            else
             {
-                /*
-                 * This catch is raster-scoped (open/band-resolution/sampling setup). If it fails,
-                 * the current unique raster cannot be trusted for this worker pass, so mark all
-                 * point samples attached to this raster with runtime error.
-                 */
-                for(point_sample_t& ps : ur->pointSamples)
+                /* Multiple bands */
+                ps.bandSample.reserve(ps.bandSample.size() + bands.size());
+                ps.bandSampleReturned.reserve(ps.bandSampleReturned.size() + bands.size());
+                for(const int bandNum : bands)
                 {
-                    ps.ssErrors |= SS_RUNTIME_ERROR;
-                }
-                mlog(e.level(), "%s", e.what());
-            }
+                    /* Use local copy of point, it will be projected in samplePOI. We do not want to project it again */
+                    OGRPoint point(ps.point);
 
-            delete raster;
-            breader->sync.lock();
-            {
-                breader->uraster = NULL; /* Done with this raster and all points */
-                breader->obj->readerDone.signal(DATA_SAMPLED, Cond::NOTIFY_ONE);
-                breader->obj->activeReaders.fetch_sub(1);
+                    RasterSample* sample = raster->samplePOI(&point, bandNum);
+                    ps.bandSample.push_back(sample);
+                    ps.bandSampleReturned.push_back(0);
+                    ps.ssErrors |= raster->getSSerror();
+                }
             }
-            breader->sync.unlock();
         }
     }
+    catch(const RunTimeException& e)
+    {
+        /*
+         * This catch is raster-scoped (open/band-resolution/sampling setup). If it fails,
+         * the current unique raster cannot be trusted for this worker pass, so mark all
+         * point samples attached to this raster with runtime error.
+         */
+        for(point_sample_t& ps : ur->pointSamples)
+        {
+            ps.ssErrors |= SS_RUNTIME_ERROR;
+        }
+        mlog(e.level(), "%s", e.what());
+    }
 
-    return NULL;
+    delete raster;
 }
 
 /*----------------------------------------------------------------------------
@@ -506,15 +543,14 @@ void* GeoIndexedRaster::groupsFinderThread(void *param)
 {
     groups_finder_t* gf = static_cast<groups_finder_t*>(param);
 
-    /* Thread must initialize GEOS context */
-    GEOSContextHandle_t threadGeosContext = GeoRtree::init();
-
     const uint32_t start = gf->pointsRange.start;
     const uint32_t end = gf->pointsRange.end;
 
     mlog(DEBUG, "Finding groups for points range: %u - %u", start, end);
 
-    vector<OGRFeature*> foundFeatures;
+    const GeoIndexCatalog* catalog = gf->obj->catalog.get();
+    const vector<bool>& mask = gf->obj->catalogMask;
+    vector<uint32_t> foundFeatures;
     vector<OGRFeature*> threadFeatures;
     OGRPoint                 ogrPoint;
 
@@ -533,9 +569,9 @@ void* GeoIndexedRaster::groupsFinderThread(void *param)
         ogrPoint.setY(pinfo.point3d.y);
         ogrPoint.setZ(pinfo.point3d.z);
 
-        /* Query the R-tree with the OGRPoint and get the result features */
+        /* Query the catalog's R-tree with the point and get the indices of result features */
         foundFeatures.clear();
-        gf->obj->geoRtree.query(&ogrPoint, threadGeosContext, foundFeatures);
+        catalog->query(pinfo.point3d.x, pinfo.point3d.y, foundFeatures, gf->obj->parms->sort_by_index);
         // mlog(DEBUG, "Found %zu features for point %u", foundFeatures.size(), i);
 
         /* Clone found features once per thread and reuse cached copies.
@@ -543,18 +579,21 @@ void* GeoIndexedRaster::groupsFinderThread(void *param)
         threadFeatures.clear();
         threadFeatures.reserve(foundFeatures.size());
 
-        for(OGRFeature* feature : foundFeatures)
+        for(const uint32_t index : foundFeatures)
         {
-            const long fid = feature->GetFID();
-            auto cacheIt = gf->featureCache.find(fid);
+            /* Temporal filter */
+            if(!mask.empty() && !mask[index])
+                continue;
+
+            auto cacheIt = gf->featureCache.find(index);
             if(cacheIt != gf->featureCache.end())
             {
                 threadFeatures.push_back(cacheIt->second);
             }
             else
             {
-                OGRFeature* clonedFeature = feature->Clone();
-                gf->featureCache[fid] = clonedFeature;
+                OGRFeature* clonedFeature = catalog->feature(index)->Clone();
+                gf->featureCache[index] = clonedFeature;
                 threadFeatures.push_back(clonedFeature);
             }
         }
@@ -606,9 +645,6 @@ void* GeoIndexedRaster::groupsFinderThread(void *param)
 
     mlog(DEBUG, "Found %zu point groups for range: %u - %u", gf->pointsGroups.size(), start, end);
 
-    /* Thread must deinitialize GEOS context */
-    GeoRtree::deinit(threadGeosContext);
-
     /* Destroy cached cloned features */
     for(const auto& pair : gf->featureCache)
     {
@@ -631,7 +667,8 @@ void* GeoIndexedRaster::samplesCollectThread(void* param)
 
     mlog(DEBUG, "Collecting samples for range: %u - %u", start, end);
 
-    sc->slvector.reserve(end - start);
+    if(sc->buffer) sc->buffer->reserve(end - start);
+    else sc->slvector.reserve(end - start);
 
     u_int32_t numSamples = 0;
     for(uint32_t pointIndx = start; pointIndx < end; pointIndx++)
@@ -644,6 +681,25 @@ void* GeoIndexedRaster::samplesCollectThread(void* param)
 
         const point_groups_t& pg = sc->pointsGroups[pointIndx];
 
+        /* Columnar results, write samples directly into buffer */
+        if(sc->buffer)
+        {
+            const GroupOrdering::Iterator iter(*pg.groupList);
+            for(int i = 0; i < iter.length; i++)
+            {
+                const rasters_group_t* rgroup = iter[i].value;
+                uint32_t flags = 0;
+
+                /* Get flags value for this group of rasters */
+                if(sc->obj->parms->flags_file && rgroup->hasFlags)
+                    flags = getBatchGroupFlags(rgroup, pointIndx);
+
+                sc->ssErrors |= sc->obj->getBatchGroupSamples(rgroup, *sc->buffer, flags, pointIndx);
+            }
+            sc->buffer->endPoint();
+            continue;
+        }
+
         /* Allocate a new sample list for groupList */
         sample_list_t* slist = new sample_list_t();
 
@@ -664,40 +720,12 @@ void* GeoIndexedRaster::samplesCollectThread(void* param)
         sc->slvector.push_back(slist);
     }
 
+    if(sc->buffer) numSamples = sc->buffer->numSamples();
     mlog(DEBUG, "Collected %u samples for range: %u - %u", numSamples, start, end);
 
     return NULL;
 }
 
-/*----------------------------------------------------------------------------
- * createBatchReaderThreads
- *----------------------------------------------------------------------------*/
-bool GeoIndexedRaster::createBatchReaderThreads(uint32_t rasters2sample)
-{
-    const int threadsNeeded = rasters2sample;
-    const int threadsNow    = batchReaders.length();
-    const int newThreadsCnt = threadsNeeded - threadsNow;
-
-    if(threadsNeeded <= threadsNow)
-        return true;
-
-    try
-    {
-        for(int i = 0; i < newThreadsCnt; i++)
-        {
-            BatchReader* r = new BatchReader(this);
-            batchReaders.add(r);
-        }
-    }
-    catch (const RunTimeException &e)
-    {
-        ssErrors |= SS_RESOURCE_LIMIT_ERROR;
-        mlog(CRITICAL, "Failed to create batch reader threads");
-    }
-
-    return batchReaders.length() == threadsNeeded;
-}
-
 /*----------------------------------------------------------------------------
  * findAllGroups
  *----------------------------------------------------------------------------*/
@@ -989,65 +1017,22 @@ bool GeoIndexedRaster::sampleUniqueRasters(const vector<unique_raster_t*>& uniqu
 
     try
     {
-        /* Testing has shown that 20 threads performs twice as fast on a 8 core system than 50 or 100 threads. */
-        const uint32_t maxThreads = 20;
+        /* Rasters are read by the node wide executor, fairly shared with other requests */
+        RasterReadExecutor::Client reader(readRaster, this);
 
-        /* Create batch reader threads */
         const uint32_t numRasters = uniqueRasters.size();
-        createBatchReaderThreads(std::min(maxThreads, numRasters));
-
-        const uint32_t numThreads = batchReaders.length();
-        mlog(samplingLogLevel, "Sampling %u rasters with %u threads", numRasters, numThreads);
-
-        /* Sample unique rasters utilizing numThreads */
-        uint32_t currentRaster = 0;
-        activeReaders.store(0);
+        mlog(samplingLogLevel, "Sampling %u rasters, %ld reads in flight on server", numRasters, RasterReadExecutor::getStats().inflight);
 
-        while(currentRaster < numRasters)
+        for(unique_raster_t* ur : uniqueRasters)
         {
-            /* Calculate how many rasters we can process in this batch */
-            const uint32_t batchSize = std::min(numThreads, numRasters - currentRaster);
-
-            /* Assign rasters to batch readers as soon as they are free */
-            while(currentRaster < numRasters || activeReaders.load() > 0)
-            {
-                bool dispatched = false;
-                for(uint32_t i = 0; i < batchSize; i++)
-                {
-                    BatchReader* breader = batchReaders[i];
-
-                    breader->sync.lock();
-                    {
-                        /* If this thread is done with its previous raster, assign a new one */
-                        if(breader->uraster == NULL && currentRaster < numRasters)
-                        {
-                            breader->uraster = uniqueRasters[currentRaster++];
-                            activeReaders.fetch_add(1);
-                            breader->sync.signal(DATA_TO_SAMPLE, Cond::NOTIFY_ONE);
-                            dispatched = true;
-                        }
-                    }
-                    breader->sync.unlock();
-
-                    if(!sampling())
-                    {
-                        /* Sampling has been stopped, stop assigning new rasters */
-                        currentRaster = numRasters;
-                        break;
-                    }
-                }
-
-                /* If no new work was dispatched, wait for any reader to finish */
-                if(activeReaders.load() > 0 && !dispatched)
-                {
-                    readerDone.wait(DATA_SAMPLED, SYS_TIMEOUT);
-                }
-            }
+            reader.submit(ur);
         }
 
-        /* Wait for all batch readers to finish sampling */
-        while(activeReaders.load() > 0)
-            readerDone.wait(DATA_SAMPLED, SYS_TIMEOUT);
+        /* Wait for all reads to complete, dropping queued reads if sampling is stopped */
+        while(!reader.wait(SYS_TIMEOUT))
+        {
+            if(!sampling()) reader.cancel();
+        }
 
         status = true;
     }
@@ -1065,7 +1050,7 @@ bool GeoIndexedRaster::sampleUniqueRasters(const vector<unique_raster_t*>& uniqu
 /*----------------------------------------------------------------------------
  * collectSamples
  *----------------------------------------------------------------------------*/
-bool GeoIndexedRaster::collectSamples(const vector<point_groups_t>& pointsGroups, List<sample_list_t*>& sllist)
+bool GeoIndexedRaster::collectSamples(const vector<point_groups_t>& pointsGroups, List<sample_list_t*>* sllist, RasterSampleBuffer* buffer)
 {
     /* Do not collect samples if sampling stopped */
     if(!sampling()) return true;
@@ -1093,6 +1078,7 @@ bool GeoIndexedRaster::collectSamples(const vector<point_groups_t>& pointsGroups
     {
         SampleCollector* sc = new SampleCollector(this, pointsGroups);
         sc->pGroupsRange = pGroupRanges[i];
+        if(buffer) sc->buffer = new RasterSampleBuffer(hasZonalStats(), hasSpatialDerivs());
         sampleCollectors.push_back(sc);
         Thread* pid = new Thread(samplesCollectThread, sc);
         pids.push_back(pid);
@@ -1109,62 +1095,36 @@ bool GeoIndexedRaster::collectSamples(const vector<point_groups_t>& pointsGroups
     mlog(DEBUG, "Merging sample lists");
     for(SampleCollector* sc : sampleCollectors)
     {
+        /* Columnar results, pad points not collected (sampling stopped) and append in point order */
+        if(sc->buffer)
+        {
+            while(sc->buffer->numPoints() < (sc->pGroupsRange.end - sc->pGroupsRange.start))
+            {
+                sc->buffer->endPoint();
+            }
+            for(const uint64_t file_id : sc->buffer->fileId)
+            {
+                fileDict.setSample(file_id);
+            }
+            buffer->merge(*sc->buffer);
+        }
+
         const vector<sample_list_t*>& slvector = sc->slvector;
         for(sample_list_t* slist : slvector)
         {
             /* Update file dictionary */
             fileDictSetSamples(slist);
 
-            sllist.add(slist);
+            sllist->add(slist);
         }
         ssErrors |= sc->ssErrors;
         delete sc;
     }
-    mlog(DEBUG, "Merged %d sample lists, time: %lf", sllist.length(), TimeLib::latchtime() - mergeStart);
+    const int numLists = sllist ? sllist->length() : static_cast<int>(buffer->numPoints());
+    mlog(DEBUG, "Merged %d sample lists, time: %lf", numLists, TimeLib::latchtime() - mergeStart);
 
     perfStats.collectSamplesTime = TimeLib::latchtime() - start;
-    mlog(DEBUG, "Populated sllist with %d lists of samples, time: %lf", sllist.length(), perfStats.collectSamplesTime);
+    mlog(DEBUG, "Populated sllist with %d lists of samples, time: %lf", numLists, perfStats.collectSamplesTime);
 
     return true;
 }
-
-/*----------------------------------------------------------------------------
- * getConvexHull
- *----------------------------------------------------------------------------*/
-OGRGeometry* GeoIndexedRaster::getConvexHull(const vector<point_info_t>* points)
-{
-    if(points->empty())
-        return NULL;
-
-    /* Create an empty geometry collection to hold all points */
-    OGRGeometryCollection geometryCollection;
-
-    mlog(DEBUG, "Creating convex hull from %zu points", points->size());
-
-    /* Collect all points into a geometry collection */
-    for(const point_info_t& pinfo : *points)
-    {
-        const double lon = pinfo.point3d.x;
-        const double lat = pinfo.point3d.y;
-
-        OGRPoint* point = new OGRPoint(lon, lat);
-        geometryCollection.addGeometryDirectly(point);
-    }
-
-    /* Create a convex hull that wraps around all the points */
-    OGRGeometry* convexHull = geometryCollection.ConvexHull();
-    if(convexHull == NULL)
-    {
-        mlog(ERROR, "Failed to create a convex hull around points.");
-        return NULL;
-    }
-
-    /* Add a buffer around the convex hull to avoid missing edge points */
-    OGRGeometry* bufferedConvexHull = convexHull->Buffer(TOLERANCE);
-    if(bufferedConvexHull)
-    {
-        OGRGeometryFactory::destroyGeometry(convexHull);
-    }
-
-    return bufferedConvexHull;
-}
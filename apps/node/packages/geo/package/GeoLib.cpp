@@ -34,6 +34,12 @@
  ******************************************************************************/
 
 #include <cmath>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <signal.h>
 #include <tiffio.h>
 #include <gdal.h>
 #include <ogr_spatialref.h>
@@ -44,6 +50,7 @@
 #include "LuaObject.h"
 #include "GdalRaster.h"
 #include "GeoJsonRaster.h"
+#include "SystemConfig.h"
 
 /******************************************************************************
  * LOCAL TYPES
@@ -294,6 +301,9 @@ const struct luaL_Reg GeoLib::TIFFImage::LUA_META_TABLE[] = {
     {NULL,          NULL}
 };
 
+Mutex GeoLib::TIFFImage::imageMut;
+std::map<string, std::shared_ptr<GeoLib::TIFFImage::entry_t>> GeoLib::TIFFImage::images;
+
 /*----------------------------------------------------------------------------
  * luaCreate
  *----------------------------------------------------------------------------*/
@@ -314,10 +324,209 @@ int GeoLib::TIFFImage::luaCreate (lua_State* L)
 
 /*----------------------------------------------------------------------------
  * Constructor
+ *
+ *  Pixels are shared by every image opened on the same file; the first
+ *  open decodes the file into a tiled layout which is written to the mask
+ *  cache directory so that subsequent opens (in this or any other process)
+ *  just map it read-only
  *----------------------------------------------------------------------------*/
 GeoLib::TIFFImage::TIFFImage(lua_State* L, const char* filename, long driver):
-    LuaObject(L, OBJECT_TYPE, LUA_META_NAME, LUA_META_TABLE)
+    LuaObject(L, OBJECT_TYPE, LUA_META_NAME, LUA_META_TABLE),
+    image(loadImage(filename, driver)),
+    width(image->hdr.width),
+    height(image->hdr.height),
+    typesize(image->hdr.typesize),
+    tilesX(image->hdr.tiles_x),
+    raster(image->raster),
+    type(static_cast<RecordObject::fieldType_t>(image->hdr.type))
+{
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor
+ *----------------------------------------------------------------------------*/
+GeoLib::TIFFImage::~TIFFImage(void) = default;
+
+/*----------------------------------------------------------------------------
+ * Destructor - image_t
+ *----------------------------------------------------------------------------*/
+GeoLib::TIFFImage::image_t::~image_t(void)
+{
+    if(map) munmap(map, map_size);
+    if(heap) operator delete[](heap, std::align_val_t(RASTER_DATA_ALIGNMENT));
+}
+
+/*----------------------------------------------------------------------------
+ * getPixel
+ *----------------------------------------------------------------------------*/
+GeoLib::TIFFImage::val_t GeoLib::TIFFImage::getPixel(uint32_t x, uint32_t y) const
+{
+    val_t val = {.u64 = INVALID_PIXEL};
+    const uint64_t index = (static_cast<uint64_t>(y) * width) + x;
+
+    if(index < (static_cast<uint64_t>(width) * height))
+    {
+        if(x >= width)
+        {
+            // columns past the edge wrap onto the next row as in a row-major raster
+            x = index % width;
+            y = index / width;
+        }
+
+        const uint64_t offset = tileIndex(x, y, tilesX) * typesize;
+        switch(typesize)
+        {
+            case 1:
+            {
+                val.u8 = raster[offset];
+                break;
+            }
+            case 2:
+            {
+                const uint16_t* valptr = reinterpret_cast<const uint16_t*>(&raster[offset]);
+                val.u16 = *valptr;
+                break;
+            }
+            case 4:
+            {
+                const uint32_t* valptr = reinterpret_cast<const uint32_t*>(&raster[offset]);
+                val.u32 = *valptr;
+                break;
+            }
+            case 8:
+            {
+                const uint64_t* valptr = reinterpret_cast<const uint64_t*>(&raster[offset]);
+                val.u64 = *valptr;
+                break;
+            }
+        }
+    }
+
+    return val;
+}
+
+/*----------------------------------------------------------------------------
+ * getPixels - copies pixels out of tiles into a row-major raster
+ *----------------------------------------------------------------------------*/
+void GeoLib::TIFFImage::getPixels(void* dst) const
+{
+    uint8_t* _dst = reinterpret_cast<uint8_t*>(dst);
+    for(uint32_t y = 0; y < height; y++)
+    {
+        for(uint32_t x = 0; x < width; x += TILE_MASK + 1)
+        {
+            const uint32_t num_pixels = MIN(TILE_MASK + 1, width - x);
+            const uint64_t src = tileIndex(x, y, tilesX);
+            memcpy(&_dst[((static_cast<uint64_t>(y) * width) + x) * typesize], &raster[src * typesize], num_pixels * typesize);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * getWidth
+ *----------------------------------------------------------------------------*/
+uint32_t GeoLib::TIFFImage::getWidth(void) const
+{
+    return width;
+}
+
+/*----------------------------------------------------------------------------
+ * getLength
+ *----------------------------------------------------------------------------*/
+uint32_t GeoLib::TIFFImage::getHeight() const
+{
+    return height;
+}
+
+/*----------------------------------------------------------------------------
+ * loadImage
+ *----------------------------------------------------------------------------*/
+std::shared_ptr<GeoLib::TIFFImage::image_t> GeoLib::TIFFImage::loadImage(const char* filename, long driver)
+{
+    if(driver != LIBTIFF_DRIVER && driver != GDAL_DRIVER)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "Invalid driver selected: %ld", driver);
+    }
+
+    /* identify the file by its name, driver, and version on disk */
+    string key = FString("%s:%ld", filename, driver).c_str();
+    struct stat st;
+    const bool local = (stat(filename, &st) == 0);
+    if(local) key += FString(":%ld:%ld", static_cast<long>(st.st_size), static_cast<long>(st.st_mtime)).c_str();
+
+    /* find or create the registry entry for this image */
+    std::shared_ptr<entry_t> entry;
+    imageMut.lock();
+    {
+        /* forget images no longer in use and not being loaded */
+        for(auto it = images.begin(); it != images.end();)
+        {
+            if(it->second->image.expired() && it->second.use_count() == 1) it = images.erase(it);
+            else it++;
+        }
+
+        std::shared_ptr<entry_t>& slot = images[key];
+        if(!slot) slot = make_shared<entry_t>();
+        entry = slot;
+    }
+    imageMut.unlock();
+
+    /* only one thread loads a given image at a time so a file is decoded at most once,
+     * while different images are loaded concurrently */
+    std::shared_ptr<image_t> image;
+    entry->mut.lock();
+    try
+    {
+        /* share image already loaded by another object */
+        image = entry->image.lock();
+
+        if(!image)
+        {
+            /* map image previously cached to disk */
+            string path;
+            const string& cache_dir = SystemConfig::settings().maskCacheDirectory.value;
+            if(local && !cache_dir.empty())
+            {
+                path = cache_dir + "/" + cacheName(filename, driver, key);
+                image = mapImage(path.c_str());
+            }
+
+            /* decode image and cache it to disk */
+            if(!image)
+            {
+                image = decodeImage(filename, driver);
+                if(!path.empty() && writeImage(path.c_str(), *image))
+                {
+                    removeStaleImages(cache_dir.c_str(), cacheName(filename, driver, key));
+                    std::shared_ptr<image_t> mapped_image = mapImage(path.c_str());
+                    if(mapped_image) image = mapped_image;
+                }
+            }
+
+            entry->image = image;
+        }
+    }
+    catch(...)
+    {
+        entry->mut.unlock();
+        throw;
+    }
+    entry->mut.unlock();
+
+    return image;
+}
+
+/*----------------------------------------------------------------------------
+ * decodeImage
+ *----------------------------------------------------------------------------*/
+std::shared_ptr<GeoLib::TIFFImage::image_t> GeoLib::TIFFImage::decodeImage(const char* filename, long driver)
 {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t typesize = 0;
+    uint8_t* raster = NULL;
+    RecordObject::fieldType_t type = RecordObject::INVALID_FIELD;
+
     if(driver == LIBTIFF_DRIVER)
     {
         TIFF* tif = TIFFOpen(filename, "r");
@@ -329,20 +538,21 @@ GeoLib::TIFFImage::TIFFImage(lua_State* L, const char* filename, long driver):
 
         mlog(INFO, "Reading image %s which is %u x %u pixels", filename, width, height);
 
-        size = width * height * typesize;
+        const uint64_t size = static_cast<uint64_t>(width) * height * typesize;
         raster = new  (std::align_val_t(RASTER_DATA_ALIGNMENT)) uint8_t[size];
         type = RecordObject::UINT32;
 
         uint32_t* _raster = reinterpret_cast<uint32_t*>(raster);
         if(!TIFFReadRGBAImage(tif, width, height, _raster, 0))
         {
+            TIFFClose(tif);
             operator delete[](raster, std::align_val_t(RASTER_DATA_ALIGNMENT));
             throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to read tiff file: %s", filename);
         }
 
         TIFFClose(tif);
     }
-    else if(driver == GDAL_DRIVER)
+    else // GDAL_DRIVER
     {
         GDALDataset* dataset = static_cast<GDALDataset*>(GDALOpen(filename, GA_ReadOnly));
         if(!dataset) throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to open tiff file: %s", filename);
@@ -354,7 +564,7 @@ GeoLib::TIFFImage::TIFFImage(lua_State* L, const char* filename, long driver):
 
         mlog(INFO, "Reading image %s which is %u x %u pixels", filename, width, height);
 
-        size = width * height * typesize;
+        const uint64_t size = static_cast<uint64_t>(width) * height * typesize;
         raster = new  (std::align_val_t(RASTER_DATA_ALIGNMENT)) uint8_t[size];
         void* _data = const_cast<void*>(reinterpret_cast<const void*>(raster));
         const OGRErr err = band->RasterIO(GF_Read, 0, 0, width, height, _data, width, height, dtype, 0, 0);
@@ -381,75 +591,168 @@ GeoLib::TIFFImage::TIFFImage(lua_State* L, const char* filename, long driver):
             throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to read tiff file: %s", filename);
         }
     }
-    else
+
+    /* populate header */
+    std::shared_ptr<image_t> image = make_shared<image_t>();
+    image->hdr.magic = MAPPED_IMAGE_MAGIC;
+    image->hdr.width = width;
+    image->hdr.height = height;
+    image->hdr.typesize = typesize;
+    image->hdr.type = static_cast<uint32_t>(type);
+    image->hdr.tiles_x = (width + TILE_MASK) >> TILE_SHIFT;
+    image->hdr.tiles_y = (height + TILE_MASK) >> TILE_SHIFT;
+    image->hdr.size = static_cast<uint64_t>(image->hdr.tiles_x) * image->hdr.tiles_y * (TILE_MASK + 1) * (TILE_MASK + 1) * typesize;
+
+    /* rearrange rows of pixels into tiles */
+    image->heap = new (std::align_val_t(RASTER_DATA_ALIGNMENT)) uint8_t[image->hdr.size];
+    memset(image->heap, 0, image->hdr.size);
+    for(uint32_t y = 0; y < height; y++)
     {
-        throw RunTimeException(CRITICAL, RTE_FAILURE, "Invalid driver selected: %ld", driver);
+        for(uint32_t tx = 0; tx < image->hdr.tiles_x; tx++)
+        {
+            const uint32_t x = tx << TILE_SHIFT;
+            const uint32_t num_pixels = MIN(TILE_MASK + 1, width - x);
+            const uint64_t src = (static_cast<uint64_t>(y) * width) + x;
+            const uint64_t dst = tileIndex(x, y, image->hdr.tiles_x);
+            memcpy(&image->heap[dst * typesize], &raster[src * typesize], num_pixels * typesize);
+        }
     }
+    image->raster = image->heap;
+    operator delete[](raster, std::align_val_t(RASTER_DATA_ALIGNMENT));
+
+    return image;
 }
 
 /*----------------------------------------------------------------------------
- * Destructor
+ * mapImage
  *----------------------------------------------------------------------------*/
-GeoLib::TIFFImage::~TIFFImage(void)
+std::shared_ptr<GeoLib::TIFFImage::image_t> GeoLib::TIFFImage::mapImage(const char* path)
 {
-    operator delete[](raster, std::align_val_t(RASTER_DATA_ALIGNMENT));
+    std::shared_ptr<image_t> image;
+
+    const int fd = open(path, O_RDONLY);
+    if(fd < 0) return image;
+
+    struct stat st;
+    image_hdr_t hdr;
+    if( (fstat(fd, &st) == 0) &&
+        (pread(fd, &hdr, sizeof(hdr), 0) == sizeof(hdr)) &&
+        (hdr.magic == MAPPED_IMAGE_MAGIC) &&
+        (static_cast<uint64_t>(st.st_size) == (MAPPED_IMAGE_HDR_SIZE + hdr.size)) )
+    {
+        void* map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if(map != MAP_FAILED)
+        {
+            image = make_shared<image_t>();
+            image->hdr = hdr;
+            image->map = map;
+            image->map_size = st.st_size;
+            image->raster = reinterpret_cast<const uint8_t*>(map) + MAPPED_IMAGE_HDR_SIZE;
+            mlog(INFO, "Mapped image %s which is %u x %u pixels", path, hdr.width, hdr.height);
+        }
+        else
+        {
+            char errbuf[256];
+            mlog(WARNING, "Failed to map image %s: %s", path, strerror_r(errno, errbuf, sizeof(errbuf)));
+        }
+    }
+    else
+    {
+        mlog(WARNING, "Ignoring invalid cached image %s", path);
+    }
+
+    close(fd);
+    return image;
 }
 
 /*----------------------------------------------------------------------------
- * getPixel
+ * writeImage
  *----------------------------------------------------------------------------*/
-GeoLib::TIFFImage::val_t GeoLib::TIFFImage::getPixel(uint32_t x, uint32_t y)
+bool GeoLib::TIFFImage::writeImage(const char* path, const image_t& image)
 {
-    val_t val = {.u64 = INVALID_PIXEL};
-    const uint32_t offset = ((y * width) + x) * typesize;
+    /* write to temporary file so readers never see a partial image */
+    const FString tmp_path("%s.%d.%ld.tmp", path, getpid(), Thread::getId());
+    FILE* fp = fopen(tmp_path.c_str(), "w");
+    if(!fp)
+    {
+        char errbuf[256];
+        mlog(WARNING, "Failed to cache image to %s: %s", tmp_path.c_str(), strerror_r(errno, errbuf, sizeof(errbuf)));
+        return false;
+    }
 
-    if(offset < size)
+    uint8_t hdr[MAPPED_IMAGE_HDR_SIZE] = {0};
+    memcpy(hdr, &image.hdr, sizeof(image_hdr_t));
+    bool status = (fwrite(hdr, 1, MAPPED_IMAGE_HDR_SIZE, fp) == MAPPED_IMAGE_HDR_SIZE) &&
+                  (fwrite(image.raster, 1, image.hdr.size, fp) == image.hdr.size);
+    status = (fclose(fp) == 0) && status;
+
+    /* atomically replace any existing image */
+    if(status) status = (rename(tmp_path.c_str(), path) == 0);
+    if(!status)
     {
-        switch(typesize)
-        {
-            case 1:
-            {
-                val.u8 = raster[offset];
-                break;
-            }
-            case 2:
-            {
-                const uint16_t* valptr = reinterpret_cast<uint16_t*>(&raster[offset]);
-                val.u16 = *valptr;
-                break;
-            }
-            case 4:
-            {
-                const uint32_t* valptr = reinterpret_cast<uint32_t*>(&raster[offset]);
-                val.u32 = *valptr;
-                break;
-            }
-            case 8:
-            {
-                const uint64_t* valptr = reinterpret_cast<uint64_t*>(&raster[offset]);
-                val.u64 = *valptr;
-                break;
-            }
-        }
+        mlog(WARNING, "Failed to cache image to %s", path);
+        remove(tmp_path.c_str());
     }
 
-    return val;
+    return status;
 }
 
 /*----------------------------------------------------------------------------
- * getWidth
+ * cacheName
+ *
+ *  <basename>.<source hash>.<version hash>.slmask - every version of a source
+ *  file shares the same prefix so that stale versions can be found and removed
  *----------------------------------------------------------------------------*/
-uint32_t GeoLib::TIFFImage::getWidth(void) const
+string GeoLib::TIFFImage::cacheName(const char* filename, long driver, const string& key)
 {
-    return width;
+    const char* basename = strrchr(filename, '/');
+    basename = basename ? basename + 1 : filename;
+    const unsigned long source_hash = std::hash<string>{}(FString("%s:%ld", filename, driver).c_str());
+    const unsigned long version_hash = std::hash<string>{}(key);
+    return FString("%s.%016lx.%016lx.slmask", basename, source_hash, version_hash).c_str();
 }
 
 /*----------------------------------------------------------------------------
- * getLength
+ * removeStaleImages
+ *
+ *  removes cached images of older versions of the same source file, and
+ *  temporary files left behind by writers that no longer exist
  *----------------------------------------------------------------------------*/
-uint32_t GeoLib::TIFFImage::getHeight() const
+void GeoLib::TIFFImage::removeStaleImages(const char* cache_dir, const string& name)
 {
-    return height;
+    const string prefix = name.substr(0, name.rfind('.', name.size() - sizeof(".slmask")) + 1);
+
+    DIR* dir = opendir(cache_dir);
+    if(!dir) return;
+
+    const struct dirent* ent;
+    while((ent = readdir(dir)) != NULL)
+    {
+        const string file = ent->d_name;
+        if(file == name || file.compare(0, prefix.size(), prefix) != 0) continue;
+
+        bool stale = false;
+        const size_t ext = file.find(".slmask", prefix.size());
+        if(ext == file.size() - 7)
+        {
+            /* older version of the image */
+            stale = true;
+        }
+        else if(ext != string::npos && file.size() > 4 && file.compare(file.size() - 4, 4, ".tmp") == 0)
+        {
+            /* partial image of a writer that died: <name>.<pid>.<tid>.tmp */
+            const long pid = strtol(file.c_str() + ext + 8, NULL, 10);
+            stale = (pid > 0) && (pid != getpid()) && (kill(static_cast<pid_t>(pid), 0) != 0) && (errno == ESRCH);
+        }
+
+        if(stale)
+        {
+            const string path = string(cache_dir) + "/" + file;
+            if(remove(path.c_str()) == 0) mlog(INFO, "Removed stale cached image %s", path.c_str());
+        }
+    }
+
+    closedir(dir);
 }
 
 /*----------------------------------------------------------------------------
@@ -528,8 +831,9 @@ int GeoLib::TIFFImage::luaConvertToBMP (lua_State* L)
         {
             /* special case conversion of 64-bit floats to scaled 32-bit unsigned ints */
             const uint32_t num_elements = lua_obj->width * lua_obj->height;
-            const double* _raster = reinterpret_cast<double*>(lua_obj->raster);
+            double* _raster = new double [num_elements];
             uint32_t* data = new uint32_t [num_elements];
+            lua_obj->getPixels(_raster);
             double minval =  std::numeric_limits<double>::max();
             double maxval =  std::numeric_limits<double>::min();
             for(uint32_t i = 0; i < num_elements; i++)
@@ -543,6 +847,7 @@ int GeoLib::TIFFImage::luaConvertToBMP (lua_State* L)
             {
                 data[i] = (_raster[i] - minval) / resolution;
             }
+            delete [] _raster;
             status = GeoLib::writeBMP(data, lua_obj->width, lua_obj->height, bmp_filename);
             delete [] data;
         }
@@ -550,11 +855,14 @@ int GeoLib::TIFFImage::luaConvertToBMP (lua_State* L)
         {
             /* special case conversion of 8-bit integers to 32-bit unsigned ints */
             const uint32_t num_elements = lua_obj->width * lua_obj->height;
+            uint8_t* _raster = new uint8_t [num_elements];
             uint32_t* data = new uint32_t [num_elements];
+            lua_obj->getPixels(_raster);
             for(uint32_t i = 0; i < num_elements; i++)
             {
-                data[i] = lua_obj->raster[i];
+                data[i] = _raster[i];
             }
+            delete [] _raster;
             status = GeoLib::writeBMP(data, lua_obj->width, lua_obj->height, bmp_filename);
             delete [] data;
         }
@@ -565,8 +873,10 @@ int GeoLib::TIFFImage::luaConvertToBMP (lua_State* L)
         else
         {
             /* just use the value as-is if it is 32 bits */
-            const uint32_t* _raster = reinterpret_cast<uint32_t*>(lua_obj->raster);
+            uint32_t* _raster = new uint32_t [lua_obj->width * lua_obj->height];
+            lua_obj->getPixels(_raster);
             status = GeoLib::writeBMP(_raster, lua_obj->width, lua_obj->height, bmp_filename);
+            delete [] _raster;
         }
     }
     catch(const RunTimeException& e)
@@ -38,6 +38,9 @@
 #include "RegionMask.h"
 #include "MathLib.h"
 
+#include <map>
+#include <memory>
+
 class GeoLib: public MathLib
 {
     public:
@@ -73,7 +76,13 @@ class GeoLib: public MathLib
 
         class TIFFImage: public LuaObject
         {
+            friend class UT_TIFFImage; // necessary for exercising tile layout and mask cache
+
             static const int RASTER_DATA_ALIGNMENT = 8;
+            static const uint32_t TILE_SHIFT = 8; // 256 x 256 pixel tiles
+            static const uint32_t TILE_MASK = (1 << TILE_SHIFT) - 1;
+            static const uint64_t MAPPED_IMAGE_MAGIC = 0x31304B53414D4C53L; // "SLMASK01"
+            static const size_t MAPPED_IMAGE_HDR_SIZE = 4096; // keeps pixels page aligned
 
             public:
                 static const char* OBJECT_TYPE;
@@ -97,18 +106,54 @@ class GeoLib: public MathLib
                 } val_t;
                 TIFFImage (lua_State* L, const char* filename, long driver=LIBTIFF_DRIVER);
                 ~TIFFImage (void) override;
-                val_t getPixel (uint32_t x, uint32_t y);
+                val_t getPixel (uint32_t x, uint32_t y) const;
                 uint32_t getWidth (void) const;
                 uint32_t getHeight (void) const;
             private:
+                typedef struct {
+                    uint64_t magic;
+                    uint32_t width;
+                    uint32_t height;
+                    uint32_t typesize;
+                    uint32_t type;
+                    uint32_t tiles_x;
+                    uint32_t tiles_y;
+                    uint64_t size;
+                } image_hdr_t;
+                struct image_t {
+                    image_hdr_t hdr;
+                    const uint8_t* raster;  // tiled pixels
+                    uint8_t* heap;          // set when pixels could not be mapped
+                    void* map;              // set when pixels are mapped from the cache file
+                    size_t map_size;
+                    image_t(void): hdr{}, raster(NULL), heap(NULL), map(NULL), map_size(0) {}
+                    ~image_t(void);
+                };
+                static uint64_t tileIndex (uint32_t x, uint32_t y, uint32_t tiles_x) {
+                    const uint64_t tile = (static_cast<uint64_t>(y >> TILE_SHIFT) * tiles_x) + (x >> TILE_SHIFT);
+                    return (tile << (2 * TILE_SHIFT)) + ((y & TILE_MASK) << TILE_SHIFT) + (x & TILE_MASK); }
+                struct entry_t {
+                    Mutex mut;                      // serializes loading of this image
+                    std::weak_ptr<image_t> image;   // shared by every object opened on the image
+                };
+                static std::shared_ptr<image_t> loadImage (const char* filename, long driver);
+                static std::shared_ptr<image_t> decodeImage (const char* filename, long driver);
+                static std::shared_ptr<image_t> mapImage (const char* path);
+                static bool writeImage (const char* path, const image_t& image);
+                static string cacheName (const char* filename, long driver, const string& key);
+                static void removeStaleImages (const char* cache_dir, const string& name);
+                void getPixels (void* dst) const;
                 static int luaDimensions (lua_State* L);
                 static int luaPixel (lua_State* L);
                 static int luaConvertToBMP (lua_State* L);
+                static Mutex imageMut; // protects the registry only, not the loading of images
+                static std::map<string, std::shared_ptr<entry_t>> images;
+                std::shared_ptr<image_t> image;
                 uint32_t width;
                 uint32_t height;
                 uint32_t typesize;
-                uint32_t size;
-                uint8_t* raster;
+                uint32_t tilesX;
+                const uint8_t* raster;
                 RecordObject::fieldType_t type;
         };
 
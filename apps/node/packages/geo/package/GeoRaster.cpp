@@ -98,12 +98,63 @@ uint32_t GeoRaster::samplePointBands(const point_info_t& pinfo, sample_list_t& s
     return raster.getSSerror() | ssErrors;
 }
 
+/*----------------------------------------------------------------------------
+ * samplePointBands - columnar results
+ *
+ *  sample is scratch space reused for every point and band sampled
+ *----------------------------------------------------------------------------*/
+uint32_t GeoRaster::samplePointBands(const point_info_t& pinfo, RasterSampleBuffer& buffer,
+                                     const vector<int>& bands, RasterSample& sample)
+{
+    uint32_t ssErrors = SS_NO_ERRORS;
+
+    try
+    {
+        for(const int bandNum : bands)
+        {
+            /* Must create OGRPoint for each bandNum, samplePOI projects it to raster CRS */
+            OGRPoint ogrPoint(pinfo.point3d.x, pinfo.point3d.y, pinfo.point3d.z);
+            sample.clear();
+            if(raster.samplePOI(&ogrPoint, bandNum, sample)) buffer.append(sample);
+            ssErrors |= raster.getSSerror();
+        }
+    }
+    catch (const RunTimeException &e)
+    {
+        ssErrors |= SS_RUNTIME_ERROR;
+        mlog(e.level(), "Error getting samples: %s", e.what());
+    }
+
+    buffer.endPoint();
+
+    return ssErrors;
+}
+
 /*----------------------------------------------------------------------------
  * getSamples
  *----------------------------------------------------------------------------*/
 uint32_t GeoRaster::getSamples(const vector<point_info_t>& points, List<sample_list_t*>& sllist, void* param)
 {
     static_cast<void>(param);
+    return samplePoints(points, &sllist, NULL);
+}
+
+/*----------------------------------------------------------------------------
+ * getSamples - columnar results
+ *----------------------------------------------------------------------------*/
+uint32_t GeoRaster::getSamples(const vector<point_info_t>& points, RasterSampleBuffer& buffer, void* param)
+{
+    static_cast<void>(param);
+    buffer.configure(hasZonalStats(), hasSpatialDerivs());
+    buffer.reserve(points.size());
+    return samplePoints(points, NULL, &buffer);
+}
+
+/*----------------------------------------------------------------------------
+ * samplePoints - returns either sample lists or columnar results
+ *----------------------------------------------------------------------------*/
+uint32_t GeoRaster::samplePoints(const vector<point_info_t>& points, List<sample_list_t*>* sllist, RasterSampleBuffer* buffer)
+{
     uint32_t ssErrors = SS_NO_ERRORS;
 
     lockSampling();
@@ -128,11 +179,18 @@ uint32_t GeoRaster::getSamples(const vector<point_info_t>& points, List<sample_l
         if(numThreads == 1)
         {
             /* Single thread, read all samples in one thread using this RasterObject */
-            vector<sample_list_t*> samples;
-            ssErrors = readSamples(this, ranges[0], points, samples);
-            for(sample_list_t* slist : samples)
+            if(buffer)
+            {
+                ssErrors = readSamples(this, ranges[0], points, *buffer);
+            }
+            else
             {
-                sllist.add(slist);
+                vector<sample_list_t*> samples;
+                ssErrors = readSamples(this, ranges[0], points, samples);
+                for(sample_list_t* slist : samples)
+                {
+                    sllist->add(slist);
+                }
             }
         }
         else
@@ -144,6 +202,7 @@ uint32_t GeoRaster::getSamples(const vector<point_info_t>& points, List<sample_l
             {
                 reader_t* reader = new reader_t(this, rqstParms, samplerKey, getCRS(), points);
                 reader->range = ranges[i];
+                if(buffer) reader->buffer = new RasterSampleBuffer(hasZonalStats(), hasSpatialDerivs());
                 readersMut.lock();
                 {
                     readers.push_back(reader);
@@ -165,6 +224,22 @@ uint32_t GeoRaster::getSamples(const vector<point_info_t>& points, List<sample_l
                 /* Acumulate errors from all reader threads */
                 ssErrors |= reader->ssErrors;
 
+                /* Columnar results, translate file ids and append in point order */
+                if(reader->buffer)
+                {
+                    while(reader->buffer->numPoints() < (reader->range.end - reader->range.start))
+                    {
+                        reader->buffer->endPoint();
+                    }
+                    for(uint64_t& file_id : reader->buffer->fileId)
+                    {
+                        const char* name = reader->fileDict ? reader->fileDict->get(file_id) : "";
+                        file_id = fileDict.add(name, true);
+                    }
+                    buffer->merge(*reader->buffer);
+                    continue;
+                }
+
                 for(sample_list_t* slist : reader->samples)
                 {
                     for(int32_t i = 0; i < slist->length(); i++)
@@ -181,7 +256,7 @@ uint32_t GeoRaster::getSamples(const vector<point_info_t>& points, List<sample_l
                         sample->fileId = fileDict.add(name, true);
                     }
 
-                    sllist.add(slist);
+                    sllist->add(slist);
                 }
             }
 
@@ -327,6 +402,7 @@ GeoRaster::Reader::Reader(GeoRaster* _owner, RequestParameters* _rqstParms, cons
     robj(NULL),
     range({0, 0}),
     points(_points),
+    buffer(NULL),
     ssErrors(SS_NO_ERRORS),
     fileDict(NULL)
 {
@@ -337,6 +413,7 @@ GeoRaster::Reader::Reader(GeoRaster* _owner, RequestParameters* _rqstParms, cons
  *----------------------------------------------------------------------------*/
 GeoRaster::Reader::~Reader(void)
 {
+    delete buffer;
     delete fileDict;
 }
 
@@ -363,7 +440,8 @@ void* GeoRaster::readerThread(void* parm)
     }
     reader->owner->readersMut.unlock();
 
-    reader->ssErrors = readSamples(robj, reader->range, reader->points, reader->samples);
+    if(reader->buffer) reader->ssErrors = readSamples(robj, reader->range, reader->points, *reader->buffer);
+    else reader->ssErrors = readSamples(robj, reader->range, reader->points, reader->samples);
     reader->fileDict = new RasterFileDictionary(robj->fileDictCopy());
 
     reader->owner->readersMut.lock();
@@ -444,6 +522,56 @@ uint32_t GeoRaster::readSamples(RasterObject* robj, const range_t& range,
     return ssErrors;
 }
 
+/*----------------------------------------------------------------------------
+ * readSamples - columnar results
+ *----------------------------------------------------------------------------*/
+uint32_t GeoRaster::readSamples(RasterObject* robj, const range_t& range,
+                                const vector<point_info_t>& points,
+                                RasterSampleBuffer& buffer)
+{
+    uint32_t ssErrors = SS_NO_ERRORS;
+    GeoRaster* grobj = dynamic_cast<GeoRaster*>(robj);
+    if(grobj == NULL)
+    {
+        mlog(CRITICAL, "Invalid raster object type in GeoRaster::readSamples");
+        return SS_RUNTIME_ERROR;
+    }
+
+    vector<int> bands;
+    try
+    {
+        /* Resolve requested bands once per reader range, not once per point. */
+        grobj->resolveBands(&grobj->raster, bands);
+    }
+    catch (const RunTimeException &e)
+    {
+        ssErrors |= SS_RUNTIME_ERROR;
+        mlog(e.level(), "Error getting samples: %s", e.what());
+        bands.clear();
+    }
+
+    RasterSample sample(0.0, 0);
+    uint32_t i = range.start;
+    for(; i < range.end; i++)
+    {
+        if(!grobj->sampling())
+        {
+            mlog(DEBUG, "Sampling stopped");
+            break;
+        }
+
+        ssErrors |= grobj->samplePointBands(points[i], buffer, bands, sample);
+    }
+
+    /* Keep output shape stable: one entry per requested point in this range. */
+    for(; i < range.end; i++)
+    {
+        buffer.endPoint();
+    }
+
+    return ssErrors;
+}
+
 /*----------------------------------------------------------------------------
  * luaDimensions - :dim() --> rows, cols
  *----------------------------------------------------------------------------*/
@@ -73,6 +73,7 @@ class GeoRaster: public RasterObject
         using RasterObject::getSamples;
 
         uint32_t      getSamples (const vector<point_info_t>& points, List<sample_list_t*>& sllist, void* param=NULL) final;
+        uint32_t      getSamples (const vector<point_info_t>& points, RasterSampleBuffer& buffer, void* param=NULL) final;
         uint32_t      getSubsets (const MathLib::extent_t&  extent, int64_t gps, List<RasterSubset*>& slist, void* param=NULL) final;
         uint8_t*      getPixels  (uint32_t ulx, uint32_t uly, uint32_t xsize=0, uint32_t ysize=0, int bandNum=1, void* param=NULL) override;
 
@@ -110,6 +111,7 @@ class GeoRaster: public RasterObject
             range_t                           range;
             const vector<point_info_t>&  points;
             vector<sample_list_t*>       samples;
+            RasterSampleBuffer*               buffer;     // columnar results, NULL when returning sample lists
             uint32_t                          ssErrors;
             RasterFileDictionary*             fileDict;
 
@@ -130,12 +132,17 @@ class GeoRaster: public RasterObject
         * Methods
         *--------------------------------------------------------------------*/
 
+        uint32_t samplePoints    (const vector<point_info_t>& points, List<sample_list_t*>* sllist, RasterSampleBuffer* buffer);
         uint32_t samplePointBands(const point_info_t& pinfo, sample_list_t& slist,
                                   const vector<int>& bands, bool oneBand);
+        uint32_t samplePointBands(const point_info_t& pinfo, RasterSampleBuffer& buffer,
+                                  const vector<int>& bands, RasterSample& sample);
 
         static void*    readerThread (void* parm);
         static uint32_t readSamples  (RasterObject* robj, const range_t& range,
                                       const vector<point_info_t>& points, vector<sample_list_t*>& samples);
+        static uint32_t readSamples  (RasterObject* robj, const range_t& range,
+                                      const vector<point_info_t>& points, RasterSampleBuffer& buffer);
 
         static int luaDimensions(lua_State* L);
         static int luaBoundingBox(lua_State* L);
@@ -240,6 +240,34 @@ uint32_t RasterObject::getSamples(const point_info_t& pinfo, sample_list_t& slis
     return ssErrors;
 }
 
+/*----------------------------------------------------------------------------
+ * getSamples - columnar results
+ *
+ *  default implementation converts the sample lists, rasters which can write
+ *  their samples directly into the buffer override this
+ *----------------------------------------------------------------------------*/
+uint32_t RasterObject::getSamples(const vector<point_info_t>& points, RasterSampleBuffer& buffer, void* param)
+{
+    List<sample_list_t*> sllist;
+    const uint32_t ssErrors = getSamples(points, sllist, param);
+
+    buffer.configure(hasZonalStats(), hasSpatialDerivs());
+    buffer.reserve(points.size());
+    for(int i = 0; i < sllist.length(); i++)
+    {
+        buffer.append(*sllist[i]);
+        buffer.endPoint();
+    }
+
+    /* Keep one entry per point even if sampling was stopped early */
+    while(buffer.numPoints() < points.size())
+    {
+        buffer.endPoint();
+    }
+
+    return ssErrors;
+}
+
 /*----------------------------------------------------------------------------
  * getPixels
  *----------------------------------------------------------------------------*/
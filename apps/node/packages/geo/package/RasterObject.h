@@ -42,6 +42,7 @@
 #include "RequestParameters.h"
 #include "GeoFields.h"
 #include "RasterSample.h"
+#include "RasterSampleBuffer.h"
 #include "RasterSubset.h"
 #include "RasterFileDictionary.h"
 #include "core.h"
@@ -96,6 +97,7 @@ class RasterObject: public LuaObject
         static int           luaFatories     (lua_State* L);
         uint32_t             getSamples      (const point_info_t& pinfo, sample_list_t& slist, void* param=NULL);
         virtual uint32_t     getSamples      (const vector<point_info_t>& points, List<sample_list_t*>& sllist, void* param=NULL) = 0;
+        virtual uint32_t     getSamples      (const vector<point_info_t>& points, RasterSampleBuffer& buffer, void* param=NULL);
         virtual uint32_t     getSubsets      (const MathLib::extent_t&  extent, int64_t gps, List<RasterSubset*>& slist, void* param=NULL);
         virtual uint8_t*     getPixels       (uint32_t ulx, uint32_t uly, uint32_t xsize=0, uint32_t ysize=0, int bandNum=1, void* param=NULL);
         void                 getBands        (vector<string>& bands);
@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <algorithm>
+
+#include "OsApi.h"
+#include "TimeLib.h"
+#include "SystemConfig.h"
+#include "RasterReadExecutor.h"
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+Cond                                RasterReadExecutor::execCond(NUM_SIGNALS);
+bool                                RasterReadExecutor::active = false;
+vector<Thread*>                     RasterReadExecutor::workers;
+vector<RasterReadExecutor::Client*> RasterReadExecutor::clients;
+size_t                              RasterReadExecutor::nextClient = 0;
+RasterReadExecutor::stats_t         RasterReadExecutor::stats = {};
+double                              RasterReadExecutor::windowStart = 0.0;
+long                                RasterReadExecutor::windowReads = 0;
+double                              RasterReadExecutor::windowLatency = 0.0;
+bool                                RasterReadExecutor::windowSaturated = false;
+double                              RasterReadExecutor::lastThroughput = 0.0;
+
+/******************************************************************************
+ * CLIENT METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Client Constructor
+ *----------------------------------------------------------------------------*/
+RasterReadExecutor::Client::Client(read_func_t _func, void* _context):
+    func(_func),
+    context(_context),
+    outstanding(0)
+{
+    execCond.lock();
+    {
+        startWorkers();
+        clients.push_back(this);
+        stats.clients = clients.size();
+    }
+    execCond.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * Client Destructor
+ *----------------------------------------------------------------------------*/
+RasterReadExecutor::Client::~Client(void)
+{
+    cancel();
+
+    execCond.lock();
+    {
+        /* Reads in flight reference the context, wait for them to complete */
+        while(outstanding > 0)
+        {
+            execCond.wait(DONE_SIGNAL, SYS_TIMEOUT);
+        }
+
+        clients.erase(std::find(clients.begin(), clients.end(), this));
+        stats.clients = clients.size();
+    }
+    execCond.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * submit
+ *----------------------------------------------------------------------------*/
+void RasterReadExecutor::Client::submit(void* item)
+{
+    execCond.lock();
+    {
+        queue.push_back(item);
+        outstanding++;
+        stats.queued++;
+        if(stats.inflight < stats.limit)
+        {
+            execCond.signal(WORK_SIGNAL, Cond::NOTIFY_ONE);
+        }
+    }
+    execCond.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * wait - returns true when all submitted reads have completed
+ *----------------------------------------------------------------------------*/
+bool RasterReadExecutor::Client::wait(int timeout_ms)
+{
+    bool complete;
+
+    execCond.lock();
+    {
+        if(outstanding > 0)
+        {
+            execCond.wait(DONE_SIGNAL, timeout_ms);
+        }
+        complete = (outstanding == 0);
+    }
+    execCond.unlock();
+
+    return complete;
+}
+
+/*----------------------------------------------------------------------------
+ * cancel - drops reads that have not started yet
+ *----------------------------------------------------------------------------*/
+void RasterReadExecutor::Client::cancel(void)
+{
+    execCond.lock();
+    {
+        const long dropped = queue.size();
+        queue.clear();
+        outstanding -= dropped;
+        stats.queued -= dropped;
+    }
+    execCond.unlock();
+}
+
+/******************************************************************************
+ * PUBLIC METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * init
+ *----------------------------------------------------------------------------*/
+void RasterReadExecutor::init (void)
+{
+    execCond.lock();
+    {
+        active = true;
+        stats.limit = INITIAL_CONCURRENCY;
+    }
+    execCond.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * deinit
+ *----------------------------------------------------------------------------*/
+void RasterReadExecutor::deinit (void)
+{
+    execCond.lock();
+    {
+        active = false;
+        execCond.signal(WORK_SIGNAL, Cond::NOTIFY_ALL);
+    }
+    execCond.unlock();
+
+    for(Thread* pid: workers)
+    {
+        delete pid;
+    }
+    workers.clear();
+}
+
+/*----------------------------------------------------------------------------
+ * getStats
+ *----------------------------------------------------------------------------*/
+RasterReadExecutor::stats_t RasterReadExecutor::getStats (void)
+{
+    execCond.lock();
+    const stats_t _stats = stats;
+    execCond.unlock();
+    return _stats;
+}
+
+/*----------------------------------------------------------------------------
+ * luaStats - rasterio() -> table of raster read executor statistics
+ *----------------------------------------------------------------------------*/
+int RasterReadExecutor::luaStats (lua_State* L)
+{
+    const stats_t _stats = getStats();
+
+    lua_newtable(L);
+    LuaEngine::setAttrInt(L, "queued", _stats.queued);
+    LuaEngine::setAttrInt(L, "inflight", _stats.inflight);
+    LuaEngine::setAttrInt(L, "limit", _stats.limit);
+    LuaEngine::setAttrInt(L, "workers", _stats.workers);
+    LuaEngine::setAttrInt(L, "clients", _stats.clients);
+    LuaEngine::setAttrInt(L, "completed", _stats.completed);
+    LuaEngine::setAttrInt(L, "increases", _stats.increases);
+    LuaEngine::setAttrInt(L, "backoffs", _stats.backoffs);
+    LuaEngine::setAttrNum(L, "latency", _stats.latency);
+    LuaEngine::setAttrNum(L, "baseline", _stats.baseline);
+    LuaEngine::setAttrNum(L, "throughput", _stats.throughput);
+    return 1;
+}
+
+/******************************************************************************
+ * PRIVATE METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * readerThread
+ *----------------------------------------------------------------------------*/
+void* RasterReadExecutor::readerThread (void* parm)
+{
+    (void)parm;
+
+    execCond.lock();
+    while(active)
+    {
+        /* Wait for a read within the concurrency limit */
+        void* item = NULL;
+        Client* client = (stats.inflight < stats.limit) ? dequeue(item) : NULL;
+        if(!client)
+        {
+            execCond.wait(WORK_SIGNAL, SYS_TIMEOUT);
+            continue;
+        }
+        stats.inflight++;
+        execCond.unlock();
+
+        /* Perform Read */
+        const double start = TimeLib::latchtime();
+        client->func(client->context, item);
+        const double latency = TimeLib::latchtime() - start;
+
+        execCond.lock();
+        stats.inflight--;
+        stats.completed++;
+        client->outstanding--;
+        adjust(latency);
+        execCond.signal(DONE_SIGNAL, Cond::NOTIFY_ALL);
+    }
+    execCond.unlock();
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * dequeue - takes the next read round robin across clients, lock held
+ *----------------------------------------------------------------------------*/
+RasterReadExecutor::Client* RasterReadExecutor::dequeue (void*& item)
+{
+    const size_t num_clients = clients.size();
+    for(size_t i = 0; i < num_clients; i++)
+    {
+        const size_t index = (nextClient + i) % num_clients;
+        Client* client = clients[index];
+        if(!client->queue.empty())
+        {
+            item = client->queue.front();
+            client->queue.pop_front();
+            stats.queued--;
+            nextClient = index + 1;
+            return client;
+        }
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * adjust - updates the concurrency limit from the current window, lock held
+ *----------------------------------------------------------------------------*/
+void RasterReadExecutor::adjust (double latency)
+{
+    const double now = TimeLib::latchtime();
+    if(windowReads == 0) windowStart = now - latency;
+    windowReads++;
+    windowLatency += latency;
+    if(stats.queued > 0) windowSaturated = true;
+
+    const double elapsed = now - windowStart;
+    if(windowReads < MIN_WINDOW_READS || elapsed * 1000.0 < ADJUST_PERIOD_MS)
+    {
+        return;
+    }
+
+    stats.latency = windowLatency / windowReads;
+    stats.throughput = windowReads / elapsed;
+
+    /* Baseline follows faster reads immediately and slower reads gradually */
+    if(stats.baseline == 0.0 || stats.latency < stats.baseline) stats.baseline = stats.latency;
+    else stats.baseline += (stats.latency - stats.baseline) * BASELINE_DRIFT;
+
+    const long budget = workers.size();
+    const long prev_limit = stats.limit;
+    if(stats.latency > stats.baseline * LATENCY_TOLERANCE)
+    {
+        /* Reads are slowing down - back off */
+        stats.limit = std::max(static_cast<long>(MIN_CONCURRENCY), static_cast<long>(stats.limit * BACKOFF_FACTOR));
+        if(stats.limit < prev_limit) stats.backoffs++;
+    }
+    else if(windowSaturated && stats.throughput > lastThroughput * THROUGHPUT_GAIN)
+    {
+        /* More concurrency is still paying off - probe higher */
+        stats.limit = std::min(budget, stats.limit + 1);
+        if(stats.limit > prev_limit)
+        {
+            stats.increases++;
+            execCond.signal(WORK_SIGNAL, Cond::NOTIFY_ONE);
+        }
+    }
+
+    if(stats.limit != prev_limit)
+    {
+        mlog(DEBUG, "Raster read concurrency %ld -> %ld (latency %.3lf, baseline %.3lf, %.1lf reads/sec)", prev_limit, stats.limit, stats.latency, stats.baseline, stats.throughput);
+    }
+
+    /* Throughput is only compared across windows that had more work than readers */
+    lastThroughput = windowSaturated ? stats.throughput : 0.0;
+
+    windowReads = 0;
+    windowLatency = 0.0;
+    windowSaturated = false;
+}
+
+/*----------------------------------------------------------------------------
+ * startWorkers - starts the reader threads on first use, lock held
+ *----------------------------------------------------------------------------*/
+void RasterReadExecutor::startWorkers (void)
+{
+    if(!workers.empty() || !active) return;
+
+    const int budget = MAX(SystemConfig::settings().rasterReadLimit.value, MIN_CONCURRENCY);
+    for(int i = 0; i < budget; i++)
+    {
+        workers.push_back(new Thread(readerThread, NULL));
+    }
+    stats.workers = workers.size();
+    stats.limit = std::min(stats.limit, static_cast<long>(budget));
+
+    mlog(INFO, "Started %d raster reader threads, initial concurrency %ld", budget, stats.limit);
+}
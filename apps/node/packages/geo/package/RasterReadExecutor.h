@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __raster_read_executor__
+#define __raster_read_executor__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <deque>
+
+#include "OsApi.h"
+#include "LuaEngine.h"
+
+/******************************************************************************
+ * RASTER READ EXECUTOR CLASS
+ ******************************************************************************/
+
+/*
+ * Node wide pool of raster reader threads shared by all requests
+ *
+ *  - the number of reader threads is fixed by the raster_read_limit setting,
+ *    which bounds the number of raster reads in flight on the server
+ *  - each request submits its reads through its own client; reader threads
+ *    serve the client queues round robin so a large request cannot starve
+ *    smaller ones
+ *  - the number of reads allowed in flight adapts between MIN_CONCURRENCY and
+ *    the limit: it is increased while throughput keeps rising and backed off
+ *    when the average read latency grows past its baseline
+ */
+class RasterReadExecutor
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int INITIAL_CONCURRENCY = 20;  // best for a single request on an 8 core system
+        static const int MIN_CONCURRENCY = 2;
+        static const int MIN_WINDOW_READS = 8;      // reads needed before the concurrency is adjusted
+        static const int ADJUST_PERIOD_MS = 500;
+        static constexpr double LATENCY_TOLERANCE = 1.5;   // latency growth over baseline that triggers a back off
+        static constexpr double THROUGHPUT_GAIN = 1.05;    // throughput growth needed to keep increasing concurrency
+        static constexpr double BACKOFF_FACTOR = 0.75;
+        static constexpr double BASELINE_DRIFT = 0.05;     // rate the latency baseline follows slower reads
+
+        /*--------------------------------------------------------------------
+         * Typedefs
+         *--------------------------------------------------------------------*/
+
+        typedef void (*read_func_t) (void* context, void* item);
+
+        typedef struct {
+            long        queued;         // reads waiting for a reader thread
+            long        inflight;       // reads being performed
+            long        limit;          // current number of reads allowed in flight
+            long        workers;        // reader threads
+            long        clients;        // requests with reads submitted
+            long        completed;      // total reads performed
+            long        increases;      // times the concurrency was raised
+            long        backoffs;       // times the concurrency was lowered
+            double      latency;        // average read latency of last window (seconds)
+            double      baseline;       // latency baseline (seconds)
+            double      throughput;     // reads per second of last window
+        } stats_t;
+
+        /*--------------------------------------------------------------------
+         * Client Subclass
+         *--------------------------------------------------------------------*/
+
+        class Client
+        {
+            public:
+
+                        Client      (read_func_t _func, void* _context);
+                        ~Client     (void);
+
+                void    submit      (void* item);
+                bool    wait        (int timeout_ms);
+                void    cancel      (void);
+
+            private:
+
+                friend class RasterReadExecutor;
+
+                read_func_t         func;
+                void*               context;
+                std::deque<void*>   queue;
+                long                outstanding;    // queued and in flight
+        };
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static void     init        (void);
+        static void     deinit      (void);
+        static stats_t  getStats    (void);
+        static int      luaStats    (lua_State* L);
+
+    private:
+
+        friend class UT_RasterReadExecutor; // necessary for driving adjust() with synthetic latencies
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int WORK_SIGNAL = 0;
+        static const int DONE_SIGNAL = 1;
+        static const int NUM_SIGNALS = 2;
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        static Cond             execCond;       // protects all executor and client state
+        static bool             active;
+        static vector<Thread*>  workers;
+        static vector<Client*>  clients;
+        static size_t           nextClient;     // round robin position
+        static stats_t          stats;          // live counters are kept in the stats
+        static double           windowStart;
+        static long             windowReads;
+        static double           windowLatency;
+        static bool             windowSaturated;
+        static double           lastThroughput;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static void*    readerThread    (void* parm);
+        static Client*  dequeue         (void*& item);
+        static void     adjust          (double latency);
+        static void     startWorkers    (void);
+};
+
+#endif  /* __raster_read_executor__ */
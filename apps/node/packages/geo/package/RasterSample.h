@@ -98,6 +98,19 @@ public:
         derivs = sample.derivs;
     }
 
+    /* Reset for reuse; keeps the capacity of bandName */
+    void clear(void)
+    {
+        value = 0;
+        time = 0;
+        verticalShift = 0;
+        fileId = 0;
+        flags = 0;
+        bandName.clear();
+        stats = {0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        derivs = {0, 0.0, 0.0};
+    }
+
     string toString(void) const
     {
         char buffer[1024];
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "RasterSampleBuffer.h"
+#include "EventLib.h"
+
+/******************************************************************************
+ * PUBLIC METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+RasterSampleBuffer::RasterSampleBuffer(bool _zonalStats, bool _spatialDerivs):
+    offsets {0},
+    zonalStats(_zonalStats),
+    spatialDerivs(_spatialDerivs)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * configure
+ *----------------------------------------------------------------------------*/
+void RasterSampleBuffer::configure(bool _zonalStats, bool _spatialDerivs)
+{
+    clear();
+    zonalStats = _zonalStats;
+    spatialDerivs = _spatialDerivs;
+}
+
+/*----------------------------------------------------------------------------
+ * reserve
+ *----------------------------------------------------------------------------*/
+void RasterSampleBuffer::reserve(uint32_t num_points, uint32_t samples_per_point)
+{
+    const size_t num_samples = static_cast<size_t>(num_points) * samples_per_point;
+
+    offsets.reserve(num_points + 1);
+    value.reserve(num_samples);
+    time.reserve(num_samples);
+    verticalShift.reserve(num_samples);
+    fileId.reserve(num_samples);
+    flags.reserve(num_samples);
+    band.reserve(num_samples);
+
+    if(zonalStats)
+    {
+        statsCount.reserve(num_samples);
+        statsMin.reserve(num_samples);
+        statsMax.reserve(num_samples);
+        statsMean.reserve(num_samples);
+        statsMedian.reserve(num_samples);
+        statsStdev.reserve(num_samples);
+        statsMad.reserve(num_samples);
+    }
+
+    if(spatialDerivs)
+    {
+        derivsCount.reserve(num_samples);
+        derivsSlope.reserve(num_samples);
+        derivsAspect.reserve(num_samples);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * clear
+ *----------------------------------------------------------------------------*/
+void RasterSampleBuffer::clear(void)
+{
+    offsets.assign(1, 0);
+    value.clear();
+    time.clear();
+    verticalShift.clear();
+    fileId.clear();
+    flags.clear();
+    band.clear();
+    bandNames.clear();
+    statsCount.clear();
+    statsMin.clear();
+    statsMax.clear();
+    statsMean.clear();
+    statsMedian.clear();
+    statsStdev.clear();
+    statsMad.clear();
+    derivsCount.clear();
+    derivsSlope.clear();
+    derivsAspect.clear();
+}
+
+/*----------------------------------------------------------------------------
+ * append - add sample to the current point
+ *----------------------------------------------------------------------------*/
+void RasterSampleBuffer::append(const RasterSample& sample)
+{
+    append(sample, sample.time, sample.flags);
+}
+
+/*----------------------------------------------------------------------------
+ * append - add sample to the current point, overriding its time and flags
+ *----------------------------------------------------------------------------*/
+void RasterSampleBuffer::append(const RasterSample& sample, double gps, uint32_t _flags)
+{
+    value.push_back(sample.value);
+    time.push_back(gps);
+    verticalShift.push_back(sample.verticalShift);
+    fileId.push_back(sample.fileId);
+    flags.push_back(_flags);
+    band.push_back(internBand(sample.bandName));
+
+    if(zonalStats)
+    {
+        statsCount.push_back(sample.stats.count);
+        statsMin.push_back(sample.stats.min);
+        statsMax.push_back(sample.stats.max);
+        statsMean.push_back(sample.stats.mean);
+        statsMedian.push_back(sample.stats.median);
+        statsStdev.push_back(sample.stats.stdev);
+        statsMad.push_back(sample.stats.mad);
+    }
+
+    if(spatialDerivs)
+    {
+        derivsCount.push_back(sample.derivs.count);
+        derivsSlope.push_back(sample.derivs.slopeDeg);
+        derivsAspect.push_back(sample.derivs.aspectDeg);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * append - add all samples in list to the current point
+ *----------------------------------------------------------------------------*/
+void RasterSampleBuffer::append(const List<RasterSample*>& slist)
+{
+    for(int i = 0; i < slist.length(); i++)
+    {
+        append(*slist[i]);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * endPoint - samples appended after this belong to the next point
+ *----------------------------------------------------------------------------*/
+void RasterSampleBuffer::endPoint(void)
+{
+    offsets.push_back(value.size());
+}
+
+/*----------------------------------------------------------------------------
+ * merge - append all points in other buffer
+ *----------------------------------------------------------------------------*/
+void RasterSampleBuffer::merge(const RasterSampleBuffer& other)
+{
+    /* Offsets */
+    const uint32_t base = value.size();
+    for(uint32_t i = 1; i < other.offsets.size(); i++)
+    {
+        offsets.push_back(base + other.offsets[i]);
+    }
+
+    /* Bands (translated to this buffer's interned names) */
+    vector<uint16_t> band_map;
+    for(const string& name: other.bandNames)
+    {
+        band_map.push_back(internBand(name));
+    }
+    for(const uint16_t b: other.band)
+    {
+        band.push_back((b == NO_BAND) ? NO_BAND : band_map[b]);
+    }
+
+    /* Sample Columns */
+    value.insert(value.end(), other.value.begin(), other.value.end());
+    time.insert(time.end(), other.time.begin(), other.time.end());
+    verticalShift.insert(verticalShift.end(), other.verticalShift.begin(), other.verticalShift.end());
+    fileId.insert(fileId.end(), other.fileId.begin(), other.fileId.end());
+    flags.insert(flags.end(), other.flags.begin(), other.flags.end());
+
+    if(zonalStats)
+    {
+        statsCount.insert(statsCount.end(), other.statsCount.begin(), other.statsCount.end());
+        statsMin.insert(statsMin.end(), other.statsMin.begin(), other.statsMin.end());
+        statsMax.insert(statsMax.end(), other.statsMax.begin(), other.statsMax.end());
+        statsMean.insert(statsMean.end(), other.statsMean.begin(), other.statsMean.end());
+        statsMedian.insert(statsMedian.end(), other.statsMedian.begin(), other.statsMedian.end());
+        statsStdev.insert(statsStdev.end(), other.statsStdev.begin(), other.statsStdev.end());
+        statsMad.insert(statsMad.end(), other.statsMad.begin(), other.statsMad.end());
+    }
+
+    if(spatialDerivs)
+    {
+        derivsCount.insert(derivsCount.end(), other.derivsCount.begin(), other.derivsCount.end());
+        derivsSlope.insert(derivsSlope.end(), other.derivsSlope.begin(), other.derivsSlope.end());
+        derivsAspect.insert(derivsAspect.end(), other.derivsAspect.begin(), other.derivsAspect.end());
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * internBand - rasters have few bands so a linear search is sufficient
+ *----------------------------------------------------------------------------*/
+uint16_t RasterSampleBuffer::internBand(const string& name)
+{
+    if(name.empty()) return NO_BAND;
+
+    for(uint16_t i = 0; i < bandNames.size(); i++)
+    {
+        if(bandNames[i] == name) return i;
+    }
+
+    if(bandNames.size() >= NO_BAND)
+    {
+        mlog(ERROR, "Too many band names, unable to intern: %s", name.c_str());
+        return NO_BAND;
+    }
+
+    bandNames.push_back(name);
+    return bandNames.size() - 1;
+}
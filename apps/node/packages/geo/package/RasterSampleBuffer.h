@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __raster_sample_buffer__
+#define __raster_sample_buffer__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "List.h"
+#include "RasterSample.h"
+
+/******************************************************************************
+ * RASTER SAMPLE BUFFER CLASS
+ ******************************************************************************/
+
+/*
+ * Columnar (struct of arrays) results of sampling a list of points
+ *
+ *  - the samples of point i are at [offsets[i], offsets[i+1]) in each column
+ *  - band names are interned, the band column holds an index into bandNames
+ *  - zonal stats and slope/aspect columns are only populated when enabled
+ */
+class RasterSampleBuffer
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const uint16_t NO_BAND = 0xFFFF;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        explicit    RasterSampleBuffer  (bool _zonalStats=false, bool _spatialDerivs=false);
+                    ~RasterSampleBuffer (void) = default;
+
+        void        configure           (bool _zonalStats, bool _spatialDerivs);
+        void        reserve             (uint32_t num_points, uint32_t samples_per_point=1);
+        void        clear               (void);
+        void        append              (const RasterSample& sample);
+        void        append              (const RasterSample& sample, double gps, uint32_t _flags);
+        void        append              (const List<RasterSample*>& slist);
+        void        endPoint            (void);
+        void        merge               (const RasterSampleBuffer& other);
+        uint16_t    internBand          (const string& name);
+
+        uint32_t    numPoints           (void) const { return offsets.size() - 1; }
+        uint32_t    numSamples          (void) const { return value.size(); }
+        uint32_t    pointStart          (uint32_t point) const { return offsets[point]; }
+        uint32_t    pointEnd            (uint32_t point) const { return offsets[point + 1]; }
+        bool        hasZonalStats       (void) const { return zonalStats; }
+        bool        hasSpatialDerivs    (void) const { return spatialDerivs; }
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        vector<uint32_t>    offsets;
+        vector<double>      value;
+        vector<double>      time;           // gps seconds
+        vector<double>      verticalShift;
+        vector<uint64_t>    fileId;
+        vector<uint32_t>    flags;
+        vector<uint16_t>    band;           // index into bandNames, NO_BAND if not named
+        vector<string>      bandNames;
+
+        /* Zonal Stats */
+        vector<uint32_t>    statsCount;
+        vector<double>      statsMin;
+        vector<double>      statsMax;
+        vector<double>      statsMean;
+        vector<double>      statsMedian;
+        vector<double>      statsStdev;
+        vector<double>      statsMad;
+
+        /* Slope and Aspect */
+        vector<uint32_t>    derivsCount;
+        vector<double>      derivsSlope;
+        vector<double>      derivsAspect;
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        bool                zonalStats;
+        bool                spatialDerivs;
+};
+
+#endif  /* __raster_sample_buffer__ */
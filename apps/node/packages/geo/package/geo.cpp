@@ -38,6 +38,7 @@
 #include "DataFrameSampler.h"
 #include "GeoRaster.h"
 #include "GeoIndexedRaster.h"
+#include "GeoIndexCatalog.h"
 #include "GeoJsonRaster.h"
 #include "GeoUserRaster.h"
 #include "GeoUserUrlRaster.h"
@@ -45,9 +46,15 @@
 #include "GeoFields.h"
 #include "GeoLib.h"
 #include "RasterSampler.h"
+#include "RasterReadExecutor.h"
 #ifdef __unittesting__
 #include "UT_RasterSubset.h"
 #include "UT_RasterSample.h"
+#include "UT_GeoIndexCatalog.h"
+#include "UT_DataFrameSampler.h"
+#include "UT_RasterSampleBuffer.h"
+#include "UT_TIFFImage.h"
+#include "UT_RasterReadExecutor.h"
 #endif
 
 #include <gdal.h>
@@ -272,9 +279,15 @@ int geo_open (lua_State* L)
         {"calcutm",         GeoLib::luaCalcUTM},
         {"tiff",            GeoLib::TIFFImage::luaCreate},
         {"simplify",        GeoLib::luaPolySimplify},
+        {"rasterio",        RasterReadExecutor::luaStats},
 #ifdef __unittesting__
         {"ut_subset",       UT_RasterSubset::luaCreate},
         {"ut_sample",       UT_RasterSample::luaCreate},
+        {"ut_catalog",      UT_GeoIndexCatalog::luaCreate},
+        {"ut_framesampler", UT_DataFrameSampler::luaCreate},
+        {"ut_samplebuffer", UT_RasterSampleBuffer::luaCreate},
+        {"ut_tiffimage",    UT_TIFFImage::luaCreate},
+        {"ut_rasterio",     UT_RasterReadExecutor::luaCreate},
 #endif
         {NULL,              NULL}
     };
@@ -333,6 +346,8 @@ void initgeo (void)
     /* Initialize Modules */
     RasterSampler::init();
     GeoLib::init();
+    GeoIndexCatalog::init();
+    RasterReadExecutor::init();
 
     /* Register GDAL custom error handler */
 #ifdef GDAL_ERROR_REPORTING
@@ -358,6 +373,8 @@ void initgeo (void)
 void deinitgeo (void)
 {
     RasterSampler::deinit();
+    RasterReadExecutor::deinit();
+    GeoIndexCatalog::deinit();
     GDALDestroy();
 }
 }
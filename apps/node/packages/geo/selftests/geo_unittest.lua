@@ -0,0 +1,50 @@
+local runner = require("test_executive")
+
+-- Requirements --
+
+if not core.UNITTEST then
+    return runner.skip()
+end
+
+-- Setup --
+
+local ut_catalog = geo.ut_catalog()
+local ut_framesampler = geo.ut_framesampler()
+local ut_samplebuffer = geo.ut_samplebuffer()
+local ut_tiffimage = geo.ut_tiffimage()
+local ut_rasterio = geo.ut_rasterio()
+
+-- Self Test --
+
+runner.unittest("GeoIndexCatalog STR Tree", function()
+    runner.assert(ut_catalog:tree(), "Failed STR tree test")
+end)
+
+runner.unittest("GeoIndexCatalog Cache", function()
+    runner.assert(ut_catalog:cache(), "Failed catalog cache test")
+end)
+
+runner.unittest("DataFrameSampler Collection Limit", function()
+    runner.assert(ut_framesampler:limit(), "Failed collection limit test")
+    runner.assert(ut_framesampler:release(), "Failed collection slot release test")
+end)
+
+runner.unittest("RasterSampleBuffer", function()
+    runner.assert(ut_samplebuffer:append(), "Failed sample buffer append test")
+    runner.assert(ut_samplebuffer:merge(), "Failed sample buffer merge test")
+    runner.assert(ut_samplebuffer:intern(), "Failed sample buffer band intern test")
+end)
+
+runner.unittest("TIFFImage", function()
+    runner.assert(ut_tiffimage:tiles(), "Failed tiff image tile layout test")
+    runner.assert(ut_tiffimage:cache(), "Failed tiff image mask cache test")
+end)
+
+runner.unittest("RasterReadExecutor", function()
+    runner.assert(ut_rasterio:adapt(), "Failed raster read concurrency adaptation test")
+    runner.assert(ut_rasterio:read(), "Failed raster read client test")
+end)
+
+-- Report Results --
+
+runner.report()
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <atomic>
+
+#include "OsApi.h"
+#include "SystemConfig.h"
+#include "FrameRunnerPool.h"
+#include "UT_DataFrameSampler.h"
+#include "DataFrameSampler.h"
+
+/******************************************************************************
+ * FILE DATA
+ ******************************************************************************/
+
+#define UT_LIMIT            2
+#define UT_COLLECTIONS      8
+#define UT_SUBMITTERS       3
+#define UT_FAILED_ITEM      3
+
+typedef struct {
+    std::atomic<int>    running;
+    std::atomic<int>    peak;
+    std::atomic<int>    sampled;
+} ut_collections_t;
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * trackRunning - counts collections between acquiring and releasing a slot
+ *----------------------------------------------------------------------------*/
+static void trackRunning (ut_collections_t* collections)
+{
+    const int running = ++collections->running;
+    int peak = collections->peak.load();
+    while(running > peak && !collections->peak.compare_exchange_weak(peak, running)) {}
+    OsApi::sleep(0.02);
+    collections->sampled++;
+    collections->running--;
+}
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_DataFrameSampler::OBJECT_TYPE = "UT_DataFrameSampler";
+const char* UT_DataFrameSampler::LUA_META_NAME = "UT_DataFrameSampler";
+const struct luaL_Reg UT_DataFrameSampler::LUA_META_TABLE[] = {
+    {"limit",           luaLimitTest},
+    {"release",         luaReleaseTest},
+    {NULL,              NULL}
+};
+
+/******************************************************************************
+ * CLASS METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * luaCreate - :UT_DataFrameSampler()
+ *----------------------------------------------------------------------------*/
+int UT_DataFrameSampler::luaCreate (lua_State* L)
+{
+    try
+    {
+        return createLuaObject(L, new UT_DataFrameSampler(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_DataFrameSampler::UT_DataFrameSampler (lua_State* L):
+    LuaObject(L, OBJECT_TYPE, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor  -
+ *----------------------------------------------------------------------------*/
+UT_DataFrameSampler::~UT_DataFrameSampler(void) = default;
+
+/*----------------------------------------------------------------------------
+ * luaLimitTest - :limit()
+ *
+ *  several requests sample collections through the pool at once; no more
+ *  than the node wide limit may be sampled at any time
+ *----------------------------------------------------------------------------*/
+int UT_DataFrameSampler::luaLimitTest (lua_State* L)
+{
+    bool status = true;
+
+    const int saved_limit = SystemConfig::settings().rasterCollectionLimit.value;
+    SystemConfig::settings().rasterCollectionLimit.value = UT_LIMIT;
+    DataFrameSampler::collectionPool.setLimit(UT_LIMIT);
+
+    ut_collections_t collections = {{0}, {0}, {0}};
+
+    /* concurrent requests */
+    vector<Thread*> pids;
+    for(int i = 0; i < UT_SUBMITTERS; i++)
+    {
+        pids.push_back(new Thread(requestThread, &collections));
+    }
+    for(Thread* pid: pids)
+    {
+        delete pid;
+    }
+
+    if(collections.sampled.load() != UT_COLLECTIONS * UT_SUBMITTERS)
+    {
+        mlog(CRITICAL, "Sampled %d collections, expected %d", collections.sampled.load(), UT_COLLECTIONS * UT_SUBMITTERS);
+        status = false;
+    }
+
+    if(collections.peak.load() > UT_LIMIT)
+    {
+        mlog(CRITICAL, "Sampled %d collections at once, limit is %d", collections.peak.load(), UT_LIMIT);
+        status = false;
+    }
+
+    if(DataFrameSampler::activeCollections != 0)
+    {
+        mlog(CRITICAL, "Leaked %d collection slots", DataFrameSampler::activeCollections);
+        status = false;
+    }
+
+    SystemConfig::settings().rasterCollectionLimit.value = saved_limit;
+    DataFrameSampler::collectionPool.setLimit(saved_limit);
+
+    lua_pushboolean(L, status);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaReleaseTest - :release()
+ *
+ *  a collection that throws while sampling releases its slot and fails the
+ *  request without blocking later requests
+ *----------------------------------------------------------------------------*/
+int UT_DataFrameSampler::luaReleaseTest (lua_State* L)
+{
+    bool status = true;
+
+    const int saved_limit = SystemConfig::settings().rasterCollectionLimit.value;
+    SystemConfig::settings().rasterCollectionLimit.value = 1;
+    DataFrameSampler::collectionPool.setLimit(1);
+
+    ut_collections_t collections = {{0}, {0}, {0}};
+    if(DataFrameSampler::collectionPool.run(failItems, &collections, UT_COLLECTIONS, 1))
+    {
+        mlog(CRITICAL, "Failure of collection not reported");
+        status = false;
+    }
+
+    if(DataFrameSampler::activeCollections != 0)
+    {
+        mlog(CRITICAL, "Leaked %d collection slots", DataFrameSampler::activeCollections);
+        status = false;
+    }
+
+    /* slot is available to the next request */
+    collections.sampled = 0;
+    if(!DataFrameSampler::collectionPool.run(sampleItems, &collections, UT_COLLECTIONS, 1) || collections.sampled.load() != UT_COLLECTIONS)
+    {
+        mlog(CRITICAL, "Failed to sample after released slot: %d", collections.sampled.load());
+        status = false;
+    }
+
+    SystemConfig::settings().rasterCollectionLimit.value = saved_limit;
+    DataFrameSampler::collectionPool.setLimit(saved_limit);
+
+    lua_pushboolean(L, status);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * sampleItems - stands in for DataFrameSampler::sampleCollections
+ *----------------------------------------------------------------------------*/
+void UT_DataFrameSampler::sampleItems (void* context, long start, long count)
+{
+    for(long i = start; i < start + count; i++)
+    {
+        const DataFrameSampler::collection_slot_t slot;
+        trackRunning(static_cast<ut_collections_t*>(context));
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * failItems - throws while holding the slot of one collection
+ *----------------------------------------------------------------------------*/
+void UT_DataFrameSampler::failItems (void* context, long start, long count)
+{
+    for(long i = start; i < start + count; i++)
+    {
+        const DataFrameSampler::collection_slot_t slot;
+        if(i == UT_FAILED_ITEM) throw RunTimeException(ERROR, RTE_FAILURE, "failed to sample collection %ld", i);
+        trackRunning(static_cast<ut_collections_t*>(context));
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * requestThread - one request sampling its collections
+ *----------------------------------------------------------------------------*/
+void* UT_DataFrameSampler::requestThread (void* parm)
+{
+    if(!DataFrameSampler::collectionPool.run(sampleItems, parm, UT_COLLECTIONS, 1))
+    {
+        mlog(CRITICAL, "Failed to run collections");
+    }
+    return NULL;
+}
@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <random>
+#include <algorithm>
+#include <cpl_conv.h>
+#include <cpl_vsi.h>
+
+#include "OsApi.h"
+#include "UT_GeoIndexCatalog.h"
+#include "GeoIndexCatalog.h"
+
+/******************************************************************************
+ * FILE DATA
+ ******************************************************************************/
+
+#define UT_SEED         1234
+#define UT_NUM_POINTS   500
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * noDate - index features have no datetime
+ *----------------------------------------------------------------------------*/
+static bool noDate (const OGRFeature* feature, TimeLib::gmt_time_t& gmt_date)
+{
+    (void)feature;
+    (void)gmt_date;
+    return false;
+}
+
+/*----------------------------------------------------------------------------
+ * writeIndex - geojson feature collection of unit squares along the equator
+ *----------------------------------------------------------------------------*/
+static void writeIndex (const char* file, int num_features)
+{
+    string geojson = "{\"type\": \"FeatureCollection\", \"features\": [";
+    for(int i = 0; i < num_features; i++)
+    {
+        geojson += FString("%s{\"type\": \"Feature\", \"properties\": {\"id\": %d}, \"geometry\": {\"type\": \"Polygon\", "
+                           "\"coordinates\": [[[%d, 0], [%d, 0], [%d, 1], [%d, 1], [%d, 0]]]}}",
+                           i > 0 ? ", " : "", i, i, i + 1, i + 1, i, i).c_str();
+    }
+    geojson += "]}";
+
+    GByte* buffer = static_cast<GByte*>(CPLMalloc(geojson.size()));
+    memcpy(buffer, geojson.data(), geojson.size());
+    VSIUnlink(file);
+    VSILFILE* fp = VSIFileFromMemBuffer(file, buffer, geojson.size(), TRUE); // takes ownership of buffer
+    VSIFCloseL(fp);
+}
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_GeoIndexCatalog::OBJECT_TYPE = "UT_GeoIndexCatalog";
+const char* UT_GeoIndexCatalog::LUA_META_NAME = "UT_GeoIndexCatalog";
+const struct luaL_Reg UT_GeoIndexCatalog::LUA_META_TABLE[] = {
+    {"tree",            luaTreeTest},
+    {"cache",           luaCacheTest},
+    {NULL,              NULL}
+};
+
+/******************************************************************************
+ * CLASS METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * luaCreate - :UT_GeoIndexCatalog()
+ *----------------------------------------------------------------------------*/
+int UT_GeoIndexCatalog::luaCreate (lua_State* L)
+{
+    try
+    {
+        return createLuaObject(L, new UT_GeoIndexCatalog(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_GeoIndexCatalog::UT_GeoIndexCatalog (lua_State* L):
+    LuaObject(L, OBJECT_TYPE, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor  -
+ *----------------------------------------------------------------------------*/
+UT_GeoIndexCatalog::~UT_GeoIndexCatalog(void) = default;
+
+/*----------------------------------------------------------------------------
+ * luaTreeTest - :tree()
+ *
+ *  bulk loads random boxes and checks every query against a brute force scan
+ *----------------------------------------------------------------------------*/
+int UT_GeoIndexCatalog::luaTreeTest (lua_State* L)
+{
+    bool status = true;
+
+    std::mt19937 gen(UT_SEED);
+    std::uniform_real_distribution<double> corner(-180.0, 180.0);
+    std::uniform_real_distribution<double> extent(0.0, 20.0);
+
+    /* empty, single node, exactly full node, one past full node, several levels */
+    for(const size_t num_items: {0UL, 1UL, 16UL, 17UL, 257UL, 20000UL})
+    {
+        vector<GdalRaster::bbox_t> item_boxes;
+        for(size_t i = 0; i < num_items; i++)
+        {
+            const double x = corner(gen);
+            const double y = corner(gen) / 2.0;
+            item_boxes.push_back({x, y, x + extent(gen), y + extent(gen)});
+        }
+
+        GeoIndexCatalog catalog;
+        if(!catalog.build(item_boxes))
+        {
+            mlog(CRITICAL, "Failed to build tree of %ld items", num_items);
+            status = false;
+            continue;
+        }
+
+        /* every leaf references a unique item */
+        vector<uint32_t> leaves(catalog.leafItems);
+        std::sort(leaves.begin(), leaves.end());
+        for(size_t i = 0; i < leaves.size(); i++)
+        {
+            if(leaves[i] != i)
+            {
+                mlog(CRITICAL, "Tree of %ld items: missing leaf %ld", num_items, i);
+                status = false;
+                break;
+            }
+        }
+
+        /* queries match brute force, including points on box edges */
+        for(int p = 0; p < UT_NUM_POINTS; p++)
+        {
+            double x = corner(gen);
+            double y = corner(gen) / 2.0;
+            if((p % 10 == 0) && !item_boxes.empty())
+            {
+                const GdalRaster::bbox_t& edge = item_boxes[p % item_boxes.size()];
+                x = edge.lon_max;
+                y = edge.lat_min;
+            }
+
+            vector<uint32_t> expected;
+            for(uint32_t i = 0; i < item_boxes.size(); i++)
+            {
+                const GdalRaster::bbox_t& b = item_boxes[i];
+                if(x >= b.lon_min && x <= b.lon_max && y >= b.lat_min && y <= b.lat_max) expected.push_back(i);
+            }
+
+            vector<uint32_t> result;
+            catalog.query(x, y, result, true);
+            if(result != expected)
+            {
+                mlog(CRITICAL, "Tree of %ld items: query (%lf, %lf) returned %ld items, expected %ld", num_items, x, y, result.size(), expected.size());
+                status = false;
+                break;
+            }
+        }
+    }
+
+    /* overlapping boxes all containing the same point */
+    {
+        vector<GdalRaster::bbox_t> item_boxes;
+        for(int i = 0; i < 5000; i++) item_boxes.push_back({-1.0 - i, -1.0, 1.0 + i, 1.0});
+
+        GeoIndexCatalog catalog;
+        vector<uint32_t> result;
+        catalog.build(item_boxes);
+        catalog.query(0.0, 0.0, result, true);
+        if(result.size() != item_boxes.size())
+        {
+            mlog(CRITICAL, "Overlapping boxes: query returned %ld items, expected %ld", result.size(), item_boxes.size());
+            status = false;
+        }
+    }
+
+    lua_pushboolean(L, status);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaCacheTest - :cache()
+ *----------------------------------------------------------------------------*/
+int UT_GeoIndexCatalog::luaCacheTest (lua_State* L)
+{
+    bool status = true;
+
+    const char* key = "ut_catalog";
+    const char* file_a1 = "/vsimem/ut_catalog_a1.geojson";
+    const char* file_a2 = "/vsimem/ut_catalog_a2.geojson";
+    const char* file_b = "/vsimem/ut_catalog_b.geojson";
+    writeIndex(file_a1, 2);
+    writeIndex(file_a2, 2);
+    writeIndex(file_b, 3);
+
+    /* identical content shares one catalog */
+    shared_ptr<const GeoIndexCatalog> a1 = GeoIndexCatalog::get(file_a1, key, noDate);
+    shared_ptr<const GeoIndexCatalog> a2 = GeoIndexCatalog::get(file_a2, key, noDate);
+    if(a1 == NULL || a1 != a2 || a1->size() != 2)
+    {
+        mlog(CRITICAL, "Identical in-memory index files not shared");
+        status = false;
+    }
+
+    /* different content gets its own catalog */
+    shared_ptr<const GeoIndexCatalog> b = GeoIndexCatalog::get(file_b, key, noDate);
+    if(b == NULL || b == a1 || b->size() != 3)
+    {
+        mlog(CRITICAL, "Different in-memory index files shared");
+        status = false;
+    }
+
+    /* hash collision: point the key of b at the entry of a */
+    string key_a;
+    string key_b;
+    std::string_view content;
+    bool in_memory = false;
+    GeoIndexCatalog::getCacheKey(file_a1, key, key_a, content, in_memory);
+    GeoIndexCatalog::getCacheKey(file_b, key, key_b, content, in_memory);
+    GeoIndexCatalog::cacheMut.lock();
+    {
+        GeoIndexCatalog::cache[key_b] = GeoIndexCatalog::cache[key_a];
+    }
+    GeoIndexCatalog::cacheMut.unlock();
+
+    shared_ptr<const GeoIndexCatalog> collided = GeoIndexCatalog::get(file_b, key, noDate);
+    if(collided == NULL || collided == a1 || collided->size() != 3)
+    {
+        mlog(CRITICAL, "Colliding in-memory index file returned catalog of another file");
+        status = false;
+    }
+
+    /* original entry unaffected */
+    if(GeoIndexCatalog::get(file_a1, key, noDate) != a1)
+    {
+        mlog(CRITICAL, "Collision replaced cached catalog");
+        status = false;
+    }
+
+    /* clean up */
+    GeoIndexCatalog::cacheMut.lock();
+    {
+        GeoIndexCatalog::cache.erase(key_a);
+        GeoIndexCatalog::cache.erase(key_b);
+    }
+    GeoIndexCatalog::cacheMut.unlock();
+    VSIUnlink(file_a1);
+    VSIUnlink(file_a2);
+    VSIUnlink(file_b);
+
+    lua_pushboolean(L, status);
+    return 1;
+}
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <atomic>
+#include <cmath>
+
+#include "OsApi.h"
+#include "EventLib.h"
+#include "RasterReadExecutor.h"
+#include "UT_RasterReadExecutor.h"
+
+/******************************************************************************
+ * FILE DATA
+ ******************************************************************************/
+
+#define UT_READS            40
+#define UT_SLOW_READS       200
+#define UT_WAIT_MS          10000
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_RasterReadExecutor::OBJECT_TYPE = "UT_RasterReadExecutor";
+const char* UT_RasterReadExecutor::LUA_META_NAME = "UT_RasterReadExecutor";
+const struct luaL_Reg UT_RasterReadExecutor::LUA_META_TABLE[] = {
+    {"adapt",           luaAdaptTest},
+    {"read",            luaReadTest},
+    {NULL,              NULL}
+};
+
+/******************************************************************************
+ * CLASS METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * luaCreate - :UT_RasterReadExecutor()
+ *----------------------------------------------------------------------------*/
+int UT_RasterReadExecutor::luaCreate (lua_State* L)
+{
+    try
+    {
+        return createLuaObject(L, new UT_RasterReadExecutor(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_RasterReadExecutor::UT_RasterReadExecutor (lua_State* L):
+    LuaObject(L, OBJECT_TYPE, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor  -
+ *----------------------------------------------------------------------------*/
+UT_RasterReadExecutor::~UT_RasterReadExecutor(void) = default;
+
+/*----------------------------------------------------------------------------
+ * luaAdaptTest - :adapt()
+ *
+ *  feeds windows of synthetic read latencies through the executor and checks
+ *  that the concurrency limit backs off, probes higher, holds, and stays
+ *  within its floor and the number of reader threads
+ *----------------------------------------------------------------------------*/
+int UT_RasterReadExecutor::luaAdaptTest (lua_State* L)
+{
+    bool status = true;
+    const int window = RasterReadExecutor::MIN_WINDOW_READS;
+
+    /* make sure the reader threads are running */
+    std::atomic<long> reads{0};
+    const RasterReadExecutor::Client client(countRead, &reads);
+
+    RasterReadExecutor::execCond.lock();
+    const RasterReadExecutor::stats_t saved = RasterReadExecutor::stats;
+    const double saved_throughput = RasterReadExecutor::lastThroughput;
+    const long budget = RasterReadExecutor::workers.size();
+    RasterReadExecutor::stats_t& stats = RasterReadExecutor::stats;
+    RasterReadExecutor::windowReads = 0;
+    RasterReadExecutor::windowLatency = 0.0;
+    RasterReadExecutor::windowSaturated = false;
+    {
+        /* no adjustment before a full window */
+        stats.limit = 16;
+        stats.baseline = 0.5;
+        stats.latency = 0.0;
+        feedWindow(window - 1, 1.0, true);
+        if(stats.limit != 16 || stats.latency != 0.0 || RasterReadExecutor::windowReads != window - 1)
+        {
+            mlog(CRITICAL, "Adjusted before a full window: limit %ld, %ld reads in window", stats.limit, RasterReadExecutor::windowReads);
+            status = false;
+        }
+        RasterReadExecutor::windowReads = 0;
+        RasterReadExecutor::windowLatency = 0.0;
+        RasterReadExecutor::windowSaturated = false;
+
+        /* slower reads back off and the baseline drifts toward them */
+        long backoffs = stats.backoffs;
+        stats.limit = 16;
+        stats.baseline = 0.5;
+        feedWindow(window, 1.0, true);
+        const long expected_limit = static_cast<long>(16 * RasterReadExecutor::BACKOFF_FACTOR);
+        const double expected_baseline = 0.5 + (0.5 * RasterReadExecutor::BASELINE_DRIFT);
+        if(stats.limit != expected_limit || stats.backoffs != backoffs + 1 || fabs(stats.baseline - expected_baseline) > 0.01)
+        {
+            mlog(CRITICAL, "Failed to back off: limit %ld, baseline %.3lf, %ld backoffs", stats.limit, stats.baseline, stats.backoffs - backoffs);
+            status = false;
+        }
+
+        /* back off never goes below the floor */
+        backoffs = stats.backoffs;
+        stats.limit = RasterReadExecutor::MIN_CONCURRENCY;
+        stats.baseline = 0.5;
+        feedWindow(window, 1.0, true);
+        if(stats.limit != RasterReadExecutor::MIN_CONCURRENCY || stats.backoffs != backoffs)
+        {
+            mlog(CRITICAL, "Backed off below the floor: limit %ld", stats.limit);
+            status = false;
+        }
+
+        /* faster saturated windows with rising throughput probe higher */
+        long increases = stats.increases;
+        stats.limit = budget - 1;
+        stats.baseline = 1.0;
+        RasterReadExecutor::lastThroughput = 1.0;
+        feedWindow(window, 0.6, true);
+        if(stats.limit != budget || stats.increases != increases + 1 || stats.baseline > 0.61)
+        {
+            mlog(CRITICAL, "Failed to increase: limit %ld of %ld, baseline %.3lf", stats.limit, budget, stats.baseline);
+            status = false;
+        }
+
+        /* increases never go past the reader threads */
+        increases = stats.increases;
+        RasterReadExecutor::lastThroughput = 1.0;
+        feedWindow(window, 0.6, true);
+        if(stats.limit != budget || stats.increases != increases)
+        {
+            mlog(CRITICAL, "Increased past the reader threads: limit %ld of %ld", stats.limit, budget);
+            status = false;
+        }
+
+        /* windows without queued reads hold the limit and reset the throughput reference */
+        stats.limit = budget - 1;
+        RasterReadExecutor::lastThroughput = 1.0;
+        feedWindow(window, 0.6, false);
+        if(stats.limit != budget - 1 || RasterReadExecutor::lastThroughput != 0.0)
+        {
+            mlog(CRITICAL, "Adjusted without saturation: limit %ld, last throughput %.1lf", stats.limit, RasterReadExecutor::lastThroughput);
+            status = false;
+        }
+    }
+    stats.limit = saved.limit;
+    stats.baseline = saved.baseline;
+    stats.latency = saved.latency;
+    stats.throughput = saved.throughput;
+    stats.increases = saved.increases;
+    stats.backoffs = saved.backoffs;
+    RasterReadExecutor::lastThroughput = saved_throughput;
+    RasterReadExecutor::windowReads = 0;
+    RasterReadExecutor::windowLatency = 0.0;
+    RasterReadExecutor::windowSaturated = false;
+    RasterReadExecutor::execCond.unlock();
+
+    lua_pushboolean(L, status);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaReadTest - :read()
+ *
+ *  several clients share the reader threads; every submitted read completes
+ *  and a cancelled client only waits on the reads already started
+ *----------------------------------------------------------------------------*/
+int UT_RasterReadExecutor::luaReadTest (lua_State* L)
+{
+    bool status = true;
+
+    const long completed = RasterReadExecutor::getStats().completed;
+
+    /* concurrent clients */
+    std::atomic<long> reads1{0};
+    std::atomic<long> reads2{0};
+    {
+        RasterReadExecutor::Client client1(countRead, &reads1);
+        RasterReadExecutor::Client client2(countRead, &reads2);
+        for(long i = 0; i < UT_READS; i++)
+        {
+            client1.submit(reinterpret_cast<void*>(i));
+            client2.submit(reinterpret_cast<void*>(i));
+        }
+        if(!client1.wait(UT_WAIT_MS) || !client2.wait(UT_WAIT_MS))
+        {
+            mlog(CRITICAL, "Timed out waiting for reads to complete");
+            status = false;
+        }
+    }
+    if(reads1 != UT_READS || reads2 != UT_READS)
+    {
+        mlog(CRITICAL, "Incorrect number of reads: %ld, %ld", reads1.load(), reads2.load());
+        status = false;
+    }
+    if(RasterReadExecutor::getStats().completed < completed + (2 * UT_READS))
+    {
+        mlog(CRITICAL, "Reads not counted: %ld", RasterReadExecutor::getStats().completed - completed);
+        status = false;
+    }
+
+    /* cancelled client */
+    std::atomic<long> slow_reads{0};
+    {
+        RasterReadExecutor::Client client(slowRead, &slow_reads);
+        for(long i = 0; i < UT_SLOW_READS; i++)
+        {
+            client.submit(reinterpret_cast<void*>(i));
+        }
+        client.cancel();
+        if(!client.wait(UT_WAIT_MS))
+        {
+            mlog(CRITICAL, "Timed out waiting for cancelled reads");
+            status = false;
+        }
+    }
+    if(slow_reads >= UT_SLOW_READS)
+    {
+        mlog(CRITICAL, "Cancelled reads were performed: %ld", slow_reads.load());
+        status = false;
+    }
+
+    lua_pushboolean(L, status);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * feedWindow - reports reads with the given latency, lock held
+ *----------------------------------------------------------------------------*/
+void UT_RasterReadExecutor::feedWindow (int reads, double latency, bool saturated)
+{
+    if(saturated) RasterReadExecutor::stats.queued++;
+    for(int i = 0; i < reads; i++)
+    {
+        RasterReadExecutor::adjust(latency);
+    }
+    if(saturated) RasterReadExecutor::stats.queued--;
+}
+
+/*----------------------------------------------------------------------------
+ * countRead
+ *----------------------------------------------------------------------------*/
+void UT_RasterReadExecutor::countRead (void* context, void* item)
+{
+    (void)item;
+    std::atomic<long>* reads = static_cast<std::atomic<long>*>(context);
+    (*reads)++;
+}
+
+/*----------------------------------------------------------------------------
+ * slowRead
+ *----------------------------------------------------------------------------*/
+void UT_RasterReadExecutor::slowRead (void* context, void* item)
+{
+    (void)item;
+    OsApi::sleep(0.01);
+    std::atomic<long>* reads = static_cast<std::atomic<long>*>(context);
+    (*reads)++;
+}
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "EventLib.h"
+#include "StringLib.h"
+#include "List.h"
+#include "UT_RasterSampleBuffer.h"
+#include "RasterSampleBuffer.h"
+#include "RasterSample.h"
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * makeSample - sample whose fields are all derived from value
+ *----------------------------------------------------------------------------*/
+static RasterSample makeSample (double value, const char* band_name)
+{
+    RasterSample sample(value * 10.0, static_cast<uint64_t>(value) + 100, value / 10.0);
+    sample.value = value;
+    sample.flags = static_cast<uint32_t>(value) + 1;
+    sample.bandName = band_name;
+    sample.stats = {static_cast<uint32_t>(value), value - 1.0, value + 1.0, value, value, 0.5, 0.25};
+    sample.derivs = {static_cast<uint32_t>(value), value * 2.0, value * 3.0};
+    return sample;
+}
+
+/*----------------------------------------------------------------------------
+ * checkSample - sample j of buffer holds the fields of makeSample(value)
+ *----------------------------------------------------------------------------*/
+static bool checkSample (const RasterSampleBuffer& buffer, uint32_t j, double value, const char* band_name)
+{
+    bool status = (buffer.value[j] == value) &&
+                  (buffer.time[j] == value * 10.0) &&
+                  (buffer.verticalShift[j] == value / 10.0) &&
+                  (buffer.fileId[j] == static_cast<uint64_t>(value) + 100) &&
+                  (buffer.flags[j] == static_cast<uint32_t>(value) + 1);
+
+    if(band_name[0] == '\0') status = status && (buffer.band[j] == RasterSampleBuffer::NO_BAND);
+    else status = status && (buffer.band[j] != RasterSampleBuffer::NO_BAND) && (buffer.bandNames[buffer.band[j]] == band_name);
+
+    if(buffer.hasZonalStats())
+    {
+        status = status && (buffer.statsCount[j] == static_cast<uint32_t>(value)) &&
+                           (buffer.statsMin[j] == value - 1.0) && (buffer.statsMax[j] == value + 1.0) &&
+                           (buffer.statsMean[j] == value) && (buffer.statsMedian[j] == value) &&
+                           (buffer.statsStdev[j] == 0.5) && (buffer.statsMad[j] == 0.25);
+    }
+
+    if(buffer.hasSpatialDerivs())
+    {
+        status = status && (buffer.derivsCount[j] == static_cast<uint32_t>(value)) &&
+                           (buffer.derivsSlope[j] == value * 2.0) && (buffer.derivsAspect[j] == value * 3.0);
+    }
+
+    if(!status) mlog(CRITICAL, "Mismatched sample %u, expected value %.1lf band <%s>", j, value, band_name);
+    return status;
+}
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_RasterSampleBuffer::OBJECT_TYPE = "UT_RasterSampleBuffer";
+const char* UT_RasterSampleBuffer::LUA_META_NAME = "UT_RasterSampleBuffer";
+const struct luaL_Reg UT_RasterSampleBuffer::LUA_META_TABLE[] = {
+    {"append",          luaAppendTest},
+    {"merge",           luaMergeTest},
+    {"intern",          luaInternTest},
+    {NULL,              NULL}
+};
+
+/******************************************************************************
+ * CLASS METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * luaCreate - :UT_RasterSampleBuffer()
+ *----------------------------------------------------------------------------*/
+int UT_RasterSampleBuffer::luaCreate (lua_State* L)
+{
+    try
+    {
+        return createLuaObject(L, new UT_RasterSampleBuffer(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_RasterSampleBuffer::UT_RasterSampleBuffer (lua_State* L):
+    LuaObject(L, OBJECT_TYPE, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor  -
+ *----------------------------------------------------------------------------*/
+UT_RasterSampleBuffer::~UT_RasterSampleBuffer(void) = default;
+
+/*----------------------------------------------------------------------------
+ * luaAppendTest - :append()
+ *----------------------------------------------------------------------------*/
+int UT_RasterSampleBuffer::luaAppendTest (lua_State* L)
+{
+    bool status = true;
+
+    /* zonal stats only: point 0 has two samples, point 1 none, point 2 one */
+    RasterSampleBuffer buffer;
+    buffer.configure(true, false);
+    buffer.reserve(3, 2);
+    buffer.append(makeSample(1.0, "red"));
+    buffer.append(makeSample(2.0, ""));
+    buffer.endPoint();
+    buffer.endPoint();
+    buffer.append(makeSample(3.0, "red"));
+    buffer.endPoint();
+
+    if(buffer.numPoints() != 3 || buffer.numSamples() != 3)
+    {
+        mlog(CRITICAL, "Mismatched shape: %u points, %u samples", buffer.numPoints(), buffer.numSamples());
+        status = false;
+    }
+    else
+    {
+        const uint32_t expected_offsets[4] = {0, 2, 2, 3};
+        for(uint32_t i = 0; i < 4; i++)
+        {
+            if(buffer.offsets[i] != expected_offsets[i])
+            {
+                mlog(CRITICAL, "Mismatched offset %u: %u != %u", i, buffer.offsets[i], expected_offsets[i]);
+                status = false;
+            }
+        }
+        status = checkSample(buffer, 0, 1.0, "red") && status;
+        status = checkSample(buffer, 1, 2.0, "") && status;
+        status = checkSample(buffer, 2, 3.0, "red") && status;
+    }
+
+    /* only enabled columns populated */
+    if(buffer.statsMean.size() != 3 || !buffer.derivsSlope.empty())
+    {
+        mlog(CRITICAL, "Mismatched optional columns: %ld stats, %ld derivs", buffer.statsMean.size(), buffer.derivsSlope.size());
+        status = false;
+    }
+
+    /* overridden time and flags */
+    buffer.append(makeSample(4.0, "green"), 123.0, 0xF0);
+    buffer.endPoint();
+    if(buffer.time[3] != 123.0 || buffer.flags[3] != 0xF0)
+    {
+        mlog(CRITICAL, "Failed to override time and flags: %lf, %u", buffer.time[3], buffer.flags[3]);
+        status = false;
+    }
+
+    /* list of samples */
+    List<RasterSample*> slist;
+    slist.add(new RasterSample(makeSample(5.0, "blue")));
+    slist.add(new RasterSample(makeSample(6.0, "red")));
+    buffer.append(slist);
+    buffer.endPoint();
+    if(buffer.numPoints() != 5 || buffer.pointStart(4) != 4 || buffer.pointEnd(4) != 6)
+    {
+        mlog(CRITICAL, "Mismatched list append: %u points, [%u, %u)", buffer.numPoints(), buffer.pointStart(4), buffer.pointEnd(4));
+        status = false;
+    }
+    else
+    {
+        status = checkSample(buffer, 4, 5.0, "blue") && status;
+        status = checkSample(buffer, 5, 6.0, "red") && status;
+    }
+    for(int i = 0; i < slist.length(); i++) delete slist[i];
+
+    /* reconfigure clears buffer */
+    buffer.configure(false, true);
+    buffer.append(makeSample(7.0, "red"));
+    buffer.endPoint();
+    if(buffer.numPoints() != 1 || buffer.numSamples() != 1 || !buffer.statsMean.empty() || buffer.derivsSlope.size() != 1 || buffer.bandNames.size() != 1)
+    {
+        mlog(CRITICAL, "Failed to reconfigure buffer");
+        status = false;
+    }
+    else
+    {
+        status = checkSample(buffer, 0, 7.0, "red") && status;
+    }
+
+    /* reused scratch sample */
+    RasterSample scratch = makeSample(8.0, "red");
+    scratch.clear();
+    if(scratch.value != 0 || scratch.time != 0 || scratch.fileId != 0 || scratch.flags != 0 || !scratch.bandName.empty() ||
+       scratch.stats.count != 0 || scratch.stats.mean != 0.0 || scratch.derivs.count != 0 || scratch.derivs.slopeDeg != 0.0)
+    {
+        mlog(CRITICAL, "Failed to clear scratch sample");
+        status = false;
+    }
+
+    lua_pushboolean(L, status);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaMergeTest - :merge()
+ *
+ *  per thread buffers are merged in point order; band indices are
+ *  translated to the names interned by the destination
+ *----------------------------------------------------------------------------*/
+int UT_RasterSampleBuffer::luaMergeTest (lua_State* L)
+{
+    bool status = true;
+
+    RasterSampleBuffer first(true, true);
+    first.append(makeSample(1.0, "red"));
+    first.endPoint();
+    first.append(makeSample(2.0, "green"));
+    first.append(makeSample(3.0, ""));
+    first.endPoint();
+
+    /* second interns its bands in a different order */
+    RasterSampleBuffer second(true, true);
+    second.endPoint();
+    second.append(makeSample(4.0, "blue"));
+    second.append(makeSample(5.0, "green"));
+    second.append(makeSample(6.0, "red"));
+    second.endPoint();
+    second.append(makeSample(7.0, ""));
+    second.endPoint();
+
+    RasterSampleBuffer empty(true, true);
+
+    RasterSampleBuffer merged(true, true);
+    merged.merge(first);
+    merged.merge(empty);
+    merged.merge(second);
+
+    if(merged.numPoints() != 5 || merged.numSamples() != 7)
+    {
+        mlog(CRITICAL, "Mismatched merged shape: %u points, %u samples", merged.numPoints(), merged.numSamples());
+        status = false;
+    }
+    else
+    {
+        const uint32_t expected_offsets[6] = {0, 1, 3, 3, 6, 7};
+        for(uint32_t i = 0; i < 6; i++)
+        {
+            if(merged.offsets[i] != expected_offsets[i])
+            {
+                mlog(CRITICAL, "Mismatched merged offset %u: %u != %u", i, merged.offsets[i], expected_offsets[i]);
+                status = false;
+            }
+        }
+
+        const char* expected_bands[7] = {"red", "green", "", "blue", "green", "red", ""};
+        for(uint32_t j = 0; j < 7; j++)
+        {
+            status = checkSample(merged, j, static_cast<double>(j + 1), expected_bands[j]) && status;
+        }
+
+        if(merged.bandNames.size() != 3)
+        {
+            mlog(CRITICAL, "Duplicate band names after merge: %ld", merged.bandNames.size());
+            status = false;
+        }
+    }
+
+    /* column lengths agree */
+    const size_t n = merged.value.size();
+    if(merged.time.size() != n || merged.verticalShift.size() != n || merged.fileId.size() != n || merged.flags.size() != n ||
+       merged.band.size() != n || merged.statsMad.size() != n || merged.derivsAspect.size() != n)
+    {
+        mlog(CRITICAL, "Mismatched merged column lengths");
+        status = false;
+    }
+
+    lua_pushboolean(L, status);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaInternTest - :intern()
+ *----------------------------------------------------------------------------*/
+int UT_RasterSampleBuffer::luaInternTest (lua_State* L)
+{
+    bool status = true;
+
+    RasterSampleBuffer buffer;
+
+    if(buffer.internBand("") != RasterSampleBuffer::NO_BAND || !buffer.bandNames.empty())
+    {
+        mlog(CRITICAL, "Empty band name interned");
+        status = false;
+    }
+
+    const uint16_t red = buffer.internBand("red");
+    const uint16_t green = buffer.internBand("green");
+    if(red != 0 || green != 1 || buffer.internBand("red") != red || buffer.internBand("green") != green || buffer.bandNames.size() != 2)
+    {
+        mlog(CRITICAL, "Failed to intern band names: %u, %u, %ld names", red, green, buffer.bandNames.size());
+        status = false;
+    }
+
+    /* band table is full */
+    for(uint32_t i = buffer.bandNames.size(); i < RasterSampleBuffer::NO_BAND; i++)
+    {
+        buffer.bandNames.push_back(FString("band%u", i).c_str());
+    }
+    if(buffer.internBand("overflow") != RasterSampleBuffer::NO_BAND || buffer.bandNames.size() != RasterSampleBuffer::NO_BAND)
+    {
+        mlog(CRITICAL, "Band index overflowed into NO_BAND");
+        status = false;
+    }
+    if(buffer.internBand("green") != green)
+    {
+        mlog(CRITICAL, "Failed to find interned band in full table");
+        status = false;
+    }
+
+    /* clear resets interned names */
+    buffer.clear();
+    if(!buffer.bandNames.empty() || buffer.internBand("green") != 0)
+    {
+        mlog(CRITICAL, "Failed to clear band names");
+        status = false;
+    }
+
+    lua_pushboolean(L, status);
+    return 1;
+}
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <gdal.h>
+#include <vector>
+
+#include "OsApi.h"
+#include "EventLib.h"
+#include "StringLib.h"
+#include "UT_TIFFImage.h"
+#include "GeoLib.h"
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_TIFFImage::OBJECT_TYPE = "UT_TIFFImage";
+const char* UT_TIFFImage::LUA_META_NAME = "UT_TIFFImage";
+const struct luaL_Reg UT_TIFFImage::LUA_META_TABLE[] = {
+    {"tiles",           luaTilesTest},
+    {"cache",           luaCacheTest},
+    {NULL,              NULL}
+};
+
+/******************************************************************************
+ * CLASS METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * luaCreate - :UT_TIFFImage()
+ *----------------------------------------------------------------------------*/
+int UT_TIFFImage::luaCreate (lua_State* L)
+{
+    try
+    {
+        return createLuaObject(L, new UT_TIFFImage(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_TIFFImage::UT_TIFFImage (lua_State* L):
+    LuaObject(L, OBJECT_TYPE, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor  -
+ *----------------------------------------------------------------------------*/
+UT_TIFFImage::~UT_TIFFImage(void) = default;
+
+/*----------------------------------------------------------------------------
+ * writeTestImage - uint32 image whose pixels hold their row-major index
+ *----------------------------------------------------------------------------*/
+bool UT_TIFFImage::writeTestImage (const char* path)
+{
+    GDALDriverH driver = GDALGetDriverByName("GTiff");
+    if(!driver) return false;
+
+    GDALDatasetH dataset = GDALCreate(driver, path, TEST_WIDTH, TEST_HEIGHT, 1, GDT_UInt32, NULL);
+    if(!dataset) return false;
+
+    std::vector<uint32_t> pixels(TEST_WIDTH * TEST_HEIGHT);
+    for(uint32_t i = 0; i < pixels.size(); i++) pixels[i] = i;
+
+    GDALRasterBandH band = GDALGetRasterBand(dataset, 1);
+    const CPLErr err = GDALRasterIO(band, GF_Write, 0, 0, TEST_WIDTH, TEST_HEIGHT, pixels.data(), TEST_WIDTH, TEST_HEIGHT, GDT_UInt32, 0, 0);
+    GDALClose(dataset);
+
+    return err == CE_None;
+}
+
+/*----------------------------------------------------------------------------
+ * luaTilesTest - :tiles()
+ *----------------------------------------------------------------------------*/
+int UT_TIFFImage::luaTilesTest (lua_State* L)
+{
+    bool status = true;
+
+    char dir[] = "/tmp/ut_tiffimage.XXXXXX";
+    if(!mkdtemp(dir))
+    {
+        mlog(CRITICAL, "Failed to create test directory");
+        lua_pushboolean(L, false);
+        return 1;
+    }
+    const FString path("%s/image.tif", dir);
+
+    GeoLib::TIFFImage* image1 = NULL;
+    GeoLib::TIFFImage* image2 = NULL;
+    try
+    {
+        if(!writeTestImage(path.c_str())) throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to write test image");
+
+        image1 = new GeoLib::TIFFImage(NULL, path.c_str(), GeoLib::TIFFImage::GDAL_DRIVER);
+        image2 = new GeoLib::TIFFImage(NULL, path.c_str(), GeoLib::TIFFImage::GDAL_DRIVER);
+
+        /* second open shares the pixels of the first */
+        if(image1->raster != image2->raster)
+        {
+            mlog(CRITICAL, "Images opened on the same file do not share pixels");
+            status = false;
+        }
+
+        /* layout covers every pixel of a partial edge tile */
+        const GeoLib::TIFFImage::image_hdr_t& hdr = image1->image->hdr;
+        if(hdr.width != TEST_WIDTH || hdr.height != TEST_HEIGHT || hdr.typesize != 4 || hdr.tiles_x != 2 || hdr.tiles_y != 2 ||
+           hdr.size != 4UL * 256 * 256 * 4)
+        {
+            mlog(CRITICAL, "Mismatched header: %u x %u, %u bytes, %u x %u tiles, %lu size", hdr.width, hdr.height, hdr.typesize, hdr.tiles_x, hdr.tiles_y, static_cast<unsigned long>(hdr.size));
+            status = false;
+        }
+
+        /* tile index maps every pixel to a unique location within the image */
+        std::vector<bool> used(hdr.size / hdr.typesize, false);
+        for(uint32_t y = 0; y < TEST_HEIGHT && status; y++)
+        {
+            for(uint32_t x = 0; x < TEST_WIDTH && status; x++)
+            {
+                const uint64_t index = GeoLib::TIFFImage::tileIndex(x, y, hdr.tiles_x);
+                if(index >= used.size() || used[index])
+                {
+                    mlog(CRITICAL, "Invalid tile index %lu for pixel (%u, %u)", static_cast<unsigned long>(index), x, y);
+                    status = false;
+                }
+                else
+                {
+                    used[index] = true;
+                }
+            }
+        }
+
+        /* pixels read back at their row-major index */
+        for(uint32_t y = 0; y < TEST_HEIGHT && status; y++)
+        {
+            for(uint32_t x = 0; x < TEST_WIDTH && status; x++)
+            {
+                const uint32_t value = image1->getPixel(x, y).u32;
+                if(value != (y * TEST_WIDTH) + x)
+                {
+                    mlog(CRITICAL, "Mismatched pixel (%u, %u): %u", x, y, value);
+                    status = false;
+                }
+            }
+        }
+
+        /* columns past the edge wrap onto the next row, pixels past the end are invalid */
+        if(image1->getPixel(TEST_WIDTH + 5, 0).u32 != TEST_WIDTH + 5 ||
+           image1->getPixel(0, TEST_HEIGHT).u64 != GeoLib::TIFFImage::INVALID_PIXEL ||
+           image1->getPixel(TEST_WIDTH, TEST_HEIGHT - 1).u64 != GeoLib::TIFFImage::INVALID_PIXEL)
+        {
+            mlog(CRITICAL, "Failed edge pixels");
+            status = false;
+        }
+
+        /* pixels copied out of tiles into a row-major raster */
+        std::vector<uint32_t> pixels(TEST_WIDTH * TEST_HEIGHT, 0);
+        image1->getPixels(pixels.data());
+        for(uint32_t i = 0; i < pixels.size() && status; i++)
+        {
+            if(pixels[i] != i)
+            {
+                mlog(CRITICAL, "Mismatched row-major pixel %u: %u", i, pixels[i]);
+                status = false;
+            }
+        }
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(CRITICAL, "Failed tiles test: %s", e.what());
+        status = false;
+    }
+
+    delete image1;
+    delete image2;
+    remove(path.c_str());
+    rmdir(dir);
+
+    lua_pushboolean(L, status);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaCacheTest - :cache()
+ *----------------------------------------------------------------------------*/
+int UT_TIFFImage::luaCacheTest (lua_State* L)
+{
+    bool status = true;
+
+    char dir[] = "/tmp/ut_tiffimage.XXXXXX";
+    if(!mkdtemp(dir))
+    {
+        mlog(CRITICAL, "Failed to create test directory");
+        lua_pushboolean(L, false);
+        return 1;
+    }
+    const FString path("%s/image.tif", dir);
+
+    /* names of the current and an older version of the image, a
+     * partial image of a writer that no longer exists, and another image */
+    const string name = GeoLib::TIFFImage::cacheName(path.c_str(), GeoLib::TIFFImage::GDAL_DRIVER, "current");
+    const string old_name = GeoLib::TIFFImage::cacheName(path.c_str(), GeoLib::TIFFImage::GDAL_DRIVER, "older");
+    const string dead_name = old_name + ".2147483646.1.tmp";
+    const string other_name = GeoLib::TIFFImage::cacheName("other.tif", GeoLib::TIFFImage::GDAL_DRIVER, "current");
+    const string cache_path = string(dir) + "/" + name;
+    const string old_path = string(dir) + "/" + old_name;
+    const string dead_path = string(dir) + "/" + dead_name;
+    const string other_path = string(dir) + "/" + other_name;
+
+    try
+    {
+        if(!writeTestImage(path.c_str())) throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to write test image");
+        std::shared_ptr<GeoLib::TIFFImage::image_t> decoded = GeoLib::TIFFImage::decodeImage(path.c_str(), GeoLib::TIFFImage::GDAL_DRIVER);
+
+        /* versions of the same file share a prefix that other files do not */
+        const string prefix = name.substr(0, name.rfind('.', name.size() - sizeof(".slmask")) + 1);
+        if(old_name.compare(0, prefix.size(), prefix) != 0 || other_name.compare(0, prefix.size(), prefix) == 0 || old_name == name)
+        {
+            mlog(CRITICAL, "Invalid cache names: %s, %s, %s", name.c_str(), old_name.c_str(), other_name.c_str());
+            status = false;
+        }
+
+        /* round trip through the cache file */
+        if(!GeoLib::TIFFImage::writeImage(cache_path.c_str(), *decoded))
+        {
+            mlog(CRITICAL, "Failed to write cached image %s", cache_path.c_str());
+            status = false;
+        }
+        std::shared_ptr<GeoLib::TIFFImage::image_t> mapped = GeoLib::TIFFImage::mapImage(cache_path.c_str());
+        if(!mapped || !mapped->map || mapped->heap)
+        {
+            mlog(CRITICAL, "Failed to map cached image %s", cache_path.c_str());
+            status = false;
+        }
+        else if(memcmp(&mapped->hdr, &decoded->hdr, sizeof(GeoLib::TIFFImage::image_hdr_t)) != 0 ||
+                memcmp(mapped->raster, decoded->raster, decoded->hdr.size) != 0)
+        {
+            mlog(CRITICAL, "Mismatched cached image");
+            status = false;
+        }
+        else if((reinterpret_cast<uintptr_t>(mapped->raster) % sysconf(_SC_PAGESIZE)) != 0)
+        {
+            mlog(CRITICAL, "Cached pixels are not page aligned");
+            status = false;
+        }
+
+        /* truncated and foreign files are rejected */
+        FILE* fp = fopen(old_path.c_str(), "w");
+        if(fp)
+        {
+            fwrite(&decoded->hdr, 1, sizeof(GeoLib::TIFFImage::image_hdr_t), fp);
+            fclose(fp);
+        }
+        if(GeoLib::TIFFImage::mapImage(old_path.c_str()) != nullptr)
+        {
+            mlog(CRITICAL, "Mapped truncated image");
+            status = false;
+        }
+        fp = fopen(dead_path.c_str(), "w");
+        if(fp) fclose(fp);
+        fp = fopen(other_path.c_str(), "w");
+        if(fp)
+        {
+            fputs("not an image", fp);
+            fclose(fp);
+        }
+        if(GeoLib::TIFFImage::mapImage(other_path.c_str()) != nullptr)
+        {
+            mlog(CRITICAL, "Mapped foreign file");
+            status = false;
+        }
+
+        /* stale versions removed, current image and other images kept */
+        GeoLib::TIFFImage::removeStaleImages(dir, name);
+        struct stat st;
+        if(stat(old_path.c_str(), &st) == 0 || stat(dead_path.c_str(), &st) == 0)
+        {
+            mlog(CRITICAL, "Failed to remove stale cached images");
+            status = false;
+        }
+        if(stat(cache_path.c_str(), &st) != 0 || stat(other_path.c_str(), &st) != 0)
+        {
+            mlog(CRITICAL, "Removed cached images still in use");
+            status = false;
+        }
+
+        /* mapping outlives removal of the cache file */
+        remove(cache_path.c_str());
+        if(mapped && memcmp(mapped->raster, decoded->raster, decoded->hdr.size) != 0)
+        {
+            mlog(CRITICAL, "Mapped image changed after cache file removed");
+            status = false;
+        }
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(CRITICAL, "Failed cache test: %s", e.what());
+        status = false;
+    }
+
+    remove(path.c_str());
+    remove(cache_path.c_str());
+    remove(old_path.c_str());
+    remove(dead_path.c_str());
+    remove(other_path.c_str());
+    rmdir(dir);
+
+    lua_pushboolean(L, status);
+    return 1;
+}
@@ -39,6 +39,7 @@
 #include "RecordObject.h"
 #include "H5Dataset.h"
 #include "H5Dense.h"
+#include "H5Filter.h"
 #include "H5CoroLib.h"
 #include "GeoDataFrame.h"
 
@@ -91,6 +92,7 @@ H5Coro::Future::Future (void)
     for(int d = 0; d < MAX_NDIMS; d++)
     {
         info.shape[d] = 0;
+        info.chunkdims[d] = 0;
     }
 
     complete        = false;
@@ -156,6 +158,7 @@ H5Coro::Context::Context (const Asset* asset, const char* resource, uint32_t opt
     ioDriver            (NULL),
     l1                  (IO_CACHE_L1_ENTRIES, hashL1),
     l2                  (IO_CACHE_L2_ENTRIES, hashL2),
+    cache_hit           (0),
     cache_miss          (0),
     l1_cache_replace    (0),
     l2_cache_replace    (0),
@@ -229,6 +232,7 @@ void H5Coro::Context::ioRequest (uint64_t* pos, int64_t size, uint8_t* buffer, i
             {
                 /* Entry Found in Cache */
                 cached = true;
+                cache_hit++;
 
                 /* Set Offset to Start of Requested Data */
                 data_offset = file_position - entry.pos;
@@ -465,13 +469,16 @@ H5Coro::info_t H5Coro::read (Context* context, const char* datasetname, RecordOb
     const uint32_t trace_id = start_trace(INFO, parent_trace_id, "h5coro_read", "{\"context\":\"%s\", \"dataset\":\"%s\"}", context->name, datasetname);
 
     /* Open Resource and Read Dataset */
-    const H5Dataset dataset(&info, context, datasetname, slice, slicendims, _meta_only);
+    const H5Dataset dataset(&info, context, datasetname, slice, slicendims, _meta_only, valtype);
     if(info.data)
     {
         bool data_valid = true;
 
+        /* Check if Translation Already Performed During Read (or Not Needed) */
+        const bool translate = !dataset.isConverted() && H5Filter::needsConversion(info.datatype, valtype);
+
         /* Perform Integer Type Translation */
-        if(valtype == RecordObject::INTEGER)
+        if(translate && valtype == RecordObject::INTEGER)
         {
             /* Allocate Buffer of Integers */
             long* tbuf = new (std::align_val_t(H5CORO_DATA_ALIGNMENT)) long [info.elements];
@@ -592,7 +599,7 @@ H5Coro::info_t H5Coro::read (Context* context, const char* datasetname, RecordOb
             info.datasize = sizeof(long) * info.elements;
         }
         /* Perform Integer Type Transaltion */
-        else if(valtype == RecordObject::REAL)
+        else if(translate && valtype == RecordObject::REAL)
         {
             /* Allocate Buffer of doubles */
             double* tbuf = new (std::align_val_t(H5CORO_DATA_ALIGNMENT)) double [info.elements];
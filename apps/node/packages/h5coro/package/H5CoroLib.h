@@ -107,6 +107,7 @@ namespace H5Coro
         uint8_t*                    data;       // point to allocated data buffer - must be H5CORO_DATA_ALIGNMENT aligned
         RecordObject::fieldType_t   datatype;   // data type of elements
         int64_t                     shape[MAX_NDIMS]; // dimensions of the data
+        int64_t                     chunkdims[MAX_NDIMS]; // dimensions of each chunk in the file, zero when not chunked
     } info_t;
 
     typedef struct {                    // [r0, r1)
@@ -188,6 +189,7 @@ namespace H5Coro
         cache_t             l1;                     // level 1 cache
         cache_t             l2;                     // level 2 cache
         Mutex               mut;                    // cache mutex
+        long                cache_hit;
         long                cache_miss;
         long                l1_cache_replace;
         long                l2_cache_replace;
@@ -40,8 +40,7 @@
 #include "H5Dense.h"
 #include "H5Dataset.h"
 #include "H5CoroLib.h"
-
-#include <zlib.h>
+#include "H5Filter.h"
 
 using H5Coro::EOR;
 using H5Coro::range_t;
@@ -72,11 +71,13 @@ Mutex H5Dataset::metaMutex;
  *----------------------------------------------------------------------------*/
 H5Dataset::H5Dataset (info_t* info, Context* context,
                       const char* dataset, const range_t* slice, int slicendims,
-                      bool _meta_only):
+                      bool _meta_only, RecordObject::valType_t _valtype):
     ioContext (context),
     datasetName (StringLib::duplicate(dataset)),
     datasetPrint (StringLib::duplicate(dataset)),
     metaOnly (_meta_only),
+    valType (_valtype),
+    convertFunc (NULL),
     dataChunkBuffer (NULL),
     dataChunkFilterBuffer (NULL),
     dataChunkBufferSize (0),
@@ -94,6 +95,7 @@ H5Dataset::H5Dataset (info_t* info, Context* context,
     info->data     = NULL;
     info->datatype = RecordObject::INVALID_FIELD;
     for(int d = 0; d < MAX_NDIMS; d++) info->shape[d] = 0;
+    for(int d = 0; d < MAX_NDIMS; d++) info->chunkdims[d] = 0;
 
     /* Initialize HyperSlice */
     for(int d = 0; d < MAX_NDIMS; d++)
@@ -197,6 +199,14 @@ H5Dataset::~H5Dataset (void)
     tearDown();
 }
 
+/*----------------------------------------------------------------------------
+ * isConverted - true when the data was converted to the requested valtype as it was read
+ *----------------------------------------------------------------------------*/
+bool H5Dataset::isConverted (void) const
+{
+    return convertFunc != NULL;
+}
+
 /*----------------------------------------------------------------------------
  * tearDown
  *----------------------------------------------------------------------------*/
@@ -347,11 +357,55 @@ void H5Dataset::readDataset (info_t* info)
         num_elements *= elements_in_dimension;
         shape[d] = elements_in_dimension;
         info->shape[d] = shape[d];
+        if(metaData.layout == CHUNKED_LAYOUT) info->chunkdims[d] = metaData.chunkdims[d];
+    }
+
+    /* Populate Data Type Attribute in Info */
+    if(metaData.type == FIXED_POINT_TYPE)
+    {
+        if(metaData.signedval)
+        {
+            if      (metaData.typesize == 1) info->datatype = RecordObject::INT8;
+            else if (metaData.typesize == 2) info->datatype = RecordObject::INT16;
+            else if (metaData.typesize == 4) info->datatype = RecordObject::INT32;
+            else if (metaData.typesize == 8) info->datatype = RecordObject::INT64;
+            else throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid type size for signed integer: %d", metaData.typesize);
+        }
+        else
+        {
+            if      (metaData.typesize == 1) info->datatype = RecordObject::UINT8;
+            else if (metaData.typesize == 2) info->datatype = RecordObject::UINT16;
+            else if (metaData.typesize == 4) info->datatype = RecordObject::UINT32;
+            else if (metaData.typesize == 8) info->datatype = RecordObject::UINT64;
+            else throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid type size for unsigned integer: %d", metaData.typesize);
+        }
+    }
+    else if(metaData.type == FLOATING_POINT_TYPE)
+    {
+        if      (metaData.typesize == 4) info->datatype = RecordObject::FLOAT;
+        else if (metaData.typesize == 8) info->datatype = RecordObject::DOUBLE;
+        else throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid type size for floating point number: %d", metaData.typesize);
+    }
+    else if(metaData.type == STRING_TYPE || metaData.type == VL_STRING_TYPE)
+    {
+        info->datatype = RecordObject::STRING;
+    }
+
+    /*
+     * Fuse Type Conversion into Chunk Reads
+     *  one dimensional chunked datasets are converted into the representation
+     *  requested by the caller as each chunk is decoded, which avoids a second
+     *  pass over the data and a second allocation after the read
+     */
+    if(!metaOnly && (metaData.layout == CHUNKED_LAYOUT) && (metaData.ndims == 1))
+    {
+        convertFunc = H5Filter::getConverter(info->datatype, valType);
     }
 
     /* Allocate Data Buffer */
     uint8_t* buffer = NULL;
     const int64_t buffer_size = num_elements * metaData.typesize;
+    const int64_t output_size = convertFunc ? num_elements * H5Filter::CONVERTED_TYPE_SIZE : buffer_size;
     if(H5CORO_ERROR_CHECKING)
     {
         if(metaData.size != 0 && metaData.size < buffer_size)
@@ -366,7 +420,7 @@ void H5Dataset::readDataset (info_t* info)
         const int64_t extra_space_for_terminator = (metaData.type == STRING_TYPE);
 
         /* Allocate */
-        buffer = new (std::align_val_t(H5CORO_DATA_ALIGNMENT)) uint8_t [buffer_size + extra_space_for_terminator];
+        buffer = new (std::align_val_t(H5CORO_DATA_ALIGNMENT)) uint8_t [output_size + extra_space_for_terminator];
 
         /* Gaurantee Termination of String */
         if(metaData.type == STRING_TYPE)
@@ -377,9 +431,16 @@ void H5Dataset::readDataset (info_t* info)
         /* Fill Buffer with Fill Value (if provided) */
         if(H5CORO_ENABLE_FILL && metaData.fillsize > 0)
         {
-            for(int64_t i = 0; i < buffer_size; i += metaData.fillsize)
+            fill_t fill = metaData.fill;
+            int64_t fillsize = metaData.fillsize;
+            if(convertFunc)
             {
-                memcpy(&buffer[i], &metaData.fill.fill_ll, metaData.fillsize);
+                convertFunc(reinterpret_cast<const uint8_t*>(&metaData.fill), reinterpret_cast<uint8_t*>(&fill), 1);
+                fillsize = H5Filter::CONVERTED_TYPE_SIZE;
+            }
+            for(int64_t i = 0; i < output_size; i += fillsize)
+            {
+                memcpy(&buffer[i], &fill.fill_ll, fillsize);
             }
         }
     }
@@ -387,40 +448,9 @@ void H5Dataset::readDataset (info_t* info)
     /* Populate Attributes in Info */
     info->typesize = metaData.typesize;
     info->elements = num_elements;
-    info->datasize = buffer_size;
+    info->datasize = output_size;
     info->data     = buffer;
 
-    /* Populate Data Type Attribute in Info */
-    if(metaData.type == FIXED_POINT_TYPE)
-    {
-        if(metaData.signedval)
-        {
-            if      (metaData.typesize == 1) info->datatype = RecordObject::INT8;
-            else if (metaData.typesize == 2) info->datatype = RecordObject::INT16;
-            else if (metaData.typesize == 4) info->datatype = RecordObject::INT32;
-            else if (metaData.typesize == 8) info->datatype = RecordObject::INT64;
-            else throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid type size for signed integer: %d", metaData.typesize);
-        }
-        else
-        {
-            if      (metaData.typesize == 1) info->datatype = RecordObject::UINT8;
-            else if (metaData.typesize == 2) info->datatype = RecordObject::UINT16;
-            else if (metaData.typesize == 4) info->datatype = RecordObject::UINT32;
-            else if (metaData.typesize == 8) info->datatype = RecordObject::UINT64;
-            else throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid type size for unsigned integer: %d", metaData.typesize);
-        }
-    }
-    else if(metaData.type == FLOATING_POINT_TYPE)
-    {
-        if      (metaData.typesize == 4) info->datatype = RecordObject::FLOAT;
-        else if (metaData.typesize == 8) info->datatype = RecordObject::DOUBLE;
-        else throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid type size for floating point number: %d", metaData.typesize);
-    }
-    else if(metaData.type == STRING_TYPE || metaData.type == VL_STRING_TYPE)
-    {
-        info->datatype = RecordObject::STRING;
-    }
-
     /* Check if Data Address and Data Size is Valid */
     if(H5CORO_ERROR_CHECKING)
     {
@@ -577,6 +607,26 @@ void H5Dataset::readDataset (info_t* info)
     }
 }
 
+/*----------------------------------------------------------------------------
+ * writeChunk
+ *
+ *  buffer_index is the byte offset the chunk data would have in a buffer of
+ *  unconverted elements; when converting, the elements are widened into
+ *  their position in the buffer of converted elements
+ *----------------------------------------------------------------------------*/
+void H5Dataset::writeChunk (uint8_t* buffer, uint64_t buffer_index, const uint8_t* chunk, int64_t chunk_bytes) const
+{
+    if(convertFunc)
+    {
+        const uint64_t element_index = buffer_index / metaData.typesize;
+        convertFunc(chunk, &buffer[element_index * H5Filter::CONVERTED_TYPE_SIZE], chunk_bytes / metaData.typesize);
+    }
+    else
+    {
+        memcpy(&buffer[buffer_index], chunk, chunk_bytes);
+    }
+}
+
 /*----------------------------------------------------------------------------
  * readSuperblock
  *----------------------------------------------------------------------------*/
@@ -1311,7 +1361,7 @@ int H5Dataset::readBTreeV1 (uint64_t pos, uint8_t* buffer, uint64_t buffer_size)
 
                     /* Read Data into Chunk Filter Buffer (holds the compressed data) */
                     ioContext->ioRequest(&child_addr, curr_node.chunk_size, dataChunkFilterBuffer, dataSizeHint, true);
-                    if((chunk_bytes == dataChunkBufferSize) && (!metaData.filter[SHUFFLE_FILTER]))
+                    if((chunk_bytes == dataChunkBufferSize) && (!metaData.filter[SHUFFLE_FILTER]) && (!convertFunc))
                     {
                         /* Inflate Directly into Data Buffer */
                         inflateChunk(dataChunkFilterBuffer, curr_node.chunk_size, &buffer[buffer_index], chunk_bytes);
@@ -1321,7 +1371,13 @@ int H5Dataset::readBTreeV1 (uint64_t pos, uint8_t* buffer, uint64_t buffer_size)
                         /* Inflate into Data Chunk Buffer */
                         inflateChunk(dataChunkFilterBuffer, curr_node.chunk_size, dataChunkBuffer, dataChunkBufferSize);
 
-                        if(metaData.filter[SHUFFLE_FILTER])
+                        if(metaData.filter[SHUFFLE_FILTER] && convertFunc)
+                        {
+                            /* Shuffle Data Chunk Buffer into Chunk Filter Buffer (free once inflated) and Convert into Data Buffer */
+                            shuffleChunk(dataChunkBuffer, dataChunkBufferSize, dataChunkFilterBuffer, chunk_index, chunk_bytes, metaData.typesize);
+                            writeChunk(buffer, buffer_index, dataChunkFilterBuffer, chunk_bytes);
+                        }
+                        else if(metaData.filter[SHUFFLE_FILTER])
                         {
                             /* Shuffle Data Chunk Buffer into Data Buffer */
                             shuffleChunk(dataChunkBuffer, dataChunkBufferSize, &buffer[buffer_index], chunk_index, chunk_bytes, metaData.typesize);
@@ -1329,7 +1385,7 @@ int H5Dataset::readBTreeV1 (uint64_t pos, uint8_t* buffer, uint64_t buffer_size)
                         else
                         {
                             /* Copy Data Chunk Buffer into Data Buffer */
-                            memcpy(&buffer[buffer_index], &dataChunkBuffer[chunk_index], chunk_bytes);
+                            writeChunk(buffer, buffer_index, &dataChunkBuffer[chunk_index], chunk_bytes);
                         }
                     }
 
@@ -1352,7 +1408,15 @@ int H5Dataset::readBTreeV1 (uint64_t pos, uint8_t* buffer, uint64_t buffer_size)
 
                     // read data into data buffer
                     uint64_t chunk_offset_addr = child_addr + chunk_index;
-                    ioContext->ioRequest(&chunk_offset_addr, chunk_bytes, &buffer[buffer_index], dataSizeHint, true);
+                    if(convertFunc)
+                    {
+                        ioContext->ioRequest(&chunk_offset_addr, chunk_bytes, dataChunkBuffer, dataSizeHint, true);
+                        writeChunk(buffer, buffer_index, dataChunkBuffer, chunk_bytes);
+                    }
+                    else
+                    {
+                        ioContext->ioRequest(&chunk_offset_addr, chunk_bytes, &buffer[buffer_index], dataSizeHint, true);
+                    }
                     dataSizeHint = Context::IO_CACHE_L1_LINESIZE;
                 }
             }
@@ -3701,45 +3765,7 @@ int H5Dataset::highestBit (uint64_t value)
  *----------------------------------------------------------------------------*/
 int H5Dataset::inflateChunk (uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_size)
 {
-    int status;
-    z_stream strm;
-
-    /* Initialize z_stream State */
-    strm.zalloc     = Z_NULL;
-    strm.zfree      = Z_NULL;
-    strm.opaque     = Z_NULL;
-    strm.avail_in   = 0;
-    strm.next_in    = Z_NULL;
-
-    /* Initialize z_stream */
-    status = inflateInit(&strm);
-    if(status != Z_OK)
-    {
-        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to initialize z_stream: %d", status);
-    }
-
-    /* Decompress Until Entire Chunk is Processed */
-    strm.avail_in = input_size;
-    strm.next_in = input;
-
-    /* Decompress Chunk */
-    do
-    {
-        strm.avail_out = output_size;
-        strm.next_out = output;
-        status = inflate(&strm, Z_NO_FLUSH);
-        if(status != Z_OK) break;
-    } while (strm.avail_out == 0);
-
-    /* Clean Up z_stream */
-    inflateEnd(&strm);
-
-    /* Check Decompression Complete */
-    if(status != Z_STREAM_END)
-    {
-        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to inflate entire z_stream: %d", status);
-    }
-
+    H5Filter::inflate(input, input_size, output, output_size);
     return 0;
 }
 
@@ -3748,27 +3774,7 @@ int H5Dataset::inflateChunk (uint8_t* input, uint32_t input_size, uint8_t* outpu
  *----------------------------------------------------------------------------*/
 int H5Dataset::shuffleChunk (const uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_offset, uint32_t output_size, int type_size)
 {
-    if(H5CORO_ERROR_CHECKING)
-    {
-        if(type_size <= 0 || type_size > 8)
-        {
-            throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid data size to perform shuffle on: %d", type_size);
-        }
-    }
-
-    int64_t dst_index = 0;
-    const int64_t shuffle_block_size = input_size / type_size;
-    const int64_t num_elements = output_size / type_size;
-    const int64_t start_element = output_offset / type_size;
-    for(int64_t element_index = start_element; element_index < (start_element + num_elements); element_index++)
-    {
-        for(int64_t val_index = 0; val_index < type_size; val_index++)
-        {
-            const int64_t src_index = (val_index * shuffle_block_size) + element_index;
-            output[dst_index++] = input[src_index];
-        }
-    }
-
+    H5Filter::unshuffle(input, input_size, output, output_offset, output_size, type_size);
     return 0;
 }
 
@@ -38,6 +38,7 @@
 
 #include "OsApi.h"
 #include "H5CoroLib.h"
+#include "H5Filter.h"
 
 using H5Coro::info_t;
 using H5Coro::range_t;
@@ -108,9 +109,11 @@ class H5Dataset
 
                 H5Dataset   (info_t* info, Context* context,
                              const char* dataset, const range_t* slice, int slicendims,
-                             bool _meta_only=false);
+                             bool _meta_only=false, RecordObject::valType_t _valtype=RecordObject::DYNAMIC);
         virtual ~H5Dataset  (void);
 
+        bool    isConverted (void) const;
+
     protected:
 
         /*--------------------------------------------------------------------
@@ -247,6 +250,7 @@ class H5Dataset
         uint64_t            readField             (int64_t size, uint64_t* pos);
         uint64_t            readPackedField       (int64_t size, uint64_t* pos);
         void                readDataset           (info_t* info);
+        void                writeChunk            (uint8_t* buffer, uint64_t buffer_index, const uint8_t* chunk, int64_t chunk_bytes) const;
 
         uint64_t            readSuperblock        (void);
         int                 readFractalHeap       (msg_type_t type, uint64_t pos, uint8_t hdr_flags, int dlvl, heap_info_t* heap_info);
@@ -307,6 +311,8 @@ class H5Dataset
         range_t             hyperslice[MAX_NDIMS];
         int64_t             shape[MAX_NDIMS];
         bool                metaOnly;
+        RecordObject::valType_t valType;            // representation the caller wants the values in
+        H5Filter::convert_func_t convertFunc;       // set when conversion to valType is fused into the chunk reads
 
         /* File Info */
         uint8_t*            dataChunkBuffer;            // buffer for reading uncompressed chunk
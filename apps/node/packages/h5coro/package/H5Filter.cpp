@@ -0,0 +1,621 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "H5Filter.h"
+#include "H5CoroLib.h"
+
+#include <zlib.h>
+
+#ifdef __libdeflate__
+#include <libdeflate.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define H5FILTER_X86
+#include <immintrin.h>
+#endif
+
+/******************************************************************************
+ * LOCAL DATA
+ ******************************************************************************/
+
+#ifdef __libdeflate__
+/*
+ * libdeflate decompressors are not thread safe but are expensive enough to
+ * allocate that one is kept per thread for the lifetime of the thread
+ */
+struct LibdeflateDecompressor
+{
+    libdeflate_decompressor* d;
+    LibdeflateDecompressor(void): d(libdeflate_alloc_decompressor()) {}
+    ~LibdeflateDecompressor(void) { if(d) libdeflate_free_decompressor(d); }
+};
+static thread_local LibdeflateDecompressor libdeflateDecompressor;
+#endif
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * convertScalar
+ *----------------------------------------------------------------------------*/
+template <class S, class D>
+static void convertScalar (const uint8_t* input, uint8_t* output, int64_t num_elements)
+{
+    const S* src = reinterpret_cast<const S*>(input);
+    D* dst = reinterpret_cast<D*>(output);
+    for(int64_t i = 0; i < num_elements; i++)
+    {
+        dst[i] = static_cast<D>(src[i]);
+    }
+}
+
+#ifdef H5FILTER_X86
+/*----------------------------------------------------------------------------
+ * convertAVX2 - widens four elements per instruction
+ *
+ *  W loads four source elements into the low bytes of a 128 bit register and
+ *  widens them into a 256 bit register of doubles or 64 bit integers
+ *----------------------------------------------------------------------------*/
+template <class S, class D, __m256i (*W)(__m128i)>
+__attribute__((target("avx2")))
+static void convertAVX2 (const uint8_t* input, uint8_t* output, int64_t num_elements)
+{
+    const int64_t num_vectors = num_elements / 4;
+    const S* src = reinterpret_cast<const S*>(input);
+    D* dst = reinterpret_cast<D*>(output);
+    for(int64_t v = 0; v < num_vectors; v++, src += 4, dst += 4)
+    {
+        __m128i in;
+        if(sizeof(S) == 4)      in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        else if(sizeof(S) == 2) in = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+        else                    { int32_t b; memcpy(&b, src, sizeof(b)); in = _mm_cvtsi32_si128(b); }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), W(in));
+    }
+    convertScalar<S, D>(reinterpret_cast<const uint8_t*>(src), reinterpret_cast<uint8_t*>(dst), num_elements - (num_vectors * 4));
+}
+
+__attribute__((target("avx2"))) static __m256i widenFloat  (__m128i v) { return _mm256_castpd_si256(_mm256_cvtps_pd(_mm_castsi128_ps(v))); }
+__attribute__((target("avx2"))) static __m256i widenInt32  (__m128i v) { return _mm256_cvtepi32_epi64(v); }
+__attribute__((target("avx2"))) static __m256i widenUInt32 (__m128i v) { return _mm256_cvtepu32_epi64(v); }
+__attribute__((target("avx2"))) static __m256i widenInt16  (__m128i v) { return _mm256_cvtepi16_epi64(v); }
+__attribute__((target("avx2"))) static __m256i widenUInt16 (__m128i v) { return _mm256_cvtepu16_epi64(v); }
+__attribute__((target("avx2"))) static __m256i widenInt8   (__m128i v) { return _mm256_cvtepi8_epi64(v); }
+__attribute__((target("avx2"))) static __m256i widenUInt8  (__m128i v) { return _mm256_cvtepu8_epi64(v); }
+__attribute__((target("avx2"))) static __m256i int32ToReal (__m128i v) { return _mm256_castpd_si256(_mm256_cvtepi32_pd(v)); }
+#endif
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+H5Filter::unshuffle_kernel_t H5Filter::unshuffleKernel = H5Filter::SCALAR_UNSHUFFLE;
+H5Filter::unshuffle_func_t H5Filter::unshuffleFunc = H5Filter::unshuffleScalar;
+bool H5Filter::avx2Supported = false;
+
+/******************************************************************************
+ * H5FILTER METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * init
+ *----------------------------------------------------------------------------*/
+void H5Filter::init (void)
+{
+    unshuffleKernel = SCALAR_UNSHUFFLE;
+    #ifdef H5FILTER_X86
+    __builtin_cpu_init();
+    avx2Supported = __builtin_cpu_supports("avx2");
+    if(avx2Supported) unshuffleKernel = AVX2_UNSHUFFLE;
+    else if(__builtin_cpu_supports("sse2")) unshuffleKernel = SSE2_UNSHUFFLE;
+    #endif
+    unshuffleFunc = getUnshuffleFunc(unshuffleKernel);
+
+    mlog(INFO, "H5Coro using %s inflate and %s unshuffle", inflate2str(getInflateBackend()), unshuffle2str(unshuffleKernel));
+}
+
+/*----------------------------------------------------------------------------
+ * inflate
+ *
+ *  uses the build time backend and falls back to zlib at runtime for any
+ *  stream the backend cannot fully decompress into the output buffer
+ *----------------------------------------------------------------------------*/
+void H5Filter::inflate (const uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_size)
+{
+    #ifdef __libdeflate__
+    if(inflateLibdeflate(input, input_size, output, output_size)) return;
+    #endif
+    inflateZlib(input, input_size, output, output_size);
+}
+
+/*----------------------------------------------------------------------------
+ * unshuffle
+ *----------------------------------------------------------------------------*/
+void H5Filter::unshuffle (const uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_offset, uint32_t output_size, int type_size)
+{
+    if(H5CORO_ERROR_CHECKING)
+    {
+        if(type_size <= 0 || type_size > 8)
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "invalid data size to perform shuffle on: %d", type_size);
+        }
+    }
+
+    const int64_t shuffle_block_size = input_size / type_size;
+    const int64_t num_elements = output_size / type_size;
+    const int64_t start_element = output_offset / type_size;
+    unshuffleFunc(input, shuffle_block_size, output, start_element, num_elements, type_size);
+}
+
+/*----------------------------------------------------------------------------
+ * inflateZlib
+ *----------------------------------------------------------------------------*/
+void H5Filter::inflateZlib (const uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_size)
+{
+    int status;
+    z_stream strm;
+
+    /* Initialize z_stream State */
+    strm.zalloc     = Z_NULL;
+    strm.zfree      = Z_NULL;
+    strm.opaque     = Z_NULL;
+    strm.avail_in   = 0;
+    strm.next_in    = Z_NULL;
+
+    /* Initialize z_stream */
+    status = inflateInit(&strm);
+    if(status != Z_OK)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to initialize z_stream: %d", status);
+    }
+
+    /* Decompress Until Entire Chunk is Processed */
+    strm.avail_in = input_size;
+    strm.next_in = const_cast<uint8_t*>(input);
+
+    /* Decompress Chunk */
+    do
+    {
+        strm.avail_out = output_size;
+        strm.next_out = output;
+        status = ::inflate(&strm, Z_NO_FLUSH);
+        if(status != Z_OK) break;
+    } while (strm.avail_out == 0);
+
+    /* Clean Up z_stream */
+    inflateEnd(&strm);
+
+    /* Check Decompression Complete */
+    if(status != Z_STREAM_END)
+    {
+        throw RunTimeException(CRITICAL, RTE_FAILURE, "failed to inflate entire z_stream: %d", status);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * inflateLibdeflate
+ *
+ *  returns false when libdeflate is unavailable or did not succeed so that
+ *  the caller can fall back to zlib
+ *----------------------------------------------------------------------------*/
+bool H5Filter::inflateLibdeflate (const uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_size)
+{
+    #ifdef __libdeflate__
+    libdeflate_decompressor* d = libdeflateDecompressor.d;
+    if(!d) return false;
+
+    size_t actual_out_size = 0;
+    const libdeflate_result result = libdeflate_zlib_decompress(d, input, input_size, output, output_size, &actual_out_size);
+    if(result == LIBDEFLATE_SUCCESS) return true;
+
+    mlog(DEBUG, "libdeflate failed to inflate chunk (%d), falling back to zlib", static_cast<int>(result));
+    return false;
+    #else
+    (void)input;
+    (void)input_size;
+    (void)output;
+    (void)output_size;
+    return false;
+    #endif
+}
+
+/*----------------------------------------------------------------------------
+ * unshuffleScalar
+ *----------------------------------------------------------------------------*/
+void H5Filter::unshuffleScalar (const uint8_t* input, int64_t shuffle_block_size, uint8_t* output, int64_t start_element, int64_t num_elements, int type_size)
+{
+    int64_t dst_index = 0;
+    for(int64_t element_index = start_element; element_index < (start_element + num_elements); element_index++)
+    {
+        for(int64_t val_index = 0; val_index < type_size; val_index++)
+        {
+            const int64_t src_index = (val_index * shuffle_block_size) + element_index;
+            output[dst_index++] = input[src_index];
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * unshuffleSSE2
+ *
+ *  interleaves 16 elements at a time from each byte plane with successive
+ *  8, 16, and 32 bit unpacks; remaining elements and type sizes other than
+ *  2, 4, and 8 bytes are handled by the scalar kernel
+ *----------------------------------------------------------------------------*/
+void H5Filter::unshuffleSSE2 (const uint8_t* input, int64_t shuffle_block_size, uint8_t* output, int64_t start_element, int64_t num_elements, int type_size)
+{
+    #ifdef H5FILTER_X86
+    const int64_t num_vectors = num_elements / 16;
+    const uint8_t* src = &input[start_element];
+    __m128i* dst = reinterpret_cast<__m128i*>(output);
+
+    if(type_size == 2)
+    {
+        for(int64_t v = 0; v < num_vectors; v++, src += 16)
+        {
+            const __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            const __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + shuffle_block_size));
+            _mm_storeu_si128(dst++, _mm_unpacklo_epi8(p0, p1));
+            _mm_storeu_si128(dst++, _mm_unpackhi_epi8(p0, p1));
+        }
+    }
+    else if(type_size == 4)
+    {
+        for(int64_t v = 0; v < num_vectors; v++, src += 16)
+        {
+            const __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            const __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + shuffle_block_size));
+            const __m128i p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (2 * shuffle_block_size)));
+            const __m128i p3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (3 * shuffle_block_size)));
+            const __m128i p01lo = _mm_unpacklo_epi8(p0, p1);
+            const __m128i p01hi = _mm_unpackhi_epi8(p0, p1);
+            const __m128i p23lo = _mm_unpacklo_epi8(p2, p3);
+            const __m128i p23hi = _mm_unpackhi_epi8(p2, p3);
+            _mm_storeu_si128(dst++, _mm_unpacklo_epi16(p01lo, p23lo));
+            _mm_storeu_si128(dst++, _mm_unpackhi_epi16(p01lo, p23lo));
+            _mm_storeu_si128(dst++, _mm_unpacklo_epi16(p01hi, p23hi));
+            _mm_storeu_si128(dst++, _mm_unpackhi_epi16(p01hi, p23hi));
+        }
+    }
+    else if(type_size == 8)
+    {
+        for(int64_t v = 0; v < num_vectors; v++, src += 16)
+        {
+            __m128i p[8];
+            for(int b = 0; b < 8; b++)
+            {
+                p[b] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (b * shuffle_block_size)));
+            }
+            const __m128i p01lo = _mm_unpacklo_epi8(p[0], p[1]);
+            const __m128i p01hi = _mm_unpackhi_epi8(p[0], p[1]);
+            const __m128i p23lo = _mm_unpacklo_epi8(p[2], p[3]);
+            const __m128i p23hi = _mm_unpackhi_epi8(p[2], p[3]);
+            const __m128i p45lo = _mm_unpacklo_epi8(p[4], p[5]);
+            const __m128i p45hi = _mm_unpackhi_epi8(p[4], p[5]);
+            const __m128i p67lo = _mm_unpacklo_epi8(p[6], p[7]);
+            const __m128i p67hi = _mm_unpackhi_epi8(p[6], p[7]);
+            const __m128i p0123a = _mm_unpacklo_epi16(p01lo, p23lo);
+            const __m128i p0123b = _mm_unpackhi_epi16(p01lo, p23lo);
+            const __m128i p0123c = _mm_unpacklo_epi16(p01hi, p23hi);
+            const __m128i p0123d = _mm_unpackhi_epi16(p01hi, p23hi);
+            const __m128i p4567a = _mm_unpacklo_epi16(p45lo, p67lo);
+            const __m128i p4567b = _mm_unpackhi_epi16(p45lo, p67lo);
+            const __m128i p4567c = _mm_unpacklo_epi16(p45hi, p67hi);
+            const __m128i p4567d = _mm_unpackhi_epi16(p45hi, p67hi);
+            _mm_storeu_si128(dst++, _mm_unpacklo_epi32(p0123a, p4567a));
+            _mm_storeu_si128(dst++, _mm_unpackhi_epi32(p0123a, p4567a));
+            _mm_storeu_si128(dst++, _mm_unpacklo_epi32(p0123b, p4567b));
+            _mm_storeu_si128(dst++, _mm_unpackhi_epi32(p0123b, p4567b));
+            _mm_storeu_si128(dst++, _mm_unpacklo_epi32(p0123c, p4567c));
+            _mm_storeu_si128(dst++, _mm_unpackhi_epi32(p0123c, p4567c));
+            _mm_storeu_si128(dst++, _mm_unpacklo_epi32(p0123d, p4567d));
+            _mm_storeu_si128(dst++, _mm_unpackhi_epi32(p0123d, p4567d));
+        }
+    }
+    else
+    {
+        unshuffleScalar(input, shuffle_block_size, output, start_element, num_elements, type_size);
+        return;
+    }
+
+    /* Remaining Elements */
+    const int64_t done = num_vectors * 16;
+    unshuffleScalar(input, shuffle_block_size, &output[done * type_size], start_element + done, num_elements - done, type_size);
+    #else
+    unshuffleScalar(input, shuffle_block_size, output, start_element, num_elements, type_size);
+    #endif
+}
+
+/*----------------------------------------------------------------------------
+ * unshuffleAVX2
+ *
+ *  same interleave as the SSE2 kernel over 32 elements at a time; the avx2
+ *  unpacks operate within each 128 bit lane, so the lanes of each pair of
+ *  results are recombined with a permute before they are stored
+ *----------------------------------------------------------------------------*/
+#ifdef H5FILTER_X86
+__attribute__((target("avx2")))
+static inline void storeLanesAVX2 (__m256i* dst, const __m256i* r, int n)
+{
+    for(int i = 0; i < n; i += 2) _mm256_storeu_si256(dst++, _mm256_permute2x128_si256(r[i], r[i + 1], 0x20));
+    for(int i = 0; i < n; i += 2) _mm256_storeu_si256(dst++, _mm256_permute2x128_si256(r[i], r[i + 1], 0x31));
+}
+
+__attribute__((target("avx2")))
+#endif
+void H5Filter::unshuffleAVX2 (const uint8_t* input, int64_t shuffle_block_size, uint8_t* output, int64_t start_element, int64_t num_elements, int type_size)
+{
+    #ifdef H5FILTER_X86
+    const int64_t num_vectors = num_elements / 32;
+    const uint8_t* src = &input[start_element];
+    __m256i* dst = reinterpret_cast<__m256i*>(output);
+
+    if(type_size == 2)
+    {
+        for(int64_t v = 0; v < num_vectors; v++, src += 32, dst += 2)
+        {
+            const __m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+            const __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + shuffle_block_size));
+            const __m256i r[2] = {_mm256_unpacklo_epi8(p0, p1), _mm256_unpackhi_epi8(p0, p1)};
+            storeLanesAVX2(dst, r, 2);
+        }
+    }
+    else if(type_size == 4)
+    {
+        for(int64_t v = 0; v < num_vectors; v++, src += 32, dst += 4)
+        {
+            const __m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+            const __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + shuffle_block_size));
+            const __m256i p2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + (2 * shuffle_block_size)));
+            const __m256i p3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + (3 * shuffle_block_size)));
+            const __m256i p01lo = _mm256_unpacklo_epi8(p0, p1);
+            const __m256i p01hi = _mm256_unpackhi_epi8(p0, p1);
+            const __m256i p23lo = _mm256_unpacklo_epi8(p2, p3);
+            const __m256i p23hi = _mm256_unpackhi_epi8(p2, p3);
+            const __m256i r[4] = {
+                _mm256_unpacklo_epi16(p01lo, p23lo),
+                _mm256_unpackhi_epi16(p01lo, p23lo),
+                _mm256_unpacklo_epi16(p01hi, p23hi),
+                _mm256_unpackhi_epi16(p01hi, p23hi)
+            };
+            storeLanesAVX2(dst, r, 4);
+        }
+    }
+    else if(type_size == 8)
+    {
+        for(int64_t v = 0; v < num_vectors; v++, src += 32, dst += 8)
+        {
+            __m256i p[8];
+            for(int b = 0; b < 8; b++)
+            {
+                p[b] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + (b * shuffle_block_size)));
+            }
+            const __m256i p01lo = _mm256_unpacklo_epi8(p[0], p[1]);
+            const __m256i p01hi = _mm256_unpackhi_epi8(p[0], p[1]);
+            const __m256i p23lo = _mm256_unpacklo_epi8(p[2], p[3]);
+            const __m256i p23hi = _mm256_unpackhi_epi8(p[2], p[3]);
+            const __m256i p45lo = _mm256_unpacklo_epi8(p[4], p[5]);
+            const __m256i p45hi = _mm256_unpackhi_epi8(p[4], p[5]);
+            const __m256i p67lo = _mm256_unpacklo_epi8(p[6], p[7]);
+            const __m256i p67hi = _mm256_unpackhi_epi8(p[6], p[7]);
+            const __m256i p0123a = _mm256_unpacklo_epi16(p01lo, p23lo);
+            const __m256i p0123b = _mm256_unpackhi_epi16(p01lo, p23lo);
+            const __m256i p0123c = _mm256_unpacklo_epi16(p01hi, p23hi);
+            const __m256i p0123d = _mm256_unpackhi_epi16(p01hi, p23hi);
+            const __m256i p4567a = _mm256_unpacklo_epi16(p45lo, p67lo);
+            const __m256i p4567b = _mm256_unpackhi_epi16(p45lo, p67lo);
+            const __m256i p4567c = _mm256_unpacklo_epi16(p45hi, p67hi);
+            const __m256i p4567d = _mm256_unpackhi_epi16(p45hi, p67hi);
+            const __m256i r[8] = {
+                _mm256_unpacklo_epi32(p0123a, p4567a),
+                _mm256_unpackhi_epi32(p0123a, p4567a),
+                _mm256_unpacklo_epi32(p0123b, p4567b),
+                _mm256_unpackhi_epi32(p0123b, p4567b),
+                _mm256_unpacklo_epi32(p0123c, p4567c),
+                _mm256_unpackhi_epi32(p0123c, p4567c),
+                _mm256_unpacklo_epi32(p0123d, p4567d),
+                _mm256_unpackhi_epi32(p0123d, p4567d)
+            };
+            storeLanesAVX2(dst, r, 8);
+        }
+    }
+    else
+    {
+        unshuffleScalar(input, shuffle_block_size, output, start_element, num_elements, type_size);
+        return;
+    }
+
+    /* Remaining Elements */
+    const int64_t done = num_vectors * 32;
+    unshuffleSSE2(input, shuffle_block_size, &output[done * type_size], start_element + done, num_elements - done, type_size);
+    #else
+    unshuffleScalar(input, shuffle_block_size, output, start_element, num_elements, type_size);
+    #endif
+}
+
+/*----------------------------------------------------------------------------
+ * getConverter
+ *
+ *  returns the kernel that converts elements of datatype into the long or
+ *  double representation requested by valtype, or NULL when the elements
+ *  are already in that representation or cannot be converted
+ *----------------------------------------------------------------------------*/
+H5Filter::convert_func_t H5Filter::getConverter (RecordObject::fieldType_t datatype, RecordObject::valType_t valtype, bool vectorized)
+{
+    if(!needsConversion(datatype, valtype)) return NULL;
+
+    #ifdef H5FILTER_X86
+    if(vectorized && avx2Supported)
+    {
+        if(valtype == RecordObject::INTEGER)
+        {
+            switch(datatype)
+            {
+                case RecordObject::INT8:    return convertAVX2<int8_t, long, widenInt8>;
+                case RecordObject::UINT8:   return convertAVX2<uint8_t, long, widenUInt8>;
+                case RecordObject::INT16:   return convertAVX2<int16_t, long, widenInt16>;
+                case RecordObject::UINT16:  return convertAVX2<uint16_t, long, widenUInt16>;
+                case RecordObject::INT32:   return convertAVX2<int32_t, long, widenInt32>;
+                case RecordObject::UINT32:  return convertAVX2<uint32_t, long, widenUInt32>;
+                default:                    break;
+            }
+        }
+        else if(valtype == RecordObject::REAL)
+        {
+            switch(datatype)
+            {
+                case RecordObject::FLOAT:   return convertAVX2<float, double, widenFloat>;
+                case RecordObject::INT32:   return convertAVX2<int32_t, double, int32ToReal>;
+                default:                    break;
+            }
+        }
+    }
+    #else
+    (void)vectorized;
+    #endif
+
+    if(valtype == RecordObject::INTEGER)
+    {
+        switch(datatype)
+        {
+            case RecordObject::INT8:    return convertScalar<int8_t, long>;
+            case RecordObject::UINT8:   return convertScalar<uint8_t, long>;
+            case RecordObject::INT16:   return convertScalar<int16_t, long>;
+            case RecordObject::UINT16:  return convertScalar<uint16_t, long>;
+            case RecordObject::INT32:   return convertScalar<int32_t, long>;
+            case RecordObject::UINT32:  return convertScalar<uint32_t, long>;
+            case RecordObject::FLOAT:   return convertScalar<float, long>;
+            case RecordObject::DOUBLE:  return convertScalar<double, long>;
+            default:                    return NULL;
+        }
+    }
+    else if(valtype == RecordObject::REAL)
+    {
+        switch(datatype)
+        {
+            case RecordObject::INT8:    return convertScalar<int8_t, double>;
+            case RecordObject::UINT8:   return convertScalar<uint8_t, double>;
+            case RecordObject::INT16:   return convertScalar<int16_t, double>;
+            case RecordObject::UINT16:  return convertScalar<uint16_t, double>;
+            case RecordObject::INT32:   return convertScalar<int32_t, double>;
+            case RecordObject::UINT32:  return convertScalar<uint32_t, double>;
+            case RecordObject::INT64:   return convertScalar<int64_t, double>;
+            case RecordObject::UINT64:  return convertScalar<uint64_t, double>;
+            case RecordObject::FLOAT:   return convertScalar<float, double>;
+            default:                    return NULL;
+        }
+    }
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * needsConversion
+ *
+ *  64 bit integers are already longs and doubles are already reals, so they
+ *  can be returned as read
+ *----------------------------------------------------------------------------*/
+bool H5Filter::needsConversion (RecordObject::fieldType_t datatype, RecordObject::valType_t valtype)
+{
+    if(valtype == RecordObject::INTEGER)
+    {
+        return (datatype != RecordObject::INT64) && (datatype != RecordObject::UINT64);
+    }
+    if(valtype == RecordObject::REAL)
+    {
+        return datatype != RecordObject::DOUBLE;
+    }
+    return false;
+}
+
+/*----------------------------------------------------------------------------
+ * getInflateBackend
+ *----------------------------------------------------------------------------*/
+H5Filter::inflate_backend_t H5Filter::getInflateBackend (void)
+{
+    #ifdef __libdeflate__
+    return LIBDEFLATE_INFLATE;
+    #else
+    return ZLIB_INFLATE;
+    #endif
+}
+
+/*----------------------------------------------------------------------------
+ * getUnshuffleKernel - best kernel supported by the cpu
+ *----------------------------------------------------------------------------*/
+H5Filter::unshuffle_kernel_t H5Filter::getUnshuffleKernel (void)
+{
+    return unshuffleKernel;
+}
+
+/*----------------------------------------------------------------------------
+ * getUnshuffleFunc
+ *----------------------------------------------------------------------------*/
+H5Filter::unshuffle_func_t H5Filter::getUnshuffleFunc (unshuffle_kernel_t kernel)
+{
+    switch(kernel)
+    {
+        case AVX2_UNSHUFFLE:    return unshuffleAVX2;
+        case SSE2_UNSHUFFLE:    return unshuffleSSE2;
+        default:                return unshuffleScalar;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * inflate2str
+ *----------------------------------------------------------------------------*/
+const char* H5Filter::inflate2str (inflate_backend_t backend)
+{
+    switch(backend)
+    {
+        case LIBDEFLATE_INFLATE:    return "libdeflate";
+        default:                    return "zlib";
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * unshuffle2str
+ *----------------------------------------------------------------------------*/
+const char* H5Filter::unshuffle2str (unshuffle_kernel_t kernel)
+{
+    switch(kernel)
+    {
+        case AVX2_UNSHUFFLE:    return "avx2";
+        case SSE2_UNSHUFFLE:    return "sse2";
+        default:                return "scalar";
+    }
+}
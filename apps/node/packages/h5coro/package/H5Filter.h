@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __h5_filter__
+#define __h5_filter__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "RecordObject.h"
+
+/******************************************************************************
+ * H5Filter CLASS
+ *
+ *  Decompression, unshuffle, and type conversion kernels used on every
+ *  chunk; the inflate backend is chosen at build time (libdeflate when
+ *  available, zlib otherwise) and the unshuffle and conversion kernels are
+ *  chosen at runtime from the cpu
+ ******************************************************************************/
+
+class H5Filter
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        typedef enum {
+            ZLIB_INFLATE        = 0,
+            LIBDEFLATE_INFLATE  = 1
+        } inflate_backend_t;
+
+        typedef enum {
+            SCALAR_UNSHUFFLE    = 0,
+            SSE2_UNSHUFFLE      = 1,
+            AVX2_UNSHUFFLE      = 2
+        } unshuffle_kernel_t;
+
+        typedef void (*unshuffle_func_t) (const uint8_t* input, int64_t shuffle_block_size, uint8_t* output, int64_t start_element, int64_t num_elements, int type_size);
+        typedef void (*convert_func_t) (const uint8_t* input, uint8_t* output, int64_t num_elements);
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int CONVERTED_TYPE_SIZE = sizeof(double); // size of the long and double elements produced by the converters
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static void                 init                (void);
+
+        static void                 inflate             (const uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_size);
+        static void                 unshuffle           (const uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_offset, uint32_t output_size, int type_size);
+
+        static void                 inflateZlib         (const uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_size);
+        static bool                 inflateLibdeflate   (const uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_size);
+
+        static void                 unshuffleScalar     (const uint8_t* input, int64_t shuffle_block_size, uint8_t* output, int64_t start_element, int64_t num_elements, int type_size);
+        static void                 unshuffleSSE2       (const uint8_t* input, int64_t shuffle_block_size, uint8_t* output, int64_t start_element, int64_t num_elements, int type_size);
+        static void                 unshuffleAVX2       (const uint8_t* input, int64_t shuffle_block_size, uint8_t* output, int64_t start_element, int64_t num_elements, int type_size);
+
+        static convert_func_t       getConverter        (RecordObject::fieldType_t datatype, RecordObject::valType_t valtype, bool vectorized=true);
+        static bool                 needsConversion     (RecordObject::fieldType_t datatype, RecordObject::valType_t valtype);
+
+        static inflate_backend_t    getInflateBackend   (void);
+        static unshuffle_kernel_t   getUnshuffleKernel  (void);
+        static unshuffle_func_t     getUnshuffleFunc    (unshuffle_kernel_t kernel);
+        static const char*          inflate2str         (inflate_backend_t backend);
+        static const char*          unshuffle2str       (unshuffle_kernel_t kernel);
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        static unshuffle_kernel_t   unshuffleKernel;
+        static unshuffle_func_t     unshuffleFunc;
+        static bool                 avx2Supported;
+};
+
+#endif  /* __h5_filter__ */
@@ -45,6 +45,7 @@ const char* H5Object::OBJECT_TYPE = "H5Object";
 const char* H5Object::LUA_META_NAME = "H5Object";
 const struct luaL_Reg H5Object::LUA_META_TABLE[] = {
     {"size",        luaSize},
+    {"stats",       luaStats},
     {NULL,          NULL}
 };
 
@@ -115,3 +116,32 @@ int H5Object::luaSize(lua_State* L)
     /* Return Results */
     return 1;
 }
+
+/*----------------------------------------------------------------------------
+ luaStats - stats() -> {bytes_read, cache_hit, cache_miss, l1_replace, l2_replace}
+ *----------------------------------------------------------------------------*/
+int H5Object::luaStats(lua_State* L)
+{
+    try
+    {
+        H5Object* h5_obj = dynamic_cast<H5Object*>(LuaObject::getLuaSelf(L, 1));
+        h5_obj->mut.lock();
+        {
+            lua_newtable(L);
+            LuaEngine::setAttrInt(L, "bytes_read",  h5_obj->bytes_read);
+            LuaEngine::setAttrInt(L, "cache_hit",   h5_obj->cache_hit);
+            LuaEngine::setAttrInt(L, "cache_miss",  h5_obj->cache_miss);
+            LuaEngine::setAttrInt(L, "l1_replace",  h5_obj->l1_cache_replace);
+            LuaEngine::setAttrInt(L, "l2_replace",  h5_obj->l2_cache_replace);
+        }
+        h5_obj->mut.unlock();
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error getting H5 object statistics: %s", e.what());
+        lua_pushboolean(L, false);
+    }
+
+    /* Return Results */
+    return 1;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __h5_range_array__
+#define __h5_range_array__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "StringLib.h"
+#include "H5CoroLib.h"
+#include "H5Array.h"
+
+/******************************************************************************
+ * H5RangeArray TEMPLATE
+ *
+ *  Reads only the supplied row ranges of a dataset; the ranges are read
+ *  concurrently and each is left in the buffer it was read into, so rows
+ *  are addressed by their range and their offset within that range
+ ******************************************************************************/
+
+template <class T>
+class H5RangeArray
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+                H5RangeArray    (H5Coro::Context* context, const char* dataset, long col, const vector<H5Coro::range_t>& ranges);
+                ~H5RangeArray   (void);
+
+        bool    join            (int timeout, bool throw_exception);
+        T&      operator()      (long range, long offset) const;
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        const char*         name;
+        long                size;   // total number of rows in all ranges
+        vector<T*>          data;   // rows of each range, populated on join
+
+    private:
+
+        vector<H5Array<T>*> arrays;
+};
+
+/******************************************************************************
+ * H5RangeArray METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+template <class T>
+H5RangeArray<T>::H5RangeArray(H5Coro::Context* context, const char* dataset, long col, const vector<H5Coro::range_t>& ranges):
+    name(NULL),
+    size(0)
+{
+    try
+    {
+        arrays.reserve(ranges.size());
+        for(const H5Coro::range_t& range: ranges)
+        {
+            arrays.push_back(new H5Array<T>(context, dataset, col, range.r0, range.r1 - range.r0));
+        }
+    }
+    catch(const RunTimeException&)
+    {
+        for(H5Array<T>* array: arrays) delete array;
+        throw;
+    }
+
+    name = StringLib::duplicate(dataset);
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor
+ *----------------------------------------------------------------------------*/
+template <class T>
+H5RangeArray<T>::~H5RangeArray(void)
+{
+    for(H5Array<T>* array: arrays) delete array;
+    delete [] name;
+}
+
+/*----------------------------------------------------------------------------
+ * join
+ *----------------------------------------------------------------------------*/
+template <class T>
+bool H5RangeArray<T>::join(int timeout, bool throw_exception)
+{
+    /* Wait for All Ranges */
+    for(H5Array<T>* array: arrays)
+    {
+        if(!array->join(timeout, throw_exception)) return false;
+    }
+
+    /* Point to Rows of Each Range */
+    data.clear();
+    data.reserve(arrays.size());
+    size = 0;
+    for(H5Array<T>* array: arrays)
+    {
+        data.push_back(array->pointer);
+        size += array->size;
+    }
+
+    return true;
+}
+
+/*----------------------------------------------------------------------------
+ * ()
+ *
+ *  Note: intentionally left unsafe for performance reasons
+ *----------------------------------------------------------------------------*/
+template <class T>
+T& H5RangeArray<T>::operator()(long range, long offset) const
+{
+    return data[range][offset];
+}
+
+#endif  /* __h5_range_array__ */
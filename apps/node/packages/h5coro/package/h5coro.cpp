@@ -43,8 +43,13 @@
 #include "H5File.h"
 #include "H5DataFrame.h"
 #include "H5DatasetDevice.h"
+#include "H5Filter.h"
 #include "H5Object.h"
 
+#ifdef __unittesting__
+#include "UT_H5Filter.h"
+#endif
+
 /******************************************************************************
  * DEFINES
  ******************************************************************************/
@@ -192,6 +197,9 @@ int h5_open (lua_State *L)
         {"object",      H5Object::luaCreate},
         {"parms",       luaCreateParameters<H5Parameters>},
         {"read",        h5_read},
+#ifdef __unittesting__
+        {"ut_filter",   UT_H5Filter::luaCreate},
+#endif
         {NULL,          NULL}
     };
 
@@ -217,6 +225,7 @@ void inith5coro (void)
 {
     /* Initialize Modules */
     H5Coro::init(H5CORO_THREAD_POOL_SIZE);
+    H5Filter::init();
     H5DatasetDevice::init();
     H5File::init();
 
@@ -0,0 +1,20 @@
+local runner = require("test_executive")
+
+-- Requirements --
+
+if not core.UNITTEST then
+    return runner.skip()
+end
+
+-- Self Test --
+
+runner.unittest("H5Coro Filter Unit Test", function()
+    local ut = h5coro.ut_filter()
+    runner.assert(ut:unshuffle())
+    runner.assert(ut:inflate())
+    runner.assert(ut:convert())
+end)
+
+-- Report Results --
+
+runner.report()
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "UT_H5Filter.h"
+#include "UnitTest.h"
+#include "OsApi.h"
+#include "EventLib.h"
+#include "H5Filter.h"
+
+#include <zlib.h>
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* UT_H5Filter::LUA_META_NAME = "UT_H5Filter";
+const struct luaL_Reg UT_H5Filter::LUA_META_TABLE[] = {
+    {"unshuffle",   luaUnshuffleTest},
+    {"inflate",     luaInflateTest},
+    {"convert",     luaConvertTest},
+    {NULL,          NULL}
+};
+
+/******************************************************************************
+ * METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * luaCreate -
+ *----------------------------------------------------------------------------*/
+int UT_H5Filter::luaCreate (lua_State* L)
+{
+    try
+    {
+        /* Create Unit Test */
+        return createLuaObject(L, new UT_H5Filter(L));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error creating %s: %s", LUA_META_NAME, e.what());
+        return returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+UT_H5Filter::UT_H5Filter (lua_State* L):
+    UnitTest(L, LUA_META_NAME, LUA_META_TABLE)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * luaUnshuffleTest - :unshuffle()
+ *
+ *  every kernel supported by the cpu must match the scalar kernel for whole
+ *  chunks and for partial reads that start and end mid vector
+ *----------------------------------------------------------------------------*/
+int UT_H5Filter::luaUnshuffleTest (lua_State* L)
+{
+    UT_H5Filter* lua_obj = NULL;
+    try
+    {
+        lua_obj = dynamic_cast<UT_H5Filter*>(getLuaSelf(L, 1));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(CRITICAL, "Failed to get lua parameters: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    ut_initialize(lua_obj);
+
+    vector<chunk_t> chunks;
+    buildChunks(chunks);
+
+    const int64_t ranges[][2] = {{0, CHUNK_ELEMENTS}, {1, 31}, {7, 100}, {33, 4097}, {CHUNK_ELEMENTS - 45, 45}};
+
+    for(const chunk_t& chunk: chunks)
+    {
+        vector<uint8_t> output(chunk.raw.size());
+        for(int k = H5Filter::SCALAR_UNSHUFFLE; k <= H5Filter::getUnshuffleKernel(); k++)
+        {
+            const H5Filter::unshuffle_kernel_t kernel = static_cast<H5Filter::unshuffle_kernel_t>(k);
+            const H5Filter::unshuffle_func_t func = H5Filter::getUnshuffleFunc(kernel);
+            for(const int64_t* range: ranges)
+            {
+                const int64_t start = range[0];
+                const int64_t count = range[1];
+                func(chunk.shuffled.data(), CHUNK_ELEMENTS, output.data(), start, count, chunk.typesize);
+                const bool match = memcmp(output.data(), &chunk.raw[start * chunk.typesize], count * chunk.typesize) == 0;
+                ut_assert(lua_obj, match, "%s unshuffle of %s failed for %ld elements at %ld", H5Filter::unshuffle2str(kernel), chunk.name, (long)count, (long)start);
+            }
+        }
+
+        /* Dispatching Entry Point */
+        H5Filter::unshuffle(chunk.shuffled.data(), chunk.shuffled.size(), output.data(), 0, chunk.raw.size(), chunk.typesize);
+        ut_assert(lua_obj, memcmp(output.data(), chunk.raw.data(), chunk.raw.size()) == 0, "unshuffle of %s failed", chunk.name);
+    }
+
+    lua_pushboolean(L, ut_status(lua_obj));
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaInflateTest - :inflate()
+ *
+ *  the selected backend must produce the same output as zlib and fall back
+ *  to zlib's error handling for a corrupt stream
+ *----------------------------------------------------------------------------*/
+int UT_H5Filter::luaInflateTest (lua_State* L)
+{
+    UT_H5Filter* lua_obj = NULL;
+    try
+    {
+        lua_obj = dynamic_cast<UT_H5Filter*>(getLuaSelf(L, 1));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(CRITICAL, "Failed to get lua parameters: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    ut_initialize(lua_obj);
+
+    vector<chunk_t> chunks;
+    buildChunks(chunks);
+
+    for(const chunk_t& chunk: chunks)
+    {
+        vector<uint8_t> zlib_output(chunk.shuffled.size());
+        vector<uint8_t> output(chunk.shuffled.size());
+        try
+        {
+            H5Filter::inflateZlib(chunk.deflated.data(), chunk.deflated.size(), zlib_output.data(), zlib_output.size());
+            H5Filter::inflate(chunk.deflated.data(), chunk.deflated.size(), output.data(), output.size());
+            ut_assert(lua_obj, zlib_output == chunk.shuffled, "zlib inflate of %s failed", chunk.name);
+            ut_assert(lua_obj, output == chunk.shuffled, "%s inflate of %s failed", H5Filter::inflate2str(H5Filter::getInflateBackend()), chunk.name);
+        }
+        catch(const RunTimeException& e)
+        {
+            ut_assert(lua_obj, false, "failed to inflate %s: %s", chunk.name, e.what());
+        }
+
+        /* Corrupt Stream */
+        vector<uint8_t> corrupt(chunk.deflated.begin(), chunk.deflated.begin() + (chunk.deflated.size() / 2));
+        bool caught = false;
+        try
+        {
+            H5Filter::inflate(corrupt.data(), corrupt.size(), output.data(), output.size());
+        }
+        catch(const RunTimeException&)
+        {
+            caught = true;
+        }
+        ut_assert(lua_obj, caught, "truncated stream for %s did not fail to inflate", chunk.name);
+    }
+
+    lua_pushboolean(L, ut_status(lua_obj));
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaConvertTest - :convert()
+ *
+ *  the vectorized converters must match the scalar converters, including
+ *  for element counts that leave a partial vector
+ *----------------------------------------------------------------------------*/
+int UT_H5Filter::luaConvertTest (lua_State* L)
+{
+    UT_H5Filter* lua_obj = NULL;
+    try
+    {
+        lua_obj = dynamic_cast<UT_H5Filter*>(getLuaSelf(L, 1));
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(CRITICAL, "Failed to get lua parameters: %s", e.what());
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    ut_initialize(lua_obj);
+
+    vector<chunk_t> chunks;
+    buildChunks(chunks);
+
+    const RecordObject::fieldType_t datatypes[] = {RecordObject::DOUBLE, RecordObject::DOUBLE, RecordObject::FLOAT, RecordObject::UINT32, RecordObject::INT16, RecordObject::INT8};
+    const RecordObject::valType_t valtypes[] = {RecordObject::INTEGER, RecordObject::REAL};
+    const int64_t counts[] = {CHUNK_ELEMENTS, CHUNK_ELEMENTS - 1, 7, 1};
+
+    for(size_t c = 0; c < chunks.size(); c++)
+    {
+        const chunk_t& chunk = chunks[c];
+        for(const RecordObject::valType_t valtype: valtypes)
+        {
+            const H5Filter::convert_func_t scalar = H5Filter::getConverter(datatypes[c], valtype, false);
+            const H5Filter::convert_func_t vectorized = H5Filter::getConverter(datatypes[c], valtype, true);
+            if(!H5Filter::needsConversion(datatypes[c], valtype))
+            {
+                ut_assert(lua_obj, scalar == NULL && vectorized == NULL, "unexpected converter for %s", chunk.name);
+                continue;
+            }
+
+            ut_assert(lua_obj, scalar != NULL && vectorized != NULL, "missing converter for %s", chunk.name);
+            if(scalar == NULL || vectorized == NULL) continue;
+
+            vector<uint8_t> expected(CHUNK_ELEMENTS * H5Filter::CONVERTED_TYPE_SIZE);
+            vector<uint8_t> output(CHUNK_ELEMENTS * H5Filter::CONVERTED_TYPE_SIZE);
+            for(const int64_t count: counts)
+            {
+                scalar(chunk.raw.data(), expected.data(), count);
+                vectorized(chunk.raw.data(), output.data(), count);
+                const bool match = memcmp(expected.data(), output.data(), count * H5Filter::CONVERTED_TYPE_SIZE) == 0;
+                ut_assert(lua_obj, match, "conversion of %ld elements of %s failed", (long)count, chunk.name);
+            }
+        }
+    }
+
+    lua_pushboolean(L, ut_status(lua_obj));
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * buildChunks
+ *
+ *  synthesizes chunks with the element types and value progressions of the
+ *  ATL03 photon variables so that they compress like the real granules
+ *----------------------------------------------------------------------------*/
+void UT_H5Filter::buildChunks (vector<chunk_t>& chunks)
+{
+    chunks.resize(6);
+    chunks[0].name = "delta_time";      chunks[0].typesize = sizeof(double);
+    chunks[1].name = "lat_ph";          chunks[1].typesize = sizeof(double);
+    chunks[2].name = "h_ph";            chunks[2].typesize = sizeof(float);
+    chunks[3].name = "pce_mframe_cnt";  chunks[3].typesize = sizeof(uint32_t);
+    chunks[4].name = "bckgrd_counts";   chunks[4].typesize = sizeof(int16_t);
+    chunks[5].name = "signal_conf_ph";  chunks[5].typesize = sizeof(int8_t);
+
+    uint32_t seed = 0x5EED;
+    auto next = [&seed]() -> uint32_t { seed = (seed * 1103515245U) + 12345U; return (seed >> 16) & 0x7FFF; };
+
+    for(chunk_t& chunk: chunks)
+    {
+        chunk.raw.resize(CHUNK_ELEMENTS * chunk.typesize);
+    }
+
+    double* delta_time = reinterpret_cast<double*>(chunks[0].raw.data());
+    double* lat_ph = reinterpret_cast<double*>(chunks[1].raw.data());
+    float* h_ph = reinterpret_cast<float*>(chunks[2].raw.data());
+    uint32_t* pce_mframe_cnt = reinterpret_cast<uint32_t*>(chunks[3].raw.data());
+    int16_t* bckgrd_counts = reinterpret_cast<int16_t*>(chunks[4].raw.data());
+    int8_t* signal_conf_ph = reinterpret_cast<int8_t*>(chunks[5].raw.data());
+
+    double t = 46656000.0;
+    double lat = -70.0;
+    for(int i = 0; i < CHUNK_ELEMENTS; i++)
+    {
+        if(next() % 4 == 0) t += 0.0001; // 10kHz pulses with multiple photons per pulse
+        lat += 0.0000001 * (next() % 8);
+        delta_time[i] = t;
+        lat_ph[i] = lat;
+        h_ph[i] = 1500.0F + (static_cast<float>(i) * 0.01F) + (static_cast<float>(next() % 1000) / 100.0F);
+        pce_mframe_cnt[i] = 1000000 + (i / 200);
+        bckgrd_counts[i] = static_cast<int16_t>(next() % 64);
+        signal_conf_ph[i] = static_cast<int8_t>(next() % 5);
+    }
+
+    for(chunk_t& chunk: chunks)
+    {
+        chunk.shuffled.resize(chunk.raw.size());
+        shuffleChunk(chunk.raw.data(), chunk.shuffled.data(), CHUNK_ELEMENTS, chunk.typesize);
+
+        uLongf deflated_size = compressBound(chunk.shuffled.size());
+        chunk.deflated.resize(deflated_size);
+        compress2(chunk.deflated.data(), &deflated_size, chunk.shuffled.data(), chunk.shuffled.size(), 6);
+        chunk.deflated.resize(deflated_size);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * shuffleChunk - inverse of the hdf5 shuffle filter
+ *----------------------------------------------------------------------------*/
+void UT_H5Filter::shuffleChunk (const uint8_t* input, uint8_t* output, int64_t num_elements, int type_size)
+{
+    for(int64_t element_index = 0; element_index < num_elements; element_index++)
+    {
+        for(int64_t val_index = 0; val_index < type_size; val_index++)
+        {
+            output[(val_index * num_elements) + element_index] = input[(element_index * type_size) + val_index];
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ut_h5filter__
+#define __ut_h5filter__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "UnitTest.h"
+#include "OsApi.h"
+
+/******************************************************************************
+ * CLASS
+ ******************************************************************************/
+
+class UT_H5Filter: public UnitTest
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const char* LUA_META_NAME;
+        static const struct luaL_Reg LUA_META_TABLE[];
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static int  luaCreate   (lua_State* L);
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Typedefs
+         *--------------------------------------------------------------------*/
+
+        typedef struct {
+            const char*     name;       // ATL03 variable the chunk is shaped after
+            int             typesize;   // size of each element in bytes
+            vector<uint8_t> raw;        // unfiltered chunk
+            vector<uint8_t> shuffled;   // shuffled chunk, input to unshuffle
+            vector<uint8_t> deflated;   // shuffled and deflated chunk, input to inflate
+        } chunk_t;
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int CHUNK_ELEMENTS = 10000; // ATL03 photon variables are chunked at 10000 elements
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        explicit UT_H5Filter (lua_State* L);
+        ~UT_H5Filter (void) override = default;
+
+        static int  luaUnshuffleTest    (lua_State* L);
+        static int  luaInflateTest      (lua_State* L);
+        static int  luaConvertTest      (lua_State* L);
+
+        static void buildChunks         (vector<chunk_t>& chunks);
+        static void shuffleChunk        (const uint8_t* input, uint8_t* output, int64_t num_elements, int type_size);
+};
+
+#endif  /* __ut_h5filter__ */
@@ -59,6 +59,23 @@ DispatchObject::DispatchObject (lua_State* L, const char* meta_name, const struc
 {
 }
 
+/*----------------------------------------------------------------------------
+ * processRecordBatch
+ *
+ *  called by a batched dispatcher with consecutive records of the same type;
+ *  dispatches that can amortize work across records (locks, lookups, posts)
+ *  override this, everything else processes the records one at a time
+ *----------------------------------------------------------------------------*/
+bool DispatchObject::processRecordBatch (RecordObject** records, const okey_t* keys, int num_records)
+{
+    bool status = true;
+    for(int i = 0; i < num_records; i++)
+    {
+        status = processRecord(records[i], keys[i], NULL) && status;
+    }
+    return status;
+}
+
 /*----------------------------------------------------------------------------
  * processTimeout
  *----------------------------------------------------------------------------*/
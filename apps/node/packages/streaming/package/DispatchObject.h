@@ -67,6 +67,7 @@ class DispatchObject: public LuaObject
         virtual         ~DispatchObject     (void) = 0;           // NOLINT(hicpp-use-override, cppcoreguidelines-explicit-virtual-functions)
 
         virtual bool    processRecord      (RecordObject* record, okey_t key, recVec_t* records) = 0;
+        virtual bool    processRecordBatch (RecordObject** records, const okey_t* keys, int num_records);
         virtual bool    processTimeout     (void);
         virtual bool    processTermination (void);
 
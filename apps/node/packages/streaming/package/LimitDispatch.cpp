@@ -94,6 +94,7 @@ LimitDispatch::LimitDispatch (lua_State* L, const LimitRecord::limit_t& _limit,
     LimitRecord::defineRecord(LimitRecord::rec_type, "TYPE", sizeof(LimitRecord::limit_t), LimitRecord::rec_def, LimitRecord::rec_elem);
 
     limit = _limit;
+    fieldPath = new RecordObject::FieldPath(limit.field_name);
     logLevel = ERROR;
     inError = false;
     gmtDisplay = false;
@@ -118,6 +119,7 @@ LimitDispatch::~LimitDispatch(void)
 {
     delete limitQ;
     delete deepQ;
+    delete fieldPath;
 }
 
 /*----------------------------------------------------------------------------
@@ -141,11 +143,11 @@ bool LimitDispatch::processRecord (RecordObject* record, okey_t key, recVec_t* r
     /* Limit Check */
     if(enabled)
     {
-        const RecordObject::field_t field = record->getField(limit.field_name);
-        if(field.type != RecordObject::INVALID_FIELD)
+        const RecordObject::Accessor& field = fieldPath->resolve(record);
+        if(field.isValid())
         {
             inError = false;
-            const double val = record->getValueReal(field);
+            const double val = field.getReal(record);
             if( ((limit.limit_min) && (limit.d_min > val)) ||
                 ((limit.limit_max) && (limit.d_max < val)) )
             {
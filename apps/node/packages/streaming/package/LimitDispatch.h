@@ -71,6 +71,7 @@ class LimitDispatch: public DispatchObject
          *--------------------------------------------------------------------*/
 
         LimitRecord::limit_t    limit;
+        RecordObject::FieldPath* fieldPath;     // compiled limit.field_name
         event_level_t           logLevel;
         bool                    inError;
         Publisher*              limitQ;
@@ -99,7 +99,8 @@ int MetricDispatch::luaCreate (lua_State* L)
  * Constructor
  *----------------------------------------------------------------------------*/
 MetricDispatch::MetricDispatch(lua_State* L, const char* _data_field, const char* outq_name, List<long>* _id_filter):
-    DispatchObject(L, LUA_META_NAME, LUA_META_TABLE)
+    DispatchObject(L, LUA_META_NAME, LUA_META_TABLE),
+    dataField(_data_field)
 {
     /* Define Metric Record */
     RecordObject::defineRecord(MetricRecord::rec_type, NULL, sizeof(MetricRecord::telemetry_t), MetricRecord::rec_def, MetricRecord::rec_elem);
@@ -113,7 +114,6 @@ MetricDispatch::MetricDispatch(lua_State* L, const char* _data_field, const char
     maxKey          = INVALID_KEY;
 
     /* Initialize Key Count/Offset/Min/Max */
-    dataField           = StringLib::duplicate(_data_field);
     idFilter            = _id_filter;
     fieldFilter         = NULL;
     outQ                = new Publisher(outq_name);
@@ -124,7 +124,6 @@ MetricDispatch::MetricDispatch(lua_State* L, const char* _data_field, const char
  *----------------------------------------------------------------------------*/
 MetricDispatch::~MetricDispatch(void)
 {
-    delete [] dataField;
     delete idFilter;
     delete fieldFilter;
     delete outQ;
@@ -190,17 +189,17 @@ bool MetricDispatch::processRecord (RecordObject* record, okey_t key, recVec_t*
                     const char* field_name = fieldFilter->first(&filter_value);
                     while(enabled && field_name)
                     {
-                        const RecordObject::field_t field = record->getField(field_name);
-                        const RecordObject::valType_t field_type = RecordObject::getValueType(field);
-                        if((field_type == RecordObject::INTEGER) && (filter_value->lvalue != record->getValueInteger(field)))
+                        const RecordObject::Accessor& field = filter_value->path.resolve(record);
+                        const RecordObject::valType_t field_type = RecordObject::getValueType(field.getField());
+                        if((field_type == RecordObject::INTEGER) && (filter_value->lvalue != field.getInteger(record)))
                         {
                             enabled = filter_value->enable;
                         }
-                        else if((field_type == RecordObject::REAL) && (filter_value->dvalue != record->getValueReal(field)))
+                        else if((field_type == RecordObject::REAL) && (filter_value->dvalue != field.getReal(record)))
                         {
                             enabled = filter_value->enable;
                         }
-                        else if((field_type == RecordObject::TEXT) && StringLib::match(filter_value->svalue, record->getValueText(field)))
+                        else if((field_type == RecordObject::TEXT) && StringLib::match(filter_value->svalue, record->getValueText(field.getField())))
                         {
                             enabled = filter_value->enable;
                         }
@@ -218,8 +217,8 @@ bool MetricDispatch::processRecord (RecordObject* record, okey_t key, recVec_t*
             if(enabled)
             {
                 /* Generate Data Point */
-                const RecordObject::field_t data_field = record->getField(dataField);
-                if(data_field.type != RecordObject::INVALID_FIELD)
+                const RecordObject::Accessor& data_field = dataField.resolve(record);
+                if(data_field.isValid())
                 {
                     /* Playback Source */
                     int size = 0;
@@ -229,17 +228,17 @@ bool MetricDispatch::processRecord (RecordObject* record, okey_t key, recVec_t*
                     /* Playback Text */
                     char valbuf[RecordObject::MAX_VAL_STR_SIZE];
                     char* text = &valbuf[0];
-                    if(playbackText) record->getValueText(data_field, valbuf);
+                    if(playbackText) record->getValueText(data_field.getField(), valbuf);
                     else text = NULL;
 
                     /* Playback Name */
                     char namebuf[MAX_STR_SIZE];
                     char* name = &namebuf[0];
-                    if(playbackName) StringLib::format(namebuf, MAX_STR_SIZE, "%s.%s", record->getRecordType(), dataField);
+                    if(playbackName) StringLib::format(namebuf, MAX_STR_SIZE, "%s.%s", record->getRecordType(), dataField.getName());
                     else name = NULL;
 
                     /* Playback Value */
-                    const double value = record->getValueReal(data_field);
+                    const double value = data_field.getReal(record);
 
                     /* Index Data Point*/
                     MetricRecord metric(key, value, text, name, src, size);
@@ -258,7 +257,7 @@ bool MetricDispatch::processRecord (RecordObject* record, okey_t key, recVec_t*
                 }
                 else
                 {
-                    mlog(WARNING, "Unable to index into record %s with field %s", record->getRecordType(), dataField);
+                    mlog(WARNING, "Unable to index into record %s with field %s", record->getRecordType(), dataField.getName());
                 }
             }
         }
@@ -479,7 +478,7 @@ int MetricDispatch::luaAddFilter(lua_State* L)
             }
 
             /* Add Field Filter */
-            fieldValue_t* value = new fieldValue_t(enable, field_val_l, field_val_d, field_val_s);
+            fieldValue_t* value = new fieldValue_t(field_name, enable, field_val_l, field_val_d, field_val_s);
 
             /* Add to Dictionary */
             status = lua_obj->fieldFilter->add(field_name, value);
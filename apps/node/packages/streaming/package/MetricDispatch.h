@@ -81,12 +81,14 @@ class MetricDispatch: public DispatchObject
 
         struct fieldValue_t
         {
+            RecordObject::FieldPath path;
             bool            enable;
             long            lvalue;
             double          dvalue;
             const char*     svalue;
 
-            fieldValue_t(bool _enable, long _lvalue, double _dvalue, const char* _svalue)
+            fieldValue_t(const char* _field_name, bool _enable, long _lvalue, double _dvalue, const char* _svalue):
+                path(_field_name)
             {
                 enable = _enable;
                 lvalue = _lvalue;
@@ -104,7 +106,7 @@ class MetricDispatch: public DispatchObject
          * Data
          *--------------------------------------------------------------------*/
 
-        const char*                 dataField;      // value of metric
+        RecordObject::FieldPath     dataField;      // value of metric
         List<long>*                 idFilter;       // id of record, not data or key
         Dictionary<fieldValue_t*>*  fieldFilter;    // more computationally intensive filter, matches field to value
         Publisher*                  outQ;           // output queue metrics are posted to
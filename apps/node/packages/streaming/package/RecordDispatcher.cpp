@@ -33,6 +33,8 @@
  * INCLUDES
  ******************************************************************************/
 
+#include <new>
+
 #include "RecordDispatcher.h"
 #include "OsApi.h"
 #include "ContainerRecord.h"
@@ -50,6 +52,7 @@ const struct luaL_Reg RecordDispatcher::LUA_META_TABLE[] = {
     {"clear",       luaClearError},
     {"drain",       luaDrain},
     {"aot",         luaAbortOnTimeout},
+    {"batch",       luaBatch},
     {NULL,          NULL}
 };
 
@@ -159,11 +162,12 @@ RecordDispatcher::RecordDispatcher( lua_State* L, const char* inputq_name,
     /* Initialize Attributes */
     keyMode         = key_mode;
     keyRecCnt       = 0;
-    keyField        = StringLib::duplicate(key_field);
+    keyField        = key_field ? new RecordObject::FieldPath(key_field) : NULL;
     keyFunc         = key_func;
     numThreads      = num_threads;
     threadsComplete = 0;
     recError        = false;
+    batchSize       = 1;
 
     /* Create Subscriber */
     inQ = new Subscriber(inputq_name, type);
@@ -189,7 +193,7 @@ RecordDispatcher::~RecordDispatcher(void)
 
     delete inQ;
 
-    delete [] keyField;
+    delete keyField;
 
     dispatch_t dispatch;
     const char* key = dispatchTable.first(&dispatch);
@@ -212,6 +216,18 @@ RecordObject* RecordDispatcher::createRecord (unsigned char* buffer, int size)
     return new RecordInterface(buffer, size);
 }
 
+/*----------------------------------------------------------------------------
+ * createRecordView
+ *
+ *  constructs the record in caller provided storage; the caller destroys it
+ *  in place, so subclasses overriding createRecord must override this too
+ *----------------------------------------------------------------------------*/
+RecordObject* RecordDispatcher::createRecordView (unsigned char* buffer, int size, view_t* view)
+{
+    static_assert(sizeof(RecordInterface) <= VIEW_SIZE);
+    return new (view->mem) RecordInterface(buffer, size);
+}
+
 /*----------------------------------------------------------------------------
  * luaRun - :run()
  *----------------------------------------------------------------------------*/
@@ -228,7 +244,7 @@ int RecordDispatcher::luaRun(lua_State* L)
         lua_obj->dispatcherActive.store(true, std::memory_order_release);
         for(int i = 0; i < lua_obj->numThreads; i++)
         {
-            lua_obj->threadPool[i] = new Thread(dispatcherThread, lua_obj);
+            lua_obj->threadPool[i] = new Thread(lua_obj->batchSize > 1 ? batchThread : dispatcherThread, lua_obj);
         }
 
         /* Set Success */
@@ -419,6 +435,48 @@ int RecordDispatcher::luaAbortOnTimeout (lua_State* L)
     return returnLuaStatus(L, status);
 }
 
+/*----------------------------------------------------------------------------
+ * luaBatch - :batch(<max messages per wakeup>)
+ *----------------------------------------------------------------------------*/
+int RecordDispatcher::luaBatch (lua_State* L)
+{
+    bool status = false;
+
+    try
+    {
+        /* Get Self */
+        RecordDispatcher* lua_obj = dynamic_cast<RecordDispatcher*>(getLuaSelf(L, 1));
+
+        /* Get Parameters */
+        const long batch_size = getLuaInteger(L, 2);
+
+        /* Check if Active */
+        if(lua_obj->dispatcherActive.load(std::memory_order_acquire))
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "Cannot change batch size of a running dispatcher");
+        }
+
+        /* Check Batch Size */
+        if(batch_size < 1 || batch_size > MAX_BATCH_SIZE)
+        {
+            throw RunTimeException(CRITICAL, RTE_FAILURE, "Invalid batch size: %ld (must be between 1 and %d)", batch_size, MAX_BATCH_SIZE);
+        }
+
+        /* Set Batch Size */
+        lua_obj->batchSize = static_cast<int>(batch_size);
+
+        /* Set Success */
+        status = true;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error setting batch size: %s", e.what());
+    }
+
+    /* Return Status */
+    return returnLuaStatus(L, status);
+}
+
 /******************************************************************************
  * PRIVATE METHODS
  ******************************************************************************/
@@ -453,24 +511,7 @@ void* RecordDispatcher::dispatcherThread(void* parm)
                 }
                 catch (const RunTimeException& e)
                 {
-                    if(!dispatcher->recError)
-                    {
-                        const int num_newlines = len / 16 + 3;
-                        char* msg_str = new char[len * 2 + num_newlines + 1];
-                        mlog(e.level(), "%s unable to create record from message: %s", dispatcher->ObjectType, e.what());
-                        int msg_index = 0;
-                        for(int i = 0; i < len; i++)
-                        {
-                            sprintf(&msg_str[msg_index], "%02X", msg[i]);
-                            msg_index += 2;
-                            if(i % 16 == 15) msg_str[msg_index++] = '\n';
-                        }
-                        msg_str[msg_index++] = '\n';
-                        msg_str[msg_index++] = '\0';
-                        mlog(DEBUG, "%s", msg_str);
-                        delete [] msg_str;
-                    }
-                    dispatcher->recError = true;
+                    dispatcher->logRecordError(e, msg, len);
                 }
             }
             else
@@ -486,19 +527,7 @@ void* RecordDispatcher::dispatcherThread(void* parm)
         else if(recv_status == MsgQ::STATE_TIMEOUT)
         {
             /* Signal Timeout to Dispatches */
-            const int num_dispatches = dispatcher->dispatchList.size();
-            for(int d = 0; d < num_dispatches; d++)
-            {
-                DispatchObject* dis = dispatcher->dispatchList[d];
-                dis->processTimeout();
-            }
-
-            /* Check if Aborting on Timeout */
-            if(dispatcher->abortOnTimeout.load(std::memory_order_acquire))
-            {
-                dispatcher->dispatcherActive.store(false, std::memory_order_release);
-                break;
-            }
+            if(dispatcher->handleTimeout()) break;
         }
         else
         {
@@ -509,31 +538,101 @@ void* RecordDispatcher::dispatcherThread(void* parm)
     }
 
     /* Handle Termination */
-    dispatcher->threadMut.lock();
+    dispatcher->completeThread();
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * batchThread
+ *
+ *  drains up to batchSize messages per wakeup and constructs the records in
+ *  place instead of on the heap; consecutive records of the same type are
+ *  handed to each dispatch together
+ *----------------------------------------------------------------------------*/
+void* RecordDispatcher::batchThread(void* parm)
+{
+    RecordDispatcher* dispatcher = static_cast<RecordDispatcher*>(parm);
+    const int batch_size = dispatcher->batchSize;
+
+    Subscriber::msgRef_t* refs = new Subscriber::msgRef_t[batch_size];
+    view_t* views = new view_t[batch_size];
+    RecordObject** records = new RecordObject* [batch_size];
+
+    /* Loop Forever */
+    while(dispatcher->dispatcherActive.load(std::memory_order_acquire))
     {
-        dispatcher->threadsComplete++;
-        if(dispatcher->threadsComplete == dispatcher->numThreads)
+        /* Wait for First Message */
+        const int recv_status = dispatcher->inQ->receiveRef(refs[0], SYS_TIMEOUT);
+        if(recv_status > 0)
         {
-            /* Process Termination for each Dispatch */
-            dispatch_t dispatch;
-            const char* key = dispatcher->dispatchTable.first(&dispatch);
-            while(key != NULL)
+            /* Drain Whatever Else is Queued */
+            int num_refs = 1;
+            while(num_refs < batch_size && refs[num_refs - 1].size > 0)
             {
-                for(int d = 0; d < dispatch.size; d++)
+                if(dispatcher->inQ->receiveRef(refs[num_refs], IO_CHECK) <= 0) break;
+                num_refs++;
+            }
+
+            /* Construct Records */
+            int num_records = 0;
+            for(int r = 0; r < num_refs; r++)
+            {
+                unsigned char* msg = reinterpret_cast<unsigned char*>(refs[r].data);
+                const int len = refs[r].size;
+                if(len > 0)
                 {
-                    if(!dispatch.list[d]->processTermination())
+                    try
                     {
-                        mlog(ERROR, "Failed to process termination on %s for %s", key, dispatch.list[d]->getName());
+                        records[num_records] = dispatcher->createRecordView(msg, len, &views[num_records]);
+                        num_records++;
+                    }
+                    catch (const RunTimeException& e)
+                    {
+                        dispatcher->logRecordError(e, msg, len);
                     }
                 }
-                key = dispatcher->dispatchTable.next(&dispatch);
+                else
+                {
+                    /* Terminating Message (always last in batch) */
+                    mlog(DEBUG, "Terminator received on %s, exiting dispatcher", dispatcher->inQ->getName());
+                    dispatcher->dispatcherActive.store(false, std::memory_order_release); // breaks out of loop
+                }
             }
 
-            /* Signal Completion */
-            dispatcher->signalComplete();
+            /* Dispatch Records */
+            dispatcher->dispatchBatch(records, num_records);
+
+            /* Destroy Records and Dereference Messages */
+            for(int r = 0; r < num_records; r++)
+            {
+                records[r]->~RecordObject();
+            }
+            for(int r = 0; r < num_refs; r++)
+            {
+                dispatcher->inQ->dereference(refs[r]);
+            }
+        }
+        else if(recv_status == MsgQ::STATE_TIMEOUT)
+        {
+            /* Signal Timeout to Dispatches */
+            if(dispatcher->handleTimeout()) break;
+        }
+        else
+        {
+            /* Break Out on Failure */
+            mlog(CRITICAL, "Failed queue receive on %s with error %d", dispatcher->inQ->getName(), recv_status);
+            dispatcher->dispatcherActive.store(false, std::memory_order_release); // breaks out of loop
         }
     }
-    dispatcher->threadMut.unlock();
+
+    /* Clean Up */
+    delete [] refs;
+    delete [] views;
+    delete [] records;
+
+    /* Handle Termination */
+    dispatcher->completeThread();
 
     return NULL;
 }
@@ -574,33 +673,202 @@ void RecordDispatcher::dispatchRecord (RecordObject* record, DispatchObject::rec
         const dispatch_t& dis = dispatchTable[rec_type];
 
         /* Get Key */
-        okey_t key = 0;
-        if(keyMode == FIELD_KEY_MODE)
+        const okey_t key = getKey(record);
+
+        /* Process Record */
+        for (int i = 0; i < dis.size; i++)
         {
-            const RecordObject::field_t key_field = record->getField(keyField);
-            key = (okey_t)record->getValueInteger(key_field);
+            dis.list[i]->processRecord(record, key, records);
         }
-        else if(keyMode == RECEIPT_KEY_MODE)
+    }
+    catch(const RunTimeException& e)
+    {
+        (void)e;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * dispatchBatch
+ *----------------------------------------------------------------------------*/
+void RecordDispatcher::dispatchBatch (RecordObject** records, int num_records)
+{
+    RecordObject* run[MAX_BATCH_SIZE];
+    okey_t keys[MAX_BATCH_SIZE];
+
+    /* Dispatch Runs of Records with the Same Type */
+    int start = 0;
+    while(start < num_records)
+    {
+        const char* rec_type = records[start]->getRecordType();
+
+        /* Containers are Unpacked and Dispatched Individually */
+        if(StringLib::match(rec_type, ContainerRecord::recType))
+        {
+            dispatchRecord(records[start]);
+            start++;
+            continue;
+        }
+
+        /* Find End of Run */
+        int end = start + 1;
+        while(end < num_records && StringLib::match(records[end]->getRecordType(), rec_type))
+        {
+            end++;
+        }
+
+        /* Process Run */
+        try
         {
-            dispatchMutex.lock();
+            const dispatch_t& dis = dispatchTable[rec_type];
+
+            /* Get Keys (records without a key are dropped, as in dispatchRecord) */
+            int run_size = 0;
+            if(keyMode == RECEIPT_KEY_MODE)
             {
-                key = keyRecCnt++;
+                dispatchMutex.lock();
+                {
+                    for(int r = start; r < end; r++)
+                    {
+                        run[run_size] = records[r];
+                        keys[run_size++] = keyRecCnt++;
+                    }
+                }
+                dispatchMutex.unlock();
+            }
+            else
+            {
+                for(int r = start; r < end; r++)
+                {
+                    try
+                    {
+                        keys[run_size] = getKey(records[r]);
+                        run[run_size++] = records[r];
+                    }
+                    catch(const RunTimeException& e)
+                    {
+                        (void)e;
+                    }
+                }
+            }
+
+            if(run_size > 0)
+            {
+                for (int i = 0; i < dis.size; i++)
+                {
+                    dis.list[i]->processRecordBatch(run, keys, run_size);
+                }
             }
-            dispatchMutex.unlock();
         }
-        else if(keyMode == CALCULATED_KEY_MODE)
+        catch(const RunTimeException& e)
         {
-            key = keyFunc(record->getRecordData(), record->getRecordDataSize());
+            (void)e; // no dispatches attached to record type
         }
 
-        /* Process Record */
-        for (int i = 0; i < dis.size; i++)
+        start = end;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * getKey
+ *----------------------------------------------------------------------------*/
+okey_t RecordDispatcher::getKey (RecordObject* record)
+{
+    okey_t key = 0;
+    if(keyMode == FIELD_KEY_MODE)
+    {
+        key = (okey_t)keyField->getInteger(record);
+    }
+    else if(keyMode == RECEIPT_KEY_MODE)
+    {
+        dispatchMutex.lock();
         {
-            dis.list[i]->processRecord(record, key, records);
+            key = keyRecCnt++;
         }
+        dispatchMutex.unlock();
     }
-    catch(const RunTimeException& e)
+    else if(keyMode == CALCULATED_KEY_MODE)
     {
-        (void)e;
+        key = keyFunc(record->getRecordData(), record->getRecordDataSize());
+    }
+    return key;
+}
+
+/*----------------------------------------------------------------------------
+ * logRecordError
+ *----------------------------------------------------------------------------*/
+void RecordDispatcher::logRecordError (const RunTimeException& e, const unsigned char* msg, int len)
+{
+    if(!recError)
+    {
+        const int num_newlines = len / 16 + 3;
+        char* msg_str = new char[len * 2 + num_newlines + 1];
+        mlog(e.level(), "%s unable to create record from message: %s", ObjectType, e.what());
+        int msg_index = 0;
+        for(int i = 0; i < len; i++)
+        {
+            sprintf(&msg_str[msg_index], "%02X", msg[i]);
+            msg_index += 2;
+            if(i % 16 == 15) msg_str[msg_index++] = '\n';
+        }
+        msg_str[msg_index++] = '\n';
+        msg_str[msg_index++] = '\0';
+        mlog(DEBUG, "%s", msg_str);
+        delete [] msg_str;
+    }
+    recError = true;
+}
+
+/*----------------------------------------------------------------------------
+ * handleTimeout - returns true if dispatcher is aborting
+ *----------------------------------------------------------------------------*/
+bool RecordDispatcher::handleTimeout (void)
+{
+    /* Signal Timeout to Dispatches */
+    const int num_dispatches = dispatchList.size();
+    for(int d = 0; d < num_dispatches; d++)
+    {
+        DispatchObject* dis = dispatchList[d];
+        dis->processTimeout();
+    }
+
+    /* Check if Aborting on Timeout */
+    if(abortOnTimeout.load(std::memory_order_acquire))
+    {
+        dispatcherActive.store(false, std::memory_order_release);
+        return true;
+    }
+
+    return false;
+}
+
+/*----------------------------------------------------------------------------
+ * completeThread
+ *----------------------------------------------------------------------------*/
+void RecordDispatcher::completeThread (void)
+{
+    threadMut.lock();
+    {
+        threadsComplete++;
+        if(threadsComplete == numThreads)
+        {
+            /* Process Termination for each Dispatch */
+            dispatch_t dispatch;
+            const char* key = dispatchTable.first(&dispatch);
+            while(key != NULL)
+            {
+                for(int d = 0; d < dispatch.size; d++)
+                {
+                    if(!dispatch.list[d]->processTermination())
+                    {
+                        mlog(ERROR, "Failed to process termination on %s for %s", key, dispatch.list[d]->getName());
+                    }
+                }
+                key = dispatchTable.next(&dispatch);
+            }
+
+            /* Signal Completion */
+            signalComplete();
+        }
     }
+    threadMut.unlock();
 }
@@ -43,6 +43,7 @@
 #include "RecordObject.h"
 #include "OsApi.h"
 #include <atomic>
+#include <cstddef>
 
 /******************************************************************************
  * RECORD DISPATCHER CLASS
@@ -74,6 +75,17 @@ class RecordDispatcher: public LuaObject
          *--------------------------------------------------------------------*/
 
         static const int DISPATCH_TIMEOUT = 1000; // milliseconds
+        static const int MAX_BATCH_SIZE = 1024; // messages drained per wakeup
+        static const int VIEW_SIZE = 128; // bytes of storage for a record view
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        /* storage a record view is constructed in when dispatching in batches */
+        typedef struct {
+            alignas(std::max_align_t) unsigned char mem[VIEW_SIZE];
+        } view_t;
 
         /*--------------------------------------------------------------------
          * Methods
@@ -109,12 +121,14 @@ class RecordDispatcher: public LuaObject
                                                      int num_threads, MsgQ::subscriber_type_t type);
                                 ~RecordDispatcher   (void) override;
         virtual RecordObject*   createRecord        (unsigned char* buffer, int size);
+        virtual RecordObject*   createRecordView    (unsigned char* buffer, int size, view_t* view);
 
         static int              luaRun              (lua_State* L);
         static int              luaAttachDispatch   (lua_State* L);
         static int              luaClearError       (lua_State* L);
         static int              luaDrain            (lua_State* L);
         static int              luaAbortOnTimeout   (lua_State* L);
+        static int              luaBatch            (lua_State* L);
 
     private:
 
@@ -143,16 +157,23 @@ class RecordDispatcher: public LuaObject
         Mutex                   dispatchMutex;
         keyMode_t               keyMode;        // determines key of metric
         okey_t                  keyRecCnt;      // used with RECEIPT_KEY_MODE
-        const char*             keyField;       // used with FIELD_KEY_MODE
+        RecordObject::FieldPath* keyField;      // used with FIELD_KEY_MODE
         calcFunc_f              keyFunc;        // used with CALCULATED_KEY_MODE
         bool                    recError;
+        int                     batchSize;      // 1 dispatches each message as it is received
 
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
 
         static void*    dispatcherThread    (void* parm);
+        static void*    batchThread         (void* parm);
         void            dispatchRecord      (RecordObject* record, DispatchObject::recVec_t* records=NULL);
+        void            dispatchBatch       (RecordObject** records, int num_records);
+        okey_t          getKey              (RecordObject* record);
+        void            logRecordError      (const RunTimeException& e, const unsigned char* msg, int len);
+        bool            handleTimeout       (void);
+        void            completeThread      (void);
 
         void            startTdhreads        (void);
         void            stopThreads         (void);
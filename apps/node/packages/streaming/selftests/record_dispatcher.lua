@@ -63,6 +63,88 @@ runner.unittest("Record Dispatcher", function()
 
 end)
 
+runner.unittest("Batched Record Dispatcher", function()
+
+	-- setup
+	local idmetric = streaming.metric("id", "batch_dispatcher_metricq")
+	idmetric:pbtext(true):pbname(true)
+
+	local countermetric = streaming.metric("counter", "batch_dispatcher_metricq")
+	countermetric:pbtext(true):pbname(true)
+
+	local r = streaming.dispatcher("batch_dispatcher_inputq")
+	runner.assert(r:batch(64))
+	r:attach(idmetric, "test.rec"):attach(countermetric, "test.rec"):run()
+
+	local inputq = msg.publish("batch_dispatcher_inputq")
+	local metricq = msg.subscribe("batch_dispatcher_metricq")
+
+	-- send test records
+	local expected_totals = {id=0, counter=0}
+	for i=1,100,1 do
+		local testrec1 = msg.create(string.format('test.rec id=1000 counter=%d', i))
+		inputq:sendrecord(testrec1)
+		local testrec2 = msg.create(string.format('test.rec id=2000 counter=%d', i))
+		inputq:sendrecord(testrec2)
+		expected_totals["id"] = expected_totals["id"] + 3000
+		expected_totals["counter"] = expected_totals["counter"] + (i * 2)
+	end
+
+	-- receive metrics
+	local actual_totals = {}
+	actual_totals["test.rec.id"]=0
+	actual_totals["test.rec.counter"]=0
+	for i=1,400,1 do
+		local metric = metricq:recvrecord(1000)
+		if metric then
+			local name = metric:getvalue("NAME")
+			local value = metric:getvalue("VALUE")
+			actual_totals[name] = actual_totals[name] + value
+		end
+	end
+
+	-- compare results
+	runner.assert(expected_totals["id"] == actual_totals["test.rec.id"])
+	runner.assert(expected_totals["counter"] == actual_totals["test.rec.counter"])
+
+	-- clean up
+	r:destroy()
+	idmetric:destroy()
+	countermetric:destroy()
+
+end)
+
+runner.unittest("Record Dispatcher Throughput", function()
+
+	local num_records = 100000
+	local testrec = msg.create('test.rec id=1000 counter=1')
+
+	-- time dispatching num_records through a limit check with and without batching
+	local function throughput(qname, batch_size)
+		local limit = streaming.limit("counter", nil, 0, 10, nil, nil)
+		local r = streaming.dispatcher(qname, 1)
+		if batch_size > 1 then r:batch(batch_size) end
+		r:attach(limit, "test.rec")
+		local inputq = msg.publish(qname)
+		for i=1,num_records,1 do
+			inputq:sendrecord(testrec)
+		end
+		local t0 = time.latch()
+		r:run()
+		inputq:sendstring("")
+		runner.assert(r:waiton(30000), "dispatcher did not complete")
+		local duration = time.latch() - t0
+		r:destroy()
+		limit:destroy()
+		return num_records / duration
+	end
+
+	local single_rate = throughput("throughput_single_inputq", 1)
+	local batch_rate = throughput("throughput_batch_inputq", 256)
+	print(string.format("Single: %.0f records/sec, Batched: %.0f records/sec", single_rate, batch_rate))
+
+end)
+
 -- Report Results --
 
 runner.report()
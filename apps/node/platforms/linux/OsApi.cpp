@@ -51,6 +51,7 @@
 #include <errno.h>
 #include <byteswap.h>
 #include <sys/sysinfo.h>
+#include <sys/resource.h>
 
 /******************************************************************************
  * STATIC DATA
@@ -300,6 +301,19 @@ double OsApi::memusage (void)
     return 0.0;
 }
 
+/*----------------------------------------------------------------------------
+ * maxrss - peak resident set size of the process in bytes
+ *----------------------------------------------------------------------------*/
+int64_t OsApi::maxrss (void)
+{
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+    return static_cast<int64_t>(usage.ru_maxrss) * 1024; // reported in kilobytes
+}
+
 /*----------------------------------------------------------------------------
  * print
  *----------------------------------------------------------------------------*/
@@ -248,6 +248,7 @@ class OsApi
         static double       swaplf              (double val);
         static int          nproc               (void);
         static double       memusage            (void);
+        static int64_t      maxrss              (void);
         static void         print               (const char* file_name, unsigned int line_number, const char* format_string, ...)  __attribute__((format(printf, 3, 4)));
 
         /* system configuration */